@@ -6,9 +6,20 @@
 
 #include <config.h>
 #include "base/allocator/allocator_extension_thunks.h"
+#include "base/allocator/sampled_heap_profiler.h"
 #include "base/profiler/alternate_timer.h"
 #include "base/sysinfo.h"
 
+// Returns the address the allocation entry point was called from, used to
+// attribute sampled allocations to their call sites.
+#if defined(_MSC_VER)
+#include <intrin.h>
+#pragma intrinsic(_ReturnAddress)
+#define ALLOCATION_CALL_SITE() _ReturnAddress()
+#else
+#define ALLOCATION_CALL_SITE() __builtin_return_address(0)
+#endif
+
 // When defined, different heap allocators can be used via an environment
 // variable set before running the program.  This may reduce the amount
 // of inlining that we get with malloc/free/etc.  Disabling makes it
@@ -130,8 +141,11 @@ void* malloc(size_t size) __THROW {
     // TCMalloc case.
     ptr = do_malloc(size);
 #endif
-    if (ptr)
+    if (ptr) {
+      base::allocator::SampledHeapProfiler::RecordAlloc(
+          ptr, size, ALLOCATION_CALL_SITE());
       return ptr;
+    }
 
     if (!new_mode || !call_new_handler(true))
       break;
@@ -140,6 +154,7 @@ void* malloc(size_t size) __THROW {
 }
 
 void free(void* p) __THROW {
+  base::allocator::SampledHeapProfiler::RecordFree(p);
 #ifdef ENABLE_DYNAMIC_ALLOCATOR_SWITCHING
   switch (allocator) {
     case JEMALLOC:
@@ -186,8 +201,17 @@ void* realloc(void* ptr, size_t size) __THROW {
     // Subtle warning:  NULL return does not alwas indicate out-of-memory.  If
     // the requested new size is zero, realloc should free the ptr and return
     // NULL.
-    if (new_ptr || !size)
+    if (new_ptr || !size) {
+      // The old block is gone whether or not it moved; resample the new
+      // one under the caller's address.  On failure the old block is
+      // still live, so its sample (if any) is kept.
+      base::allocator::SampledHeapProfiler::RecordFree(ptr);
+      if (new_ptr) {
+        base::allocator::SampledHeapProfiler::RecordAlloc(
+            new_ptr, size, ALLOCATION_CALL_SITE());
+      }
       return new_ptr;
+    }
     if (!new_mode || !call_new_handler(true))
       break;
   }
@@ -0,0 +1,170 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/allocator/sampled_heap_profiler.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "base/atomicops.h"
+#include "base/format_macros.h"
+#include "base/stringprintf.h"
+
+namespace base {
+namespace allocator {
+
+namespace {
+
+// One in this many allocations is sampled.  A prime keeps the sampling
+// from locking onto periodic allocation patterns.
+const int32 kSampleInterval = 1021;
+
+// Size of the live-sample table.  Must be a power of two.  With the
+// interval above this covers processes with several million live
+// allocations before samples start getting dropped.
+const size_t kTableSize = 4096;
+const size_t kTableMask = kTableSize - 1;
+
+// How far RecordAlloc() and RecordFree() probe from the hash bucket
+// before giving up.
+const int kMaxProbes = 16;
+
+// Marks a slot that is claimed but not yet fully written.  Never a valid
+// allocation address.
+const subtle::AtomicWord kBusySentinel = 1;
+
+// A sampled live allocation.  |ptr| is 0 when the slot is empty and
+// kBusySentinel while a writer is filling in the other fields.
+struct Slot {
+  subtle::AtomicWord ptr;
+  subtle::AtomicWord size;
+  subtle::AtomicWord call_site;
+};
+
+Slot g_table[kTableSize];
+
+// Allocations left until the next sample.  Maintained with plain loads
+// and stores on purpose: an atomic read-modify-write on every malloc()
+// would put a contended cache line on the hottest path in the process,
+// and racing updates merely shift the sampling phase.
+subtle::Atomic32 g_countdown = kSampleInterval;
+
+size_t HashPointer(const void* ptr) {
+  // Allocators hand out aligned pointers, so discard the always-zero low
+  // bits before mixing.
+  uintptr_t value = reinterpret_cast<uintptr_t>(ptr) >> 4;
+  return (value * 2654435761u) & kTableMask;
+}
+
+bool LiveBytesGreaterThan(const SampledHeapProfiler::Site& a,
+                          const SampledHeapProfiler::Site& b) {
+  return a.live_bytes > b.live_bytes;
+}
+
+}  // namespace
+
+// static
+void SampledHeapProfiler::RecordAlloc(const void* ptr, size_t size,
+                                      const void* call_site) {
+  if (!ptr)
+    return;
+
+  int32 countdown = subtle::NoBarrier_Load(&g_countdown) - 1;
+  if (countdown > 0) {
+    subtle::NoBarrier_Store(&g_countdown, countdown);
+    return;
+  }
+  subtle::NoBarrier_Store(&g_countdown, kSampleInterval);
+
+  size_t index = HashPointer(ptr);
+  for (int probe = 0; probe < kMaxProbes;
+       ++probe, index = (index + 1) & kTableMask) {
+    Slot* slot = &g_table[index];
+    if (subtle::NoBarrier_Load(&slot->ptr) != 0)
+      continue;
+    if (subtle::Acquire_CompareAndSwap(&slot->ptr, 0, kBusySentinel) != 0)
+      continue;  // Lost the slot to a concurrent sample.
+    subtle::NoBarrier_Store(&slot->size,
+                            static_cast<subtle::AtomicWord>(size));
+    subtle::NoBarrier_Store(
+        &slot->call_site, reinterpret_cast<subtle::AtomicWord>(call_site));
+    // Publishes the slot; readers acquire-load |ptr| before trusting the
+    // other fields.
+    subtle::Release_Store(&slot->ptr,
+                          reinterpret_cast<subtle::AtomicWord>(ptr));
+    return;
+  }
+  // The neighborhood is full; drop the sample.
+}
+
+// static
+void SampledHeapProfiler::RecordFree(const void* ptr) {
+  if (!ptr)
+    return;
+
+  const subtle::AtomicWord value = reinterpret_cast<subtle::AtomicWord>(ptr);
+  size_t index = HashPointer(ptr);
+  for (int probe = 0; probe < kMaxProbes;
+       ++probe, index = (index + 1) & kTableMask) {
+    Slot* slot = &g_table[index];
+    if (subtle::NoBarrier_Load(&slot->ptr) != value)
+      continue;
+    if (subtle::Acquire_CompareAndSwap(&slot->ptr, value, 0) == value)
+      return;
+  }
+}
+
+// static
+int SampledHeapProfiler::GetSnapshot(Site* sites, int max_sites) {
+  // Aggregate the live samples by call site.  Slots written concurrently
+  // with the scan are either skipped (still busy) or at worst counted
+  // with the values they held when their pointer was published; the
+  // result is an estimate either way.
+  std::map<const void*, Site> aggregated;
+  for (size_t index = 0; index < kTableSize; ++index) {
+    const Slot* slot = &g_table[index];
+    subtle::AtomicWord ptr = subtle::Acquire_Load(&slot->ptr);
+    if (ptr == 0 || ptr == kBusySentinel)
+      continue;
+    const void* call_site = reinterpret_cast<const void*>(
+        subtle::NoBarrier_Load(&slot->call_site));
+    uint64 size =
+        static_cast<uint64>(subtle::NoBarrier_Load(&slot->size));
+    Site& site = aggregated[call_site];
+    site.call_site = call_site;
+    site.live_allocs += kSampleInterval;
+    site.live_bytes += size * kSampleInterval;
+  }
+
+  std::vector<Site> sorted;
+  sorted.reserve(aggregated.size());
+  for (std::map<const void*, Site>::const_iterator it = aggregated.begin();
+       it != aggregated.end(); ++it)
+    sorted.push_back(it->second);
+  std::sort(sorted.begin(), sorted.end(), LiveBytesGreaterThan);
+
+  int count = 0;
+  for (; count < max_sites && count < static_cast<int>(sorted.size());
+       ++count)
+    sites[count] = sorted[count];
+  return count;
+}
+
+// static
+std::string SampledHeapProfiler::GetReport() {
+  Site sites[64];
+  int count = GetSnapshot(sites, arraysize(sites));
+
+  std::string report;
+  for (int i = 0; i < count; ++i) {
+    StringAppendF(&report, "%p %" PRIu64 " %" PRIu64 "\n",
+                  sites[i].call_site, sites[i].live_allocs,
+                  sites[i].live_bytes);
+  }
+  return report;
+}
+
+}  // namespace allocator
+}  // namespace base
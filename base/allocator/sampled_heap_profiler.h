@@ -0,0 +1,71 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_ALLOCATOR_SAMPLED_HEAP_PROFILER_H_
+#define BASE_ALLOCATOR_SAMPLED_HEAP_PROFILER_H_
+#pragma once
+
+#include <stddef.h>
+
+#include <string>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+
+namespace base {
+namespace allocator {
+
+// An always-on sampled heap profiler.
+//
+// The allocator shim reports every allocation and free here; one in
+// kSampleInterval allocations is sampled and tracked in a fixed-size
+// lock-free table together with the code address that requested it.  A
+// snapshot aggregates the live samples by call site and scales the byte
+// counts back up by the sampling interval, giving an estimate of which
+// call sites own the heap that is cheap enough to collect from every
+// production process.  Call sites are reported as raw code addresses;
+// symbolization happens offline against the matching binary.
+//
+// RecordAlloc() and RecordFree() never allocate and never block, so they
+// are safe to call from inside the allocator itself.
+class BASE_EXPORT SampledHeapProfiler {
+ public:
+  // An aggregated view of one allocating call site.
+  struct Site {
+    const void* call_site;
+    // Estimated number of live allocations and live bytes attributed to
+    // the call site, already scaled by the sampling interval.
+    uint64 live_allocs;
+    uint64 live_bytes;
+  };
+
+  // Called by the allocator for every allocation that returns |ptr|.
+  // |call_site| is the address the allocation was requested from.
+  static void RecordAlloc(const void* ptr, size_t size,
+                          const void* call_site);
+
+  // Called by the allocator for every free.  Does nothing for pointers
+  // that were not sampled, which is the overwhelmingly common case.
+  static void RecordFree(const void* ptr);
+
+  // Fills |sites| with up to |max_sites| aggregated call sites, largest
+  // live-byte estimate first, and returns the number filled.
+  static int GetSnapshot(Site* sites, int max_sites);
+
+  // Returns the snapshot as text, one "<address> <allocs> <bytes>" line
+  // per call site.  This is the form the memory internals pages ship
+  // across processes.
+  static std::string GetReport();
+
+ private:
+  // Static use only.
+  SampledHeapProfiler();
+
+  DISALLOW_COPY_AND_ASSIGN(SampledHeapProfiler);
+};
+
+}  // namespace allocator
+}  // namespace base
+
+#endif  // BASE_ALLOCATOR_SAMPLED_HEAP_PROFILER_H_
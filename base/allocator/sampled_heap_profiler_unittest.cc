@@ -0,0 +1,82 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/allocator/sampled_heap_profiler.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace allocator {
+
+namespace {
+
+// Distinct fake call sites for the tests below; the profiler treats call
+// sites as opaque addresses and never dereferences them.
+const void* const kSiteA = reinterpret_cast<const void*>(0xA5171);
+const void* const kSiteB = reinterpret_cast<const void*>(0xB5172);
+
+// Fake allocation addresses, spaced like real allocator results.  The
+// profiler only hashes and compares them.
+const void* FakePointer(int i) {
+  return reinterpret_cast<const void*>(0x100000 + i * 16);
+}
+
+// Returns true if |call_site| shows up in a snapshot, and its live-byte
+// estimate through |live_bytes| if so.
+bool SnapshotContains(const void* call_site, uint64* live_bytes) {
+  SampledHeapProfiler::Site sites[256];
+  int count = SampledHeapProfiler::GetSnapshot(sites, 256);
+  for (int i = 0; i < count; ++i) {
+    if (sites[i].call_site == call_site) {
+      if (live_bytes)
+        *live_bytes = sites[i].live_bytes;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST(SampledHeapProfilerTest, SamplesAndReleases) {
+  // Enough allocations that the 1-in-N sampler is guaranteed to pick some
+  // of them up.
+  const int kAllocations = 100000;
+  for (int i = 0; i < kAllocations; ++i)
+    SampledHeapProfiler::RecordAlloc(FakePointer(i), 64, kSiteA);
+
+  uint64 live_bytes = 0;
+  EXPECT_TRUE(SnapshotContains(kSiteA, &live_bytes));
+  EXPECT_GT(live_bytes, 0u);
+
+  // Freeing everything must remove the call site from the snapshot again.
+  for (int i = 0; i < kAllocations; ++i)
+    SampledHeapProfiler::RecordFree(FakePointer(i));
+  EXPECT_FALSE(SnapshotContains(kSiteA, NULL));
+}
+
+TEST(SampledHeapProfilerTest, ReportListsSampledSite) {
+  const int kAllocations = 100000;
+  for (int i = 0; i < kAllocations; ++i)
+    SampledHeapProfiler::RecordAlloc(FakePointer(i), 128, kSiteB);
+
+  std::string report = SampledHeapProfiler::GetReport();
+  EXPECT_FALSE(report.empty());
+  // One space-separated triple per line.
+  EXPECT_NE(std::string::npos, report.find(' '));
+  EXPECT_NE(std::string::npos, report.find('\n'));
+
+  for (int i = 0; i < kAllocations; ++i)
+    SampledHeapProfiler::RecordFree(FakePointer(i));
+}
+
+TEST(SampledHeapProfilerTest, NullsAreIgnored) {
+  SampledHeapProfiler::RecordAlloc(NULL, 64, kSiteA);
+  SampledHeapProfiler::RecordFree(NULL);
+}
+
+}  // namespace allocator
+}  // namespace base
@@ -0,0 +1,224 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/allocator/thread_local_pool.h"
+
+#include <stdlib.h>
+
+#include "base/format_macros.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/metrics/stats_counters.h"
+#include "base/stringprintf.h"
+#include "base/threading/thread_local.h"
+
+namespace base {
+namespace allocator {
+
+namespace {
+
+// Power-of-two size classes: 32 bytes through 32KB.  Anything larger is
+// served by malloc() directly; pooling provides no measurable benefit for
+// blocks that big and would tie down too much cached memory.
+const size_t kMinBlockSize = 32;
+const size_t kNumSizeClasses = 11;
+
+// Marker stored in a block's header when it bypassed the size classes.
+const size_t kOversizedBlock = static_cast<size_t>(-1);
+
+// Caps how many free blocks of one size class a thread may cache, bounding
+// the per-thread memory held by idle freelists.
+const size_t kMaxFreeBlocksPerClass = 32;
+
+// Every block starts with one of these; the payload follows.  The union
+// keeps the payload as aligned as malloc() results are.
+union BlockHeader {
+  size_t size_class;
+  double for_alignment;
+};
+
+// Free blocks store the freelist link in their payload bytes.
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct PoolState {
+  FreeBlock* free_lists[kNumSizeClasses];
+  size_t free_counts[kNumSizeClasses];
+};
+
+LazyInstance<ThreadLocalPointer<PoolState> >::Leaky g_pool_tls =
+    LAZY_INSTANCE_INITIALIZER;
+
+PoolState* GetPoolState() {
+  PoolState* state = g_pool_tls.Get().Get();
+  if (!state) {
+    state = static_cast<PoolState*>(calloc(1, sizeof(PoolState)));
+    CHECK(state);
+    g_pool_tls.Get().Set(state);
+  }
+  return state;
+}
+
+// Returns the smallest size class whose blocks hold |bytes|, or
+// kOversizedBlock if none does.
+size_t SizeClassFor(size_t bytes) {
+  size_t block_size = kMinBlockSize;
+  for (size_t size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+    if (bytes <= block_size)
+      return size_class;
+    block_size <<= 1;
+  }
+  return kOversizedBlock;
+}
+
+size_t BlockSizeOfClass(size_t size_class) {
+  return kMinBlockSize << size_class;
+}
+
+}  // namespace
+
+// static
+void* ThreadLocalPool::Allocate(size_t size) {
+  const size_t needed = size + sizeof(BlockHeader);
+  const size_t size_class = SizeClassFor(needed);
+
+  BlockHeader* header;
+  if (size_class == kOversizedBlock) {
+    SIMPLE_STATS_COUNTER("ThreadLocalPool.Oversized");
+    header = static_cast<BlockHeader*>(malloc(needed));
+    if (!header)
+      return NULL;
+    header->size_class = kOversizedBlock;
+    return header + 1;
+  }
+
+  PoolState* state = GetPoolState();
+  FreeBlock* free_block = state->free_lists[size_class];
+  if (free_block) {
+    SIMPLE_STATS_COUNTER("ThreadLocalPool.Hits");
+    state->free_lists[size_class] = free_block->next;
+    state->free_counts[size_class]--;
+    header = reinterpret_cast<BlockHeader*>(free_block);
+  } else {
+    SIMPLE_STATS_COUNTER("ThreadLocalPool.Misses");
+    header = static_cast<BlockHeader*>(malloc(BlockSizeOfClass(size_class)));
+    if (!header)
+      return NULL;
+  }
+  header->size_class = size_class;
+  return header + 1;
+}
+
+// static
+void ThreadLocalPool::Free(void* ptr) {
+  if (!ptr)
+    return;
+
+  BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+  const size_t size_class = header->size_class;
+  if (size_class == kOversizedBlock) {
+    free(header);
+    return;
+  }
+  DCHECK_LT(size_class, kNumSizeClasses);
+
+  PoolState* state = GetPoolState();
+  if (state->free_counts[size_class] >= kMaxFreeBlocksPerClass) {
+    free(header);
+    return;
+  }
+  FreeBlock* free_block = reinterpret_cast<FreeBlock*>(header);
+  free_block->next = state->free_lists[size_class];
+  state->free_lists[size_class] = free_block;
+  state->free_counts[size_class]++;
+}
+
+// static
+void ThreadLocalPool::GetStatsForCurrentThread(std::string* output) {
+  PoolState* state = GetPoolState();
+  for (size_t size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+    if (!state->free_counts[size_class])
+      continue;
+    StringAppendF(output, "class %5" PRIuS ": %" PRIuS " free blocks "
+                  "(%" PRIuS " bytes)\n",
+                  BlockSizeOfClass(size_class),
+                  state->free_counts[size_class],
+                  state->free_counts[size_class] *
+                      BlockSizeOfClass(size_class));
+  }
+}
+
+// static
+void ThreadLocalPool::DrainCurrentThread() {
+  PoolState* state = GetPoolState();
+  for (size_t size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+    FreeBlock* free_block = state->free_lists[size_class];
+    while (free_block) {
+      FreeBlock* next = free_block->next;
+      free(free_block);
+      free_block = next;
+    }
+    state->free_lists[size_class] = NULL;
+    state->free_counts[size_class] = 0;
+  }
+}
+
+// Chunks are allocated with their payload immediately following this
+// header; |size| is the payload size.  The second member also pads the
+// header so the payload stays aligned for any standard type.
+struct ScopedArena::Chunk {
+  Chunk* next;
+  size_t size;
+};
+
+namespace {
+
+// Default chunk payload size; allocations bigger than this get a chunk of
+// their own.
+const size_t kArenaChunkSize = 4096;
+
+// Arena allocations are rounded up to this many bytes so that every
+// returned pointer is suitably aligned.
+const size_t kArenaAlignment = 8;
+
+}  // namespace
+
+ScopedArena::ScopedArena()
+    : head_(NULL),
+      next_(NULL),
+      remaining_(0),
+      bytes_allocated_(0) {
+}
+
+ScopedArena::~ScopedArena() {
+  while (head_) {
+    Chunk* next = head_->next;
+    free(head_);
+    head_ = next;
+  }
+}
+
+void* ScopedArena::Allocate(size_t size) {
+  size = (size + kArenaAlignment - 1) & ~(kArenaAlignment - 1);
+  if (size > remaining_) {
+    const size_t chunk_size = size > kArenaChunkSize ? size : kArenaChunkSize;
+    Chunk* chunk = static_cast<Chunk*>(malloc(sizeof(Chunk) + chunk_size));
+    if (!chunk)
+      return NULL;
+    chunk->next = head_;
+    chunk->size = chunk_size;
+    head_ = chunk;
+    next_ = reinterpret_cast<char*>(chunk + 1);
+    remaining_ = chunk_size;
+  }
+  void* result = next_;
+  next_ += size;
+  remaining_ -= size;
+  bytes_allocated_ += size;
+  return result;
+}
+
+}  // namespace allocator
+}  // namespace base
@@ -0,0 +1,92 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_ALLOCATOR_THREAD_LOCAL_POOL_H_
+#define BASE_ALLOCATOR_THREAD_LOCAL_POOL_H_
+#pragma once
+
+#include <stddef.h>
+
+#include <string>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+
+namespace base {
+namespace allocator {
+
+// A pool of fixed size-class blocks recycled through per-thread freelists.
+//
+// Call sites whose allocation counts dominate profiles (IOBuffer payloads,
+// Pickle buffers, Value trees) can opt in by routing their buffers through
+// Allocate()/Free() instead of the global allocator.  The freelists are
+// thread-local, so no locks or atomic operations are involved.  Blocks are
+// plain malloc() memory underneath; a block allocated on one thread may be
+// freed on another, in which case it simply joins the freeing thread's
+// list.  Requests larger than the biggest size class fall through to
+// malloc()/free() unchanged.
+//
+// Blocks cached by a thread are not reclaimed automatically when the
+// thread exits; threads that use the pool and terminate before the process
+// does should call DrainCurrentThread() during their teardown.
+class BASE_EXPORT ThreadLocalPool {
+ public:
+  // Returns a block with at least |size| usable bytes, or NULL if the
+  // underlying allocation fails.
+  static void* Allocate(size_t size);
+
+  // Releases a block previously returned by Allocate().  Does nothing if
+  // |ptr| is NULL.
+  static void Free(void* ptr);
+
+  // Appends a human-readable description of the calling thread's freelists
+  // to |output|, one line per non-empty size class.  This is what the
+  // memory internals pages show next to the global allocator's stats.
+  static void GetStatsForCurrentThread(std::string* output);
+
+  // Returns every block cached by the calling thread to the global
+  // allocator, e.g. on thread exit or under memory pressure.
+  static void DrainCurrentThread();
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(ThreadLocalPool);
+};
+
+// A bump allocator for call sites where every allocation dies at the end
+// of a well-defined scope.  Individual allocations are never freed; all of
+// the arena's memory is released at once when it goes out of scope.
+//
+//   base::allocator::ScopedArena arena;
+//   Foo* foo = new (arena.Allocate(sizeof(Foo))) Foo(...);
+//
+// Note that Allocate() does not run constructors and the destructor does
+// not run destructors; the arena is intended for POD buffers and for
+// objects whose destructors are trivial.
+class BASE_EXPORT ScopedArena {
+ public:
+  ScopedArena();
+  ~ScopedArena();
+
+  // Returns |size| bytes aligned suitably for any standard type, or NULL
+  // if the underlying chunk allocation fails.
+  void* Allocate(size_t size);
+
+  // Total payload bytes handed out so far; chunk overhead is not counted.
+  size_t bytes_allocated() const { return bytes_allocated_; }
+
+ private:
+  struct Chunk;
+
+  Chunk* head_;            // Newest chunk; chunks form a singly-linked list.
+  char* next_;             // First free byte in the newest chunk.
+  size_t remaining_;       // Free bytes left in the newest chunk.
+  size_t bytes_allocated_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedArena);
+};
+
+}  // namespace allocator
+}  // namespace base
+
+#endif  // BASE_ALLOCATOR_THREAD_LOCAL_POOL_H_
@@ -0,0 +1,107 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/allocator/thread_local_pool.h"
+
+#include <string.h>
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace allocator {
+
+TEST(ThreadLocalPoolTest, AllocateAndFree) {
+  void* block = ThreadLocalPool::Allocate(100);
+  ASSERT_TRUE(block != NULL);
+  // The whole requested size must be writable.
+  memset(block, 0xAB, 100);
+  ThreadLocalPool::Free(block);
+
+  // A same-sized allocation should come back out of the freelist.
+  void* recycled = ThreadLocalPool::Allocate(100);
+  EXPECT_EQ(block, recycled);
+  ThreadLocalPool::Free(recycled);
+
+  ThreadLocalPool::DrainCurrentThread();
+}
+
+TEST(ThreadLocalPoolTest, DifferentSizeClasses) {
+  void* small_block = ThreadLocalPool::Allocate(8);
+  void* large_block = ThreadLocalPool::Allocate(1000);
+  ASSERT_TRUE(small_block != NULL);
+  ASSERT_TRUE(large_block != NULL);
+  ThreadLocalPool::Free(small_block);
+  ThreadLocalPool::Free(large_block);
+
+  // Freeing the small block must not satisfy the large request.
+  void* recycled = ThreadLocalPool::Allocate(1000);
+  EXPECT_EQ(large_block, recycled);
+  ThreadLocalPool::Free(recycled);
+
+  ThreadLocalPool::DrainCurrentThread();
+}
+
+TEST(ThreadLocalPoolTest, OversizedFallsThrough) {
+  // Far beyond the largest size class; must still work.
+  const size_t kOversized = 1024 * 1024;
+  void* block = ThreadLocalPool::Allocate(kOversized);
+  ASSERT_TRUE(block != NULL);
+  memset(block, 0, kOversized);
+  ThreadLocalPool::Free(block);
+  ThreadLocalPool::DrainCurrentThread();
+}
+
+TEST(ThreadLocalPoolTest, FreeNullIsNoOp) {
+  ThreadLocalPool::Free(NULL);
+}
+
+TEST(ThreadLocalPoolTest, Stats) {
+  void* block = ThreadLocalPool::Allocate(100);
+  ThreadLocalPool::Free(block);
+
+  std::string stats;
+  ThreadLocalPool::GetStatsForCurrentThread(&stats);
+  EXPECT_FALSE(stats.empty());
+
+  ThreadLocalPool::DrainCurrentThread();
+  stats.clear();
+  ThreadLocalPool::GetStatsForCurrentThread(&stats);
+  EXPECT_TRUE(stats.empty());
+}
+
+TEST(ScopedArenaTest, Basic) {
+  ScopedArena arena;
+  EXPECT_EQ(0u, arena.bytes_allocated());
+
+  char* first = static_cast<char*>(arena.Allocate(10));
+  ASSERT_TRUE(first != NULL);
+  memset(first, 1, 10);
+
+  char* second = static_cast<char*>(arena.Allocate(10));
+  ASSERT_TRUE(second != NULL);
+  memset(second, 2, 10);
+
+  EXPECT_NE(first, second);
+  EXPECT_GE(arena.bytes_allocated(), 20u);
+
+  // Returned pointers are aligned for any standard type.
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(first) % 8);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(second) % 8);
+}
+
+TEST(ScopedArenaTest, LargeAllocations) {
+  ScopedArena arena;
+  // Larger than the arena's chunk size; gets a dedicated chunk.
+  char* block = static_cast<char*>(arena.Allocate(64 * 1024));
+  ASSERT_TRUE(block != NULL);
+  memset(block, 0xCD, 64 * 1024);
+
+  // Small allocations still work afterwards.
+  EXPECT_TRUE(arena.Allocate(16) != NULL);
+}
+
+}  // namespace allocator
+}  // namespace base
@@ -131,6 +131,8 @@
       'type': '<(gtest_target_type)',
       'sources': [
         # Tests.
+        'allocator/sampled_heap_profiler_unittest.cc',
+        'allocator/thread_local_pool_unittest.cc',
         'android/jni_android_unittest.cc',
         'android/path_utils_unittest.cc',
         'android/scoped_java_ref_unittest.cc',
@@ -255,11 +257,13 @@
         'time_unittest.cc',
         'time_win_unittest.cc',
         'timer_unittest.cc',
+        'timer_wheel_unittest.cc',
         'tools_sanity_unittest.cc',
         'tracked_objects_unittest.cc',
         'tuple_unittest.cc',
         'utf_offset_string_conversions_unittest.cc',
         'utf_string_conversions_unittest.cc',
+        'value_arena_unittest.cc',
         'values_unittest.cc',
         'version_unittest.cc',
         'vlog_unittest.cc',
@@ -509,6 +513,8 @@
       ],
       'sources': [
         'perftimer.cc',
+        'test/perf_benchmark.cc',
+        'test/perf_benchmark.h',
         'test/run_all_perftests.cc',
       ],
       'direct_dependent_settings': {
@@ -4,17 +4,82 @@
 
 #include "base/base64.h"
 
+#include "base/base64_internal.h"
+#include "base/cpu.h"
 #include "third_party/modp_b64/modp_b64.h"
 
 namespace base {
 
+namespace {
+
+#if defined(ARCH_CPU_X86_FAMILY)
+// Inputs shorter than this are not worth the vector setup cost.
+const size_t kMinSizeForSIMD = 32;
+
+// The benign race on first use is harmless: every thread computes the same
+// answer.
+bool HasSSSE3() {
+  static int has_ssse3 = -1;
+  if (has_ssse3 == -1)
+    has_ssse3 = CPU().has_ssse3() ? 1 : 0;
+  return has_ssse3 == 1;
+}
+#endif
+
+// Encodes |input| into |dest|, which must have room for
+// modp_b64_encode_len(input.size()) bytes.  Returns the number of
+// characters written, not counting the trailing null byte, or -1 on
+// failure.  Whole 12-byte groups go through the SSSE3 kernel when the CPU
+// has it; the tail (and everything on other CPUs) is handled by modp_b64.
+int EncodeImpl(char* dest, const StringPiece& input) {
+  size_t consumed = 0;
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (input.size() >= kMinSizeForSIMD && HasSSSE3()) {
+    consumed =
+        internal::Base64EncodeBlocksSSSE3(dest, input.data(), input.size());
+  }
+#endif
+  const size_t emitted = consumed / 3 * 4;
+  int tail = modp_b64_encode(dest + emitted, input.data() + consumed,
+                             static_cast<int>(input.size() - consumed));
+  if (tail < 0)
+    return -1;
+  return static_cast<int>(emitted) + tail;
+}
+
+// Decodes |input| into |dest|, which must have room for
+// modp_b64_decode_len(input.size()) bytes.  Returns the number of bytes
+// written, or -1 if the input is not valid base64.  The final group, which
+// may carry '=' padding, always goes through modp_b64 so that the padding
+// rules stay in one place.
+int DecodeImpl(char* dest, const StringPiece& input) {
+  size_t consumed = 0;
+  size_t produced = 0;
+#if defined(ARCH_CPU_X86_FAMILY)
+  // modp_b64_decode rejects inputs that are not a multiple of four long,
+  // so only a well-formed prefix is worth decoding.
+  if (input.size() >= kMinSizeForSIMD && (input.size() % 4) == 0 &&
+      HasSSSE3()) {
+    if (!internal::Base64DecodeBlocksSSSE3(dest, input.data(), input.size(),
+                                           &consumed, &produced))
+      return -1;
+  }
+#endif
+  int tail = modp_b64_decode(dest + produced, input.data() + consumed,
+                             static_cast<int>(input.size() - consumed));
+  if (tail < 0)
+    return -1;
+  return static_cast<int>(produced) + tail;
+}
+
+}  // namespace
+
 bool Base64Encode(const StringPiece& input, std::string* output) {
   std::string temp;
   temp.resize(modp_b64_encode_len(input.size()));  // makes room for null byte
 
   // null terminates result since result is base64 text!
-  int input_size = static_cast<int>(input.size());
-  int output_size= modp_b64_encode(&(temp[0]), input.data(), input_size);
+  int output_size = EncodeImpl(&(temp[0]), input);
   if (output_size < 0)
     return false;
 
@@ -23,13 +88,26 @@ bool Base64Encode(const StringPiece& input, std::string* output) {
   return true;
 }
 
+bool Base64EncodeAppend(const StringPiece& input, std::string* output) {
+  const size_t out_size = output->size();
+  output->resize(out_size + modp_b64_encode_len(input.size()));
+
+  int added = EncodeImpl(&(*output)[out_size], input);
+  if (added < 0) {
+    output->resize(out_size);
+    return false;
+  }
+
+  output->resize(out_size + added);
+  return true;
+}
+
 bool Base64Decode(const StringPiece& input, std::string* output) {
   std::string temp;
   temp.resize(modp_b64_decode_len(input.size()));
 
   // does not null terminate result since result is binary data!
-  int input_size = static_cast<int>(input.size());
-  int output_size = modp_b64_decode(&(temp[0]), input.data(), input_size);
+  int output_size = DecodeImpl(&(temp[0]), input);
   if (output_size < 0)
     return false;
 
@@ -38,4 +116,18 @@ bool Base64Decode(const StringPiece& input, std::string* output) {
   return true;
 }
 
+bool Base64DecodeAppend(const StringPiece& input, std::string* output) {
+  const size_t out_size = output->size();
+  output->resize(out_size + modp_b64_decode_len(input.size()));
+
+  int added = DecodeImpl(&(*output)[out_size], input);
+  if (added < 0) {
+    output->resize(out_size);
+    return false;
+  }
+
+  output->resize(out_size + added);
+  return true;
+}
+
 }  // namespace base
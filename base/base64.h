@@ -21,6 +21,16 @@ BASE_EXPORT bool Base64Encode(const StringPiece& input, std::string* output);
 // otherwise.  The output string is only modified if successful.
 BASE_EXPORT bool Base64Decode(const StringPiece& input, std::string* output);
 
+// Variants of the conversions above which append the result to |*output|
+// instead of replacing it, so that callers assembling a larger buffer (a
+// data: URL, a sync protocol message) avoid the temporary-string-and-swap
+// of the plain forms.  The output string is only modified on success,
+// aside from possibly being reallocated to make room.
+BASE_EXPORT bool Base64EncodeAppend(const StringPiece& input,
+                                    std::string* output);
+BASE_EXPORT bool Base64DecodeAppend(const StringPiece& input,
+                                    std::string* output);
+
 }  // namespace base
 
 #endif  // BASE_BASE64_H__
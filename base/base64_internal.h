@@ -0,0 +1,42 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_BASE64_INTERNAL_H_
+#define BASE_BASE64_INTERNAL_H_
+#pragma once
+
+#include "build/build_config.h"
+
+#include <stddef.h>
+
+// Base64 block transcoding functions shared between base64.cc, which owns
+// the scalar tails and runtime CPU dispatch, and base64_ssse3.cc, which is
+// compiled with SSSE3 enabled.  Not part of the public API; use the
+// functions in base/base64.h instead.
+
+namespace base {
+namespace internal {
+
+#if defined(ARCH_CPU_X86_FAMILY)
+// Encodes whole 12-byte groups of |src| as 16 base64 characters each for
+// as long as at least 16 input bytes remain (the kernel loads 16 bytes per
+// group).  Returns the number of input bytes consumed, a multiple of 12;
+// the caller encodes the rest with the scalar routine.  Only call on CPUs
+// where base::CPU::has_ssse3() is true.
+size_t Base64EncodeBlocksSSSE3(char* dest, const char* src, size_t len);
+
+// Decodes whole 16-character groups of |src| into 12 output bytes each
+// while more than 16 characters remain, leaving the final group (which may
+// carry '=' padding) to the scalar routine.  On success returns true and
+// sets |*consumed| (a multiple of 16) and |*produced|.  Returns false if
+// any character outside the standard alphabet was seen; the input is then
+// invalid as a whole, matching modp_b64_decode.
+bool Base64DecodeBlocksSSSE3(char* dest, const char* src, size_t len,
+                             size_t* consumed, size_t* produced);
+#endif
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_BASE64_INTERNAL_H_
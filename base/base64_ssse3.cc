@@ -0,0 +1,134 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// SSSE3 base64 block functions, using the pshufb lookup technique
+// described by Wojciech Mula ("Base64 encoding and decoding with SSE
+// instructions").  This file is compiled with SSSE3 code generation
+// enabled (see the base_ssse3 target); it must only contain code that is
+// guarded by the runtime CPU check in base64.cc.
+
+#include "base/base64_internal.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+#include <string.h>
+#include <tmmintrin.h>
+
+namespace base {
+namespace internal {
+
+size_t Base64EncodeBlocksSSSE3(char* dest, const char* src, size_t len) {
+  // Spreads each 3-byte input group over a 32-bit lane, with the middle
+  // bytes duplicated so that every output sextet has its source byte pair
+  // in one 16-bit half.
+  const __m128i kSpread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                        7, 6, 8, 7, 10, 9, 11, 10);
+  // Offsets from sextet value to ASCII, indexed by range: 13 for values
+  // 0-25 ('A'-'Z'), 0 for 26-51 ('a'-'z'), 1-10 for 52-61 ('0'-'9'), 11
+  // for 62 ('+') and 12 for 63 ('/').  The range index is computed by the
+  // translation step below.
+  const __m128i kShiftLut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '+' - 62,
+                                          '/' - 63, 'A', 0, 0);
+
+  size_t consumed = 0;
+  while (len - consumed >= 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    in = _mm_shuffle_epi8(in, kSpread);
+
+    // Isolate the two sextets held in the upper bits of each 16-bit half
+    // and shift them down, then the two held in the lower bits and shift
+    // them up, producing one sextet per output byte.
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i sextets = _mm_or_si128(t1, t3);
+
+    // Translate to ASCII: reduce each sextet to one of fourteen ranges and
+    // add the per-range offset from kShiftLut.
+    __m128i offsets = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+    offsets = _mm_or_si128(offsets, _mm_and_si128(less, _mm_set1_epi8(13)));
+    offsets = _mm_shuffle_epi8(kShiftLut, offsets);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                     _mm_add_epi8(sextets, offsets));
+    src += 12;
+    dest += 16;
+    consumed += 12;
+  }
+  return consumed;
+}
+
+bool Base64DecodeBlocksSSSE3(char* dest, const char* src, size_t len,
+                             size_t* consumed, size_t* produced) {
+  // Character validity is checked with a bitmask scheme: the low nibble of
+  // each input byte selects a bit set from kLutLo, the high nibble one from
+  // kLutHi, and a character is legal exactly when the two sets do not
+  // intersect.
+  const __m128i kLutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11,
+                                       0x11, 0x11, 0x11, 0x11,
+                                       0x11, 0x11, 0x13, 0x1a,
+                                       0x1b, 0x1b, 0x1b, 0x1a);
+  const __m128i kLutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02,
+                                       0x04, 0x08, 0x04, 0x08,
+                                       0x10, 0x10, 0x10, 0x10,
+                                       0x10, 0x10, 0x10, 0x10);
+  // Offset from ASCII to sextet value, indexed by the high nibble, with
+  // index 1 special-cased for '/' (the only character whose offset differs
+  // from the rest of its high-nibble row).
+  const __m128i kLutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                         0, 0, 0, 0, 0, 0, 0, 0);
+
+  *consumed = 0;
+  *produced = 0;
+  while (len - *consumed > 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i lo_nibbles = _mm_and_si128(in, _mm_set1_epi8(0x0f));
+    const __m128i hi_nibbles =
+        _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f));
+
+    const __m128i lo = _mm_shuffle_epi8(kLutLo, lo_nibbles);
+    const __m128i hi = _mm_shuffle_epi8(kLutHi, hi_nibbles);
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi),
+                                         _mm_setzero_si128())) != 0)
+      return false;
+
+    // cmpeq yields -1 for '/', bumping its roll index from 2 down to 1.
+    const __m128i eq_slash = _mm_cmpeq_epi8(in, _mm_set1_epi8(0x2f));
+    const __m128i roll =
+        _mm_shuffle_epi8(kLutRoll, _mm_add_epi8(eq_slash, hi_nibbles));
+    const __m128i sextets = _mm_add_epi8(in, roll);
+
+    // Merge the four sextets of each group into a 24-bit value, then pull
+    // the bytes back into big-endian order.
+    const __m128i merged =
+        _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+    const __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    const __m128i out =
+        _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                               14, 13, 12, -1, -1, -1, -1));
+
+    // Only twelve output bytes are valid; store in two pieces so that the
+    // write never runs past the caller's buffer.
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), out);
+    const int last = _mm_cvtsi128_si32(_mm_shuffle_epi32(out, 2));
+    memcpy(dest + 8, &last, 4);
+
+    src += 16;
+    dest += 12;
+    *consumed += 16;
+    *produced += 12;
+  }
+  return true;
+}
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // defined(ARCH_CPU_X86_FAMILY)
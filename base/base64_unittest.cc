@@ -27,3 +27,47 @@ TEST(Base64Test, Basic) {
   EXPECT_TRUE(ok);
   EXPECT_EQ(kText, decoded);
 }
+
+TEST(Base64Test, RoundTripAllLengths) {
+  // Exercise every input length up to a few vector blocks so both the
+  // SIMD fast path (on CPUs that have it) and the scalar tail get covered.
+  std::string input;
+  for (int i = 0; i < 80; ++i) {
+    std::string encoded, decoded;
+    EXPECT_TRUE(base::Base64Encode(input, &encoded));
+    EXPECT_TRUE(base::Base64Decode(encoded, &decoded));
+    EXPECT_EQ(input, decoded) << "length " << i;
+    input.push_back(static_cast<char>(i * 89 + 7));
+  }
+}
+
+TEST(Base64Test, DecodeRejectsInvalidInput) {
+  std::string decoded;
+  // Characters outside the alphabet, anywhere in the input.
+  EXPECT_FALSE(base::Base64Decode("aGVsbG8*d29ybGQhaGVsbG8gd29ybGQh",
+                                  &decoded));
+  EXPECT_FALSE(base::Base64Decode("aGVsbG8gd29ybGQhaGVsbG8gd29ybGQ*",
+                                  &decoded));
+  // Whitespace is not accepted either.
+  EXPECT_FALSE(base::Base64Decode("aGVs bG8=", &decoded));
+  // Mid-input padding.
+  EXPECT_FALSE(base::Base64Decode("aGVsbG8=d29ybGQhaGVsbG8gd29ybGQh",
+                                  &decoded));
+  // Lengths that are not a multiple of four.
+  EXPECT_FALSE(base::Base64Decode("aGVsbG8gd29ybGQhaGVsbG8gd29ybGQ",
+                                  &decoded));
+}
+
+TEST(Base64Test, AppendVariants) {
+  std::string buffer = "data:image/png;base64,";
+  EXPECT_TRUE(base::Base64EncodeAppend("hello world", &buffer));
+  EXPECT_EQ("data:image/png;base64,aGVsbG8gd29ybGQ=", buffer);
+
+  std::string decoded = "prefix-";
+  EXPECT_TRUE(base::Base64DecodeAppend("aGVsbG8gd29ybGQ=", &decoded));
+  EXPECT_EQ("prefix-hello world", decoded);
+
+  // A failed decode must leave the output untouched.
+  EXPECT_FALSE(base::Base64DecodeAppend("not*valid", &decoded));
+  EXPECT_EQ("prefix-hello world", decoded);
+}
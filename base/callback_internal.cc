@@ -4,11 +4,111 @@
 
 #include "base/callback_internal.h"
 
+#include <stdlib.h>
+
 #include "base/logging.h"
+#include "base/threading/thread_local_storage.h"
 
 namespace base {
 namespace internal {
 
+namespace {
+
+// Allocation sizes are rounded up to a multiple of kQuantum, and anything at
+// most kMaxCachedSize ends up on a per-thread free list with one bucket per
+// size class.  64 bytes covers a BindState holding a method pointer and a
+// handful of bound arguments, i.e. nearly every Bind() call site; larger
+// states fall through to the normal heap.  Each bucket is capped so that a
+// burst of callbacks does not pin memory forever.
+const size_t kQuantum = 16;
+const size_t kMaxCachedSize = 64;
+const size_t kNumSizeClasses = kMaxCachedSize / kQuantum;
+const size_t kMaxBlocksPerClass = 64;
+
+// Overlays the first word of a cached block.  Safe because every size class
+// is at least pointer-sized, and the block holds no live object while it is
+// on the free list.
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct BindStateCache {
+  FreeBlock* free_lists[kNumSizeClasses];
+  size_t free_counts[kNumSizeClasses];
+};
+
+ThreadLocalStorage::StaticSlot g_bind_state_tls = TLS_INITIALIZER;
+
+void FreeBindStateCache(void* data) {
+  BindStateCache* cache = static_cast<BindStateCache*>(data);
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    FreeBlock* block = cache->free_lists[i];
+    while (block) {
+      FreeBlock* next = block->next;
+      ::operator delete(block);
+      block = next;
+    }
+  }
+  free(cache);
+}
+
+BindStateCache* GetBindStateCache() {
+  if (!g_bind_state_tls.initialized())
+    g_bind_state_tls.Initialize(FreeBindStateCache);
+  BindStateCache* cache = static_cast<BindStateCache*>(g_bind_state_tls.Get());
+  if (!cache) {
+    cache = static_cast<BindStateCache*>(calloc(1, sizeof(BindStateCache)));
+    g_bind_state_tls.Set(cache);
+  }
+  return cache;
+}
+
+// Like GetBindStateCache(), but never creates the cache.  The release path
+// uses this so that a BindState destroyed during thread shutdown, after the
+// TLS destructor has already run, does not resurrect a cache that would
+// then leak.
+BindStateCache* GetBindStateCacheIfExists() {
+  if (!g_bind_state_tls.initialized())
+    return NULL;
+  return static_cast<BindStateCache*>(g_bind_state_tls.Get());
+}
+
+}  // namespace
+
+// static
+void* BindStateBase::operator new(size_t size) {
+  if (size <= kMaxCachedSize) {
+    const size_t size_class = (size - 1) / kQuantum;
+    BindStateCache* cache = GetBindStateCache();
+    FreeBlock* block = cache->free_lists[size_class];
+    if (block) {
+      cache->free_lists[size_class] = block->next;
+      cache->free_counts[size_class]--;
+      return block;
+    }
+    // Carve fresh blocks at the full class size so that any BindState in
+    // the same class can reuse them later.
+    return ::operator new((size_class + 1) * kQuantum);
+  }
+  return ::operator new(size);
+}
+
+// static
+void BindStateBase::operator delete(void* ptr, size_t size) {
+  if (size <= kMaxCachedSize) {
+    const size_t size_class = (size - 1) / kQuantum;
+    BindStateCache* cache = GetBindStateCacheIfExists();
+    if (cache && cache->free_counts[size_class] < kMaxBlocksPerClass) {
+      FreeBlock* block = static_cast<FreeBlock*>(ptr);
+      block->next = cache->free_lists[size_class];
+      cache->free_lists[size_class] = block;
+      cache->free_counts[size_class]++;
+      return;
+    }
+  }
+  ::operator delete(ptr);
+}
+
 bool CallbackBase::is_null() const {
   return bind_state_.get() == NULL;
 }
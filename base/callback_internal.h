@@ -28,6 +28,18 @@ namespace internal {
 // us to shield the Callback class from the types of the bound argument via
 // "type erasure."
 class BindStateBase : public RefCountedThreadSafe<BindStateBase> {
+ public:
+  // BindStates are small, are created on every base::Bind() call, and die
+  // when the last Callback referencing them does, which makes them one of
+  // the hottest allocation patterns in the browser.  Serve the common sizes
+  // from a per-thread free list instead of the general-purpose heap so that
+  // posting a task does not touch the allocator locks.  Only the sized form
+  // of operator delete is declared; because the destructor is virtual, the
+  // compiler passes the most-derived size, which tells us which free list
+  // the block belongs to.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
  protected:
   friend class RefCountedThreadSafe<BindStateBase>;
   virtual ~BindStateBase() {}
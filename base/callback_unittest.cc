@@ -145,5 +145,27 @@ TEST_F(CallbackTest, ResetAndReturn) {
   ASSERT_TRUE(tfr.cb_already_run);
 }
 
+TEST_F(CallbackTest, BindStateAllocationReuse) {
+  // Small BindStates are recycled through a per-thread free list; a block
+  // released on this thread should be handed straight back on the next
+  // same-sized allocation.
+  void* first = internal::BindStateBase::operator new(48);
+  ASSERT_TRUE(first != NULL);
+  internal::BindStateBase::operator delete(first, 48);
+  void* second = internal::BindStateBase::operator new(48);
+  EXPECT_EQ(first, second);
+  internal::BindStateBase::operator delete(second, 48);
+
+  // Sizes within the same 16-byte class share a free list.
+  void* third = internal::BindStateBase::operator new(33);
+  EXPECT_EQ(first, third);
+  internal::BindStateBase::operator delete(third, 33);
+
+  // Oversized states bypass the cache and must still round-trip.
+  void* large = internal::BindStateBase::operator new(256);
+  ASSERT_TRUE(large != NULL);
+  internal::BindStateBase::operator delete(large, 256);
+}
+
 }  // namespace
 }  // namespace base
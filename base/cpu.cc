@@ -30,6 +30,7 @@ CPU::CPU()
     has_ssse3_(false),
     has_sse41_(false),
     has_sse42_(false),
+    has_non_stop_time_stamp_counter_(false),
     cpu_vendor_("unknown") {
   Initialize();
 }
@@ -119,6 +120,15 @@ void CPU::Initialize() {
     has_sse41_ = (cpu_info[2] & 0x00080000) != 0;
     has_sse42_ = (cpu_info[2] & 0x00100000) != 0;
   }
+
+  // Get the invariant-TSC bit from the extended power management leaf. Bit 8
+  // of EDX is set when the time-stamp counter is both constant-rate and
+  // non-stop; see the "Invariant TSC" section of the Intel SDM.
+  __cpuid(cpu_info, 0x80000000);
+  if (static_cast<unsigned int>(cpu_info[0]) >= 0x80000007) {
+    __cpuid(cpu_info, 0x80000007);
+    has_non_stop_time_stamp_counter_ = (cpu_info[3] & (1 << 8)) != 0;
+  }
 #endif
 }
 
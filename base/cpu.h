@@ -33,6 +33,11 @@ class BASE_EXPORT CPU {
   int has_ssse3() const { return has_ssse3_; }
   int has_sse41() const { return has_sse41_; }
   int has_sse42() const { return has_sse42_; }
+  // True if the time-stamp counter runs at a constant rate and keeps counting
+  // in deep C-states, so it can be used as a wall-clock time source.
+  bool has_non_stop_time_stamp_counter() const {
+    return has_non_stop_time_stamp_counter_;
+  }
 
  private:
   // Query the processor for CPUID information.
@@ -51,6 +56,7 @@ class BASE_EXPORT CPU {
   bool has_ssse3_;
   bool has_sse41_;
   bool has_sse42_;
+  bool has_non_stop_time_stamp_counter_;
   std::string cpu_vendor_;
 };
 
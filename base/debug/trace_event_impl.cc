@@ -6,6 +6,7 @@
 
 #include <algorithm>
 
+#include "base/atomicops.h"
 #include "base/bind.h"
 #include "base/debug/trace_event.h"
 #include "base/file_util.h"
@@ -43,6 +44,10 @@ namespace debug {
 const size_t kTraceEventBufferSize = 500000;
 const size_t kTraceEventBatchSize = 1000;
 
+// Each thread accumulates events in its own fixed-size buffer and spills
+// them to the shared vector under the lock when the buffer fills up.
+const size_t kThreadTraceEventBufferSize = 1024;
+
 #define TRACE_EVENT_MAX_CATEGORIES 100
 
 namespace {
@@ -267,6 +272,79 @@ void TraceEvent::AppendAsJSON(std::string* out) const {
   *out += "}";
 }
 
+// static
+void TraceEvent::AppendEventsAsBinary(const std::vector<TraceEvent>& events,
+                                      size_t start,
+                                      size_t count,
+                                      std::string* out) {
+  for (size_t i = 0; i < count && start + i < events.size(); ++i)
+    events[i + start].AppendAsBinary(out);
+}
+
+// Binary record layout, in the native byte order of the capturing
+// machine:
+//   uint32  size of the rest of the record in bytes
+//   int64   timestamp (TimeTicks internal value)
+//   uint64  id
+//   int32   thread id
+//   uint8   phase
+//   uint8   flags
+//   uint8   number of arguments
+//   category name, NUL-terminated
+//   event name, NUL-terminated
+// and then per argument: a uint8 type, the NUL-terminated argument name,
+// and either a NUL-terminated string value (for the string types) or the
+// raw 8-byte value union.  The leading size lets a reader skip records it
+// does not understand.
+void TraceEvent::AppendAsBinary(std::string* out) const {
+  const size_t size_offset = out->size();
+  uint32 record_size = 0;
+  out->append(reinterpret_cast<const char*>(&record_size),
+              sizeof(record_size));
+  const size_t record_start = out->size();
+
+  int64 time_int64 = timestamp_.ToInternalValue();
+  uint64 id = static_cast<uint64>(id_);
+  int32 thread_id = thread_id_;
+  uint8 phase = static_cast<uint8>(phase_);
+  uint8 flags = flags_;
+  uint8 num_args = 0;
+  for (int i = 0; i < kTraceMaxNumArgs && arg_names_[i]; ++i)
+    ++num_args;
+
+  out->append(reinterpret_cast<const char*>(&time_int64),
+              sizeof(time_int64));
+  out->append(reinterpret_cast<const char*>(&id), sizeof(id));
+  out->append(reinterpret_cast<const char*>(&thread_id), sizeof(thread_id));
+  out->append(reinterpret_cast<const char*>(&phase), sizeof(phase));
+  out->append(reinterpret_cast<const char*>(&flags), sizeof(flags));
+  out->append(reinterpret_cast<const char*>(&num_args), sizeof(num_args));
+  out->append(TraceLog::GetCategoryName(category_enabled_));
+  out->push_back('\0');
+  out->append(name_);
+  out->push_back('\0');
+
+  for (int i = 0; i < num_args; ++i) {
+    uint8 type = arg_types_[i];
+    out->append(reinterpret_cast<const char*>(&type), sizeof(type));
+    out->append(arg_names_[i]);
+    out->push_back('\0');
+    if (arg_types_[i] == TRACE_VALUE_TYPE_STRING ||
+        arg_types_[i] == TRACE_VALUE_TYPE_COPY_STRING) {
+      out->append(arg_values_[i].as_string ? arg_values_[i].as_string : "");
+      out->push_back('\0');
+    } else {
+      out->append(reinterpret_cast<const char*>(&arg_values_[i]),
+                  sizeof(arg_values_[i]));
+    }
+  }
+
+  // Now that the record is written its size is known; patch it in.
+  record_size = static_cast<uint32>(out->size() - record_start);
+  memcpy(string_as_array(out) + size_offset, &record_size,
+         sizeof(record_size));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // TraceResultBuffer
@@ -310,6 +388,119 @@ void TraceResultBuffer::Finish() {
   output_callback_.Run("]");
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// TraceThreadBuffer
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// A fixed-size event buffer owned by a single writer thread.  The owner
+// appends events with no locking and publishes them by bumping the event
+// count with a release store, so category-enabled tracing costs little more
+// than constructing the TraceEvent.  Everything else -- merging a full
+// buffer into the shared vector, copying events out at flush time, and
+// unwinding a below-threshold begin event -- is rare and runs under
+// TraceLog::lock_.
+class TraceThreadBuffer {
+ public:
+  TraceThreadBuffer()
+      : events_(kThreadTraceEventBufferSize),
+        count_(0),
+        flushed_count_(0),
+        spilled_count_(0) {
+  }
+
+  // Sequence number the next appended event will get.  Sequence numbers are
+  // stable across spills and flushes, which makes them suitable as the begin
+  // ids handed out by AddTraceEvent.  Owner thread only.
+  int64 next_sequence() const {
+    return spilled_count_ + subtle::NoBarrier_Load(&count_);
+  }
+
+  // Appends an event; returns false if the buffer is out of room.  Owner
+  // thread only.
+  bool AddEvent(const TraceEvent& event) {
+    size_t count = static_cast<size_t>(subtle::NoBarrier_Load(&count_));
+    if (count >= events_.size())
+      return false;
+    events_[count] = event;
+    subtle::Release_Store(&count_, static_cast<subtle::AtomicWord>(count + 1));
+    return true;
+  }
+
+  // Returns the buffered event with the given sequence number, or NULL if it
+  // was already spilled to the shared vector.  Owner thread only.
+  const TraceEvent* GetEventBySequence(int64 sequence) const {
+    int64 offset = sequence - spilled_count_;
+    if (offset < 0 || offset >= subtle::NoBarrier_Load(&count_))
+      return NULL;
+    return &events_[static_cast<size_t>(offset)];
+  }
+
+  // Removes a buffered event that has not been output yet; returns false if
+  // the event was already handed to the output callback.  Removal shifts the
+  // sequence numbers of later events, exactly as erasing from the shared
+  // vector used to shift begin ids; since end events are LIFO, outstanding
+  // begin events always precede the removed event and keep their numbers.
+  // Owner thread only, TraceLog::lock_ must be held.
+  bool RemoveEventBySequence(int64 sequence) {
+    size_t count = static_cast<size_t>(subtle::NoBarrier_Load(&count_));
+    int64 offset = sequence - spilled_count_;
+    if (offset < static_cast<int64>(flushed_count_) ||
+        offset >= static_cast<int64>(count))
+      return false;
+    for (size_t i = static_cast<size_t>(offset); i + 1 < count; ++i)
+      events_[i] = events_[i + 1];
+    events_[count - 1] = TraceEvent();
+    subtle::Release_Store(&count_, static_cast<subtle::AtomicWord>(count - 1));
+    return true;
+  }
+
+  // Moves events that have not been output yet into |out|, dropping whatever
+  // does not fit in |room|, and resets the buffer.  Owner thread only,
+  // TraceLog::lock_ must be held.
+  void Spill(std::vector<TraceEvent>* out, size_t room) {
+    size_t count = static_cast<size_t>(subtle::NoBarrier_Load(&count_));
+    size_t take = std::min(room, count - flushed_count_);
+    for (size_t i = flushed_count_; i < flushed_count_ + take; ++i)
+      out->push_back(events_[i]);
+    // Reset the slots so parameter copies are released promptly.
+    for (size_t i = 0; i < count; ++i)
+      events_[i] = TraceEvent();
+    spilled_count_ += count;
+    flushed_count_ = 0;
+    subtle::Release_Store(&count_, 0);
+  }
+
+  // Copies events that have not been handed to the output callback yet into
+  // |out| without disturbing the owner thread; the acquire load of the count
+  // pairs with the owner's release store in AddEvent.  Any thread,
+  // TraceLog::lock_ must be held.
+  void Flush(std::vector<TraceEvent>* out) {
+    size_t count = static_cast<size_t>(subtle::Acquire_Load(&count_));
+    for (size_t i = flushed_count_; i < count; ++i)
+      out->push_back(events_[i]);
+    flushed_count_ = count;
+  }
+
+  // Test inspection of events not yet output.  TraceLog::lock_ must be held.
+  size_t unflushed_size() const {
+    return static_cast<size_t>(subtle::Acquire_Load(&count_)) - flushed_count_;
+  }
+  const TraceEvent& unflushed_event(size_t index) const {
+    DCHECK(index < unflushed_size());
+    return events_[flushed_count_ + index];
+  }
+
+ private:
+  std::vector<TraceEvent> events_;  // Fixed size; first count_ slots in use.
+  subtle::AtomicWord count_;        // Published events; written by owner.
+  size_t flushed_count_;            // Events already output.
+  int64 spilled_count_;             // Events ever removed by spills.
+
+  DISALLOW_COPY_AND_ASSIGN(TraceThreadBuffer);
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // TraceLog
@@ -323,6 +514,7 @@ TraceLog* TraceLog::GetInstance() {
 
 TraceLog::TraceLog()
     : enabled_(false)
+    , output_format_(OUTPUT_JSON)
     , dispatching_to_observer_list_(false) {
   // Trace is enabled or disabled on one thread while other threads are
   // accessing the enabled flag. We don't care whether edge-case events are
@@ -343,6 +535,36 @@ TraceLog::TraceLog()
 }
 
 TraceLog::~TraceLog() {
+  STLDeleteElements(&thread_buffers_);
+}
+
+size_t TraceLog::GetEventsSize() {
+  AutoLock lock(lock_);
+  size_t size = logged_events_.size();
+  TraceThreadBuffer* buffer = thread_buffer_tls_.Get();
+  if (buffer)
+    size += buffer->unflushed_size();
+  return size;
+}
+
+const TraceEvent& TraceLog::GetEventAt(size_t index) {
+  AutoLock lock(lock_);
+  if (index < logged_events_.size())
+    return logged_events_[index];
+  TraceThreadBuffer* buffer = thread_buffer_tls_.Get();
+  DCHECK(buffer);
+  return buffer->unflushed_event(index - logged_events_.size());
+}
+
+TraceThreadBuffer* TraceLog::GetThreadBuffer() {
+  TraceThreadBuffer* buffer = thread_buffer_tls_.Get();
+  if (buffer)
+    return buffer;
+  buffer = new TraceThreadBuffer();
+  thread_buffer_tls_.Set(buffer);
+  AutoLock lock(lock_);
+  thread_buffers_.push_back(buffer);
+  return buffer;
 }
 
 const unsigned char* TraceLog::GetCategoryEnabled(const char* name) {
@@ -543,6 +765,12 @@ void TraceLog::SetOutputCallback(const TraceLog::OutputCallback& cb) {
   output_callback_ = cb;
 }
 
+void TraceLog::SetOutputFormat(OutputFormat format) {
+  AutoLock lock(lock_);
+  DCHECK(!enabled_);
+  output_format_ = format;
+}
+
 void TraceLog::SetBufferFullCallback(const TraceLog::BufferFullCallback& cb) {
   AutoLock lock(lock_);
   buffer_full_callback_ = cb;
@@ -551,10 +779,17 @@ void TraceLog::SetBufferFullCallback(const TraceLog::BufferFullCallback& cb) {
 void TraceLog::Flush() {
   std::vector<TraceEvent> previous_logged_events;
   OutputCallback output_callback_copy;
+  OutputFormat output_format_copy;
   {
     AutoLock lock(lock_);
     previous_logged_events.swap(logged_events_);
+    // Gather the events still sitting in per-thread buffers.  Writers
+    // publish events with a release store of their buffer's count, so
+    // everything below the count observed here is safe to copy.
+    for (size_t i = 0; i < thread_buffers_.size(); ++i)
+      thread_buffers_[i]->Flush(&previous_logged_events);
     output_callback_copy = output_callback_;
+    output_format_copy = output_format_;
   }  // release lock
 
   if (output_callback_copy.is_null())
@@ -563,13 +798,20 @@ void TraceLog::Flush() {
   for (size_t i = 0;
        i < previous_logged_events.size();
        i += kTraceEventBatchSize) {
-    scoped_refptr<RefCountedString> json_events_str_ptr =
+    scoped_refptr<RefCountedString> events_str_ptr =
         new RefCountedString();
-    TraceEvent::AppendEventsAsJSON(previous_logged_events,
-                                   i,
-                                   kTraceEventBatchSize,
-                                   &(json_events_str_ptr->data()));
-    output_callback_copy.Run(json_events_str_ptr);
+    if (output_format_copy == OUTPUT_BINARY) {
+      TraceEvent::AppendEventsAsBinary(previous_logged_events,
+                                       i,
+                                       kTraceEventBatchSize,
+                                       &(events_str_ptr->data()));
+    } else {
+      TraceEvent::AppendEventsAsJSON(previous_logged_events,
+                                     i,
+                                     kTraceEventBatchSize,
+                                     &(events_str_ptr->data()));
+    }
+    output_callback_copy.Run(events_str_ptr);
   }
 }
 
@@ -586,81 +828,91 @@ int TraceLog::AddTraceEvent(char phase,
                             unsigned char flags) {
   DCHECK(name);
   TimeTicks now = TimeTicks::NowFromSystemTraceTime();
-  BufferFullCallback buffer_full_callback_copy;
-  int ret_begin_id = -1;
-  {
+  if (!*category_enabled)
+    return -1;
+
+  int thread_id = static_cast<int>(PlatformThread::CurrentId());
+
+  const char* new_name = PlatformThread::GetName();
+  // Check if the thread name has been set or changed since the previous
+  // call (if any), but don't bother if the new name is empty. Note this will
+  // not detect a thread name change within the same char* buffer address: we
+  // favor common case performance over corner case correctness.
+  if (new_name != g_current_thread_name.Get().Get() &&
+      new_name && *new_name) {
+    g_current_thread_name.Get().Set(new_name);
     AutoLock lock(lock_);
-    if (!*category_enabled)
-      return -1;
-    if (logged_events_.size() >= kTraceEventBufferSize)
-      return -1;
-
-    int thread_id = static_cast<int>(PlatformThread::CurrentId());
-
-    const char* new_name = PlatformThread::GetName();
-    // Check if the thread name has been set or changed since the previous
-    // call (if any), but don't bother if the new name is empty. Note this will
-    // not detect a thread name change within the same char* buffer address: we
-    // favor common case performance over corner case correctness.
-    if (new_name != g_current_thread_name.Get().Get() &&
-        new_name && *new_name) {
-      g_current_thread_name.Get().Set(new_name);
-      base::hash_map<int, std::string>::iterator existing_name =
-          thread_names_.find(thread_id);
-      if (existing_name == thread_names_.end()) {
-        // This is a new thread id, and a new name.
-        thread_names_[thread_id] = new_name;
-      } else {
-        // This is a thread id that we've seen before, but potentially with a
-        // new name.
-        std::vector<base::StringPiece> existing_names;
-        Tokenize(existing_name->second, ",", &existing_names);
-        bool found = std::find(existing_names.begin(),
-                               existing_names.end(),
-                               new_name) != existing_names.end();
-        if (!found) {
-          existing_name->second.push_back(',');
-          existing_name->second.append(new_name);
-        }
+    base::hash_map<int, std::string>::iterator existing_name =
+        thread_names_.find(thread_id);
+    if (existing_name == thread_names_.end()) {
+      // This is a new thread id, and a new name.
+      thread_names_[thread_id] = new_name;
+    } else {
+      // This is a thread id that we've seen before, but potentially with a
+      // new name.
+      std::vector<base::StringPiece> existing_names;
+      Tokenize(existing_name->second, ",", &existing_names);
+      bool found = std::find(existing_names.begin(),
+                             existing_names.end(),
+                             new_name) != existing_names.end();
+      if (!found) {
+        existing_name->second.push_back(',');
+        existing_name->second.append(new_name);
       }
     }
+  }
+
+  TraceThreadBuffer* buffer = GetThreadBuffer();
 
-    if (threshold_begin_id > -1) {
-      DCHECK(phase == TRACE_EVENT_PHASE_END);
-      size_t begin_i = static_cast<size_t>(threshold_begin_id);
-      // Return now if there has been a flush since the begin event was posted.
-      if (begin_i >= logged_events_.size())
-        return -1;
+  if (threshold_begin_id > -1) {
+    DCHECK(phase == TRACE_EVENT_PHASE_END);
+    // Begin/end pairs are recorded by the same thread, so the begin event is
+    // in this thread's buffer unless it was spilled; in that case we can no
+    // longer compute the elapsed time, so keep the pair.
+    const TraceEvent* begin_event =
+        buffer->GetEventBySequence(threshold_begin_id);
+    if (begin_event) {
       // Determine whether to drop the begin/end pair.
-      TimeDelta elapsed = now - logged_events_[begin_i].timestamp();
+      TimeDelta elapsed = now - begin_event->timestamp();
       if (elapsed < TimeDelta::FromMicroseconds(threshold)) {
-        // Remove begin event and do not add end event.
-        // This will be expensive if there have been other events in the
-        // mean time (should be rare).
-        logged_events_.erase(logged_events_.begin() + begin_i);
-        return -1;
+        // Remove begin event and do not add end event, unless the begin
+        // event was already handed to the output callback and cannot be
+        // unwritten.
+        AutoLock lock(lock_);
+        if (buffer->RemoveEventBySequence(threshold_begin_id))
+          return -1;
       }
     }
+  }
 
-    if (flags & TRACE_EVENT_FLAG_MANGLE_ID)
-      id ^= process_id_hash_;
+  if (flags & TRACE_EVENT_FLAG_MANGLE_ID)
+    id ^= process_id_hash_;
 
-    ret_begin_id = static_cast<int>(logged_events_.size());
-    logged_events_.push_back(
-        TraceEvent(thread_id,
+  TraceEvent event(thread_id,
                    now, phase, category_enabled, name, id,
                    num_args, arg_names, arg_types, arg_values,
-                   flags));
-
-    if (logged_events_.size() == kTraceEventBufferSize) {
-      buffer_full_callback_copy = buffer_full_callback_;
-    }
-  }  // release lock
-
-  if (!buffer_full_callback_copy.is_null())
-    buffer_full_callback_copy.Run();
+                   flags);
+  if (!buffer->AddEvent(event)) {
+    // The thread's buffer is full: spill it into the shared vector, dropping
+    // events that don't fit there either, and retry.
+    BufferFullCallback buffer_full_callback_copy;
+    {
+      AutoLock lock(lock_);
+      size_t old_size = logged_events_.size();
+      size_t room = old_size < kTraceEventBufferSize ?
+          kTraceEventBufferSize - old_size : 0;
+      buffer->Spill(&logged_events_, room);
+      buffer->AddEvent(event);
+      if (old_size < kTraceEventBufferSize &&
+          logged_events_.size() >= kTraceEventBufferSize) {
+        buffer_full_callback_copy = buffer_full_callback_;
+      }
+    }  // release lock
+    if (!buffer_full_callback_copy.is_null())
+      buffer_full_callback_copy.Run();
+  }
 
-  return ret_begin_id;
+  return static_cast<int>(buffer->next_sequence() - 1);
 }
 
 void TraceLog::AddTraceEventEtw(char phase,
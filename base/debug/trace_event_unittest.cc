@@ -643,6 +643,49 @@ TEST_F(TraceEventTestFixture, DataCaptured) {
   ValidateAllTraceMacrosCreatedData(trace_parsed_);
 }
 
+namespace {
+
+void CollectBinaryChunk(std::string* out,
+                        const scoped_refptr<base::RefCountedString>& chunk) {
+  *out += chunk->data();
+}
+
+}  // namespace
+
+TEST_F(TraceEventTestFixture, BinaryOutputFormat) {
+  ManualTestSetUp();
+
+  TraceLog* trace_log = TraceLog::GetInstance();
+  std::string binary;
+  trace_log->SetOutputFormat(TraceLog::OUTPUT_BINARY);
+  trace_log->SetOutputCallback(
+      base::Bind(&CollectBinaryChunk, base::Unretained(&binary)));
+  trace_log->SetEnabled(true);
+  TRACE_EVENT_INSTANT0("binary_cat", "binary_event");
+  trace_log->SetEnabled(false);
+
+  // Put the log back the way the other tests expect it.
+  trace_log->SetOutputFormat(TraceLog::OUTPUT_JSON);
+
+  // Walk the stream using the leading size fields; it must end exactly on
+  // a record boundary and contain the event emitted above.
+  bool found_event = false;
+  size_t offset = 0;
+  while (offset + sizeof(uint32) <= binary.size()) {
+    uint32 record_size = 0;
+    binary.copy(reinterpret_cast<char*>(&record_size), sizeof(record_size),
+                offset);
+    offset += sizeof(record_size);
+    ASSERT_LE(offset + record_size, binary.size());
+    if (binary.substr(offset, record_size).find("binary_event") !=
+        std::string::npos)
+      found_event = true;
+    offset += record_size;
+  }
+  EXPECT_EQ(binary.size(), offset);
+  EXPECT_TRUE(found_event);
+}
+
 class MockEnabledStateChangedObserver :
       public base::debug::TraceLog::EnabledStateChangedObserver {
  public:
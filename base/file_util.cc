@@ -11,6 +11,7 @@
 
 #include <fstream>
 
+#include "base/callback.h"
 #include "base/file_path.h"
 #include "base/logging.h"
 #include "base/stringprintf.h"
@@ -168,6 +169,41 @@ bool ReadFileToString(const FilePath& path, std::string* contents) {
   return true;
 }
 
+bool ReadFileToStringPiece(const FilePath& path,
+                           MemoryMappedFile* mapped_file,
+                           base::StringPiece* contents) {
+  DCHECK(mapped_file);
+  if (!mapped_file->Initialize(path))
+    return false;
+
+  if (contents) {
+    *contents = base::StringPiece(
+        reinterpret_cast<const char*>(mapped_file->data()),
+        mapped_file->length());
+  }
+  return true;
+}
+
+bool ReadFileInChunks(const FilePath& path,
+                      const ReadFileChunkCallback& callback) {
+  FILE* file = OpenFile(path, "rb");
+  if (!file)
+    return false;
+
+  bool completed = true;
+  char buf[1 << 16];
+  size_t len;
+  while ((len = fread(buf, 1, sizeof(buf), file)) > 0) {
+    if (!callback.Run(buf, len)) {
+      completed = false;
+      break;
+    }
+  }
+  CloseFile(file);
+
+  return completed;
+}
+
 bool IsDirectoryEmpty(const FilePath& dir_path) {
   FileEnumerator files(dir_path, false,
       static_cast<FileEnumerator::FileType>(
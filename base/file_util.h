@@ -27,10 +27,12 @@
 
 #include "base/base_export.h"
 #include "base/basictypes.h"
+#include "base/callback_forward.h"
 #include "base/file_path.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/platform_file.h"
 #include "base/string16.h"
+#include "base/string_piece.h"
 
 #if defined(OS_POSIX)
 #include "base/eintr_wrapper.h"
@@ -44,6 +46,8 @@ class Time;
 
 namespace file_util {
 
+class MemoryMappedFile;
+
 extern bool g_bug108724_debug;
 
 //-----------------------------------------------------------------------------
@@ -179,6 +183,27 @@ BASE_EXPORT bool TextContentsEqual(const FilePath& filename1,
 // Useful for unit tests.
 BASE_EXPORT bool ReadFileToString(const FilePath& path, std::string* contents);
 
+// Maps the file at |path| into memory and points |contents| at the mapping,
+// returning true on success.  Unlike ReadFileToString, no bytes are copied
+// and no heap is consumed, so this is preferable for large read-only files
+// such as data packs and dictionaries.  |contents| is only valid while
+// |mapped_file| stays alive and mapped; |contents| may be NULL if the caller
+// only wants the mapping itself.
+BASE_EXPORT bool ReadFileToStringPiece(const FilePath& path,
+                                       MemoryMappedFile* mapped_file,
+                                       base::StringPiece* contents);
+
+// Reads the file at |path| a chunk at a time, invoking |callback| with each
+// chunk in order.  Returns false if the file could not be opened or if the
+// callback returned false to abort the read; returns true once the whole
+// file has been delivered.  The data passed to the callback is only valid
+// for the duration of that call.  Unlike ReadFileToString, memory use is
+// bounded by the chunk size regardless of how large the file is.
+typedef base::Callback<bool(const char* data, size_t size)>
+    ReadFileChunkCallback;
+BASE_EXPORT bool ReadFileInChunks(const FilePath& path,
+                                  const ReadFileChunkCallback& callback);
+
 #if defined(OS_POSIX)
 // Read exactly |bytes| bytes from file descriptor |fd|, storing the result
 // in |buffer|. This function is protected against EINTR and partial reads.
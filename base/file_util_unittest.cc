@@ -17,6 +17,7 @@
 #include <set>
 
 #include "base/base_paths.h"
+#include "base/bind.h"
 #include "base/file_path.h"
 #include "base/file_util.h"
 #include "base/path_service.h"
@@ -201,6 +202,17 @@ std::wstring ReadTextFile(const FilePath& filename) {
   return std::wstring(contents);
 }
 
+// Appends each chunk delivered by ReadFileInChunks to |dest|.
+bool AppendChunk(std::string* dest, const char* data, size_t size) {
+  dest->append(data, size);
+  return true;
+}
+
+// A ReadFileInChunks callback that immediately aborts the read.
+bool AbortRead(const char* data, size_t size) {
+  return false;
+}
+
 #if defined(OS_WIN)
 uint64 FileTimeAsUint64(const FILETIME& ft) {
   ULARGE_INTEGER u;
@@ -1538,6 +1550,57 @@ TEST_F(FileUtilTest, GetTempDirTest) {
 }
 #endif  // OS_WIN
 
+TEST_F(FileUtilTest, ReadFileToStringPiece) {
+  FilePath file_path = temp_dir_.path().Append(FPL("mapped.txt"));
+  const std::string kContents("0123456789");
+  ASSERT_EQ(static_cast<int>(kContents.size()),
+            file_util::WriteFile(file_path, kContents.data(),
+                                 kContents.size()));
+
+  file_util::MemoryMappedFile mapped_file;
+  base::StringPiece contents;
+  ASSERT_TRUE(file_util::ReadFileToStringPiece(file_path, &mapped_file,
+                                               &contents));
+  EXPECT_EQ(kContents, contents.as_string());
+  // The data must come straight from the mapping, not a copy.
+  EXPECT_EQ(reinterpret_cast<const char*>(mapped_file.data()),
+            contents.data());
+
+  // |contents| may be NULL when only the mapping is wanted.
+  file_util::MemoryMappedFile mapped_file2;
+  EXPECT_TRUE(file_util::ReadFileToStringPiece(file_path, &mapped_file2,
+                                               NULL));
+
+  // A nonexistent file fails.
+  file_util::MemoryMappedFile mapped_file3;
+  EXPECT_FALSE(file_util::ReadFileToStringPiece(
+      temp_dir_.path().Append(FPL("nonexistent.txt")), &mapped_file3, NULL));
+}
+
+TEST_F(FileUtilTest, ReadFileInChunks) {
+  FilePath file_path = temp_dir_.path().Append(FPL("chunked.txt"));
+  const std::string kContents("chunk me, please");
+  ASSERT_EQ(static_cast<int>(kContents.size()),
+            file_util::WriteFile(file_path, kContents.data(),
+                                 kContents.size()));
+
+  std::string read_back;
+  EXPECT_TRUE(file_util::ReadFileInChunks(file_path,
+                                          base::Bind(&AppendChunk,
+                                                     &read_back)));
+  EXPECT_EQ(kContents, read_back);
+
+  // Returning false from the callback aborts the read, which is reported
+  // as failure.
+  EXPECT_FALSE(file_util::ReadFileInChunks(file_path,
+                                           base::Bind(&AbortRead)));
+
+  // A nonexistent file fails without running the callback.
+  EXPECT_FALSE(file_util::ReadFileInChunks(
+      temp_dir_.path().Append(FPL("nonexistent.txt")),
+      base::Bind(&AbortRead)));
+}
+
 TEST_F(FileUtilTest, CreateTemporaryFileTest) {
   FilePath temp_files[3];
   for (int i = 0; i < 3; i++) {
@@ -5,6 +5,7 @@
 #include "base/i18n/case_conversion.h"
 
 #include "base/string16.h"
+#include "base/string_util.h"
 #include "unicode/unistr.h"
 
 namespace base {
@@ -22,5 +23,20 @@ string16 ToUpper(const StringPiece16& string) {
   return string16(unicode_string.getBuffer(), unicode_string.length());
 }
 
+string16 FoldCase(const StringPiece16& string) {
+  // Unlike ToLower(), case folding is locale-independent, so it is safe to
+  // handle the common all-ASCII case with the ASCII lowering table and skip
+  // ICU entirely.  (An ASCII shortcut would be wrong for ToLower(), which
+  // must map 'I' to a dotless i under a Turkish default locale.)
+  string16 folded(string.data(), string.size());
+  if (IsStringASCII(folded)) {
+    StringToLowerASCII(&folded);
+    return folded;
+  }
+  icu::UnicodeString unicode_string(string.data(), string.size());
+  unicode_string.foldCase();
+  return string16(unicode_string.getBuffer(), unicode_string.length());
+}
+
 }  // namespace i18n
 }  // namespace base
@@ -19,6 +19,14 @@ BASE_I18N_EXPORT string16 ToLower(const StringPiece16& string);
 // Returns the upper case equivalent of string. Uses ICU's default locale.
 BASE_I18N_EXPORT string16 ToUpper(const StringPiece16& string);
 
+// Returns the locale-independent case-folded equivalent of string. Two
+// strings match case-insensitively exactly when their folded forms are
+// equal, so callers that compare one string against many (e.g. autocomplete
+// matching) should fold each side once and compare the keys with plain
+// operator== instead of paying for a case-aware comparison every time.
+// Pure-ASCII input is folded without entering ICU.
+BASE_I18N_EXPORT string16 FoldCase(const StringPiece16& string);
+
 }  // namespace i18n
 }  // namespace base
 
@@ -21,6 +21,24 @@ TEST(CaseConversionTest, UpperLower) {
   EXPECT_EQ(expected_upper, result);
 }
 
+TEST(CaseConversionTest, FoldCase) {
+  // The all-ASCII shortcut must agree with full case folding.
+  const string16 mixed(ASCIIToUTF16("Text with UPPer & lowER casE."));
+  const string16 expected_folded(ASCIIToUTF16("text with upper & lower case."));
+  EXPECT_EQ(expected_folded, base::i18n::FoldCase(mixed));
+
+  // Strings that differ only by case must fold to the same key.
+  EXPECT_EQ(base::i18n::FoldCase(ASCIIToUTF16("Comparison KEY")),
+            base::i18n::FoldCase(ASCIIToUTF16("compariSON keY")));
+
+  // Full case folding is not a simple lowering: the German sharp s expands
+  // to "ss".
+  const string16 sharp_s(WideToUTF16(L"stra\x00df" L"e"));
+  EXPECT_EQ(WideToUTF16(L"strasse"), base::i18n::FoldCase(sharp_s));
+  EXPECT_EQ(base::i18n::FoldCase(WideToUTF16(L"STRASSE")),
+            base::i18n::FoldCase(sharp_s));
+}
+
 // TODO(jshin): More tests are needed, especially with non-ASCII characters.
 
 }  // namespace
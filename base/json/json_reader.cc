@@ -88,6 +88,7 @@ JSONReader::JSONReader()
       end_pos_(NULL),
       stack_depth_(0),
       allow_trailing_comma_(false),
+      stream_aborted_(false),
       error_code_(JSON_NO_ERROR),
       error_line_(0),
       error_col_(0) {}
@@ -122,6 +123,27 @@ Value* JSONReader::ReadAndReturnError(const std::string& json,
   return NULL;
 }
 
+// static
+bool JSONReader::ReadStream(const std::string& json,
+                            int options,
+                            StreamHandler* handler,
+                            int* error_code_out,
+                            std::string* error_msg_out) {
+  JSONReader reader = JSONReader();
+  if (reader.JsonToStream(json, false,
+                          (options & JSON_ALLOW_TRAILING_COMMAS) != 0,
+                          handler)) {
+    return true;
+  }
+
+  if (error_code_out)
+    *error_code_out = reader.error_code();
+  if (error_msg_out)
+    *error_msg_out = reader.GetErrorMessage();
+
+  return false;
+}
+
 // static
 std::string JSONReader::ErrorCodeToString(JsonParseError error_code) {
   switch (error_code) {
@@ -196,6 +218,45 @@ Value* JSONReader::JsonToValue(const std::string& json, bool check_root,
   return NULL;
 }
 
+bool JSONReader::JsonToStream(const std::string& json, bool check_root,
+                              bool allow_trailing_comma,
+                              StreamHandler* handler) {
+  // The input must be in UTF-8.
+  if (!IsStringUTF8(json.data())) {
+    error_code_ = JSON_UNSUPPORTED_ENCODING;
+    return false;
+  }
+
+  start_pos_ = json.data();
+  end_pos_ = start_pos_ + json.size();
+
+  // Skip over a UTF-8 Byte-Order-Mark, as in JsonToValue().
+  if (json.size() >= 3 && static_cast<uint8>(start_pos_[0]) == 0xEF &&
+      static_cast<uint8>(start_pos_[1]) == 0xBB &&
+      static_cast<uint8>(start_pos_[2]) == 0xBF) {
+    start_pos_ += 3;
+  }
+
+  json_pos_ = start_pos_;
+  allow_trailing_comma_ = allow_trailing_comma;
+  stack_depth_ = 0;
+  error_code_ = JSON_NO_ERROR;
+  stream_aborted_ = false;
+
+  if (StreamValue(check_root, handler)) {
+    if (ParseToken().type == Token::END_OF_INPUT)
+      return true;
+    SetErrorCode(JSON_UNEXPECTED_DATA_AFTER_ROOT, json_pos_);
+    return false;
+  }
+
+  // An abort requested by the handler is not a parse error.
+  if (!stream_aborted_ && error_code_ == 0)
+    SetErrorCode(JSON_SYNTAX_ERROR, json_pos_);
+
+  return false;
+}
+
 // static
 std::string JSONReader::FormatErrorMessage(int line, int column,
                                            const std::string& description) {
@@ -360,6 +421,186 @@ Value* JSONReader::BuildValue(bool is_root) {
   return node.release();
 }
 
+bool JSONReader::StreamValue(bool is_root, StreamHandler* handler) {
+  ++stack_depth_;
+  if (stack_depth_ > kStackLimit) {
+    SetErrorCode(JSON_TOO_MUCH_NESTING, json_pos_);
+    return false;
+  }
+
+  Token token = ParseToken();
+  // The root token must be an array or an object.
+  if (is_root && token.type != Token::OBJECT_BEGIN &&
+      token.type != Token::ARRAY_BEGIN) {
+    SetErrorCode(JSON_BAD_ROOT_ELEMENT_TYPE, json_pos_);
+    return false;
+  }
+
+  switch (token.type) {
+    case Token::END_OF_INPUT:
+    case Token::INVALID_TOKEN:
+      return false;
+
+    case Token::NULL_TOKEN:
+      if (!handler->OnNull()) {
+        stream_aborted_ = true;
+        return false;
+      }
+      break;
+
+    case Token::BOOL_TRUE:
+    case Token::BOOL_FALSE:
+      if (!handler->OnBoolean(token.type == Token::BOOL_TRUE)) {
+        stream_aborted_ = true;
+        return false;
+      }
+      break;
+
+    case Token::NUMBER: {
+      const std::string num_string(token.begin, token.length);
+      int num_int;
+      double num_double;
+      bool handled;
+      if (StringToInt(num_string, &num_int)) {
+        handled = handler->OnInteger(num_int);
+      } else if (StringToDouble(num_string, &num_double) &&
+                 base::IsFinite(num_double)) {
+        handled = handler->OnDouble(num_double);
+      } else {
+        return false;
+      }
+      if (!handled) {
+        stream_aborted_ = true;
+        return false;
+      }
+      break;
+    }
+
+    case Token::STRING: {
+      std::string decoded_str;
+      if (!DecodeStringInternal(token, &decoded_str))
+        return false;
+      if (!handler->OnString(decoded_str)) {
+        stream_aborted_ = true;
+        return false;
+      }
+      break;
+    }
+
+    case Token::ARRAY_BEGIN:
+      {
+        json_pos_ += token.length;
+        token = ParseToken();
+
+        if (!handler->OnArrayBegin()) {
+          stream_aborted_ = true;
+          return false;
+        }
+        while (token.type != Token::ARRAY_END) {
+          if (!StreamValue(false, handler))
+            return false;
+
+          // After a list value, we expect a comma or the end of the list.
+          token = ParseToken();
+          if (token.type == Token::LIST_SEPARATOR) {
+            json_pos_ += token.length;
+            token = ParseToken();
+            // Trailing commas are invalid according to the JSON RFC, but some
+            // consumers need the parsing leniency, so handle accordingly.
+            if (token.type == Token::ARRAY_END) {
+              if (!allow_trailing_comma_) {
+                SetErrorCode(JSON_TRAILING_COMMA, json_pos_);
+                return false;
+              }
+              // Trailing comma OK, stop parsing the Array.
+              break;
+            }
+          } else if (token.type != Token::ARRAY_END) {
+            // Unexpected value after list value.  Bail out.
+            return false;
+          }
+        }
+        if (token.type != Token::ARRAY_END)
+          return false;
+        if (!handler->OnArrayEnd()) {
+          stream_aborted_ = true;
+          return false;
+        }
+        break;
+      }
+
+    case Token::OBJECT_BEGIN:
+      {
+        json_pos_ += token.length;
+        token = ParseToken();
+
+        if (!handler->OnObjectBegin()) {
+          stream_aborted_ = true;
+          return false;
+        }
+        while (token.type != Token::OBJECT_END) {
+          if (token.type != Token::STRING) {
+            SetErrorCode(JSON_UNQUOTED_DICTIONARY_KEY, json_pos_);
+            return false;
+          }
+          std::string dict_key;
+          if (!DecodeStringInternal(token, &dict_key))
+            return false;
+          if (!handler->OnKey(dict_key)) {
+            stream_aborted_ = true;
+            return false;
+          }
+
+          json_pos_ += token.length;
+          token = ParseToken();
+          if (token.type != Token::OBJECT_PAIR_SEPARATOR)
+            return false;
+
+          json_pos_ += token.length;
+          token = ParseToken();
+          if (!StreamValue(false, handler))
+            return false;
+
+          // After a key/value pair, we expect a comma or the end of the
+          // object.
+          token = ParseToken();
+          if (token.type == Token::LIST_SEPARATOR) {
+            json_pos_ += token.length;
+            token = ParseToken();
+            // Trailing commas are invalid according to the JSON RFC, but some
+            // consumers need the parsing leniency, so handle accordingly.
+            if (token.type == Token::OBJECT_END) {
+              if (!allow_trailing_comma_) {
+                SetErrorCode(JSON_TRAILING_COMMA, json_pos_);
+                return false;
+              }
+              // Trailing comma OK, stop parsing the Object.
+              break;
+            }
+          } else if (token.type != Token::OBJECT_END) {
+            // Unexpected value after last object value.  Bail out.
+            return false;
+          }
+        }
+        if (token.type != Token::OBJECT_END)
+          return false;
+        if (!handler->OnObjectEnd()) {
+          stream_aborted_ = true;
+          return false;
+        }
+        break;
+      }
+
+    default:
+      // We got a token that's not a value.
+      return false;
+  }
+  json_pos_ += token.length;
+
+  --stack_depth_;
+  return true;
+}
+
 JSONReader::Token JSONReader::ParseNumberToken() {
   // We just grab the number here.  We validate the size in DecodeNumber.
   // According   to RFC4627, a valid number is: [minus] int [frac] [exp]
@@ -458,7 +699,14 @@ JSONReader::Token JSONReader::ParseStringToken() {
 
 Value* JSONReader::DecodeString(const Token& token) {
   std::string decoded_str;
-  decoded_str.reserve(token.length - 2);
+  if (!DecodeStringInternal(token, &decoded_str))
+    return NULL;
+  return Value::CreateStringValue(decoded_str);
+}
+
+bool JSONReader::DecodeStringInternal(const Token& token,
+                                      std::string* decoded_str) {
+  decoded_str->reserve(decoded_str->size() + token.length - 2);
 
   for (int i = 1; i < token.length - 1; ++i) {
     char c = *(token.begin + i);
@@ -469,54 +717,54 @@ Value* JSONReader::DecodeString(const Token& token) {
         case '"':
         case '/':
         case '\\':
-          decoded_str.push_back(c);
+          decoded_str->push_back(c);
           break;
         case 'b':
-          decoded_str.push_back('\b');
+          decoded_str->push_back('\b');
           break;
         case 'f':
-          decoded_str.push_back('\f');
+          decoded_str->push_back('\f');
           break;
         case 'n':
-          decoded_str.push_back('\n');
+          decoded_str->push_back('\n');
           break;
         case 'r':
-          decoded_str.push_back('\r');
+          decoded_str->push_back('\r');
           break;
         case 't':
-          decoded_str.push_back('\t');
+          decoded_str->push_back('\t');
           break;
         case 'v':
-          decoded_str.push_back('\v');
+          decoded_str->push_back('\v');
           break;
 
         case 'x': {
           if (i + 2 >= token.length)
-            return NULL;
+            return false;
           int hex_digit = 0;
           if (!HexStringToInt(StringPiece(token.begin + i + 1, 2), &hex_digit))
-            return NULL;
-          decoded_str.push_back(hex_digit);
+            return false;
+          decoded_str->push_back(hex_digit);
           i += 2;
           break;
         }
         case 'u':
-          if (!ConvertUTF16Units(token, &i, &decoded_str))
-            return NULL;
+          if (!ConvertUTF16Units(token, &i, decoded_str))
+            return false;
           break;
 
         default:
           // We should only have valid strings at this point.  If not,
           // ParseStringToken didn't do its job.
           NOTREACHED();
-          return NULL;
+          return false;
       }
     } else {
       // Not escaped
-      decoded_str.push_back(c);
+      decoded_str->push_back(c);
     }
   }
-  return Value::CreateStringValue(decoded_str);
+  return true;
 }
 
 bool JSONReader::ConvertUTF16Units(const Token& token,
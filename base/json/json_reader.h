@@ -124,6 +124,27 @@ class BASE_EXPORT JSONReader {
   static const char* kUnsupportedEncoding;
   static const char* kUnquotedDictionaryKey;
 
+  // Receives parse events from ReadStream() in document order.  Implementing
+  // this lets callers extract the keys they need from very large inputs
+  // without materializing a full Value tree.  Any callback may return false
+  // to abort the parse; ReadStream() then returns false with JSON_NO_ERROR.
+  class StreamHandler {
+   public:
+    virtual ~StreamHandler() {}
+
+    virtual bool OnObjectBegin() = 0;
+    // |key| is the decoded key of the pair whose value is reported next.
+    virtual bool OnKey(const std::string& key) = 0;
+    virtual bool OnObjectEnd() = 0;
+    virtual bool OnArrayBegin() = 0;
+    virtual bool OnArrayEnd() = 0;
+    virtual bool OnString(const std::string& value) = 0;
+    virtual bool OnInteger(int value) = 0;
+    virtual bool OnDouble(double value) = 0;
+    virtual bool OnBoolean(bool value) = 0;
+    virtual bool OnNull() = 0;
+  };
+
   JSONReader();
 
   // Reads and parses |json|, returning a Value. The caller owns the returned
@@ -144,6 +165,16 @@ class BASE_EXPORT JSONReader {
                                    int* error_code_out,
                                    std::string* error_msg_out);
 
+  // Parses |json| and reports each value to |handler| without building a
+  // Value tree.  Returns true if the whole input parsed successfully and no
+  // callback aborted.  On a parse error, returns false and, if specified,
+  // populates |error_code_out| and |error_msg_out| like ReadAndReturnError().
+  static bool ReadStream(const std::string& json,
+                         int options,  // JSONParserOptions
+                         StreamHandler* handler,
+                         int* error_code_out,
+                         std::string* error_msg_out);
+
   // Converts a JSON parse error code into a human readable message.
   // Returns an empty string if error_code is JSON_NO_ERROR.
   static std::string ErrorCodeToString(JsonParseError error_code);
@@ -166,6 +197,13 @@ class BASE_EXPORT JSONReader {
   Value* JsonToValue(const std::string& json, bool check_root,
                      bool allow_trailing_comma);
 
+  // Streaming counterpart of JsonToValue(): parses |json| and reports values
+  // to |handler| instead of building a tree.  Returns true on a complete,
+  // successful parse; on failure a detailed error can be retrieved from
+  // GetErrorMessage() unless a callback aborted the parse.
+  bool JsonToStream(const std::string& json, bool check_root,
+                    bool allow_trailing_comma, StreamHandler* handler);
+
  private:
   FRIEND_TEST_ALL_PREFIXES(JSONReaderTest, Reading);
   FRIEND_TEST_ALL_PREFIXES(JSONReaderTest, ErrorMessages);
@@ -194,10 +232,18 @@ class BASE_EXPORT JSONReader {
   // actual wstring.
   Token ParseStringToken();
 
+  // Recursively stream values to |handler|, mirroring BuildValue().  Returns
+  // false on a parse error or when a callback asks to abort.
+  bool StreamValue(bool is_root, StreamHandler* handler);
+
   // Convert the substring into a value string.  This should always succeed
   // (otherwise ParseStringToken would have failed).
   Value* DecodeString(const Token& token);
 
+  // Shared implementation of DecodeString() that appends the decoded string
+  // to |decoded_str| instead of wrapping it in a StringValue.
+  bool DecodeStringInternal(const Token& token, std::string* decoded_str);
+
   // Helper function for DecodeString that consumes UTF16 [0,2] code units and
   // convers them to UTF8 code untis.  |token| is the string token in which the
   // units should be read, |i| is the position in the token at which the first
@@ -242,6 +288,10 @@ class BASE_EXPORT JSONReader {
   // A parser flag that allows trailing commas in objects and arrays.
   bool allow_trailing_comma_;
 
+  // Set when a StreamHandler callback returned false; distinguishes an
+  // aborted parse from a parse error.
+  bool stream_aborted_;
+
   // Contains the error code for the last call to JsonToValue(), if any.
   JsonParseError error_code_;
   int error_line_;
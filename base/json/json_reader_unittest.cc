@@ -5,10 +5,12 @@
 #include "base/json/json_reader.h"
 
 #include "base/base_paths.h"
+#include "base/compiler_specific.h"
 #include "base/file_util.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/path_service.h"
 #include "base/string_piece.h"
+#include "base/stringprintf.h"
 #include "base/utf_string_conversions.h"
 #include "base/values.h"
 #include "build/build_config.h"
@@ -607,4 +609,87 @@ TEST(JSONReaderTest, ErrorMessages) {
   EXPECT_EQ(JSONReader::JSON_INVALID_ESCAPE, error_code);
 }
 
+namespace {
+
+// Records every streaming callback as a compact event string, optionally
+// aborting once |abort_after| events have been seen.
+class RecordingStreamHandler : public JSONReader::StreamHandler {
+ public:
+  explicit RecordingStreamHandler(int abort_after)
+      : abort_after_(abort_after) {}
+
+  virtual bool OnObjectBegin() OVERRIDE { return Record("{"); }
+  virtual bool OnKey(const std::string& key) OVERRIDE {
+    return Record("k(" + key + ")");
+  }
+  virtual bool OnObjectEnd() OVERRIDE { return Record("}"); }
+  virtual bool OnArrayBegin() OVERRIDE { return Record("["); }
+  virtual bool OnArrayEnd() OVERRIDE { return Record("]"); }
+  virtual bool OnString(const std::string& value) OVERRIDE {
+    return Record("s(" + value + ")");
+  }
+  virtual bool OnInteger(int value) OVERRIDE {
+    return Record(StringPrintf("i(%d)", value));
+  }
+  virtual bool OnDouble(double value) OVERRIDE {
+    return Record(StringPrintf("d(%g)", value));
+  }
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    return Record(value ? "b(true)" : "b(false)");
+  }
+  virtual bool OnNull() OVERRIDE { return Record("n"); }
+
+  const std::string& events() const { return events_; }
+
+ private:
+  bool Record(const std::string& event) {
+    events_ += event;
+    return --abort_after_ != 0;
+  }
+
+  int abort_after_;
+  std::string events_;
+};
+
+}  // namespace
+
+TEST(JSONReaderTest, StreamReading) {
+  RecordingStreamHandler handler(-1);
+  EXPECT_TRUE(JSONReader::ReadStream(
+      "{\"a\": [1, 2.5, true, null, \"s\"], \"b\": {\"c\": \"d\"}}",
+      JSON_PARSE_RFC, &handler, NULL, NULL));
+  EXPECT_EQ("{k(a)[i(1)d(2.5)b(true)ns(s)]k(b){k(c)s(d)}}",
+            handler.events());
+
+  // Trailing commas require the matching option, as with Read().
+  RecordingStreamHandler strict_handler(-1);
+  EXPECT_FALSE(JSONReader::ReadStream("[1, 2,]", JSON_PARSE_RFC,
+                                      &strict_handler, NULL, NULL));
+  RecordingStreamHandler lenient_handler(-1);
+  EXPECT_TRUE(JSONReader::ReadStream("[1, 2,]", JSON_ALLOW_TRAILING_COMMAS,
+                                     &lenient_handler, NULL, NULL));
+  EXPECT_EQ("[i(1)i(2)]", lenient_handler.events());
+}
+
+TEST(JSONReaderTest, StreamReadingErrors) {
+  int error_code = 0;
+  std::string error_message;
+  RecordingStreamHandler handler(-1);
+  EXPECT_FALSE(JSONReader::ReadStream("[1, 2", JSON_PARSE_RFC, &handler,
+                                      &error_code, &error_message));
+  EXPECT_EQ(JSONReader::JSON_SYNTAX_ERROR, error_code);
+  EXPECT_FALSE(error_message.empty());
+}
+
+TEST(JSONReaderTest, StreamReadingAbort) {
+  // Aborting from a callback stops the parse without reporting an error.
+  int error_code = JSONReader::JSON_NO_ERROR;
+  std::string error_message;
+  RecordingStreamHandler handler(3);
+  EXPECT_FALSE(JSONReader::ReadStream("[1, 2, 3]", JSON_PARSE_RFC, &handler,
+                                      &error_code, &error_message));
+  EXPECT_EQ("[i(1)i(2)", handler.events());
+  EXPECT_EQ(JSONReader::JSON_NO_ERROR, error_code);
+}
+
 }  // namespace base
@@ -41,6 +41,23 @@ class BASE_EXPORT Location {
     return function_name_ < other.function_name_;
   }
 
+  // As with operator<, we compare the string pointers (not the contents)
+  // because the strings are atoms.
+  bool operator==(const Location& other) const {
+    return line_number_ == other.line_number_ &&
+           file_name_ == other.file_name_ &&
+           function_name_ == other.function_name_;
+  }
+
+  // Quick hash over the same members operator== compares, for use as a
+  // hash_map key.  Pointer values stand in for string contents here too; the
+  // low pointer bits are discarded as they are always zero.
+  size_t Hash() const {
+    return static_cast<size_t>(line_number_) ^
+           (reinterpret_cast<uintptr_t>(file_name_) >> 2) ^
+           (reinterpret_cast<uintptr_t>(function_name_) >> 4);
+  }
+
   const char* function_name()   const { return function_name_; }
   const char* file_name()       const { return file_name_; }
   int line_number()             const { return line_number_; }
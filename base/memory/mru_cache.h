@@ -17,9 +17,11 @@
 #define BASE_MEMORY_MRU_CACHE_H_
 #pragma once
 
+#include <iterator>
 #include <list>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/hash_tables.h"
@@ -301,6 +303,494 @@ class HashingMRUCache : public MRUCacheBase<KeyType,
   DISALLOW_COPY_AND_ASSIGN(HashingMRUCache);
 };
 
+// OpenAddressingMRUCache ------------------------------------------------------
+
+// An MRU cache that stores its entries in a single flat, open-addressed hash
+// table with the recency list threaded through the entries as slot indices.
+// Compared to MRUCacheBase (std::map + std::list), lookups hash directly to
+// the entry instead of walking a red-black tree, no per-entry nodes are
+// allocated, and touching an entry updates two indices instead of splicing
+// list nodes.  Use this for caches that sit on per-request paths, e.g. host
+// resolution and SSL session lookup.
+//
+// The interface matches MRUCacheBase with two differences inherent to the
+// backing store: KeyType must be hashable (like HashingMRUCache), and while
+// iterators survive Erase of other elements (erasure only tombstones a slot),
+// any Put may rehash and invalidate all iterators.
+template <class KeyType, class PayloadType, class DeletorType,
+          class HashType = BASE_HASH_NAMESPACE::hash<KeyType> >
+class OpenAddressingMRUCacheBase {
+ public:
+  // The stored entry. This maintains a copy of the key so the recency list
+  // can be walked without consulting the probe sequence.
+  typedef std::pair<KeyType, PayloadType> value_type;
+  typedef size_t size_type;
+
+  enum { NO_AUTO_EVICT = 0 };
+
+ private:
+  enum SlotState {
+    SLOT_EMPTY,    // Never used; terminates probe sequences.
+    SLOT_DELETED,  // Tombstone; probe sequences continue across it.
+    SLOT_FULL
+  };
+
+  struct Slot {
+    Slot()
+        : hash(0),
+          prev(kInvalidSlot),
+          next(kInvalidSlot),
+          state(SLOT_EMPTY) {
+    }
+
+    value_type entry;
+    size_t hash;   // Cached so rehashing need not re-run the hasher.
+    size_t prev;   // Slot index of the next more recently used entry.
+    size_t next;   // Slot index of the next less recently used entry.
+    SlotState state;
+  };
+
+  static const size_t kInvalidSlot = static_cast<size_t>(-1);
+  static const size_t kMinimumSlotCount = 16;
+
+ public:
+  class const_iterator;
+
+  // Bidirectional so std::reverse_iterator can be layered on top; forward
+  // iteration starts with the most recent item and works backwards.
+  class iterator {
+   public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef typename OpenAddressingMRUCacheBase::value_type value_type;
+    typedef ptrdiff_t difference_type;
+    typedef value_type* pointer;
+    typedef value_type& reference;
+
+    iterator() : cache_(NULL), slot_(kInvalidSlot) {}
+
+    reference operator*() const { return cache_->slots_[slot_].entry; }
+    pointer operator->() const { return &cache_->slots_[slot_].entry; }
+
+    iterator& operator++() {
+      slot_ = cache_->slots_[slot_].next;
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator copy(*this);
+      ++(*this);
+      return copy;
+    }
+    iterator& operator--() {
+      slot_ = (slot_ == kInvalidSlot) ? cache_->tail_
+                                      : cache_->slots_[slot_].prev;
+      return *this;
+    }
+    iterator operator--(int) {
+      iterator copy(*this);
+      --(*this);
+      return copy;
+    }
+
+    bool operator==(const iterator& other) const {
+      return slot_ == other.slot_;
+    }
+    bool operator!=(const iterator& other) const {
+      return slot_ != other.slot_;
+    }
+
+   private:
+    friend class OpenAddressingMRUCacheBase;
+    friend class const_iterator;
+
+    iterator(OpenAddressingMRUCacheBase* cache, size_t slot)
+        : cache_(cache), slot_(slot) {}
+
+    OpenAddressingMRUCacheBase* cache_;
+    size_t slot_;
+  };
+
+  class const_iterator {
+   public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef typename OpenAddressingMRUCacheBase::value_type value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+
+    const_iterator() : cache_(NULL), slot_(kInvalidSlot) {}
+    const_iterator(const iterator& other)
+        : cache_(other.cache_), slot_(other.slot_) {}
+
+    reference operator*() const { return cache_->slots_[slot_].entry; }
+    pointer operator->() const { return &cache_->slots_[slot_].entry; }
+
+    const_iterator& operator++() {
+      slot_ = cache_->slots_[slot_].next;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator copy(*this);
+      ++(*this);
+      return copy;
+    }
+    const_iterator& operator--() {
+      slot_ = (slot_ == kInvalidSlot) ? cache_->tail_
+                                      : cache_->slots_[slot_].prev;
+      return *this;
+    }
+    const_iterator operator--(int) {
+      const_iterator copy(*this);
+      --(*this);
+      return copy;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return slot_ == other.slot_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return slot_ != other.slot_;
+    }
+
+   private:
+    friend class OpenAddressingMRUCacheBase;
+
+    const_iterator(const OpenAddressingMRUCacheBase* cache, size_t slot)
+        : cache_(cache), slot_(slot) {}
+
+    const OpenAddressingMRUCacheBase* cache_;
+    size_t slot_;
+  };
+
+  typedef std::reverse_iterator<iterator> reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  // See MRUCacheBase for the meaning of |max_size| and NO_AUTO_EVICT.  The
+  // table is allocated lazily on the first Put, so an unused cache costs
+  // nothing beyond this object.
+  explicit OpenAddressingMRUCacheBase(size_type max_size)
+      : mask_(0),
+        size_(0),
+        deleted_count_(0),
+        head_(kInvalidSlot),
+        tail_(kInvalidSlot),
+        max_size_(max_size) {
+  }
+
+  OpenAddressingMRUCacheBase(size_type max_size, const DeletorType& deletor)
+      : mask_(0),
+        size_(0),
+        deleted_count_(0),
+        head_(kInvalidSlot),
+        tail_(kInvalidSlot),
+        max_size_(max_size),
+        deletor_(deletor) {
+  }
+
+  virtual ~OpenAddressingMRUCacheBase() {
+    Clear();
+  }
+
+  size_type max_size() const { return max_size_; }
+
+  // Inserts a payload item with the given key. If an existing item has
+  // the same key, it is removed prior to insertion. An iterator indicating the
+  // inserted item will be returned (this will always be the front of the
+  // recency list).  Invalidates outstanding iterators if the table rehashes.
+  iterator Put(const KeyType& key, const PayloadType& payload) {
+    size_t hash = hasher_(key);
+    size_t slot = FindSlot(key, hash);
+    if (slot != kInvalidSlot) {
+      // Erase the existing entry. This will call the deletor on the removed
+      // element.
+      EraseSlot(slot);
+    } else if (max_size_ != NO_AUTO_EVICT) {
+      // New item is being inserted which might make it larger than the maximum
+      // size: kick the oldest thing out if necessary.
+      ShrinkToSize(max_size_ - 1);
+    }
+
+    slot = InsertSlot(key, hash, payload);
+    LinkAtHead(slot);
+    return iterator(this, slot);
+  }
+
+  // Retrieves the contents of the given key, or end() if not found. This
+  // method has the side effect of moving the requested item to the front of
+  // the recency list.
+  iterator Get(const KeyType& key) {
+    size_t slot = FindSlot(key, hasher_(key));
+    if (slot == kInvalidSlot)
+      return end();
+
+    // Move the touched item to the front of the recency ordering.
+    Unlink(slot);
+    LinkAtHead(slot);
+    return iterator(this, slot);
+  }
+
+  // Retrieves the item associated with a given key without affecting the
+  // ordering (unlike Get).
+  iterator Peek(const KeyType& key) {
+    size_t slot = FindSlot(key, hasher_(key));
+    if (slot == kInvalidSlot)
+      return end();
+    return iterator(this, slot);
+  }
+
+  // Erases the item referenced by the given iterator. An iterator to the item
+  // following it will be returned. The iterator must be valid.  The vacated
+  // slot becomes a tombstone, so other outstanding iterators stay valid.
+  iterator Erase(iterator pos) {
+    size_t next = slots_[pos.slot_].next;
+    EraseSlot(pos.slot_);
+    return iterator(this, next);
+  }
+
+  // MRUCache entries are often processed in reverse order, so we add this
+  // convenience function (not typically defined by STL containers).
+  reverse_iterator Erase(reverse_iterator pos) {
+    // We have to actually give it the incremented iterator to delete, since
+    // the forward iterator that base() returns is actually one past the item
+    // being iterated over.
+    return reverse_iterator(Erase((++pos).base()));
+  }
+
+  // Shrinks the cache so it only holds |new_size| items. If |new_size| is
+  // bigger or equal to the current number of items, this will do nothing.
+  void ShrinkToSize(size_type new_size) {
+    while (size_ > new_size)
+      EraseSlot(tail_);
+  }
+
+  // Deletes everything from the cache and releases the table.
+  void Clear() {
+    for (size_t i = head_; i != kInvalidSlot; i = slots_[i].next)
+      deletor_(slots_[i].entry.second);
+    slots_.clear();
+    mask_ = 0;
+    size_ = 0;
+    deleted_count_ = 0;
+    head_ = kInvalidSlot;
+    tail_ = kInvalidSlot;
+  }
+
+  // Returns the number of elements in the cache.
+  size_type size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  // Allows iteration over the recency list. Forward iteration starts with the
+  // most recent item and works backwards.
+  iterator begin() { return iterator(this, head_); }
+  const_iterator begin() const { return const_iterator(this, head_); }
+  iterator end() { return iterator(this, kInvalidSlot); }
+  const_iterator end() const { return const_iterator(this, kInvalidSlot); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+ private:
+  // Returns the slot holding |key|, or kInvalidSlot. Probing is linear; the
+  // load factor is capped at 3/4 so an empty terminator is always reached.
+  size_t FindSlot(const KeyType& key, size_t hash) const {
+    if (slots_.empty())
+      return kInvalidSlot;
+    for (size_t i = hash & mask_; ; i = (i + 1) & mask_) {
+      const Slot& slot = slots_[i];
+      if (slot.state == SLOT_EMPTY)
+        return kInvalidSlot;
+      if (slot.state == SLOT_FULL && slot.hash == hash &&
+          slot.entry.first == key)
+        return i;
+    }
+  }
+
+  // Places a new entry, growing or rebuilding the table as needed to keep
+  // the load factor (including tombstones) at or below 3/4. The caller must
+  // have ensured that |key| is not already present.
+  size_t InsertSlot(const KeyType& key, size_t hash,
+                    const PayloadType& payload) {
+    if (slots_.empty()) {
+      Rehash(kMinimumSlotCount);
+    } else if ((size_ + 1 + deleted_count_) * 4 > slots_.size() * 3) {
+      // Rebuilding at the same size is enough when the table is mostly
+      // tombstones; otherwise double.
+      Rehash((size_ + 1) * 4 > slots_.size() * 2 ? slots_.size() * 2
+                                                 : slots_.size());
+    }
+
+    size_t i = hash & mask_;
+    while (slots_[i].state == SLOT_FULL)
+      i = (i + 1) & mask_;
+    if (slots_[i].state == SLOT_DELETED)
+      deleted_count_--;
+
+    Slot& slot = slots_[i];
+    slot.state = SLOT_FULL;
+    slot.hash = hash;
+    slot.entry.first = key;
+    slot.entry.second = payload;
+    size_++;
+    return i;
+  }
+
+  // Calls the deletor on the entry in |slot|, removes it from the recency
+  // list and leaves a tombstone behind.
+  void EraseSlot(size_t slot_index) {
+    Slot& slot = slots_[slot_index];
+    deletor_(slot.entry.second);
+    Unlink(slot_index);
+    slot.state = SLOT_DELETED;
+    // Reset the entry so held resources (string keys, refcounts) go away now
+    // rather than when the slot is reused.
+    slot.entry = value_type();
+    size_--;
+    deleted_count_++;
+  }
+
+  void LinkAtHead(size_t slot_index) {
+    Slot& slot = slots_[slot_index];
+    slot.prev = kInvalidSlot;
+    slot.next = head_;
+    if (head_ != kInvalidSlot)
+      slots_[head_].prev = slot_index;
+    head_ = slot_index;
+    if (tail_ == kInvalidSlot)
+      tail_ = slot_index;
+  }
+
+  void LinkAtTail(size_t slot_index) {
+    Slot& slot = slots_[slot_index];
+    slot.prev = tail_;
+    slot.next = kInvalidSlot;
+    if (tail_ != kInvalidSlot)
+      slots_[tail_].next = slot_index;
+    tail_ = slot_index;
+    if (head_ == kInvalidSlot)
+      head_ = slot_index;
+  }
+
+  void Unlink(size_t slot_index) {
+    Slot& slot = slots_[slot_index];
+    if (slot.prev != kInvalidSlot)
+      slots_[slot.prev].next = slot.next;
+    else
+      head_ = slot.next;
+    if (slot.next != kInvalidSlot)
+      slots_[slot.next].prev = slot.prev;
+    else
+      tail_ = slot.prev;
+  }
+
+  // Rebuilds the table with |new_slot_count| slots (a power of two),
+  // discarding tombstones and preserving the recency order.
+  void Rehash(size_t new_slot_count) {
+    DCHECK_EQ(0u, new_slot_count & (new_slot_count - 1));
+    std::vector<Slot> old_slots;
+    old_slots.swap(slots_);
+    slots_.resize(new_slot_count);
+    mask_ = new_slot_count - 1;
+
+    size_t old_head = head_;
+    head_ = kInvalidSlot;
+    tail_ = kInvalidSlot;
+    size_ = 0;
+    deleted_count_ = 0;
+
+    // Reinsert from most to least recently used, appending at the tail, so
+    // the recency order carries over.
+    for (size_t i = old_head; i != kInvalidSlot; i = old_slots[i].next) {
+      size_t slot = old_slots[i].hash & mask_;
+      while (slots_[slot].state == SLOT_FULL)
+        slot = (slot + 1) & mask_;
+      slots_[slot].state = SLOT_FULL;
+      slots_[slot].hash = old_slots[i].hash;
+      slots_[slot].entry = old_slots[i].entry;
+      size_++;
+      LinkAtTail(slot);
+    }
+  }
+
+  std::vector<Slot> slots_;
+  size_t mask_;  // slots_.size() - 1; the slot count is a power of two.
+  size_t size_;
+  size_t deleted_count_;
+  size_t head_;  // Most recently used slot, or kInvalidSlot if empty.
+  size_t tail_;  // Least recently used slot, or kInvalidSlot if empty.
+
+  size_type max_size_;
+
+  HashType hasher_;
+  DeletorType deletor_;
+
+  DISALLOW_COPY_AND_ASSIGN(OpenAddressingMRUCacheBase);
+};
+
+template <class KeyType, class PayloadType, class DeletorType, class HashType>
+const size_t
+    OpenAddressingMRUCacheBase<KeyType, PayloadType, DeletorType, HashType>::
+        kInvalidSlot;
+
+template <class KeyType, class PayloadType, class DeletorType, class HashType>
+const size_t
+    OpenAddressingMRUCacheBase<KeyType, PayloadType, DeletorType, HashType>::
+        kMinimumSlotCount;
+
+// A cache that does not do anything to free its data, backed by the open
+// addressed table above. Use this when storing value types (as opposed to
+// pointers).
+template <class KeyType, class PayloadType>
+class OpenAddressingMRUCache
+    : public OpenAddressingMRUCacheBase<KeyType,
+                                        PayloadType,
+                                        MRUCacheNullDeletor<PayloadType> > {
+ private:
+  typedef OpenAddressingMRUCacheBase<KeyType, PayloadType,
+      MRUCacheNullDeletor<PayloadType> > ParentType;
+
+ public:
+  // See MRUCacheBase, noting the possibility of using NO_AUTO_EVICT.
+  explicit OpenAddressingMRUCache(typename ParentType::size_type max_size)
+      : ParentType(max_size) {
+  }
+  virtual ~OpenAddressingMRUCache() {
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(OpenAddressingMRUCache);
+};
+
+// The owning equivalent of OpenAddressingMRUCache; payloads must be non-const
+// pointers and are deleted when removed, replaced, or when the cache is
+// destroyed.
+template <class KeyType, class PayloadType>
+class OwningOpenAddressingMRUCache
+    : public OpenAddressingMRUCacheBase<KeyType,
+                                        PayloadType,
+                                        MRUCachePointerDeletor<PayloadType> > {
+ private:
+  typedef OpenAddressingMRUCacheBase<KeyType, PayloadType,
+      MRUCachePointerDeletor<PayloadType> > ParentType;
+
+ public:
+  // See MRUCacheBase, noting the possibility of using NO_AUTO_EVICT.
+  explicit OwningOpenAddressingMRUCache(
+      typename ParentType::size_type max_size)
+      : ParentType(max_size) {
+  }
+  virtual ~OwningOpenAddressingMRUCache() {
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(OwningOpenAddressingMRUCache);
+};
+
 }  // namespace base
 
 #endif  // BASE_MEMORY_MRU_CACHE_H_
@@ -269,3 +269,148 @@ TEST(MRUCacheTest, HashingMRUCache) {
   EXPECT_EQ(two.value, cache.Get("Second")->second.value);
   EXPECT_TRUE(cache.Get("First") == cache.end());
 }
+
+TEST(MRUCacheTest, OpenAddressingBasic) {
+  typedef base::OpenAddressingMRUCache<int, CachedItem> Cache;
+  Cache cache(Cache::NO_AUTO_EVICT);
+
+  // Check failure conditions.
+  EXPECT_TRUE(cache.Get(0) == cache.end());
+  EXPECT_TRUE(cache.Peek(0) == cache.end());
+  EXPECT_TRUE(cache.empty());
+
+  static const int kItem1Key = 5;
+  CachedItem item1(10);
+  Cache::iterator inserted_item = cache.Put(kItem1Key, item1);
+  EXPECT_EQ(1U, cache.size());
+  EXPECT_TRUE(inserted_item == cache.begin());
+
+  static const int kItem2Key = 7;
+  CachedItem item2(12);
+  cache.Put(kItem2Key, item2);
+  EXPECT_EQ(2U, cache.size());
+
+  // Check that item1 is the oldest since item2 was added afterwards.
+  {
+    Cache::reverse_iterator oldest = cache.rbegin();
+    ASSERT_TRUE(oldest != cache.rend());
+    EXPECT_EQ(kItem1Key, oldest->first);
+    EXPECT_EQ(item1.value, oldest->second.value);
+  }
+
+  // Check that retrieving item1 pushes item2 to oldest, and that Peek does
+  // not reorder.
+  {
+    Cache::iterator test_item = cache.Get(kItem1Key);
+    ASSERT_TRUE(test_item != cache.end());
+    EXPECT_EQ(kItem1Key, test_item->first);
+
+    Cache::reverse_iterator oldest = cache.rbegin();
+    ASSERT_TRUE(oldest != cache.rend());
+    EXPECT_EQ(kItem2Key, oldest->first);
+
+    cache.Peek(kItem2Key);
+    EXPECT_EQ(kItem2Key, cache.rbegin()->first);
+  }
+
+  // Remove the oldest item via a reverse iterator, then the rest.
+  {
+    Cache::reverse_iterator next = cache.Erase(cache.rbegin());
+    EXPECT_EQ(1U, cache.size());
+    EXPECT_TRUE(next == cache.rbegin());
+    EXPECT_EQ(kItem1Key, next->first);
+
+    cache.Erase(cache.begin());
+    EXPECT_EQ(0U, cache.size());
+    EXPECT_TRUE(cache.begin() == cache.end());
+  }
+}
+
+TEST(MRUCacheTest, OpenAddressingKeyReplacementAndEvict) {
+  typedef base::OpenAddressingMRUCache<std::string, CachedItem> Cache;
+  Cache cache(2);
+
+  CachedItem one(1);
+  cache.Put("First", one);
+
+  CachedItem two(2);
+  cache.Put("Second", two);
+
+  // Replacing a key must not grow the cache.
+  CachedItem three(3);
+  cache.Put("First", three);
+  EXPECT_EQ(2U, cache.size());
+  EXPECT_EQ(three.value, cache.Peek("First")->second.value);
+  EXPECT_EQ("First", cache.begin()->first);
+
+  // Inserting past max_size evicts the oldest ("Second").
+  CachedItem four(4);
+  cache.Put("Third", four);
+  EXPECT_EQ(2U, cache.size());
+  EXPECT_TRUE(cache.Get("Second") == cache.end());
+  EXPECT_EQ(three.value, cache.Get("First")->second.value);
+  EXPECT_EQ(four.value, cache.Get("Third")->second.value);
+}
+
+TEST(MRUCacheTest, OpenAddressingRehash) {
+  typedef base::OpenAddressingMRUCache<int, CachedItem> Cache;
+  Cache cache(Cache::NO_AUTO_EVICT);
+
+  // Push the table through several growth rehashes and make sure everything
+  // remains reachable and the recency order is preserved.
+  static const int kItemCount = 1000;
+  for (int i = 0; i < kItemCount; i++)
+    cache.Put(i, CachedItem(i * 2));
+  EXPECT_EQ(static_cast<Cache::size_type>(kItemCount), cache.size());
+
+  int expected_key = kItemCount - 1;
+  for (Cache::iterator iter = cache.begin(); iter != cache.end(); ++iter) {
+    EXPECT_EQ(expected_key, iter->first);
+    EXPECT_EQ(expected_key * 2, iter->second.value);
+    expected_key--;
+  }
+  EXPECT_EQ(-1, expected_key);
+
+  // Erase-while-iterating must be safe: erasure only leaves a tombstone.
+  for (Cache::iterator iter = cache.begin(); iter != cache.end(); ) {
+    if (iter->first % 2)
+      iter = cache.Erase(iter);
+    else
+      ++iter;
+  }
+  EXPECT_EQ(static_cast<Cache::size_type>(kItemCount / 2), cache.size());
+  for (int i = 0; i < kItemCount; i++)
+    EXPECT_EQ(i % 2 == 0, cache.Peek(i) != cache.end());
+}
+
+TEST(MRUCacheTest, OpenAddressingOwning) {
+  typedef base::OwningOpenAddressingMRUCache<int, CachedItem*> Cache;
+
+  int initial_count = cached_item_live_count;
+
+  {
+    Cache cache(3);
+
+    // First insert an item and then overwrite it; the replaced payload must
+    // be deleted.
+    cache.Put(1, new CachedItem(20));
+    cache.Put(1, new CachedItem(22));
+    EXPECT_EQ(initial_count + 1, cached_item_live_count);
+
+    // Auto-eviction deletes the oldest payloads.
+    cache.Put(2, new CachedItem(23));
+    cache.Put(3, new CachedItem(24));
+    cache.Put(4, new CachedItem(25));
+    EXPECT_EQ(3U, cache.size());
+    EXPECT_EQ(initial_count + 3, cached_item_live_count);
+
+    // Check that Clear() frees things correctly.
+    cache.Clear();
+    EXPECT_EQ(initial_count, cached_item_live_count);
+
+    cache.Put(5, new CachedItem(26));
+  }
+
+  // The destructor releases the remaining payloads; nothing is leaked.
+  EXPECT_EQ(initial_count, cached_item_live_count);
+}
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 
+#include "base/atomicops.h"
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/debug/alias.h"
@@ -19,6 +20,7 @@
 #include "base/third_party/dynamic_annotations/dynamic_annotations.h"
 #include "base/threading/thread_local.h"
 #include "base/time.h"
+#include "base/timer_wheel.h"
 #include "base/tracked_objects.h"
 
 #if defined(OS_MACOSX)
@@ -125,11 +127,27 @@ MessageLoop::DestructionObserver::~DestructionObserver() {
 
 //------------------------------------------------------------------------------
 
+// A heap-allocated carrier for one cross-thread task on the lock-free
+// incoming queue.  Nodes are only ever touched by the posting thread (before
+// the publishing CAS) and by the loop's thread (after detaching the stack),
+// so the |next| link needs no synchronization of its own.
+struct MessageLoop::LockFreeTaskNode {
+  explicit LockFreeTaskNode(const PendingTask& pending_task)
+      : task(pending_task),
+        next(NULL) {
+  }
+
+  PendingTask task;
+  LockFreeTaskNode* next;
+};
+
 MessageLoop::MessageLoop(Type type)
     : type_(type),
       nestable_tasks_allowed_(true),
       exception_restoration_(false),
       message_histogram_(NULL),
+      lock_free_incoming_queue_enabled_(false),
+      lock_free_incoming_head_(0),
       state_(NULL),
 #ifdef OS_WIN
       os_modal_loop_(false),
@@ -255,6 +273,63 @@ void MessageLoop::PostTask(
   AddToIncomingQueue(&pending_task);
 }
 
+void MessageLoop::PostTaskBatch(
+    const tracked_objects::Location& from_here,
+    std::vector<base::Closure>* tasks) {
+  if (tasks->empty())
+    return;
+
+  if (lock_free_incoming_queue_enabled_) {
+    // Take a reference to the pump before publishing the batch: once the
+    // tasks are visible, the loop's thread may run them and destroy |this|.
+    scoped_refptr<base::MessagePump> pump(pump_);
+
+    // Link the batch into a private chain first, then publish the whole
+    // thing with one compare-and-swap.  The drain reverses the stack, so
+    // chaining the last task on top preserves posting order.
+    LockFreeTaskNode* top = NULL;
+    LockFreeTaskNode* bottom = NULL;
+    for (size_t i = 0; i < tasks->size(); ++i) {
+      DCHECK(!(*tasks)[i].is_null()) << from_here.ToString();
+      PendingTask pending_task(from_here, (*tasks)[i],
+                               CalculateDelayedRuntime(0), true);
+      LockFreeTaskNode* node = new LockFreeTaskNode(pending_task);
+      node->next = top;
+      top = node;
+      if (!bottom)
+        bottom = node;
+      (*tasks)[i].Reset();
+    }
+    bool was_empty = PushChainToLockFreeIncomingQueue(top, bottom);
+    tasks->clear();
+    if (was_empty)
+      pump->ScheduleWork();
+    return;
+  }
+
+  scoped_refptr<base::MessagePump> pump;
+  {
+    base::AutoLock locked(incoming_queue_lock_);
+
+    bool was_empty = incoming_queue_.empty();
+    for (size_t i = 0; i < tasks->size(); ++i) {
+      DCHECK(!(*tasks)[i].is_null()) << from_here.ToString();
+      PendingTask pending_task(from_here, (*tasks)[i],
+                               CalculateDelayedRuntime(0), true);
+      incoming_queue_.push(pending_task);
+      (*tasks)[i].Reset();
+    }
+    tasks->clear();
+    if (!was_empty)
+      return;  // Someone else should have started the sub-pump.
+
+    pump = pump_;
+  }
+  // See the comment at the end of AddToIncomingQueue() for why the pump
+  // reference is taken inside the lock and ScheduleWork called outside it.
+  pump->ScheduleWork();
+}
+
 void MessageLoop::PostDelayedTask(
     const tracked_objects::Location& from_here,
     const base::Closure& task,
@@ -347,6 +422,27 @@ bool MessageLoop::NestableTasksAllowed() const {
   return nestable_tasks_allowed_;
 }
 
+void MessageLoop::SetLockFreeIncomingQueue(bool enabled) {
+  DCHECK_EQ(this, current());
+  // Switching modes with posted tasks in flight would reorder them.
+  AssertIdle();
+  DCHECK(!base::subtle::NoBarrier_Load(&lock_free_incoming_head_));
+  lock_free_incoming_queue_enabled_ = enabled;
+}
+
+void MessageLoop::SetTimerWheelEnabled(bool enabled) {
+  DCHECK_EQ(this, current());
+  // Switching backends with delayed tasks pending would drop them.
+  DCHECK(delayed_work_queue_.empty());
+  DCHECK(!timer_wheel_.get() || timer_wheel_->empty());
+  if (enabled == (timer_wheel_.get() != NULL))
+    return;
+  if (enabled)
+    timer_wheel_.reset(new base::TimerWheel);
+  else
+    timer_wheel_.reset();
+}
+
 bool MessageLoop::IsNested() {
   return state_->run_depth > 1;
 }
@@ -365,6 +461,7 @@ void MessageLoop::AssertIdle() const {
   // We only check |incoming_queue_|, since we don't want to lock |work_queue_|.
   base::AutoLock lock(incoming_queue_lock_);
   DCHECK(incoming_queue_.empty());
+  DCHECK(!base::subtle::NoBarrier_Load(&lock_free_incoming_head_));
 }
 
 bool MessageLoop::is_running() const {
@@ -486,6 +583,10 @@ void MessageLoop::AddToDelayedWorkQueue(const PendingTask& pending_task) {
   // delayed_run_time value.
   PendingTask new_pending_task(pending_task);
   new_pending_task.sequence_num = next_sequence_num_++;
+  if (timer_wheel_.get()) {
+    timer_wheel_->Push(new_pending_task);
+    return;
+  }
   delayed_work_queue_.push(new_pending_task);
 }
 
@@ -497,6 +598,11 @@ void MessageLoop::ReloadWorkQueue() {
   if (!work_queue_.empty())
     return;  // Wait till we *really* need to lock and load.
 
+  if (lock_free_incoming_queue_enabled_) {
+    DrainLockFreeIncomingQueue();
+    return;
+  }
+
   // Acquire all we can from the inter-thread queue with one lock acquisition.
   {
     base::AutoLock lock(incoming_queue_lock_);
@@ -524,6 +630,12 @@ bool MessageLoop::DeletePendingTasks() {
     deferred_non_nestable_work_queue_.pop();
   }
   did_work |= !delayed_work_queue_.empty();
+  if (timer_wheel_.get()) {
+    did_work |= !timer_wheel_->empty();
+    PendingTask task(FROM_HERE, base::Closure());
+    while (timer_wheel_->PopAny(&task)) {
+    }
+  }
 
   // Historically, we always delete the task regardless of valgrind status. It's
   // not completely clear why we want to leak them in the loops above.  This
@@ -581,6 +693,17 @@ void MessageLoop::AddToIncomingQueue(PendingTask* pending_task) {
   // directly, as it could starve handling of foreign threads.  Put every task
   // into this queue.
 
+  if (lock_free_incoming_queue_enabled_) {
+    // Take a reference to the pump before publishing the task: once the task
+    // is visible, the loop's thread may run it and destroy |this|.
+    scoped_refptr<base::MessagePump> pump(pump_);
+    bool was_empty = PushToLockFreeIncomingQueue(*pending_task);
+    pending_task->task.Reset();
+    if (was_empty)
+      pump->ScheduleWork();
+    return;
+  }
+
   scoped_refptr<base::MessagePump> pump;
   {
     base::AutoLock locked(incoming_queue_lock_);
@@ -601,6 +724,69 @@ void MessageLoop::AddToIncomingQueue(PendingTask* pending_task) {
   pump->ScheduleWork();
 }
 
+bool MessageLoop::PushToLockFreeIncomingQueue(const PendingTask& pending_task) {
+  LockFreeTaskNode* node = new LockFreeTaskNode(pending_task);
+  for (;;) {
+    base::subtle::AtomicWord head =
+        base::subtle::NoBarrier_Load(&lock_free_incoming_head_);
+    node->next = reinterpret_cast<LockFreeTaskNode*>(head);
+    // Release so the consumer's acquire in DrainLockFreeIncomingQueue() sees
+    // a fully constructed node.
+    if (base::subtle::Release_CompareAndSwap(
+            &lock_free_incoming_head_,
+            head,
+            reinterpret_cast<base::subtle::AtomicWord>(node)) == head) {
+      return head == 0;
+    }
+  }
+}
+
+bool MessageLoop::PushChainToLockFreeIncomingQueue(LockFreeTaskNode* top,
+                                                   LockFreeTaskNode* bottom) {
+  for (;;) {
+    base::subtle::AtomicWord head =
+        base::subtle::NoBarrier_Load(&lock_free_incoming_head_);
+    bottom->next = reinterpret_cast<LockFreeTaskNode*>(head);
+    // Release so the consumer's acquire in DrainLockFreeIncomingQueue() sees
+    // every fully constructed node in the chain.
+    if (base::subtle::Release_CompareAndSwap(
+            &lock_free_incoming_head_,
+            head,
+            reinterpret_cast<base::subtle::AtomicWord>(top)) == head) {
+      return head == 0;
+    }
+  }
+}
+
+void MessageLoop::DrainLockFreeIncomingQueue() {
+  base::subtle::AtomicWord head =
+      base::subtle::Acquire_Load(&lock_free_incoming_head_);
+  if (!head)
+    return;
+  // Detach the whole stack in one shot; producers keep pushing onto a fresh
+  // empty queue (and will ScheduleWork for it).
+  while (base::subtle::Acquire_CompareAndSwap(
+             &lock_free_incoming_head_, head, 0) != head) {
+    head = base::subtle::Acquire_Load(&lock_free_incoming_head_);
+  }
+
+  // The stack is in LIFO order; reverse it so tasks run in posting order.
+  LockFreeTaskNode* reversed = NULL;
+  LockFreeTaskNode* node = reinterpret_cast<LockFreeTaskNode*>(head);
+  while (node) {
+    LockFreeTaskNode* next = node->next;
+    node->next = reversed;
+    reversed = node;
+    node = next;
+  }
+  while (reversed) {
+    LockFreeTaskNode* next = reversed->next;
+    work_queue_.push(reversed->task);
+    delete reversed;
+    reversed = next;
+  }
+}
+
 //------------------------------------------------------------------------------
 // Method and data for histogramming events and actions taken by each instance
 // on each thread.
@@ -640,9 +826,14 @@ bool MessageLoop::DoWork() {
       work_queue_.pop();
       if (!pending_task.delayed_run_time.is_null()) {
         AddToDelayedWorkQueue(pending_task);
-        // If we changed the topmost task, then it is time to reschedule.
-        if (delayed_work_queue_.top().task.Equals(pending_task.task))
+        if (timer_wheel_.get()) {
+          // The wheel tracks the global earliest deadline; rescheduling with
+          // it is never later than needed.
+          pump_->ScheduleDelayedWork(timer_wheel_->next_run_time());
+        } else if (delayed_work_queue_.top().task.Equals(pending_task.task)) {
+          // If we changed the topmost task, then it is time to reschedule.
           pump_->ScheduleDelayedWork(pending_task.delayed_run_time);
+        }
       } else {
         if (DeferOrRunPendingTask(pending_task))
           return true;
@@ -655,6 +846,35 @@ bool MessageLoop::DoWork() {
 }
 
 bool MessageLoop::DoDelayedWork(TimeTicks* next_delayed_work_time) {
+  if (timer_wheel_.get()) {
+    if (!nestable_tasks_allowed_ || timer_wheel_->empty()) {
+      recent_time_ = *next_delayed_work_time = TimeTicks();
+      return false;
+    }
+
+    TimeTicks next_run_time = timer_wheel_->next_run_time();
+    if (next_run_time > recent_time_) {
+      recent_time_ = TimeTicks::Now();  // Get a better view of Now();
+      if (next_run_time > recent_time_) {
+        *next_delayed_work_time = next_run_time;
+        return false;
+      }
+    }
+
+    PendingTask pending_task(FROM_HERE, base::Closure());
+    if (!timer_wheel_->PopReady(recent_time_, &pending_task)) {
+      // The wheel woke us at slot granularity and cascaded; nothing was
+      // actually due yet, so re-arm with the refined deadline.
+      *next_delayed_work_time = timer_wheel_->next_run_time();
+      return false;
+    }
+
+    if (!timer_wheel_->empty())
+      *next_delayed_work_time = timer_wheel_->next_run_time();
+
+    return DeferOrRunPendingTask(pending_task);
+  }
+
   if (!nestable_tasks_allowed_ || delayed_work_queue_.empty()) {
     recent_time_ = *next_delayed_work_time = TimeTicks();
     return false;
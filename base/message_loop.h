@@ -8,12 +8,15 @@
 
 #include <queue>
 #include <string>
+#include <vector>
 
+#include "base/atomicops.h"
 #include "base/base_export.h"
 #include "base/basictypes.h"
 #include "base/callback_forward.h"
 #include "base/location.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/message_loop_proxy.h"
 #include "base/message_pump.h"
 #include "base/observer_list.h"
@@ -42,6 +45,7 @@
 
 namespace base {
 class Histogram;
+class TimerWheel;
 }
 
 // A MessageLoop is used to process events for a particular thread.  There is
@@ -162,6 +166,16 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
       const tracked_objects::Location& from_here,
       const base::Closure& task);
 
+  // Posts every closure in |*tasks| in order with a single insertion into
+  // the incoming queue: one lock acquisition (or one compare-and-swap) and
+  // at most one wakeup of the pump, instead of one of each per task.  Worth
+  // using for producers that generate bursts of related tasks, such as a
+  // network read fanned out to several consumers.  The closures in |*tasks|
+  // are reset before returning, like the |task| argument to PostTask.
+  void PostTaskBatch(
+      const tracked_objects::Location& from_here,
+      std::vector<base::Closure>* tasks);
+
   void PostDelayedTask(
       const tracked_objects::Location& from_here,
       const base::Closure& task, int64 delay_ms);
@@ -278,6 +292,21 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   void SetNestableTasksAllowed(bool allowed);
   bool NestableTasksAllowed() const;
 
+  // Enables a lock-free multi-producer single-consumer incoming queue, making
+  // a cross-thread PostTask a single compare-and-swap instead of an
+  // acquisition of |incoming_queue_lock_|.  This helps loops (e.g. the IO
+  // thread) whose PostTask path is contended by many producer threads.  Must
+  // be called on this loop's thread before any other thread posts tasks here;
+  // the locked queue remains the default.
+  void SetLockFreeIncomingQueue(bool enabled);
+
+  // Switches delayed-task bookkeeping from the priority-queue based
+  // DelayedTaskQueue to a hierarchical timer wheel (base/timer_wheel.h),
+  // giving O(1) insertion for the short-delay timeouts that dominate e.g.
+  // the IO thread.  Must be called on this loop's thread while no delayed
+  // tasks are pending; the priority queue remains the default.
+  void SetTimerWheelEnabled(bool enabled);
+
   // Enables nestable tasks on |loop| while in scope.
   class ScopedNestableTaskAllower {
    public:
@@ -437,6 +466,25 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // beyond this function call.
   void AddToIncomingQueue(base::PendingTask* pending_task);
 
+  // Node of the lock-free incoming queue; defined in message_loop.cc.
+  struct LockFreeTaskNode;
+
+  // Pushes |pending_task| onto the lock-free incoming queue with a single
+  // compare-and-swap.  Returns true if the queue was empty beforehand, i.e.
+  // the caller must schedule work on the pump.  Safe to call from any thread.
+  bool PushToLockFreeIncomingQueue(const base::PendingTask& pending_task);
+
+  // As above, but publishes a privately linked chain of nodes, |top| through
+  // |bottom|, with one compare-and-swap.  |bottom->next| is overwritten with
+  // the previous head.  Safe to call from any thread.
+  bool PushChainToLockFreeIncomingQueue(LockFreeTaskNode* top,
+                                        LockFreeTaskNode* bottom);
+
+  // Atomically detaches the whole lock-free incoming queue and appends its
+  // tasks to work_queue_ in FIFO posting order.  Only called on this loop's
+  // thread.
+  void DrainLockFreeIncomingQueue();
+
   // Load tasks from the incoming_queue_ into work_queue_ if the latter is
   // empty.  The former requires a lock to access, while the latter is directly
   // accessible on this thread.
@@ -473,6 +521,10 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // Contains delayed tasks, sorted by their 'delayed_run_time' property.
   base::DelayedTaskQueue delayed_work_queue_;
 
+  // When non-NULL, delayed tasks live here instead of delayed_work_queue_.
+  // See SetTimerWheelEnabled().
+  scoped_ptr<base::TimerWheel> timer_wheel_;
+
   // A recent snapshot of Time::Now(), used to check delayed_work_queue_.
   base::TimeTicks recent_time_;
 
@@ -503,6 +555,15 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // Protect access to incoming_queue_.
   mutable base::Lock incoming_queue_lock_;
 
+  // When true, cross-thread posts go through |lock_free_incoming_head_|
+  // instead of |incoming_queue_|.  See SetLockFreeIncomingQueue().
+  bool lock_free_incoming_queue_enabled_;
+
+  // Head of a Treiber stack of LockFreeTaskNodes, most recent post first.
+  // Producers push with a CAS; the loop's thread detaches the whole stack
+  // with an atomic exchange and reverses it into work_queue_.
+  base::subtle::AtomicWord lock_free_incoming_head_;
+
   RunState* state_;
 
 #if defined(OS_WIN)
@@ -30,6 +30,17 @@ bool MessageLoopProxyImpl::PostNonNestableDelayedTask(
       from_here, task, base::TimeDelta::FromMilliseconds(delay_ms));
 }
 
+bool MessageLoopProxyImpl::PostTaskBatch(
+    const tracked_objects::Location& from_here,
+    std::vector<base::Closure>* tasks) {
+  AutoLock lock(message_loop_lock_);
+  if (target_message_loop_) {
+    target_message_loop_->PostTaskBatch(from_here, tasks);
+    return true;
+  }
+  return false;
+}
+
 bool MessageLoopProxyImpl::PostDelayedTask(
     const tracked_objects::Location& from_here,
     const base::Closure& task,
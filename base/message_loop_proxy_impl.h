@@ -19,6 +19,8 @@ namespace base {
 class BASE_EXPORT MessageLoopProxyImpl : public MessageLoopProxy {
  public:
   // MessageLoopProxy implementation
+  virtual bool PostTaskBatch(const tracked_objects::Location& from_here,
+                             std::vector<base::Closure>* tasks) OVERRIDE;
   virtual bool PostDelayedTask(const tracked_objects::Location& from_here,
                                const base::Closure& task,
                                int64 delay_ms) OVERRIDE;
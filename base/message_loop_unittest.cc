@@ -142,6 +142,80 @@ void RunTest_PostTask_SEH(MessageLoop::Type message_loop_type) {
   EXPECT_EQ(foo->result(), "abacad");
 }
 
+// Runs on a poster thread; posts |count| tasks to |loop| followed by a
+// completion marker.  Used by RunTest_PostTask_LockFreeIncomingQueue.
+static void PosterDone(int* pending_posters) {
+  if (--(*pending_posters) == 0)
+    MessageLoop::current()->Quit();
+}
+
+static void PostTasksToLoop(MessageLoop* loop,
+                            scoped_refptr<Foo> foo,
+                            int count,
+                            int* pending_posters) {
+  for (int i = 0; i < count; ++i)
+    loop->PostTask(FROM_HERE, base::Bind(&Foo::Test1Int, foo, 1));
+  loop->PostTask(FROM_HERE, base::Bind(&PosterDone, pending_posters));
+}
+
+void RunTest_PostTask_LockFreeIncomingQueue(
+    MessageLoop::Type message_loop_type) {
+  MessageLoop loop(message_loop_type);
+  loop.SetLockFreeIncomingQueue(true);
+
+  const int kNumPosters = 4;
+  const int kNumTasksPerPoster = 50;
+  scoped_refptr<Foo> foo(new Foo());
+  int pending_posters = kNumPosters;
+
+  Thread* posters[kNumPosters];
+  for (int i = 0; i < kNumPosters; ++i) {
+    posters[i] = new Thread("lock-free queue poster");
+    posters[i]->Start();
+    posters[i]->message_loop()->PostTask(FROM_HERE, base::Bind(
+        &PostTasksToLoop, &loop, foo, kNumTasksPerPoster, &pending_posters));
+  }
+
+  // Runs until every poster's completion marker has been processed.  The
+  // markers are posted after each poster's tasks, so per-producer FIFO order
+  // guarantees all tasks have run by then.
+  loop.Run();
+
+  for (int i = 0; i < kNumPosters; ++i)
+    delete posters[i];
+
+  EXPECT_EQ(kNumPosters * kNumTasksPerPoster, foo->test_count());
+}
+
+void RunTest_PostTaskBatch(MessageLoop::Type message_loop_type,
+                           bool lock_free) {
+  MessageLoop loop(message_loop_type);
+  loop.SetLockFreeIncomingQueue(lock_free);
+
+  // The batch must run in posting order, interleave correctly with plain
+  // posts, and leave the vector empty.
+  scoped_refptr<Foo> foo(new Foo());
+  std::string a("a"), c("c");
+  std::vector<base::Closure> batch;
+  batch.push_back(base::Bind(&Foo::Test0, foo.get()));
+  batch.push_back(base::Bind(&Foo::Test1ConstRef, foo.get(), a));
+  batch.push_back(base::Bind(&Foo::Test2Ptr, foo.get(), &a, &c));
+
+  loop.PostTask(FROM_HERE, base::Bind(&Foo::Test1Int, foo.get(), 100));
+  loop.PostTaskBatch(FROM_HERE, &batch);
+  EXPECT_TRUE(batch.empty());
+  loop.PostTask(FROM_HERE, base::Bind(
+      &MessageLoop::Quit, base::Unretained(&loop)));
+
+  loop.Run();
+
+  EXPECT_EQ(103, foo->test_count());
+  EXPECT_EQ("aac", foo->result());
+
+  // An empty batch is a no-op.
+  loop.PostTaskBatch(FROM_HERE, &batch);
+}
+
 // This function runs slowly to simulate a large amount of work being done.
 static void SlowFunc(TimeDelta pause, int* quit_counter) {
     PlatformThread::Sleep(pause);
@@ -1303,6 +1377,19 @@ TEST(MessageLoopTest, PostTask_SEH) {
   RunTest_PostTask_SEH(MessageLoop::TYPE_IO);
 }
 
+TEST(MessageLoopTest, PostTask_LockFreeIncomingQueue) {
+  RunTest_PostTask_LockFreeIncomingQueue(MessageLoop::TYPE_DEFAULT);
+  RunTest_PostTask_LockFreeIncomingQueue(MessageLoop::TYPE_UI);
+  RunTest_PostTask_LockFreeIncomingQueue(MessageLoop::TYPE_IO);
+}
+
+TEST(MessageLoopTest, PostTaskBatch) {
+  RunTest_PostTaskBatch(MessageLoop::TYPE_DEFAULT, false);
+  RunTest_PostTaskBatch(MessageLoop::TYPE_DEFAULT, true);
+  RunTest_PostTaskBatch(MessageLoop::TYPE_UI, false);
+  RunTest_PostTaskBatch(MessageLoop::TYPE_IO, false);
+}
+
 TEST(MessageLoopTest, PostDelayedTask_Basic) {
   RunTest_PostDelayedTask_Basic(MessageLoop::TYPE_DEFAULT);
   RunTest_PostDelayedTask_Basic(MessageLoop::TYPE_UI);
@@ -6,6 +6,10 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#if defined(OS_LINUX)
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif
 
 #include "base/auto_reset.h"
 #include "base/compiler_specific.h"
@@ -123,7 +127,10 @@ MessagePumpLibevent::MessagePumpLibevent()
       processed_io_events_(false),
       event_base_(event_base_new()),
       wakeup_pipe_in_(-1),
-      wakeup_pipe_out_(-1) {
+      wakeup_pipe_out_(-1),
+      wakeup_is_eventfd_(false),
+      delayed_work_timer_fd_(-1),
+      delayed_work_event_(NULL) {
   if (!Init())
      NOTREACHED();
 }
@@ -133,11 +140,20 @@ MessagePumpLibevent::~MessagePumpLibevent() {
   DCHECK(event_base_);
   event_del(wakeup_event_);
   delete wakeup_event_;
+  if (delayed_work_event_) {
+    event_del(delayed_work_event_);
+    delete delayed_work_event_;
+  }
+  if (delayed_work_timer_fd_ >= 0) {
+    if (HANDLE_EINTR(close(delayed_work_timer_fd_)) < 0)
+      DPLOG(ERROR) << "close";
+  }
   if (wakeup_pipe_in_ >= 0) {
     if (HANDLE_EINTR(close(wakeup_pipe_in_)) < 0)
       DPLOG(ERROR) << "close";
   }
-  if (wakeup_pipe_out_ >= 0) {
+  // With an eventfd both ends are the same descriptor and were closed above.
+  if (!wakeup_is_eventfd_ && wakeup_pipe_out_ >= 0) {
     if (HANDLE_EINTR(close(wakeup_pipe_out_)) < 0)
       DPLOG(ERROR) << "close";
   }
@@ -269,6 +285,26 @@ void MessagePumpLibevent::Run(Delegate* delegate) {
     } else {
       TimeDelta delay = delayed_work_time_ - TimeTicks::Now();
       if (delay > TimeDelta()) {
+#if defined(OS_LINUX)
+        if (delayed_work_timer_fd_ >= 0) {
+          // Arm the persistently-watched timerfd for this sleep instead of
+          // registering and unregistering a libevent timer around every one.
+          struct itimerspec arm;
+          arm.it_interval.tv_sec = 0;
+          arm.it_interval.tv_nsec = 0;
+          arm.it_value = delay.ToTimeSpec();
+          if (timerfd_settime(delayed_work_timer_fd_, 0, &arm, NULL) == 0) {
+            event_base_loop(event_base_, EVLOOP_ONCE);
+            // Disarm in case we woke up for another reason. If the timer
+            // fired in the meantime OnDelayedWorkTimer() drains it, at worst
+            // on the next iteration at the cost of one spurious wakeup.
+            arm.it_value.tv_sec = 0;
+            arm.it_value.tv_nsec = 0;
+            timerfd_settime(delayed_work_timer_fd_, 0, &arm, NULL);
+            continue;
+          }
+        }
+#endif
         struct timeval poll_tv;
         poll_tv.tv_sec = delay.InSeconds();
         poll_tv.tv_usec = delay.InMicroseconds() % Time::kMicrosecondsPerSecond;
@@ -297,6 +333,15 @@ void MessagePumpLibevent::Quit() {
 
 void MessagePumpLibevent::ScheduleWork() {
   // Tell libevent (in a threadsafe way) that it should break out of its loop.
+  if (wakeup_is_eventfd_) {
+    // Increment the eventfd counter; concurrent ScheduleWork() calls coalesce
+    // into a single wakeup and a single read on the pump thread.
+    uint64 value = 1;
+    int nwrite = HANDLE_EINTR(write(wakeup_pipe_in_, &value, sizeof(value)));
+    DCHECK(nwrite == static_cast<int>(sizeof(value)) || errno == EAGAIN)
+        << "[nwrite:" << nwrite << "] [errno:" << errno << "]";
+    return;
+  }
   char buf = 0;
   int nwrite = HANDLE_EINTR(write(wakeup_pipe_in_, &buf, 1));
   DCHECK(nwrite == 1 || errno == EAGAIN)
@@ -320,21 +365,41 @@ void MessagePumpLibevent::DidProcessIOEvent() {
 }
 
 bool MessagePumpLibevent::Init() {
-  int fds[2];
-  if (pipe(fds)) {
-    DLOG(ERROR) << "pipe() failed, errno: " << errno;
-    return false;
-  }
-  if (SetNonBlocking(fds[0])) {
-    DLOG(ERROR) << "SetNonBlocking for pipe fd[0] failed, errno: " << errno;
-    return false;
+#if defined(OS_LINUX)
+  // Prefer a single eventfd over the pipe: one descriptor instead of two,
+  // and any number of pending wakeups drain with one 8-byte read. Old
+  // kernels without it fall through to the pipe below.
+  int wakeup_fd = eventfd(0, 0);
+  if (wakeup_fd >= 0) {
+    if (SetNonBlocking(wakeup_fd)) {
+      DLOG(ERROR) << "SetNonBlocking for eventfd failed, errno: " << errno;
+      if (HANDLE_EINTR(close(wakeup_fd)) < 0)
+        DPLOG(ERROR) << "close";
+    } else {
+      wakeup_pipe_out_ = wakeup_fd;
+      wakeup_pipe_in_ = wakeup_fd;
+      wakeup_is_eventfd_ = true;
+    }
   }
-  if (SetNonBlocking(fds[1])) {
-    DLOG(ERROR) << "SetNonBlocking for pipe fd[1] failed, errno: " << errno;
-    return false;
+#endif
+
+  if (!wakeup_is_eventfd_) {
+    int fds[2];
+    if (pipe(fds)) {
+      DLOG(ERROR) << "pipe() failed, errno: " << errno;
+      return false;
+    }
+    if (SetNonBlocking(fds[0])) {
+      DLOG(ERROR) << "SetNonBlocking for pipe fd[0] failed, errno: " << errno;
+      return false;
+    }
+    if (SetNonBlocking(fds[1])) {
+      DLOG(ERROR) << "SetNonBlocking for pipe fd[1] failed, errno: " << errno;
+      return false;
+    }
+    wakeup_pipe_out_ = fds[0];
+    wakeup_pipe_in_ = fds[1];
   }
-  wakeup_pipe_out_ = fds[0];
-  wakeup_pipe_in_ = fds[1];
 
   wakeup_event_ = new event;
   event_set(wakeup_event_, wakeup_pipe_out_, EV_READ | EV_PERSIST,
@@ -343,6 +408,35 @@ bool MessagePumpLibevent::Init() {
 
   if (event_add(wakeup_event_, 0))
     return false;
+
+#if defined(OS_LINUX)
+  // Keep one timerfd registered for the lifetime of the pump so that Run()
+  // can arm it with timerfd_settime() instead of paying for a libevent timer
+  // add/del pair on every sleep with delayed work pending. Optional: Run()
+  // falls back to the libevent timer when the descriptor is missing.
+  delayed_work_timer_fd_ = timerfd_create(CLOCK_MONOTONIC, 0);
+  if (delayed_work_timer_fd_ >= 0) {
+    if (SetNonBlocking(delayed_work_timer_fd_)) {
+      DLOG(ERROR) << "SetNonBlocking for timerfd failed, errno: " << errno;
+      if (HANDLE_EINTR(close(delayed_work_timer_fd_)) < 0)
+        DPLOG(ERROR) << "close";
+      delayed_work_timer_fd_ = -1;
+    } else {
+      delayed_work_event_ = new event;
+      event_set(delayed_work_event_, delayed_work_timer_fd_,
+                EV_READ | EV_PERSIST, OnDelayedWorkTimer, this);
+      event_base_set(event_base_, delayed_work_event_);
+      if (event_add(delayed_work_event_, 0)) {
+        delete delayed_work_event_;
+        delayed_work_event_ = NULL;
+        if (HANDLE_EINTR(close(delayed_work_timer_fd_)) < 0)
+          DPLOG(ERROR) << "close";
+        delayed_work_timer_fd_ = -1;
+      }
+    }
+  }
+#endif
+
   return true;
 }
 
@@ -373,13 +467,35 @@ void MessagePumpLibevent::OnWakeup(int socket, short flags, void* context) {
               static_cast<base::MessagePumpLibevent*>(context);
   DCHECK(that->wakeup_pipe_out_ == socket);
 
-  // Remove and discard the wakeup byte.
-  char buf;
-  int nread = HANDLE_EINTR(read(socket, &buf, 1));
-  DCHECK_EQ(nread, 1);
+  if (that->wakeup_is_eventfd_) {
+    // Reading the counter drains every wakeup posted so far at once.
+    uint64 value;
+    int nread = HANDLE_EINTR(read(socket, &value, sizeof(value)));
+    DCHECK_EQ(nread, static_cast<int>(sizeof(value)));
+  } else {
+    // Remove and discard the wakeup byte.
+    char buf;
+    int nread = HANDLE_EINTR(read(socket, &buf, 1));
+    DCHECK_EQ(nread, 1);
+  }
   that->processed_io_events_ = true;
   // Tell libevent to break out of inner loop.
   event_base_loopbreak(that->event_base_);
 }
 
+// Called when the timerfd armed in Run() for delayed work expires.
+// static
+void MessagePumpLibevent::OnDelayedWorkTimer(int fd, short flags,
+                                             void* context) {
+  base::MessagePumpLibevent* that =
+              static_cast<base::MessagePumpLibevent*>(context);
+  DCHECK(that->delayed_work_timer_fd_ == fd);
+
+  // Drain the expiration count and let Run() get to DoDelayedWork().
+  uint64 expirations;
+  int nread = HANDLE_EINTR(read(fd, &expirations, sizeof(expirations)));
+  DCHECK_EQ(nread, static_cast<int>(sizeof(expirations)));
+  event_base_loopbreak(that->event_base_);
+}
+
 }  // namespace base
@@ -148,6 +148,9 @@ class BASE_EXPORT MessagePumpLibevent : public MessagePump {
   // ... callback; called by libevent inside Run() when pipe is ready to read
   static void OnWakeup(int socket, short flags, void* context);
 
+  // Called by libevent when the timerfd armed for DoDelayedWork expires.
+  static void OnDelayedWorkTimer(int fd, short flags, void* context);
+
   // This flag is set to false when Run should return.
   bool keep_running_;
 
@@ -171,6 +174,17 @@ class BASE_EXPORT MessagePumpLibevent : public MessagePump {
   // ... libevent wrapper for read end
   event* wakeup_event_;
 
+  // True when an eventfd backs the wakeup above, in which case
+  // |wakeup_pipe_in_| and |wakeup_pipe_out_| are the same descriptor.
+  bool wakeup_is_eventfd_;
+
+  // One-shot timerfd armed before blocking when there is delayed work, or -1
+  // where timerfd is unavailable. Watched persistently by
+  // |delayed_work_event_|, so sleeping does not have to register and
+  // unregister a libevent timer every time.
+  int delayed_work_timer_fd_;
+  event* delayed_work_event_;
+
   ObserverList<IOObserver> io_observers_;
   ThreadChecker watch_file_descriptor_caller_checker_;
   DISALLOW_COPY_AND_ASSIGN(MessagePumpLibevent);
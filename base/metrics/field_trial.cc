@@ -8,6 +8,7 @@
 #include "base/logging.h"
 #include "base/rand_util.h"
 #include "base/sha1.h"
+#include "base/stl_util.h"
 #include "base/stringprintf.h"
 #include "base/string_util.h"
 #include "base/sys_byteorder.h"
@@ -201,6 +202,27 @@ double FieldTrial::HashClientId(const std::string& client_id,
   return BitsToOpenEndedUnitInterval(bits);
 }
 
+//------------------------------------------------------------------------------
+// FieldTrialList::TrialHandle methods and members.
+
+FieldTrialList::TrialHandle::TrialHandle() {}
+
+FieldTrialList::TrialHandle::TrialHandle(FieldTrial* trial) : trial_(trial) {}
+
+FieldTrialList::TrialHandle::~TrialHandle() {}
+
+int FieldTrialList::TrialHandle::value() const {
+  if (!trial_)
+    return FieldTrial::kNotFinalized;
+  return trial_->group();
+}
+
+std::string FieldTrialList::TrialHandle::full_name() const {
+  if (!trial_)
+    return "";
+  return trial_->group_name();
+}
+
 //------------------------------------------------------------------------------
 // FieldTrialList methods and members.
 
@@ -212,6 +234,7 @@ bool FieldTrialList::used_without_global_ = false;
 
 FieldTrialList::FieldTrialList(const std::string& client_id)
     : application_start_time_(TimeTicks::Now()),
+      snapshot_(0),
       client_id_(client_id),
       observer_list_(new ObserverListThreadSafe<FieldTrialList::Observer>(
           ObserverListBase<FieldTrialList::Observer>::NOTIFY_EXISTING_ONLY)) {
@@ -233,6 +256,10 @@ FieldTrialList::~FieldTrialList() {
     it->second->Release();
     registered_.erase(it->first);
   }
+  delete reinterpret_cast<RegistrationList*>(
+      subtle::NoBarrier_Load(&snapshot_));
+  snapshot_ = 0;
+  STLDeleteElements(&retired_snapshots_);
   DCHECK_EQ(this, global_);
   global_ = NULL;
 }
@@ -271,8 +298,14 @@ FieldTrial* FieldTrialList::FactoryGetFieldTrial(
 FieldTrial* FieldTrialList::Find(const std::string& name) {
   if (!global_)
     return NULL;
-  AutoLock auto_lock(global_->lock_);
-  return global_->PreLockedFind(name);
+  const RegistrationList* snapshot = reinterpret_cast<const RegistrationList*>(
+      subtle::Acquire_Load(&global_->snapshot_));
+  if (!snapshot)
+    return NULL;  // Nothing has been registered yet.
+  RegistrationList::const_iterator it = snapshot->find(name);
+  if (snapshot->end() == it)
+    return NULL;
+  return it->second;
 }
 
 // static
@@ -296,6 +329,12 @@ bool FieldTrialList::TrialExists(const std::string& name) {
   return Find(name) != NULL;
 }
 
+// static
+FieldTrialList::TrialHandle FieldTrialList::FindHandle(
+    const std::string& name) {
+  return TrialHandle(Find(name));
+}
+
 // static
 void FieldTrialList::StatesToString(std::string* output) {
   DCHECK(output->empty());
@@ -452,6 +491,17 @@ FieldTrial* FieldTrialList::PreLockedFind(const std::string& name) {
   return it->second;
 }
 
+void FieldTrialList::PreLockedPublishSnapshot() {
+  lock_.AssertAcquired();
+  RegistrationList* old_snapshot =
+      reinterpret_cast<RegistrationList*>(subtle::NoBarrier_Load(&snapshot_));
+  if (old_snapshot)
+    retired_snapshots_.push_back(old_snapshot);
+  subtle::Release_Store(
+      &snapshot_,
+      reinterpret_cast<subtle::AtomicWord>(new RegistrationList(registered_)));
+}
+
 // static
 void FieldTrialList::Register(FieldTrial* trial) {
   if (!global_) {
@@ -462,6 +512,7 @@ void FieldTrialList::Register(FieldTrial* trial) {
   DCHECK(!global_->PreLockedFind(trial->name()));
   trial->AddRef();
   global_->registered_[trial->name()] = trial;
+  global_->PreLockedPublishSnapshot();
 }
 
 }  // namespace base
@@ -79,6 +79,7 @@
 #include <string>
 #include <vector>
 
+#include "base/atomicops.h"
 #include "base/base_export.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
@@ -266,6 +267,39 @@ class BASE_EXPORT FieldTrialList {
     virtual ~Observer() {}
   };
 
+  // A TrialHandle caches the result of a single registration-list lookup so
+  // that callers which query the same trial repeatedly (e.g. on every
+  // connection setup) don't pay for a map lookup each time.  Handles are
+  // cheap to copy and remain valid for the life of the process.  A handle
+  // obtained before its trial was registered stays empty and reports the
+  // same results as a failed lookup.
+  class BASE_EXPORT TrialHandle {
+   public:
+    TrialHandle();
+    ~TrialHandle();
+
+    // Returns true if the named trial was registered when the handle was
+    // created.
+    bool exists() const { return trial_ != NULL; }
+
+    // Returns the group number chosen for the trial, or
+    // FieldTrial::kNotFinalized if the handle is empty.
+    int value() const;
+
+    // Returns the group name chosen for the trial, or the empty string if
+    // the handle is empty.
+    std::string full_name() const;
+
+   private:
+    friend class FieldTrialList;
+
+    explicit TrialHandle(FieldTrial* trial);
+
+    scoped_refptr<FieldTrial> trial_;
+
+    // Copy and assign are allowed.
+  };
+
   // This singleton holds the global list of registered FieldTrials.
   //
   // |client_id| should be an opaque, diverse ID for this client that does not
@@ -305,7 +339,10 @@ class BASE_EXPORT FieldTrialList {
       int* default_group_number);
 
   // The Find() method can be used to test to see if a named Trial was already
-  // registered, or to retrieve a pointer to it from the global map.
+  // registered, or to retrieve a pointer to it from the global map.  Find()
+  // and the query methods below search an immutable snapshot of the
+  // registration map that is republished on every registration, so they are
+  // lock-free and cheap enough to call from hot paths.
   static FieldTrial* Find(const std::string& name);
 
   // Returns the group number chosen for the named trial, or
@@ -319,6 +356,11 @@ class BASE_EXPORT FieldTrialList {
   // Returns true if the named trial has been registered.
   static bool TrialExists(const std::string& name);
 
+  // Returns a handle for the named trial, for callers that will query the
+  // same trial many times.  The handle is empty if the trial has not been
+  // registered yet.
+  static TrialHandle FindHandle(const std::string& name);
+
   // Creates a persistent representation of all FieldTrial instances for
   // resurrection in another process. This allows randomization to be done in
   // one process, and secondary processes can be synchronized on the result.
@@ -396,6 +438,11 @@ class BASE_EXPORT FieldTrialList {
   // Helper function should be called only while holding lock_.
   FieldTrial* PreLockedFind(const std::string& name);
 
+  // Copies registered_ into a freshly allocated map and publishes it in
+  // snapshot_ for the lock-free query methods.  Should be called, while
+  // holding lock_, after every change to registered_.
+  void PreLockedPublishSnapshot();
+
   // Register() stores a pointer to the given trial in a global map.
   // This method also AddRef's the indicated trial.
   // This should always be called after creating a new FieldTrial instance.
@@ -418,6 +465,15 @@ class BASE_EXPORT FieldTrialList {
   base::Lock lock_;
   RegistrationList registered_;
 
+  // An immutable copy of registered_ (a RegistrationList*), published with a
+  // Release_Store each time a trial is registered and read with an
+  // Acquire_Load by the query methods.  Snapshots that have been replaced
+  // are parked in retired_snapshots_ until destruction, since a concurrent
+  // reader may still be walking them; registration is rare and the maps are
+  // small, so this costs little.
+  subtle::AtomicWord snapshot_;
+  std::vector<RegistrationList*> retired_snapshots_;
+
   // An opaque, diverse ID for this client that does not change
   // between sessions, or the empty string if not initialized.
   std::string client_id_;
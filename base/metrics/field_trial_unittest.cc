@@ -352,6 +352,30 @@ TEST_F(FieldTrialTest, CreateFieldTrial) {
   EXPECT_EQ("Some_name", trial->name());
 }
 
+TEST_F(FieldTrialTest, FindHandle) {
+  // A handle taken before registration stays empty and behaves like a
+  // failed lookup.
+  FieldTrialList::TrialHandle empty_handle =
+      FieldTrialList::FindHandle("Some_name");
+  EXPECT_FALSE(empty_handle.exists());
+  EXPECT_EQ(FieldTrial::kNotFinalized, empty_handle.value());
+  EXPECT_EQ("", empty_handle.full_name());
+
+  FieldTrialList::CreateFieldTrial("Some_name", "Winner");
+
+  FieldTrialList::TrialHandle handle = FieldTrialList::FindHandle("Some_name");
+  ASSERT_TRUE(handle.exists());
+  EXPECT_EQ(FieldTrialList::FindValue("Some_name"), handle.value());
+  EXPECT_EQ("Winner", handle.full_name());
+
+  // Registering more trials republishes the snapshot; both old handles and
+  // fresh lookups must keep working.
+  FieldTrialList::CreateFieldTrial("Some_other_name", "Loser");
+  EXPECT_EQ("Winner", handle.full_name());
+  EXPECT_EQ("Winner", FieldTrialList::FindFullName("Some_name"));
+  EXPECT_EQ("Loser", FieldTrialList::FindFullName("Some_other_name"));
+}
+
 TEST_F(FieldTrialTest, DuplicateFieldTrial) {
   FieldTrial* trial = FieldTrialList::FactoryGetFieldTrial(
       "Some_name", 10, "Default some name", next_year_, 12, 31, NULL);
@@ -14,11 +14,13 @@
 #include <algorithm>
 #include <string>
 
+#include "base/atomicops.h"
 #include "base/debug/leak_annotations.h"
 #include "base/logging.h"
 #include "base/pickle.h"
 #include "base/stringprintf.h"
 #include "base/synchronization/lock.h"
+#include "base/threading/platform_thread.h"
 
 namespace base {
 
@@ -74,6 +76,9 @@ typedef Histogram::Count Count;
 // static
 const size_t Histogram::kBucketCount_MAX = 16384u;
 
+// static
+const size_t Histogram::kNumSampleShards;
+
 // Collect the number of histograms created.
 static uint32 number_of_histograms_ = 0;
 // Collect the number of vectors saved because of caching ranges.
@@ -149,7 +154,9 @@ void Histogram::AddBoolean(bool value) {
 }
 
 void Histogram::AddSampleSet(const SampleSet& sample) {
-  sample_.Add(sample);
+  // Bulk additions (browser-side shadow copies of renderer histograms) are
+  // not performance critical, so they all land in the first shard.
+  sample_shards_[0].Add(sample);
 }
 
 void Histogram::SetRangeDescriptions(const DescriptionPair descriptions[]) {
@@ -396,8 +403,10 @@ size_t Histogram::bucket_count() const {
 // Do a safe atomic snapshot of sample data.
 // This implementation assumes we are on a safe single thread.
 void Histogram::SnapshotSample(SampleSet* sample) const {
-  // Note locking not done in this version!!!
-  *sample = sample_;
+  // Merge all recording shards.  Note locking not done in this version!!!
+  *sample = sample_shards_[0];
+  for (size_t i = 1; i < kNumSampleShards; ++i)
+    sample->Add(sample_shards_[i]);
 }
 
 bool Histogram::HasConstructorArguments(Sample minimum,
@@ -428,7 +437,7 @@ Histogram::Histogram(const std::string& name, Sample minimum,
     flags_(kNoFlags),
     cached_ranges_(new CachedRanges(bucket_count + 1, 0)),
     range_checksum_(0),
-    sample_() {
+    sample_shards_() {
   Initialize();
 }
 
@@ -441,7 +450,7 @@ Histogram::Histogram(const std::string& name, TimeDelta minimum,
     flags_(kNoFlags),
     cached_ranges_(new CachedRanges(bucket_count + 1, 0)),
     range_checksum_(0),
-    sample_() {
+    sample_shards_() {
   Initialize();
 }
 
@@ -553,8 +562,11 @@ const std::string Histogram::GetAsciiBucketRange(size_t i) const {
 
 // Update histogram data with new sample.
 void Histogram::Accumulate(Sample value, Count count, size_t index) {
-  // Note locking not done in this version!!!
-  sample_.Accumulate(value, count, index);
+  // Shard on the calling thread's id so that concurrent writers usually hit
+  // distinct SampleSets; the SampleSet itself tallies atomically.
+  size_t shard = static_cast<size_t>(PlatformThread::CurrentId()) &
+      (kNumSampleShards - 1);
+  sample_shards_[shard].Accumulate(value, count, index);
 }
 
 void Histogram::SetBucketRange(size_t i, Sample value) {
@@ -583,7 +595,8 @@ uint32 Histogram::CalculateRangeChecksum() const {
 }
 
 void Histogram::Initialize() {
-  sample_.Resize(*this);
+  for (size_t i = 0; i < kNumSampleShards; ++i)
+    sample_shards_[i].Resize(*this);
   if (declared_min_ < 1)
     declared_min_ = 1;
   if (declared_max_ > kSampleType_MAX - 1)
@@ -721,9 +734,22 @@ void Histogram::SampleSet::CheckSize(const Histogram& histogram) const {
 void Histogram::SampleSet::Accumulate(Sample value,  Count count,
                                       size_t index) {
   DCHECK(count == 1 || count == -1);
-  counts_[index] += count;
-  sum_ += count * value;
+  // Bucket counts are bumped atomically so that writers racing into the same
+  // shard cannot lose samples.
+  subtle::NoBarrier_AtomicIncrement(
+      reinterpret_cast<volatile subtle::Atomic32*>(&counts_[index]), count);
+#if defined(ARCH_CPU_64_BITS)
+  subtle::NoBarrier_AtomicIncrement(
+      reinterpret_cast<volatile subtle::Atomic64*>(&sum_),
+      static_cast<int64>(count) * value);
+  subtle::NoBarrier_AtomicIncrement(
+      reinterpret_cast<volatile subtle::Atomic64*>(&redundant_count_), count);
+#else
+  // No Atomic64 on 32-bit targets; sharding already makes a race on these
+  // tallies far less likely than it was when every thread shared one set.
+  sum_ += static_cast<int64>(count) * value;
   redundant_count_ += count;
+#endif
   DCHECK_GE(counts_[index], 0);
   DCHECK_GE(sum_, 0);
   DCHECK_GE(redundant_count_, 0);
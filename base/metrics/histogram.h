@@ -654,8 +654,13 @@ class BASE_EXPORT Histogram {
   uint32 range_checksum_;
 
   // Finally, provide the state that changes with the addition of each new
-  // sample.
-  SampleSet sample_;
+  // sample.  Recording is sharded across a small array of SampleSets: each
+  // writing thread picks a shard from its thread id and bumps the tallies
+  // with atomic increments, so the hot path takes no lock and concurrent
+  // writers mostly touch distinct cache lines.  Readers merge all shards in
+  // SnapshotSample().  Must be a power of two (shards are selected by mask).
+  static const size_t kNumSampleShards = 4;
+  SampleSet sample_shards_[kNumSampleShards];
 
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
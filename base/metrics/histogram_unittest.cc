@@ -9,6 +9,7 @@
 
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
+#include "base/threading/simple_thread.h"
 #include "base/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -347,6 +348,48 @@ TEST(HistogramTest, BucketPlacementTest) {
     EXPECT_EQ(i + 1, sample.counts(i));
 }
 
+class SampleWriterThread : public DelegateSimpleThread::Delegate {
+ public:
+  SampleWriterThread(Histogram* histogram, int sample_count)
+      : histogram_(histogram),
+        sample_count_(sample_count) {
+  }
+
+  virtual void Run() {
+    for (int i = 0; i < sample_count_; ++i)
+      histogram_->Add(i % 60);
+  }
+
+ private:
+  Histogram* histogram_;
+  int sample_count_;
+};
+
+// Recording is sharded across SampleSets with atomic tallies; hammering one
+// histogram from several threads must not lose samples.
+TEST(HistogramTest, ThreadedAccumulate) {
+  static const int kNumThreads = 4;
+  static const int kSamplesPerThread = 10000;
+  Histogram* histogram(Histogram::FactoryGet(
+      "ThreadedHistogram", 1, 64, 8, Histogram::kNoFlags));
+
+  SampleWriterThread writer(histogram, kSamplesPerThread);
+  std::vector<DelegateSimpleThread*> threads;
+  for (int i = 0; i < kNumThreads; ++i)
+    threads.push_back(new DelegateSimpleThread(&writer, "sample_writer"));
+  for (int i = 0; i < kNumThreads; ++i)
+    threads[i]->Start();
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads[i]->Join();
+    delete threads[i];
+  }
+
+  Histogram::SampleSet snapshot;
+  histogram->SnapshotSample(&snapshot);
+  EXPECT_EQ(kNumThreads * kSamplesPerThread, snapshot.TotalCount());
+  EXPECT_EQ(kNumThreads * kSamplesPerThread, snapshot.redundant_count());
+}
+
 }  // namespace
 
 //------------------------------------------------------------------------------
@@ -357,10 +400,11 @@ TEST(HistogramTest, CorruptSampleCounts) {
   Histogram* histogram(Histogram::FactoryGet(
       "Histogram", 1, 64, 8, Histogram::kNoFlags));  // As per header file.
 
-  EXPECT_EQ(0, histogram->sample_.redundant_count());
+  Histogram::SampleSet empty_snapshot;
+  histogram->SnapshotSample(&empty_snapshot);
+  EXPECT_EQ(0, empty_snapshot.redundant_count());
   histogram->Add(20);  // Add some samples.
   histogram->Add(40);
-  EXPECT_EQ(2, histogram->sample_.redundant_count());
 
   Histogram::SampleSet snapshot;
   histogram->SnapshotSample(&snapshot);
@@ -4,6 +4,8 @@
 
 #include "base/metrics/stats_counters.h"
 
+#include "base/atomicops.h"
+
 namespace base {
 
 StatsCounter::StatsCounter(const std::string& name)
@@ -23,13 +25,26 @@ StatsCounter::~StatsCounter() {
 void StatsCounter::Set(int value) {
   int* loc = GetPtr();
   if (loc)
-    *loc = value;
+    subtle::NoBarrier_Store(
+        reinterpret_cast<volatile subtle::Atomic32*>(loc), value);
 }
 
 void StatsCounter::Add(int value) {
+  // Each registered thread writes its own column of the table, so this
+  // atomic add is normally uncontended; it is what keeps the cell sane
+  // when the thread's slot is reused or read by another process.
+  int* loc = GetPtr();
+  if (loc)
+    subtle::NoBarrier_AtomicIncrement(
+        reinterpret_cast<volatile subtle::Atomic32*>(loc), value);
+}
+
+int StatsCounter::value() {
   int* loc = GetPtr();
   if (loc)
-    (*loc) += value;
+    return subtle::NoBarrier_Load(
+        reinterpret_cast<volatile subtle::Atomic32*>(loc));
+  return 0;
 }
 
 StatsCounter::StatsCounter()
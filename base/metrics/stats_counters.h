@@ -85,7 +85,8 @@ class BASE_EXPORT StatsCounter {
   // Sets the counter to a specific value.
   void Set(int value);
 
-  // Increments the counter.
+  // Increments the counter.  This is a single lock-free add on the
+  // thread's cell in the shared memory table.
   void Increment() {
     Add(1);
   }
@@ -107,11 +108,7 @@ class BASE_EXPORT StatsCounter {
     return GetPtr() != NULL;
   }
 
-  int value() {
-    int* loc = GetPtr();
-    if (loc) return *loc;
-    return 0;
-  }
+  int value();
 
  protected:
   StatsCounter();
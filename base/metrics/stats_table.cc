@@ -4,6 +4,7 @@
 
 #include "base/metrics/stats_table.h"
 
+#include "base/atomicops.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/process_util.h"
@@ -47,15 +48,21 @@ namespace base {
 // About Locking:
 // This class is designed to be both multi-thread and multi-process safe.
 // Aside from initialization, this is done by partitioning the data which
-// each thread uses so that no locking is required.  However, to allocate
-// the rows and columns of the table to particular threads, locking is
-// required.
+// each thread uses so that no locking is required.  Counter cells are
+// read and written with lock-free atomic operations; since each
+// registered thread writes only its own column, the writes never contend.
 //
-// At the shared-memory level, we have a lock.  This lock protects the
-// shared-memory table only, and is used when we create new counters (e.g.
-// use rows) or when we register new threads (e.g. use columns).  Reading
-// data from the table does not require any locking at the shared memory
-// level.
+// Registering a thread is also lock-free: a slot whose thread id word is
+// zero is free, and a thread claims it with a compare-and-swap on that
+// word.  The thread name is the shared "slot in use" marker, so it is
+// written last when claiming and cleared first when releasing.
+//
+// At the shared-memory level, we still have a lock.  This lock protects
+// the shared-memory table only, and is used when we create new counters
+// (e.g. use rows) and for the batched reclamation sweep that releases
+// slots whose owners freed them by clearing the thread name alone.
+// Reading data from the table does not require any locking at the shared
+// memory level.
 //
 // Each process which accesses the table will create a StatsTable object.
 // The StatsTable maintains a hash table of the existing counters in the
@@ -68,12 +75,23 @@ namespace base {
 // we all need to use the same size ints.
 COMPILE_ASSERT(sizeof(int)==4, expect_4_byte_ints);
 
+// The thread id words in the table are claimed with compare-and-swaps,
+// so they must be the same size as our atomic type.
+COMPILE_ASSERT(sizeof(PlatformThreadId) == sizeof(subtle::Atomic32),
+               expect_4_byte_tids);
+
 namespace {
 
 // An internal version in case we ever change the format of this
 // file, and so that we can identify our table.
 const int kTableVersion = 0x13131313;
 
+// Written to a slot's thread id word between the compare-and-swap that
+// claims the slot and the store of the real thread id, so that the
+// reclamation sweep never frees a slot which is mid-registration.  Not a
+// valid thread id on any platform.
+const subtle::Atomic32 kSlotClaimPending = -1;
+
 // The name for un-named counters and threads in the table.
 const char kUnknownName[] = "<unknown>";
 
@@ -293,30 +311,35 @@ int StatsTable::GetSlot() const {
 }
 
 int StatsTable::RegisterThread(const std::string& name) {
-  int slot = 0;
   if (!impl_)
     return 0;
 
-  // Registering a thread requires that we lock the shared memory
-  // so that two threads don't grab the same slot.  Fortunately,
-  // thread creation shouldn't happen in inner loops.
-  {
-    SharedMemoryAutoLock lock(impl_->shared_memory());
-    slot = FindEmptyThread();
-    if (!slot) {
+  // Claiming a slot is lock-free: we take the first slot whose thread id
+  // word is zero with a compare-and-swap, so two threads can't grab the
+  // same slot.
+  int slot = TryClaimThreadSlot();
+  if (!slot) {
+    // The table looks full.  Slots released by clearing the thread name
+    // alone still hold a stale thread id; reclaim them all in one batch
+    // and retry before giving up.
+    ReclaimFreeThreadSlots();
+    slot = TryClaimThreadSlot();
+    if (!slot)
       return 0;
-    }
-
-    // We have space, so consume a column in the table.
-    std::string thread_name = name;
-    if (name.empty())
-      thread_name = kUnknownName;
-    strlcpy(impl_->thread_name(slot), thread_name.c_str(),
-            kMaxThreadNameLength);
-    *(impl_->thread_tid(slot)) = PlatformThread::CurrentId();
-    *(impl_->thread_pid(slot)) = GetCurrentProcId();
   }
 
+  // We own the column now, so fill in our identity.  The name is written
+  // last: a non-empty name is what marks the slot as in use to readers.
+  std::string thread_name = name;
+  if (name.empty())
+    thread_name = kUnknownName;
+  *(impl_->thread_pid(slot)) = GetCurrentProcId();
+  strlcpy(impl_->thread_name(slot), thread_name.c_str(),
+          kMaxThreadNameLength);
+  subtle::Release_Store(
+      reinterpret_cast<volatile subtle::Atomic32*>(impl_->thread_tid(slot)),
+      static_cast<subtle::Atomic32>(PlatformThread::CurrentId()));
+
   // Set our thread local storage.
   TLSData* data = new TLSData;
   data->table = this;
@@ -391,7 +414,8 @@ int StatsTable::GetRowValue(int index, int pid) const {
   int* row = impl_->row(index);
   for (int slot_id = 0; slot_id < impl_->max_threads(); slot_id++) {
     if (pid == 0 || *impl_->thread_pid(slot_id) == pid)
-      rv += row[slot_id];
+      rv += subtle::NoBarrier_Load(
+          reinterpret_cast<volatile subtle::Atomic32*>(&row[slot_id]));
   }
   return rv;
 }
@@ -451,9 +475,16 @@ void StatsTable::UnregisterThread(TLSData* data) {
     return;
   DCHECK(impl_);
 
-  // Mark the slot free by zeroing out the thread name.
+  // Mark the slot free by zeroing out the thread name, then release the
+  // thread id word so the slot can be claimed again without a sweep.  The
+  // release ordering makes sure the cleared name is visible before the
+  // slot appears free to a claiming thread.
   char* name = impl_->thread_name(data->slot);
   *name = '\0';
+  subtle::Release_Store(
+      reinterpret_cast<volatile subtle::Atomic32*>(
+          impl_->thread_tid(data->slot)),
+      0);
 
   // Remove the calling thread's TLS so that it cannot use the slot.
   tls_index_.Set(NULL);
@@ -471,7 +502,7 @@ void StatsTable::SlotReturnFunction(void* data) {
   }
 }
 
-int StatsTable::FindEmptyThread() const {
+int StatsTable::TryClaimThreadSlot() {
   // Note: the API returns slots numbered from 1..N, although
   // internally, the array is 0..N-1.  This is so that we can return
   // zero as "not found".
@@ -483,15 +514,37 @@ int StatsTable::FindEmptyThread() const {
   if (!impl_)
     return 0;
 
-  int index = 1;
-  for (; index <= impl_->max_threads(); index++) {
-    char* name = impl_->thread_name(index);
-    if (!*name)
-      break;
+  for (int index = 1; index <= impl_->max_threads(); index++) {
+    volatile subtle::Atomic32* tid =
+        reinterpret_cast<volatile subtle::Atomic32*>(impl_->thread_tid(index));
+    if (subtle::NoBarrier_Load(tid) == 0 &&
+        subtle::Acquire_CompareAndSwap(tid, 0, kSlotClaimPending) == 0)
+      return index;
+  }
+  return 0;  // The table is full.
+}
+
+void StatsTable::ReclaimFreeThreadSlots() {
+  // A slot is free once its thread name is empty, but the thread id word
+  // may still hold a stale id: clients of older versions of the table
+  // cleared only the name when unregistering.  Sweep the whole table once
+  // under the lock, releasing every such id in a batch, rather than
+  // paying for a locked scan on each registration.
+  //
+  // Slots holding kSlotClaimPending are skipped: their claimant has not
+  // written its thread name yet, so they look free but are not.
+  if (!impl_)
+    return;
+
+  SharedMemoryAutoLock lock(impl_->shared_memory());
+  for (int index = 1; index <= impl_->max_threads(); index++) {
+    volatile subtle::Atomic32* tid =
+        reinterpret_cast<volatile subtle::Atomic32*>(impl_->thread_tid(index));
+    subtle::Atomic32 value = subtle::NoBarrier_Load(tid);
+    if (value != 0 && value != kSlotClaimPending &&
+        *impl_->thread_name(index) == '\0')
+      subtle::Release_CompareAndSwap(tid, value, 0);
   }
-  if (index > impl_->max_threads())
-    return 0;  // The table is full.
-  return index;
 }
 
 int StatsTable::FindCounterOrEmptyRow(const std::string& name) const {
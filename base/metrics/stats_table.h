@@ -149,10 +149,15 @@ class BASE_EXPORT StatsTable {
   // which used the StatsTable.
   static void SlotReturnFunction(void* data);
 
-  // Locates a free slot in the table.  Returns a number > 0 on success,
-  // or 0 on failure.  The caller must hold the shared_memory lock when
-  // calling this function.
-  int FindEmptyThread() const;
+  // Attempts to claim a free slot in the table with a compare-and-swap
+  // on the slot's thread id word.  Returns a number > 0 on success, or 0
+  // if no free slot was found.  Requires no lock.
+  int TryClaimThreadSlot();
+
+  // Batch-reclaims slots that were freed by clearing the thread name
+  // alone, releasing their stale thread ids under the shared memory lock
+  // so that TryClaimThreadSlot can reuse them.
+  void ReclaimFreeThreadSlots();
 
   // Locates a counter in the table or finds an empty row.  Returns a
   // number > 0 on success, or 0 on failure.  The caller must hold the
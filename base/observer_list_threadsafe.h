@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <map>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/bind.h"
@@ -48,7 +49,10 @@
 //   The ObserverListThreadSafe maintains an ObserverList for each thread
 //   which uses the ThreadSafeObserver.  When Notifying the observers,
 //   we simply call PostTask to each registered thread, and then each thread
-//   will notify its regular ObserverList.
+//   will notify its regular ObserverList.  The notification parameters are
+//   allocated once per Notify() call and shared, via refcounting, by the
+//   tasks posted to every destination thread, so the cost of a broadcast
+//   does not multiply with the number of threads listening.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -225,16 +229,54 @@ class ObserverListThreadSafe
     observer_lists_.clear();
   }
 
+  // Holds the unbound method and its parameters for one Notify() call.
+  // A single instance is shared by the tasks posted to every destination
+  // thread, so the parameters are stored (and destroyed) only once no matter
+  // how wide the fan-out is.
+  template <class Method, class Params>
+  class NotificationData
+      : public base::RefCountedThreadSafe<NotificationData<Method, Params> > {
+   public:
+    explicit NotificationData(
+        const UnboundMethod<ObserverType, Method, Params>& m)
+        : method(m) {
+    }
+
+    const UnboundMethod<ObserverType, Method, Params> method;
+
+   private:
+    friend class base::RefCountedThreadSafe<NotificationData<Method, Params> >;
+    ~NotificationData() {}
+  };
+
   template <class Method, class Params>
   void Notify(const UnboundMethod<ObserverType, Method, Params>& method) {
-    base::AutoLock lock(list_lock_);
-    typename ObserversListMap::iterator it;
-    for (it = observer_lists_.begin(); it != observer_lists_.end(); ++it) {
-      ObserverListContext* context = (*it).second;
-      context->loop->PostTask(
+    scoped_refptr<NotificationData<Method, Params> > data(
+        new NotificationData<Method, Params>(method));
+
+    // Snapshot the destinations under the lock, but post outside of it so
+    // that a woken thread running NotifyWrapper() does not immediately block
+    // on |list_lock_| while we are still posting to the remaining loops.
+    // The contexts are validated against the map again in NotifyWrapper()
+    // before they are dereferenced, as they may be deleted in the meantime.
+    std::vector<std::pair<scoped_refptr<base::MessageLoopProxy>,
+                          ObserverListContext*> > destinations;
+    {
+      base::AutoLock lock(list_lock_);
+      destinations.reserve(observer_lists_.size());
+      typename ObserversListMap::iterator it;
+      for (it = observer_lists_.begin(); it != observer_lists_.end(); ++it) {
+        ObserverListContext* context = (*it).second;
+        destinations.push_back(std::make_pair(context->loop, context));
+      }
+    }
+
+    for (size_t i = 0; i < destinations.size(); ++i) {
+      destinations[i].first->PostTask(
           FROM_HERE,
           base::Bind(&ObserverListThreadSafe<ObserverType>::
-              template NotifyWrapper<Method, Params>, this, context, method));
+              template NotifyWrapper<Method, Params>, this,
+              destinations[i].second, data));
     }
   }
 
@@ -242,8 +284,9 @@ class ObserverListThreadSafe
   // ObserverList.  This function MUST be called on the thread which owns
   // the unsafe ObserverList.
   template <class Method, class Params>
-  void NotifyWrapper(ObserverListContext* context,
-      const UnboundMethod<ObserverType, Method, Params>& method) {
+  void NotifyWrapper(
+      ObserverListContext* context,
+      const scoped_refptr<NotificationData<Method, Params> >& data) {
 
     // Check that this list still needs notifications.
     {
@@ -263,7 +306,7 @@ class ObserverListThreadSafe
       typename ObserverList<ObserverType>::Iterator it(context->list);
       ObserverType* obs;
       while ((obs = it.GetNext()) != NULL)
-        method.Run(obs);
+        data->method.Run(obs);
     }
 
     // If there are no more observers on the list, we can now delete it.
@@ -17,7 +17,8 @@ static const size_t kCapacityReadOnly = static_cast<size_t>(-1);
 
 PickleIterator::PickleIterator(const Pickle& pickle)
     : read_ptr_(pickle.payload()),
-      read_end_ptr_(pickle.end_of_payload()) {
+      read_end_ptr_(pickle.end_of_payload()),
+      region_end_ptr_(NULL) {
 }
 
 template <typename Type>
@@ -62,6 +63,40 @@ inline const char* PickleIterator::GetReadPointerAndAdvance(int num_elements,
   return GetReadPointerAndAdvance(num_bytes32);
 }
 
+template <typename Type>
+inline void PickleIterator::ReadBuiltinTypeNoCheck(Type* result) {
+  DCHECK(region_end_ptr_);
+  DCHECK(read_ptr_ + sizeof(Type) <= region_end_ptr_);
+  if (sizeof(Type) > sizeof(uint32))
+    memcpy(result, read_ptr_, sizeof(*result));
+  else
+    *result = *reinterpret_cast<const Type*>(read_ptr_);
+  read_ptr_ += AlignInt(sizeof(Type), sizeof(uint32));
+}
+
+bool PickleIterator::CheckRegion(int num_bytes) {
+  if (num_bytes < 0 || read_end_ptr_ - read_ptr_ < num_bytes)
+    return false;
+  region_end_ptr_ = read_ptr_ + num_bytes;
+  return true;
+}
+
+void PickleIterator::ReadBoolNoCheck(bool* result) {
+  ReadBuiltinTypeNoCheck(result);
+}
+
+void PickleIterator::ReadIntNoCheck(int* result) {
+  ReadBuiltinTypeNoCheck(result);
+}
+
+void PickleIterator::ReadUInt32NoCheck(uint32* result) {
+  ReadBuiltinTypeNoCheck(result);
+}
+
+void PickleIterator::ReadInt64NoCheck(int64* result) {
+  ReadBuiltinTypeNoCheck(result);
+}
+
 bool PickleIterator::ReadBool(bool* result) {
   return ReadBuiltinType(result);
 }
@@ -102,6 +137,18 @@ bool PickleIterator::ReadString(std::string* result) {
   return true;
 }
 
+bool PickleIterator::ReadStringPiece(base::StringPiece* result) {
+  int len;
+  if (!ReadInt(&len))
+    return false;
+  const char* read_from = GetReadPointerAndAdvance(len);
+  if (!read_from)
+    return false;
+
+  *result = base::StringPiece(read_from, len);
+  return true;
+}
+
 bool PickleIterator::ReadWString(std::wstring* result) {
   int len;
   if (!ReadInt(&len))
@@ -300,6 +347,15 @@ void Pickle::TrimWriteData(int new_length) {
   *cur_length = new_length;
 }
 
+void Pickle::Reserve(size_t additional_capacity) {
+  // write at a uint32-aligned offset from the beginning of the header
+  size_t offset = AlignInt(header_->payload_size, sizeof(uint32));
+
+  size_t needed_size = header_size_ + offset + additional_capacity;
+  if (needed_size > capacity_)
+    Resize(needed_size);
+}
+
 char* Pickle::BeginWrite(size_t length) {
   // write at a uint32-aligned offset from the beginning of the header
   size_t offset = AlignInt(header_->payload_size, sizeof(uint32));
@@ -14,6 +14,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/logging.h"
 #include "base/string16.h"
+#include "base/string_piece.h"
 
 class Pickle;
 
@@ -21,7 +22,8 @@ class Pickle;
 // while the PickleIterator object is in use.
 class BASE_EXPORT PickleIterator {
  public:
-  PickleIterator() : read_ptr_(NULL), read_end_ptr_(NULL) {}
+  PickleIterator()
+      : read_ptr_(NULL), read_end_ptr_(NULL), region_end_ptr_(NULL) {}
   explicit PickleIterator(const Pickle& pickle);
 
   // Methods for reading the payload of the Pickle. To read from the start of
@@ -36,6 +38,10 @@ class BASE_EXPORT PickleIterator {
   bool ReadInt64(int64* result) WARN_UNUSED_RESULT;
   bool ReadUInt64(uint64* result) WARN_UNUSED_RESULT;
   bool ReadString(std::string* result) WARN_UNUSED_RESULT;
+  // Reads a string as a StringPiece referencing the Pickle's own buffer,
+  // avoiding the copy that ReadString makes.  The result is valid only as
+  // long as the Pickle's data is.
+  bool ReadStringPiece(base::StringPiece* result) WARN_UNUSED_RESULT;
   bool ReadWString(std::wstring* result) WARN_UNUSED_RESULT;
   bool ReadString16(string16* result) WARN_UNUSED_RESULT;
   bool ReadData(const char** data, int* length) WARN_UNUSED_RESULT;
@@ -53,6 +59,17 @@ class BASE_EXPORT PickleIterator {
     return !!GetReadPointerAndAdvance(num_bytes);
   }
 
+  // Batch validation for hot deserializers.  CheckRegion verifies once that
+  // the next |num_bytes| of payload are present; the *NoCheck readers may
+  // then be used for the fixed-size fields inside that region, skipping the
+  // per-field bounds check.  Debug builds still DCHECK that each read stays
+  // inside the checked region.
+  bool CheckRegion(int num_bytes) WARN_UNUSED_RESULT;
+  void ReadBoolNoCheck(bool* result);
+  void ReadIntNoCheck(int* result);
+  void ReadUInt32NoCheck(uint32* result);
+  void ReadInt64NoCheck(int64* result);
+
  private:
   // Aligns 'i' by rounding it up to the next multiple of 'alignment'
   static size_t AlignInt(size_t i, int alignment) {
@@ -63,6 +80,10 @@ class BASE_EXPORT PickleIterator {
   template <typename Type>
   inline bool ReadBuiltinType(Type* result);
 
+  // Read Type from inside a region validated by CheckRegion.
+  template <typename Type>
+  inline void ReadBuiltinTypeNoCheck(Type* result);
+
   // Get read pointer for Type and advance read pointer.
   template<typename Type>
   inline const char* GetReadPointerAndAdvance();
@@ -80,6 +101,10 @@ class BASE_EXPORT PickleIterator {
   const char* read_ptr_;
   const char* read_end_ptr_;
 
+  // End of the span validated by the last CheckRegion call; used to DCHECK
+  // the *NoCheck readers.
+  const char* region_end_ptr_;
+
   FRIEND_TEST_ALL_PREFIXES(PickleTest, GetReadPointerAndAdvance);
 };
 
@@ -217,6 +242,35 @@ class BASE_EXPORT Pickle {
   bool WriteData(const char* data, int length);
   bool WriteBytes(const void* data, int data_len);
 
+  // Precompute the number of payload bytes the corresponding Write method
+  // will append, including length prefixes and uint32 alignment padding.
+  // Summing these for every value in a message and passing the total to
+  // Reserve() lets a message of known content be built with a single
+  // allocation instead of a series of doubling reallocs.
+  static size_t SizeOfBytes(size_t data_len) {
+    return AlignInt(data_len, sizeof(uint32));
+  }
+  static size_t SizeOfData(size_t data_len) {
+    return SizeOfBytes(sizeof(int)) + SizeOfBytes(data_len);
+  }
+  static size_t SizeOfString(const std::string& value) {
+    return SizeOfData(value.size());
+  }
+  static size_t SizeOfWString(const std::wstring& value) {
+    return SizeOfData(value.size() * sizeof(wchar_t));
+  }
+  static size_t SizeOfString16(const string16& value) {
+    return SizeOfData(value.size() * sizeof(char16));
+  }
+
+  // Ensures that at least |additional_capacity| payload bytes can be
+  // appended without reallocating.  Unlike the implicit growth performed by
+  // the Write methods, which doubles the capacity each time it runs out,
+  // this resizes to exactly what is needed, so callers that know the final
+  // message size up front (see the SizeOf helpers above) get one
+  // right-sized allocation with no overshoot.
+  void Reserve(size_t additional_capacity);
+
   // Same as WriteData, but allows the caller to write directly into the
   // Pickle. This saves a copy in cases where the data is not already
   // available in a buffer. The caller should take care to not write more
@@ -324,6 +378,7 @@ class BASE_EXPORT Pickle {
   size_t variable_buffer_offset_;  // IF non-zero, then offset to a buffer.
 
   FRIEND_TEST_ALL_PREFIXES(PickleTest, Resize);
+  FRIEND_TEST_ALL_PREFIXES(PickleTest, Reserve);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNext);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNextWithIncompleteHeader);
 };
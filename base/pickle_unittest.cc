@@ -239,6 +239,42 @@ TEST(PickleTest, Resize) {
   EXPECT_EQ(cur_payload, pickle.payload_size());
 }
 
+TEST(PickleTest, Reserve) {
+  const std::string data(1000, 'G');
+  const std::string data2(377, 'H');
+
+  // Precompute the payload and reserve it all up front; the subsequent
+  // writes must then fit without another allocation.
+  Pickle pickle;
+  pickle.Reserve(Pickle::SizeOfString(data) +
+                 Pickle::SizeOfString(data2) +
+                 Pickle::SizeOfBytes(sizeof(int)));
+  size_t capacity_before = pickle.capacity();
+  EXPECT_TRUE(pickle.WriteString(data));
+  EXPECT_TRUE(pickle.WriteString(data2));
+  EXPECT_TRUE(pickle.WriteInt(42));
+  EXPECT_EQ(capacity_before, pickle.capacity());
+
+  // The SizeOf helpers must account for every byte written, including
+  // length prefixes and alignment padding.
+  EXPECT_EQ(Pickle::SizeOfString(data) +
+            Pickle::SizeOfString(data2) +
+            Pickle::SizeOfBytes(sizeof(int)),
+            pickle.payload_size());
+
+  // Make sure the content survived intact.
+  PickleIterator iter(pickle);
+  std::string read_back;
+  std::string read_back2;
+  int read_int = 0;
+  EXPECT_TRUE(iter.ReadString(&read_back));
+  EXPECT_TRUE(iter.ReadString(&read_back2));
+  EXPECT_TRUE(iter.ReadInt(&read_int));
+  EXPECT_EQ(data, read_back);
+  EXPECT_EQ(data2, read_back2);
+  EXPECT_EQ(42, read_int);
+}
+
 namespace {
 
 struct CustomHeader : Pickle::Header {
@@ -334,3 +370,56 @@ TEST(PickleTest, ReadBytes) {
   memcpy(&outdata, outdata_char, sizeof(outdata));
   EXPECT_EQ(data, outdata);
 }
+
+TEST(PickleTest, StringPiece) {
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteString(teststr));
+  EXPECT_TRUE(pickle.WriteInt(testint));
+
+  PickleIterator iter(pickle);
+  base::StringPiece outstr;
+  EXPECT_TRUE(iter.ReadStringPiece(&outstr));
+  EXPECT_EQ(teststr, outstr.as_string());
+  // The piece must reference the pickle's buffer, not a copy.
+  EXPECT_GE(outstr.data(), static_cast<const char*>(pickle.data()));
+
+  int outint;
+  EXPECT_TRUE(iter.ReadInt(&outint));
+  EXPECT_EQ(testint, outint);
+
+  // A length running past the payload must fail like ReadString does.
+  Pickle bad;
+  EXPECT_TRUE(bad.WriteInt(100));
+  PickleIterator bad_iter(bad);
+  EXPECT_FALSE(bad_iter.ReadStringPiece(&outstr));
+}
+
+TEST(PickleTest, CheckRegion) {
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteBool(testbool2));
+  EXPECT_TRUE(pickle.WriteInt(testint));
+  EXPECT_TRUE(pickle.WriteUInt32(0xDEADBEEF));
+  EXPECT_TRUE(pickle.WriteInt64(GG_INT64_C(0x123456789ABC)));
+
+  // Four fields, each padded to uint32 except the 8-byte int64.
+  PickleIterator iter(pickle);
+  EXPECT_TRUE(iter.CheckRegion(3 * sizeof(uint32) + sizeof(int64)));
+
+  bool outbool;
+  iter.ReadBoolNoCheck(&outbool);
+  EXPECT_EQ(testbool2, outbool);
+  int outint;
+  iter.ReadIntNoCheck(&outint);
+  EXPECT_EQ(testint, outint);
+  uint32 outuint32;
+  iter.ReadUInt32NoCheck(&outuint32);
+  EXPECT_EQ(0xDEADBEEFu, outuint32);
+  int64 outint64;
+  iter.ReadInt64NoCheck(&outint64);
+  EXPECT_EQ(GG_INT64_C(0x123456789ABC), outint64);
+
+  // Declaring more bytes than the payload holds must fail up front.
+  PickleIterator short_iter(pickle);
+  EXPECT_FALSE(short_iter.CheckRegion(kuint32max / 2));
+  EXPECT_FALSE(short_iter.CheckRegion(-1));
+}
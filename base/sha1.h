@@ -9,6 +9,7 @@
 #include <string>
 
 #include "base/base_export.h"
+#include "base/basictypes.h"
 
 namespace base {
 
@@ -25,6 +26,45 @@ BASE_EXPORT std::string SHA1HashString(const std::string& str);
 BASE_EXPORT void SHA1HashBytes(const unsigned char* data, size_t len,
                                unsigned char* hash);
 
+// Computes a SHA-1 hash incrementally, for callers whose input arrives in
+// pieces.  Whole 64-byte blocks are hashed straight out of the caller's
+// buffer (using an SSSE3 block function where the CPU supports it), so no
+// intermediate copies of the bulk data are made.
+//
+// Usage example:
+//
+//   SecureHashAlgorithm sha;
+//   while (there is data to hash)
+//     sha.Update(moredata, size of data);
+//   sha.Final();
+//   memcpy(somewhere, sha.Digest(), 20);
+//
+// To reuse the instance of sha, call sha.Init().
+class BASE_EXPORT SecureHashAlgorithm {
+ public:
+  SecureHashAlgorithm() { Init(); }
+
+  static const int kDigestSizeBytes;
+
+  void Init();
+  void Update(const void* data, size_t nbytes);
+  void Final();
+
+  // 20 bytes of message digest.
+  const unsigned char* Digest() const {
+    return reinterpret_cast<const unsigned char*>(H);
+  }
+
+ private:
+  void Pad();
+  void Process();
+
+  uint32 H[5];
+  uint8 M[64];   // Holds a partially filled block between Update calls.
+  uint32 cursor;
+  uint32 l;
+};
+
 }  // namespace base
 
 #endif  // BASE_SHA1_H_
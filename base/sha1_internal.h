@@ -0,0 +1,39 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_SHA1_INTERNAL_H_
+#define BASE_SHA1_INTERNAL_H_
+#pragma once
+
+#include "build/build_config.h"
+
+#include "base/basictypes.h"
+
+// SHA-1 block functions shared between sha1_portable.cc, which owns the
+// streaming state and runtime CPU dispatch, and sha1_ssse3.cc, which is
+// compiled with SSSE3 enabled.  Not part of the public API; use the
+// functions and SecureHashAlgorithm in base/sha1.h instead.
+
+namespace base {
+namespace internal {
+
+// Folds |num_blocks| consecutive 64-byte message blocks at |data| into
+// |state| (the five 32-bit SHA-1 chaining values, host byte order).  |data|
+// need not be aligned.
+void SHA1ProcessBlocksPortable(uint32 state[5],
+                               const uint8* data,
+                               size_t num_blocks);
+
+#if defined(ARCH_CPU_X86_FAMILY)
+// As above, with the message schedule computed four words at a time with
+// SSSE3.  Only call on CPUs where base::CPU::has_ssse3() is true.
+void SHA1ProcessBlocksSSSE3(uint32 state[5],
+                            const uint8* data,
+                            size_t num_blocks);
+#endif
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_SHA1_INTERNAL_H_
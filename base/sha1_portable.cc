@@ -6,62 +6,30 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "base/basictypes.h"
+#include "base/cpu.h"
+#include "base/sha1_internal.h"
 
 namespace base {
 
-// Implementation of SHA-1. Only handles data in byte-sized blocks,
-// which simplifies the code a fair bit.
+// Implementation of SHA-1, with the streaming state in SecureHashAlgorithm
+// (declared in sha1.h).  Whole 64-byte blocks are folded straight out of
+// the caller's buffer by a block function chosen at runtime: the portable
+// one below, or the SSSE3 variant in sha1_ssse3.cc on CPUs that support it.
 
 // Identifier names follow notation in FIPS PUB 180-3, where you'll
 // also find a description of the algorithm:
 // http://csrc.nist.gov/publications/fips/fips180-3/fips180-3_final.pdf
 
-// Usage example:
-//
-// SecureHashAlgorithm sha;
-// while(there is data to hash)
-//   sha.Update(moredata, size of data);
-// sha.Final();
-// memcpy(somewhere, sha.Digest(), 20);
-//
-// to reuse the instance of sha, call sha.Init();
-
 // TODO(jhawkins): Replace this implementation with a per-platform
 // implementation using each platform's crypto library.  See
 // http://crbug.com/47218
 
-class SecureHashAlgorithm {
- public:
-  SecureHashAlgorithm() { Init(); }
-
-  static const int kDigestSizeBytes;
-
-  void Init();
-  void Update(const void* data, size_t nbytes);
-  void Final();
-
-  // 20 bytes of message digest.
-  const unsigned char* Digest() const {
-    return reinterpret_cast<const unsigned char*>(H);
-  }
-
- private:
-  void Pad();
-  void Process();
-
-  uint32 A, B, C, D, E;
-
-  uint32 H[5];
-
-  union {
-    uint32 W[80];
-    uint8 M[64];
-  };
-
-  uint32 cursor;
-  uint32 l;
-};
+typedef void (*ProcessBlocksFn)(uint32 state[5],
+                                const uint8* data,
+                                size_t num_blocks);
 
 static inline uint32 f(uint32 t, uint32 B, uint32 C, uint32 D) {
   if (t < 20) {
@@ -91,6 +59,77 @@ static inline uint32 K(uint32 t) {
   }
 }
 
+namespace internal {
+
+void SHA1ProcessBlocksPortable(uint32 state[5],
+                               const uint8* data,
+                               size_t num_blocks) {
+  uint32 W[80];
+
+  for (size_t block = 0; block < num_blocks; ++block, data += 64) {
+    uint32 t;
+
+    // Each a...e corresponds to a section in the FIPS 180-3 algorithm.
+
+    // a.
+    //
+    // Assembled byte-wise, so |data| need not be aligned and no in-place
+    // endian swapping of the caller's buffer is needed.
+    for (t = 0; t < 16; ++t) {
+      W[t] = (static_cast<uint32>(data[t * 4]) << 24) |
+             (static_cast<uint32>(data[t * 4 + 1]) << 16) |
+             (static_cast<uint32>(data[t * 4 + 2]) << 8) |
+             (static_cast<uint32>(data[t * 4 + 3]));
+    }
+
+    // b.
+    for (t = 16; t < 80; ++t)
+      W[t] = S(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
+
+    // c.
+    uint32 A = state[0];
+    uint32 B = state[1];
+    uint32 C = state[2];
+    uint32 D = state[3];
+    uint32 E = state[4];
+
+    // d.
+    for (t = 0; t < 80; ++t) {
+      uint32 TEMP = S(5, A) + f(t, B, C, D) + E + W[t] + K(t);
+      E = D;
+      D = C;
+      C = S(30, B);
+      B = A;
+      A = TEMP;
+    }
+
+    // e.
+    state[0] += A;
+    state[1] += B;
+    state[2] += C;
+    state[3] += D;
+    state[4] += E;
+  }
+}
+
+}  // namespace internal
+
+// Returns the fastest block function this CPU supports.  The benign race on
+// first use is harmless: every thread computes the same answer.
+static ProcessBlocksFn GetProcessBlocksFn() {
+  static ProcessBlocksFn process_blocks_fn = NULL;
+  if (!process_blocks_fn) {
+#if defined(ARCH_CPU_X86_FAMILY)
+    if (CPU().has_ssse3()) {
+      process_blocks_fn = &internal::SHA1ProcessBlocksSSSE3;
+      return process_blocks_fn;
+    }
+#endif
+    process_blocks_fn = &internal::SHA1ProcessBlocksPortable;
+  }
+  return process_blocks_fn;
+}
+
 static inline void swapends(uint32* t) {
   *t = ((*t & 0xff000000) >> 24) |
        ((*t & 0xff0000) >> 8) |
@@ -101,11 +140,6 @@ static inline void swapends(uint32* t) {
 const int SecureHashAlgorithm::kDigestSizeBytes = 20;
 
 void SecureHashAlgorithm::Init() {
-  A = 0;
-  B = 0;
-  C = 0;
-  D = 0;
-  E = 0;
   cursor = 0;
   l = 0;
   H[0] = 0x67452301;
@@ -125,11 +159,31 @@ void SecureHashAlgorithm::Final() {
 
 void SecureHashAlgorithm::Update(const void* data, size_t nbytes) {
   const uint8* d = reinterpret_cast<const uint8*>(data);
-  while (nbytes--) {
-    M[cursor++] = *d++;
-    if (cursor >= 64)
+  l += static_cast<uint32>(nbytes) * 8;
+
+  // Top up a partially filled block left over from an earlier Update.
+  if (cursor > 0) {
+    size_t take = std::min<size_t>(64 - cursor, nbytes);
+    memcpy(M + cursor, d, take);
+    cursor += take;
+    d += take;
+    nbytes -= take;
+    if (cursor == 64)
       Process();
-    l += 8;
+  }
+
+  // Hash whole blocks straight out of the caller's buffer.
+  if (nbytes >= 64) {
+    size_t num_blocks = nbytes / 64;
+    GetProcessBlocksFn()(H, d, num_blocks);
+    d += num_blocks * 64;
+    nbytes -= num_blocks * 64;
+  }
+
+  // Buffer whatever is left for the next Update or Final.
+  if (nbytes > 0) {
+    memcpy(M, d, nbytes);
+    cursor = nbytes;
   }
 }
 
@@ -154,45 +208,7 @@ void SecureHashAlgorithm::Pad() {
 }
 
 void SecureHashAlgorithm::Process() {
-  uint32 t;
-
-  // Each a...e corresponds to a section in the FIPS 180-3 algorithm.
-
-  // a.
-  //
-  // W and M are in a union, so no need to memcpy.
-  // memcpy(W, M, sizeof(M));
-  for (t = 0; t < 16; ++t)
-    swapends(&W[t]);
-
-  // b.
-  for (t = 16; t < 80; ++t)
-    W[t] = S(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
-
-  // c.
-  A = H[0];
-  B = H[1];
-  C = H[2];
-  D = H[3];
-  E = H[4];
-
-  // d.
-  for (t = 0; t < 80; ++t) {
-    uint32 TEMP = S(5, A) + f(t, B, C, D) + E + W[t] + K(t);
-    E = D;
-    D = C;
-    C = S(30, B);
-    B = A;
-    A = TEMP;
-  }
-
-  // e.
-  H[0] += A;
-  H[1] += B;
-  H[2] += C;
-  H[3] += D;
-  H[4] += E;
-
+  GetProcessBlocksFn()(H, M, 1);
   cursor = 0;
 }
 
@@ -0,0 +1,136 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// SSSE3 SHA-1 block function.  This file is compiled with SSSE3 code
+// generation enabled (see the base_sha1_ssse3 target); it must only contain
+// code that is guarded by the runtime CPU check in sha1_portable.cc.
+
+#include "base/sha1_internal.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+#include <tmmintrin.h>
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Rotates each 32-bit lane of |x| left by one bit.
+inline __m128i RotateLeftOne(__m128i x) {
+  return _mm_or_si128(_mm_slli_epi32(x, 1), _mm_srli_epi32(x, 31));
+}
+
+inline uint32 RotateLeft(uint32 n, uint32 x) {
+  return (x << n) | (x >> (32 - n));
+}
+
+}  // namespace
+
+void SHA1ProcessBlocksSSSE3(uint32 state[5],
+                            const uint8* data,
+                            size_t num_blocks) {
+  // pshufb control that byte-swaps each 32-bit lane, turning the big-endian
+  // message words into host order.
+  const __m128i kByteSwap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11,
+                                         4, 5, 6, 7, 0, 1, 2, 3);
+  const __m128i kK0 = _mm_set1_epi32(0x5a827999);
+  const __m128i kK1 = _mm_set1_epi32(0x6ed9eba1);
+  const __m128i kK2 = _mm_set1_epi32(0x8f1bbcdc);
+  const __m128i kK3 = _mm_set1_epi32(0xca62c1d6);
+
+  // W[t] + K(t) for the whole block, four words per element.
+  __m128i WK[20];
+
+  for (size_t block = 0; block < num_blocks; ++block, data += 64) {
+    const __m128i* input = reinterpret_cast<const __m128i*>(data);
+
+    // The first sixteen words are the message itself.
+    __m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128(input), kByteSwap);
+    __m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128(input + 1), kByteSwap);
+    __m128i w2 = _mm_shuffle_epi8(_mm_loadu_si128(input + 2), kByteSwap);
+    __m128i w3 = _mm_shuffle_epi8(_mm_loadu_si128(input + 3), kByteSwap);
+    WK[0] = _mm_add_epi32(w0, kK0);
+    WK[1] = _mm_add_epi32(w1, kK0);
+    WK[2] = _mm_add_epi32(w2, kK0);
+    WK[3] = _mm_add_epi32(w3, kK0);
+
+    // Expand the message schedule four words at a time:
+    //   W[t] = rol1(W[t-3] ^ W[t-8] ^ W[t-14] ^ W[t-16])
+    // The first three lanes have all their inputs available; the last lane
+    // needs W[t], which is produced in lane 0 of the same step, so its
+    // rol1(W[t]) contribution is patched in afterwards.
+    for (uint32 t = 16; t < 80; t += 4) {
+      __m128i x = _mm_xor_si128(
+          _mm_xor_si128(w0, _mm_alignr_epi8(w1, w0, 8)),  // W[t-16], W[t-14]
+          _mm_xor_si128(w2, _mm_srli_si128(w3, 4)));      // W[t-8], W[t-3]
+      __m128i r = RotateLeftOne(x);
+      __m128i fixup = RotateLeftOne(_mm_slli_si128(r, 12));  // rol1(W[t])
+      r = _mm_xor_si128(r, fixup);
+
+      const __m128i k = t < 20 ? kK0 : t < 40 ? kK1 : t < 60 ? kK2 : kK3;
+      WK[t / 4] = _mm_add_epi32(r, k);
+
+      w0 = w1;
+      w1 = w2;
+      w2 = w3;
+      w3 = r;
+    }
+
+    const uint32* wk = reinterpret_cast<const uint32*>(WK);
+
+    uint32 A = state[0];
+    uint32 B = state[1];
+    uint32 C = state[2];
+    uint32 D = state[3];
+    uint32 E = state[4];
+
+    uint32 t = 0;
+    for (; t < 20; ++t) {
+      uint32 TEMP =
+          RotateLeft(5, A) + ((B & C) | ((~B) & D)) + E + wk[t];
+      E = D;
+      D = C;
+      C = RotateLeft(30, B);
+      B = A;
+      A = TEMP;
+    }
+    for (; t < 40; ++t) {
+      uint32 TEMP = RotateLeft(5, A) + (B ^ C ^ D) + E + wk[t];
+      E = D;
+      D = C;
+      C = RotateLeft(30, B);
+      B = A;
+      A = TEMP;
+    }
+    for (; t < 60; ++t) {
+      uint32 TEMP =
+          RotateLeft(5, A) + ((B & C) | (B & D) | (C & D)) + E + wk[t];
+      E = D;
+      D = C;
+      C = RotateLeft(30, B);
+      B = A;
+      A = TEMP;
+    }
+    for (; t < 80; ++t) {
+      uint32 TEMP = RotateLeft(5, A) + (B ^ C ^ D) + E + wk[t];
+      E = D;
+      D = C;
+      C = RotateLeft(30, B);
+      B = A;
+      A = TEMP;
+    }
+
+    state[0] += A;
+    state[1] += B;
+    state[2] += C;
+    state[3] += D;
+    state[4] += E;
+  }
+}
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // defined(ARCH_CPU_X86_FAMILY)
@@ -4,6 +4,7 @@
 
 #include "base/sha1.h"
 
+#include <algorithm>
 #include <string>
 
 #include "base/basictypes.h"
@@ -90,6 +91,30 @@ TEST(SHA1Test, Test2Bytes) {
     EXPECT_EQ(expected[i], output[i]);
 }
 
+TEST(SHA1Test, StreamingMatchesOneShot) {
+  // Feeding the data in assorted chunk sizes (forcing both the buffered
+  // partial-block path and the direct whole-block path, at every block
+  // offset) must give the same digest as hashing it in one call.
+  std::string input;
+  for (size_t i = 0; i < 4096; ++i)
+    input.push_back(static_cast<char>(i * 37 + (i >> 5)));
+  std::string expected = base::SHA1HashString(input);
+
+  static const size_t kChunkSizes[] = { 1, 7, 63, 64, 65, 256, 1000 };
+  for (size_t c = 0; c < arraysize(kChunkSizes); ++c) {
+    base::SecureHashAlgorithm sha;
+    for (size_t pos = 0; pos < input.size(); pos += kChunkSizes[c]) {
+      size_t len = std::min(kChunkSizes[c], input.size() - pos);
+      sha.Update(input.data() + pos, len);
+    }
+    sha.Final();
+    EXPECT_EQ(expected,
+              std::string(reinterpret_cast<const char*>(sha.Digest()),
+                          base::kSHA1Length))
+        << "chunk size " << kChunkSizes[c];
+  }
+}
+
 TEST(SHA1Test, Test3Bytes) {
   // Example A.3 from FIPS 180-2: long message.
   std::string input(1000000, 'a');
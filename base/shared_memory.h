@@ -46,7 +46,7 @@ typedef ino_t SharedMemoryId;
 // Options for creating a shared memory object.
 struct SharedMemoryCreateOptions {
   SharedMemoryCreateOptions() : name(NULL), size(0), open_existing(false),
-                                executable(false) {}
+                                executable(false), huge_pages(false) {}
 
   // If NULL, the object is anonymous.  This pointer is owned by the caller
   // and must live through the call to Create().
@@ -64,6 +64,13 @@ struct SharedMemoryCreateOptions {
 
   // If true, mappings might need to be made executable later.
   bool executable;
+
+  // If true, ask the kernel to back mappings of this segment with
+  // transparent huge pages.  This is a best-effort hint, honored on Linux
+  // when the kernel supports it; fewer TLB misses make it worthwhile for
+  // segments that are tens of megabytes (e.g. compositor and resource
+  // transfer buffers).  Ignored on other platforms.
+  bool huge_pages;
 };
 
 // Platform abstraction for shared memory.  Provides a C++ wrapper
@@ -151,6 +158,18 @@ class BASE_EXPORT SharedMemory {
   // memory is not mapped.
   bool Unmap();
 
+#if defined(OS_POSIX)
+  // Releases the physical pages backing the byte range [offset,
+  // offset + length) of the mapping back to the OS with
+  // madvise(MADV_DONTNEED), while keeping the range mapped.  Use this to
+  // cheaply shrink a large segment under memory pressure; touching the
+  // range afterwards faults the pages back in from the backing file.
+  // Only the pages lying entirely inside the range are released, since
+  // madvise() works on whole pages.  Returns false if the memory is not
+  // mapped, the range is out of bounds, or the advice fails.
+  bool DiscardRange(uint32 offset, uint32 length);
+#endif
+
   // Get the size of the shared memory backing file.
   // Note:  This size is only available to the creator of the
   // shared memory, and not to those that opened shared memory
@@ -240,6 +259,7 @@ class BASE_EXPORT SharedMemory {
   int                mapped_file_;
   uint32             mapped_size_;
   ino_t              inode_;
+  bool               huge_pages_;
 #endif
   void*              memory_;
   bool               read_only_;
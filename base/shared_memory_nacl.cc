@@ -18,6 +18,7 @@ SharedMemory::SharedMemory()
     : mapped_file_(-1),
       mapped_size_(0),
       inode_(0),
+      huge_pages_(false),
       memory_(NULL),
       read_only_(false),
       created_size_(0) {
@@ -28,6 +29,7 @@ SharedMemory::SharedMemory(SharedMemoryHandle handle, bool read_only)
     : mapped_file_(handle.fd),
       mapped_size_(0),
       inode_(0),
+      huge_pages_(false),
       memory_(NULL),
       read_only_(read_only),
       created_size_(0) {
@@ -39,6 +41,7 @@ SharedMemory::SharedMemory(SharedMemoryHandle handle, bool read_only,
     : mapped_file_(handle.fd),
       mapped_size_(0),
       inode_(0),
+      huge_pages_(false),
       memory_(NULL),
       read_only_(read_only),
       created_size_(0) {
@@ -90,6 +93,10 @@ bool SharedMemory::Unmap() {
   return false;
 }
 
+bool SharedMemory::DiscardRange(uint32 offset, uint32 length) {
+  return false;
+}
+
 SharedMemoryHandle SharedMemory::handle() const {
   return FileDescriptor(mapped_file_, false);
 }
@@ -44,6 +44,7 @@ SharedMemory::SharedMemory()
     : mapped_file_(-1),
       mapped_size_(0),
       inode_(0),
+      huge_pages_(false),
       memory_(NULL),
       read_only_(false),
       created_size_(0) {
@@ -53,6 +54,7 @@ SharedMemory::SharedMemory(SharedMemoryHandle handle, bool read_only)
     : mapped_file_(handle.fd),
       mapped_size_(0),
       inode_(0),
+      huge_pages_(false),
       memory_(NULL),
       read_only_(read_only),
       created_size_(0) {
@@ -69,6 +71,7 @@ SharedMemory::SharedMemory(SharedMemoryHandle handle, bool read_only,
     : mapped_file_(handle.fd),
       mapped_size_(0),
       inode_(0),
+      huge_pages_(false),
       memory_(NULL),
       read_only_(read_only),
       created_size_(0) {
@@ -113,6 +116,8 @@ bool SharedMemory::Create(const SharedMemoryCreateOptions& options) {
   DCHECK_EQ(-1, mapped_file_);
   if (options.size == 0) return false;
 
+  huge_pages_ = options.huge_pages;
+
   // This function theoretically can block on the disk, but realistically
   // the temporary files we create will just go into the buffer cache
   // and be deleted before they ever make it out to disk.
@@ -240,10 +245,17 @@ bool SharedMemory::Map(uint32 bytes) {
                  MAP_SHARED, mapped_file_, 0);
 
   bool mmap_succeeded = memory_ != (void*)-1 && memory_ != NULL;
-  if (mmap_succeeded)
+  if (mmap_succeeded) {
     mapped_size_ = bytes;
-  else
+#if defined(OS_LINUX) && defined(MADV_HUGEPAGE)
+    // Best effort: the kernel is free to ignore the hint, and file-backed
+    // mappings only gained transparent huge page support on some systems.
+    if (huge_pages_ && madvise(memory_, mapped_size_, MADV_HUGEPAGE) < 0)
+      DPLOG(WARNING) << "madvise(MADV_HUGEPAGE)";
+#endif
+  } else {
     memory_ = NULL;
+  }
 
   return mmap_succeeded;
 }
@@ -258,6 +270,30 @@ bool SharedMemory::Unmap() {
   return true;
 }
 
+bool SharedMemory::DiscardRange(uint32 offset, uint32 length) {
+  if (memory_ == NULL)
+    return false;
+  if (offset > mapped_size_ || length > mapped_size_ - offset)
+    return false;
+
+  // madvise() operates on whole pages, so shrink the range to the pages
+  // lying entirely inside it.
+  const uintptr_t page_mask = getpagesize() - 1;
+  uintptr_t begin = reinterpret_cast<uintptr_t>(memory_) + offset;
+  uintptr_t end = begin + length;
+  begin = (begin + page_mask) & ~page_mask;
+  end &= ~page_mask;
+  if (begin >= end)
+    return true;  // The range contains no whole page; nothing to release.
+
+  if (madvise(reinterpret_cast<void*>(begin), end - begin,
+              MADV_DONTNEED) < 0) {
+    DPLOG(ERROR) << "madvise(MADV_DONTNEED)";
+    return false;
+  }
+  return true;
+}
+
 SharedMemoryHandle SharedMemory::handle() const {
   return FileDescriptor(mapped_file_, false);
 }
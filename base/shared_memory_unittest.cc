@@ -19,6 +19,7 @@
 #endif
 
 #if defined(OS_POSIX)
+#include <string.h>
 #include <sys/mman.h>
 #endif
 
@@ -355,6 +356,41 @@ TEST(SharedMemoryTest, AnonymousExecutable) {
   EXPECT_EQ(0, mprotect(shared_memory.memory(), shared_memory.created_size(),
                         PROT_READ | PROT_EXEC));
 }
+
+// Create a large segment with the huge page hint, then release a slice of
+// it with DiscardRange.
+TEST(SharedMemoryTest, HugePagesAndDiscardRange) {
+  const uint32 kTestSize = 1 << 22;  // 4MB, enough for one 2MB huge page.
+
+  SharedMemory shared_memory;
+  SharedMemoryCreateOptions options;
+  options.size = kTestSize;
+  options.huge_pages = true;
+
+  // The huge page request is a best-effort hint; creation and mapping must
+  // succeed whether or not the kernel honors it.
+  EXPECT_TRUE(shared_memory.Create(options));
+  EXPECT_TRUE(shared_memory.Map(kTestSize));
+
+  char* ptr = static_cast<char*>(shared_memory.memory());
+  ASSERT_TRUE(ptr);
+  memset(ptr, 'G', kTestSize);
+
+  // Release the middle half of the segment.  The pages outside the range
+  // must be untouched.
+  EXPECT_TRUE(shared_memory.DiscardRange(kTestSize / 4, kTestSize / 2));
+  EXPECT_EQ('G', ptr[0]);
+  EXPECT_EQ('G', ptr[kTestSize - 1]);
+
+  // A sub-page range contains no whole page; this is a no-op, not an error.
+  EXPECT_TRUE(shared_memory.DiscardRange(1, 7));
+
+  // Out-of-bounds ranges and unmapped segments fail.
+  EXPECT_FALSE(shared_memory.DiscardRange(kTestSize, 1));
+  EXPECT_FALSE(shared_memory.DiscardRange(0, kTestSize + 1));
+  EXPECT_TRUE(shared_memory.Unmap());
+  EXPECT_FALSE(shared_memory.DiscardRange(0, kTestSize));
+}
 #endif
 
 // On POSIX it is especially important we test shmem across processes,
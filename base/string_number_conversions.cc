@@ -6,7 +6,9 @@
 
 #include <ctype.h>
 #include <errno.h>
+#include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wctype.h>
 
 #include <limits>
@@ -19,6 +21,20 @@ namespace base {
 
 namespace {
 
+// Look-up table of the decimal representations of 0..99, so that integer
+// formatting can emit two digits per division instead of one.
+const char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
 template <typename STR, typename INT, typename UINT, bool NEG>
 struct IntToStringT {
   // This is to avoid a compiler warning about unary minus on unsigned type.
@@ -41,7 +57,10 @@ struct IntToStringT {
   template <typename INT2, typename UINT2>
   struct ToUnsignedT<INT2, UINT2, true> {
     static UINT2 ToUnsigned(INT2 value) {
-      return static_cast<UINT2>(value < 0 ? -value : value);
+      // Negate in the unsigned domain: -value would overflow (undefined
+      // behavior) for the minimum value of INT2.
+      return value < 0 ? static_cast<UINT2>(0) - static_cast<UINT2>(value)
+                       : static_cast<UINT2>(value);
     }
   };
 
@@ -63,41 +82,529 @@ struct IntToStringT {
     }
   };
 
-  static STR IntToString(INT value) {
-    // log10(2) ~= 0.3 bytes needed per bit or per byte log10(2**8) ~= 2.4.
-    // So round up to allocate 3 output characters per byte, plus 1 for '-'.
-    const int kOutputBufSize = 3 * sizeof(INT) + 1;
+  // log10(2) ~= 0.3 bytes needed per bit or per byte log10(2**8) ~= 2.4.
+  // So round up to allocate 3 output characters per byte, plus 1 for '-'.
+  static const int kOutputBufSize = 3 * sizeof(INT) + 1;
 
-    // Allocate the whole string right away, we will right back to front, and
-    // then return the substr of what we ended up using.
-    STR outbuf(kOutputBufSize, 0);
+  typedef typename STR::value_type value_type;
 
+  // Writes the decimal representation of |value| into the characters just
+  // before |end|, back to front, and returns a pointer to the first
+  // character written.  |end| must be preceded by at least kOutputBufSize
+  // characters of room.  Digits are emitted two at a time from the
+  // kDigitPairs table, halving the number of divisions.
+  static value_type* Write(INT value, value_type* end) {
     bool is_neg = TestNegT<INT, NEG>::TestNeg(value);
     // Even though is_neg will never be true when INT is parameterized as
     // unsigned, even the presence of the unary operation causes a warning.
     UINT res = ToUnsignedT<INT, UINT, NEG>::ToUnsigned(value);
 
-    for (typename STR::iterator it = outbuf.end();;) {
-      --it;
-      DCHECK(it != outbuf.begin());
-      *it = static_cast<typename STR::value_type>((res % 10) + '0');
-      res /= 10;
-
-      // We're done..
-      if (res == 0) {
-        if (is_neg) {
-          --it;
-          DCHECK(it != outbuf.begin());
-          *it = static_cast<typename STR::value_type>('-');
-        }
-        return STR(it, outbuf.end());
-      }
+    value_type* it = end;
+    while (res >= 100) {
+      UINT next = res / 100;
+      const char* pair = &kDigitPairs[static_cast<unsigned>(res - next * 100) * 2];
+      *--it = static_cast<value_type>(pair[1]);
+      *--it = static_cast<value_type>(pair[0]);
+      res = next;
+    }
+    if (res >= 10) {
+      const char* pair = &kDigitPairs[static_cast<unsigned>(res) * 2];
+      *--it = static_cast<value_type>(pair[1]);
+      *--it = static_cast<value_type>(pair[0]);
+    } else {
+      *--it = static_cast<value_type>('0' + res);
     }
-    NOTREACHED();
-    return STR();
+    if (is_neg)
+      *--it = static_cast<value_type>('-');
+    return it;
+  }
+
+  static STR IntToString(INT value) {
+    value_type outbuf[kOutputBufSize];
+    value_type* end = outbuf + kOutputBufSize;
+    return STR(Write(value, end), end);
+  }
+};
+
+// Appends the decimal representation of |value| to |*output| without
+// constructing a temporary string.
+template <typename INT, typename UINT, bool NEG>
+void IntAppendT(INT value, std::string* output) {
+  typedef IntToStringT<std::string, INT, UINT, NEG> Formatter;
+  char outbuf[Formatter::kOutputBufSize];
+  char* end = outbuf + Formatter::kOutputBufSize;
+  char* begin = Formatter::Write(value, end);
+  output->append(begin, end);
+}
+
+// The code below formats a double exactly as dmg_fp::g_fmt does, but uses
+// the Grisu3 algorithm (Florian Loitsch, "Printing Floating-Point Numbers
+// Quickly and Accurately with Integers", PLDI 2010) to produce the
+// shortest digit string with plain integer arithmetic.  Grisu3 detects the rare inputs (under 1%) for which it
+// cannot prove its result is the shortest correctly-rounded representation
+// and reports failure; for those we fall back to dmg_fp, so the output is
+// always byte-identical to what g_fmt produces.
+
+// A "do-it-yourself" floating point number: significand_ * 2^exponent_,
+// with all precision carried in the uint64 significand.
+class DiyFp {
+ public:
+  DiyFp() : f_(0), e_(0) {}
+  DiyFp(uint64 f, int e) : f_(f), e_(e) {}
+
+  uint64 f() const { return f_; }
+  int e() const { return e_; }
+  void set_f(uint64 f) { f_ = f; }
+  void set_e(int e) { e_ = e; }
+
+  static const int kSignificandSize = 64;
+
+  // Returns a - b.  The exponents must match and a.f() >= b.f().
+  static DiyFp Minus(const DiyFp& a, const DiyFp& b) {
+    return DiyFp(a.f_ - b.f_, a.e_);
+  }
+
+  // Returns a * b, rounded; the result loses at most half a unit in the
+  // last place.
+  static DiyFp Times(const DiyFp& a, const DiyFp& b) {
+    const uint64 kM32 = GG_UINT64_C(0xffffffff);
+    uint64 x = a.f_ >> 32;
+    uint64 y = a.f_ & kM32;
+    uint64 z = b.f_ >> 32;
+    uint64 w = b.f_ & kM32;
+    uint64 xz = x * z;
+    uint64 yz = y * z;
+    uint64 xw = x * w;
+    uint64 yw = y * w;
+    uint64 mid = (yw >> 32) + (xw & kM32) + (yz & kM32);
+    mid += GG_UINT64_C(1) << 31;  // Round the lower bits.
+    return DiyFp(xz + (xw >> 32) + (yz >> 32) + (mid >> 32),
+                 a.e_ + b.e_ + 64);
   }
+
+ private:
+  uint64 f_;
+  int e_;
+};
+
+// IEEE 754 double-precision constants.
+const uint64 kDoubleSignMask = GG_UINT64_C(0x8000000000000000);
+const uint64 kDoubleExponentMask = GG_UINT64_C(0x7ff0000000000000);
+const uint64 kDoubleSignificandMask = GG_UINT64_C(0x000fffffffffffff);
+const uint64 kDoubleHiddenBit = GG_UINT64_C(0x0010000000000000);
+const int kDoublePhysicalSignificandSize = 52;
+const int kDoubleExponentBias = 0x3ff + kDoublePhysicalSignificandSize;
+const int kDoubleDenormalExponent = -kDoubleExponentBias + 1;
+
+// Decomposes a finite, non-zero |bits| into its significand and exponent,
+// un-biasing the exponent and restoring the hidden bit for normals.
+DiyFp DoubleAsDiyFp(uint64 bits) {
+  uint64 significand = bits & kDoubleSignificandMask;
+  if ((bits & kDoubleExponentMask) != 0) {  // Normal.
+    int biased = static_cast<int>((bits & kDoubleExponentMask) >>
+                                  kDoublePhysicalSignificandSize);
+    return DiyFp(significand + kDoubleHiddenBit,
+                 biased - kDoubleExponentBias);
+  }
+  return DiyFp(significand, kDoubleDenormalExponent);  // Denormal.
+}
+
+// Computes the two boundaries of the double given by |bits|: every value
+// strictly between them rounds to it.  Both are normalized to the same
+// exponent, with |m_plus| having its top bit set.
+void DoubleNormalizedBoundaries(uint64 bits, DiyFp* m_minus, DiyFp* m_plus) {
+  DiyFp v = DoubleAsDiyFp(bits);
+  DiyFp plus((v.f() << 1) + 1, v.e() - 1);
+  while ((plus.f() & (GG_UINT64_C(1) << 63)) == 0) {
+    plus.set_f(plus.f() << 1);
+    plus.set_e(plus.e() - 1);
+  }
+  DiyFp minus;
+  if (v.f() == kDoubleHiddenBit && (bits & kDoubleExponentMask) != 0) {
+    // The lower boundary is closer for powers of two (except the smallest
+    // normal, whose neighbor gap does not shrink).
+    minus = DiyFp((v.f() << 2) - 1, v.e() - 2);
+  } else {
+    minus = DiyFp((v.f() << 1) - 1, v.e() - 1);
+  }
+  minus.set_f(minus.f() << (minus.e() - plus.e()));
+  minus.set_e(plus.e());
+  *m_plus = plus;
+  *m_minus = minus;
+}
+
+// A cached, normalized power of ten: significand * 2^binary_exponent is
+// the best 64-bit approximation of 10^decimal_exponent.
+struct CachedPower {
+  uint64 significand;
+  int16 binary_exponent;
+  int16 decimal_exponent;
+};
+
+// Every eighth power of ten from 10^-348 to 10^340.
+const CachedPower kCachedPowers[] = {
+    {GG_UINT64_C(0xfa8fd5a0081c0288), -1220, -348},
+    {GG_UINT64_C(0xbaaee17fa23ebf76), -1193, -340},
+    {GG_UINT64_C(0x8b16fb203055ac76), -1166, -332},
+    {GG_UINT64_C(0xcf42894a5dce35ea), -1140, -324},
+    {GG_UINT64_C(0x9a6bb0aa55653b2d), -1113, -316},
+    {GG_UINT64_C(0xe61acf033d1a45df), -1087, -308},
+    {GG_UINT64_C(0xab70fe17c79ac6ca), -1060, -300},
+    {GG_UINT64_C(0xff77b1fcbebcdc4f), -1034, -292},
+    {GG_UINT64_C(0xbe5691ef416bd60c), -1007, -284},
+    {GG_UINT64_C(0x8dd01fad907ffc3c), -980, -276},
+    {GG_UINT64_C(0xd3515c2831559a83), -954, -268},
+    {GG_UINT64_C(0x9d71ac8fada6c9b5), -927, -260},
+    {GG_UINT64_C(0xea9c227723ee8bcb), -901, -252},
+    {GG_UINT64_C(0xaecc49914078536d), -874, -244},
+    {GG_UINT64_C(0x823c12795db6ce57), -847, -236},
+    {GG_UINT64_C(0xc21094364dfb5637), -821, -228},
+    {GG_UINT64_C(0x9096ea6f3848984f), -794, -220},
+    {GG_UINT64_C(0xd77485cb25823ac7), -768, -212},
+    {GG_UINT64_C(0xa086cfcd97bf97f4), -741, -204},
+    {GG_UINT64_C(0xef340a98172aace5), -715, -196},
+    {GG_UINT64_C(0xb23867fb2a35b28e), -688, -188},
+    {GG_UINT64_C(0x84c8d4dfd2c63f3b), -661, -180},
+    {GG_UINT64_C(0xc5dd44271ad3cdba), -635, -172},
+    {GG_UINT64_C(0x936b9fcebb25c996), -608, -164},
+    {GG_UINT64_C(0xdbac6c247d62a584), -582, -156},
+    {GG_UINT64_C(0xa3ab66580d5fdaf6), -555, -148},
+    {GG_UINT64_C(0xf3e2f893dec3f126), -529, -140},
+    {GG_UINT64_C(0xb5b5ada8aaff80b8), -502, -132},
+    {GG_UINT64_C(0x87625f056c7c4a8b), -475, -124},
+    {GG_UINT64_C(0xc9bcff6034c13053), -449, -116},
+    {GG_UINT64_C(0x964e858c91ba2655), -422, -108},
+    {GG_UINT64_C(0xdff9772470297ebd), -396, -100},
+    {GG_UINT64_C(0xa6dfbd9fb8e5b88f), -369, -92},
+    {GG_UINT64_C(0xf8a95fcf88747d94), -343, -84},
+    {GG_UINT64_C(0xb94470938fa89bcf), -316, -76},
+    {GG_UINT64_C(0x8a08f0f8bf0f156b), -289, -68},
+    {GG_UINT64_C(0xcdb02555653131b6), -263, -60},
+    {GG_UINT64_C(0x993fe2c6d07b7fac), -236, -52},
+    {GG_UINT64_C(0xe45c10c42a2b3b06), -210, -44},
+    {GG_UINT64_C(0xaa242499697392d3), -183, -36},
+    {GG_UINT64_C(0xfd87b5f28300ca0e), -157, -28},
+    {GG_UINT64_C(0xbce5086492111aeb), -130, -20},
+    {GG_UINT64_C(0x8cbccc096f5088cc), -103, -12},
+    {GG_UINT64_C(0xd1b71758e219652c), -77, -4},
+    {GG_UINT64_C(0x9c40000000000000), -50, 4},
+    {GG_UINT64_C(0xe8d4a51000000000), -24, 12},
+    {GG_UINT64_C(0xad78ebc5ac620000), 3, 20},
+    {GG_UINT64_C(0x813f3978f8940984), 30, 28},
+    {GG_UINT64_C(0xc097ce7bc90715b3), 56, 36},
+    {GG_UINT64_C(0x8f7e32ce7bea5c70), 83, 44},
+    {GG_UINT64_C(0xd5d238a4abe98068), 109, 52},
+    {GG_UINT64_C(0x9f4f2726179a2245), 136, 60},
+    {GG_UINT64_C(0xed63a231d4c4fb27), 162, 68},
+    {GG_UINT64_C(0xb0de65388cc8ada8), 189, 76},
+    {GG_UINT64_C(0x83c7088e1aab65db), 216, 84},
+    {GG_UINT64_C(0xc45d1df942711d9a), 242, 92},
+    {GG_UINT64_C(0x924d692ca61be758), 269, 100},
+    {GG_UINT64_C(0xda01ee641a708dea), 295, 108},
+    {GG_UINT64_C(0xa26da3999aef774a), 322, 116},
+    {GG_UINT64_C(0xf209787bb47d6b85), 348, 124},
+    {GG_UINT64_C(0xb454e4a179dd1877), 375, 132},
+    {GG_UINT64_C(0x865b86925b9bc5c2), 402, 140},
+    {GG_UINT64_C(0xc83553c5c8965d3d), 428, 148},
+    {GG_UINT64_C(0x952ab45cfa97a0b3), 455, 156},
+    {GG_UINT64_C(0xde469fbd99a05fe3), 481, 164},
+    {GG_UINT64_C(0xa59bc234db398c25), 508, 172},
+    {GG_UINT64_C(0xf6c69a72a3989f5c), 534, 180},
+    {GG_UINT64_C(0xb7dcbf5354e9bece), 561, 188},
+    {GG_UINT64_C(0x88fcf317f22241e2), 588, 196},
+    {GG_UINT64_C(0xcc20ce9bd35c78a5), 614, 204},
+    {GG_UINT64_C(0x98165af37b2153df), 641, 212},
+    {GG_UINT64_C(0xe2a0b5dc971f303a), 667, 220},
+    {GG_UINT64_C(0xa8d9d1535ce3b396), 694, 228},
+    {GG_UINT64_C(0xfb9b7cd9a4a7443c), 720, 236},
+    {GG_UINT64_C(0xbb764c4ca7a44410), 747, 244},
+    {GG_UINT64_C(0x8bab8eefb6409c1a), 774, 252},
+    {GG_UINT64_C(0xd01fef10a657842c), 800, 260},
+    {GG_UINT64_C(0x9b10a4e5e9913129), 827, 268},
+    {GG_UINT64_C(0xe7109bfba19c0c9d), 853, 276},
+    {GG_UINT64_C(0xac2820d9623bf429), 880, 284},
+    {GG_UINT64_C(0x80444b5e7aa7cf85), 907, 292},
+    {GG_UINT64_C(0xbf21e44003acdd2d), 933, 300},
+    {GG_UINT64_C(0x8e679c2f5e44ff8f), 960, 308},
+    {GG_UINT64_C(0xd433179d9c8cb841), 986, 316},
+    {GG_UINT64_C(0x9e19db92b4e31ba9), 1013, 324},
+    {GG_UINT64_C(0xeb96bf6ebadf77d9), 1039, 332},
+    {GG_UINT64_C(0xaf87023b9bf0ee6b), 1066, 340},
 };
 
+const int kCachedPowersOffset = 348;
+const int kDecimalExponentDistance = 8;
+// 1 / log2(10).
+const double kD1Log210 = 0.30102999566398114;
+
+// Returns a cached power of ten whose binary exponent lies in
+// [min_exponent, max_exponent], and its decimal exponent.
+void GetCachedPowerForBinaryExponentRange(int min_exponent,
+                                          int max_exponent,
+                                          DiyFp* power,
+                                          int* decimal_exponent) {
+  int kQ = DiyFp::kSignificandSize;
+  double k = ceil((min_exponent + kQ - 1) * kD1Log210);
+  int index =
+      (kCachedPowersOffset + static_cast<int>(k) - 1) /
+          kDecimalExponentDistance + 1;
+  const CachedPower& cached_power = kCachedPowers[index];
+  DCHECK_LE(min_exponent, cached_power.binary_exponent);
+  DCHECK_LE(cached_power.binary_exponent, max_exponent);
+  *decimal_exponent = cached_power.decimal_exponent;
+  *power = DiyFp(cached_power.significand, cached_power.binary_exponent);
+}
+
+// Grisu3 wants the scaled value's exponent in [kMinimalTargetExponent,
+// kMaximalTargetExponent]; with these bounds the integral part of the
+// scaled value fits a uint32 and the fractional weeding stays exact.
+const int kMinimalTargetExponent = -60;
+const int kMaximalTargetExponent = -32;
+
+// The shortest representation of a double never needs more digits.
+const int kFastDtoaMaximalLength = 17;
+
+// Returns the biggest power of ten <= |number|, where |number| has
+// |number_bits| significant bits.  |exponent_plus_one| is the power plus
+// one (i.e. the number of decimal digits of |number|).
+void BiggestPowerTen(uint32 number,
+                     int number_bits,
+                     uint32* power,
+                     int* exponent_plus_one) {
+  static const uint32 kSmallPowersOfTen[] = {
+      0, 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+      1000000000};
+  // 1233/4096 is log10(2) scaled by 2^12.
+  int exponent_plus_one_guess = ((number_bits + 1) * 1233 >> 12) + 1;
+  // The guess can be off by one, and never more.
+  if (number < kSmallPowersOfTen[exponent_plus_one_guess])
+    exponent_plus_one_guess--;
+  *power = kSmallPowersOfTen[exponent_plus_one_guess];
+  *exponent_plus_one = exponent_plus_one_guess;
+}
+
+// Rounds the last generated digit so that the result lies closest to the
+// actual value |w|, and verifies that the digit string uniquely identifies
+// the double within the unsafe interval.  Returns false when that cannot
+// be guaranteed (the caller then falls back to dmg_fp).
+bool RoundWeed(char* buffer,
+               int length,
+               uint64 distance_too_high_w,
+               uint64 unsafe_interval,
+               uint64 rest,
+               uint64 ten_kappa,
+               uint64 unit) {
+  uint64 small_distance = distance_too_high_w - unit;
+  uint64 big_distance = distance_too_high_w + unit;
+  // Move the result toward w as long as doing so stays inside the safe
+  // zone and gets us strictly closer.
+  while (rest < small_distance &&
+         unsafe_interval - rest >= ten_kappa &&
+         (rest + ten_kappa < small_distance ||
+          small_distance - rest >= rest + ten_kappa - small_distance)) {
+    buffer[length - 1]--;
+    rest += ten_kappa;
+  }
+
+  // If an alternative digit would have been at least as close to the
+  // upper boundary's mirror we cannot prove uniqueness.
+  if (rest < big_distance &&
+      unsafe_interval - rest >= ten_kappa &&
+      (rest + ten_kappa < big_distance ||
+       big_distance - rest > rest + ten_kappa - big_distance)) {
+    return false;
+  }
+
+  // The result must be well inside the interval once the accumulated
+  // imprecision (unit) is accounted for.
+  return (2 * unit <= rest) && (rest <= unsafe_interval - 4 * unit);
+}
+
+// Generates the shortest digit string for the scaled value |w|, which lies
+// between the scaled boundaries |low| and |high|.  On success the digits
+// are in |buffer| and the value is buffer * 10^kappa * 2^w.e().
+bool DigitGen(const DiyFp& low,
+              const DiyFp& w,
+              const DiyFp& high,
+              char* buffer,
+              int* length,
+              int* kappa) {
+  DCHECK_EQ(low.e(), w.e());
+  DCHECK_EQ(w.e(), high.e());
+  DCHECK_GE(w.e(), kMinimalTargetExponent);
+  DCHECK_LE(w.e(), kMaximalTargetExponent);
+  // The boundaries themselves are off by at most one unit in the last
+  // place; widen the interval accordingly and track the error in |unit|.
+  uint64 unit = 1;
+  DiyFp too_low(low.f() - unit, low.e());
+  DiyFp too_high(high.f() + unit, high.e());
+  DiyFp unsafe_interval = DiyFp::Minus(too_high, too_low);
+  DiyFp one(GG_UINT64_C(1) << -w.e(), w.e());
+  uint32 integrals = static_cast<uint32>(too_high.f() >> -one.e());
+  uint64 fractionals = too_high.f() & (one.f() - 1);
+  uint32 divisor;
+  int divisor_exponent_plus_one;
+  BiggestPowerTen(integrals, DiyFp::kSignificandSize - (-one.e()),
+                  &divisor, &divisor_exponent_plus_one);
+  *kappa = divisor_exponent_plus_one;
+  *length = 0;
+
+  // Emit the digits of the integral part, stopping as soon as the
+  // remainder falls inside the unsafe interval (the digits so far then
+  // identify the double).
+  while (*kappa > 0) {
+    int digit = integrals / divisor;
+    buffer[(*length)++] = static_cast<char>('0' + digit);
+    integrals %= divisor;
+    (*kappa)--;
+    uint64 rest = (static_cast<uint64>(integrals) << -one.e()) + fractionals;
+    if (rest < unsafe_interval.f()) {
+      return RoundWeed(buffer, *length,
+                       DiyFp::Minus(too_high, w).f(),
+                       unsafe_interval.f(), rest,
+                       static_cast<uint64>(divisor) << -one.e(), unit);
+    }
+    divisor /= 10;
+  }
+
+  // Emit digits of the fractional part; multiplying everything by ten per
+  // step keeps the arithmetic exact (modulo |unit|).
+  for (;;) {
+    fractionals *= 10;
+    unit *= 10;
+    unsafe_interval.set_f(unsafe_interval.f() * 10);
+    int digit = static_cast<int>(fractionals >> -one.e());
+    buffer[(*length)++] = static_cast<char>('0' + digit);
+    fractionals &= one.f() - 1;
+    (*kappa)--;
+    if (fractionals < unsafe_interval.f()) {
+      return RoundWeed(buffer, *length,
+                       DiyFp::Minus(too_high, w).f() * unit,
+                       unsafe_interval.f(), fractionals, one.f(), unit);
+    }
+  }
+}
+
+// Computes the shortest decimal digit string that reads back as the
+// positive, finite, non-zero double |bits|.  On success, the value is
+// 0.|buffer| * 10^|decimal_point| and |buffer| is NUL-terminated.
+// Returns false when uniqueness of the digits cannot be proven.
+bool Grisu3(uint64 bits, char* buffer, int* length, int* decimal_point) {
+  DiyFp w = DoubleAsDiyFp(bits);
+  // Normalize so the significand uses all 64 bits.
+  while ((w.f() & (GG_UINT64_C(1) << 63)) == 0) {
+    w.set_f(w.f() << 1);
+    w.set_e(w.e() - 1);
+  }
+  DiyFp boundary_minus, boundary_plus;
+  DoubleNormalizedBoundaries(bits, &boundary_minus, &boundary_plus);
+  DCHECK_EQ(boundary_plus.e(), w.e());
+
+  DiyFp ten_mk;
+  int mk;
+  GetCachedPowerForBinaryExponentRange(
+      kMinimalTargetExponent - (w.e() + DiyFp::kSignificandSize),
+      kMaximalTargetExponent - (w.e() + DiyFp::kSignificandSize),
+      &ten_mk, &mk);
+
+  DiyFp scaled_w = DiyFp::Times(w, ten_mk);
+  DiyFp scaled_boundary_minus = DiyFp::Times(boundary_minus, ten_mk);
+  DiyFp scaled_boundary_plus = DiyFp::Times(boundary_plus, ten_mk);
+
+  int kappa;
+  if (!DigitGen(scaled_boundary_minus, scaled_w, scaled_boundary_plus,
+                buffer, length, &kappa))
+    return false;
+  *decimal_point = *length + (kappa - mk);
+  // dmg_fp never emits trailing zeros; neither may we.  (Stripping them
+  // does not move the decimal point.)
+  while (*length > 1 && buffer[*length - 1] == '0')
+    (*length)--;
+  buffer[*length] = '\0';
+  return true;
+}
+
+// Formats |value| into |buffer| (which must hold at least 32 characters)
+// with exactly the digit placement rules of dmg_fp::g_fmt.
+void FormatDouble(double value, char* buffer) {
+  uint64 bits = bit_cast<uint64>(value);
+
+  if ((bits & ~kDoubleSignMask) == 0) {
+    char* b = buffer;
+    if (bits & kDoubleSignMask)
+      *b++ = '-';
+    *b++ = '0';
+    *b = '\0';
+    return;
+  }
+
+  char digits[kFastDtoaMaximalLength + 1];
+  int length, decimal_point;
+  if ((bits & kDoubleExponentMask) == kDoubleExponentMask ||
+      !Grisu3(bits & ~kDoubleSignMask, digits, &length, &decimal_point)) {
+    // Infinities, NaNs, and the rare values Grisu3 cannot settle.
+    dmg_fp::g_fmt(buffer, value);
+    return;
+  }
+
+  char* b = buffer;
+  if (bits & kDoubleSignMask)
+    *b++ = '-';
+
+  if (decimal_point <= -4 || decimal_point > length + 5) {
+    // Scientific notation, e.g. "1.2345e+67".
+    *b++ = digits[0];
+    if (length > 1) {
+      *b++ = '.';
+      memcpy(b, digits + 1, length - 1);
+      b += length - 1;
+    }
+    *b++ = 'e';
+    int exponent = decimal_point - 1;
+    if (exponent < 0) {
+      *b++ = '-';
+      exponent = -exponent;
+    } else {
+      *b++ = '+';
+    }
+    // At least two exponent digits, matching g_fmt's "%+.2d".
+    int j = 2, k = 10;
+    while (10 * k <= exponent) {
+      j++;
+      k *= 10;
+    }
+    for (;;) {
+      int i = exponent / k;
+      *b++ = static_cast<char>('0' + i);
+      if (--j <= 0)
+        break;
+      exponent -= i * k;
+      exponent *= 10;
+    }
+  } else if (decimal_point <= 0) {
+    // Pure fraction, e.g. ".00123".  (No leading zero, as with g_fmt.)
+    *b++ = '.';
+    for (int i = decimal_point; i < 0; ++i)
+      *b++ = '0';
+    memcpy(b, digits, length);
+    b += length;
+  } else if (decimal_point >= length) {
+    // Integer, possibly with trailing zeros, e.g. "12300".
+    memcpy(b, digits, length);
+    b += length;
+    for (int i = length; i < decimal_point; ++i)
+      *b++ = '0';
+  } else {
+    // Digits on both sides of the point, e.g. "12.345".
+    memcpy(b, digits, decimal_point);
+    b += decimal_point;
+    *b++ = '.';
+    memcpy(b, digits + decimal_point, length - decimal_point);
+    b += length - decimal_point;
+  }
+  *b = '\0';
+}
+
 // Utility to convert a character to a digit in a given base
 template<typename CHAR, int BASE, bool BASE_LTE_10> class BaseCharToDigit {
 };
@@ -390,10 +897,32 @@ string16 Uint64ToString16(uint64 value) {
 std::string DoubleToString(double value) {
   // According to g_fmt.cc, it is sufficient to declare a buffer of size 32.
   char buffer[32];
-  dmg_fp::g_fmt(buffer, value);
+  FormatDouble(value, buffer);
   return std::string(buffer);
 }
 
+void IntToStringAppend(int value, std::string* output) {
+  IntAppendT<int, unsigned int, true>(value, output);
+}
+
+void UintToStringAppend(unsigned value, std::string* output) {
+  IntAppendT<unsigned int, unsigned int, false>(value, output);
+}
+
+void Int64ToStringAppend(int64 value, std::string* output) {
+  IntAppendT<int64, uint64, true>(value, output);
+}
+
+void Uint64ToStringAppend(uint64 value, std::string* output) {
+  IntAppendT<uint64, uint64, false>(value, output);
+}
+
+void DoubleToStringAppend(double value, std::string* output) {
+  char buffer[32];
+  FormatDouble(value, buffer);
+  output->append(buffer);
+}
+
 bool StringToInt(const StringPiece& input, int* output) {
   return StringToIntImpl(input, output);
 }
@@ -45,6 +45,15 @@ BASE_EXPORT string16 Uint64ToString16(uint64 value);
 // locale. If you want to use locale specific formatting, use ICU.
 BASE_EXPORT std::string DoubleToString(double value);
 
+// Variants of the conversions above which append the result to |*output|
+// instead of returning it, so that hot serialization paths (NetLog, the
+// JSON writer) do not construct a temporary string per value.
+BASE_EXPORT void IntToStringAppend(int value, std::string* output);
+BASE_EXPORT void UintToStringAppend(unsigned value, std::string* output);
+BASE_EXPORT void Int64ToStringAppend(int64 value, std::string* output);
+BASE_EXPORT void Uint64ToStringAppend(uint64 value, std::string* output);
+BASE_EXPORT void DoubleToStringAppend(double value, std::string* output);
+
 // String -> number conversions ------------------------------------------------
 
 // Perform a best-effort conversion of the input string to a numeric type,
@@ -57,6 +57,67 @@ TEST(StringNumberConversionsTest, IntToString) {
   }
 }
 
+TEST(StringNumberConversionsTest, IntToStringAppend) {
+  std::string output("x:");
+  IntToStringAppend(-42, &output);
+  EXPECT_EQ("x:-42", output);
+  UintToStringAppend(4294967295U, &output);
+  EXPECT_EQ("x:-424294967295", output);
+
+  output.clear();
+  Int64ToStringAppend(std::numeric_limits<int64>::min(), &output);
+  EXPECT_EQ("-9223372036854775808", output);
+  output.clear();
+  Uint64ToStringAppend(std::numeric_limits<uint64>::max(), &output);
+  EXPECT_EQ("18446744073709551615", output);
+}
+
+TEST(StringNumberConversionsTest, DoubleToString) {
+  // These pin the g_fmt-compatible formatting: shortest digits, no
+  // leading zero on pure fractions, and two-digit minimum exponents.
+  static const struct {
+    double input;
+    const char* expected;
+  } cases[] = {
+    {0.0, "0"},
+    {1.0, "1"},
+    {-1.0, "-1"},
+    {1.5, "1.5"},
+    {0.1, ".1"},
+    {-0.25, "-.25"},
+    {3.14159, "3.14159"},
+    {1234.5678, "1234.5678"},
+    {100.0, "100"},
+    {12345678.0, "12345678"},
+    {1e7, "1e+07"},
+    {1e-4, ".0001"},
+    {1e-5, "1e-05"},
+    {-1e-10, "-1e-10"},
+    {1e21, "1e+21"},
+    {1.23456789e21, "1.23456789e+21"},
+    {5e-324, "5e-324"},  // Smallest denormal.
+    {1.7976931348623157e308, "1.7976931348623157e+308"},
+  };
+  for (size_t i = 0; i < arraysize(cases); ++i) {
+    EXPECT_EQ(cases[i].expected, DoubleToString(cases[i].input));
+
+    std::string appended("d:");
+    DoubleToStringAppend(cases[i].input, &appended);
+    EXPECT_EQ(std::string("d:") + cases[i].expected, appended);
+  }
+
+  // Every output must parse back to exactly the input.
+  static const double kRoundTrips[] = {
+    0.5, 2.0 / 3.0, 1.0 / 3.0, 4e9, 2.225073858507201e-308,
+    9007199254740993.0, 123.456e-67,
+  };
+  for (size_t i = 0; i < arraysize(kRoundTrips); ++i) {
+    double parsed;
+    EXPECT_TRUE(StringToDouble(DoubleToString(kRoundTrips[i]), &parsed));
+    EXPECT_EQ(kRoundTrips[i], parsed);
+  }
+}
+
 TEST(StringNumberConversionsTest, Uint64ToString) {
   static const struct {
     uint64 input;
@@ -49,6 +49,57 @@ void SplitString(const std::string& str,
   SplitStringT(str, c, true, r);
 }
 
+// Narrows |piece| past any leading and trailing whitespace.  Equivalent to
+// TrimWhitespace(..., TRIM_ALL, ...) but returns a view instead of copying.
+static StringPiece TrimWhitespacePiece(const StringPiece& piece) {
+  const StringPiece whitespace(kWhitespaceASCII);
+  const size_t first = piece.find_first_not_of(whitespace);
+  if (first == StringPiece::npos)
+    return StringPiece();
+  const size_t last = piece.find_last_not_of(whitespace);
+  return StringPiece(piece.data() + first, last - first + 1);
+}
+
+static void SplitStringPieceT(const StringPiece& str,
+                              char s,
+                              bool trim_whitespace,
+                              std::vector<StringPiece>* r) {
+  size_t last = 0;
+  size_t c = str.size();
+  for (size_t i = 0; i <= c; ++i) {
+    if (i == c || str[i] == s) {
+      StringPiece piece(str.data() + last, i - last);
+      if (trim_whitespace)
+        piece = TrimWhitespacePiece(piece);
+      // Avoid converting an empty or all-whitespace source string into a
+      // vector of one empty piece.
+      if (i != c || !r->empty() || !piece.empty())
+        r->push_back(piece);
+      last = i + 1;
+    }
+  }
+}
+
+void SplitStringPiece(const StringPiece& str,
+                      char c,
+                      std::vector<StringPiece>* r) {
+#if CHAR_MIN < 0
+  DCHECK(c >= 0);
+#endif
+  DCHECK(c < 0x7F);
+  SplitStringPieceT(str, c, true, r);
+}
+
+void SplitStringPieceDontTrim(const StringPiece& str,
+                              char c,
+                              std::vector<StringPiece>* r) {
+#if CHAR_MIN < 0
+  DCHECK(c >= 0);
+#endif
+  DCHECK(c < 0x7F);
+  SplitStringPieceT(str, c, false, r);
+}
+
 bool SplitStringIntoKeyValues(
     const std::string& line,
     char key_value_delimiter,
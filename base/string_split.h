@@ -12,6 +12,7 @@
 
 #include "base/base_export.h"
 #include "base/string16.h"
+#include "base/string_piece.h"
 
 namespace base {
 
@@ -32,6 +33,21 @@ BASE_EXPORT void SplitString(const std::string& str,
                              char c,
                              std::vector<std::string>* r);
 
+// Like SplitString, but returns StringPiece views into |str| instead of
+// copying every token into a new string, so splitting a large block (an
+// HTTP header, a cookie line) allocates nothing beyond the vector itself.
+// |str| must outlive |*r|.  For fully lazy, one-token-at-a-time iteration
+// see StringPieceTokenizer in base/string_tokenizer.h.
+// Note: |c| must be in the ASCII range.
+BASE_EXPORT void SplitStringPiece(const StringPiece& str,
+                                  char c,
+                                  std::vector<StringPiece>* r);
+
+// The same as SplitStringPiece, but don't trim white space.
+BASE_EXPORT void SplitStringPieceDontTrim(const StringPiece& str,
+                                          char c,
+                                          std::vector<StringPiece>* r);
+
 BASE_EXPORT bool SplitStringIntoKeyValues(
     const std::string& line,
     char key_value_delimiter,
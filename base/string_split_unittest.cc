@@ -284,6 +284,38 @@ TEST(StringSplitTest, StringSplitDontTrim) {
   r.clear();
 }
 
+TEST(StringSplitTest, SplitStringPiece) {
+  std::string input = "a, b ,, c ";
+  std::vector<StringPiece> r;
+
+  SplitStringPiece(input, ',', &r);
+  ASSERT_EQ(4U, r.size());
+  EXPECT_EQ(r[0], "a");
+  EXPECT_EQ(r[1], "b");
+  EXPECT_EQ(r[2], "");
+  EXPECT_EQ(r[3], "c");
+  // The pieces must be views into |input|, not copies.
+  EXPECT_EQ(input.data(), r[0].data());
+  EXPECT_EQ(input.data() + 3, r[1].data());
+  EXPECT_EQ(input.data() + 8, r[3].data());
+  r.clear();
+
+  // Mirror SplitString(): an empty or all-whitespace input yields nothing.
+  SplitStringPiece("", '*', &r);
+  EXPECT_EQ(0U, r.size());
+  SplitStringPiece("  \t ", '*', &r);
+  EXPECT_EQ(0U, r.size());
+  r.clear();
+
+  SplitStringPieceDontTrim("\t  \ta\t ", '\t', &r);
+  ASSERT_EQ(4U, r.size());
+  EXPECT_EQ(r[0], "");
+  EXPECT_EQ(r[1], "  ");
+  EXPECT_EQ(r[2], "a");
+  EXPECT_EQ(r[3], " ");
+  r.clear();
+}
+
 TEST(StringSplitTest, SplitStringAlongWhitespace) {
   struct TestData {
     const char* input;
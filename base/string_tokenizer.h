@@ -254,4 +254,18 @@ typedef StringTokenizerT<std::wstring, std::wstring::const_iterator>
     WStringTokenizer;
 typedef StringTokenizerT<std::string, const char*> CStringTokenizer;
 
+// Tokenizes a StringPiece without any copying; read tokens back with
+// token_piece().  The data the piece points at must live longer than the
+// tokenizer.
+class StringPieceTokenizer
+    : public StringTokenizerT<std::string, const char*> {
+ public:
+  StringPieceTokenizer(const base::StringPiece& input,
+                       const std::string& delims)
+      : StringTokenizerT<std::string, const char*>(input.begin(),
+                                                   input.end(),
+                                                   delims) {
+  }
+};
+
 #endif  // BASE_STRING_TOKENIZER_H_
@@ -30,6 +30,26 @@ TEST(StringTokenizerTest, Simple) {
   EXPECT_FALSE(t.GetNext());
 }
 
+TEST(StringTokenizerTest, StringPieceNoCopy) {
+  string input = "this is a test";
+  StringPieceTokenizer t(base::StringPiece(input), " ");
+
+  EXPECT_TRUE(t.GetNext());
+  EXPECT_EQ(base::StringPiece("this"), t.token_piece());
+  // The token must point into |input|, not at a copy.
+  EXPECT_EQ(input.data(), t.token_piece().data());
+
+  EXPECT_TRUE(t.GetNext());
+  EXPECT_EQ(base::StringPiece("is"), t.token_piece());
+  EXPECT_EQ(input.data() + 5, t.token_piece().data());
+
+  EXPECT_TRUE(t.GetNext());
+  EXPECT_TRUE(t.GetNext());
+  EXPECT_EQ(base::StringPiece("test"), t.token_piece());
+
+  EXPECT_FALSE(t.GetNext());
+}
+
 TEST(StringTokenizerTest, Reset) {
   string input = "this is a test";
   StringTokenizer t(input, " ");
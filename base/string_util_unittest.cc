@@ -402,6 +402,53 @@ TEST(StringUtilTest, IsStringUTF8) {
   EXPECT_FALSE(IsStringUTF8("embedded\xc0\x80U+0000"));
 }
 
+TEST(StringUtilTest, IsStringASCII) {
+  static char char_ascii[] =
+      "0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF";
+  static char16 char16_ascii[] = {
+      '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D',
+      'E', 'F', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B',
+      'C', 'D', 'E', 'F', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+      'A', 'B', 'C', 'D', 'E', 'F', 0 };
+  static std::wstring wchar_ascii(
+      L"0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF");
+
+  // The implementation of IsStringASCII processes the input a machine word
+  // at a time, so exercise all character positions for all alignments and
+  // string lengths covering the unaligned prologue, the word loop and the
+  // trailing characters.
+  for (size_t len = 0; len < arraysize(char_ascii); ++len) {
+    EXPECT_TRUE(IsStringASCII(StringPiece(char_ascii, len)));
+    for (size_t char_pos = 0; char_pos < len; ++char_pos) {
+      char_ascii[char_pos] |= '\x80';
+      EXPECT_FALSE(IsStringASCII(StringPiece(char_ascii, len)));
+      char_ascii[char_pos] &= ~'\x80';
+    }
+  }
+
+  for (size_t len = 0; len < arraysize(char16_ascii); ++len) {
+    EXPECT_TRUE(IsStringASCII(string16(char16_ascii, len)));
+    for (size_t char_pos = 0; char_pos < len; ++char_pos) {
+      char16_ascii[char_pos] |= 0x80;
+      EXPECT_FALSE(IsStringASCII(string16(char16_ascii, len)));
+      char16_ascii[char_pos] &= ~0x80;
+      // Also test when the upper half is non-zero.
+      char16_ascii[char_pos] |= 0x100;
+      EXPECT_FALSE(IsStringASCII(string16(char16_ascii, len)));
+      char16_ascii[char_pos] &= ~0x100;
+    }
+  }
+
+  for (size_t len = 0; len < wchar_ascii.length(); ++len) {
+    EXPECT_TRUE(IsStringASCII(wchar_ascii.substr(0, len)));
+    for (size_t char_pos = 0; char_pos < len; ++char_pos) {
+      std::wstring copy = wchar_ascii.substr(0, len);
+      copy[char_pos] |= 0x80;
+      EXPECT_FALSE(IsStringASCII(copy));
+    }
+  }
+}
+
 TEST(StringUtilTest, ConvertASCII) {
   static const char* char_cases[] = {
     "Google Video",
@@ -59,8 +59,11 @@ static void StringAppendVT(StringType* dst,
     return;
   }
 
-  // Repeatedly increase buffer size until it fits.
+  // Repeatedly increase buffer size until it fits.  The formatted data is
+  // written directly into the tail of |dst| rather than into a temporary
+  // heap buffer that would immediately be copied into |dst| and freed.
   int mem_length = arraysize(stack_buf);
+  const size_t initial_length = dst->length();
   while (true) {
     if (result < 0) {
 #if !defined(OS_WIN)
@@ -72,6 +75,7 @@ static void StringAppendVT(StringType* dst,
       {
         // If an error other than overflow occurred, it's never going to work.
         DLOG(WARNING) << "Unable to printf the requested string due to error.";
+        dst->resize(initial_length);
         return;
       }
       // Try doubling the buffer size.
@@ -86,20 +90,23 @@ static void StringAppendVT(StringType* dst,
       // against huge allocations when using vsnprintfT implementations that
       // return -1 for reasons other than overflow without setting errno.
       DLOG(WARNING) << "Unable to printf the requested string due to size.";
+      dst->resize(initial_length);
       return;
     }
 
-    std::vector<typename StringType::value_type> mem_buf(mem_length);
+    // Leave room for the terminating NUL that vsnprintfT writes; it is
+    // trimmed off below along with any excess from an overestimate.
+    dst->resize(initial_length + mem_length);
 
     // NOTE: You can only use a va_list once.  Since we're in a while loop, we
     // need to make a new copy each time so we don't use up the original.
     GG_VA_COPY(ap_copy, ap);
-    result = vsnprintfT(&mem_buf[0], mem_length, format, ap_copy);
+    result = vsnprintfT(&(*dst)[initial_length], mem_length, format, ap_copy);
     va_end(ap_copy);
 
     if ((result >= 0) && (result < mem_length)) {
       // It fit.
-      dst->append(&mem_buf[0], result);
+      dst->resize(initial_length + result);
       return;
     }
   }
@@ -134,6 +134,22 @@ TEST(StringPrintfTest, GrowBoundary) {
   EXPECT_STREQ(src, out.c_str());
 }
 
+// Appending past the stack buffer formats into the destination's own
+// storage; existing contents must be preserved.
+TEST(StringPrintfTest, AppendGrowBoundary) {
+  const int string_util_buf_len = 1024;
+  const int buf_len = string_util_buf_len + 1;
+  char src[buf_len + 1];  // Need extra one for NULL-terminator.
+  for (int i = 0; i < buf_len; ++i)
+    src[i] = 'a';
+  src[buf_len] = 0;
+
+  std::string out("existing");
+  StringAppendF(&out, "%s", src);
+
+  EXPECT_EQ(std::string("existing") + src, out);
+}
+
 // TODO(evanm): what's the proper cross-platform test here?
 #if defined(OS_WIN)
 // sprintf in Visual Studio fails when given U+FFFF. This tests that the
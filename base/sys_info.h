@@ -12,6 +12,7 @@
 #include "base/time.h"
 
 #include <string>
+#include <vector>
 
 class FilePath;
 
@@ -22,6 +23,24 @@ class BASE_EXPORT SysInfo {
   // Return the number of logical processors/cores on the current machine.
   static int NumberOfProcessors();
 
+  // Describes where one logical processor sits in the machine topology.
+  // Processors with equal |package_id| share a socket (and on NUMA
+  // machines a memory node); processors that also share |core_id| are
+  // hyperthread siblings and share caches.
+  struct ProcessorInfo {
+    int logical_index;  // 0 to NumberOfProcessors() - 1.
+    int core_id;        // Physical core within the package.
+    int package_id;     // Processor package (socket).
+  };
+
+  // Fills |processors| with one entry per logical processor.  On
+  // platforms where the topology cannot be read, every processor reports
+  // core and package 0.
+  static void GetProcessorTopology(std::vector<ProcessorInfo>* processors);
+
+  // Returns the number of processor packages (sockets) in the machine.
+  static int NumberOfProcessorPackages();
+
   // Return the number of bytes of physical memory on the current machine.
   static int64 AmountOfPhysicalMemory();
 
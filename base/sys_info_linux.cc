@@ -5,13 +5,34 @@
 #include "base/sys_info.h"
 
 #include <limits>
+#include <set>
 
 #include "base/file_util.h"
 #include "base/logging.h"
 #include "base/string_number_conversions.h"
+#include "base/string_util.h"
+#include "base/stringprintf.h"
 
 namespace base {
 
+namespace {
+
+// Reads a small integer file such as the ones under
+// /sys/devices/system/cpu/cpuN/topology/.  Returns |default_value| if the
+// file is missing or unparsable.
+int ReadIntFromFile(const std::string& path, int default_value) {
+  std::string contents;
+  if (!file_util::ReadFileToString(FilePath(path), &contents))
+    return default_value;
+  int value = default_value;
+  TrimWhitespaceASCII(contents, TRIM_ALL, &contents);
+  if (!base::StringToInt(contents, &value))
+    return default_value;
+  return value;
+}
+
+}  // namespace
+
 int64 SysInfo::AmountOfPhysicalMemory() {
   long pages = sysconf(_SC_PHYS_PAGES);
   long page_size = sysconf(_SC_PAGE_SIZE);
@@ -23,6 +44,32 @@ int64 SysInfo::AmountOfPhysicalMemory() {
   return static_cast<int64>(pages) * page_size;
 }
 
+// static
+void SysInfo::GetProcessorTopology(std::vector<ProcessorInfo>* processors) {
+  processors->clear();
+  int num_processors = NumberOfProcessors();
+  for (int i = 0; i < num_processors; ++i) {
+    std::string topology_dir =
+        StringPrintf("/sys/devices/system/cpu/cpu%d/topology/", i);
+    ProcessorInfo info;
+    info.logical_index = i;
+    info.core_id = ReadIntFromFile(topology_dir + "core_id", 0);
+    info.package_id =
+        ReadIntFromFile(topology_dir + "physical_package_id", 0);
+    processors->push_back(info);
+  }
+}
+
+// static
+int SysInfo::NumberOfProcessorPackages() {
+  std::vector<ProcessorInfo> processors;
+  GetProcessorTopology(&processors);
+  std::set<int> packages;
+  for (size_t i = 0; i < processors.size(); ++i)
+    packages.insert(processors[i].package_id);
+  return packages.empty() ? 1 : static_cast<int>(packages.size());
+}
+
 // static
 size_t SysInfo::MaxSharedMemorySize() {
   static int64 limit;
@@ -38,6 +38,27 @@ int SysInfo::NumberOfProcessors() {
 }
 #endif
 
+#if !defined(OS_LINUX)
+// Linux reads the real topology from sysfs in sys_info_linux.cc.
+// static
+void SysInfo::GetProcessorTopology(std::vector<ProcessorInfo>* processors) {
+  processors->clear();
+  int num_processors = NumberOfProcessors();
+  for (int i = 0; i < num_processors; ++i) {
+    ProcessorInfo info;
+    info.logical_index = i;
+    info.core_id = 0;
+    info.package_id = 0;
+    processors->push_back(info);
+  }
+}
+
+// static
+int SysInfo::NumberOfProcessorPackages() {
+  return 1;
+}
+#endif
+
 // static
 int64 SysInfo::AmountOfFreeDiskSpace(const FilePath& path) {
   struct statvfs stats;
@@ -21,6 +21,20 @@ TEST_F(SysInfoTest, NumProcs) {
   EXPECT_GE(base::SysInfo::NumberOfProcessors(), 1);
 }
 
+TEST_F(SysInfoTest, ProcessorTopology) {
+  // We aren't actually testing that it's correct, just that it's sane.
+  std::vector<base::SysInfo::ProcessorInfo> processors;
+  base::SysInfo::GetProcessorTopology(&processors);
+  ASSERT_EQ(static_cast<size_t>(base::SysInfo::NumberOfProcessors()),
+            processors.size());
+  for (size_t i = 0; i < processors.size(); ++i) {
+    EXPECT_EQ(static_cast<int>(i), processors[i].logical_index);
+    EXPECT_GE(processors[i].core_id, 0);
+    EXPECT_GE(processors[i].package_id, 0);
+  }
+  EXPECT_GE(base::SysInfo::NumberOfProcessorPackages(), 1);
+}
+
 TEST_F(SysInfoTest, AmountOfMem) {
   // We aren't actually testing that it's correct, just that it's sane.
   EXPECT_GT(base::SysInfo::AmountOfPhysicalMemory(), 0);
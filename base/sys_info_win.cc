@@ -6,6 +6,8 @@
 
 #include <windows.h>
 
+#include <algorithm>
+
 #include "base/file_path.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
@@ -19,6 +21,61 @@ int SysInfo::NumberOfProcessors() {
   return win::OSInfo::GetInstance()->processors();
 }
 
+// static
+void SysInfo::GetProcessorTopology(std::vector<ProcessorInfo>* processors) {
+  processors->clear();
+  int num_processors = NumberOfProcessors();
+  for (int i = 0; i < num_processors; ++i) {
+    ProcessorInfo info;
+    info.logical_index = i;
+    info.core_id = 0;
+    info.package_id = 0;
+    processors->push_back(info);
+  }
+
+  DWORD length = 0;
+  GetLogicalProcessorInformation(NULL, &length);
+  if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+    return;
+  size_t count = length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+  scoped_array<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> buffer(
+      new SYSTEM_LOGICAL_PROCESSOR_INFORMATION[count]);
+  if (!GetLogicalProcessorInformation(buffer.get(), &length))
+    return;
+
+  int next_core_id = 0;
+  int next_package_id = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& entry = buffer[i];
+    if (entry.Relationship != RelationProcessorCore &&
+        entry.Relationship != RelationProcessorPackage)
+      continue;
+    int id = entry.Relationship == RelationProcessorCore ?
+        next_core_id++ : next_package_id++;
+    for (int bit = 0;
+         bit < num_processors &&
+             bit < static_cast<int>(sizeof(ULONG_PTR) * 8);
+         ++bit) {
+      if (!(entry.ProcessorMask & (static_cast<ULONG_PTR>(1) << bit)))
+        continue;
+      if (entry.Relationship == RelationProcessorCore)
+        (*processors)[bit].core_id = id;
+      else
+        (*processors)[bit].package_id = id;
+    }
+  }
+}
+
+// static
+int SysInfo::NumberOfProcessorPackages() {
+  std::vector<ProcessorInfo> processors;
+  GetProcessorTopology(&processors);
+  int max_package_id = 0;
+  for (size_t i = 0; i < processors.size(); ++i)
+    max_package_id = std::max(max_package_id, processors[i].package_id);
+  return max_package_id + 1;
+}
+
 // static
 int64 SysInfo::AmountOfPhysicalMemory() {
   MEMORYSTATUSEX memory_info;
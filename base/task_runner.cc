@@ -4,6 +4,7 @@
 
 #include "base/task_runner.h"
 
+#include "base/callback.h"
 #include "base/compiler_specific.h"
 #include "base/logging.h"
 #include "base/threading/post_task_and_reply_impl.h"
@@ -45,6 +46,18 @@ bool TaskRunner::PostTask(const tracked_objects::Location& from_here,
   return PostDelayedTask(from_here, task, 0);
 }
 
+bool TaskRunner::PostTaskBatch(const tracked_objects::Location& from_here,
+                               std::vector<Closure>* tasks) {
+  bool result = true;
+  for (size_t i = 0; i < tasks->size(); ++i) {
+    if (!PostTask(from_here, (*tasks)[i]))
+      result = false;
+    (*tasks)[i].Reset();
+  }
+  tasks->clear();
+  return result;
+}
+
 bool TaskRunner::PostTaskAndReply(
     const tracked_objects::Location& from_here,
     const Closure& task,
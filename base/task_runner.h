@@ -6,6 +6,8 @@
 #define BASE_TASK_RUNNER_H_
 #pragma once
 
+#include <vector>
+
 #include "base/base_export.h"
 #include "base/basictypes.h"
 #include "base/callback_forward.h"
@@ -67,6 +69,16 @@ class BASE_EXPORT TaskRunner
   bool PostTask(const tracked_objects::Location& from_here,
                 const Closure& task);
 
+  // Posts every closure in |*tasks| in order, as if by calling PostTask on
+  // each, and resets them.  Returns true only if every task may be run at
+  // some point in the future.  The default implementation simply loops;
+  // implementations that can enqueue the whole batch with one lock
+  // acquisition and one target-thread wakeup (e.g. MessageLoopProxy)
+  // override it, which is worth using when posting bursts of related
+  // tasks across threads.
+  virtual bool PostTaskBatch(const tracked_objects::Location& from_here,
+                             std::vector<Closure>* tasks);
+
   // Like PostTask, but tries to run the posted task only after
   // |delay_ms| has passed.
   //
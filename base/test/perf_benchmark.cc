@@ -0,0 +1,131 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/test/perf_benchmark.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "base/command_line.h"
+#include "base/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/perftimer.h"
+#include "base/values.h"
+
+namespace base {
+
+namespace {
+
+// File that JSON results are appended to, one object per line.
+const char kJsonOutputSwitch[] = "perf-metrics-json";
+
+// Steady-state detection compares the means of the two most recent windows
+// of this many samples.
+const size_t kSteadyStateWindow = 50;
+
+// The windows are considered settled when their means differ by this
+// fraction or less.
+const double kSteadyStateTolerance = 0.05;
+
+// Hard cap so that a noisy benchmark still terminates.
+const size_t kMaxSamples = 10000;
+
+double WindowMean(const std::vector<int64>& samples, size_t end) {
+  int64 sum = 0;
+  for (size_t i = end - kSteadyStateWindow; i < end; i++)
+    sum += samples[i];
+  return static_cast<double>(sum) / kSteadyStateWindow;
+}
+
+}  // namespace
+
+PerfBenchmark::PerfBenchmark(const std::string& name)
+    : name_(name),
+      reported_(false) {
+}
+
+PerfBenchmark::~PerfBenchmark() {
+  if (!reported_)
+    Report();
+}
+
+void PerfBenchmark::StartIteration() {
+  iteration_start_ = TimeTicks::Now();
+}
+
+void PerfBenchmark::StopIteration() {
+  DCHECK(!iteration_start_.is_null());
+  AddSample(TimeTicks::Now() - iteration_start_);
+}
+
+void PerfBenchmark::AddSample(TimeDelta elapsed) {
+  samples_us_.push_back(elapsed.InMicroseconds());
+}
+
+bool PerfBenchmark::ReachedSteadyState() const {
+  if (samples_us_.size() >= kMaxSamples)
+    return true;
+  if (samples_us_.size() < 2 * kSteadyStateWindow)
+    return false;
+  double current = WindowMean(samples_us_, samples_us_.size());
+  double previous = WindowMean(samples_us_,
+                               samples_us_.size() - kSteadyStateWindow);
+  if (previous <= 0)
+    return true;
+  return fabs(current - previous) <= kSteadyStateTolerance * previous;
+}
+
+int64 PerfBenchmark::PercentileInMicroseconds(int percent) const {
+  if (samples_us_.empty())
+    return 0;
+  std::vector<int64> sorted(samples_us_);
+  size_t index = sorted.size() * percent / 100;
+  if (index >= sorted.size())
+    index = sorted.size() - 1;
+  std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+  return sorted[index];
+}
+
+void PerfBenchmark::Report() {
+  reported_ = true;
+
+  int64 total_us = 0;
+  for (size_t i = 0; i < samples_us_.size(); i++)
+    total_us += samples_us_[i];
+  double total_ms = total_us / 1000.0;
+  double throughput = total_us > 0 ?
+      samples_us_.size() * 1000000.0 / total_us : 0;
+  int64 p50_us = PercentileInMicroseconds(50);
+  int64 p95_us = PercentileInMicroseconds(95);
+  int64 p99_us = PercentileInMicroseconds(99);
+
+  LogPerfResult(name_.c_str(), total_ms, "ms");
+  LogPerfResult((name_ + "_throughput").c_str(), throughput, "ops/s");
+  LogPerfResult((name_ + "_p50").c_str(), p50_us / 1000.0, "ms");
+  LogPerfResult((name_ + "_p95").c_str(), p95_us / 1000.0, "ms");
+  LogPerfResult((name_ + "_p99").c_str(), p99_us / 1000.0, "ms");
+
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(kJsonOutputSwitch))
+    return;
+
+  DictionaryValue dict;
+  dict.SetString("name", name_);
+  dict.SetInteger("samples", static_cast<int>(samples_us_.size()));
+  dict.SetDouble("total_ms", total_ms);
+  dict.SetDouble("throughput_ops_per_s", throughput);
+  dict.SetDouble("p50_us", static_cast<double>(p50_us));
+  dict.SetDouble("p95_us", static_cast<double>(p95_us));
+  dict.SetDouble("p99_us", static_cast<double>(p99_us));
+
+  std::string json;
+  JSONWriter::Write(&dict, &json);
+  json += "\n";
+  file_util::AppendToFile(command_line.GetSwitchValuePath(kJsonOutputSwitch),
+                          json.data(), json.size());
+}
+
+}  // namespace base
@@ -0,0 +1,75 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TEST_PERF_BENCHMARK_H_
+#define BASE_TEST_PERF_BENCHMARK_H_
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/time.h"
+
+namespace base {
+
+// Gathers per-iteration timings for a benchmark and reports aggregate
+// metrics: total time (compatible with the series PerfTimeLogger produces),
+// throughput, and p50/p95/p99 latency.  Results go to the perf log (see
+// base/perftimer.h) and, when --perf-metrics-json=<path> is given, are also
+// appended to that file as one JSON object per benchmark so that CI can
+// gate on the numbers from a single run.
+//
+// Typical use:
+//   PerfBenchmark benchmark("Cookie_monster_query_single_host");
+//   while (!benchmark.ReachedSteadyState()) {
+//     benchmark.StartIteration();
+//     ... one operation ...
+//     benchmark.StopIteration();
+//   }
+//   benchmark.Report();
+//
+// Fixed-iteration tests can simply call StartIteration()/StopIteration()
+// around each operation of their existing loop.
+class PerfBenchmark {
+ public:
+  explicit PerfBenchmark(const std::string& name);
+
+  // Calls Report() if the test did not.
+  ~PerfBenchmark();
+
+  // Times a single iteration.  Only the time between these two calls is
+  // attributed to the benchmark, so per-iteration setup stays out of the
+  // measurement.
+  void StartIteration();
+  void StopIteration();
+
+  // Records a sample measured by the caller.
+  void AddSample(TimeDelta elapsed);
+
+  // Returns true once the mean of the most recent sample window is within
+  // a small tolerance of the previous window's, i.e. the benchmark has
+  // warmed up and settled.  Also returns true when a cap on the number of
+  // samples is reached, so this can be a loop's only exit condition.
+  bool ReachedSteadyState() const;
+
+  // Returns the given latency percentile over the recorded samples.
+  int64 PercentileInMicroseconds(int percent) const;
+
+  // Logs the aggregate metrics.  The total time is logged under |name| so
+  // the series stays comparable with one produced by PerfTimeLogger.
+  void Report();
+
+ private:
+  const std::string name_;
+  std::vector<int64> samples_us_;
+  TimeTicks iteration_start_;
+  bool reported_;
+
+  DISALLOW_COPY_AND_ASSIGN(PerfBenchmark);
+};
+
+}  // namespace base
+
+#endif  // BASE_TEST_PERF_BENCHMARK_H_
@@ -113,6 +113,19 @@ class BASE_EXPORT PlatformThread {
   static void SetThreadPriority(PlatformThreadHandle handle,
                                 ThreadPriority priority);
 
+  // Restricts the thread to the logical processors whose bits are set in
+  // |mask| (bit n = logical processor n, matching the indexes reported by
+  // SysInfo::GetProcessorTopology()).  Use this to keep hot threads
+  // within one processor package on multi-socket machines, where
+  // cross-node memory traffic is expensive.  A zero mask is invalid.
+  // Returns false on platforms that cannot apply the hint; Mac's
+  // scheduler does not take affinity masks.
+  static bool SetThreadAffinityMask(PlatformThreadHandle handle,
+                                    uint64 mask);
+
+  // As above, for the calling thread.
+  static bool SetCurrentThreadAffinityMask(uint64 mask);
+
  private:
   DISALLOW_IMPLICIT_CONSTRUCTORS(PlatformThread);
 };
@@ -285,4 +285,29 @@ void PlatformThread::SetThreadPriority(PlatformThreadHandle, ThreadPriority) {
 }
 #endif
 
+// static
+bool PlatformThread::SetThreadAffinityMask(PlatformThreadHandle handle,
+                                           uint64 mask) {
+#if defined(OS_LINUX)
+  if (!mask)
+    return false;
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (unsigned bit = 0; bit < 64; ++bit) {
+    if (mask & (GG_UINT64_C(1) << bit))
+      CPU_SET(bit, &cpu_set);
+  }
+  return pthread_setaffinity_np(handle, sizeof(cpu_set), &cpu_set) == 0;
+#else
+  // The Mach scheduler only takes relative affinity hints, and the BSDs
+  // have no portable interface for this; treat the mask as unsupported.
+  return false;
+#endif
+}
+
+// static
+bool PlatformThread::SetCurrentThreadAffinityMask(uint64 mask) {
+  return SetThreadAffinityMask(pthread_self(), mask);
+}
+
 }  // namespace base
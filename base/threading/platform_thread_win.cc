@@ -199,4 +199,17 @@ void PlatformThread::SetThreadPriority(PlatformThreadHandle handle,
   }
 }
 
+// static
+bool PlatformThread::SetThreadAffinityMask(PlatformThreadHandle handle,
+                                           uint64 mask) {
+  if (!mask)
+    return false;
+  return ::SetThreadAffinityMask(handle, static_cast<DWORD_PTR>(mask)) != 0;
+}
+
+// static
+bool PlatformThread::SetCurrentThreadAffinityMask(uint64 mask) {
+  return SetThreadAffinityMask(::GetCurrentThread(), mask);
+}
+
 }  // namespace base
@@ -4,6 +4,7 @@
 
 #include "base/threading/sequenced_worker_pool.h"
 
+#include <deque>
 #include <list>
 #include <map>
 #include <set>
@@ -283,9 +284,14 @@ class SequencedWorkerPool::Worker : public SimpleThread {
     return running_sequence_;
   }
 
+  int worker_number() const {
+    return worker_number_;
+  }
+
  private:
   scoped_refptr<SequencedWorkerPool> worker_pool_;
   SequenceToken running_sequence_;
+  const int worker_number_;
 
   DISALLOW_COPY_AND_ASSIGN(Worker);
 };
@@ -323,6 +329,8 @@ class SequencedWorkerPool::Inner {
 
   void SignalHasWorkForTesting();
 
+  void SetWorkerAffinityMask(uint64 affinity_mask);
+
   int GetWorkSignalCountForTesting() const;
 
   void Shutdown();
@@ -331,6 +339,15 @@ class SequencedWorkerPool::Inner {
   void ThreadLoop(Worker* this_worker);
 
  private:
+  // An unsequenced-task queue assigned to one worker thread.  The owning
+  // worker pops from the front while other workers steal from the back;
+  // each deque has its own lock so that unsequenced work never contends on
+  // the pool-wide |lock_|.
+  struct WorkDeque {
+    Lock lock;
+    std::deque<SequencedTask> tasks;
+  };
+
   // Returns whether there are no more pending tasks and all threads
   // are idle.  Must be called under lock.
   bool IsIdle() const;
@@ -345,6 +362,19 @@ class SequencedWorkerPool::Inner {
   bool GetWork(SequencedTask* task,
                std::vector<Closure>* delete_these_outside_lock);
 
+  // Pops an unsequenced task from the deque at |deque_index|, stealing from
+  // the other deques if it is empty. Takes only the individual deque locks,
+  // never |lock_|. During shutdown, tasks that aren't blocking shutdown are
+  // moved to |delete_these_outside_lock| as in GetWork().
+  bool GetDequeWork(size_t deque_index,
+                    SequencedTask* task,
+                    std::vector<Closure>* delete_these_outside_lock);
+
+  // Runs an unsequenced task obtained from GetDequeWork(), taking |lock_|
+  // only for tasks that block shutdown to keep the shutdown accounting
+  // accurate. Called without any locks held.
+  void RunDequeTask(SequencedTask* task);
+
   // Peforms init and cleanup around running the given task. WillRun...
   // returns the value from PrepareToStartAdditionalThreadIfNecessary.
   // The calling code should call FinishStartingAdditionalThread once the
@@ -425,6 +455,10 @@ class SequencedWorkerPool::Inner {
   // See PrepareToStartAdditionalThreadIfHelpful for more.
   bool thread_being_created_;
 
+  // Affinity mask applied by each worker thread as it starts up, or 0 for
+  // no restriction.  Protected by |lock_|.
+  uint64 worker_affinity_mask_;
+
   // Number of threads currently waiting for work.
   size_t waiting_thread_count_;
 
@@ -432,14 +466,28 @@ class SequencedWorkerPool::Inner {
   // flag set.
   size_t blocking_shutdown_thread_count_;
 
-  // In-order list of all pending tasks. These are tasks waiting for a thread
-  // to run on or that are blocked on a previous task in their sequence.
+  // In-order list of pending sequenced tasks. These are tasks waiting for a
+  // thread to run on or that are blocked on a previous task in their
+  // sequence. Unsequenced tasks go to the per-worker deques below instead.
   //
   // We maintain the pending_task_count_ separately for metrics because
   // list.size() can be linear time.
   std::list<SequencedTask> pending_tasks_;
   size_t pending_task_count_;
 
+  // Per-worker deques of unsequenced tasks, indexed by worker number.
+  // Unsequenced tasks can run in any order, so they are distributed
+  // round-robin at post time and picked up (or stolen) by workers without
+  // taking |lock_|. Posting to a deque is always done while holding |lock_|
+  // so that a worker re-checking |deque_task_count_| under the lock before
+  // waiting cannot miss a wakeup.
+  std::vector<linked_ptr<WorkDeque> > deques_;
+  size_t next_deque_index_;
+
+  // Number of tasks currently sitting in |deques_|. Maintained with atomic
+  // increments so the worker fast path can update it without |lock_|.
+  volatile subtle::Atomic32 deque_task_count_;
+
   // Number of tasks in the pending_tasks_ list that are marked as blocking
   // shutdown.
   size_t blocking_shutdown_pending_task_count_;
@@ -464,7 +512,8 @@ SequencedWorkerPool::Worker::Worker(
     const std::string& prefix)
     : SimpleThread(
           prefix + StringPrintf("Worker%d", thread_number).c_str()),
-      worker_pool_(worker_pool) {
+      worker_pool_(worker_pool),
+      worker_number_(thread_number) {
   Start();
 }
 
@@ -498,12 +547,18 @@ SequencedWorkerPool::Inner::Inner(
       max_threads_(max_threads),
       thread_name_prefix_(thread_name_prefix),
       thread_being_created_(false),
+      worker_affinity_mask_(0),
       waiting_thread_count_(0),
       blocking_shutdown_thread_count_(0),
       pending_task_count_(0),
+      next_deque_index_(0),
+      deque_task_count_(0),
       blocking_shutdown_pending_task_count_(0),
       shutdown_called_(false),
-      testing_observer_(observer) {}
+      testing_observer_(observer) {
+  for (size_t i = 0; i < max_threads; ++i)
+    deques_.push_back(linked_ptr<WorkDeque>(new WorkDeque));
+}
 
 SequencedWorkerPool::Inner::~Inner() {
   // You must call Shutdown() before destroying the pool.
@@ -554,8 +609,18 @@ bool SequencedWorkerPool::Inner::PostTask(
     if (optional_token_name)
       sequenced.sequence_token_id = LockedGetNamedTokenID(*optional_token_name);
 
-    pending_tasks_.push_back(sequenced);
-    pending_task_count_++;
+    if (sequenced.sequence_token_id) {
+      pending_tasks_.push_back(sequenced);
+      pending_task_count_++;
+    } else {
+      // Unsequenced tasks can run in any order, so distribute them
+      // round-robin across the per-worker deques where workers pick them up
+      // (or steal them) without taking |lock_|.
+      WorkDeque* deque = deques_[next_deque_index_++ % deques_.size()].get();
+      AutoLock deque_lock(deque->lock);
+      deque->tasks.push_back(sequenced);
+      subtle::NoBarrier_AtomicIncrement(&deque_task_count_, 1);
+    }
     if (shutdown_behavior == BLOCK_SHUTDOWN)
       blocking_shutdown_pending_task_count_++;
 
@@ -596,6 +661,11 @@ void SequencedWorkerPool::Inner::SignalHasWorkForTesting() {
   SignalHasWork();
 }
 
+void SequencedWorkerPool::Inner::SetWorkerAffinityMask(uint64 affinity_mask) {
+  AutoLock lock(lock_);
+  worker_affinity_mask_ = affinity_mask;
+}
+
 void SequencedWorkerPool::Inner::Shutdown() {
   // Mark us as terminated and go through and drop all tasks that aren't
   // required to run on shutdown. Since no new tasks will get posted once the
@@ -636,6 +706,7 @@ void SequencedWorkerPool::Inner::Shutdown() {
 }
 
 void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
+  uint64 affinity_mask;
   {
     AutoLock lock(lock_);
     DCHECK(thread_being_created_);
@@ -644,15 +715,45 @@ void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
         threads_.insert(
             std::make_pair(this_worker->tid(), make_linked_ptr(this_worker)));
     DCHECK(result.second);
+    affinity_mask = worker_affinity_mask_;
+  }
+
+  if (affinity_mask)
+    PlatformThread::SetCurrentThreadAffinityMask(affinity_mask);
+
+  const size_t deque_index =
+      static_cast<size_t>(this_worker->worker_number() - 1);
+  DCHECK_LT(deque_index, deques_.size());
 
-    while (true) {
+  bool exiting = false;
+  while (!exiting) {
 #if defined(OS_MACOSX)
-      base::mac::ScopedNSAutoreleasePool autorelease_pool;
+    base::mac::ScopedNSAutoreleasePool autorelease_pool;
 #endif
 
-      // See GetWork for what delete_these_outside_lock is doing.
-      SequencedTask task;
-      std::vector<Closure> delete_these_outside_lock;
+    // See GetWork for what delete_these_outside_lock is doing.
+    SequencedTask task;
+    std::vector<Closure> delete_these_outside_lock;
+
+    // Fast path: unsequenced tasks come from the per-worker deques and are
+    // run without ever touching |lock_|.
+    bool got_deque_work =
+        GetDequeWork(deque_index, &task, &delete_these_outside_lock);
+    // Tasks dropped during shutdown are deleted here, outside all locks.
+    delete_these_outside_lock.clear();
+    if (got_deque_work) {
+      RunDequeTask(&task);
+      continue;
+    }
+
+    {
+      AutoLock lock(lock_);
+      // Unsequenced tasks are posted while holding |lock_|, so re-checking
+      // the deques under the lock before waiting guarantees we cannot miss
+      // the wakeup for a task posted after the check above.
+      if (subtle::NoBarrier_Load(&deque_task_count_) > 0)
+        continue;
+
       if (GetWork(&task, &delete_these_outside_lock)) {
         int new_thread_id = WillRunWorkerTask(task);
         {
@@ -686,17 +787,19 @@ void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
         // shutdown_called_ is set. There may be some tasks stuck
         // behind running ones with the same sequence token, but
         // additional threads won't help this case.
-        if (shutdown_called_)
-          break;
-        waiting_thread_count_++;
-        // This is the only time that IsIdle() can go to true.
-        if (IsIdle())
-          is_idle_cv_.Signal();
-        has_work_cv_.Wait();
-        waiting_thread_count_--;
+        if (shutdown_called_) {
+          exiting = true;
+        } else {
+          waiting_thread_count_++;
+          // This is the only time that IsIdle() can go to true.
+          if (IsIdle())
+            is_idle_cv_.Signal();
+          has_work_cv_.Wait();
+          waiting_thread_count_--;
+        }
       }
-    }
-  }  // Release lock_.
+    }  // Release lock_.
+  }
 
   // We noticed we should exit. Wake up the next worker so it knows it should
   // exit as well (because the Shutdown() code only signals once).
@@ -708,7 +811,9 @@ void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
 
 bool SequencedWorkerPool::Inner::IsIdle() const {
   lock_.AssertAcquired();
-  return pending_task_count_ == 0 && waiting_thread_count_ == threads_.size();
+  return pending_task_count_ == 0 &&
+         subtle::NoBarrier_Load(&deque_task_count_) == 0 &&
+         waiting_thread_count_ == threads_.size();
 }
 
 int SequencedWorkerPool::Inner::LockedGetNamedTokenID(
@@ -809,6 +914,62 @@ bool SequencedWorkerPool::Inner::GetWork(
   return found_task;
 }
 
+bool SequencedWorkerPool::Inner::GetDequeWork(
+    size_t deque_index,
+    SequencedTask* task,
+    std::vector<Closure>* delete_these_outside_lock) {
+  // Pop from our own deque first, then try to steal from the others.
+  // Unsequenced tasks can run in any order, so stealing cannot violate any
+  // ordering guarantee. The owner pops from the front and thieves pop from
+  // the back to reduce collisions between them.
+  for (size_t n = 0; n < deques_.size(); ++n) {
+    WorkDeque* deque = deques_[(deque_index + n) % deques_.size()].get();
+    AutoLock deque_lock(deque->lock);
+    while (!deque->tasks.empty()) {
+      if (n == 0) {
+        *task = deque->tasks.front();
+        deque->tasks.pop_front();
+      } else {
+        *task = deque->tasks.back();
+        deque->tasks.pop_back();
+      }
+      subtle::NoBarrier_AtomicIncrement(&deque_task_count_, -1);
+
+      if (shutdown_called_ && task->shutdown_behavior != BLOCK_SHUTDOWN) {
+        // We're shutting down and this task isn't blocking shutdown. Drop
+        // it and keep looking, deleting the closure outside the locks as
+        // GetWork() does.
+        delete_these_outside_lock->push_back(task->task);
+        task->task = Closure();
+        continue;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void SequencedWorkerPool::Inner::RunDequeTask(SequencedTask* task) {
+  if (task->shutdown_behavior == BLOCK_SHUTDOWN) {
+    // Atomically convert the pending-task count into a running-thread count
+    // so that CanShutdown() never sees a gap where this task is accounted
+    // nowhere.
+    AutoLock lock(lock_);
+    DCHECK_GT(blocking_shutdown_pending_task_count_, 0u);
+    blocking_shutdown_pending_task_count_--;
+    blocking_shutdown_thread_count_++;
+  }
+
+  task->task.Run();
+  task->task = Closure();
+
+  if (task->shutdown_behavior == BLOCK_SHUTDOWN) {
+    AutoLock lock(lock_);
+    DCHECK_GT(blocking_shutdown_thread_count_, 0u);
+    blocking_shutdown_thread_count_--;
+  }
+}
+
 int SequencedWorkerPool::Inner::WillRunWorkerTask(const SequencedTask& task) {
   lock_.AssertAcquired();
 
@@ -892,6 +1053,11 @@ int SequencedWorkerPool::Inner::PrepareToStartAdditionalThreadIfHelpful() {
       !thread_being_created_ &&
       threads_.size() < max_threads_ &&
       waiting_thread_count_ == 0) {
+    // Unsequenced tasks in the per-worker deques are always runnable.
+    if (subtle::NoBarrier_Load(&deque_task_count_) > 0) {
+      thread_being_created_ = true;
+      return static_cast<int>(threads_.size() + 1);
+    }
     // We could use an additional thread if there's work to be done.
     for (std::list<SequencedTask>::iterator i = pending_tasks_.begin();
          i != pending_tasks_.end(); ++i) {
@@ -1065,6 +1231,10 @@ void SequencedWorkerPool::SignalHasWorkForTesting() {
   inner_->SignalHasWorkForTesting();
 }
 
+void SequencedWorkerPool::SetWorkerAffinityMask(uint64 affinity_mask) {
+  inner_->SetWorkerAffinityMask(affinity_mask);
+}
+
 void SequencedWorkerPool::Shutdown() {
   DCHECK(constructor_message_loop_->BelongsToCurrentThread());
   inner_->Shutdown();
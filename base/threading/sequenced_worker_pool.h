@@ -254,6 +254,13 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
   // Spuriously signal that there is work to be done.
   void SignalHasWorkForTesting();
 
+  // Restricts the pool's worker threads to the logical processors whose
+  // bits are set, as for PlatformThread::SetThreadAffinityMask().  Only
+  // workers created after this call pick up the mask; since workers are
+  // created lazily, calling this right after construction covers them all.
+  // A mask of 0 (the default) leaves workers free to run anywhere.
+  void SetWorkerAffinityMask(uint64 affinity_mask);
+
   // Implements the worker pool shutdown. This should be called during app
   // shutdown, and will discard/join with appropriate tasks before returning.
   // After this call, subsequent calls to post tasks will fail.
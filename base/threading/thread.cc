@@ -30,11 +30,10 @@ void ThreadQuitHelper() {
   Thread::SetThreadWasQuitProperly(true);
 }
 
-// Used to pass data to ThreadMain.  This structure is allocated on the stack
-// from within StartWithOptions.
+// Used to pass data to ThreadMain.  It is allocated on the heap so that it
+// can outlive StartWithOptionsAsync() until WaitUntilThreadStarted() runs.
 struct Thread::StartupData {
-  // We get away with a const reference here because of how we are allocated.
-  const Thread::Options& options;
+  const Thread::Options options;
 
   // Used to synchronize thread startup.
   WaitableEvent event;
@@ -63,24 +62,45 @@ bool Thread::Start() {
 }
 
 bool Thread::StartWithOptions(const Options& options) {
+  if (!StartWithOptionsAsync(options))
+    return false;
+  return WaitUntilThreadStarted();
+}
+
+bool Thread::StartWithOptionsAsync(const Options& options) {
   DCHECK(!message_loop_);
+  DCHECK(!startup_data_);
 
   SetThreadWasQuitProperly(false);
 
-  StartupData startup_data(options);
-  startup_data_ = &startup_data;
+  startup_data_ = new StartupData(options);
 
   if (!PlatformThread::Create(options.stack_size, this, &thread_)) {
     DLOG(ERROR) << "failed to create thread";
+    delete startup_data_;
     startup_data_ = NULL;
     return false;
   }
 
+  if (options.affinity_mask)
+    PlatformThread::SetThreadAffinityMask(thread_, options.affinity_mask);
+
+  return true;
+}
+
+bool Thread::WaitUntilThreadStarted() {
+  if (started_)
+    return true;
+  if (!startup_data_)
+    return false;
+
   // Wait for the thread to start and initialize message_loop_
-  base::ThreadRestrictions::ScopedAllowWait allow_wait;
-  startup_data.event.Wait();
+  {
+    base::ThreadRestrictions::ScopedAllowWait allow_wait;
+    startup_data_->event.Wait();
+  }
 
-  // set it to NULL so we don't keep a pointer to some object on the stack.
+  delete startup_data_;
   startup_data_ = NULL;
   started_ = true;
 
@@ -89,6 +109,11 @@ bool Thread::StartWithOptions(const Options& options) {
 }
 
 void Thread::Stop() {
+  // A thread started asynchronously may not have finished its startup
+  // handshake yet; complete it so the thread can be joined safely.
+  if (startup_data_)
+    WaitUntilThreadStarted();
+
   if (!thread_was_started())
     return;
 
@@ -31,9 +31,12 @@ namespace base {
 class BASE_EXPORT Thread : PlatformThread::Delegate {
  public:
   struct Options {
-    Options() : message_loop_type(MessageLoop::TYPE_DEFAULT), stack_size(0) {}
+    Options()
+        : message_loop_type(MessageLoop::TYPE_DEFAULT),
+          stack_size(0),
+          affinity_mask(0) {}
     Options(MessageLoop::Type type, size_t size)
-        : message_loop_type(type), stack_size(size) {}
+        : message_loop_type(type), stack_size(size), affinity_mask(0) {}
 
     // Specifies the type of message loop that will be allocated on the thread.
     MessageLoop::Type message_loop_type;
@@ -42,6 +45,12 @@ class BASE_EXPORT Thread : PlatformThread::Delegate {
     // This does not necessarily correspond to the thread's initial stack size.
     // A value of 0 indicates that the default maximum should be used.
     size_t stack_size;
+
+    // Restricts the thread to the logical processors whose bits are set,
+    // as for PlatformThread::SetThreadAffinityMask().  A value of 0 leaves
+    // the thread free to run anywhere.  The mask is applied on a best-effort
+    // basis; platforms without affinity support ignore it.
+    uint64 affinity_mask;
   };
 
   // Constructor.
@@ -76,6 +85,18 @@ class BASE_EXPORT Thread : PlatformThread::Delegate {
   // callback.
   bool StartWithOptions(const Options& options);
 
+  // Like StartWithOptions, but returns as soon as the underlying platform
+  // thread has been created, without waiting for it to begin running.  The
+  // caller must call WaitUntilThreadStarted() before using message_loop() or
+  // stopping the thread.  This lets several threads be spawned concurrently
+  // rather than paying each thread's startup latency in sequence.
+  bool StartWithOptionsAsync(const Options& options);
+
+  // Completes a StartWithOptionsAsync() call by blocking until the new thread
+  // is running its message loop.  Returns false if the thread was never
+  // started; a no-op returning true if the startup already completed.
+  bool WaitUntilThreadStarted();
+
   // Signals the thread to exit and returns once the thread has exited.  After
   // this method returns, the Thread object is completely reset and may be used
   // as if it were newly constructed (i.e., Start may be called again).
@@ -156,6 +156,34 @@ TEST_F(ThreadTest, StartWithOptions_StackSize) {
   EXPECT_TRUE(was_invoked);
 }
 
+TEST_F(ThreadTest, StartWithOptionsAsync) {
+  Thread a("StartAsyncA");
+  Thread b("StartAsyncB");
+  // Spawn both threads before joining either startup.
+  EXPECT_TRUE(a.StartWithOptionsAsync(Thread::Options()));
+  EXPECT_TRUE(b.StartWithOptionsAsync(Thread::Options()));
+  EXPECT_TRUE(a.WaitUntilThreadStarted());
+  EXPECT_TRUE(b.WaitUntilThreadStarted());
+  EXPECT_TRUE(a.message_loop());
+  EXPECT_TRUE(b.message_loop());
+  EXPECT_TRUE(a.IsRunning());
+  EXPECT_TRUE(b.IsRunning());
+  a.Stop();
+  b.Stop();
+  EXPECT_FALSE(a.message_loop());
+  EXPECT_FALSE(b.message_loop());
+}
+
+TEST_F(ThreadTest, StopWithoutWaitingForAsyncStart) {
+  // Stop() (and thus the destructor) must cope with a thread whose startup
+  // handshake hasn't been joined yet.
+  Thread a("StopWithoutWait");
+  EXPECT_TRUE(a.StartWithOptionsAsync(Thread::Options()));
+  a.Stop();
+  EXPECT_FALSE(a.message_loop());
+  EXPECT_FALSE(a.IsRunning());
+}
+
 TEST_F(ThreadTest, TwoTasks) {
   bool was_invoked = false;
   {
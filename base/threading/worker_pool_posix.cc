@@ -10,6 +10,7 @@
 #include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
+#include "base/metrics/histogram.h"
 #include "base/stringprintf.h"
 #include "base/threading/platform_thread.h"
 #include "base/threading/thread_local.h"
@@ -39,21 +40,31 @@ class WorkerPoolImpl {
                 const base::Closure& task, bool task_is_slow);
 
  private:
+  // Tasks not flagged as slow share |pool_|; tasks flagged as slow get their
+  // own pool so that bulk work cannot queue ahead of latency-sensitive tasks
+  // (e.g. DNS resolutions) and inflate their queueing delay.
   scoped_refptr<base::PosixDynamicThreadPool> pool_;
+  scoped_refptr<base::PosixDynamicThreadPool> slow_pool_;
 };
 
 WorkerPoolImpl::WorkerPoolImpl()
     : pool_(new base::PosixDynamicThreadPool("WorkerPool",
-                                             kIdleSecondsBeforeExit)) {
+                                             kIdleSecondsBeforeExit)),
+      slow_pool_(new base::PosixDynamicThreadPool("SlowWorkerPool",
+                                                  kIdleSecondsBeforeExit)) {
 }
 
 WorkerPoolImpl::~WorkerPoolImpl() {
   pool_->Terminate();
+  slow_pool_->Terminate();
 }
 
 void WorkerPoolImpl::PostTask(const tracked_objects::Location& from_here,
                               const base::Closure& task, bool task_is_slow) {
-  pool_->PostTask(from_here, task);
+  if (task_is_slow)
+    slow_pool_->PostTask(from_here, task);
+  else
+    pool_->PostTask(from_here, task);
 }
 
 base::LazyInstance<WorkerPoolImpl> g_lazy_worker_pool =
@@ -123,6 +134,13 @@ PosixDynamicThreadPool::PosixDynamicThreadPool(
     int idle_seconds_before_exit)
     : name_prefix_(name_prefix),
       idle_seconds_before_exit_(idle_seconds_before_exit),
+      queue_depth_histogram_(Histogram::FactoryGet(
+          name_prefix + ".QueueDepth", 1, 100, 50,
+          Histogram::kUmaTargetedHistogramFlag)),
+      queue_time_histogram_(Histogram::FactoryTimeGet(
+          name_prefix + ".QueueTime",
+          TimeDelta::FromMilliseconds(1), TimeDelta::FromSeconds(60), 50,
+          Histogram::kUmaTargetedHistogramFlag)),
       pending_tasks_available_cv_(&lock_),
       num_idle_threads_(0),
       terminated_(false),
@@ -156,6 +174,7 @@ void PosixDynamicThreadPool::AddTask(PendingTask* pending_task) {
 
   pending_tasks_.push(*pending_task);
   pending_task->task.Reset();
+  queue_depth_histogram_->Add(static_cast<int>(pending_tasks_.size()));
 
   // We have enough worker threads.
   if (static_cast<size_t>(num_idle_threads_) >= pending_tasks_.size()) {
@@ -193,6 +212,7 @@ PendingTask PosixDynamicThreadPool::WaitForTask() {
 
   PendingTask pending_task = pending_tasks_.front();
   pending_tasks_.pop();
+  queue_time_histogram_->AddTime(TimeTicks::Now() - pending_task.time_posted);
   return pending_task;
 }
 
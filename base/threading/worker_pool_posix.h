@@ -44,6 +44,8 @@ class Task;
 
 namespace base {
 
+class Histogram;
+
 class BASE_EXPORT PosixDynamicThreadPool
     : public RefCountedThreadSafe<PosixDynamicThreadPool> {
  public:
@@ -79,6 +81,13 @@ class BASE_EXPORT PosixDynamicThreadPool
   const std::string name_prefix_;
   const int idle_seconds_before_exit_;
 
+  // Histograms recording the queue depth seen by each PostTask() and the time
+  // tasks spend queued before a worker dequeues them, named after
+  // |name_prefix_|.  Histogram objects are never deleted, so raw pointers are
+  // safe here.
+  Histogram* queue_depth_histogram_;
+  Histogram* queue_time_histogram_;
+
   Lock lock_;  // Protects all the variables below.
 
   // Signal()s worker threads to let them know more tasks are available.
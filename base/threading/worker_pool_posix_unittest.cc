@@ -8,6 +8,7 @@
 
 #include "base/bind.h"
 #include "base/callback.h"
+#include "base/metrics/histogram.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
 #include "base/threading/platform_thread.h"
@@ -251,4 +252,36 @@ TEST_F(PosixDynamicThreadPoolTest, Complex) {
   EXPECT_EQ(4, counter_);
 }
 
+TEST_F(PosixDynamicThreadPoolTest, QueueMetricsRecorded) {
+  // The pool registers its histograms under its name prefix, so FactoryGet
+  // with matching parameters hands back the same objects.
+  Histogram* depth = Histogram::FactoryGet(
+      "dynamic_pool.QueueDepth", 1, 100, 50,
+      Histogram::kUmaTargetedHistogramFlag);
+  Histogram* queue_time = Histogram::FactoryTimeGet(
+      "dynamic_pool.QueueTime",
+      TimeDelta::FromMilliseconds(1), TimeDelta::FromSeconds(60), 50,
+      Histogram::kUmaTargetedHistogramFlag);
+  Histogram::SampleSet depth_before;
+  Histogram::SampleSet queue_time_before;
+  depth->SnapshotSample(&depth_before);
+  queue_time->SnapshotSample(&queue_time_before);
+
+  pool_->PostTask(FROM_HERE, CreateNewBlockingIncrementingTaskCallback());
+  pool_->PostTask(FROM_HERE, CreateNewBlockingIncrementingTaskCallback());
+  WaitForTasksToStart(2);
+  start_.Signal();
+  WaitForIdleThreads(2);
+
+  // Each post records one queue depth sample, and each dequeue records one
+  // queueing time sample.
+  Histogram::SampleSet depth_after;
+  Histogram::SampleSet queue_time_after;
+  depth->SnapshotSample(&depth_after);
+  queue_time->SnapshotSample(&queue_time_after);
+  EXPECT_EQ(depth_before.TotalCount() + 2, depth_after.TotalCount());
+  EXPECT_EQ(queue_time_before.TotalCount() + 2,
+            queue_time_after.TotalCount());
+}
+
 }  // namespace base
@@ -476,6 +476,13 @@ class BASE_EXPORT TimeTicks {
   // on hardware/operating system configuration.
   static TimeTicks Now();
 
+  // A cheaper version of Now() for callers that can tolerate millisecond
+  // granularity, e.g. high-frequency bookkeeping that only feeds relative
+  // comparisons.  On Linux this reads the value the kernel updates once per
+  // tick instead of computing a fresh timestamp, so it may lag Now() by up
+  // to a few milliseconds; on the other platforms it is the same as Now().
+  static TimeTicks CoarseNow();
+
   // Returns a platform-dependent high-resolution tick count. Implementation
   // is hardware dependent and may or may not return sub-millisecond
   // resolution.  THIS CALL IS GENERALLY MUCH MORE EXPENSIVE THAN Now() AND
@@ -143,6 +143,13 @@ TimeTicks TimeTicks::Now() {
   return TimeTicks(absolute_micro);
 }
 
+// static
+TimeTicks TimeTicks::CoarseNow() {
+  // mach_absolute_time() is already cheap; there is no coarser clock worth
+  // reading here.
+  return Now();
+}
+
 // static
 TimeTicks TimeTicks::HighResNow() {
   return Now();
@@ -8,6 +8,7 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <limits>
 
 #include "base/basictypes.h"
@@ -19,6 +20,15 @@
 #include "base/os_compat_nacl.h"
 #endif
 
+// The time-stamp counter fast path for TimeTicks::Now() below.
+#if defined(OS_LINUX) && defined(ARCH_CPU_X86_FAMILY)
+#define BASE_TIME_TICKS_USE_TSC 1
+#include "base/atomicops.h"
+#include "base/cpu.h"
+#include "base/lazy_instance.h"
+#include "base/synchronization/lock.h"
+#endif
+
 namespace base {
 
 #if defined(OS_ANDROID)
@@ -193,10 +203,190 @@ Time Time::FromExploded(bool is_local, const Exploded& exploded) {
      defined(_POSIX_MONOTONIC_CLOCK) && _POSIX_MONOTONIC_CLOCK >= 0) || \
      defined(OS_BSD) || defined(OS_ANDROID)
 
+#if defined(BASE_TIME_TICKS_USE_TSC)
+
+namespace {
+
+// Reads the CPU's time-stamp counter.
+uint64 ReadTSC() {
+#if defined(ARCH_CPU_X86_64)
+  uint32 tsc_lo, tsc_hi;
+  __asm__ __volatile__("rdtsc" : "=a" (tsc_lo), "=d" (tsc_hi));
+  return (static_cast<uint64>(tsc_hi) << 32) | tsc_lo;
+#else
+  uint64 tsc;
+  __asm__ __volatile__("rdtsc" : "=A" (tsc));
+  return tsc;
+#endif
+}
+
+int64 ClockMonotonicNow() {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+    NOTREACHED() << "clock_gettime(CLOCK_MONOTONIC) failed.";
+    return 0;
+  }
+  return (static_cast<int64>(ts.tv_sec) * Time::kMicrosecondsPerSecond) +
+         (static_cast<int64>(ts.tv_nsec) / Time::kNanosecondsPerMicrosecond);
+}
+
+// An anchor reading of CLOCK_MONOTONIC paired with the TSC value taken at the
+// same moment, plus the measured tick rate. Instances are immutable once
+// published; a refinement publishes a replacement.
+struct TSCCalibration {
+  int64 Extrapolate(uint64 tsc) const {
+    return base_micros + static_cast<int64>(
+        static_cast<double>(tsc - base_tsc) / ticks_per_micro);
+  }
+
+  uint64 base_tsc;
+  int64 base_micros;
+  double ticks_per_micro;
+
+  // Extrapolated time at which the rate should be re-measured over the then
+  // ten times longer window, or 0 once the final calibration is in place.
+  int64 refine_at_micros;
+};
+
+// The rate measurement window grows from the initial to the final size by
+// factors of ten; each refinement shrinks the relative error of the measured
+// rate, and with it the drift of extrapolated readings, by the same factor.
+const int64 kInitialCalibrationWindowMicros =
+    100 * Time::kMicrosecondsPerMillisecond;
+const int64 kFinalCalibrationWindowMicros =
+    100 * Time::kMicrosecondsPerSecond;
+
+// Produces tick readings from the CPU's invariant time-stamp counter instead
+// of calling clock_gettime(), which costs a vDSO transition per call. The
+// counter is anchored to CLOCK_MONOTONIC once at startup and its rate is
+// measured over progressively longer windows, so readings converge on the
+// kernel's clock while each one stays a register read plus some arithmetic.
+class TSCClock {
+ public:
+  TSCClock()
+      : calibration_(0),
+        disabled_(0),
+        first_tsc_(0),
+        first_micros_(0) {
+  }
+
+  // Produces a tick reading on the fast path. Returns false until the
+  // counter has been calibrated (or when it cannot be used at all), in which
+  // case the caller should read CLOCK_MONOTONIC itself.
+  bool Now(int64* out_micros) {
+    const TSCCalibration* calibration =
+        reinterpret_cast<const TSCCalibration*>(
+            subtle::Acquire_Load(&calibration_));
+    if (!calibration)
+      return Calibrate();
+
+    int64 micros = calibration->Extrapolate(ReadTSC());
+    if (calibration->refine_at_micros &&
+        micros >= calibration->refine_at_micros) {
+      Refine(calibration);
+      calibration = reinterpret_cast<const TSCCalibration*>(
+          subtle::Acquire_Load(&calibration_));
+      micros = calibration->Extrapolate(ReadTSC());
+    }
+    *out_micros = micros;
+    return true;
+  }
+
+ private:
+  // Takes the startup anchor on the first call and publishes the initial
+  // calibration once the first measurement window has elapsed. Always
+  // returns false so that callers keep using CLOCK_MONOTONIC meanwhile.
+  bool Calibrate() {
+    if (subtle::NoBarrier_Load(&disabled_))
+      return false;
+
+    AutoLock locked(lock_);
+    if (subtle::NoBarrier_Load(&disabled_) ||
+        subtle::NoBarrier_Load(&calibration_)) {
+      return false;
+    }
+
+    if (!first_tsc_) {
+      // A counter that stops in deep sleep states or changes rate with
+      // frequency scaling cannot back a monotonic clock.
+      if (!CPU().has_non_stop_time_stamp_counter()) {
+        subtle::NoBarrier_Store(&disabled_, 1);
+        return false;
+      }
+      first_tsc_ = ReadTSC();
+      first_micros_ = ClockMonotonicNow();
+      return false;
+    }
+
+    uint64 tsc = ReadTSC();
+    int64 now = ClockMonotonicNow();
+    if (now - first_micros_ >= kInitialCalibrationWindowMicros)
+      Publish(tsc, now, now);
+    return false;
+  }
+
+  // Re-measures the tick rate over the (longer) window elapsed since the
+  // startup anchor and publishes the result.
+  void Refine(const TSCCalibration* expected) {
+    AutoLock locked(lock_);
+    if (subtle::NoBarrier_Load(&calibration_) !=
+        reinterpret_cast<subtle::AtomicWord>(expected)) {
+      return;  // Another thread already refined this calibration.
+    }
+
+    uint64 tsc = ReadTSC();
+    int64 now = ClockMonotonicNow();
+    // Never anchor behind what the outgoing calibration would have returned,
+    // so readings do not step backwards across the switch.
+    Publish(tsc, std::max(now, expected->Extrapolate(tsc)), now);
+  }
+
+  // Must be called with |lock_| held, with |tsc| and |now| read together.
+  void Publish(uint64 tsc, int64 base_micros, int64 now) {
+    TSCCalibration* calibration = new TSCCalibration;
+    calibration->base_tsc = tsc;
+    calibration->base_micros = base_micros;
+    calibration->ticks_per_micro =
+        static_cast<double>(tsc - first_tsc_) /
+        static_cast<double>(now - first_micros_);
+    int64 window = now - first_micros_;
+    calibration->refine_at_micros = window >= kFinalCalibrationWindowMicros ?
+        0 : base_micros + 9 * window;
+    // The outgoing calibration is intentionally leaked: other threads may
+    // still be reading through it, and only a handful of instances are ever
+    // created per process.
+    subtle::Release_Store(&calibration_,
+                          reinterpret_cast<subtle::AtomicWord>(calibration));
+  }
+
+  subtle::AtomicWord calibration_;  // const TSCCalibration*, NULL until the
+                                    // initial calibration is published.
+  subtle::Atomic32 disabled_;       // Set when the TSC is not usable.
+
+  // Guards the startup anchor below and transitions of |calibration_|.
+  Lock lock_;
+  uint64 first_tsc_;
+  int64 first_micros_;
+
+  DISALLOW_COPY_AND_ASSIGN(TSCClock);
+};
+
+LazyInstance<TSCClock>::Leaky g_tsc_clock = LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+#endif  // BASE_TIME_TICKS_USE_TSC
+
 // static
 TimeTicks TimeTicks::Now() {
   uint64_t absolute_micro;
 
+#if defined(BASE_TIME_TICKS_USE_TSC)
+  int64 tsc_micros;
+  if (g_tsc_clock.Get().Now(&tsc_micros))
+    return TimeTicks(tsc_micros);
+#endif
+
   struct timespec ts;
   if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
     NOTREACHED() << "clock_gettime(CLOCK_MONOTONIC) failed.";
@@ -228,6 +418,22 @@ TimeTicks TimeTicks::HighResNow() {
   return Now();
 }
 
+// static
+TimeTicks TimeTicks::CoarseNow() {
+#if defined(CLOCK_MONOTONIC_COARSE)
+  // Reads the value the kernel updates once per tick, which does not need a
+  // fresh timestamp computation. Old kernels do not support the clock; fall
+  // through to Now() there.
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC_COARSE, &ts) == 0) {
+    return TimeTicks(
+        (static_cast<int64>(ts.tv_sec) * Time::kMicrosecondsPerSecond) +
+        (static_cast<int64>(ts.tv_nsec) / Time::kNanosecondsPerMicrosecond));
+  }
+#endif
+  return Now();
+}
+
 #if defined(OS_POSIX) && defined(CLOCK_SYSTEM_TRACE)
 
 // static
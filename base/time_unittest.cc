@@ -464,6 +464,27 @@ TEST(TimeTicks, Deltas) {
   }
 }
 
+TEST(TimeTicks, NowIsMonotonic) {
+  // Successive readings must never go backwards, whichever clock source
+  // backs Now() on this machine.
+  TimeTicks previous = TimeTicks::Now();
+  for (int index = 0; index < 100000; index++) {
+    TimeTicks now = TimeTicks::Now();
+    EXPECT_LE(previous, now);
+    previous = now;
+  }
+}
+
+TEST(TimeTicks, CoarseNow) {
+  // CoarseNow() may lag Now() by the kernel tick, but should never be ahead
+  // of it and should stay within a few ticks behind.
+  TimeTicks start = TimeTicks::Now();
+  TimeTicks coarse = TimeTicks::CoarseNow();
+  TimeTicks end = TimeTicks::Now();
+  EXPECT_LE(coarse, end);
+  EXPECT_GE(coarse, start - TimeDelta::FromMilliseconds(50));
+}
+
 static void HighResClockTest(TimeTicks (*GetTicks)()) {
 #if defined(OS_WIN)
   // HighResNow doesn't work on some systems.  Since the product still works
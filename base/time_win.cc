@@ -430,6 +430,12 @@ TimeTicks TimeTicks::Now() {
   return TimeTicks() + RolloverProtectedNow();
 }
 
+// static
+TimeTicks TimeTicks::CoarseNow() {
+  // Now() is already just a rollover-protected timeGetTime() here.
+  return Now();
+}
+
 // static
 TimeTicks TimeTicks::HighResNow() {
   return TimeTicks() + HighResNowSingleton::GetInstance()->Now();
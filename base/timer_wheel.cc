@@ -0,0 +1,198 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/timer_wheel.h"
+
+#include "base/logging.h"
+
+namespace base {
+
+namespace {
+
+const int64 kMicrosecondsPerTick = 1000;  // 1ms ticks.
+
+// Index of the lowest set bit.  Callers guarantee |bits| is non-zero.
+int CountTrailingZeros(uint64 bits) {
+  DCHECK(bits);
+  int n = 0;
+  while (!(bits & 1)) {
+    bits >>= 1;
+    ++n;
+  }
+  return n;
+}
+
+}  // namespace
+
+TimerWheel::TimerWheel()
+    : current_tick_(TimeTicks::Now().ToInternalValue() / kMicrosecondsPerTick),
+      size_(0) {
+  for (int level = 0; level < kNumLevels; ++level)
+    occupied_[level] = 0;
+}
+
+TimerWheel::~TimerWheel() {
+}
+
+// static
+int64 TimerWheel::DueTick(TimeTicks time) {
+  // Round up so a task is never considered due before its deadline.
+  return (time.ToInternalValue() + kMicrosecondsPerTick - 1) /
+      kMicrosecondsPerTick;
+}
+
+// static
+TimeTicks TimerWheel::TickToTime(int64 tick) {
+  return TimeTicks::FromInternalValue(tick * kMicrosecondsPerTick);
+}
+
+void TimerWheel::Push(const PendingTask& task) {
+  Dispatch(task, DueTick(task.delayed_run_time));
+  ++size_;
+}
+
+bool TimerWheel::PopReady(TimeTicks now, PendingTask* task) {
+  // Floor: tick N's deadline has passed once |now| reaches N ms exactly.
+  AdvanceTo(now.ToInternalValue() / kMicrosecondsPerTick);
+  if (ready_.empty())
+    return false;
+  *task = ready_.front();
+  ready_.pop_front();
+  --size_;
+  return true;
+}
+
+bool TimerWheel::PopAny(PendingTask* task) {
+  if (!ready_.empty()) {
+    *task = ready_.front();
+    ready_.pop_front();
+    --size_;
+    return true;
+  }
+  for (int level = 0; level < kNumLevels; ++level) {
+    if (!occupied_[level])
+      continue;
+    int index = CountTrailingZeros(occupied_[level]);
+    TaskList* slot = &slots_[level][index];
+    *task = slot->front();
+    slot->pop_front();
+    if (slot->empty())
+      occupied_[level] &= ~(GG_UINT64_C(1) << index);
+    --size_;
+    return true;
+  }
+  return false;
+}
+
+TimeTicks TimerWheel::next_run_time() const {
+  DCHECK(!empty());
+  if (!ready_.empty())
+    return TickToTime(current_tick_);
+  int64 tick = NextExpiryTick();
+  DCHECK_GE(tick, 0);
+  return TickToTime(tick);
+}
+
+void TimerWheel::Dispatch(const PendingTask& task, int64 due_tick) {
+  int64 delta = due_tick - current_tick_;
+  if (delta <= 0) {
+    ready_.push_back(task);
+    return;
+  }
+
+  // Pick the level whose span covers |delta|.
+  int level = 0;
+  int64 span = kSlotsPerLevel;
+  while (level < kNumLevels - 1 && delta >= span) {
+    span <<= kBitsPerLevel;
+    ++level;
+  }
+
+  int shift = kBitsPerLevel * level;
+  int index;
+  if (delta >= span) {
+    // Beyond the wheel's reach: park in the furthest top-level slot; the
+    // task will cascade (and be re-parked if needed) as the cursor turns.
+    index = static_cast<int>(
+        ((current_tick_ >> shift) + kSlotsPerLevel - 1) & (kSlotsPerLevel - 1));
+  } else {
+    index = static_cast<int>((due_tick >> shift) & (kSlotsPerLevel - 1));
+    // A task nearly a full rotation ahead maps onto the cursor's own slot
+    // index; escalate a level so that an occupied slot at the cursor index
+    // always means "expire now" and AdvanceTo() cannot spin.
+    while (index == static_cast<int>(
+               (current_tick_ >> shift) & (kSlotsPerLevel - 1))) {
+      if (level == kNumLevels - 1) {
+        index = (index + kSlotsPerLevel - 1) & (kSlotsPerLevel - 1);
+        break;
+      }
+      ++level;
+      shift += kBitsPerLevel;
+      index = static_cast<int>((due_tick >> shift) & (kSlotsPerLevel - 1));
+    }
+  }
+  slots_[level][index].push_back(task);
+  occupied_[level] |= GG_UINT64_C(1) << index;
+}
+
+void TimerWheel::AdvanceTo(int64 target_tick) {
+  while (current_tick_ < target_tick) {
+    int64 next = NextExpiryTick();
+    if (next < 0 || next > target_tick) {
+      current_tick_ = target_tick;
+      return;
+    }
+    current_tick_ = next;
+    // Expire lowest levels first so exact deadlines reach |ready_| in order
+    // before coarser slots cascade down.
+    for (int level = 0; level < kNumLevels; ++level) {
+      int shift = kBitsPerLevel * level;
+      int index = static_cast<int>(
+          (current_tick_ >> shift) & (kSlotsPerLevel - 1));
+      if (occupied_[level] & (GG_UINT64_C(1) << index))
+        ExpireSlot(level, index);
+    }
+  }
+}
+
+int64 TimerWheel::NextExpiryTick() const {
+  int64 best = -1;
+  for (int level = 0; level < kNumLevels; ++level) {
+    uint64 bits = occupied_[level];
+    if (!bits)
+      continue;
+    int shift = kBitsPerLevel * level;
+    int cur = static_cast<int>(
+        (current_tick_ >> shift) & (kSlotsPerLevel - 1));
+    // Rotate so bit 0 is the cursor's slot, then the lowest set bit gives
+    // the forward distance to the nearest occupied slot.
+    uint64 rotated = cur ?
+        ((bits >> cur) | (bits << (kSlotsPerLevel - cur))) : bits;
+    int dist = CountTrailingZeros(rotated);
+    int64 tick;
+    if (level == 0) {
+      // Level-0 slots hold exact ticks within the current rotation.
+      tick = current_tick_ + dist;
+    } else if (dist == 0) {
+      // Cursor is already inside an occupied slot; cascade immediately.
+      tick = current_tick_;
+    } else {
+      // Cascade when the cursor reaches the slot's leading edge.
+      tick = ((current_tick_ >> shift) + dist) << shift;
+    }
+    if (best < 0 || tick < best)
+      best = tick;
+  }
+  return best;
+}
+
+void TimerWheel::ExpireSlot(int level, int index) {
+  TaskList expired;
+  expired.swap(slots_[level][index]);
+  occupied_[level] &= ~(GG_UINT64_C(1) << index);
+  for (TaskList::iterator it = expired.begin(); it != expired.end(); ++it)
+    Dispatch(*it, DueTick(it->delayed_run_time));
+}
+
+}  // namespace base
@@ -0,0 +1,105 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TIMER_WHEEL_H_
+#define BASE_TIMER_WHEEL_H_
+#pragma once
+
+#include <list>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/pending_task.h"
+#include "base/time.h"
+
+namespace base {
+
+// A hierarchical timer wheel holding PendingTasks, used by MessageLoop as an
+// alternative to the std::priority_queue based DelayedTaskQueue.  Insertion
+// is O(1) (a shift and a list append) regardless of the number of pending
+// tasks, which matters for loops carrying tens of thousands of timeouts.
+//
+// Time is quantized into 1ms ticks.  The wheel has kNumLevels levels of
+// kSlotsPerLevel slots each; level L spans deltas in
+// [kSlotsPerLevel^L, kSlotsPerLevel^(L+1)) ticks.  When the cursor crosses
+// into a higher-level slot its tasks are re-dispatched ("cascaded") into
+// lower levels.  Per-slot occupancy bitmaps let AdvanceTo() jump over empty
+// regions, so an idle wheel costs nothing to catch up.
+//
+// Tasks never run before their delayed_run_time: due ticks are rounded up,
+// so next_run_time() is always at or after the earliest task's deadline.
+// All methods must be called on the owning MessageLoop's thread.
+class BASE_EXPORT TimerWheel {
+ public:
+  TimerWheel();
+  ~TimerWheel();
+
+  // Adds |task| to the wheel, keyed by task.delayed_run_time.
+  void Push(const PendingTask& task);
+
+  // Advances the wheel to |now| and, if a task has come due, pops the
+  // earliest one into |task| and returns true.
+  bool PopReady(TimeTicks now, PendingTask* task);
+
+  // Pops any remaining task regardless of deadline (used when tearing down a
+  // loop).  Returns false if the wheel is empty.
+  bool PopAny(PendingTask* task);
+
+  // Earliest time at which PopReady() may return a task.  Must not be called
+  // on an empty wheel.  The result can precede the actual earliest deadline
+  // by less than the width of the containing slot; waking then simply
+  // cascades and re-arms.
+  TimeTicks next_run_time() const;
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+ private:
+  static const int kBitsPerLevel = 6;
+  static const int kSlotsPerLevel = 1 << kBitsPerLevel;  // 64
+  static const int kNumLevels = 4;  // 64^4 ticks ~= 4.6 hours of reach.
+
+  typedef std::list<PendingTask> TaskList;
+
+  // Converts between TimeTicks and 1ms wheel ticks.  Due ticks round up so
+  // tasks cannot fire early.
+  static int64 DueTick(TimeTicks time);
+  static TimeTicks TickToTime(int64 tick);
+
+  // Files a task due at |due_tick| into the level selected by its distance
+  // from |current_tick_|, or straight onto |ready_| if already due.
+  void Dispatch(const PendingTask& task, int64 due_tick);
+
+  // Moves the cursor forward to |target_tick|, expiring and cascading every
+  // occupied slot it passes.  Skips empty regions via the bitmaps.
+  void AdvanceTo(int64 target_tick);
+
+  // Smallest tick at which some slot must be expired or cascaded, or -1 if
+  // nothing is pending outside |ready_|.
+  int64 NextExpiryTick() const;
+
+  // Empties the slot at (|level|, |index|), re-dispatching its tasks.
+  void ExpireSlot(int level, int index);
+
+  // One ms-granularity cursor into the wheel.
+  int64 current_tick_;
+
+  // slots_[level][index]; each list keeps push order, which within a level-0
+  // slot is sequence order.
+  TaskList slots_[kNumLevels][kSlotsPerLevel];
+
+  // Bit i set iff slots_[level][i] is non-empty.
+  uint64 occupied_[kNumLevels];
+
+  // Tasks whose deadline has passed, in expiry order.
+  TaskList ready_;
+
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+}  // namespace base
+
+#endif  // BASE_TIMER_WHEEL_H_
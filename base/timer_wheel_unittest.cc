@@ -0,0 +1,119 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/timer_wheel.h"
+
+#include "base/bind.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+void DoNothing() {
+}
+
+PendingTask MakeTask(TimeTicks run_time, int sequence_num) {
+  PendingTask task(FROM_HERE, Bind(&DoNothing), run_time, true);
+  task.sequence_num = sequence_num;
+  return task;
+}
+
+}  // namespace
+
+TEST(TimerWheelTest, PopInDeadlineOrder) {
+  TimerWheel wheel;
+  TimeTicks now = TimeTicks::Now();
+
+  wheel.Push(MakeTask(now + TimeDelta::FromMilliseconds(30), 1));
+  wheel.Push(MakeTask(now + TimeDelta::FromMilliseconds(10), 2));
+  wheel.Push(MakeTask(now + TimeDelta::FromMilliseconds(20), 3));
+  EXPECT_EQ(3u, wheel.size());
+
+  PendingTask task(FROM_HERE, Closure());
+  EXPECT_FALSE(wheel.PopReady(now, &task));
+
+  EXPECT_TRUE(wheel.PopReady(now + TimeDelta::FromMilliseconds(50), &task));
+  EXPECT_EQ(2, task.sequence_num);
+  EXPECT_TRUE(wheel.PopReady(now + TimeDelta::FromMilliseconds(50), &task));
+  EXPECT_EQ(3, task.sequence_num);
+  EXPECT_TRUE(wheel.PopReady(now + TimeDelta::FromMilliseconds(50), &task));
+  EXPECT_EQ(1, task.sequence_num);
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, NeverFiresEarly) {
+  TimerWheel wheel;
+  TimeTicks now = TimeTicks::Now();
+  TimeTicks run_time = now + TimeDelta::FromMilliseconds(100);
+
+  wheel.Push(MakeTask(run_time, 1));
+  EXPECT_GE(wheel.next_run_time(), run_time);
+
+  PendingTask task(FROM_HERE, Closure());
+  EXPECT_FALSE(wheel.PopReady(run_time - TimeDelta::FromMilliseconds(1),
+                              &task));
+  EXPECT_TRUE(wheel.PopReady(run_time, &task));
+}
+
+TEST(TimerWheelTest, SameDeadlineKeepsSequenceOrder) {
+  TimerWheel wheel;
+  TimeTicks now = TimeTicks::Now();
+  TimeTicks run_time = now + TimeDelta::FromMilliseconds(5);
+
+  for (int i = 0; i < 10; ++i)
+    wheel.Push(MakeTask(run_time, i));
+
+  PendingTask task(FROM_HERE, Closure());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(wheel.PopReady(run_time, &task));
+    EXPECT_EQ(i, task.sequence_num);
+  }
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, CascadesAcrossLevels) {
+  TimerWheel wheel;
+  TimeTicks now = TimeTicks::Now();
+
+  // One task per level of the wheel, plus one beyond its reach.
+  wheel.Push(MakeTask(now + TimeDelta::FromMilliseconds(3), 1));
+  wheel.Push(MakeTask(now + TimeDelta::FromMilliseconds(500), 2));
+  wheel.Push(MakeTask(now + TimeDelta::FromSeconds(90), 3));
+  wheel.Push(MakeTask(now + TimeDelta::FromHours(2), 4));
+  wheel.Push(MakeTask(now + TimeDelta::FromHours(20), 5));
+
+  PendingTask task(FROM_HERE, Closure());
+  EXPECT_TRUE(wheel.PopReady(now + TimeDelta::FromSeconds(1), &task));
+  EXPECT_EQ(1, task.sequence_num);
+  EXPECT_TRUE(wheel.PopReady(now + TimeDelta::FromSeconds(1), &task));
+  EXPECT_EQ(2, task.sequence_num);
+  EXPECT_FALSE(wheel.PopReady(now + TimeDelta::FromSeconds(1), &task));
+
+  EXPECT_TRUE(wheel.PopReady(now + TimeDelta::FromSeconds(100), &task));
+  EXPECT_EQ(3, task.sequence_num);
+  EXPECT_TRUE(wheel.PopReady(now + TimeDelta::FromHours(3), &task));
+  EXPECT_EQ(4, task.sequence_num);
+  EXPECT_TRUE(wheel.PopReady(now + TimeDelta::FromHours(21), &task));
+  EXPECT_EQ(5, task.sequence_num);
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, PopAnyDrainsEverything) {
+  TimerWheel wheel;
+  TimeTicks now = TimeTicks::Now();
+
+  wheel.Push(MakeTask(now + TimeDelta::FromMilliseconds(1), 1));
+  wheel.Push(MakeTask(now + TimeDelta::FromSeconds(10), 2));
+  wheel.Push(MakeTask(now + TimeDelta::FromHours(10), 3));
+
+  PendingTask task(FROM_HERE, Closure());
+  int drained = 0;
+  while (wheel.PopAny(&task))
+    ++drained;
+  EXPECT_EQ(3, drained);
+  EXPECT_TRUE(wheel.empty());
+}
+
+}  // namespace base
@@ -229,10 +229,14 @@ base::LazyInstance<base::Lock>::Leaky
 // static
 ThreadData::Status ThreadData::status_ = ThreadData::UNINITIALIZED;
 
+// static
+int ThreadData::sampling_interval_ = 1;
+
 ThreadData::ThreadData(const std::string& suggested_name)
     : next_(NULL),
       next_retired_worker_(NULL),
       worker_thread_number_(0),
+      sample_countdown_(1),
       incarnation_count_for_pool_(-1) {
   DCHECK_GE(suggested_name.size(), 0u);
   thread_name_ = suggested_name;
@@ -243,6 +247,7 @@ ThreadData::ThreadData(int thread_number)
     : next_(NULL),
       next_retired_worker_(NULL),
       worker_thread_number_(thread_number),
+      sample_countdown_(1),
       incarnation_count_for_pool_(-1)  {
   CHECK_GT(thread_number, 0);
   base::StringAppendF(&thread_name_, "WorkerThread-%d", thread_number);
@@ -438,6 +443,15 @@ Births* ThreadData::TallyABirthIfActive(const Location& location) {
   ThreadData* current_thread_data = Get();
   if (!current_thread_data)
     return NULL;
+
+  // In sampled mode, track only one birth in sampling_interval_ on each
+  // thread.  Untracked tasks carry a NULL birth tally, so their deaths are
+  // skipped as well and the recorded data stays internally consistent.
+  if (sampling_interval_ > 1) {
+    if (--current_thread_data->sample_countdown_ > 0)
+      return NULL;
+    current_thread_data->sample_countdown_ = sampling_interval_;
+  }
   return current_thread_data->TallyABirth(location);
 }
 
@@ -721,6 +735,17 @@ ThreadData::Status ThreadData::status() {
   return status_;
 }
 
+// static
+void ThreadData::set_sampling_interval(int interval) {
+  DCHECK_GE(interval, 1);
+  sampling_interval_ = interval;
+}
+
+// static
+int ThreadData::sampling_interval() {
+  return sampling_interval_;
+}
+
 // static
 bool ThreadData::TrackingStatus() {
   return status_ > DEACTIVATED;
@@ -801,6 +826,7 @@ void ThreadData::ShutdownSingleThreadedCleanup(bool leak) {
   cleanup_count_ = 0;
   tls_index_.Set(NULL);
   status_ = DORMANT_DURING_TESTS;  // Almost UNINITIALIZED.
+  sampling_interval_ = 1;
 
   // To avoid any chance of racing in unit tests, which is the only place we
   // call this function, we may sometimes leak all the data structures we
@@ -15,6 +15,7 @@
 
 #include "base/base_export.h"
 #include "base/gtest_prod_util.h"
+#include "base/hash_tables.h"
 #include "base/lazy_instance.h"
 #include "base/location.h"
 #include "base/profiler/alternate_timer.h"
@@ -188,6 +189,42 @@
 // DeathData that is reset (as synchronously as possible) during each snapshot.
 // This will facilitate displaying a max value for each snapshot period.
 
+namespace tracked_objects {
+class Births;
+}
+
+// Hash functions so that the birth and death maps below can be hash tables
+// rather than trees.  Each tracked task performs one lookup in each map, so
+// making those lookups O(1) instead of O(log n) pointer comparisons is a
+// direct reduction of the always-on profiling overhead.
+namespace BASE_HASH_NAMESPACE {
+#if defined(COMPILER_GCC)
+
+template <>
+struct hash<tracked_objects::Location> {
+  std::size_t operator()(const tracked_objects::Location& location) const {
+    return location.Hash();
+  }
+};
+
+template <>
+struct hash<const tracked_objects::Births*> {
+  std::size_t operator()(const tracked_objects::Births* birth) const {
+    // Births are individually heap-allocated; ignore the low bits of the
+    // pointer, which are always zero.
+    return reinterpret_cast<uintptr_t>(birth) >> 4;
+  }
+};
+
+#elif defined(COMPILER_MSVC)
+
+inline size_t hash_value(const tracked_objects::Location& location) {
+  return location.Hash();
+}
+
+#endif  // COMPILER
+}  // namespace BASE_HASH_NAMESPACE
+
 namespace tracked_objects {
 
 //------------------------------------------------------------------------------
@@ -362,8 +399,8 @@ class BASE_EXPORT ThreadData {
     PROFILING_CHILDREN_ACTIVE,  // Fully active, recording parent-child links.
   };
 
-  typedef std::map<Location, Births*> BirthMap;
-  typedef std::map<const Births*, DeathData> DeathMap;
+  typedef base::hash_map<Location, Births*> BirthMap;
+  typedef base::hash_map<const Births*, DeathData> DeathMap;
   typedef std::pair<const Births*, const Births*> ParentChildPair;
   typedef std::set<ParentChildPair> ParentChildSet;
   typedef std::stack<const Births*> ParentStack;
@@ -449,6 +486,15 @@ class BASE_EXPORT ThreadData {
 
   static Status status();
 
+  // Sets the sampling interval: when |interval| is greater than one, only
+  // one birth in |interval| (per thread) is tracked, and the corresponding
+  // deaths are the only ones tallied.  This shrinks the tracking overhead
+  // proportionally so profiling can stay enabled in production; displayed
+  // counts are then approximately 1/interval of the true task counts.  An
+  // |interval| of one (the default) tracks everything.
+  static void set_sampling_interval(int interval);
+  static int sampling_interval();
+
   // Indicate if any sort of profiling is being done (i.e., we are more than
   // DEACTIVATED).
   static bool TrackingStatus();
@@ -616,6 +662,11 @@ class BASE_EXPORT ThreadData {
   // We set status_ to SHUTDOWN when we shut down the tracking service.
   static Status status_;
 
+  // When greater than one, only 1-in-sampling_interval_ births (per thread)
+  // are tracked.  Written while single threaded (startup/flag parsing), read
+  // on every birth.
+  static int sampling_interval_;
+
   // Link to next instance (null terminated list). Used to globally track all
   // registered instances (corresponds to all registered threads where we keep
   // data).
@@ -671,6 +722,11 @@ class BASE_EXPORT ThreadData {
   // significant additional cost).
   ParentStack parent_stack_;
 
+  // Countdown until this thread tracks its next birth, used when the
+  // sampling interval is greater than one.  Initialized to one so that the
+  // first birth on each thread is always tracked.
+  int sample_countdown_;
+
   // A random number that we used to select decide which sample to keep as a
   // representative sample in each DeathData instance.  We can't start off with
   // much randomness (because we can't call RandInt() on all our threads), so
@@ -131,6 +131,29 @@ TEST_F(TrackedObjectsTest, MinimalStartupShutdown) {
   EXPECT_EQ(0u, parent_child_set.size());
 }
 
+TEST_F(TrackedObjectsTest, SampledTracking) {
+  if (!ThreadData::InitializeAndSetTrackingStatus(
+          ThreadData::PROFILING_ACTIVE))
+    return;
+
+  // With 1-in-4 sampling, 8 births at one location should tally the first
+  // birth on this thread and then every fourth, i.e. 2 tracked births.
+  ThreadData::set_sampling_interval(4);
+  EXPECT_EQ(4, ThreadData::sampling_interval());
+
+  Location location(__FUNCTION__, kFile, kLineNumber, NULL);
+  int tracked = 0;
+  for (int i = 0; i < 8; ++i) {
+    if (ThreadData::TallyABirthIfActive(location))
+      ++tracked;
+  }
+  EXPECT_EQ(2, tracked);
+
+  // Shutdown (via Reset) must restore the default interval.
+  Reset();
+  EXPECT_EQ(1, ThreadData::sampling_interval());
+}
+
 TEST_F(TrackedObjectsTest, TinyStartupShutdown) {
   if (!ThreadData::InitializeAndSetTrackingStatus(
           ThreadData::PROFILING_CHILDREN_ACTIVE))
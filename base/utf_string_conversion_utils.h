@@ -10,6 +10,12 @@
 
 #include "base/base_export.h"
 #include "base/string16.h"
+#include "build/build_config.h"
+
+#if defined(__SSE2__) || (defined(COMPILER_MSVC) && defined(ARCH_CPU_X86_64))
+#define BASE_UTF_CONVERSIONS_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
 
 namespace base {
 
@@ -29,6 +35,46 @@ inline bool IsValidCharacter(uint32 code_point) {
       code_point <= 0x10FFFFu && (code_point & 0xFFFEu) != 0xFFFEu);
 }
 
+// Returns the length of the leading all-ASCII run of |src|.  ASCII code
+// points encode identically in UTF-8, UTF-16 and UTF-32, so such a run can
+// be copied to any destination string verbatim, and is always valid without
+// per-code point checks.  Where SSE2 is available the scan checks 16 bytes
+// per iteration instead of looking at one unit at a time.
+template<typename CHAR>
+size_t AsciiRunLength(const CHAR* src, size_t src_len) {
+  size_t i = 0;
+#if defined(BASE_UTF_CONVERSIONS_HAVE_SSE2)
+  if (sizeof(CHAR) == 1) {
+    // UTF-8: all ASCII iff no byte has the high bit set.
+    while (i + 16 <= src_len) {
+      __m128i chunk = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(src + i));
+      if (_mm_movemask_epi8(chunk))
+        break;
+      i += 16;
+    }
+  } else if (sizeof(CHAR) == 2) {
+    // UTF-16: a unit is ASCII iff every bit above 0x7F is clear.
+    const __m128i non_ascii_bits = _mm_set1_epi16(static_cast<int16>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    while (i + 8 <= src_len) {
+      __m128i chunk = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(src + i));
+      __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(chunk, non_ascii_bits),
+                                      zero);
+      if (_mm_movemask_epi8(ascii) != 0xFFFF)
+        break;
+      i += 8;
+    }
+  }
+#endif
+  for (; i < src_len; ++i) {
+    if ((static_cast<uint32>(src[i]) & ~0x7Fu) != 0)
+      break;
+  }
+  return i;
+}
+
 // ReadUnicodeCharacter --------------------------------------------------------
 
 // Reads a UTF-8 stream, placing the next code point into the given output
@@ -7,7 +7,9 @@
 #include "base/string_piece.h"
 #include "base/string_util.h"
 #include "base/utf_string_conversion_utils.h"
+#include "build/build_config.h"
 
+using base::AsciiRunLength;
 using base::PrepareForUTF8Output;
 using base::PrepareForUTF16Or32Output;
 using base::ReadUnicodeCharacter;
@@ -29,6 +31,16 @@ bool ConvertUnicode(const SRC_CHAR* src,
   bool success = true;
   int32 src_len32 = static_cast<int32>(src_len);
   for (int32 i = 0; i < src_len32; i++) {
+    // Bulk-copy ASCII runs, which dominate typical inputs; only non-ASCII
+    // code points go through the per-character decoder below.
+    int32 run = static_cast<int32>(AsciiRunLength(src + i, src_len32 - i));
+    if (run) {
+      output->append(src + i, src + i + run);
+      i += run;
+      if (i >= src_len32)
+        break;
+    }
+
     uint32 code_point;
     if (ReadUnicodeCharacter(src, src_len32, &i, &code_point)) {
       WriteUnicodeCharacter(code_point, output);
@@ -208,4 +208,32 @@ TEST(UTFStringConversionsTest, ConvertMultiString) {
   EXPECT_EQ(expected, converted);
 }
 
+TEST(UTFStringConversionsTest, ConvertLongAsciiStrings) {
+  // Exercises the vectorized ASCII run handling with lengths around and well
+  // past the 16-byte chunk size, including non-chunk-aligned tails.
+  for (size_t len = 1; len < 300; ++len) {
+    std::string ascii;
+    for (size_t i = 0; i < len; ++i)
+      ascii.push_back(static_cast<char>('!' + (i % 90)));
+    string16 utf16 = UTF8ToUTF16(ascii);
+    ASSERT_EQ(len, utf16.length());
+    EXPECT_EQ(ascii, UTF16ToUTF8(utf16));
+  }
+}
+
+TEST(UTFStringConversionsTest, ConvertAsciiRunsAroundNonAscii) {
+  // Non-ASCII code points at chunk boundaries must not disturb the
+  // surrounding ASCII runs.
+  const char kSnowman[] = "\xE2\x98\x83";
+  for (size_t pos = 0; pos < 40; ++pos) {
+    std::string input(pos, 'a');
+    input += kSnowman;
+    input.append(40 - pos, 'b');
+    string16 utf16 = UTF8ToUTF16(input);
+    ASSERT_EQ(41u, utf16.length());
+    EXPECT_EQ(static_cast<char16>(0x2603), utf16[pos]);
+    EXPECT_EQ(input, UTF16ToUTF8(utf16));
+  }
+}
+
 }  // base
@@ -0,0 +1,127 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/value_arena.h"
+
+#include <stdlib.h>
+
+#include "base/logging.h"
+#include "base/threading/thread_local_storage.h"
+
+namespace base {
+
+namespace {
+
+// Per-thread state tying Value's class-level operator new/delete to the
+// active arena.  operator new cannot write into the object (the constructor
+// has not run) and operator delete cannot read from it (the destructor has
+// already run), so the origin of an allocation is handed from operator new
+// to the Value constructor, and from the Value destructor to operator
+// delete, through these flags.  Both handoffs are immediate on the same
+// thread, so no other allocation can interleave.
+struct ArenaTLS {
+  ValueArena* arena;
+  bool last_alloc_was_arena;
+  bool delete_pending_from_arena;
+};
+
+ThreadLocalStorage::StaticSlot g_arena_tls = TLS_INITIALIZER;
+
+void FreeArenaTLS(void* data) {
+  free(data);
+}
+
+ArenaTLS* GetArenaTLS() {
+  if (!g_arena_tls.initialized())
+    g_arena_tls.Initialize(FreeArenaTLS);
+  ArenaTLS* state = static_cast<ArenaTLS*>(g_arena_tls.Get());
+  if (!state) {
+    state = static_cast<ArenaTLS*>(calloc(1, sizeof(ArenaTLS)));
+    g_arena_tls.Set(state);
+  }
+  return state;
+}
+
+}  // namespace
+
+ValueArena::ValueArena()
+    : slab_used_(kSlabSize),  // Force a new slab on the first Allocate().
+      bytes_allocated_(0) {
+}
+
+ValueArena::~ValueArena() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  DCHECK_NE(this, current()) << "destroying an arena while it is in scope";
+  for (size_t i = 0; i < slabs_.size(); ++i)
+    free(slabs_[i]);
+}
+
+ValueArena::Scope::Scope(ValueArena* arena) {
+  ArenaTLS* state = GetArenaTLS();
+  previous_ = state->arena;
+  state->arena = arena;
+}
+
+ValueArena::Scope::~Scope() {
+  GetArenaTLS()->arena = previous_;
+}
+
+// static
+ValueArena* ValueArena::current() {
+  return GetArenaTLS()->arena;
+}
+
+void* ValueArena::Allocate(size_t size) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  DCHECK_LE(size, kSlabSize);
+  // Keep allocations pointer-aligned within the slab.
+  size = (size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+  if (slab_used_ + size > kSlabSize) {
+    slabs_.push_back(static_cast<char*>(malloc(kSlabSize)));
+    slab_used_ = 0;
+  }
+  void* result = slabs_.back() + slab_used_;
+  slab_used_ += size;
+  bytes_allocated_ += size;
+  return result;
+}
+
+namespace internal {
+
+void* AllocateValue(size_t size) {
+  ArenaTLS* state = GetArenaTLS();
+  if (state->arena) {
+    state->last_alloc_was_arena = true;
+    return state->arena->Allocate(size);
+  }
+  state->last_alloc_was_arena = false;
+  return ::operator new(size);
+}
+
+void FreeValue(void* ptr) {
+  ArenaTLS* state = GetArenaTLS();
+  if (state->delete_pending_from_arena) {
+    // The memory belongs to an arena; it is reclaimed when the arena dies.
+    state->delete_pending_from_arena = false;
+    return;
+  }
+  ::operator delete(ptr);
+}
+
+bool LastValueAllocWasArena() {
+  ArenaTLS* state = GetArenaTLS();
+  bool result = state->last_alloc_was_arena;
+  // Reset so Values constructed without operator new (e.g. on the stack)
+  // are not misattributed to the arena.
+  state->last_alloc_was_arena = false;
+  return result;
+}
+
+void SetValueDeletePendingFromArena(bool from_arena) {
+  GetArenaTLS()->delete_pending_from_arena = from_arena;
+}
+
+}  // namespace internal
+
+}  // namespace base
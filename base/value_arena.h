@@ -0,0 +1,100 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_VALUE_ARENA_H_
+#define BASE_VALUE_ARENA_H_
+#pragma once
+
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/threading/thread_checker.h"
+
+namespace base {
+
+class Value;
+
+// Slab allocator for base::Value trees.  Large hierarchies (prefs, extension
+// manifests) consist of 100k+ individually heap-allocated nodes; routing
+// their allocation through an arena replaces one malloc/free pair per node
+// with a pointer bump, and releases the whole tree's memory in a handful of
+// frees when the arena dies.
+//
+// Usage:
+//   ValueArena arena;
+//   {
+//     ValueArena::Scope scope(&arena);
+//     root.reset(JSONReader::Read(huge_json));  // Nodes come from |arena|.
+//   }
+//   ... use the tree as usual; deleting nodes is a cheap no-op ...
+//   root.reset();   // Run destructors (releases string/map innards).
+//   // |arena| reclaims the node memory when it goes out of scope.
+//
+// While a Scope is active on a thread, every Value constructed on that
+// thread comes from the arena, so don't hold a Scope across unrelated code.
+// Values from an arena may be mixed freely with heap Values; each remembers
+// where it came from and operator delete does the right thing.  Delete the
+// tree (or at least stop using it) before destroying the arena.
+class BASE_EXPORT ValueArena {
+ public:
+  ValueArena();
+  ~ValueArena();
+
+  // Routes Value allocation on the current thread through an arena while in
+  // scope.  Scopes nest; the previous arena (if any) is restored on exit.
+  class BASE_EXPORT Scope {
+   public:
+    explicit Scope(ValueArena* arena);
+    ~Scope();
+
+   private:
+    ValueArena* previous_;
+
+    DISALLOW_COPY_AND_ASSIGN(Scope);
+  };
+
+  // Returns the arena active on the current thread, or NULL.
+  static ValueArena* current();
+
+  // Total bytes handed out to Values, for diagnostics.
+  size_t bytes_allocated() const { return bytes_allocated_; }
+
+ private:
+  friend class Value;  // Calls Allocate() from its class-level operator new.
+
+  static const size_t kSlabSize = 32 * 1024;
+
+  // Bump-allocates |size| bytes, starting a new slab when needed.
+  void* Allocate(size_t size);
+
+  // Slabs are only freed by the destructor; individual Values are not
+  // reclaimed while the arena lives.
+  std::vector<char*> slabs_;
+
+  // Bytes used in slabs_.back().
+  size_t slab_used_;
+
+  size_t bytes_allocated_;
+
+  ThreadChecker thread_checker_;
+
+  DISALLOW_COPY_AND_ASSIGN(ValueArena);
+};
+
+namespace internal {
+
+// Glue between Value's class-level operator new/delete and the thread's
+// active arena; see the implementation notes in value_arena.cc.  Not for use
+// outside base/values.cc.
+BASE_EXPORT void* AllocateValue(size_t size);
+BASE_EXPORT void FreeValue(void* ptr);
+BASE_EXPORT bool LastValueAllocWasArena();
+BASE_EXPORT void SetValueDeletePendingFromArena(bool from_arena);
+
+}  // namespace internal
+
+}  // namespace base
+
+#endif  // BASE_VALUE_ARENA_H_
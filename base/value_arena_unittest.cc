@@ -0,0 +1,79 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/value_arena.h"
+
+#include "base/json/json_reader.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+TEST(ValueArenaTest, ScopeActivation) {
+  EXPECT_TRUE(ValueArena::current() == NULL);
+  ValueArena arena;
+  {
+    ValueArena::Scope scope(&arena);
+    EXPECT_EQ(&arena, ValueArena::current());
+    {
+      ValueArena arena2;
+      ValueArena::Scope nested(&arena2);
+      EXPECT_EQ(&arena2, ValueArena::current());
+    }
+    EXPECT_EQ(&arena, ValueArena::current());
+  }
+  EXPECT_TRUE(ValueArena::current() == NULL);
+}
+
+TEST(ValueArenaTest, ValuesComeFromArena) {
+  ValueArena arena;
+  scoped_ptr<DictionaryValue> dict;
+  {
+    ValueArena::Scope scope(&arena);
+    dict.reset(new DictionaryValue);
+    dict->SetString("a.b.c", "hello");
+    dict->SetInteger("a.b.d", 42);
+  }
+  EXPECT_GT(arena.bytes_allocated(), 0u);
+
+  std::string out;
+  EXPECT_TRUE(dict->GetString("a.b.c", &out));
+  EXPECT_EQ("hello", out);
+
+  // Replacing and removing nodes deletes arena Values; both must be safe.
+  dict->SetString("a.b.c", "world");
+  EXPECT_TRUE(dict->Remove("a.b.d", NULL));
+
+  // Deleting the root is a no-op for the arena's memory.
+  dict.reset();
+}
+
+TEST(ValueArenaTest, MixedHeapAndArenaValues) {
+  ValueArena arena;
+  scoped_ptr<DictionaryValue> dict(new DictionaryValue);  // Heap.
+  {
+    ValueArena::Scope scope(&arena);
+    dict->Set("arena", new DictionaryValue);  // Arena.
+  }
+  dict->Set("heap", new DictionaryValue);  // Heap again.
+  dict.reset();  // Heap nodes freed, arena node left to the arena.
+}
+
+TEST(ValueArenaTest, JsonReaderUsesActiveArena) {
+  ValueArena arena;
+  scoped_ptr<Value> root;
+  {
+    ValueArena::Scope scope(&arena);
+    root.reset(JSONReader::Read("{\"list\": [1, 2, {\"k\": \"v\"}]}"));
+  }
+  ASSERT_TRUE(root.get());
+  EXPECT_GT(arena.bytes_allocated(), 0u);
+  DictionaryValue* dict = static_cast<DictionaryValue*>(root.get());
+  ListValue* list = NULL;
+  ASSERT_TRUE(dict->GetList("list", &list));
+  EXPECT_EQ(3u, list->GetSize());
+}
+
+}  // namespace base
@@ -10,6 +10,7 @@
 #include "base/logging.h"
 #include "base/string_util.h"
 #include "base/utf_string_conversions.h"
+#include "base/value_arena.h"
 
 namespace {
 
@@ -83,6 +84,19 @@ namespace base {
 ///////////////////// Value ////////////////////
 
 Value::~Value() {
+  // Runs after any subclass destructor and immediately before operator
+  // delete, which cannot inspect the (destroyed) object itself.
+  internal::SetValueDeletePendingFromArena(is_arena_allocated_);
+}
+
+// static
+void* Value::operator new(size_t size) {
+  return internal::AllocateValue(size);
+}
+
+// static
+void Value::operator delete(void* ptr) {
+  internal::FreeValue(ptr);
 }
 
 // static
@@ -172,7 +186,9 @@ bool Value::Equals(const Value* a, const Value* b) {
   return a->Equals(b);
 }
 
-Value::Value(Type type) : type_(type) {
+Value::Value(Type type)
+    : type_(type),
+      is_arena_allocated_(internal::LastValueAllocWasArena()) {
 }
 
 ///////////////////// FundamentalValue ////////////////////
@@ -67,6 +67,14 @@ class BASE_EXPORT Value {
 
   virtual ~Value();
 
+  // Class-level allocator.  While a ValueArena::Scope is active on the
+  // current thread (see base/value_arena.h), Values are slab-allocated from
+  // that arena and deleting them individually becomes a cheap no-op; the
+  // memory is reclaimed when the arena is destroyed.  Without an active
+  // scope these forward to the default heap.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr);
+
   // Convenience methods for creating Value objects for various
   // kinds of values without thinking about which class implements them.
   // These can always be expected to return a valid Value*.
@@ -125,6 +133,10 @@ class BASE_EXPORT Value {
 
   Type type_;
 
+  // True if this Value came from a ValueArena; recorded at construction and
+  // handed to operator delete by the destructor (see value_arena.cc).
+  bool is_arena_allocated_;
+
   DISALLOW_COPY_AND_ASSIGN(Value);
 };
 
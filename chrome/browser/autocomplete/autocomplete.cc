@@ -842,6 +842,12 @@ const int AutocompleteController::kNoItemSelected = -1;
 // they initiate a query.
 static const int kExpireTimeMS = 500;
 
+// Amount of time (in ms) an asynchronous query may run before we stop any
+// providers that haven't finished and publish the matches received so far.
+// This keeps a slow provider from holding the popup open indefinitely; the
+// faster providers have long since merged their results incrementally.
+static const int kStopTimeMS = 1500;
+
 AutocompleteController::AutocompleteController(
     Profile* profile,
     AutocompleteControllerDelegate* delegate)
@@ -941,8 +947,10 @@ void AutocompleteController::Start(
   CheckIfDone();
   UpdateResult(true);
 
-  if (!done_)
+  if (!done_) {
     StartExpireTimer();
+    StartStopTimer();
+  }
 }
 
 void AutocompleteController::Stop(bool clear_result) {
@@ -952,6 +960,7 @@ void AutocompleteController::Stop(bool clear_result) {
   }
 
   expire_timer_.Stop();
+  stop_timer_.Stop();
   done_ = true;
   if (clear_result && !result_.empty()) {
     result_.Reset();
@@ -1126,6 +1135,20 @@ void AutocompleteController::StartExpireTimer() {
                         this, &AutocompleteController::ExpireCopiedEntries);
 }
 
+void AutocompleteController::StartStopTimer() {
+  stop_timer_.Start(FROM_HERE,
+                    base::TimeDelta::FromMilliseconds(kStopTimeMS),
+                    this, &AutocompleteController::StopDueToTimeout);
+}
+
+void AutocompleteController::StopDueToTimeout() {
+  // The deadline expired with one or more providers still running. Any
+  // matches they returned along the way are already merged into |result_|,
+  // so we just halt the outstanding work and declare the query finished.
+  Stop(false);
+  NotifyChanged(false);
+}
+
 // AutocompleteLog ---------------------------------------------------------
 
 AutocompleteLog::AutocompleteLog(
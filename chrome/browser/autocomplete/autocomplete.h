@@ -736,6 +736,14 @@ class AutocompleteController : public ACProviderListener {
   // Starts the expire timer.
   void StartExpireTimer();
 
+  // Starts the stop timer, which enforces a fixed latency budget on each
+  // query. See |stop_timer_|.
+  void StartStopTimer();
+
+  // Invoked when the stop timer fires. Halts any providers that are still
+  // running, keeping whatever matches they have produced so far.
+  void StopDueToTimeout();
+
   AutocompleteControllerDelegate* delegate_;
 
   // A list of all providers.
@@ -755,6 +763,13 @@ class AutocompleteController : public ACProviderListener {
   // invokes |ExpireCopiedEntries|.
   base::OneShotTimer<AutocompleteController> expire_timer_;
 
+  // Timer that bounds how long asynchronous providers may keep a query open.
+  // Slow providers (e.g. history queries against very large profiles, or a
+  // slow suggest server) otherwise serialize their latency into every
+  // keystroke. When it fires we stop the outstanding providers and finish the
+  // query with the matches received so far.
+  base::OneShotTimer<AutocompleteController> stop_timer_;
+
   // True if a query is not currently running.
   bool done_;
 
@@ -18,6 +18,7 @@
 #include "chrome/browser/history/history_backend.h"
 #include "chrome/browser/history/history_database.h"
 #include "chrome/browser/history/history_types.h"
+#include "chrome/browser/history/url_prefix_index.h"
 #include "chrome/browser/net/url_fixer_upper.h"
 #include "chrome/browser/prefs/pref_service.h"
 #include "chrome/browser/profiles/profile.h"
@@ -352,7 +353,7 @@ void HistoryURLProvider::ExecuteWithDB(history::HistoryBackend* backend,
   } else if (!params->cancel_flag.IsSet()) {
     base::TimeTicks beginning_time = base::TimeTicks::Now();
 
-    DoAutocomplete(backend, db, params);
+    DoAutocomplete(backend, db, NULL, params);
 
     UMA_HISTOGRAM_TIMES("Autocomplete.HistoryAsyncQueryTime",
                         base::TimeTicks::Now() - beginning_time);
@@ -365,9 +366,11 @@ void HistoryURLProvider::ExecuteWithDB(history::HistoryBackend* backend,
 
 // Used by both autocomplete passes, and therefore called on multiple different
 // threads (though not simultaneously).
-void HistoryURLProvider::DoAutocomplete(history::HistoryBackend* backend,
-                                        history::URLDatabase* db,
-                                        HistoryURLProviderParams* params) {
+void HistoryURLProvider::DoAutocomplete(
+    history::HistoryBackend* backend,
+    history::URLDatabase* db,
+    const history::URLPrefixIndex* prefix_index,
+    HistoryURLProviderParams* params) {
   VisitClassifier classifier(this, params->input, db);
   // Create a What You Typed match, which we'll need below.
   //
@@ -402,8 +405,18 @@ void HistoryURLProvider::DoAutocomplete(history::HistoryBackend* backend,
     // for more results than we need, of every prefix type, in hopes this will
     // give us far more than enough to work with.  CullRedirects() will then
     // reduce the list to the best kMaxMatches results.
-    db->AutocompleteForPrefix(UTF16ToUTF8(i->prefix + params->input.text()),
-                              kMaxMatches * 2, (backend == NULL), &url_matches);
+    // The prefix index mirrors the typed URLs in the in-memory database, so
+    // when it is available candidate retrieval is a trie walk rather than a
+    // database range scan.
+    if (prefix_index) {
+      prefix_index->GetURLsForPrefix(
+          UTF16ToUTF8(i->prefix + params->input.text()), kMaxMatches * 2,
+          &url_matches);
+    } else {
+      db->AutocompleteForPrefix(UTF16ToUTF8(i->prefix + params->input.text()),
+                                kMaxMatches * 2, (backend == NULL),
+                                &url_matches);
+    }
     for (history::URLRows::const_iterator j(url_matches.begin());
          j != url_matches.end(); ++j) {
       const history::Prefix* best_prefix = BestPrefix(j->url(), string16());
@@ -606,7 +619,8 @@ void HistoryURLProvider::RunAutocompletePasses(
     // someone unloads the history backend, we'll get inconsistent inline
     // autocomplete behavior here.
     if (url_db) {
-      DoAutocomplete(NULL, url_db, params.get());
+      DoAutocomplete(NULL, url_db, history_service->InMemoryPrefixIndex(),
+                     params.get());
       // params->matches now has the matches we should expose to the provider.
       // Pass 2 expects a "clean slate" set of matches.
       matches_.clear();
@@ -21,6 +21,7 @@ namespace history {
 
 class HistoryBackend;
 class URLDatabase;
+class URLPrefixIndex;
 
 }  // namespace history
 
@@ -37,7 +38,7 @@ class URLDatabase;
 //         -> SuggestExactInput
 //         [params_ allocated]
 //         -> DoAutocomplete (for inline autocomplete)
-//           -> URLDatabase::AutocompleteForPrefix (on in-memory DB)
+//           -> URLPrefixIndex::GetURLsForPrefix (on in-memory index)
 //         -> HistoryService::ScheduleAutocomplete
 //         (return to controller) ----
 //                                   /
@@ -163,9 +164,12 @@ class HistoryURLProvider : public HistoryProvider {
                      HistoryURLProviderParams* params);
 
   // Actually runs the autocomplete job on the given database, which is
-  // guaranteed not to be NULL.
+  // guaranteed not to be NULL. |prefix_index| is non-NULL only during the
+  // synchronous pass, where it replaces database range scans for candidate
+  // retrieval; the database is still used for everything else.
   void DoAutocomplete(history::HistoryBackend* backend,
                       history::URLDatabase* db,
+                      const history::URLPrefixIndex* prefix_index,
                       HistoryURLProviderParams* params);
 
   // Dispatches the results to the autocomplete controller. Called on the
@@ -17,17 +17,72 @@
 #include "chrome/browser/profiles/profile.h"
 #include "ui/base/l10n/l10n_util.h"
 
+// A node of the prefix trie over the lower case words of all bookmark
+// titles. Each edge is labelled with one character. Children are kept
+// sorted, so a child lookup is a binary search and a pre-order traversal
+// enumerates the words in lexicographic order.
+struct BookmarkIndex::TrieNode {
+  typedef std::vector<std::pair<char16, TrieNode*> > Children;
+
+  TrieNode() {}
+  ~TrieNode() {
+    for (size_t i = 0; i < children.size(); ++i)
+      delete children[i].second;
+  }
+
+  // Returns the child reached over |c|, or NULL if there is none.
+  TrieNode* GetChild(char16 c) const {
+    Children::const_iterator i =
+        std::lower_bound(children.begin(), children.end(), c, ChildLess);
+    return (i != children.end() && i->first == c) ? i->second : NULL;
+  }
+
+  // Returns the child reached over |c|, creating it if necessary.
+  TrieNode* GetOrCreateChild(char16 c) {
+    Children::iterator i =
+        std::lower_bound(children.begin(), children.end(), c, ChildLess);
+    if (i != children.end() && i->first == c)
+      return i->second;
+    TrieNode* child = new TrieNode;
+    children.insert(i, std::make_pair(c, child));
+    return child;
+  }
+
+  // Removes and deletes the child reached over |c|, which must exist.
+  void RemoveChild(char16 c) {
+    Children::iterator i =
+        std::lower_bound(children.begin(), children.end(), c, ChildLess);
+    DCHECK(i != children.end() && i->first == c);
+    delete i->second;
+    children.erase(i);
+  }
+
+  // Bookmarks whose title contains the word spelled by the path to this
+  // node. Empty for nodes that only extend to longer words.
+  NodeSet nodes;
+
+  // Outgoing edges, sorted by character.
+  Children children;
+
+ private:
+  static bool ChildLess(const Children::value_type& child, char16 c) {
+    return child.first < c;
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(TrieNode);
+};
+
 // Used when finding the set of bookmarks that match a query. Each match
-// represents a set of terms (as an interator into the Index) matching the
+// represents a set of terms (as node sets from the trie) matching the
 // query as well as the set of nodes that contain those terms in their titles.
 struct BookmarkIndex::Match {
-  // List of terms matching the query.
-  std::list<Index::const_iterator> terms;
+  // The node sets of the terms matching the query.
+  std::list<const NodeSet*> terms;
 
   // The set of nodes matching the terms. As an optimization this is empty
   // when we match only one term, and is filled in when we get more than one
   // term. We can do this as when we have only one matching term we know
-  // the set of matching nodes is terms.front()->second.
+  // the set of matching nodes is *terms.front().
   //
   // Use nodes_begin() and nodes_end() to get an iterator over the set as
   // it handles the necessary switching between nodes and terms.front().
@@ -44,14 +99,16 @@ struct BookmarkIndex::Match {
 
 BookmarkIndex::NodeSet::const_iterator
     BookmarkIndex::Match::nodes_begin() const {
-  return nodes.empty() ? terms.front()->second.begin() : nodes.begin();
+  return nodes.empty() ? terms.front()->begin() : nodes.begin();
 }
 
 BookmarkIndex::NodeSet::const_iterator BookmarkIndex::Match::nodes_end() const {
-  return nodes.empty() ? terms.front()->second.end() : nodes.end();
+  return nodes.empty() ? terms.front()->end() : nodes.end();
 }
 
-BookmarkIndex::BookmarkIndex(Profile* profile) : profile_(profile) {
+BookmarkIndex::BookmarkIndex(Profile* profile)
+    : trie_root_(new TrieNode),
+      profile_(profile) {
 }
 
 BookmarkIndex::~BookmarkIndex() {
@@ -91,12 +148,13 @@ void BookmarkIndex::GetBookmarksWithTitlesMatching(
   NodeTypedCountPairs node_typed_counts;
   SortMatches(matches, &node_typed_counts);
 
-  // We use a QueryParser to fill in match positions for us. It's not the most
-  // efficient way to go about this, but by the time we get here we know what
-  // matches and so this shouldn't be performance critical.
+  // We use a QueryNodeMatcher to fill in match positions for us. It is built
+  // once here and reused for every candidate below, so matching cost does not
+  // grow with the number of words in the query.
   QueryParser parser;
   ScopedVector<QueryNode> query_nodes;
   parser.ParseQueryNodes(query, &query_nodes.get());
+  QueryNodeMatcher matcher(query_nodes.get());
 
   // The highest typed counts should be at the beginning of the results vector
   // so that the best matches will always be included in the results. The loop
@@ -105,7 +163,7 @@ void BookmarkIndex::GetBookmarksWithTitlesMatching(
   // best matches.
   for (NodeTypedCountPairs::const_iterator i = node_typed_counts.begin();
        i != node_typed_counts.end() && results->size() < max_count; ++i)
-    AddMatchToResults(i->first, &parser, query_nodes.get(), results);
+    AddMatchToResults(i->first, matcher, results);
 }
 
 void BookmarkIndex::SortMatches(const Matches& matches,
@@ -140,8 +198,7 @@ void BookmarkIndex::ExtractBookmarkNodePairs(
 
 void BookmarkIndex::AddMatchToResults(
     const BookmarkNode* node,
-    QueryParser* parser,
-    const std::vector<QueryNode*>& query_nodes,
+    const QueryNodeMatcher& matcher,
     std::vector<bookmark_utils::TitleMatch>* results) {
   bookmark_utils::TitleMatch title_match;
   // Check that the result matches the query.  The previous search
@@ -149,7 +206,7 @@ void BookmarkIndex::AddMatchToResults(
   // of QueryParser may filter it out.  For example, the query
   // ["thi"] will match the bookmark titled [Thinking], but since
   // ["thi"] is quoted we don't want to do a prefix match.
-  if (parser->DoesQueryMatch(node->GetTitle(), query_nodes,
+  if (matcher.DoesQueryMatch(node->GetTitle(),
                              &(title_match.match_positions))) {
     title_match.node = node;
     results->push_back(title_match);
@@ -159,80 +216,94 @@ void BookmarkIndex::AddMatchToResults(
 bool BookmarkIndex::GetBookmarksWithTitleMatchingTerm(const string16& term,
                                                       bool first_term,
                                                       Matches* matches) {
-  Index::const_iterator i = index_.lower_bound(term);
-  if (i == index_.end())
-    return false;
+  const TrieNode* trie_node = WalkTrie(base::StringPiece16(term));
+  if (!trie_node)
+    return false;  // No indexed word starts with this term.
 
   if (!QueryParser::IsWordLongEnoughForPrefixSearch(term)) {
     // Term is too short for prefix match, compare using exact match.
-    if (i->first != term)
+    if (trie_node->nodes.empty())
       return false;  // No bookmarks with this term.
 
     if (first_term) {
       Match match;
-      match.terms.push_back(i);
+      match.terms.push_back(&trie_node->nodes);
       matches->push_back(match);
       return true;
     }
-    CombineMatchesInPlace(i, matches);
+    CombineMatchesInPlace(trie_node->nodes, matches);
   } else if (first_term) {
-    // This is the first term and we're doing a prefix match. Loop through
-    // index adding all entries that start with term to matches.
-    while (i != index_.end() &&
-           i->first.size() >= term.size() &&
-           term.compare(0, term.size(), i->first, 0, term.size()) == 0) {
+    // This is the first term and we're doing a prefix match. Every word in
+    // the subtree under |trie_node| starts with the term.
+    std::vector<const NodeSet*> node_sets;
+    CollectNodeSets(trie_node, &node_sets);
+    for (size_t i = 0; i < node_sets.size(); ++i) {
       Match match;
-      match.terms.push_back(i);
+      match.terms.push_back(node_sets[i]);
       matches->push_back(match);
-      ++i;
     }
   } else {
-    // Prefix match and not the first term. Loop through index combining
-    // current matches in matches with term, placing result in result.
+    // Prefix match and not the first term. Combine the current matches in
+    // matches with every word in the subtree, placing result in result.
+    std::vector<const NodeSet*> node_sets;
+    CollectNodeSets(trie_node, &node_sets);
     Matches result;
-    while (i != index_.end() &&
-           i->first.size() >= term.size() &&
-           term.compare(0, term.size(), i->first, 0, term.size()) == 0) {
-      CombineMatches(i, *matches, &result);
-      ++i;
-    }
+    for (size_t i = 0; i < node_sets.size(); ++i)
+      CombineMatches(*node_sets[i], *matches, &result);
     matches->swap(result);
   }
   return !matches->empty();
 }
 
-void BookmarkIndex::CombineMatchesInPlace(const Index::const_iterator& index_i,
+const BookmarkIndex::TrieNode* BookmarkIndex::WalkTrie(
+    const base::StringPiece16& term) const {
+  const TrieNode* trie_node = trie_root_.get();
+  for (size_t i = 0; trie_node && i < term.size(); ++i)
+    trie_node = trie_node->GetChild(term[i]);
+  return trie_node;
+}
+
+// static
+void BookmarkIndex::CollectNodeSets(const TrieNode* trie_node,
+                                    std::vector<const NodeSet*>* node_sets) {
+  if (!trie_node->nodes.empty())
+    node_sets->push_back(&trie_node->nodes);
+  for (size_t i = 0; i < trie_node->children.size(); ++i)
+    CollectNodeSets(trie_node->children[i].second, node_sets);
+}
+
+void BookmarkIndex::CombineMatchesInPlace(const NodeSet& term_nodes,
                                           Matches* matches) {
   for (size_t i = 0; i < matches->size(); ) {
     Match* match = &((*matches)[i]);
     NodeSet intersection;
     std::set_intersection(match->nodes_begin(), match->nodes_end(),
-                          index_i->second.begin(), index_i->second.end(),
+                          term_nodes.begin(), term_nodes.end(),
                           std::inserter(intersection, intersection.begin()));
     if (intersection.empty()) {
       matches->erase(matches->begin() + i);
     } else {
-      match->terms.push_back(index_i);
+      match->terms.push_back(&term_nodes);
       match->nodes.swap(intersection);
       ++i;
     }
   }
 }
 
-void BookmarkIndex::CombineMatches(const Index::const_iterator& index_i,
+void BookmarkIndex::CombineMatches(const NodeSet& term_nodes,
                                    const Matches& current_matches,
                                    Matches* result) {
   for (size_t i = 0; i < current_matches.size(); ++i) {
     const Match& match = current_matches[i];
     NodeSet intersection;
     std::set_intersection(match.nodes_begin(), match.nodes_end(),
-                          index_i->second.begin(), index_i->second.end(),
+                          term_nodes.begin(), term_nodes.end(),
                           std::inserter(intersection, intersection.begin()));
     if (!intersection.empty()) {
       result->push_back(Match());
       Match& combined_match = result->back();
       combined_match.terms = match.terms;
-      combined_match.terms.push_back(index_i);
+      combined_match.terms.push_back(&term_nodes);
       combined_match.nodes.swap(intersection);
     }
   }
@@ -251,23 +322,38 @@ std::vector<string16> BookmarkIndex::ExtractQueryWords(const string16& query) {
 
 void BookmarkIndex::RegisterNode(const string16& term,
                                  const BookmarkNode* node) {
-  if (std::find(index_[term].begin(), index_[term].end(), node) !=
-      index_[term].end()) {
-    // We've already added node for term.
-    return;
-  }
-  index_[term].insert(node);
+  TrieNode* trie_node = trie_root_.get();
+  for (size_t i = 0; i < term.size(); ++i)
+    trie_node = trie_node->GetOrCreateChild(term[i]);
+  // The insert is a no-op if we've already added node for term, which
+  // happens when a title contains the same word more than once.
+  trie_node->nodes.insert(node);
 }
 
 void BookmarkIndex::UnregisterNode(const string16& term,
                                    const BookmarkNode* node) {
-  Index::iterator i = index_.find(term);
-  if (i == index_.end()) {
+  // Remember the path to the term so that trie nodes left empty can be
+  // pruned afterwards.
+  std::vector<TrieNode*> path;
+  path.reserve(term.size() + 1);
+  TrieNode* trie_node = trie_root_.get();
+  path.push_back(trie_node);
+  for (size_t i = 0; trie_node && i < term.size(); ++i) {
+    trie_node = trie_node->GetChild(term[i]);
+    path.push_back(trie_node);
+  }
+  if (!trie_node) {
     // We can get here if the node has the same term more than once. For
     // example, a bookmark with the title 'foo foo' would end up here.
     return;
   }
-  i->second.erase(node);
-  if (i->second.empty())
-    index_.erase(i);
+  trie_node->nodes.erase(node);
+
+  // Prune the trie nodes that no longer spell or extend any word.
+  for (size_t i = term.size(); i > 0; --i) {
+    TrieNode* child = path[i];
+    if (!child->nodes.empty() || !child->children.empty())
+      break;
+    path[i - 1]->RemoveChild(term[i - 1]);
+  }
 }
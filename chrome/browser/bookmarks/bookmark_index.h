@@ -6,17 +6,17 @@
 #define CHROME_BROWSER_BOOKMARKS_BOOKMARK_INDEX_H_
 #pragma once
 
-#include <map>
 #include <set>
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/string16.h"
+#include "base/string_piece.h"
 
 class BookmarkNode;
 class Profile;
-class QueryNode;
-class QueryParser;
+class QueryNodeMatcher;
 
 namespace bookmark_utils {
 struct TitleMatch;
@@ -30,9 +30,13 @@ class URLDatabase;
 // look up. BookmarkIndex is owned and maintained by BookmarkModel, you
 // shouldn't need to interact directly with BookmarkIndex.
 //
-// BookmarkIndex maintains the index (index_) as a map of sets. The map (type
-// Index) maps from a lower case string to the set (type NodeSet) of
-// BookmarkNodes that contain that string in their title.
+// BookmarkIndex maintains the index (trie_root_) as a prefix trie over the
+// lower case words of all bookmark titles. Each trie node stores the set
+// (type NodeSet) of BookmarkNodes whose title contains the word spelled by
+// the path to it, so an exact lookup walks the term once and a prefix lookup
+// enumerates a subtree instead of comparing strings. The trie is updated
+// incrementally as bookmarks are added and removed; nodes that no longer
+// spell or extend any word are pruned.
 
 class BookmarkIndex {
  public:
@@ -53,7 +57,9 @@ class BookmarkIndex {
 
  private:
   typedef std::set<const BookmarkNode*> NodeSet;
-  typedef std::map<string16, NodeSet> Index;
+
+  // A node of the prefix trie (see the .cc file).
+  struct TrieNode;
 
   struct Match;
   typedef std::vector<Match> Matches;
@@ -85,8 +91,7 @@ class BookmarkIndex {
 
   // Add |node| to |results| if the node matches the query.
   void AddMatchToResults(const BookmarkNode* node,
-                         QueryParser* parser,
-                         const std::vector<QueryNode*>& query_nodes,
+                         const QueryNodeMatcher& matcher,
                          std::vector<bookmark_utils::TitleMatch>* results);
 
   // Populates |matches| for the specified term. If |first_term| is true, this
@@ -96,16 +101,26 @@ class BookmarkIndex {
                                          bool first_term,
                                          Matches* matches);
 
+  // Returns the trie node reached by walking |term| from the root, or NULL
+  // if no indexed word starts with |term|.
+  const TrieNode* WalkTrie(const base::StringPiece16& term) const;
+
+  // Appends the node sets of all words in the subtree rooted at |trie_node|
+  // (including |trie_node| itself) to |node_sets|, in lexicographic word
+  // order.
+  static void CollectNodeSets(const TrieNode* trie_node,
+                              std::vector<const NodeSet*>* node_sets);
+
   // Iterates over |matches| updating each Match's nodes to contain the
-  // intersection of the Match's current nodes and the nodes at |index_i|.
+  // intersection of the Match's current nodes and |term_nodes|.
   // If the intersection is empty, the Match is removed.
   //
   // This is invoked from GetBookmarksWithTitleMatchingTerm.
-  void CombineMatchesInPlace(const Index::const_iterator& index_i,
+  void CombineMatchesInPlace(const NodeSet& term_nodes,
                              Matches* matches);
 
   // Iterates over |current_matches| calculating the intersection between the
-  // Match's nodes and the nodes at |index_i|. If the intersection between the
+  // Match's nodes and |term_nodes|. If the intersection between the
   // two is non-empty, a new match is added to |result|.
   //
   // This differs from CombineMatchesInPlace in that if the intersection is
@@ -113,20 +128,21 @@ class BookmarkIndex {
   // variant is used for prefix matching.
   //
   // This is invoked from GetBookmarksWithTitleMatchingTerm.
-  void CombineMatches(const Index::const_iterator& index_i,
+  void CombineMatches(const NodeSet& term_nodes,
                       const Matches& current_matches,
                       Matches* result);
 
   // Returns the set of query words from |query|.
   std::vector<string16> ExtractQueryWords(const string16& query);
 
-  // Adds |node| to |index_|.
+  // Adds |node| to the trie under |term|.
   void RegisterNode(const string16& term, const BookmarkNode* node);
 
-  // Removes |node| from |index_|.
+  // Removes |node| from the trie under |term|, pruning trie nodes that are
+  // left spelling or extending no word.
   void UnregisterNode(const string16& term, const BookmarkNode* node);
 
-  Index index_;
+  scoped_ptr<TrieNode> trie_root_;
 
   Profile* profile_;
 
@@ -34,6 +34,7 @@
 #include "chrome/common/extensions/extension_error_utils.h"
 #include "chrome/common/extensions/extension_messages.h"
 #include "chrome/common/extensions/url_pattern.h"
+#include "chrome/common/extensions/url_pattern_matcher.h"
 #include "chrome/common/url_constants.h"
 #include "content/public/browser/browser_message_filter.h"
 #include "content/public/browser/browser_thread.h"
@@ -395,9 +396,25 @@ bool ExtensionWebRequestEventRouter::RequestFilter::InitFromValue(
       return false;
     }
   }
+
+  // The filter runs against every network request; compile the patterns so
+  // matching doesn't scan them one at a time.
+  if (!urls.is_empty()) {
+    compiled_urls.reset(new URLPatternMatcher);
+    compiled_urls->Compile(urls);
+  }
   return true;
 }
 
+bool ExtensionWebRequestEventRouter::RequestFilter::MatchesURL(
+    const GURL& url) const {
+  if (urls.is_empty())
+    return true;
+  if (compiled_urls.get())
+    return compiled_urls->MatchesURL(url);
+  return urls.MatchesURL(url);
+}
+
 // static
 bool ExtensionWebRequestEventRouter::ExtraInfoSpec::InitFromValue(
     const ListValue& value, int* extra_info_spec) {
@@ -1080,7 +1097,7 @@ void ExtensionWebRequestEventRouter::GetMatchingListenersImpl(
       continue;
     }
 
-    if (!it->filter.urls.is_empty() && !it->filter.urls.MatchesURL(url))
+    if (!it->filter.MatchesURL(url))
       continue;
     if (it->filter.tab_id != -1 && tab_id != it->filter.tab_id)
       continue;
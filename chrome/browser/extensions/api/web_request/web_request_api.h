@@ -12,6 +12,7 @@
 #include <string>
 #include <vector>
 
+#include "base/memory/linked_ptr.h"
 #include "base/memory/singleton.h"
 #include "base/time.h"
 #include "chrome/browser/extensions/api/declarative_webrequest/request_stages.h"
@@ -28,6 +29,7 @@
 class ExtensionInfoMap;
 class ExtensionWebRequestTimeTracker;
 class GURL;
+class URLPatternMatcher;
 
 namespace base {
 class DictionaryValue;
@@ -82,7 +84,17 @@ class ExtensionWebRequestEventRouter {
     // unexpected).
     bool InitFromValue(const base::DictionaryValue& value, std::string* error);
 
+    // Returns true if |url| passes the URL part of the filter: either no URL
+    // patterns were specified, or one of them matches.
+    bool MatchesURL(const GURL& url) const;
+
     URLPatternSet urls;
+
+    // Compiled form of |urls|, built by InitFromValue. The filter is tested
+    // against every network request, so matching shouldn't scan the patterns
+    // one at a time.
+    linked_ptr<URLPatternMatcher> compiled_urls;
+
     std::vector<ResourceType::Type> types;
     int tab_id;
     int window_id;
@@ -6,6 +6,7 @@
 
 #include "base/bind.h"
 #include "base/command_line.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/message_loop.h"
 #include "base/values.h"
 #include "chrome/browser/extensions/api/runtime/runtime_api.h"
@@ -37,6 +38,17 @@ namespace {
 
 const char kDispatchEvent[] = "Event.dispatchJSON";
 
+// Packs the renderer-side dispatch arguments for an event. The result is
+// what Event.dispatchJSON expects: the event name followed by the JSON
+// argument string.
+ListValue* PackDispatchArguments(const std::string& event_name,
+                                 const std::string& event_args) {
+  ListValue* args = new ListValue();
+  args->Set(0, Value::CreateStringValue(event_name));
+  args->Set(1, Value::CreateStringValue(event_args));
+  return args;
+}
+
 void NotifyEventListenerRemovedOnIOThread(
     void* profile,
     const std::string& extension_id,
@@ -84,6 +96,27 @@ struct ExtensionEventRouter::ExtensionEvent {
       restrict_to_profile(restrict_to_profile),
       cross_incognito_args(cross_incognito_args),
       user_gesture(user_gesture) {}
+
+  // Returns the packed argument list for the normal or the cross-incognito
+  // variant of this event, building it on first use. An event is typically
+  // dispatched to many listener processes; sharing the packed list means the
+  // argument strings are copied once per event rather than once per listener.
+  const ListValue* GetDispatchArguments() {
+    if (!dispatch_args_.get())
+      dispatch_args_.reset(PackDispatchArguments(event_name, event_args));
+    return dispatch_args_.get();
+  }
+  const ListValue* GetCrossIncognitoDispatchArguments() {
+    if (!cross_incognito_dispatch_args_.get()) {
+      cross_incognito_dispatch_args_.reset(
+          PackDispatchArguments(event_name, cross_incognito_args));
+    }
+    return cross_incognito_dispatch_args_.get();
+  }
+
+ private:
+  scoped_ptr<ListValue> dispatch_args_;
+  scoped_ptr<ListValue> cross_incognito_dispatch_args_;
 };
 
 // static
@@ -93,11 +126,20 @@ void ExtensionEventRouter::DispatchEvent(IPC::Message::Sender* ipc_sender,
                                          const std::string& event_args,
                                          const GURL& event_url,
                                          UserGestureState user_gesture) {
-  ListValue args;
-  args.Set(0, Value::CreateStringValue(event_name));
-  args.Set(1, Value::CreateStringValue(event_args));
+  scoped_ptr<ListValue> args(PackDispatchArguments(event_name, event_args));
+  DispatchPackedEvent(ipc_sender, extension_id, *args, event_url,
+                      user_gesture);
+}
+
+// static
+void ExtensionEventRouter::DispatchPackedEvent(
+    IPC::Message::Sender* ipc_sender,
+    const std::string& extension_id,
+    const ListValue& dispatch_args,
+    const GURL& event_url,
+    UserGestureState user_gesture) {
   ipc_sender->Send(new ExtensionMsg_MessageInvoke(MSG_ROUTING_CONTROL,
-      extension_id, kDispatchEvent, args, event_url,
+      extension_id, kDispatchEvent, dispatch_args, event_url,
       user_gesture == USER_GESTURE_ENABLED));
 }
 
@@ -321,14 +363,13 @@ void ExtensionEventRouter::DispatchEventToListener(
     return;
   }
 
-  const std::string* event_args;
+  const ListValue* dispatch_args;
   if (!CanDispatchEventToProfile(listener_profile, extension,
-                                 event, &event_args))
+                                 event, &dispatch_args))
     return;
 
-  DispatchEvent(listener.process, listener.extension_id,
-                event->event_name, *event_args,
-                event->event_url, event->user_gesture);
+  DispatchPackedEvent(listener.process, listener.extension_id,
+                      *dispatch_args, event->event_url, event->user_gesture);
   IncrementInFlightEvents(listener_profile, extension);
 }
 
@@ -336,9 +377,7 @@ bool ExtensionEventRouter::CanDispatchEventToProfile(
     Profile* profile,
     const Extension* extension,
     const linked_ptr<ExtensionEvent>& event,
-    const std::string** event_args) {
-  *event_args = &event->event_args;
-
+    const ListValue** dispatch_args) {
   // Is this event from a different profile than the renderer (ie, an
   // incognito tab event sent to a normal process, or vice versa).
   bool cross_incognito = event->restrict_to_profile &&
@@ -349,9 +388,11 @@ bool ExtensionEventRouter::CanDispatchEventToProfile(
       return false;
     // Send the event with different arguments to extensions that can't
     // cross incognito.
-    *event_args = &event->cross_incognito_args;
+    *dispatch_args = event->GetCrossIncognitoDispatchArguments();
+    return true;
   }
 
+  *dispatch_args = event->GetDispatchArguments();
   return true;
 }
 
@@ -390,8 +431,8 @@ void ExtensionEventRouter::MaybeLoadLazyBackgroundPage(
     Profile* profile,
     const Extension* extension,
     const linked_ptr<ExtensionEvent>& event) {
-  const std::string* event_args;
-  if (!CanDispatchEventToProfile(profile, extension, event, &event_args))
+  const ListValue* dispatch_args;
+  if (!CanDispatchEventToProfile(profile, extension, event, &dispatch_args))
     return;
 
   extensions::LazyBackgroundTaskQueue* queue =
@@ -21,6 +21,7 @@ class GURL;
 class Extension;
 class ExtensionHost;
 class ExtensionDevToolsManager;
+class ListValue;
 class Profile;
 
 namespace content {
@@ -157,15 +158,24 @@ class ExtensionEventRouter : public content::NotificationObserver {
   void DispatchEventToListener(const ListenerProcess& listener,
                                const linked_ptr<ExtensionEvent>& event);
 
+  // Sends a dispatch message with an already-packed argument list. Used so
+  // that a broadcast builds the argument list once and shares it between
+  // every listener process instead of re-packing it per listener.
+  static void DispatchPackedEvent(IPC::Message::Sender* ipc_sender,
+                                  const std::string& extension_id,
+                                  const ListValue& dispatch_args,
+                                  const GURL& event_url,
+                                  UserGestureState user_gesture);
+
   // Returns false when the event is scoped to a profile and the listening
   // extension does not have access to events from that profile. Also fills
-  // |event_args| with the proper arguments to send, which may differ if
-  // the event crosses the incognito boundary.
+  // |dispatch_args| with the packed argument list to send, which is built
+  // once per event (per incognito variant) and shared between listeners.
   bool CanDispatchEventToProfile(
       Profile* profile,
       const Extension* extension,
       const linked_ptr<ExtensionEvent>& event,
-      const std::string** event_args);
+      const ListValue** dispatch_args);
 
   // Ensures that all lazy background pages that are interested in the given
   // event are loaded, and queues the event if the page is not ready yet.
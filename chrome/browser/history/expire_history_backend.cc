@@ -135,6 +135,23 @@ const int kExpirationDelaySec = 30;
 // iteration, so we want to wait longer before checking to avoid wasting CPU.
 const int kExpirationEmptyDelayMin = 5;
 
+// How long the history thread must have been free of foreground work before
+// an archive iteration will run. Anything shorter and we may be racing an
+// omnibox interaction that is about to send more queries our way.
+const int kExpirationIdleSec = 5;
+
+// How much wall-clock time one archive iteration may consume. Within the
+// budget we process several kNumExpirePerIteration chunks back to back; all
+// of their deletes batch under the backend's long-running transaction, so
+// bigger iterations amortize the commit cost, while the budget bounds how
+// long we keep the history thread to ourselves.
+const int kExpirationBudgetMs = 50;
+
+// The maximum number of free pages handed back to the file system after a
+// full expiration pass (see HistoryDatabase::TrimUnusedPages). At the
+// history database's 4K page size this caps the extra I/O at 4MB per pass.
+const int kMaxUnusedPagesTrimmed = 1000;
+
 // The number of minutes that we wait for before scheduling a task to
 // delete old history index files.
 const int kIndexExpirationDelayMin = 2;
@@ -597,15 +614,37 @@ void ExpireHistoryBackend::ScheduleArchive() {
 void ExpireHistoryBackend::DoArchiveIteration() {
   DCHECK(!work_queue_.empty()) << "queue has to be non-empty";
 
-  const ExpiringVisitsReader* reader = work_queue_.front();
-  bool more_to_expire = ArchiveSomeOldHistory(GetCurrentArchiveTime(), reader,
-                                              kNumExpirePerIteration);
+  // Only archive when the history thread has been idle for a bit; expiring
+  // months of old history must never slow down foreground work such as
+  // omnibox queries. ScheduleArchive() will try again later.
+  if (!last_foreground_work_time_.is_null() &&
+      base::TimeTicks::Now() - last_foreground_work_time_ <
+          TimeDelta::FromSeconds(kExpirationIdleSec)) {
+    ScheduleArchive();
+    return;
+  }
 
-  work_queue_.pop();
-  // If there are more items to expire, add the reader back to the queue, thus
-  // creating a new task for future iterations.
-  if (more_to_expire)
-    work_queue_.push(reader);
+  // Expire in chunks until the time budget is exhausted or the queue drains.
+  base::TimeTicks batch_start = base::TimeTicks::Now();
+  do {
+    const ExpiringVisitsReader* reader = work_queue_.front();
+    bool more_to_expire = ArchiveSomeOldHistory(GetCurrentArchiveTime(),
+                                                reader,
+                                                kNumExpirePerIteration);
+
+    work_queue_.pop();
+    // If there are more items to expire, add the reader back to the queue,
+    // thus creating a new task for future iterations.
+    if (more_to_expire)
+      work_queue_.push(reader);
+  } while (!work_queue_.empty() &&
+           base::TimeTicks::Now() - batch_start <
+               TimeDelta::FromMilliseconds(kExpirationBudgetMs));
+
+  // A drained queue means a full expiration pass just finished. Give any
+  // pages it freed back to the file system while we are still idle.
+  if (work_queue_.empty() && main_db_)
+    main_db_->TrimUnusedPages(kMaxUnusedPagesTrimmed);
 
   ScheduleArchive();
 }
@@ -107,6 +107,14 @@ class ExpireHistoryBackend {
     return base::Time::Now() - expiration_threshold_;
   }
 
+  // Tells the expirer that the history thread just serviced a foreground
+  // request. Periodic archive iterations hold off while such work is recent
+  // so that expiring months of old history never contends with, for example,
+  // omnibox queries.
+  void OnForegroundWork() {
+    last_foreground_work_time_ = base::TimeTicks::Now();
+  }
+
  private:
   FRIEND_TEST_ALL_PREFIXES(ExpireHistoryTest, DeleteFaviconsIfPossible);
   FRIEND_TEST_ALL_PREFIXES(ExpireHistoryTest, ArchiveSomeOldHistory);
@@ -266,6 +274,11 @@ class ExpireHistoryBackend {
   // iterations.
   std::queue<const ExpiringVisitsReader*> work_queue_;
 
+  // The last time the history backend told us it serviced a foreground
+  // request (see OnForegroundWork). Archive iterations are deferred until
+  // this is comfortably in the past.
+  base::TimeTicks last_foreground_work_time_;
+
   // Readers for various types of visits.
   // TODO(dglazkov): If you are adding another one, please consider reorganizing
   // into a map.
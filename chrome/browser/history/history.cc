@@ -263,6 +263,13 @@ history::URLDatabase* HistoryService::InMemoryDatabase() {
   return NULL;
 }
 
+history::URLPrefixIndex* HistoryService::InMemoryPrefixIndex() {
+  LoadBackendIfNecessary();
+  if (in_memory_backend_.get())
+    return in_memory_backend_->prefix_index();
+  return NULL;
+}
+
 void HistoryService::SetSegmentPresentationIndex(int64 segment_id, int index) {
   ScheduleAndForget(PRIORITY_UI,
                     &HistoryBackend::SetSegmentPresentationIndex,
@@ -55,6 +55,7 @@ struct HistoryDetails;
 class HistoryQueryTest;
 class VisitFilter;
 class URLDatabase;
+class URLPrefixIndex;
 class VisitDatabaseObserver;
 }  // namespace history
 
@@ -150,6 +151,11 @@ class HistoryService : public CancelableRequestProvider,
   // TODO(brettw) this should return the InMemoryHistoryBackend.
   history::URLDatabase* InMemoryDatabase();
 
+  // Returns the prefix index over the typed URLs in InMemoryDatabase(), or
+  // NULL under the same conditions InMemoryDatabase() returns NULL. The same
+  // ownership caveats apply.
+  history::URLPrefixIndex* InMemoryPrefixIndex();
+
   // Return the quick history index.
   history::InMemoryURLIndex* InMemoryIndex() const {
     return in_memory_url_index_.get();
@@ -17,6 +17,7 @@
 #include "base/message_loop.h"
 #include "base/metrics/histogram.h"
 #include "base/string_util.h"
+#include "base/threading/worker_pool.h"
 #include "base/time.h"
 #include "chrome/browser/autocomplete/history_url_provider.h"
 #include "chrome/browser/bookmarks/bookmark_service.h"
@@ -218,6 +219,9 @@ HistoryBackend::~HistoryBackend() {
   ReleaseDBTasks();
 
   // First close the databases before optionally running the "destroy" task.
+  // Release our reference to the read pool. Any read connections still out
+  // with worker tasks keep the pool (but not us) alive until they finish.
+  read_pool_ = NULL;
   if (db_.get()) {
     // Commit the long-running transaction.
     db_->CommitTransaction();
@@ -394,6 +398,8 @@ void HistoryBackend::AddPage(scoped_refptr<HistoryAddPageArgs> request) {
   if (!db_.get())
     return;
 
+  expirer_.OnForegroundWork();
+
   // Will be filled with the URL ID and the visit ID of the last addition.
   std::pair<URLID, VisitID> last_ids(0, tracker_.GetLastVisit(
       request->id_scope, request->page_id, request->referrer));
@@ -614,7 +620,11 @@ void HistoryBackend::InitImpl(const std::string& languages) {
                                                       // pointer.
   else
     delete mem_backend;  // Error case, run without the in-memory DB.
-  db_->BeginExclusiveMode();  // Must be after the mem backend read the data.
+
+  // With the database in WAL mode, additional read-only connections can query
+  // it while this thread writes. Expensive read queries draw their
+  // connections from this pool and run on worker threads.
+  read_pool_ = new HistoryReadConnectionPool(history_name);
 
   // Create the history publisher which needs to be passed on to the text and
   // thumbnail databases for publishing history.
@@ -1039,6 +1049,8 @@ void HistoryBackend::QueryURL(scoped_refptr<QueryURLRequest> request,
   if (request->canceled())
     return;
 
+  expirer_.OnForegroundWork();
+
   bool success = false;
   URLRow* row = &request->value.a;
   VisitVector* visits = &request->value.b;
@@ -1221,12 +1233,35 @@ void HistoryBackend::QueryHistory(scoped_refptr<QueryHistoryRequest> request,
   if (request->canceled())
     return;
 
+  expirer_.OnForegroundWork();
+
+  if (db_.get() && text_query.empty() && read_pool_.get()) {
+    // Basic (non-FTS) queries only read the main database, so run them on a
+    // worker thread against a read-only connection and move on to servicing
+    // other requests. Commit the long-running transaction first so the reader
+    // sees everything written so far; in WAL mode the reader then gets a
+    // consistent snapshot without blocking our later writes.
+    HistoryReadOnlyDatabase* readonly_db = read_pool_->Acquire();
+    if (readonly_db) {
+      Commit();
+      base::WorkerPool::PostTask(
+          FROM_HERE,
+          base::Bind(&HistoryBackend::QueryHistoryOnPoolThread, read_pool_,
+                     readonly_db, request, options, first_recorded_time_),
+          true);
+      return;
+    }
+    // All read connections are busy (or could not be opened); fall through
+    // and run the query here like we used to.
+  }
+
   TimeTicks beginning_time = TimeTicks::Now();
 
   if (db_.get()) {
     if (text_query.empty()) {
       // Basic history query for the main database.
-      QueryHistoryBasic(db_.get(), db_.get(), options, &request->value);
+      QueryHistoryBasic(db_.get(), db_.get(), db_.get(), options,
+                        first_recorded_time_, &request->value);
 
       // Now query the archived database. This is a bit tricky because we don't
       // want to query it if the queried time range isn't going to find anything
@@ -1247,10 +1282,35 @@ void HistoryBackend::QueryHistory(scoped_refptr<QueryHistoryRequest> request,
                       TimeTicks::Now() - beginning_time);
 }
 
+// static
+void HistoryBackend::QueryHistoryOnPoolThread(
+    scoped_refptr<HistoryReadConnectionPool> read_pool,
+    HistoryReadOnlyDatabase* readonly_db,
+    scoped_refptr<QueryHistoryRequest> request,
+    const QueryOptions& options,
+    base::Time first_recorded_time) {
+  TimeTicks beginning_time = TimeTicks::Now();
+
+  if (!request->canceled()) {
+    QueryHistoryBasic(readonly_db, readonly_db, NULL, options,
+                      first_recorded_time, &request->value);
+    // This forwards to the thread the request came from.
+    request->ForwardResult(request->handle(), &request->value);
+  }
+
+  read_pool->Release(readonly_db);
+
+  UMA_HISTOGRAM_TIMES("History.QueryHistory",
+                      TimeTicks::Now() - beginning_time);
+}
+
 // Basic time-based querying of history.
+// static
 void HistoryBackend::QueryHistoryBasic(URLDatabase* url_db,
                                        VisitDatabase* visit_db,
+                                       URLDatabase* main_db,
                                        const QueryOptions& options,
+                                       base::Time first_recorded_time,
                                        QueryResults* result) {
   // First get all visits.
   VisitVector visits;
@@ -1281,11 +1341,11 @@ void HistoryBackend::QueryHistoryBasic(URLDatabase* url_db,
     // The archived database may be out of sync with respect to starring,
     // titles, last visit date, etc. Therefore, we query the main DB if the
     // current URL database is not the main one.
-    if (url_db == db_.get()) {
+    if (main_db && url_db == main_db) {
       // Currently querying the archived DB, update with the main database to
       // catch any interesting stuff. This will update it if it exists in the
       // main DB, and do nothing otherwise.
-      db_->GetRowForURL(url_result.url(), &url_result);
+      main_db->GetRowForURL(url_result.url(), &url_result);
     }
 
     url_result.set_visit_time(visit.visit_time);
@@ -1295,7 +1355,7 @@ void HistoryBackend::QueryHistoryBasic(URLDatabase* url_db,
     result->AppendURLBySwapping(&url_result);
   }
 
-  if (options.begin_time <= first_recorded_time_)
+  if (options.begin_time <= first_recorded_time)
     result->set_reached_beginning(true);
 }
 
@@ -1643,6 +1703,7 @@ bool HistoryBackend::GetMostRecentRedirectsTo(
 
 void HistoryBackend::ScheduleAutocomplete(HistoryURLProvider* provider,
                                           HistoryURLProviderParams* params) {
+  expirer_.OnForegroundWork();
   // ExecuteWithDB should handle the NULL database case.
   provider->ExecuteWithDB(this, db_.get(), params);
 }
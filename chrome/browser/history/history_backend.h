@@ -471,12 +471,33 @@ class HistoryBackend : public base::RefCountedThreadSafe<HistoryBackend>,
   // text search) queries and can just be given directly to the history DB).
   // The FTS version queries the text_database, then merges with the history DB.
   // Both functions assume QueryHistory already checked the DB for validity.
-  void QueryHistoryBasic(URLDatabase* url_db, VisitDatabase* visit_db,
-                         const QueryOptions& options, QueryResults* result);
+  //
+  // QueryHistoryBasic() is static so that it can also run on a worker thread
+  // against a read-only connection (see QueryHistoryOnPoolThread). |main_db|
+  // is the main history connection used to refresh rows when querying another
+  // database, and must be NULL when not running on the history thread.
+  static void QueryHistoryBasic(URLDatabase* url_db,
+                                VisitDatabase* visit_db,
+                                URLDatabase* main_db,
+                                const QueryOptions& options,
+                                base::Time first_recorded_time,
+                                QueryResults* result);
   void QueryHistoryFTS(const string16& text_query,
                        const QueryOptions& options,
                        QueryResults* result);
 
+  // Runs a basic history query against |readonly_db| on a worker thread and
+  // forwards the result to the request's consumer, leaving the history thread
+  // free to service writes in the meantime. Gives |readonly_db| back to
+  // |read_pool| when done. Deliberately not bound to |this| so that a slow
+  // query cannot end up destroying the backend on a worker thread.
+  static void QueryHistoryOnPoolThread(
+      scoped_refptr<HistoryReadConnectionPool> read_pool,
+      HistoryReadOnlyDatabase* readonly_db,
+      scoped_refptr<QueryHistoryRequest> request,
+      const QueryOptions& options,
+      base::Time first_recorded_time);
+
   // Committing ----------------------------------------------------------------
 
   // We always keep a transaction open on the history database so that multiple
@@ -615,6 +636,10 @@ class HistoryBackend : public base::RefCountedThreadSafe<HistoryBackend>,
   scoped_ptr<HistoryDatabase> db_;
   scoped_ptr<ThumbnailDatabase> thumbnail_db_;
 
+  // Read-only connections to the history database for expensive queries that
+  // run on worker threads. NULL whenever db_ is NULL.
+  scoped_refptr<HistoryReadConnectionPool> read_pool_;
+
   // Stores old history in a larger, slower database.
   scoped_ptr<ArchivedDatabase> archived_db_;
 
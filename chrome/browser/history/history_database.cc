@@ -10,9 +10,12 @@
 
 #include "base/command_line.h"
 #include "base/file_util.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
 #include "base/rand_util.h"
+#include "base/stl_util.h"
 #include "base/string_util.h"
+#include "base/stringprintf.h"
 #include "chrome/browser/diagnostics/sqlite_diagnostics.h"
 #include "chrome/browser/history/starred_url_database.h"
 #include "sql/transaction.h"
@@ -36,6 +39,11 @@ static const char kEarlyExpirationThresholdKey[] = "early_expiration_threshold";
 // of history.
 static const char kNeedsThumbnailMigrationKey[] = "needs_thumbnail_migration";
 
+// Maximum number of read-only connections HistoryReadConnectionPool will
+// open. Expensive queries are rare enough that two running at once covers
+// the common case; anything beyond that falls back to the history thread.
+const size_t kMaxReadConnections = 2;
+
 void ComputeDatabaseMetrics(const FilePath& history_name,
                             sql::Connection& db) {
   if (base::RandInt(1, 100) != 50)
@@ -85,13 +93,23 @@ sql::InitStatus HistoryDatabase::Init(const FilePath& history_name,
   // TODO(brettw) scale this value to the amount of available memory.
   db_.set_cache_size(6000);
 
-  // Note that we don't set exclusive locking here. That's done by
-  // BeginExclusiveMode below which is called later (we have to be in shared
-  // mode to start out for the in-memory backend to read the data).
+  // Run in WAL (write-ahead log) journal mode so that the read-only
+  // connections in HistoryReadConnectionPool can query a consistent snapshot
+  // of the database while we write. This is also why we don't use exclusive
+  // locking: it would lock those connections (and the in-memory backend,
+  // which attaches to slurp the data out) out of the database entirely.
+  db_.set_journal_mode_wal();
 
   if (!db_.Open(history_name))
     return sql::INIT_FAILURE;
 
+  // Use incremental auto-vacuum so that expiration can hand freed pages back
+  // to the file system a little at a time (see TrimUnusedPages) instead of
+  // needing a full, blocking VACUUM. This only takes effect on databases
+  // created from now on; switching the mode on an existing database would
+  // itself require a full vacuum, which isn't worth the hit.
+  ignore_result(db_.Execute("PRAGMA auto_vacuum=INCREMENTAL"));
+
   // Wrap the rest of init in a tranaction. This will prevent the database from
   // getting corrupted if we crash in the middle of initialization or migration.
   sql::Transaction committer(&db_);
@@ -127,12 +145,6 @@ sql::InitStatus HistoryDatabase::Init(const FilePath& history_name,
   return committer.Commit() ? sql::INIT_OK : sql::INIT_FAILURE;
 }
 
-void HistoryDatabase::BeginExclusiveMode() {
-  // We can't use set_exclusive_locking() since that only has an effect before
-  // the DB is opened.
-  ignore_result(db_.Execute("PRAGMA locking_mode=EXCLUSIVE"));
-}
-
 // static
 int HistoryDatabase::GetCurrentVersion() {
   return kCurrentVersionNumber;
@@ -179,6 +191,11 @@ void HistoryDatabase::Vacuum() {
   ignore_result(db_.Execute("VACUUM"));
 }
 
+void HistoryDatabase::TrimUnusedPages(int max_pages) {
+  ignore_result(db_.Execute(
+      StringPrintf("PRAGMA incremental_vacuum(%d)", max_pages).c_str()));
+}
+
 void HistoryDatabase::ThumbnailMigrationDone() {
   meta_table_.SetValue(kNeedsThumbnailMigrationKey, 0);
 }
@@ -365,4 +382,73 @@ void HistoryDatabase::MigrateTimeEpoch() {
 }
 #endif
 
+HistoryReadOnlyDatabase::HistoryReadOnlyDatabase() {
+}
+
+HistoryReadOnlyDatabase::~HistoryReadOnlyDatabase() {
+}
+
+bool HistoryReadOnlyDatabase::Init(const FilePath& history_name) {
+  // The main connection put the database in WAL mode; this connection must
+  // ask for the same mode or opening it would try to switch the journal mode
+  // back underneath the writer.
+  db_.set_journal_mode_wal();
+  if (!db_.Open(history_name))
+    return false;
+
+  // The schema is owned by the main connection; we only ever read. Make sure
+  // we really did open an initialized history database and not, say, a file
+  // some other version is in the middle of creating.
+  if (!db_.DoesTableExist("urls") || !db_.DoesTableExist("visits")) {
+    db_.Close();
+    return false;
+  }
+  return true;
+}
+
+sql::Connection& HistoryReadOnlyDatabase::GetDB() {
+  return db_;
+}
+
+HistoryReadConnectionPool::HistoryReadConnectionPool(
+    const FilePath& history_name)
+    : history_name_(history_name),
+      open_count_(0) {
+}
+
+HistoryReadConnectionPool::~HistoryReadConnectionPool() {
+  // Checked-out connections are always Release()d before the worker task
+  // drops its reference to the pool, so by the time the last reference goes
+  // away every connection is back on the idle list.
+  STLDeleteElements(&idle_connections_);
+}
+
+HistoryReadOnlyDatabase* HistoryReadConnectionPool::Acquire() {
+  {
+    base::AutoLock lock(lock_);
+    if (!idle_connections_.empty()) {
+      HistoryReadOnlyDatabase* database = idle_connections_.back();
+      idle_connections_.pop_back();
+      return database;
+    }
+    if (open_count_ >= kMaxReadConnections)
+      return NULL;
+    ++open_count_;
+  }
+
+  // Open the new connection outside the lock; it does file I/O.
+  scoped_ptr<HistoryReadOnlyDatabase> database(new HistoryReadOnlyDatabase());
+  if (!database->Init(history_name_)) {
+    base::AutoLock lock(lock_);
+    --open_count_;
+    return NULL;
+  }
+  return database.release();
+}
+
+void HistoryReadConnectionPool::Release(HistoryReadOnlyDatabase* database) {
+  base::AutoLock lock(lock_);
+  idle_connections_.push_back(database);
+}
+
 }  // namespace history
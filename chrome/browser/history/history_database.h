@@ -6,9 +6,14 @@
 #define CHROME_BROWSER_HISTORY_HISTORY_DATABASE_H_
 #pragma once
 
+#include <vector>
+
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/file_path.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "chrome/browser/history/download_database.h"
 #include "chrome/browser/history/history_types.h"
@@ -24,8 +29,6 @@
 #include "chrome/browser/history/android/android_urls_database.h"
 #endif
 
-class FilePath;
-
 namespace history {
 
 // Encapsulates the SQL connection for the history database. This class holds
@@ -66,18 +69,13 @@ class HistoryDatabase : public DownloadDatabase,
   virtual ~HistoryDatabase();
 
   // Must call this function to complete initialization. Will return true on
-  // success. On false, no other function should be called. You may want to call
-  // BeginExclusiveMode after this when you are ready.
+  // success. On false, no other function should be called. The database is
+  // opened in WAL (write-ahead log) journal mode so that the read-only
+  // connections handed out by HistoryReadConnectionPool below can query it
+  // concurrently with this connection's writes.
   sql::InitStatus Init(const FilePath& history_name,
                        const FilePath& tmp_bookmarks_path);
 
-  // Call to set the mode on the database to exclusive. The default locking mode
-  // is "normal" but we want to run in exclusive mode for slightly better
-  // performance since we know nobody else is using the database. This is
-  // separate from Init() since the in-memory database attaches to slurp the
-  // data out, and this can't happen in exclusive mode.
-  void BeginExclusiveMode();
-
   // Returns the current version that we will generate history databases with.
   static int GetCurrentVersion();
 
@@ -118,6 +116,13 @@ class HistoryDatabase : public DownloadDatabase,
   // unused space in the file. It can be VERY SLOW.
   void Vacuum();
 
+  // Releases up to |max_pages| unused pages back to the file system using
+  // incremental auto-vacuum. Unlike Vacuum() this is cheap enough to run
+  // after expiring old history. A no-op on databases created before
+  // incremental auto-vacuum was enabled, since changing the mode on an
+  // existing database requires a full vacuum.
+  void TrimUnusedPages(int max_pages);
+
   // Returns true if the history backend should erase the full text search
   // and archived history files as part of version 16 -> 17 migration. The
   // time format changed in this revision, and these files would be much slower
@@ -195,6 +200,71 @@ class HistoryDatabase : public DownloadDatabase,
   DISALLOW_COPY_AND_ASSIGN(HistoryDatabase);
 };
 
+// A second, read-only connection to an existing history database. Because the
+// main connection runs in WAL journal mode, one of these can read a consistent
+// snapshot of the database from a worker thread while the history thread
+// continues to write, with neither side blocking the other. Only the querying
+// mixins are inherited; nothing may write through this connection.
+class HistoryReadOnlyDatabase : public URLDatabase, public VisitDatabase {
+ public:
+  HistoryReadOnlyDatabase();
+  virtual ~HistoryReadOnlyDatabase();
+
+  // Opens the connection to an existing history database. Returns true on
+  // success. On false, no other function should be called.
+  bool Init(const FilePath& history_name);
+
+ private:
+  // Overridden from URLDatabase and VisitDatabase:
+  virtual sql::Connection& GetDB() OVERRIDE;
+
+  sql::Connection db_;
+
+  DISALLOW_COPY_AND_ASSIGN(HistoryReadOnlyDatabase);
+};
+
+// Hands out read-only connections to the history database so that expensive
+// queries can run on worker threads while writes keep their ordering on the
+// history thread. Connections are opened lazily, up to a fixed maximum.
+//
+// Acquire() is only called on the history thread, but Release() runs on
+// whatever worker thread finished with the connection, so the idle list is
+// guarded by a lock. The pool is reference counted because a worker task can
+// outlive the HistoryBackend during shutdown.
+class HistoryReadConnectionPool
+    : public base::RefCountedThreadSafe<HistoryReadConnectionPool> {
+ public:
+  explicit HistoryReadConnectionPool(const FilePath& history_name);
+
+  // Returns an idle connection, opening a new one if the pool is below its
+  // limit. Returns NULL when all connections are busy or a new one could not
+  // be opened; the caller should fall back to querying on the history thread.
+  // The returned connection must be given back with Release().
+  HistoryReadOnlyDatabase* Acquire();
+
+  // Returns a connection obtained from Acquire() to the pool. May be called
+  // from any thread.
+  void Release(HistoryReadOnlyDatabase* database);
+
+ private:
+  friend class base::RefCountedThreadSafe<HistoryReadConnectionPool>;
+  ~HistoryReadConnectionPool();
+
+  const FilePath history_name_;
+
+  // Protects both members below.
+  base::Lock lock_;
+
+  // Open connections not currently checked out. Owned by this class; entries
+  // handed out by Acquire() are owned by the caller until Release()d.
+  std::vector<HistoryReadOnlyDatabase*> idle_connections_;
+
+  // Number of connections opened so far, checked out or not.
+  size_t open_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(HistoryReadConnectionPool);
+};
+
 }  // namespace history
 
 #endif  // CHROME_BROWSER_HISTORY_HISTORY_DATABASE_H_
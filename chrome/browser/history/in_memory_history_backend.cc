@@ -14,6 +14,7 @@
 #include "chrome/browser/history/history_notifications.h"
 #include "chrome/browser/history/in_memory_database.h"
 #include "chrome/browser/history/url_database.h"
+#include "chrome/browser/history/url_prefix_index.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/common/chrome_notification_types.h"
 #include "content/public/browser/notification_details.h"
@@ -30,7 +31,11 @@ InMemoryHistoryBackend::~InMemoryHistoryBackend() {}
 bool InMemoryHistoryBackend::Init(const FilePath& history_filename,
                                   URLDatabase* db) {
   db_.reset(new InMemoryDatabase);
-  return db_->InitFromDisk(history_filename);
+  if (!db_->InitFromDisk(history_filename))
+    return false;
+
+  PopulatePrefixIndex();
+  return true;
 }
 
 void InMemoryHistoryBackend::AttachToHistoryService(Profile* profile) {
@@ -119,6 +124,8 @@ void InMemoryHistoryBackend::OnTypedURLsModified(
         db_->UpdateURLRow(id, *i);
       else
         db_->AddURL(*i);
+      if (prefix_index_.get())
+        prefix_index_->Add(*i);
     }
   }
 }
@@ -132,6 +139,8 @@ void InMemoryHistoryBackend::OnURLsDeleted(const URLsDeletedDetails& details) {
     db_.reset(new InMemoryDatabase);
     if (!db_->InitFromScratch())
       db_.reset();
+    if (prefix_index_.get())
+      prefix_index_->Clear();
     return;
   }
 
@@ -141,6 +150,8 @@ void InMemoryHistoryBackend::OnURLsDeleted(const URLsDeletedDetails& details) {
     // We typically won't have most of them since we only have a subset of
     // history, so ignore errors.
     db_->DeleteURLRow(row->id());
+    if (prefix_index_.get())
+      prefix_index_->Remove(row->url());
   }
 }
 
@@ -167,6 +178,18 @@ void InMemoryHistoryBackend::OnKeywordSearchTermUpdated(
   db_->SetKeywordSearchTermsForURL(url_id, details.keyword_id, details.term);
 }
 
+void InMemoryHistoryBackend::PopulatePrefixIndex() {
+  prefix_index_.reset(new URLPrefixIndex);
+
+  URLDatabase::URLEnumerator enumerator;
+  if (!db_->InitURLEnumeratorForEverything(&enumerator))
+    return;
+
+  URLRow row;
+  while (enumerator.GetNextURL(&row))
+    prefix_index_->Add(row);
+}
+
 bool InMemoryHistoryBackend::HasKeyword(const GURL& url) {
   URLID id = db_->GetRowForURL(url, NULL);
   if (!id)
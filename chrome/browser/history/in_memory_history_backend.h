@@ -32,6 +32,7 @@ class InMemoryDatabase;
 class InMemoryURLIndex;
 struct KeywordSearchTermDetails;
 class URLDatabase;
+class URLPrefixIndex;
 struct URLsDeletedDetails;
 struct URLsModifiedDetails;
 
@@ -57,6 +58,13 @@ class InMemoryHistoryBackend : public content::NotificationObserver {
     return db_.get();
   }
 
+  // Returns the prefix index over the typed URLs in |db()|, kept in sync with
+  // it. Used by the autocomplete code to find candidate URLs for a prefix
+  // without querying the database.
+  URLPrefixIndex* prefix_index() const {
+    return prefix_index_.get();
+  }
+
   // Notification callback.
   virtual void Observe(int type,
                        const content::NotificationSource& source,
@@ -77,9 +85,13 @@ class InMemoryHistoryBackend : public content::NotificationObserver {
   // Returns true if there is a keyword associated with the specified url.
   bool HasKeyword(const GURL& url);
 
+  // Rebuilds |prefix_index_| from the typed URLs currently in |db_|.
+  void PopulatePrefixIndex();
+
   content::NotificationRegistrar registrar_;
 
   scoped_ptr<InMemoryDatabase> db_;
+  scoped_ptr<URLPrefixIndex> prefix_index_;
 
   // The profile that this object is attached. May be NULL before
   // initialization.
@@ -22,10 +22,12 @@ using in_memory_url_index::InMemoryURLIndexCacheItem;
 namespace history {
 
 // Called by DoSaveToCacheFile to delete any old cache file at |path| when
-// there is no private data to save. Runs on the FILE thread.
+// there is no private data to save, along with the journal of changes that
+// accompanies it. Runs on the FILE thread.
 void DeleteCacheFile(const FilePath& path) {
   DCHECK(!content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
   file_util::Delete(path, false);
+  file_util::Delete(URLIndexPrivateData::JournalFilePath(path), false);
 }
 
 // Initializes a whitelist of URL schemes.
@@ -186,25 +188,40 @@ void InMemoryURLIndex::Observe(int notification_type,
 }
 
 void InMemoryURLIndex::OnURLVisited(const URLVisitedDetails* details) {
-  needs_to_be_cached_ |=
-      private_data_->UpdateURL(details->row, languages_, scheme_whitelist_);
+  if (private_data_->UpdateURL(details->row, languages_, scheme_whitelist_)) {
+    needs_to_be_cached_ = true;
+    PostAppendToJournalTask(
+        URLIndexPrivateData::MakeJournalUpdateRecord(details->row));
+  }
 }
 
 void InMemoryURLIndex::OnURLsModified(const URLsModifiedDetails* details) {
   for (URLRows::const_iterator row = details->changed_urls.begin();
-       row != details->changed_urls.end(); ++row)
-    needs_to_be_cached_ |=
-        private_data_->UpdateURL(*row, languages_, scheme_whitelist_);
+       row != details->changed_urls.end(); ++row) {
+    if (private_data_->UpdateURL(*row, languages_, scheme_whitelist_)) {
+      needs_to_be_cached_ = true;
+      PostAppendToJournalTask(
+          URLIndexPrivateData::MakeJournalUpdateRecord(*row));
+    }
+  }
 }
 
 void InMemoryURLIndex::OnURLsDeleted(const URLsDeletedDetails* details) {
   if (details->all_history) {
     ClearPrivateData();
     needs_to_be_cached_ = true;
+    // Journal the clear so a crash before the next full cache save cannot
+    // resurrect the deleted history from a stale cache file.
+    PostAppendToJournalTask(URLIndexPrivateData::MakeJournalClearRecord());
   } else {
     for (URLRows::const_iterator row = details->rows.begin();
-         row != details->rows.end(); ++row)
-      needs_to_be_cached_ |= private_data_->DeleteURL(row->url());
+         row != details->rows.end(); ++row) {
+      if (private_data_->DeleteURL(row->url())) {
+        needs_to_be_cached_ = true;
+        PostAppendToJournalTask(
+            URLIndexPrivateData::MakeJournalDeleteRecord(row->url()));
+      }
+    }
   }
 }
 
@@ -219,7 +236,7 @@ void InMemoryURLIndex::PostRestoreFromCacheFileTask() {
   content::BrowserThread::PostTaskAndReply(
       content::BrowserThread::FILE, FROM_HERE,
       base::Bind(&URLIndexPrivateData::RestoreFromFileTask, path,
-          restored_private_data, languages_),
+          restored_private_data, languages_, scheme_whitelist_),
       base::Bind(&InMemoryURLIndex::OnCacheLoadDone, AsWeakPtr(),
           restored_private_data));
 }
@@ -284,6 +301,15 @@ void InMemoryURLIndex::RebuildFromHistory(HistoryDatabase* history_db) {
 
 // Saving to Cache -------------------------------------------------------------
 
+void InMemoryURLIndex::PostAppendToJournalTask(const std::string& record) {
+  FilePath path;
+  if (record.empty() || !GetCacheFilePath(&path))
+    return;
+  content::BrowserThread::PostTask(
+      content::BrowserThread::FILE, FROM_HERE,
+      base::Bind(&URLIndexPrivateData::AppendToJournalFileTask, path, record));
+}
+
 void InMemoryURLIndex::PostSaveToCacheFileTask() {
   FilePath path;
   if (!GetCacheFilePath(&path))
@@ -225,6 +225,14 @@ class InMemoryURLIndex : public content::NotificationObserver,
   // restore has succeeded.
   void OnCacheRestored(URLIndexPrivateData* private_data);
 
+  // Posts a task to append |record| (a framed journal record built by one of
+  // URLIndexPrivateData's MakeJournal*Record functions) to the journal file
+  // kept beside the cache file. The journal keeps the on-disk cache current
+  // as history changes without rewriting the whole cache; it is replayed on
+  // top of the cache at restore time and deleted whenever the full cache is
+  // saved.
+  void PostAppendToJournalTask(const std::string& record);
+
   // Posts a task to cache the index private data and write the cache file to
   // the profile directory.
   void PostSaveToCacheFileTask();
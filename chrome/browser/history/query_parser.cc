@@ -5,6 +5,7 @@
 #include "chrome/browser/history/query_parser.h"
 
 #include <algorithm>
+#include <map>
 
 #include "base/compiler_specific.h"
 #include "base/i18n/break_iterator.h"
@@ -318,7 +319,9 @@ void QueryParser::ParseQueryWords(const string16& query,
 void QueryParser::ParseQueryNodes(const string16& query,
                                   std::vector<QueryNode*>* nodes) {
   QueryNodeList root;
-  if (ParseQueryImpl(base::i18n::ToLower(query), &root))
+  // Case folding rather than lowering: both sides of the match are folded,
+  // and the fold has an ASCII fast path that avoids ICU for typical queries.
+  if (ParseQueryImpl(base::i18n::FoldCase(query), &root))
     nodes->swap(*root.children());
 }
 
@@ -329,7 +332,7 @@ bool QueryParser::DoesQueryMatch(const string16& text,
     return false;
 
   std::vector<QueryWord> query_words;
-  string16 lower_text = base::i18n::ToLower(text);
+  string16 lower_text = base::i18n::FoldCase(text);
   ExtractQueryWords(lower_text, &query_words);
 
   if (query_words.empty())
@@ -353,6 +356,29 @@ bool QueryParser::DoesQueryMatch(const string16& text,
   return true;
 }
 
+// static
+void QueryParser::ExtractQueryWords(const string16& text,
+                                    std::vector<QueryWord>* words) {
+  base::i18n::BreakIterator iter(text, base::i18n::BreakIterator::BREAK_WORD);
+  // TODO(evanm): support a locale here
+  if (!iter.Init())
+    return;
+
+  while (iter.Advance()) {
+    // Just found a span between 'prev' (inclusive) and 'pos' (exclusive). It
+    // is not necessarily a word, but could also be a sequence of punctuation
+    // or whitespace.
+    if (iter.IsWord()) {
+      string16 word = iter.GetString();
+      if (!word.empty()) {
+        words->push_back(QueryWord());
+        words->back().word = word;
+        words->back().position = iter.prev();
+      }
+    }
+  }
+}
+
 bool QueryParser::ParseQueryImpl(const string16& query, QueryNodeList* root) {
   base::i18n::BreakIterator iter(query, base::i18n::BreakIterator::BREAK_WORD);
   // TODO(evanm): support a locale here
@@ -393,24 +419,120 @@ bool QueryParser::ParseQueryImpl(const string16& query, QueryNodeList* root) {
   return true;
 }
 
-void QueryParser::ExtractQueryWords(const string16& text,
-                                    std::vector<QueryWord>* words) {
-  base::i18n::BreakIterator iter(text, base::i18n::BreakIterator::BREAK_WORD);
-  // TODO(evanm): support a locale here
-  if (!iter.Init())
-    return;
+// A node of the query word trie. A node is terminal if some query word ends
+// at it; |node_indices| then lists the word nodes spelling that word.
+struct QueryNodeMatcher::TrieNode {
+  TrieNode() : is_terminal(false), allows_prefix_match(false) {}
+  ~TrieNode() {
+    STLDeleteContainerPairSecondPointers(children.begin(), children.end());
+  }
 
-  while (iter.Advance()) {
-    // Just found a span between 'prev' (inclusive) and 'pos' (exclusive). It
-    // is not necessarily a word, but could also be a sequence of punctuation
-    // or whitespace.
-    if (iter.IsWord()) {
-      string16 word = iter.GetString();
-      if (!word.empty()) {
-        words->push_back(QueryWord());
-        words->back().word = word;
-        words->back().position = iter.prev();
+  bool is_terminal;
+
+  // Valid when |is_terminal|; mirrors IsWordLongEnoughForPrefixSearch() for
+  // the word ending here.
+  bool allows_prefix_match;
+
+  // Indices of the word nodes whose word ends at this trie node.
+  std::vector<size_t> node_indices;
+
+  std::map<char16, TrieNode*> children;
+};
+
+QueryNodeMatcher::QueryNodeMatcher(const std::vector<QueryNode*>& nodes)
+    : root_(new TrieNode),
+      num_word_nodes_(0) {
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (nodes[i]->IsWord()) {
+      AddWord(static_cast<const QueryNodeWord*>(nodes[i])->word(),
+              num_word_nodes_++);
+    } else {
+      phrase_nodes_.push_back(nodes[i]);
+    }
+  }
+}
+
+QueryNodeMatcher::~QueryNodeMatcher() {}
+
+bool QueryNodeMatcher::DoesQueryMatch(
+    const string16& text,
+    Snippet::MatchPositions* match_positions) const {
+  if (num_word_nodes_ == 0 && phrase_nodes_.empty())
+    return false;
+
+  std::vector<QueryWord> query_words;
+  string16 lower_text = base::i18n::FoldCase(text);
+  QueryParser::ExtractQueryWords(lower_text, &query_words);
+
+  if (query_words.empty())
+    return false;
+
+  Snippet::MatchPositions matches;
+  if (!MatchWordNodes(query_words, &matches))
+    return false;
+  for (size_t i = 0; i < phrase_nodes_.size(); ++i) {
+    if (!phrase_nodes_[i]->HasMatchIn(query_words, &matches))
+      return false;
+  }
+  if (lower_text.length() != text.length()) {
+    // The folded string differs from the original string. The matches are
+    // meaningless (see QueryParser::DoesQueryMatch).
+    match_positions->clear();
+  } else {
+    CoalseAndSortMatchPositions(&matches);
+    match_positions->swap(matches);
+  }
+  return true;
+}
+
+void QueryNodeMatcher::AddWord(const string16& word, size_t node_index) {
+  TrieNode* node = root_.get();
+  for (size_t i = 0; i < word.size(); ++i) {
+    TrieNode*& child = node->children[word[i]];
+    if (!child)
+      child = new TrieNode;
+    node = child;
+  }
+  node->is_terminal = true;
+  node->allows_prefix_match =
+      QueryParser::IsWordLongEnoughForPrefixSearch(word);
+  node->node_indices.push_back(node_index);
+}
+
+bool QueryNodeMatcher::MatchWordNodes(
+    const std::vector<QueryWord>& words,
+    Snippet::MatchPositions* match_positions) const {
+  if (num_word_nodes_ == 0)
+    return true;
+
+  std::vector<bool> matched(num_word_nodes_, false);
+  size_t num_matched = 0;
+  for (size_t i = 0; i < words.size() && num_matched < num_word_nodes_; ++i) {
+    const string16& word = words[i].word;
+    const TrieNode* node = root_.get();
+    // After |j| characters of |word| are consumed, |node| spells a query word
+    // |j| characters long; a terminal there matches if it may prefix-match or
+    // if the whole candidate word was consumed.
+    for (size_t j = 0; j <= word.size() && node; ++j) {
+      if (node->is_terminal &&
+          (node->allows_prefix_match || j == word.size())) {
+        for (size_t k = 0; k < node->node_indices.size(); ++k) {
+          size_t index = node->node_indices[k];
+          if (!matched[index]) {
+            matched[index] = true;
+            ++num_matched;
+            match_positions->push_back(
+                Snippet::MatchPosition(words[i].position,
+                                       words[i].position + j));
+          }
+        }
+      }
+      if (j < word.size()) {
+        std::map<char16, TrieNode*>::const_iterator child =
+            node->children.find(word[j]);
+        node = (child == node->children.end()) ? NULL : child->second;
       }
     }
   }
+  return num_matched == num_word_nodes_;
 }
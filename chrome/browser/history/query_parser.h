@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/string16.h"
 #include "chrome/browser/history/snippet.h"
 
@@ -83,20 +84,63 @@ class QueryParser {
 
   // Returns true if the string text matches the query nodes created by a call
   // to ParseQuery. If the query does match, each of the matching positions in
-  // the text is added to |match_positions|.
+  // the text is added to |match_positions|. Callers matching many candidate
+  // strings against the same query should build a QueryNodeMatcher instead.
   bool DoesQueryMatch(const string16& text,
                       const std::vector<QueryNode*>& nodes,
                       Snippet::MatchPositions* match_positions);
 
+  // Extracts the words from |text|, placing each word into |words|.
+  static void ExtractQueryWords(const string16& text,
+                                std::vector<QueryWord>* words);
+
  private:
   // Does the work of parsing |query|; creates nodes in |root| as appropriate.
   // This is invoked from both of the ParseQuery methods.
   bool ParseQueryImpl(const string16& query, QueryNodeList* root);
 
-  // Extracts the words from |text|, placing each word into |words|.
-  void ExtractQueryWords(const string16& text, std::vector<QueryWord>* words);
-
   DISALLOW_COPY_AND_ASSIGN(QueryParser);
 };
 
+// QueryNodeMatcher compiles the word nodes produced by ParseQueryNodes() into
+// a trie so that a candidate string is matched against every query word in a
+// single pass, instead of once per word node. Since query words only ever
+// match at the start of a candidate word, a plain trie walk per candidate
+// word suffices. Build one matcher per parsed query and reuse it across
+// candidates. Phrase nodes ("quoted") cannot be compiled this way and are
+// still matched individually; they are rare.
+class QueryNodeMatcher {
+ public:
+  // |nodes| must outlive this matcher.
+  explicit QueryNodeMatcher(const std::vector<QueryNode*>& nodes);
+  ~QueryNodeMatcher();
+
+  // Same contract as QueryParser::DoesQueryMatch().
+  bool DoesQueryMatch(const string16& text,
+                      Snippet::MatchPositions* match_positions) const;
+
+ private:
+  struct TrieNode;
+
+  // Adds |word| to the trie, recording that it spells the word node at
+  // |node_index|.
+  void AddWord(const string16& word, size_t node_index);
+
+  // Walks the trie with each word in |words|, recording the first match for
+  // every word node in |match_positions|. Returns true if all word nodes
+  // matched.
+  bool MatchWordNodes(const std::vector<QueryWord>& words,
+                      Snippet::MatchPositions* match_positions) const;
+
+  scoped_ptr<TrieNode> root_;
+
+  // Number of word nodes compiled into the trie.
+  size_t num_word_nodes_;
+
+  // Nodes that cannot be compiled (phrases), matched one at a time.
+  std::vector<const QueryNode*> phrase_nodes_;
+
+  DISALLOW_COPY_AND_ASSIGN(QueryNodeMatcher);
+};
+
 #endif  // CHROME_BROWSER_HISTORY_QUERY_PARSER_H_
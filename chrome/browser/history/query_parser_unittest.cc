@@ -133,6 +133,25 @@ TEST_F(QueryParserTest, ParseQueryNodesAndMatch) {
       EXPECT_EQ(data[i].m2_start, match_positions[offset].first);
       EXPECT_EQ(data[i].m2_end, match_positions[offset].second);
     }
+
+    // The compiled matcher must agree with DoesQueryMatch().
+    QueryNodeMatcher matcher(query_nodes.get());
+    Snippet::MatchPositions matcher_positions;
+    ASSERT_EQ(data[i].matches,
+              matcher.DoesQueryMatch(UTF8ToUTF16(data[i].text),
+                                     &matcher_positions));
+    offset = 0;
+    if (data[i].m1_start != 0 || data[i].m1_end != 0) {
+      ASSERT_TRUE(matcher_positions.size() >= 1);
+      EXPECT_EQ(data[i].m1_start, matcher_positions[0].first);
+      EXPECT_EQ(data[i].m1_end, matcher_positions[0].second);
+      offset++;
+    }
+    if (data[i].m2_start != 0 || data[i].m2_end != 0) {
+      ASSERT_TRUE(matcher_positions.size() == 1 + offset);
+      EXPECT_EQ(data[i].m2_start, matcher_positions[offset].first);
+      EXPECT_EQ(data[i].m2_end, matcher_positions[offset].second);
+    }
   }
 }
 
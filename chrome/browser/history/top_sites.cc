@@ -20,6 +20,7 @@
 #include "chrome/browser/history/page_usage_data.h"
 #include "chrome/browser/history/top_sites_backend.h"
 #include "chrome/browser/history/top_sites_cache.h"
+#include "chrome/browser/history/top_sites_snapshot.h"
 #include "chrome/browser/prefs/pref_service.h"
 #include "chrome/browser/prefs/scoped_user_pref_update.h"
 #include "chrome/browser/profiles/profile.h"
@@ -170,6 +171,15 @@ void TopSites::Init(const FilePath& db_name) {
       base::Bind(&TopSites::OnGotMostVisitedThumbnails,
                  base::Unretained(this)));
 
+  // Race the database load against a read of the snapshot of the last
+  // session's top sites. Mapping the snapshot doesn't wait on the DB thread
+  // or SQLite, so the new tab page usually has something to show well before
+  // the database load completes.
+  BrowserThread::PostTask(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(&TopSites::ReadSnapshotOnFileThread, this,
+                 TopSitesSnapshot::PathForDatabase(db_name)));
+
   // History may have already finished loading by the time we're created.
   HistoryService* history = profile_->GetHistoryServiceWithoutCreating();
   if (history && history->backend_loaded()) {
@@ -229,9 +239,10 @@ void TopSites::GetMostVisitedURLs(CancelableRequestConsumer* consumer,
   MostVisitedURLList filtered_urls;
   {
     base::AutoLock lock(lock_);
-    if (!loaded_) {
-      // A request came in before we finished loading. Put the request in
-      // pending_callbacks_ and we'll notify it when we finish loading.
+    if (!loaded_ && !snapshot_.get()) {
+      // A request came in before we finished loading and before the snapshot
+      // of the last session was read. Put the request in pending_callbacks_
+      // and we'll notify it when either arrives.
       pending_callbacks_.insert(request);
       return;
     }
@@ -248,6 +259,11 @@ bool TopSites::GetPageThumbnail(const GURL& url,
     base::AutoLock lock(lock_);
     if (thread_safe_cache_->GetPageThumbnail(url, bytes))
       return true;
+
+    // Until the database load completes, serve thumbnails straight out of the
+    // mapped snapshot of the last session.
+    if (snapshot_.get() && snapshot_->GetPageThumbnail(url, bytes))
+      return true;
   }
 
   // Resource bundle is thread safe.
@@ -793,6 +809,10 @@ void TopSites::MoveStateToLoaded() {
       return;  // Don't do anything if we're already loaded.
     loaded_ = true;
 
+    // The database is authoritative from here on; drop the snapshot mapping.
+    // Thumbnails already handed out keep it alive until they're released.
+    snapshot_ = NULL;
+
     // Now that we're loaded we can service the queued up callbacks. Copy them
     // here and service them outside the lock.
     if (!pending_callbacks_.empty()) {
@@ -902,4 +922,42 @@ void TopSites::OnTopSitesAvailableFromHistory(
       content::Details<CancelableRequestProvider::Handle>(&handle));
 }
 
+void TopSites::ReadSnapshotOnFileThread(const FilePath& path) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+
+  scoped_refptr<TopSitesSnapshot> snapshot = TopSitesSnapshot::Read(path);
+  if (!snapshot.get())
+    return;  // No snapshot (first run) or it's unreadable; nothing to serve.
+
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&TopSites::OnSnapshotRead, this, snapshot));
+}
+
+void TopSites::OnSnapshotRead(scoped_refptr<TopSitesSnapshot> snapshot) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+
+  if (!profile_)
+    return;  // We've been shut down.
+
+  MostVisitedURLList filtered_urls;
+  ApplyBlacklist(snapshot->most_visited(), &filtered_urls);
+
+  PendingCallbackSet pending_callbacks;
+  {
+    base::AutoLock lock(lock_);
+    if (loaded_)
+      return;  // The database load finished first; it wins.
+
+    snapshot_ = snapshot;
+    thread_safe_cache_->SetTopSites(filtered_urls);
+
+    // Service the requests that queued up before the snapshot was read. Any
+    // later requests are answered from |thread_safe_cache_| directly.
+    pending_callbacks.swap(pending_callbacks_);
+  }
+
+  ProcessPendingCallbacks(pending_callbacks, filtered_urls);
+}
+
 }  // namespace history
@@ -39,6 +39,7 @@ namespace history {
 
 class TopSitesCache;
 class TopSitesBackend;
+class TopSitesSnapshot;
 class TopSitesTest;
 
 // Stores the data for the top "most visited" sites. This includes a cache of
@@ -310,6 +311,15 @@ class TopSites
   void OnTopSitesAvailableFromHistory(CancelableRequestProvider::Handle handle,
                                       MostVisitedURLList data);
 
+  // Reads the snapshot of the last session's top sites (see TopSitesSnapshot)
+  // and forwards it to OnSnapshotRead on the UI thread. Invoked on the FILE
+  // thread during Init.
+  void ReadSnapshotOnFileThread(const FilePath& path);
+
+  // Starts serving the snapshot's list and thumbnails if the database load
+  // hasn't finished yet.
+  void OnSnapshotRead(scoped_refptr<TopSitesSnapshot> snapshot);
+
   scoped_refptr<TopSitesBackend> backend_;
 
   // The top sites data.
@@ -359,6 +369,12 @@ class TopSites
   // See description above TopSitesLoadState.
   TopSitesLoadState top_sites_state_;
 
+  // Mapped snapshot of the last session's top sites. Only set between the
+  // snapshot read finishing and the database load finishing; while set, the
+  // new tab page is served from it. Protected by |lock_| since the thumbnail
+  // getters run on any thread.
+  scoped_refptr<TopSitesSnapshot> snapshot_;
+
   // Are we loaded?
   bool loaded_;
 
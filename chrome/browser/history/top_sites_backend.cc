@@ -9,14 +9,21 @@
 #include "base/file_util.h"
 #include "base/memory/ref_counted.h"
 #include "chrome/browser/history/top_sites_database.h"
+#include "chrome/browser/history/top_sites_snapshot.h"
 #include "content/public/browser/browser_thread.h"
 
 using content::BrowserThread;
 
 namespace history {
 
+// How long after an update before the snapshot file is rewritten. Thumbnail
+// updates come in bursts (one per page load early in a session), so coalesce
+// them rather than rewriting the file each time.
+static const int64 kWriteSnapshotDelayMS = 30 * 1000;
+
 TopSitesBackend::TopSitesBackend()
-    : db_(new TopSitesDatabase()) {
+    : db_(new TopSitesDatabase()),
+      snapshot_write_pending_(false) {
 }
 
 void TopSitesBackend::Init(const FilePath& path) {
@@ -94,6 +101,10 @@ void TopSitesBackend::InitDBOnDBThread(const FilePath& path) {
 
 void TopSitesBackend::ShutdownDBOnDBThread() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::DB));
+  // Flush any updates the delayed write hasn't picked up yet so the next
+  // session's snapshot isn't stale.
+  if (snapshot_write_pending_)
+    WriteSnapshotOnDBThread();
   db_.reset();
 }
 
@@ -112,6 +123,10 @@ void TopSitesBackend::GetMostVisitedThumbnailsOnDBThread(
   }
   request->ForwardResult(request->handle(), request->value,
                          may_need_history_migration);
+
+  // Make sure a snapshot exists for the next startup, even on profiles that
+  // predate the snapshot file.
+  ScheduleWriteSnapshotOnDBThread();
 }
 
 void TopSitesBackend::UpdateTopSitesOnDBThread(const TopSitesDelta& delta) {
@@ -126,6 +141,8 @@ void TopSitesBackend::UpdateTopSitesOnDBThread(const TopSitesDelta& delta) {
 
   for (size_t i = 0; i < delta.moved.size(); ++i)
     db_->UpdatePageRank(delta.moved[i].url, delta.moved[i].rank);
+
+  ScheduleWriteSnapshotOnDBThread();
 }
 
 void TopSitesBackend::SetPageThumbnailOnDBThread(const MostVisitedURL& url,
@@ -135,12 +152,15 @@ void TopSitesBackend::SetPageThumbnailOnDBThread(const MostVisitedURL& url,
     return;
 
   db_->SetPageThumbnail(url, url_rank, thumbnail);
+
+  ScheduleWriteSnapshotOnDBThread();
 }
 
 void TopSitesBackend::ResetDatabaseOnDBThread(const FilePath& file_path) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::DB));
   db_.reset(NULL);
   file_util::Delete(db_path_, false);
+  file_util::Delete(TopSitesSnapshot::PathForDatabase(db_path_), false);
   db_.reset(new TopSitesDatabase());
   InitDBOnDBThread(db_path_);
 }
@@ -150,4 +170,28 @@ void TopSitesBackend::DoEmptyRequestOnDBThread(
   request->ForwardResult(request->handle());
 }
 
+void TopSitesBackend::ScheduleWriteSnapshotOnDBThread() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::DB));
+  if (snapshot_write_pending_)
+    return;
+  snapshot_write_pending_ = true;
+  BrowserThread::PostDelayedTask(
+      BrowserThread::DB, FROM_HERE,
+      base::Bind(&TopSitesBackend::WriteSnapshotOnDBThread, this),
+      kWriteSnapshotDelayMS);
+}
+
+void TopSitesBackend::WriteSnapshotOnDBThread() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::DB));
+  snapshot_write_pending_ = false;
+  if (!db_.get())
+    return;
+
+  MostVisitedURLList urls;
+  URLToImagesMap thumbnails;
+  db_->GetPageThumbnails(&urls, &thumbnails);
+  TopSitesSnapshot::Write(TopSitesSnapshot::PathForDatabase(db_path_),
+                          urls, thumbnails);
+}
+
 }  // namespace history
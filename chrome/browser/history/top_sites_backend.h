@@ -97,10 +97,21 @@ class TopSitesBackend
   // Notifies the request.
   void DoEmptyRequestOnDBThread(scoped_refptr<EmptyRequestRequest> request);
 
+  // Schedules a delayed rewrite of the snapshot file (see TopSitesSnapshot),
+  // coalescing bursts of updates into a single write.
+  void ScheduleWriteSnapshotOnDBThread();
+
+  // Rewrites the snapshot file from the database.
+  void WriteSnapshotOnDBThread();
+
   FilePath db_path_;
 
   scoped_ptr<TopSitesDatabase> db_;
 
+  // Whether a call to WriteSnapshotOnDBThread is pending. Only used on the DB
+  // thread.
+  bool snapshot_write_pending_;
+
   DISALLOW_COPY_AND_ASSIGN(TopSitesBackend);
 };
 
@@ -0,0 +1,150 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/history/top_sites_snapshot.h"
+
+#include "base/logging.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/pickle.h"
+
+namespace history {
+
+namespace {
+
+// Written as the first int of the pickle. Bump this when the layout changes
+// so old files are ignored rather than misread.
+const int kSnapshotVersion = 1;
+
+const FilePath::CharType kSnapshotFileName[] =
+    FILE_PATH_LITERAL("Top Sites Thumbnails");
+
+}  // namespace
+
+// RefCountedMemory view of one thumbnail inside the mapped file. Holds a
+// reference to the snapshot so the mapping outlives the bytes handed out.
+class TopSitesSnapshot::MappedThumbnail : public base::RefCountedMemory {
+ public:
+  MappedThumbnail(const TopSitesSnapshot* snapshot,
+                  const unsigned char* data,
+                  size_t length)
+      : snapshot_(snapshot),
+        data_(data),
+        length_(length) {
+  }
+
+  // Overridden from base::RefCountedMemory:
+  virtual const unsigned char* front() const OVERRIDE { return data_; }
+  virtual size_t size() const OVERRIDE { return length_; }
+
+ private:
+  virtual ~MappedThumbnail() {}
+
+  scoped_refptr<const TopSitesSnapshot> snapshot_;
+  const unsigned char* data_;
+  size_t length_;
+
+  DISALLOW_COPY_AND_ASSIGN(MappedThumbnail);
+};
+
+// static
+FilePath TopSitesSnapshot::PathForDatabase(const FilePath& db_path) {
+  return db_path.DirName().Append(kSnapshotFileName);
+}
+
+// static
+scoped_refptr<TopSitesSnapshot> TopSitesSnapshot::Read(const FilePath& path) {
+  scoped_refptr<TopSitesSnapshot> snapshot(new TopSitesSnapshot());
+  if (!snapshot->file_->Initialize(path))
+    return NULL;
+  if (!snapshot->Parse())
+    return NULL;
+  return snapshot;
+}
+
+// static
+bool TopSitesSnapshot::Write(const FilePath& path,
+                             const MostVisitedURLList& urls,
+                             const URLToImagesMap& thumbnails) {
+  Pickle pickle;
+  pickle.WriteInt(kSnapshotVersion);
+  pickle.WriteInt(static_cast<int>(urls.size()));
+  for (size_t i = 0; i < urls.size(); ++i) {
+    pickle.WriteString(urls[i].url.spec());
+    pickle.WriteString16(urls[i].title);
+    URLToImagesMap::const_iterator image = thumbnails.find(urls[i].url);
+    if (image != thumbnails.end() && image->second.thumbnail.get()) {
+      pickle.WriteData(
+          reinterpret_cast<const char*>(image->second.thumbnail->front()),
+          static_cast<int>(image->second.thumbnail->size()));
+    } else {
+      pickle.WriteData("", 0);
+    }
+  }
+
+  // Write to a temporary file and rename it into place so that a reader never
+  // maps a partially written snapshot.
+  FilePath temp_path(path.value() + FILE_PATH_LITERAL(".tmp"));
+  int size = static_cast<int>(pickle.size());
+  if (file_util::WriteFile(temp_path,
+                           static_cast<const char*>(pickle.data()),
+                           size) != size) {
+    file_util::Delete(temp_path, false);
+    return false;
+  }
+  return file_util::ReplaceFile(temp_path, path);
+}
+
+bool TopSitesSnapshot::GetPageThumbnail(
+    const GURL& url,
+    scoped_refptr<base::RefCountedMemory>* bytes) const {
+  ThumbnailSpanMap::const_iterator found = thumbnails_.find(url);
+  if (found == thumbnails_.end())
+    return false;
+  *bytes = new MappedThumbnail(this, found->second.data,
+                               found->second.length);
+  return true;
+}
+
+TopSitesSnapshot::TopSitesSnapshot()
+    : file_(new file_util::MemoryMappedFile) {
+}
+
+TopSitesSnapshot::~TopSitesSnapshot() {
+}
+
+bool TopSitesSnapshot::Parse() {
+  Pickle pickle(reinterpret_cast<const char*>(file_->data()),
+                static_cast<int>(file_->length()));
+  PickleIterator iter(pickle);
+  int version = 0;
+  if (!pickle.ReadInt(&iter, &version) || version != kSnapshotVersion)
+    return false;
+  int count = 0;
+  if (!pickle.ReadInt(&iter, &count) || count < 0)
+    return false;
+
+  for (int i = 0; i < count; ++i) {
+    std::string spec;
+    MostVisitedURL url;
+    const char* data = NULL;
+    int data_length = 0;
+    if (!pickle.ReadString(&iter, &spec) ||
+        !pickle.ReadString16(&iter, &url.title) ||
+        !pickle.ReadData(&iter, &data, &data_length))
+      return false;
+    url.url = GURL(spec);
+    if (!url.url.is_valid())
+      return false;
+    url.redirects.push_back(url.url);
+    most_visited_.push_back(url);
+    if (data_length > 0) {
+      ThumbnailSpan& span = thumbnails_[url.url];
+      span.data = reinterpret_cast<const unsigned char*>(data);
+      span.length = static_cast<size_t>(data_length);
+    }
+  }
+  return true;
+}
+
+}  // namespace history
@@ -0,0 +1,89 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_HISTORY_TOP_SITES_SNAPSHOT_H_
+#define CHROME_BROWSER_HISTORY_TOP_SITES_SNAPSHOT_H_
+#pragma once
+
+#include <map>
+
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "chrome/browser/history/history_types.h"
+
+namespace base {
+class RefCountedMemory;
+}
+
+namespace history {
+
+// A memory-mapped flat-file copy of the top sites list and thumbnails.
+//
+// The top sites database is authoritative, but reading it takes a round trip
+// through the DB thread and a SQLite table scan, so at startup the new tab
+// page has nothing to show until that completes. TopSitesBackend keeps a
+// snapshot file ("Top Sites Thumbnails") next to the database; TopSites maps
+// it early in startup and serves the list and thumbnails out of the mapping
+// until the database load finishes. Thumbnail bytes handed out point directly
+// into the mapping, so during that window they are file-backed pages the OS
+// can evict rather than heap copies.
+//
+// The snapshot may be missing or stale; it is only ever a hint. Thumbnails
+// handed out keep the mapping alive for as long as anything references them.
+class TopSitesSnapshot
+    : public base::RefCountedThreadSafe<TopSitesSnapshot> {
+ public:
+  // Returns the path of the snapshot accompanying the database at |db_path|.
+  static FilePath PathForDatabase(const FilePath& db_path);
+
+  // Maps and parses the snapshot at |path|. Returns NULL if the file is
+  // missing or malformed. Does file access; call on a thread that allows it.
+  static scoped_refptr<TopSitesSnapshot> Read(const FilePath& path);
+
+  // Atomically rewrites the snapshot at |path| from |urls| and |thumbnails|.
+  // Returns true on success.
+  static bool Write(const FilePath& path,
+                    const MostVisitedURLList& urls,
+                    const URLToImagesMap& thumbnails);
+
+  const MostVisitedURLList& most_visited() const { return most_visited_; }
+
+  // Sets |bytes| to the stored thumbnail for |url|, pointing into the mapped
+  // file. Returns false if the snapshot has no thumbnail for |url|.
+  bool GetPageThumbnail(const GURL& url,
+                        scoped_refptr<base::RefCountedMemory>* bytes) const;
+
+ private:
+  friend class base::RefCountedThreadSafe<TopSitesSnapshot>;
+
+  class MappedThumbnail;
+
+  // Span of the mapped file holding one URL's encoded thumbnail.
+  struct ThumbnailSpan {
+    const unsigned char* data;
+    size_t length;
+  };
+  typedef std::map<GURL, ThumbnailSpan> ThumbnailSpanMap;
+
+  TopSitesSnapshot();
+  ~TopSitesSnapshot();
+
+  // Parses the mapped file into most_visited_ and thumbnails_. Returns false
+  // if the contents aren't a valid snapshot.
+  bool Parse();
+
+  scoped_ptr<file_util::MemoryMappedFile> file_;
+
+  MostVisitedURLList most_visited_;
+
+  ThumbnailSpanMap thumbnails_;
+
+  DISALLOW_COPY_AND_ASSIGN(TopSitesSnapshot);
+};
+
+}  // namespace history
+
+#endif  // CHROME_BROWSER_HISTORY_TOP_SITES_SNAPSHOT_H_
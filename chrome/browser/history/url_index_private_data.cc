@@ -60,6 +60,26 @@ const int kMaxTotalScore = 1425;
 // final calculation.
 const int kScoreRank[] = { 1450, 1200, 900, 400 };
 
+namespace {
+
+// Serializes |entry| and frames it with a leading record size so that journal
+// records can be concatenated by appending and later split apart again. The
+// journal never leaves the machine, so native byte order is fine, just as the
+// protobuf cache file itself is not portable. Returns an empty string on
+// serialization failure.
+std::string FrameJournalEntry(const imui::URLIndexJournalEntry& entry) {
+  std::string payload;
+  if (!entry.SerializeToString(&payload))
+    return std::string();
+  uint32 record_size = payload.size();
+  std::string record(reinterpret_cast<const char*>(&record_size),
+                     sizeof(record_size));
+  record += payload;
+  return record;
+}
+
+}  // namespace
+
 // SearchTermCacheItem ---------------------------------------------------------
 
 URLIndexPrivateData::SearchTermCacheItem::SearchTermCacheItem(
@@ -958,11 +978,104 @@ bool URLIndexPrivateData::SaveToFile(const FilePath& file_path) {
     LOG(WARNING) << "Failed to write " << file_path.value();
     return false;
   }
+
+  // The newly written cache reflects all changes, so the journal of changes
+  // accumulated since the previous save is no longer needed.
+  file_util::Delete(JournalFilePath(file_path), false);
+
   UMA_HISTOGRAM_TIMES("History.InMemoryURLIndexSaveCacheTime",
                       base::TimeTicks::Now() - beginning_time);
   return true;
 }
 
+// Journaling ------------------------------------------------------------------
+
+// static
+FilePath URLIndexPrivateData::JournalFilePath(
+    const FilePath& cache_file_path) {
+  return cache_file_path.AddExtension(FILE_PATH_LITERAL("journal"));
+}
+
+// static
+std::string URLIndexPrivateData::MakeJournalUpdateRecord(const URLRow& row) {
+  imui::URLIndexJournalEntry entry;
+  entry.set_op(imui::URLIndexJournalEntry::URL_UPDATED);
+  entry.set_url(row.url().spec());
+  entry.set_history_id(row.id());
+  entry.set_title(UTF16ToUTF8(row.title()));
+  entry.set_visit_count(row.visit_count());
+  entry.set_typed_count(row.typed_count());
+  entry.set_last_visit(row.last_visit().ToInternalValue());
+  return FrameJournalEntry(entry);
+}
+
+// static
+std::string URLIndexPrivateData::MakeJournalDeleteRecord(const GURL& url) {
+  imui::URLIndexJournalEntry entry;
+  entry.set_op(imui::URLIndexJournalEntry::URL_DELETED);
+  entry.set_url(url.spec());
+  return FrameJournalEntry(entry);
+}
+
+// static
+std::string URLIndexPrivateData::MakeJournalClearRecord() {
+  imui::URLIndexJournalEntry entry;
+  entry.set_op(imui::URLIndexJournalEntry::ALL_CLEARED);
+  return FrameJournalEntry(entry);
+}
+
+// static
+void URLIndexPrivateData::AppendToJournalFileTask(
+    const FilePath& cache_file_path,
+    const std::string& record) {
+  if (record.empty())
+    return;
+  file_util::AppendToFile(JournalFilePath(cache_file_path), record.data(),
+                          record.size());
+}
+
+void URLIndexPrivateData::ApplyJournal(
+    const FilePath& journal_path,
+    const std::string& languages,
+    const std::set<std::string>& scheme_whitelist) {
+  std::string contents;
+  if (!file_util::ReadFileToString(journal_path, &contents))
+    return;
+
+  size_t pos = 0;
+  while (pos + sizeof(uint32) <= contents.size()) {
+    uint32 record_size;
+    memcpy(&record_size, contents.data() + pos, sizeof(record_size));
+    pos += sizeof(record_size);
+    if (record_size > contents.size() - pos)
+      break;  // Torn final record.
+
+    imui::URLIndexJournalEntry entry;
+    if (!entry.ParseFromArray(contents.data() + pos,
+                              static_cast<int>(record_size)))
+      break;
+    pos += record_size;
+
+    switch (entry.op()) {
+      case imui::URLIndexJournalEntry::URL_UPDATED: {
+        URLRow row(GURL(entry.url()), entry.history_id());
+        row.set_title(UTF8ToUTF16(entry.title()));
+        row.set_visit_count(entry.visit_count());
+        row.set_typed_count(entry.typed_count());
+        row.set_last_visit(base::Time::FromInternalValue(entry.last_visit()));
+        UpdateURL(row, languages, scheme_whitelist);
+        break;
+      }
+      case imui::URLIndexJournalEntry::URL_DELETED:
+        DeleteURL(GURL(entry.url()));
+        break;
+      case imui::URLIndexJournalEntry::ALL_CLEARED:
+        Clear();
+        break;
+    }
+  }
+}
+
 void URLIndexPrivateData::SavePrivateData(
     InMemoryURLIndexCacheItem* cache) const {
   DCHECK(cache);
@@ -1094,46 +1207,55 @@ void URLIndexPrivateData::SaveWordStartsMap(
 void URLIndexPrivateData::RestoreFromFileTask(
     const FilePath& file_path,
     scoped_refptr<URLIndexPrivateData> private_data,
-    std::string languages) {
-  private_data = URLIndexPrivateData::RestoreFromFile(file_path, languages);
+    std::string languages,
+    std::set<std::string> scheme_whitelist) {
+  DCHECK(private_data.get());
+  if (!private_data->RestoreFromFile(file_path, languages, scheme_whitelist))
+    private_data->Clear();
 }
 
-// static
-scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::RestoreFromFile(
+bool URLIndexPrivateData::RestoreFromFile(
     const FilePath& file_path,
-    const std::string& languages) {
+    const std::string& languages,
+    const std::set<std::string>& scheme_whitelist) {
   base::TimeTicks beginning_time = base::TimeTicks::Now();
-  if (!file_util::PathExists(file_path))
-    return NULL;
-  std::string data;
+  Clear();
   // If there is no cache file then simply give up. This will cause us to
   // attempt to rebuild from the history database.
-  if (!file_util::ReadFileToString(file_path, &data))
-    return NULL;
+  if (!file_util::PathExists(file_path))
+    return false;
+
+  // Map the cache rather than reading it: the parse runs straight over the
+  // page cache without first copying the file into a temporary buffer.
+  file_util::MemoryMappedFile cache_file;
+  if (!cache_file.Initialize(file_path))
+    return false;
 
-  scoped_refptr<URLIndexPrivateData> restored_data(new URLIndexPrivateData);
   InMemoryURLIndexCacheItem index_cache;
-  if (!index_cache.ParseFromArray(data.c_str(), data.size())) {
+  if (!index_cache.ParseFromArray(cache_file.data(),
+                                  static_cast<int>(cache_file.length()))) {
     LOG(WARNING) << "Failed to parse URLIndexPrivateData cache data read from "
                  << file_path.value();
-    return restored_data;
+    return false;
   }
 
-  if (!restored_data->RestorePrivateData(index_cache, languages))
-    return NULL;
+  if (!RestorePrivateData(index_cache, languages))
+    return false;
+
+  // Bring the restored data up to date with any changes journaled since the
+  // cache file was last written.
+  ApplyJournal(JournalFilePath(file_path), languages, scheme_whitelist);
 
   UMA_HISTOGRAM_TIMES("History.InMemoryURLIndexRestoreCacheTime",
                       base::TimeTicks::Now() - beginning_time);
   UMA_HISTOGRAM_COUNTS("History.InMemoryURLHistoryItems",
-                       restored_data->history_id_word_map_.size());
-  UMA_HISTOGRAM_COUNTS("History.InMemoryURLCacheSize", data.size());
-  UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLWords",
-                             restored_data->word_map_.size());
+                       history_id_word_map_.size());
+  UMA_HISTOGRAM_COUNTS("History.InMemoryURLCacheSize", cache_file.length());
+  UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLWords", word_map_.size());
   UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLChars",
-                             restored_data->char_word_map_.size());
-  if (restored_data->Empty())
-    return NULL;  // 'No data' is the same as a failed reload.
-  return restored_data;
+                             char_word_map_.size());
+  // 'No data' is the same as a failed reload.
+  return !Empty();
 }
 
 // static
@@ -40,6 +40,10 @@ class URLIndexPrivateData
  public:
   URLIndexPrivateData();
 
+  // Returns the path of the incremental-change journal kept beside the cache
+  // file at |cache_file_path|.
+  static FilePath JournalFilePath(const FilePath& cache_file_path);
+
  private:
   friend class base::RefCountedThreadSafe<URLIndexPrivateData>;
   ~URLIndexPrivateData();
@@ -139,22 +143,25 @@ class URLIndexPrivateData
   // to this function.
   ScoredHistoryMatches HistoryItemsForTerms(const string16& term_string);
 
-  // Creates a new URLIndexPrivateData object, populates it from the contents
-  // of the cache file stored in |file_path|, and assigns it to |private_data|.
-  // |languages| will be used to break URLs and page titles into words and is
-  // deliberately passed by value.
+  // Populates |private_data| from the contents of the cache file stored in
+  // |file_path| and the journal kept beside it. |private_data| will be empty
+  // upon failure. |languages| will be used to break URLs and page titles into
+  // words and is deliberately passed by value, as is |scheme_whitelist|.
   static void RestoreFromFileTask(
       const FilePath& file_path,
       scoped_refptr<URLIndexPrivateData> private_data,
-      std::string languages);
-
-  // Constructs a new object by restoring its contents from the file at |path|.
-  // Returns the new URLIndexPrivateData which on success will contain the
-  // restored data but upon failure will be empty.  |languages| will be used to
-  // break URLs and page titles into words
-  static scoped_refptr<URLIndexPrivateData> RestoreFromFile(
-      const FilePath& path,
-      const std::string& languages);
+      std::string languages,
+      std::set<std::string> scheme_whitelist);
+
+  // Restores this object's contents from the file at |path| by memory-mapping
+  // the cache and decoding it in place, then replaying the journal of changes
+  // made since the cache was written. Returns true if the restored index holds
+  // data; upon failure the object is left empty and the caller should fall
+  // back to rebuilding from the history database. |languages| will be used to
+  // break URLs and page titles into words.
+  bool RestoreFromFile(const FilePath& path,
+                       const std::string& languages,
+                       const std::set<std::string>& scheme_whitelist);
 
   // Constructs a new object by rebuilding its contents from the history
   // database in |history_db|. Returns the new URLIndexPrivateData which on
@@ -174,9 +181,30 @@ class URLIndexPrivateData
       scoped_refptr<RefCountedBool> succeeded);
 
   // Caches the index private data and writes the cache file to the profile
-  // directory.  Called by WritePrivateDataToCacheFileTask.
+  // directory, then deletes the journal, whose entries the new file subsumes.
+  // Called by WritePrivateDataToCacheFileTask.
   bool SaveToFile(const FilePath& file_path);
 
+  // Build length-framed journal records describing a single change, ready to
+  // be handed to AppendToJournalFileTask(). Return an empty string on
+  // serialization failure, which AppendToJournalFileTask() ignores.
+  static std::string MakeJournalUpdateRecord(const URLRow& row);
+  static std::string MakeJournalDeleteRecord(const GURL& url);
+  static std::string MakeJournalClearRecord();
+
+  // Appends |record| to the journal kept beside the cache file at
+  // |cache_file_path|. Runs on the FILE thread.
+  static void AppendToJournalFileTask(const FilePath& cache_file_path,
+                                      const std::string& record);
+
+  // Replays the journal at |journal_path| on top of this object, bringing a
+  // freshly restored cache up to date with changes made after the cache file
+  // was written. Entries are applied oldest first; a torn final record (from
+  // losing power mid-append) is expected and ignored.
+  void ApplyJournal(const FilePath& journal_path,
+                    const std::string& languages,
+                    const std::set<std::string>& scheme_whitelist);
+
   // Initializes all index data members in preparation for restoring the index
   // from the cache or a complete rebuild from the history database.
   void Clear();
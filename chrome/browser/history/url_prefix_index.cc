@@ -0,0 +1,149 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/history/url_prefix_index.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/stl_util.h"
+#include "googleurl/src/gurl.h"
+
+namespace history {
+
+namespace {
+
+// Sorts rows the way URLDatabase::AutocompleteForPrefix() does: most typed
+// first, breaking ties by visit count and then by recency.
+bool CompareRowQuality(const URLRow& a, const URLRow& b) {
+  if (a.typed_count() != b.typed_count())
+    return a.typed_count() > b.typed_count();
+  if (a.visit_count() != b.visit_count())
+    return a.visit_count() > b.visit_count();
+  return a.last_visit() > b.last_visit();
+}
+
+}  // namespace
+
+struct URLPrefixIndex::Node {
+  Node() {}
+  ~Node() {
+    STLDeleteContainerPairSecondPointers(children.begin(), children.end());
+  }
+
+  // Set when an indexed URL ends at this node.
+  scoped_ptr<URLRow> row;
+
+  std::map<char, Node*> children;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(Node);
+};
+
+URLPrefixIndex::URLPrefixIndex() : root_(new Node), size_(0) {
+}
+
+URLPrefixIndex::~URLPrefixIndex() {
+  delete root_;
+}
+
+void URLPrefixIndex::Add(const URLRow& row) {
+  if (row.hidden() || row.typed_count() <= 0) {
+    Remove(row.url());
+    return;
+  }
+
+  const std::string& spec = row.url().spec();
+  Node* node = root_;
+  for (size_t i = 0; i < spec.size(); ++i) {
+    Node*& child = node->children[spec[i]];
+    if (!child)
+      child = new Node;
+    node = child;
+  }
+  if (!node->row.get())
+    ++size_;
+  node->row.reset(new URLRow(row));
+}
+
+void URLPrefixIndex::Remove(const GURL& url) {
+  const std::string& spec = url.spec();
+
+  // Walk down to the URL's node, remembering the path so empty nodes can be
+  // pruned on the way back up.
+  std::vector<Node*> path;
+  path.reserve(spec.size() + 1);
+  Node* node = root_;
+  path.push_back(node);
+  for (size_t i = 0; i < spec.size(); ++i) {
+    std::map<char, Node*>::iterator it = node->children.find(spec[i]);
+    if (it == node->children.end())
+      return;  // Not indexed.
+    node = it->second;
+    path.push_back(node);
+  }
+  if (!node->row.get())
+    return;  // A longer URL passes through here, but none ends here.
+  node->row.reset();
+  --size_;
+
+  for (size_t i = path.size() - 1; i > 0; --i) {
+    Node* child = path[i];
+    if (child->row.get() || !child->children.empty())
+      break;
+    path[i - 1]->children.erase(spec[i - 1]);
+    delete child;
+  }
+}
+
+void URLPrefixIndex::Clear() {
+  delete root_;
+  root_ = new Node;
+  size_ = 0;
+}
+
+bool URLPrefixIndex::GetURLsForPrefix(const std::string& prefix,
+                                      size_t max_results,
+                                      URLRows* results) const {
+  results->clear();
+
+  const Node* node = FindNode(prefix);
+  if (!node)
+    return false;
+
+  CollectRows(node, results);
+  if (results->size() > max_results) {
+    std::partial_sort(results->begin(), results->begin() + max_results,
+                      results->end(), CompareRowQuality);
+    results->resize(max_results);
+  } else {
+    std::sort(results->begin(), results->end(), CompareRowQuality);
+  }
+  return !results->empty();
+}
+
+const URLPrefixIndex::Node* URLPrefixIndex::FindNode(
+    const std::string& key) const {
+  const Node* node = root_;
+  for (size_t i = 0; i < key.size(); ++i) {
+    std::map<char, Node*>::const_iterator it = node->children.find(key[i]);
+    if (it == node->children.end())
+      return NULL;
+    node = it->second;
+  }
+  return node;
+}
+
+// static
+void URLPrefixIndex::CollectRows(const Node* node, URLRows* results) {
+  if (node->row.get())
+    results->push_back(*node->row);
+  for (std::map<char, Node*>::const_iterator it = node->children.begin();
+       it != node->children.end(); ++it) {
+    CollectRows(it->second, results);
+  }
+}
+
+}  // namespace history
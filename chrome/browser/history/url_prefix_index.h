@@ -0,0 +1,77 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_HISTORY_URL_PREFIX_INDEX_H_
+#define CHROME_BROWSER_HISTORY_URL_PREFIX_INDEX_H_
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "chrome/browser/history/history_types.h"
+
+class GURL;
+
+namespace history {
+
+// A compact in-memory index of typed URLs keyed by their spec, kept up to
+// date by InMemoryHistoryBackend. HistoryURLProvider's synchronous pass uses
+// it to find candidate URLs for a prefix with a trie walk instead of issuing
+// a SQL range scan against the in-memory database on every keystroke; the
+// database is still consulted for data the index does not carry (visits,
+// keyword search terms, etc.).
+//
+// Only URLs with a non-zero typed count are indexed, matching what
+// URLDatabase::AutocompleteForPrefix() returns for typed-only queries.
+class URLPrefixIndex {
+ public:
+  URLPrefixIndex();
+  ~URLPrefixIndex();
+
+  // Adds |row| to the index, replacing any existing entry for the same URL.
+  // Rows that are hidden or have no typed visits are removed instead, so
+  // callers can simply feed through modified rows.
+  void Add(const URLRow& row);
+
+  // Removes the entry for |url|, if any.
+  void Remove(const GURL& url);
+
+  // Removes all entries from the index.
+  void Clear();
+
+  // Fills |results| with up to |max_results| indexed rows whose spec starts
+  // with |prefix|, ordered by typed count, then visit count, then recency --
+  // the same order URLDatabase::AutocompleteForPrefix() produces. Returns
+  // true if any matches were found.
+  bool GetURLsForPrefix(const std::string& prefix,
+                        size_t max_results,
+                        URLRows* results) const;
+
+  // Returns the number of indexed URLs.
+  size_t size() const { return size_; }
+
+ private:
+  // A trie node. Each edge is labelled with one character of the URL spec; a
+  // node at which an indexed URL ends owns a copy of its row.
+  struct Node;
+
+  // Returns the node reached by walking |key| from the root, or NULL if the
+  // walk falls off the trie.
+  const Node* FindNode(const std::string& key) const;
+
+  // Appends the rows of all URLs ending at or below |node| to |results|.
+  static void CollectRows(const Node* node, URLRows* results);
+
+  Node* root_;
+
+  // Number of indexed URLs, maintained so size() need not walk the trie.
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLPrefixIndex);
+};
+
+}  // namespace history
+
+#endif  // CHROME_BROWSER_HISTORY_URL_PREFIX_INDEX_H_
@@ -0,0 +1,105 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/history/url_prefix_index.h"
+
+#include "base/time.h"
+#include "chrome/browser/history/history_types.h"
+#include "googleurl/src/gurl.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace history {
+
+namespace {
+
+URLRow MakeRow(const std::string& url, int typed_count, int visit_count) {
+  URLRow row((GURL(url)));
+  row.set_typed_count(typed_count);
+  row.set_visit_count(visit_count);
+  row.set_last_visit(base::Time::Now());
+  return row;
+}
+
+}  // namespace
+
+class URLPrefixIndexTest : public testing::Test {
+};
+
+TEST_F(URLPrefixIndexTest, AddRemove) {
+  URLPrefixIndex index;
+  EXPECT_EQ(0U, index.size());
+
+  index.Add(MakeRow("http://www.google.com/", 2, 5));
+  index.Add(MakeRow("http://www.google.com/mail", 1, 3));
+  EXPECT_EQ(2U, index.size());
+
+  // Re-adding an existing URL replaces it rather than duplicating it.
+  index.Add(MakeRow("http://www.google.com/", 3, 6));
+  EXPECT_EQ(2U, index.size());
+
+  // Removing a URL that shares a prefix with another must not disturb the
+  // other.
+  index.Remove(GURL("http://www.google.com/"));
+  EXPECT_EQ(1U, index.size());
+  URLRows results;
+  EXPECT_TRUE(index.GetURLsForPrefix("http://www.google.com/", 10, &results));
+  ASSERT_EQ(1U, results.size());
+  EXPECT_EQ(GURL("http://www.google.com/mail"), results[0].url());
+
+  // Removing a URL that isn't indexed is a no-op.
+  index.Remove(GURL("http://example.com/"));
+  EXPECT_EQ(1U, index.size());
+}
+
+TEST_F(URLPrefixIndexTest, SkipsHiddenAndUntyped) {
+  URLPrefixIndex index;
+
+  URLRow hidden(MakeRow("http://hidden.com/", 1, 1));
+  hidden.set_hidden(true);
+  index.Add(hidden);
+  index.Add(MakeRow("http://untyped.com/", 0, 4));
+  EXPECT_EQ(0U, index.size());
+
+  // A row whose typed count drops to zero falls out of the index.
+  index.Add(MakeRow("http://typed.com/", 1, 1));
+  EXPECT_EQ(1U, index.size());
+  index.Add(MakeRow("http://typed.com/", 0, 2));
+  EXPECT_EQ(0U, index.size());
+}
+
+TEST_F(URLPrefixIndexTest, PrefixMatchOrdering) {
+  URLPrefixIndex index;
+  index.Add(MakeRow("http://www.apple.com/", 1, 2));
+  index.Add(MakeRow("http://www.amazon.com/", 5, 10));
+  index.Add(MakeRow("http://www.amazon.com/books", 2, 2));
+  index.Add(MakeRow("https://www.android.com/", 3, 3));
+
+  URLRows results;
+  ASSERT_TRUE(index.GetURLsForPrefix("http://www.a", 10, &results));
+  ASSERT_EQ(3U, results.size());
+  // Ordered by typed count, descending.
+  EXPECT_EQ(GURL("http://www.amazon.com/"), results[0].url());
+  EXPECT_EQ(GURL("http://www.amazon.com/books"), results[1].url());
+  EXPECT_EQ(GURL("http://www.apple.com/"), results[2].url());
+
+  // The limit keeps only the best matches.
+  ASSERT_TRUE(index.GetURLsForPrefix("http://www.a", 1, &results));
+  ASSERT_EQ(1U, results.size());
+  EXPECT_EQ(GURL("http://www.amazon.com/"), results[0].url());
+
+  // Prefixes with no matches report none.
+  EXPECT_FALSE(index.GetURLsForPrefix("ftp://", 10, &results));
+  EXPECT_TRUE(results.empty());
+}
+
+TEST_F(URLPrefixIndexTest, Clear) {
+  URLPrefixIndex index;
+  index.Add(MakeRow("http://www.google.com/", 1, 1));
+  index.Clear();
+  EXPECT_EQ(0U, index.size());
+  URLRows results;
+  EXPECT_FALSE(index.GetURLsForPrefix("http://", 10, &results));
+}
+
+}  // namespace history
@@ -4,8 +4,12 @@
 
 #include "chrome/browser/memory_details.h"
 
+#include <map>
+
+#include "base/allocator/sampled_heap_profiler.h"
 #include "base/bind.h"
 #include "base/file_version_info.h"
+#include "base/lazy_instance.h"
 #include "base/metrics/histogram.h"
 #include "base/process_util.h"
 #include "base/string_util.h"
@@ -16,6 +20,7 @@
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/common/chrome_view_type.h"
 #include "chrome/common/extensions/extension.h"
+#include "chrome/common/render_messages.h"
 #include "chrome/common/url_constants.h"
 #include "content/public/browser/browser_child_process_host_iterator.h"
 #include "content/public/browser/browser_thread.h"
@@ -44,6 +49,16 @@ using content::RenderViewHost;
 using content::RenderWidgetHost;
 using content::WebContents;
 
+namespace {
+
+// The latest sampled heap report received from each child process, keyed
+// by pid.  Refreshed as renderers answer ChromeViewMsg_GetHeapSample;
+// read by the next fetch.  UI thread only.
+typedef std::map<base::ProcessId, std::string> HeapSampleMap;
+base::LazyInstance<HeapSampleMap> g_heap_samples = LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
 // static
 std::string ProcessMemoryInformation::GetRendererTypeNameInEnglish(
     RendererProcessType type) {
@@ -132,6 +147,13 @@ void MemoryDetails::StartFetch(UserMetricsMode user_metrics_mode) {
 
 MemoryDetails::~MemoryDetails() {}
 
+// static
+void MemoryDetails::SetHeapSampleForProcess(base::ProcessId pid,
+                                            const std::string& report) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  g_heap_samples.Get()[pid] = report;
+}
+
 std::string MemoryDetails::ToLogString() {
   std::string log;
   log.reserve(4096);
@@ -192,6 +214,18 @@ void MemoryDetails::CollectChildInfoOnUIThread() {
       content::ZygoteHost::GetInstance()->GetSandboxHelperPid();
 #endif
 
+  // Ask each renderer for a fresh sampled heap report.  The replies
+  // arrive asynchronously, so the reports attached below come from the
+  // previous request; about:memory refreshes often enough that the lag
+  // doesn't matter in practice.
+  for (content::RenderProcessHost::iterator renderer_iter(
+          content::RenderProcessHost::AllHostsIterator());
+       !renderer_iter.IsAtEnd(); renderer_iter.Advance()) {
+    content::RenderProcessHost* host = renderer_iter.GetCurrentValue();
+    if (host->HasConnection())
+      host->Send(new ChromeViewMsg_GetHeapSample);
+  }
+
   ProcessData* const chrome_browser = ChromeBrowser();
   // Get more information about the process.
   for (size_t index = 0; index < chrome_browser->processes.size();
@@ -332,6 +366,18 @@ void MemoryDetails::CollectChildInfoOnUIThread() {
       }
     }
 
+    // Attach the heap attribution data: the browser's own sampler can be
+    // read in place, child processes report theirs over IPC.
+    if (process.pid == base::GetCurrentProcId()) {
+      process.heap_sample_report =
+          base::allocator::SampledHeapProfiler::GetReport();
+    } else {
+      HeapSampleMap::const_iterator sample =
+          g_heap_samples.Get().find(process.pid);
+      if (sample != g_heap_samples.Get().end())
+        process.heap_sample_report = sample->second;
+    }
+
 #if defined(OS_POSIX) && !defined(OS_MACOSX) && !defined(OS_ANDROID)
     if (process.pid == zygote_pid) {
       process.type = content::PROCESS_TYPE_ZYGOTE;
@@ -6,6 +6,7 @@
 #define CHROME_BROWSER_MEMORY_DETAILS_H_
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include "base/memory/ref_counted.h"
@@ -60,6 +61,9 @@ struct ProcessMemoryInformation {
   RendererProcessType renderer_type;
   // A collection of titles used, i.e. for a tab it'll show all the page titles.
   std::vector<string16> titles;
+  // The sampled heap call-site report for this process, if one has been
+  // collected.  One "<address> <allocs> <bytes>" line per call site.
+  std::string heap_sample_report;
 };
 
 typedef std::vector<ProcessMemoryInformation> ProcessMemoryInformationList;
@@ -127,6 +131,12 @@ class MemoryDetails : public base::RefCountedThreadSafe<MemoryDetails> {
 
   virtual void OnDetailsAvailable() = 0;
 
+  // Stores the latest sampled heap report received from the process |pid|
+  // so the next fetch can attach it to that process's entry.  Called on
+  // the UI thread as renderers answer ChromeViewMsg_GetHeapSample.
+  static void SetHeapSampleForProcess(base::ProcessId pid,
+                                      const std::string& report);
+
   // Returns a string summarizing memory usage of the Chrome browser process
   // and all sub-processes, suitable for logging.
   std::string ToLogString();
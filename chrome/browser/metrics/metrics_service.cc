@@ -872,9 +872,46 @@ void MetricsService::StartRecording() {
 }
 
 void MetricsService::StopRecording() {
-  if (!log_manager_.current_log())
+  if (!PrepareCurrentLogForClose())
     return;
 
+  log_manager_.FinishCurrentLog();
+}
+
+void MetricsService::StopRecordingAsync(const base::Closure& done_callback) {
+  if (!PrepareCurrentLogForClose()) {
+    done_callback.Run();
+    return;
+  }
+
+  // Hand the closed log off to the blocking pool for the expensive XML and
+  // protobuf encoding and compression, keeping the UI thread free of
+  // metrics work; OnCurrentLogSerialized() stores the result.
+  MetricsLogManager::LogType log_type = MetricsLogManager::NO_LOG;
+  MetricsLogBase* log = log_manager_.ReleaseCurrentLog(&log_type);
+  MetricsLogManager::SerializedLog* serialized =
+      new MetricsLogManager::SerializedLog;
+  BrowserThread::PostBlockingPoolTaskAndReply(
+      FROM_HERE,
+      base::Bind(&MetricsLogManager::SerializeAndCompressLog,
+                 base::Owned(log), serialized),
+      base::Bind(&MetricsService::OnCurrentLogSerialized,
+                 self_ptr_factory_.GetWeakPtr(),
+                 done_callback, log_type, base::Owned(serialized)));
+}
+
+void MetricsService::OnCurrentLogSerialized(
+    const base::Closure& done_callback,
+    MetricsLogManager::LogType log_type,
+    MetricsLogManager::SerializedLog* serialized) {
+  log_manager_.StoreSerializedLog(serialized, log_type);
+  done_callback.Run();
+}
+
+bool MetricsService::PrepareCurrentLogForClose() {
+  if (!log_manager_.current_log())
+    return false;
+
   // TODO(jar): Integrate bounds on log recording more consistently, so that we
   // can stop recording logs that are too big much sooner.
   if (log_manager_.current_log()->num_events() > kEventLimit) {
@@ -898,7 +935,7 @@ void MetricsService::StopRecording() {
   current_log->RecordIncrementalStabilityElements(plugins_);
   RecordCurrentHistograms();
 
-  log_manager_.FinishCurrentLog();
+  return true;
 }
 
 void MetricsService::PushPendingLogsToPersistentStorage() {
@@ -1012,8 +1049,14 @@ void MetricsService::OnFinalLogInfoCollectionDone() {
     return;
   }
 
-  MakeStagedLog();
+  // Making the staged log may involve serializing and compressing the
+  // current log on the blocking pool; the upload continues in
+  // OnMakeStagedLogComplete() once a log is staged.
+  MakeStagedLog(base::Bind(&MetricsService::OnMakeStagedLogComplete,
+                           self_ptr_factory_.GetWeakPtr()));
+}
 
+void MetricsService::OnMakeStagedLogComplete() {
   // MakeStagedLog should have prepared log text; if it didn't, skip this
   // upload and hope things work out next time.
   if (log_manager_.staged_log_text().empty()) {
@@ -1024,9 +1067,11 @@ void MetricsService::OnFinalLogInfoCollectionDone() {
   SendStagedLog();
 }
 
-void MetricsService::MakeStagedLog() {
-  if (log_manager_.has_staged_log())
+void MetricsService::MakeStagedLog(const base::Closure& done_callback) {
+  if (log_manager_.has_staged_log()) {
+    done_callback.Run();
     return;
+  }
 
   switch (state_) {
     case INITIALIZED:
@@ -1053,10 +1098,14 @@ void MetricsService::MakeStagedLog() {
       // Fall through.
 
     case SENDING_CURRENT_LOGS:
-      StopRecording();
+      // Close the current log and serialize and compress it off the UI
+      // thread; OnRecordingStoppedForUpload() stages it once it has been
+      // stored. A new log is opened right away so no events are lost.
+      StopRecordingAsync(
+          base::Bind(&MetricsService::OnRecordingStoppedForUpload,
+                     self_ptr_factory_.GetWeakPtr(), done_callback));
       StartRecording();
-      log_manager_.StageNextLogForUpload();
-      break;
+      return;
 
     default:
       NOTREACHED();
@@ -1064,6 +1113,17 @@ void MetricsService::MakeStagedLog() {
   }
 
   DCHECK(log_manager_.has_staged_log());
+  done_callback.Run();
+}
+
+void MetricsService::OnRecordingStoppedForUpload(
+    const base::Closure& done_callback) {
+  // The closed log may have been dropped if its compression failed, in
+  // which case there may be nothing to stage; OnMakeStagedLogComplete()
+  // treats an empty staged log as a cancelled upload.
+  if (!log_manager_.has_staged_log() && log_manager_.has_unsent_logs())
+    log_manager_.StageNextLogForUpload();
+  done_callback.Run();
 }
 
 void MetricsService::PrepareInitialLog() {
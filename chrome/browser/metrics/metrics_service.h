@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/callback.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -223,6 +224,23 @@ class MetricsService
   // Adds any last information to current_log_ and then stages it for upload.
   void StopRecording();
 
+  // Helper for StopRecording() and StopRecordingAsync(): adds the final
+  // information (environment, stability and histogram deltas) to
+  // current_log_. Returns false if there is no log to close.
+  bool PrepareCurrentLogForClose();
+
+  // Like StopRecording(), except that serialization and compression of the
+  // closed log run on the blocking pool instead of the UI thread. Once the
+  // log has been stored as an unsent log, |done_callback| is run on the UI
+  // thread.
+  void StopRecordingAsync(const base::Closure& done_callback);
+
+  // Stores a log serialized on the blocking pool by StopRecordingAsync(),
+  // then runs |done_callback|. Do not call directly.
+  void OnCurrentLogSerialized(const base::Closure& done_callback,
+                              MetricsLogManager::LogType log_type,
+                              MetricsLogManager::SerializedLog* serialized);
+
   // Pushes the text of the current and staged logs into persistent storage.
   // Called when Chrome shuts down.
   void PushPendingLogsToPersistentStorage();
@@ -244,9 +262,20 @@ class MetricsService
   void OnFinalLogInfoCollectionDone();
 
   // Takes whatever log should be uploaded next (according to the state_)
-  // and makes it the staged log.  If there is already a staged log, this is a
-  // no-op.
-  void MakeStagedLog();
+  // and makes it the staged log. If there is already a staged log, this is a
+  // no-op. When the current log has to be closed first, its serialization
+  // and compression run on the blocking pool, so |done_callback| may be run
+  // either synchronously or asynchronously on the UI thread.
+  void MakeStagedLog(const base::Closure& done_callback);
+
+  // Stages the log stored by StopRecordingAsync() during MakeStagedLog(),
+  // then runs |done_callback|.
+  void OnRecordingStoppedForUpload(const base::Closure& done_callback);
+
+  // Continuation of StartScheduledUpload(), run once MakeStagedLog() has
+  // finished; sends the staged log, or tells the scheduler the upload was
+  // cancelled if there is none.
+  void OnMakeStagedLogComplete();
 
   // Record stats, client ID, Session ID, etc. in a special "first" log.
   void PrepareInitialLog();
@@ -13,10 +13,19 @@
 #include "chrome/browser/net/net_log_logger.h"
 #include "chrome/common/chrome_switches.h"
 
+namespace {
+
+// Capacity of the always-on ring of recent events.  Must be a power of two.
+const size_t kRecentEventRingSize = 4096;
+
+}  // namespace
+
 ChromeNetLog::ChromeNetLog()
     : last_id_(0),
       base_log_level_(LOG_BASIC),
       effective_log_level_(LOG_BASIC),
+      num_observers_(0),
+      recent_events_(kRecentEventRingSize),
       load_timing_observer_(new LoadTimingObserver()) {
   const CommandLine* command_line = CommandLine::ForCurrentProcess();
   // Adjust base log level based on command line switch, if present.
@@ -56,6 +65,16 @@ void ChromeNetLog::AddEntry(
     const scoped_refptr<EventParameters>& params) {
   base::TimeTicks time(base::TimeTicks::Now());
 
+  // Record the event in the always-on ring first; this is lock-free, so it
+  // is safe (and cheap) to do on the IO thread.
+  recent_events_.Add(type, time, source, phase);
+
+  // Don't take |lock_| at all when nobody is watching.  An observer that is
+  // being attached concurrently may miss this event, but events racing with
+  // registration have no delivery guarantee to begin with.
+  if (base::subtle::NoBarrier_Load(&num_observers_) == 0)
+    return;
+
   base::AutoLock lock(lock_);
 
   // Notify all of the log observers.
@@ -63,6 +82,11 @@ void ChromeNetLog::AddEntry(
                     OnAddEntry(type, time, source, phase, params));
 }
 
+void ChromeNetLog::GetRecentEvents(
+    std::vector<net::NetLogEventRing::Entry>* entries) const {
+  recent_events_.GetEntries(entries);
+}
+
 uint32 ChromeNetLog::NextID() {
   return base::subtle::NoBarrier_AtomicIncrement(&last_id_, 1);
 }
@@ -80,6 +104,7 @@ void ChromeNetLog::AddThreadSafeObserver(
 
   observers_.AddObserver(observer);
   OnAddObserver(observer, log_level);
+  base::subtle::NoBarrier_AtomicIncrement(&num_observers_, 1);
   UpdateLogLevel();
 }
 
@@ -100,6 +125,7 @@ void ChromeNetLog::RemoveThreadSafeObserver(
   DCHECK(observers_.HasObserver(observer));
   observers_.RemoveObserver(observer);
   OnRemoveObserver(observer);
+  base::subtle::NoBarrier_AtomicIncrement(&num_observers_, -1);
   UpdateLogLevel();
 }
 
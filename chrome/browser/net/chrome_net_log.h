@@ -6,12 +6,15 @@
 #define CHROME_BROWSER_NET_CHROME_NET_LOG_H_
 #pragma once
 
+#include <vector>
+
 #include "base/atomicops.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/observer_list.h"
 #include "base/synchronization/lock.h"
 #include "base/time.h"
 #include "net/base/net_log.h"
+#include "net/base/net_log_event_ring.h"
 
 class LoadTimingObserver;
 class NetLogLogger;
@@ -40,6 +43,14 @@ class ChromeNetLog : public net::NetLog {
     return load_timing_observer_.get();
   }
 
+  // Appends a snapshot of the most recently logged events to |entries|,
+  // oldest first.  These are captured continuously, whether or not any
+  // observer is attached, so a log of the events leading up to a problem is
+  // available after the fact.  Parameters are not captured.  Can be called
+  // on any thread.
+  void GetRecentEvents(
+      std::vector<net::NetLogEventRing::Entry>* entries) const;
+
  private:
   // NetLog implementation:
   virtual void AddEntry(EventType type,
@@ -64,6 +75,15 @@ class ChromeNetLog : public net::NetLog {
   // The current log level.
   base::subtle::Atomic32 effective_log_level_;
 
+  // The number of attached observers.  Only modified with |lock_| held, but
+  // read without it by AddEntry() to skip taking the lock entirely when
+  // nobody is watching.
+  base::subtle::Atomic32 num_observers_;
+
+  // Lock-free ring holding the last few thousand events, so AddEntry() can
+  // record them at near zero cost on the IO thread.  See GetRecentEvents().
+  net::NetLogEventRing recent_events_;
+
   scoped_ptr<LoadTimingObserver> load_timing_observer_;
   scoped_ptr<NetLogLogger> net_log_logger_;
 
@@ -31,6 +31,7 @@
 #include "content/public/browser/browser_thread.h"
 #include "net/base/address_list.h"
 #include "net/base/completion_callback.h"
+#include "net/base/host_cache.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/host_resolver.h"
 #include "net/base/net_errors.h"
@@ -157,6 +158,8 @@ void Predictor::RegisterUserPrefs(PrefService* user_prefs) {
                                PrefService::UNSYNCABLE_PREF);
   user_prefs->RegisterListPref(prefs::kDnsPrefetchingHostReferralList,
                                PrefService::UNSYNCABLE_PREF);
+  user_prefs->RegisterListPref(prefs::kDnsHostCacheSnapshot,
+                               PrefService::UNSYNCABLE_PREF);
 }
 
 // --------------------- Start UI methods. ------------------------------------
@@ -179,13 +182,17 @@ void Predictor::InitNetworkPredictor(PrefService* user_prefs,
       static_cast<base::ListValue*>(user_prefs->GetList(
           prefs::kDnsPrefetchingHostReferralList)->DeepCopy());
 
+  base::ListValue* host_cache_snapshot =
+      static_cast<base::ListValue*>(user_prefs->GetList(
+          prefs::kDnsHostCacheSnapshot)->DeepCopy());
+
   BrowserThread::PostTask(
       BrowserThread::IO,
       FROM_HERE,
       base::Bind(
           &Predictor::FinalizeInitializationOnIOThread,
           base::Unretained(this),
-          urls, referral_list,
+          urls, referral_list, host_cache_snapshot,
           io_thread, predictor_enabled));
 }
 
@@ -650,6 +657,7 @@ void Predictor::DiscardInitialNavigationHistory() {
 void Predictor::FinalizeInitializationOnIOThread(
     const UrlList& startup_urls,
     base::ListValue* referral_list,
+    base::ListValue* host_cache_snapshot,
     IOThread* io_thread,
     bool predictor_enabled) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
@@ -658,6 +666,10 @@ void Predictor::FinalizeInitializationOnIOThread(
   initial_observer_.reset(new InitialObserver());
   host_resolver_ = io_thread->globals()->host_resolver.get();
 
+  // Warm the resolver cache with last session's answers before issuing any
+  // startup resolutions, so that still-valid entries are hits.
+  PrewarmHostCacheThenDelete(host_cache_snapshot);
+
   // base::WeakPtrFactory instances need to be created and destroyed
   // on the same thread. The predictor lives on the IO thread and will die
   // from there so now that we're on the IO thread we need to properly
@@ -728,6 +740,7 @@ void Predictor::DnsPrefetchMotivatedList(
 static void SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread(
     base::ListValue* startup_list,
     base::ListValue* referral_list,
+    base::ListValue* host_cache_list,
     base::WaitableEvent* completion,
     Predictor* predictor) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
@@ -737,7 +750,7 @@ static void SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread(
     return;
   }
   predictor->SaveDnsPrefetchStateForNextStartupAndTrim(
-      startup_list, referral_list, completion);
+      startup_list, referral_list, host_cache_list, completion);
 }
 
 void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
@@ -749,10 +762,12 @@ void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
   ListPrefUpdate update_startup_list(prefs, prefs::kDnsPrefetchingStartupList);
   ListPrefUpdate update_referral_list(prefs,
                                       prefs::kDnsPrefetchingHostReferralList);
+  ListPrefUpdate update_host_cache_list(prefs, prefs::kDnsHostCacheSnapshot);
   if (BrowserThread::CurrentlyOn(BrowserThread::IO)) {
     SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread(
         update_startup_list.Get(),
         update_referral_list.Get(),
+        update_host_cache_list.Get(),
         &completion,
         this);
   } else {
@@ -763,6 +778,7 @@ void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
             &SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread,
             update_startup_list.Get(),
             update_referral_list.Get(),
+            update_host_cache_list.Get(),
             &completion,
             this));
 
@@ -780,6 +796,7 @@ void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
 void Predictor::SaveDnsPrefetchStateForNextStartupAndTrim(
     base::ListValue* startup_list,
     base::ListValue* referral_list,
+    base::ListValue* host_cache_list,
     base::WaitableEvent* completion) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   if (initial_observer_.get())
@@ -790,9 +807,35 @@ void Predictor::SaveDnsPrefetchStateForNextStartupAndTrim(
   TrimReferrersNow();
   SerializeReferrers(referral_list);
 
+  // Snapshot the resolver cache so that the next startup can serve its first
+  // navigations from answers whose TTLs have not yet expired.
+  host_cache_list->Clear();
+  if (host_resolver_) {
+    net::HostCache* host_cache = host_resolver_->GetHostCache();
+    if (host_cache) {
+      host_cache->GetPersistentEntries(base::TimeTicks::Now(),
+                                       base::Time::Now(),
+                                       host_cache_list);
+    }
+  }
+
   completion->Signal();
 }
 
+void Predictor::PrewarmHostCacheThenDelete(
+    base::ListValue* host_cache_snapshot) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (host_resolver_) {
+    net::HostCache* host_cache = host_resolver_->GetHostCache();
+    if (host_cache) {
+      host_cache->RestorePersistentEntries(*host_cache_snapshot,
+                                           base::TimeTicks::Now(),
+                                           base::Time::Now());
+    }
+  }
+  delete host_cache_snapshot;
+}
+
 void Predictor::EnablePredictor(bool enable) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI) ||
          BrowserThread::CurrentlyOn(BrowserThread::IO));
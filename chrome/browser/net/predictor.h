@@ -188,6 +188,7 @@ class Predictor {
   void FinalizeInitializationOnIOThread(
       const std::vector<GURL>& urls_to_prefetch,
       base::ListValue* referral_list,
+      base::ListValue* host_cache_snapshot,
       IOThread* io_thread,
       bool predictor_enabled);
 
@@ -211,8 +212,16 @@ class Predictor {
   void SaveDnsPrefetchStateForNextStartupAndTrim(
       base::ListValue* startup_list,
       base::ListValue* referral_list,
+      base::ListValue* host_cache_list,
       base::WaitableEvent* completion);
 
+  // Seeds the host resolver cache with the unexpired entries of
+  // |host_cache_snapshot|, a list produced by
+  // net::HostCache::GetPersistentEntries() during a previous session, and
+  // deletes the list. This warms the first navigations of this session with
+  // DNS answers whose TTLs are still valid.
+  void PrewarmHostCacheThenDelete(base::ListValue* host_cache_snapshot);
+
   // May be called from either the IO or UI thread and will PostTask
   // to the IO thread if necessary.
   void EnablePredictor(bool enable);
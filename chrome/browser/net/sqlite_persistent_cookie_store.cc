@@ -8,6 +8,7 @@
 #include <map>
 #include <set>
 #include <utility>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/bind.h"
@@ -18,6 +19,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
+#include "base/stl_util.h"
 #include "base/string_util.h"
 #include "base/synchronization/lock.h"
 #include "base/threading/thread.h"
@@ -41,9 +43,12 @@ using content::BrowserThread;
 // delegates to Backend::Load, which posts a Backend::LoadAndNotifyOnDBThread
 // task to the DB thread.  This task calls Backend::ChainLoadCookies(), which
 // repeatedly posts itself to the DB thread to load each eTLD+1's cookies in
-// separate tasks.  When this is complete, Backend::CompleteLoadOnIOThread is
-// posted to the IO thread, which notifies the caller of
-// SQLitePersistentCookieStore::Load that the load is complete.
+// separate tasks.  Callers may seed the chain-load order beforehand via
+// SQLitePersistentCookieStore::SetPriorityLoadKeys with domain keys predicted
+// to be needed at startup; those keys are loaded before the rest.  When this
+// is complete, Backend::CompleteLoadOnIOThread is posted to the IO thread,
+// which notifies the caller of SQLitePersistentCookieStore::Load that the
+// load is complete.
 //
 // If a priority load request is invoked via SQLitePersistentCookieStore::
 // LoadCookiesForKey, it is delegated to Backend::LoadCookiesForKey, which posts
@@ -78,6 +83,10 @@ class SQLitePersistentCookieStore::Backend
   void LoadCookiesForKey(const std::string& domain,
       const LoadedCallback& loaded_callback);
 
+  // Steers the background load order; see
+  // SQLitePersistentCookieStore::SetPriorityLoadKeys().
+  void SetPriorityLoadKeys(const std::vector<std::string>& keys);
+
   // Batch a cookie addition.
   void AddCookie(const net::CookieMonster::CanonicalCookie& cc);
 
@@ -128,6 +137,8 @@ class SQLitePersistentCookieStore::Backend
     net::CookieMonster::CanonicalCookie cc_;
   };
 
+  typedef std::list<PendingOperation*> PendingOperationsList;
+
  private:
   // Creates or loads the SQLite database on DB thread.
   void LoadAndNotifyOnDBThread(const LoadedCallback& loaded_callback,
@@ -178,6 +189,19 @@ class SQLitePersistentCookieStore::Backend
                       const net::CookieMonster::CanonicalCookie& cc);
   // Commit our pending operations to the database.
   void Commit();
+
+  // Commit() helpers, each handling one run of identically-typed operations.
+  // Additions and deletions use |batch_smt| for every full group of
+  // kCommitBatchRows operations and |single_smt| for the remainder; access
+  // time updates carry per-row values and cannot be collapsed.
+  void CommitAdds(const std::vector<PendingOperation*>& run,
+                  sql::Statement* batch_smt,
+                  sql::Statement* single_smt);
+  void CommitAccessTimeUpdates(const std::vector<PendingOperation*>& run,
+                               sql::Statement* smt);
+  void CommitDeletes(const std::vector<PendingOperation*>& run,
+                     sql::Statement* batch_smt,
+                     sql::Statement* single_smt);
   // Close() executed on the background thread.
   void InternalBackgroundClose();
 
@@ -187,12 +211,12 @@ class SQLitePersistentCookieStore::Backend
   scoped_ptr<sql::Connection> db_;
   sql::MetaTable meta_table_;
 
-  typedef std::list<PendingOperation*> PendingOperationsList;
   PendingOperationsList pending_;
   PendingOperationsList::size_type num_pending_;
   // True if the persistent store should be deleted upon destruction.
   bool clear_local_state_on_exit_;
-  // Guard |cookies_|, |pending_|, |num_pending_|, |clear_local_state_on_exit_|
+  // Guard |cookies_|, |pending_|, |num_pending_|,
+  // |clear_local_state_on_exit_|, |priority_load_keys_|
   base::Lock lock_;
 
   // Temporary buffer for cookies loaded from DB. Accumulates cookies to reduce
@@ -203,6 +227,10 @@ class SQLitePersistentCookieStore::Backend
   // Map of domain keys(eTLD+1) to domains/hosts that are to be loaded from DB.
   std::map<std::string, std::set<std::string> > keys_to_load_;
 
+  // Domain keys the chain load should service first, in order. Consumed on
+  // the DB thread as the chain progresses.
+  std::vector<std::string> priority_load_keys_;
+
   // Indicates if DB has been initialized.
   bool initialized_;
 
@@ -252,6 +280,33 @@ static const int kCompatibleVersionNumber = 5;
 
 namespace {
 
+// Number of rows bound into one batched INSERT or DELETE statement when
+// committing pending operations. The bundled SQLite predates the multi-row
+// VALUES clause (added in 3.7.11), so the batched insert uses the
+// SELECT ... UNION ALL SELECT form instead.
+const size_t kCommitBatchRows = 8;
+
+// Number of columns bound per cookie by BindCookieToStatement().
+const int kCookieBindCount = 11;
+
+// Binds one cookie's columns to |smt| starting at parameter |offset|, in the
+// column order of the batched and single-row INSERT statements.
+void BindCookieToStatement(const net::CookieMonster::CanonicalCookie& cc,
+                           sql::Statement* smt,
+                           int offset) {
+  smt->BindInt64(offset + 0, cc.CreationDate().ToInternalValue());
+  smt->BindString(offset + 1, cc.Domain());
+  smt->BindString(offset + 2, cc.Name());
+  smt->BindString(offset + 3, cc.Value());
+  smt->BindString(offset + 4, cc.Path());
+  smt->BindInt64(offset + 5, cc.ExpiryDate().ToInternalValue());
+  smt->BindInt(offset + 6, cc.IsSecure());
+  smt->BindInt(offset + 7, cc.IsHttpOnly());
+  smt->BindInt64(offset + 8, cc.LastAccessDate().ToInternalValue());
+  smt->BindInt(offset + 9, cc.DoesExpire());
+  smt->BindInt(offset + 10, cc.IsPersistent());
+}
+
 // Increments a specified TimeDelta by the duration between this object's
 // constructor and destructor. Not thread safe. Multiple instances may be
 // created with the same delta instance as long as their lifetimes are nested.
@@ -335,6 +390,12 @@ void SQLitePersistentCookieStore::Backend::LoadCookiesForKey(
                base::Time::Now()));
 }
 
+void SQLitePersistentCookieStore::Backend::SetPriorityLoadKeys(
+    const std::vector<std::string>& keys) {
+  base::AutoLock locked(lock_);
+  priority_load_keys_ = keys;
+}
+
 void SQLitePersistentCookieStore::Backend::LoadAndNotifyOnDBThread(
     const LoadedCallback& loaded_callback, const base::Time& posted_at) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::DB));
@@ -545,8 +606,19 @@ void SQLitePersistentCookieStore::Backend::ChainLoadCookies(
     // Close() has been called on this store.
     load_success = false;
   } else if (keys_to_load_.size() > 0) {
-    // Load cookies for the first domain key.
+    // Load cookies for the next domain key, preferring any remaining
+    // predicted-startup keys over plain map order. Keys already consumed by
+    // a priority load are simply skipped.
     std::map<std::string, std::set<std::string> >::iterator
+      it = keys_to_load_.end();
+    {
+      base::AutoLock locked(lock_);
+      while (it == keys_to_load_.end() && !priority_load_keys_.empty()) {
+        it = keys_to_load_.find(priority_load_keys_.front());
+        priority_load_keys_.erase(priority_load_keys_.begin());
+      }
+    }
+    if (it == keys_to_load_.end())
       it = keys_to_load_.begin();
     load_success = LoadCookiesForDomains(it->second);
     keys_to_load_.erase(it);
@@ -806,6 +878,21 @@ void SQLitePersistentCookieStore::Backend::Commit() {
   if (!add_smt.is_valid())
     return;
 
+  sql::Statement add_batch_smt(db_->GetCachedStatement(SQL_FROM_HERE,
+      "INSERT INTO cookies (creation_utc, host_key, name, value, path, "
+      "expires_utc, secure, httponly, last_access_utc, has_expires, "
+      "persistent) "
+      "SELECT ?,?,?,?,?,?,?,?,?,?,?"
+      " UNION ALL SELECT ?,?,?,?,?,?,?,?,?,?,?"
+      " UNION ALL SELECT ?,?,?,?,?,?,?,?,?,?,?"
+      " UNION ALL SELECT ?,?,?,?,?,?,?,?,?,?,?"
+      " UNION ALL SELECT ?,?,?,?,?,?,?,?,?,?,?"
+      " UNION ALL SELECT ?,?,?,?,?,?,?,?,?,?,?"
+      " UNION ALL SELECT ?,?,?,?,?,?,?,?,?,?,?"
+      " UNION ALL SELECT ?,?,?,?,?,?,?,?,?,?,?"));
+  if (!add_batch_smt.is_valid())
+    return;
+
   sql::Statement update_access_smt(db_->GetCachedStatement(SQL_FROM_HERE,
       "UPDATE cookies SET last_access_utc=? WHERE creation_utc=?"));
   if (!update_access_smt.is_valid())
@@ -816,47 +903,36 @@ void SQLitePersistentCookieStore::Backend::Commit() {
   if (!del_smt.is_valid())
     return;
 
+  sql::Statement del_batch_smt(db_->GetCachedStatement(SQL_FROM_HERE,
+      "DELETE FROM cookies WHERE creation_utc IN (?,?,?,?,?,?,?,?)"));
+  if (!del_batch_smt.is_valid())
+    return;
+
   sql::Transaction transaction(db_.get());
   if (!transaction.Begin())
     return;
 
-  for (PendingOperationsList::iterator it = ops.begin();
-       it != ops.end(); ++it) {
-    // Free the cookies as we commit them to the database.
-    scoped_ptr<PendingOperation> po(*it);
-    switch (po->op()) {
+  // Commit the operations in order, batching each run of identically-typed
+  // operations into multi-row statements. Runs must not be reordered across
+  // type boundaries: the same creation_utc can legitimately be deleted and
+  // re-added within one batch.
+  PendingOperationsList::iterator it = ops.begin();
+  while (it != ops.end()) {
+    PendingOperation::OperationType op = (*it)->op();
+    std::vector<PendingOperation*> run;
+    for (; it != ops.end() && (*it)->op() == op; ++it)
+      run.push_back(*it);
+    switch (op) {
       case PendingOperation::COOKIE_ADD:
-        add_smt.Reset(true);
-        add_smt.BindInt64(0, po->cc().CreationDate().ToInternalValue());
-        add_smt.BindString(1, po->cc().Domain());
-        add_smt.BindString(2, po->cc().Name());
-        add_smt.BindString(3, po->cc().Value());
-        add_smt.BindString(4, po->cc().Path());
-        add_smt.BindInt64(5, po->cc().ExpiryDate().ToInternalValue());
-        add_smt.BindInt(6, po->cc().IsSecure());
-        add_smt.BindInt(7, po->cc().IsHttpOnly());
-        add_smt.BindInt64(8, po->cc().LastAccessDate().ToInternalValue());
-        add_smt.BindInt(9, po->cc().DoesExpire());
-        add_smt.BindInt(10, po->cc().IsPersistent());
-        if (!add_smt.Run())
-          NOTREACHED() << "Could not add a cookie to the DB.";
+        CommitAdds(run, &add_batch_smt, &add_smt);
         break;
 
       case PendingOperation::COOKIE_UPDATEACCESS:
-        update_access_smt.Reset(true);
-        update_access_smt.BindInt64(0,
-            po->cc().LastAccessDate().ToInternalValue());
-        update_access_smt.BindInt64(1,
-            po->cc().CreationDate().ToInternalValue());
-        if (!update_access_smt.Run())
-          NOTREACHED() << "Could not update cookie last access time in the DB.";
+        CommitAccessTimeUpdates(run, &update_access_smt);
         break;
 
       case PendingOperation::COOKIE_DELETE:
-        del_smt.Reset(true);
-        del_smt.BindInt64(0, po->cc().CreationDate().ToInternalValue());
-        if (!del_smt.Run())
-          NOTREACHED() << "Could not delete a cookie from the DB.";
+        CommitDeletes(run, &del_batch_smt, &del_smt);
         break;
 
       default:
@@ -865,10 +941,67 @@ void SQLitePersistentCookieStore::Backend::Commit() {
     }
   }
   bool succeeded = transaction.Commit();
+  STLDeleteElements(&ops);
   UMA_HISTOGRAM_ENUMERATION("Cookie.BackingStoreUpdateResults",
                             succeeded ? 0 : 1, 2);
 }
 
+void SQLitePersistentCookieStore::Backend::CommitAdds(
+    const std::vector<PendingOperation*>& run,
+    sql::Statement* batch_smt,
+    sql::Statement* single_smt) {
+  size_t i = 0;
+  for (; i + kCommitBatchRows <= run.size(); i += kCommitBatchRows) {
+    batch_smt->Reset(true);
+    for (size_t j = 0; j < kCommitBatchRows; ++j) {
+      BindCookieToStatement(run[i + j]->cc(), batch_smt,
+                            static_cast<int>(j) * kCookieBindCount);
+    }
+    if (!batch_smt->Run())
+      NOTREACHED() << "Could not add cookies to the DB.";
+  }
+  for (; i < run.size(); ++i) {
+    single_smt->Reset(true);
+    BindCookieToStatement(run[i]->cc(), single_smt, 0);
+    if (!single_smt->Run())
+      NOTREACHED() << "Could not add a cookie to the DB.";
+  }
+}
+
+void SQLitePersistentCookieStore::Backend::CommitAccessTimeUpdates(
+    const std::vector<PendingOperation*>& run,
+    sql::Statement* smt) {
+  for (size_t i = 0; i < run.size(); ++i) {
+    smt->Reset(true);
+    smt->BindInt64(0, run[i]->cc().LastAccessDate().ToInternalValue());
+    smt->BindInt64(1, run[i]->cc().CreationDate().ToInternalValue());
+    if (!smt->Run())
+      NOTREACHED() << "Could not update cookie last access time in the DB.";
+  }
+}
+
+void SQLitePersistentCookieStore::Backend::CommitDeletes(
+    const std::vector<PendingOperation*>& run,
+    sql::Statement* batch_smt,
+    sql::Statement* single_smt) {
+  size_t i = 0;
+  for (; i + kCommitBatchRows <= run.size(); i += kCommitBatchRows) {
+    batch_smt->Reset(true);
+    for (size_t j = 0; j < kCommitBatchRows; ++j) {
+      batch_smt->BindInt64(static_cast<int>(j),
+                           run[i + j]->cc().CreationDate().ToInternalValue());
+    }
+    if (!batch_smt->Run())
+      NOTREACHED() << "Could not delete cookies from the DB.";
+  }
+  for (; i < run.size(); ++i) {
+    single_smt->Reset(true);
+    single_smt->BindInt64(0, run[i]->cc().CreationDate().ToInternalValue());
+    if (!single_smt->Run())
+      NOTREACHED() << "Could not delete a cookie from the DB.";
+  }
+}
+
 void SQLitePersistentCookieStore::Backend::Flush(
     const base::Closure& callback) {
   DCHECK(!BrowserThread::CurrentlyOn(BrowserThread::DB));
@@ -925,6 +1058,12 @@ SQLitePersistentCookieStore::SQLitePersistentCookieStore(
     : backend_(new Backend(path, restore_old_session_cookies)) {
 }
 
+void SQLitePersistentCookieStore::SetPriorityLoadKeys(
+    const std::vector<std::string>& keys) {
+  if (backend_.get())
+    backend_->SetPriorityLoadKeys(keys);
+}
+
 void SQLitePersistentCookieStore::Load(const LoadedCallback& loaded_callback) {
   backend_->Load(loaded_callback);
 }
@@ -28,6 +28,12 @@ class SQLitePersistentCookieStore
   SQLitePersistentCookieStore(const FilePath& path,
                               bool restore_old_session_cookies);
 
+  // Sets the domain keys (eTLD+1) whose cookies should be loaded before the
+  // remaining keys are chain-loaded in background batches, e.g. keys
+  // predicted from the profile's startup history. Keys are serviced in the
+  // given order; unknown keys are ignored. Call before Load().
+  void SetPriorityLoadKeys(const std::vector<std::string>& keys);
+
   // net::CookieMonster::PersistentCookieStore:
   virtual void Load(const LoadedCallback& loaded_callback) OVERRIDE;
   virtual void LoadCookiesForKey(const std::string& key,
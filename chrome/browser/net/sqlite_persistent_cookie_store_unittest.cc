@@ -9,6 +9,7 @@
 #include "base/message_loop.h"
 #include "base/scoped_temp_dir.h"
 #include "base/stl_util.h"
+#include "base/stringprintf.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/test/thread_test_helper.h"
 #include "base/time.h"
@@ -270,6 +271,94 @@ TEST_F(SQLitePersistentCookieStoreTest, TestLoadCookiesForKey) {
   ASSERT_EQ(cookies_loaded.find("www.bbb.com") != cookies_loaded.end(), true);
 }
 
+// Test that SetPriorityLoadKeys steers the chain load: the predicted key's
+// cookies are loaded in the first background batch, ahead of map order.
+TEST_F(SQLitePersistentCookieStoreTest, TestPriorityLoadKeys) {
+  InitializeStore(false);
+  base::Time t = base::Time::Now();
+  AddCookie("A", "B", "www.aaa.com", "/", t);
+  t += base::TimeDelta::FromInternalValue(10);
+  AddCookie("A", "B", "www.bbb.com", "/", t);
+  t += base::TimeDelta::FromInternalValue(10);
+  AddCookie("A", "B", "www.ccc.com", "/", t);
+  DestroyStore();
+
+  store_ = new SQLitePersistentCookieStore(
+      temp_dir_.path().Append(chrome::kCookieFilename), false);
+  std::vector<std::string> keys;
+  keys.push_back("ccc.com");
+  keys.push_back("notthere.com");  // Unknown keys are skipped.
+  store_->SetPriorityLoadKeys(keys);
+  // Posting a blocking task to db_thread_ makes sure that the DB thread waits
+  // until both Load and LoadCookiesForKey have been posted to its task queue.
+  BrowserThread::PostTask(
+      BrowserThread::DB, FROM_HERE,
+      base::Bind(&SQLitePersistentCookieStoreTest::WaitOnDBEvent,
+                 base::Unretained(this)));
+  store_->Load(base::Bind(&SQLitePersistentCookieStoreTest::OnLoaded,
+                          base::Unretained(this)));
+  store_->LoadCookiesForKey("aaa.com",
+    base::Bind(&SQLitePersistentCookieStoreTest::OnKeyLoaded,
+               base::Unretained(this)));
+  BrowserThread::PostTask(
+      BrowserThread::DB, FROM_HERE,
+      base::Bind(&SQLitePersistentCookieStoreTest::WaitOnDBEvent,
+                 base::Unretained(this)));
+
+  // The first chain-load batch runs before the priority load of "aaa.com",
+  // and its cookies are delivered together with the key notification. With
+  // "ccc.com" designated as a priority key, that first batch must be
+  // www.ccc.com rather than the first key in map order.
+  db_thread_event_.Signal();
+  key_loaded_event_.Wait();
+  ASSERT_EQ(loaded_event_.IsSignaled(), false);
+  std::set<std::string> cookies_loaded;
+  for (std::vector<net::CookieMonster::CanonicalCookie*>::iterator
+       it = cookies_.begin(); it != cookies_.end(); ++it)
+    cookies_loaded.insert((*it)->Domain().c_str());
+  ASSERT_EQ(cookies_loaded.find("www.ccc.com") != cookies_loaded.end(), true);
+  ASSERT_EQ(cookies_loaded.find("www.bbb.com") != cookies_loaded.end(), false);
+
+  db_thread_event_.Signal();
+  loaded_event_.Wait();
+  for (std::vector<net::CookieMonster::CanonicalCookie*>::iterator
+       it = cookies_.begin(); it != cookies_.end(); ++it)
+    cookies_loaded.insert((*it)->Domain().c_str());
+  ASSERT_EQ(3U, cookies_loaded.size());
+}
+
+// Test that a large mixed batch commits correctly: the multi-row insert and
+// delete paths must preserve ordering across type boundaries, since the same
+// creation time can be deleted and re-added within one batch.
+TEST_F(SQLitePersistentCookieStoreTest, BatchedCommit) {
+  InitializeStore(false);
+  base::Time t = base::Time::Now();
+  // Enough cookies to fill the multi-row statements and leave a remainder.
+  for (int i = 0; i < 19; ++i) {
+    t += base::TimeDelta::FromInternalValue(10);
+    AddCookie(base::StringPrintf("c%d", i), "old", "http://foo.bar", "/", t);
+  }
+  // Delete the last cookie and re-add it with the same creation time but a
+  // new value; the re-added value must win.
+  net::CookieMonster::CanonicalCookie doomed(
+      GURL(), "c18", "old", "http://foo.bar", "/", std::string(),
+      std::string(), t, t, t, false, false, true, true);
+  store_->DeleteCookie(doomed);
+  AddCookie("c18", "new", "http://foo.bar", "/", t);
+  DestroyStore();
+
+  std::vector<net::CookieMonster::CanonicalCookie*> cookies;
+  CreateAndLoad(false, &cookies);
+  ASSERT_EQ(19U, cookies.size());
+  for (std::vector<net::CookieMonster::CanonicalCookie*>::iterator
+       it = cookies.begin(); it != cookies.end(); ++it) {
+    if ((*it)->Name() == "c18")
+      EXPECT_STREQ("new", (*it)->Value().c_str());
+  }
+  STLDeleteContainerPointers(cookies.begin(), cookies.end());
+  cookies.clear();
+}
+
 // Test that we can force the database to be written by calling Flush().
 TEST_F(SQLitePersistentCookieStoreTest, TestFlush) {
   InitializeStore(false);
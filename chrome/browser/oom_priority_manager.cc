@@ -205,6 +205,11 @@ std::vector<string16> OomPriorityManager::GetTabTitles() {
 // such as tabs created with JavaScript window.open().  We might want to
 // discard the entire set together, or use that in the priority computation.
 bool OomPriorityManager::DiscardTab() {
+  // Backing stores are the cheapest memory to give back: dropping them only
+  // costs a repaint when the widget is next shown, while discarding a tab
+  // loses the whole page. Trim them before sacrificing a tab.
+  content::RenderWidgetHost::ReduceBackingStoreMemory();
+
   TabStatsList stats = GetTabStatsOnUIThread();
   if (stats.empty())
     return false;
@@ -28,6 +28,7 @@
 #include "net/base/server_bound_cert_service.h"
 #include "net/ftp/ftp_network_layer.h"
 #include "net/http/http_cache.h"
+#include "net/http/http_cache_hybrid_backend.h"
 #include "net/url_request/url_request_job_factory.h"
 
 using content::BrowserThread;
@@ -388,12 +389,18 @@ void ProfileImplIOData::LazyInitializeInternal(
     trusted_spdy_proxy = command_line.GetSwitchValueASCII(
         switches::kTrustedSpdyProxy);
   }
-  net::HttpCache::DefaultBackend* main_backend =
+  net::HttpCache::BackendFactory* main_backend =
       new net::HttpCache::DefaultBackend(
           net::DISK_CACHE,
           lazy_params_->cache_path,
           lazy_params_->cache_max_size,
           BrowserThread::GetMessageLoopProxyForThread(BrowserThread::CACHE));
+  if (command_line.HasSwitch(switches::kEnableHttpCacheRamTier)) {
+    // 2 MB holds a few dozen hot small entries per profile without
+    // noticeably growing the browser footprint.
+    main_backend = new net::HybridBackendFactory(main_backend,
+                                                 2 * 1024 * 1024);
+  }
   net::HttpCache* main_cache = new net::HttpCache(
       main_context->host_resolver(),
       main_context->cert_verifier(),
@@ -0,0 +1,149 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/profiles/profile_startup_prefetcher.h"
+
+#include "build/build_config.h"
+
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/string_split.h"
+#include "base/string_util.h"
+#include "chrome/common/chrome_constants.h"
+#include "content/public/browser/browser_thread.h"
+
+#if defined(OS_POSIX)
+#include "base/eintr_wrapper.h"
+#endif
+
+using content::BrowserThread;
+
+namespace {
+
+// Name of the trace file written into the profile directory. It holds one
+// profile-relative file name per line, in the order the files should be
+// warmed on the next startup.
+const FilePath::CharType kPrefetchTraceFilename[] =
+    FILE_PATH_LITERAL("Startup Prefetch Trace");
+
+// Profile files that startup commonly reads. The trace recorded for the
+// next run is the subset of these that exist on disk.
+const FilePath::CharType* const kCandidateFilenames[] = {
+  chrome::kPreferencesFilename,
+  chrome::kHistoryFilename,
+  chrome::kArchivedHistoryFilename,
+  chrome::kCookieFilename,
+  chrome::kExtensionsCookieFilename,
+  chrome::kOBCertFilename,
+  chrome::kFaviconsFilename,
+  chrome::kTopSitesFilename,
+  chrome::kWebDataFilename,
+  chrome::kThemePackFilename,
+};
+
+// Chunk size used when a file has to be warmed by reading it.
+const size_t kWarmChunkSize = 1 << 16;  // 64 KB
+
+// Returns a key that approximates the on-disk position of |path| so the
+// prefetch loop can visit files in ascending disk order and keep seek
+// distances short. Inode numbers correlate well enough with block
+// placement on the filesystems we care about; where they are unavailable
+// the trace order is kept.
+uint64 DiskOrderKey(const FilePath& path) {
+#if defined(OS_POSIX)
+  struct stat info;
+  if (stat(path.value().c_str(), &info) == 0)
+    return info.st_ino;
+#endif
+  return 0;
+}
+
+// Asks the OS to pull |path| into the page cache, without waiting for the
+// I/O where the platform allows it.
+void WarmFile(const FilePath& path) {
+#if defined(OS_POSIX)
+  int fd = HANDLE_EINTR(open(path.value().c_str(), O_RDONLY));
+  if (fd < 0)
+    return;
+  // POSIX_FADV_WILLNEED queues the read in the background; it does not
+  // block on the disk.
+  posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  HANDLE_EINTR(close(fd));
+#else
+  // No asynchronous readahead primitive, so read the file sequentially and
+  // throw the data away. This still beats the consumers' random access
+  // pattern on a cold cache.
+  FILE* file = file_util::OpenFile(path, "rb");
+  if (!file)
+    return;
+  scoped_array<char> buffer(new char[kWarmChunkSize]);
+  while (fread(buffer.get(), 1, kWarmChunkSize, file) == kWarmChunkSize) {
+  }
+  file_util::CloseFile(file);
+#endif
+}
+
+// Replays the trace left by the previous run, then records a fresh one.
+// Runs on the blocking pool.
+void PrefetchOnBlockingPool(const FilePath& profile_path) {
+  const FilePath trace_path = profile_path.Append(kPrefetchTraceFilename);
+
+  std::string trace;
+  file_util::ReadFileToString(trace_path, &trace);
+  std::vector<std::string> names;
+  base::SplitString(trace, '\n', &names);
+
+  std::vector<std::pair<uint64, FilePath> > files;
+  for (size_t i = 0; i < names.size(); ++i) {
+    // Ignore blank lines and anything a corrupt trace may contain; the
+    // trace only ever holds ASCII names from kCandidateFilenames.
+    if (names[i].empty() || !IsStringASCII(names[i]))
+      continue;
+    FilePath path = profile_path.AppendASCII(names[i]);
+    files.push_back(std::make_pair(DiskOrderKey(path), path));
+  }
+  std::sort(files.begin(), files.end());
+  for (size_t i = 0; i < files.size(); ++i)
+    WarmFile(files[i].second);
+
+  // Record the trace for the next startup: the well-known profile files
+  // that exist right now. Names that don't round-trip through ASCII are
+  // skipped; all current candidates do.
+  std::string new_trace;
+  for (size_t i = 0; i < arraysize(kCandidateFilenames); ++i) {
+    if (!file_util::PathExists(profile_path.Append(kCandidateFilenames[i])))
+      continue;
+    std::string name = FilePath(kCandidateFilenames[i]).MaybeAsASCII();
+    if (name.empty())
+      continue;
+    new_trace += name;
+    new_trace += '\n';
+  }
+  file_util::WriteFile(trace_path, new_trace.data(), new_trace.size());
+}
+
+}  // namespace
+
+// static
+void ProfileStartupPrefetcher::Prefetch(const FilePath& profile_path) {
+  DCHECK(!profile_path.empty());
+  BrowserThread::PostBlockingPoolTask(
+      FROM_HERE,
+      base::Bind(&PrefetchOnBlockingPool, profile_path));
+}
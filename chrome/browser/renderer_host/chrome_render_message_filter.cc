@@ -19,6 +19,7 @@
 #include "chrome/browser/extensions/extension_process_manager.h"
 #include "chrome/browser/extensions/extension_service.h"
 #include "chrome/browser/extensions/extension_system.h"
+#include "chrome/browser/memory_details.h"
 #include "chrome/browser/metrics/histogram_synchronizer.h"
 #include "chrome/browser/nacl_host/nacl_process_host.h"
 #include "chrome/browser/net/chrome_url_request_context.h"
@@ -79,6 +80,7 @@ bool ChromeRenderMessageFilter::OnMessageReceived(const IPC::Message& message,
                         OnUpdatedCacheStats)
     IPC_MESSAGE_HANDLER(ChromeViewHostMsg_FPS, OnFPS)
     IPC_MESSAGE_HANDLER(ChromeViewHostMsg_V8HeapStats, OnV8HeapStats)
+    IPC_MESSAGE_HANDLER(ChromeViewHostMsg_HeapSample, OnHeapSample)
     IPC_MESSAGE_HANDLER(ExtensionHostMsg_OpenChannelToExtension,
                         OnOpenChannelToExtension)
     IPC_MESSAGE_HANDLER(ExtensionHostMsg_OpenChannelToTab, OnOpenChannelToTab)
@@ -249,6 +251,18 @@ void ChromeRenderMessageFilter::OnV8HeapStats(int v8_memory_allocated,
       content::Details<const V8HeapStatsDetails>(&details));
 }
 
+void ChromeRenderMessageFilter::OnHeapSample(const std::string& report) {
+  if (!BrowserThread::CurrentlyOn(BrowserThread::UI)) {
+    BrowserThread::PostTask(
+        BrowserThread::UI, FROM_HERE,
+        base::Bind(&ChromeRenderMessageFilter::OnHeapSample, this, report));
+    return;
+  }
+
+  MemoryDetails::SetHeapSampleForProcess(base::GetProcId(peer_handle()),
+                                         report);
+}
+
 void ChromeRenderMessageFilter::OnOpenChannelToExtension(
     int routing_id, const std::string& source_extension_id,
     const std::string& target_extension_id,
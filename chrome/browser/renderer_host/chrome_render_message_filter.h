@@ -85,6 +85,7 @@ class ChromeRenderMessageFilter : public content::BrowserMessageFilter {
   void OnUpdatedCacheStats(const WebKit::WebCache::UsageStats& stats);
   void OnFPS(int routing_id, float fps);
   void OnV8HeapStats(int v8_memory_allocated, int v8_memory_used);
+  void OnHeapSample(const std::string& report);
   void OnOpenChannelToExtension(int routing_id,
                                 const std::string& source_extension_id,
                                 const std::string& target_extension_id,
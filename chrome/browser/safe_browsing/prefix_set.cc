@@ -29,18 +29,13 @@ typedef struct {
   uint32 deltas_size;
 } FileHeader;
 
-// For |std::upper_bound()| to find a prefix w/in a vector of pairs.
-bool PrefixLess(const std::pair<SBPrefix,size_t>& a,
-                const std::pair<SBPrefix,size_t>& b) {
-  return a.first < b.first;
-}
-
 }  // namespace
 
 namespace safe_browsing {
 
 PrefixSet::PrefixSet(const std::vector<SBPrefix>& sorted_prefixes)
-    : checksum_(0) {
+    : filter_mask_(0),
+      checksum_(0) {
   if (sorted_prefixes.size()) {
     // Estimate the resulting vector sizes.  There will be strictly
     // more than |min_runs| entries in |index_|, but there generally
@@ -102,45 +97,130 @@ PrefixSet::PrefixSet(const std::vector<SBPrefix>& sorted_prefixes)
                               bits_used / unique_prefixes,
                               kMaxBitsPerPrefix);
   }
+
+  BuildAccelerators();
 }
 
 PrefixSet::PrefixSet(std::vector<std::pair<SBPrefix,size_t> > *index,
                      std::vector<uint16> *deltas)
-    : checksum_(0) {
+    : filter_mask_(0),
+      checksum_(0) {
   DCHECK(index && deltas);
   index_.swap(*index);
   deltas_.swap(*deltas);
+  BuildAccelerators();
 }
 
 PrefixSet::~PrefixSet() {}
 
+void PrefixSet::BuildAccelerators() {
+  bfs_prefixes_.clear();
+  bfs_to_sorted_.clear();
+  filter_.clear();
+  filter_mask_ = 0;
+
+  if (index_.empty())
+    return;
+
+  // Lay the |index_| prefixes out in BFS order.
+  bfs_prefixes_.resize(index_.size());
+  bfs_to_sorted_.resize(index_.size());
+  size_t sorted_pos = 0;
+  FillBfs(&sorted_pos, 0);
+  DCHECK_EQ(index_.size(), sorted_pos);
+
+  // Skip the pre-filter for small sets; the search is already cheap
+  // and a tiny filter would reject almost nothing.
+  const size_t prefix_count = index_.size() + deltas_.size();
+  if (prefix_count < kMinFilterPrefixes)
+    return;
+
+  // Size the pre-filter at |kFilterBitsPerPrefix| bits per prefix,
+  // rounded up to a power of two so the hash is a simple mask.
+  size_t filter_bits = 1;
+  while (filter_bits < prefix_count * kFilterBitsPerPrefix)
+    filter_bits <<= 1;
+  filter_mask_ = static_cast<uint32>(filter_bits - 1);
+  filter_.resize(filter_bits / 32);
+
+  // Set the bit for every prefix in the set.  The enumeration matches
+  // |GetPrefixes()|.
+  for (size_t ii = 0; ii < index_.size(); ++ii) {
+    const size_t deltas_end =
+        (ii + 1 < index_.size()) ? index_[ii + 1].second : deltas_.size();
+
+    SBPrefix current = index_[ii].first;
+    uint32 bit = static_cast<uint32>(current) & filter_mask_;
+    filter_[bit >> 5] |= 1u << (bit & 31);
+    for (size_t di = index_[ii].second; di < deltas_end; ++di) {
+      current += deltas_[di];
+      bit = static_cast<uint32>(current) & filter_mask_;
+      filter_[bit >> 5] |= 1u << (bit & 31);
+    }
+  }
+}
+
+void PrefixSet::FillBfs(size_t* sorted_pos, size_t bfs_pos) {
+  if (bfs_pos >= index_.size())
+    return;
+  FillBfs(sorted_pos, 2 * bfs_pos + 1);
+  bfs_prefixes_[bfs_pos] = index_[*sorted_pos].first;
+  bfs_to_sorted_[bfs_pos] = static_cast<uint32>(*sorted_pos);
+  ++*sorted_pos;
+  FillBfs(sorted_pos, 2 * bfs_pos + 2);
+}
+
+size_t PrefixSet::IndexSearch(SBPrefix prefix) const {
+  // Descend the implicit tree.  Children of |bfs_prefixes_[k]| live at
+  // 2k+1 and 2k+2, so the early levels of the search all land in the
+  // same few cache lines no matter which way the comparisons go.
+  const size_t bfs_size = bfs_prefixes_.size();
+  size_t k = 0;
+  size_t best_bfs = bfs_size;
+  while (k < bfs_size) {
+    if (bfs_prefixes_[k] <= prefix) {
+      best_bfs = k;
+      k = 2 * k + 2;
+    } else {
+      k = 2 * k + 1;
+    }
+  }
+
+  if (best_bfs == bfs_size)
+    return index_.size();
+  return bfs_to_sorted_[best_bfs];
+}
+
 bool PrefixSet::Exists(SBPrefix prefix) const {
   if (index_.empty())
     return false;
 
-  // Find the first position after |prefix| in |index_|.
-  std::vector<std::pair<SBPrefix,size_t> >::const_iterator
-      iter = std::upper_bound(index_.begin(), index_.end(),
-                              std::pair<SBPrefix,size_t>(prefix, 0),
-                              PrefixLess);
+  // A clear pre-filter bit proves |prefix| is not in the set, which
+  // settles almost every probe with a single memory access.
+  if (!filter_.empty()) {
+    const uint32 bit = static_cast<uint32>(prefix) & filter_mask_;
+    if (!(filter_[bit >> 5] & (1u << (bit & 31))))
+      return false;
+  }
+
+  // Find the entry our target's deltas would run from.
+  const size_t pos = IndexSearch(prefix);
 
   // |prefix| comes before anything that's in the set.
-  if (iter == index_.begin())
+  if (pos == index_.size())
     return false;
 
   // Capture the upper bound of our target entry's deltas.
-  const size_t bound = (iter == index_.end() ? deltas_.size() : iter->second);
-
-  // Back up to the entry our target is in.
-  --iter;
+  const size_t bound =
+      (pos + 1 < index_.size()) ? index_[pos + 1].second : deltas_.size();
 
   // All prefixes in |index_| are in the set.
-  SBPrefix current = iter->first;
+  SBPrefix current = index_[pos].first;
   if (current == prefix)
     return true;
 
   // Scan forward accumulating deltas while a match is possible.
-  for (size_t di = iter->second; di < bound && current < prefix; ++di) {
+  for (size_t di = index_[pos].second; di < bound && current < prefix; ++di) {
     current += deltas_[di];
   }
 
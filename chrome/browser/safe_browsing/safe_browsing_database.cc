@@ -13,6 +13,7 @@
 #include "base/metrics/histogram.h"
 #include "base/metrics/stats_counters.h"
 #include "base/process_util.h"
+#include "base/threading/worker_pool.h"
 #include "base/time.h"
 #include "chrome/browser/safe_browsing/bloom_filter.h"
 #include "chrome/browser/safe_browsing/prefix_set.h"
@@ -497,7 +498,8 @@ SafeBrowsingDatabaseNew::SafeBrowsingDatabaseNew()
       download_store_(NULL),
       csd_whitelist_store_(NULL),
       download_whitelist_store_(NULL),
-      ALLOW_THIS_IN_INITIALIZER_LIST(reset_factory_(this)) {
+      ALLOW_THIS_IN_INITIALIZER_LIST(reset_factory_(this)),
+      ALLOW_THIS_IN_INITIALIZER_LIST(filter_build_factory_(this)) {
   DCHECK(browse_store_.get());
   DCHECK(!download_store_.get());
   DCHECK(!csd_whitelist_store_.get());
@@ -515,6 +517,7 @@ SafeBrowsingDatabaseNew::SafeBrowsingDatabaseNew(
       csd_whitelist_store_(csd_whitelist_store),
       download_whitelist_store_(download_whitelist_store),
       ALLOW_THIS_IN_INITIALIZER_LIST(reset_factory_(this)),
+      ALLOW_THIS_IN_INITIALIZER_LIST(filter_build_factory_(this)),
       corruption_detected_(false) {
   DCHECK(browse_store_.get());
 }
@@ -599,6 +602,9 @@ void SafeBrowsingDatabaseNew::Init(const FilePath& filename_base) {
 bool SafeBrowsingDatabaseNew::ResetDatabase() {
   DCHECK_EQ(creation_loop_, MessageLoop::current());
 
+  // Any in-flight filter rebuild would resurrect the data being reset.
+  filter_build_factory_.InvalidateWeakPtrs();
+
   // Delete files on disk.
   // TODO(shess): Hard to see where one might want to delete without a
   // reset.  Perhaps inline |Delete()|?
@@ -1223,66 +1229,59 @@ void SafeBrowsingDatabaseNew::UpdateDownloadStore() {
 #endif
 }
 
-void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
-  // Copy out the pending add hashes.  Copy rather than swapping in
-  // case |ContainsBrowseURL()| is called before the new filter is complete.
-  std::vector<SBAddFullHash> pending_add_hashes;
-  {
-    base::AutoLock locked(lookup_lock_);
-    pending_add_hashes.insert(pending_add_hashes.end(),
-                              pending_browse_hashes_.begin(),
-                              pending_browse_hashes_.end());
-  }
-
-  // Measure the amount of IO during the bloom filter build.
-  base::IoCounters io_before, io_after;
-  base::ProcessHandle handle = base::Process::Current().handle();
-  scoped_ptr<base::ProcessMetrics> metric(
-#if !defined(OS_MACOSX)
-      base::ProcessMetrics::CreateProcessMetrics(handle)
-#else
-      // Getting stats only for the current process is enough, so NULL is fine.
-      base::ProcessMetrics::CreateProcessMetrics(handle, NULL)
-#endif
-  );
+// Carries the data for the browse filter rebuild between the safe-browsing
+// thread and the worker thread doing the CPU-heavy work.  Refcounted so that
+// whichever side finishes last cleans it up.
+struct SafeBrowsingDatabaseNew::BrowseFilterBuild
+    : public base::RefCountedThreadSafe<BrowseFilterBuild> {
+  BrowseFilterBuild() : build_start(base::Time::Now()) {}
 
-  // IoCounters are currently not supported on Mac, and may not be
-  // available for Linux, so we check the result and only show IO
-  // stats if they are available.
-  const bool got_counters = metric->GetIOCounters(&io_before);
-
-  const base::Time before = base::Time::Now();
+  const base::Time build_start;
 
+  // Filled from the store merge on the safe-browsing thread.
   SBAddPrefixes add_prefixes;
   std::vector<SBAddFullHash> add_full_hashes;
-  if (!browse_store_->FinishUpdate(pending_add_hashes, prefix_miss_cache_,
-                                   &add_prefixes, &add_full_hashes)) {
-    RecordFailure(FAILURE_BROWSE_DATABASE_UPDATE_FINISH);
-    return;
-  }
 
+  // Built on the worker thread by |BuildBrowseFilter()|.
+  scoped_refptr<BloomFilter> filter;
+  scoped_ptr<safe_browsing::PrefixSet> prefix_set;
+
+ private:
+  friend class base::RefCountedThreadSafe<BrowseFilterBuild>;
+  ~BrowseFilterBuild() {}
+
+  DISALLOW_COPY_AND_ASSIGN(BrowseFilterBuild);
+};
+
+// static
+void SafeBrowsingDatabaseNew::BuildBrowseFilter(
+    scoped_refptr<BrowseFilterBuild> build) {
   // Create and populate |filter| from |add_prefixes|.
   // TODO(shess): The bloom filter doesn't need to be a
   // scoped_refptr<> for this code.  Refactor that away.
   const int filter_size =
-      BloomFilter::FilterSizeForKeyCount(add_prefixes.size());
-  scoped_refptr<BloomFilter> filter(new BloomFilter(filter_size));
-  for (SBAddPrefixes::const_iterator iter = add_prefixes.begin();
-       iter != add_prefixes.end(); ++iter) {
-    filter->Insert(iter->prefix);
+      BloomFilter::FilterSizeForKeyCount(build->add_prefixes.size());
+  build->filter = new BloomFilter(filter_size);
+  for (SBAddPrefixes::const_iterator iter = build->add_prefixes.begin();
+       iter != build->add_prefixes.end(); ++iter) {
+    build->filter->Insert(iter->prefix);
   }
 
-  scoped_ptr<safe_browsing::PrefixSet>
-      prefix_set(PrefixSetFromAddPrefixes(add_prefixes));
+  build->prefix_set.reset(PrefixSetFromAddPrefixes(build->add_prefixes));
 
   // This needs to be in sorted order by prefix for efficient access.
-  std::sort(add_full_hashes.begin(), add_full_hashes.end(),
+  std::sort(build->add_full_hashes.begin(), build->add_full_hashes.end(),
             SBAddFullHashPrefixLess);
+}
+
+void SafeBrowsingDatabaseNew::OnBrowseFilterBuilt(
+    scoped_refptr<BrowseFilterBuild> build) {
+  DCHECK_EQ(creation_loop_, MessageLoop::current());
 
   // Swap in the newly built filter and cache.
   {
     base::AutoLock locked(lookup_lock_);
-    full_browse_hashes_.swap(add_full_hashes);
+    full_browse_hashes_.swap(build->add_full_hashes);
 
     // TODO(shess): If |CacheHashResults()| is posted between the
     // earlier lock and this clear, those pending hashes will be lost.
@@ -1291,17 +1290,70 @@ void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
     // hash will be fetched again).
     pending_browse_hashes_.clear();
     prefix_miss_cache_.clear();
-    browse_bloom_filter_.swap(filter);
-    prefix_set_.swap(prefix_set);
+    browse_bloom_filter_.swap(build->filter);
+    prefix_set_.swap(build->prefix_set);
   }
 
-  const base::TimeDelta bloom_gen = base::Time::Now() - before;
+  const base::TimeDelta bloom_gen = base::Time::Now() - build->build_start;
 
   // Persist the bloom filter to disk.  Since only this thread changes
   // |browse_bloom_filter_|, there is no need to lock.
   WriteBloomFilter();
 
-  // Gather statistics.
+  DVLOG(1) << "SafeBrowsingDatabaseImpl built bloom filter in "
+           << bloom_gen.InMilliseconds() << " ms total.  prefix count: "
+           << build->add_prefixes.size();
+  UMA_HISTOGRAM_LONG_TIMES("SB2.BuildFilter", bloom_gen);
+  UMA_HISTOGRAM_COUNTS("SB2.FilterKilobytes",
+                       browse_bloom_filter_->size() / 1024);
+  int64 size_64;
+  if (file_util::GetFileSize(browse_filename_, &size_64)) {
+    UMA_HISTOGRAM_COUNTS("SB2.BrowseDatabaseKilobytes",
+                         static_cast<int>(size_64 / 1024));
+  }
+
+#if defined(OS_MACOSX)
+  base::mac::SetFileBackupExclusion(browse_filename_);
+#endif
+}
+
+void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
+  // Copy out the pending add hashes.  Copy rather than swapping in
+  // case |ContainsBrowseURL()| is called before the new filter is complete.
+  std::vector<SBAddFullHash> pending_add_hashes;
+  {
+    base::AutoLock locked(lookup_lock_);
+    pending_add_hashes.insert(pending_add_hashes.end(),
+                              pending_browse_hashes_.begin(),
+                              pending_browse_hashes_.end());
+  }
+
+  // Measure the amount of IO during the bloom filter build.
+  base::IoCounters io_before, io_after;
+  base::ProcessHandle handle = base::Process::Current().handle();
+  scoped_ptr<base::ProcessMetrics> metric(
+#if !defined(OS_MACOSX)
+      base::ProcessMetrics::CreateProcessMetrics(handle)
+#else
+      // Getting stats only for the current process is enough, so NULL is fine.
+      base::ProcessMetrics::CreateProcessMetrics(handle, NULL)
+#endif
+  );
+
+  // IoCounters are currently not supported on Mac, and may not be
+  // available for Linux, so we check the result and only show IO
+  // stats if they are available.
+  const bool got_counters = metric->GetIOCounters(&io_before);
+
+  scoped_refptr<BrowseFilterBuild> build(new BrowseFilterBuild);
+  if (!browse_store_->FinishUpdate(pending_add_hashes, prefix_miss_cache_,
+                                   &build->add_prefixes,
+                                   &build->add_full_hashes)) {
+    RecordFailure(FAILURE_BROWSE_DATABASE_UPDATE_FINISH);
+    return;
+  }
+
+  // Gather statistics on the store merge, which is where the IO happens.
   if (got_counters && metric->GetIOCounters(&io_after)) {
     UMA_HISTOGRAM_COUNTS("SB2.BuildReadKilobytes",
                          static_cast<int>(io_after.ReadTransferCount -
@@ -1316,21 +1368,26 @@ void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
                          static_cast<int>(io_after.WriteOperationCount -
                                           io_before.WriteOperationCount));
   }
-  DVLOG(1) << "SafeBrowsingDatabaseImpl built bloom filter in "
-           << bloom_gen.InMilliseconds() << " ms total.  prefix count: "
-           << add_prefixes.size();
-  UMA_HISTOGRAM_LONG_TIMES("SB2.BuildFilter", bloom_gen);
-  UMA_HISTOGRAM_COUNTS("SB2.FilterKilobytes",
-                       browse_bloom_filter_->size() / 1024);
-  int64 size_64;
-  if (file_util::GetFileSize(browse_filename_, &size_64)) {
-    UMA_HISTOGRAM_COUNTS("SB2.BrowseDatabaseKilobytes",
-                         static_cast<int>(size_64 / 1024));
-  }
 
-#if defined(OS_MACOSX)
-  base::mac::SetFileBackupExclusion(browse_filename_);
-#endif
+  // Build the replacement bloom filter and prefix set on a worker thread
+  // while this thread moves on to the whitelist stores; lookups are served
+  // from the current structures until |OnBrowseFilterBuilt()| swaps the new
+  // ones in under |lookup_lock_|.  A newer rebuild or a database reset
+  // invalidates the weak pointer, dropping any stale build on the floor.
+  filter_build_factory_.InvalidateWeakPtrs();
+  if (creation_loop_) {
+    base::WorkerPool::PostTaskAndReply(
+        FROM_HERE,
+        base::Bind(&SafeBrowsingDatabaseNew::BuildBrowseFilter, build),
+        base::Bind(&SafeBrowsingDatabaseNew::OnBrowseFilterBuilt,
+                   filter_build_factory_.GetWeakPtr(), build),
+        true);
+  } else {
+    // Without a message loop there is nowhere to reply to (unit tests);
+    // build synchronously like we used to.
+    BuildBrowseFilter(build);
+    OnBrowseFilterBuilt(build);
+  }
 }
 
 void SafeBrowsingDatabaseNew::HandleCorruptDatabase() {
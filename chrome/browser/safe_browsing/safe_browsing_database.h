@@ -300,12 +300,26 @@ class SafeBrowsingDatabaseNew : public SafeBrowsingDatabase {
   void InsertSub(int chunk, SBPrefix host, const SBEntry* entry, int list_id);
   void InsertSubChunks(int list_id, const SBChunkList& chunks);
 
+  // Carries the browse filter rebuild between the safe-browsing thread and
+  // the worker thread which does the CPU-heavy work (see UpdateBrowseStore).
+  struct BrowseFilterBuild;
+
   void UpdateDownloadStore();
   void UpdateBrowseStore();
   void UpdateWhitelistStore(const FilePath& store_filename,
                             SafeBrowsingStore* store,
                             SBWhitelist* whitelist);
 
+  // Worker-thread half of the browse filter rebuild.  Builds the bloom
+  // filter, prefix set, and sorted full-hash list in |build| from the merge
+  // results in |build|; touches nothing else.
+  static void BuildBrowseFilter(scoped_refptr<BrowseFilterBuild> build);
+
+  // Reply half, run on |creation_loop_|.  Swaps the freshly built structures
+  // in under |lookup_lock_| and persists the bloom filter.  Until this runs,
+  // lookups keep being served from the previous structures.
+  void OnBrowseFilterBuilt(scoped_refptr<BrowseFilterBuild> build);
+
   // Helper function to compare addprefixes in download_store_ with |prefixes|.
   // The |list_bit| indicates which list (download url or download hash)
   // to compare.
@@ -368,6 +382,11 @@ class SafeBrowsingDatabaseNew : public SafeBrowsingDatabase {
   // Used to schedule resetting the database because of corruption.
   base::WeakPtrFactory<SafeBrowsingDatabaseNew> reset_factory_;
 
+  // Used for the reply of the worker-thread browse filter rebuild.
+  // Invalidated when a newer rebuild or a database reset makes an
+  // outstanding build stale.
+  base::WeakPtrFactory<SafeBrowsingDatabaseNew> filter_build_factory_;
+
   // Set if corruption is detected during the course of an update.
   // Causes the update functions to fail with no side effects, until
   // the next call to |UpdateStarted()|.
@@ -66,11 +66,19 @@ std::set<SessionRestoreImpl*>* active_session_restorers = NULL;
 // Initial delay (see class decription for details).
 static const int kInitialDelayTimerMS = 100;
 
+// Max number of background tab loads in flight at once. Loading advances
+// when a tab finishes (or is closed) or when the force load timer fires, so
+// the doubling delay acts as a crude backoff when the machine is saturated.
+static const size_t kMaxConcurrentTabLoads = 3;
+
 // TabLoader is responsible for loading tabs after session restore creates
-// tabs. New tabs are loaded after the current tab finishes loading, or a delay
-// is reached (initially kInitialDelayTimerMS). If the delay is reached before
-// a tab finishes loading a new tab is loaded and the time of the delay
-// doubled.
+// tabs. The foreground tabs (one per restored window) are given the machine
+// to themselves first: background loads only start once one of them finishes
+// loading or paints, or a delay is reached (initially kInitialDelayTimerMS).
+// After that, new tabs are loaded after the current tab finishes loading, or
+// when the delay is reached. If the delay is reached before a tab finishes
+// loading a new tab is loaded and the time of the delay doubled. No more
+// than kMaxConcurrentTabLoads tabs are ever loading at once.
 //
 // TabLoader keeps a reference to itself when it's loading. When it has finished
 // loading, it drops the reference. If another profile is restored while the
@@ -110,7 +118,13 @@ class TabLoader : public content::NotificationObserver,
   explicit TabLoader(base::TimeTicks restore_started);
   virtual ~TabLoader();
 
-  // Loads the next tab. If there are no more tabs to load this deletes itself,
+  // Kicks off the background loads. If the foreground tabs are still loading
+  // no tab is loaded yet; the first background load then starts when one of
+  // them finishes or paints, or when |force_load_timer_| fires.
+  void StartFirstLoad();
+
+  // Loads the next tab unless kMaxConcurrentTabLoads tabs are already
+  // loading. If there are no more tabs to load this deletes itself,
   // otherwise |force_load_timer_| is restarted.
   void LoadNextTab();
 
@@ -224,13 +238,13 @@ void TabLoader::StartLoading() {
 #if defined(OS_CHROMEOS)
   if (!net::NetworkChangeNotifier::IsOffline()) {
     loading_ = true;
-    LoadNextTab();
+    StartFirstLoad();
   } else {
     net::NetworkChangeNotifier::AddOnlineStateObserver(this);
   }
 #else
   loading_ = true;
-  LoadNextTab();
+  StartFirstLoad();
 #endif
 }
 
@@ -250,8 +264,26 @@ TabLoader::~TabLoader() {
   shared_tab_loader = NULL;
 }
 
+void TabLoader::StartFirstLoad() {
+  if (tabs_loading_.empty()) {
+    LoadNextTab();
+    return;
+  }
+
+  // The foreground tabs are still loading; give them the full machine and
+  // start the background loads when one of them finishes or paints, or when
+  // the timer fires.
+  if (tabs_to_load_.empty())
+    return;
+  force_load_timer_.Stop();
+  force_load_timer_.Start(FROM_HERE,
+      base::TimeDelta::FromMilliseconds(force_load_delay_),
+      this, &TabLoader::ForceLoadTimerFired);
+}
+
 void TabLoader::LoadNextTab() {
-  if (!tabs_to_load_.empty()) {
+  if (!tabs_to_load_.empty() &&
+      tabs_loading_.size() < kMaxConcurrentTabLoads) {
     NavigationController* tab = tabs_to_load_.front();
     DCHECK(tab);
     tabs_loading_.insert(tab);
@@ -346,6 +378,11 @@ void TabLoader::Observe(int type,
                   100,
                   base::Histogram::kUmaTargetedHistogramFlag);
           counter_for_count->AddTime(time_to_paint);
+
+          // The foreground tab has painted; the background loads can have
+          // the machine now.
+          if (loading_)
+            LoadNextTab();
         } else if (render_widget_hosts_loading_.find(render_widget_host) ==
             render_widget_hosts_loading_.end()) {
           // If this is a host for a tab we're not loading some other tab
@@ -373,7 +410,7 @@ void TabLoader::OnOnlineStateChanged(bool online) {
   if (online) {
     if (!loading_) {
       loading_ = true;
-      LoadNextTab();
+      StartFirstLoad();
     }
   } else {
     loading_ = false;
@@ -540,7 +577,8 @@ class SessionRestoreImpl : public content::NotificationObserver {
       // Restore and show the browser.
       const int initial_tab_count = browser->tab_count();
       int selected_tab_index = (*i)->selected_tab_index;
-      RestoreTabsToBrowser(*(*i), browser, selected_tab_index);
+      RestoreTabsToBrowser(*(*i), browser, selected_tab_index,
+                           (*i)->show_state != ui::SHOW_STATE_MINIMIZED);
       ShowBrowser(browser, initial_tab_count, selected_tab_index);
       tab_loader_->TabIsLoading(
           &browser->GetSelectedWebContents()->GetController());
@@ -749,6 +787,7 @@ class SessionRestoreImpl : public content::NotificationObserver {
     for (std::vector<SessionWindow*>::iterator i = windows->begin();
          i != windows->end(); ++i) {
       Browser* browser = NULL;
+      bool is_minimized = false;
       if (!has_tabbed_browser && (*i)->type == Browser::TYPE_TABBED)
         has_tabbed_browser = true;
       if (i == windows->begin() && (*i)->type == Browser::TYPE_TABBED &&
@@ -767,6 +806,7 @@ class SessionRestoreImpl : public content::NotificationObserver {
           show_state = ui::SHOW_STATE_NORMAL;
           has_visible_browser = true;
         }
+        is_minimized = (show_state == ui::SHOW_STATE_MINIMIZED);
 
         browser = CreateRestoredBrowser(
             static_cast<Browser::Type>((*i)->type),
@@ -783,7 +823,7 @@ class SessionRestoreImpl : public content::NotificationObserver {
       WebContents* active_tab = browser->GetSelectedWebContents();
       int initial_tab_count = browser->tab_count();
       int selected_tab_index = (*i)->selected_tab_index;
-      RestoreTabsToBrowser(*(*i), browser, selected_tab_index);
+      RestoreTabsToBrowser(*(*i), browser, selected_tab_index, !is_minimized);
       ShowBrowser(browser, initial_tab_count, selected_tab_index);
       if (clobber_existing_tab_ && i == windows->begin() &&
           (*i)->type == Browser::TYPE_TABBED && active_tab &&
@@ -827,9 +867,14 @@ class SessionRestoreImpl : public content::NotificationObserver {
     }
   }
 
+  // Restores the tabs of |window| into |browser|. When |schedule_loads| is
+  // false (the window is minimized) the tabs are left as stubs: fully
+  // instantiated, but never scheduled with the TabLoader, so they only load
+  // when the user activates them.
   void RestoreTabsToBrowser(const SessionWindow& window,
                             Browser* browser,
-                            int selected_tab_index) {
+                            int selected_tab_index,
+                            bool schedule_loads) {
     DCHECK(!window.tabs.empty());
     int initial_tab_count = browser->tab_count();
     for (std::vector<SessionTab*>::const_iterator i = window.tabs.begin();
@@ -840,7 +885,8 @@ class SessionRestoreImpl : public content::NotificationObserver {
       // Don't schedule a load for the selected tab, as ShowBrowser() will
       // already have done that.
       RestoreTab(tab, tab_index, browser,
-                 tab_index != (selected_tab_index + initial_tab_count));
+                 schedule_loads &&
+                     tab_index != (selected_tab_index + initial_tab_count));
     }
   }
 
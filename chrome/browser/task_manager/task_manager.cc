@@ -4,6 +4,8 @@
 
 #include "chrome/browser/task_manager/task_manager.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/i18n/number_formatting.h"
@@ -60,6 +62,10 @@ const int kUpdateTimeMs = 2000;
 const int kUpdateTimeMs = 1000;
 #endif
 
+// The longest the update delay is allowed to grow to while the displayed
+// values are not changing.
+const int kMaxUpdateTimeMs = 4 * kUpdateTimeMs;
+
 template <class T>
 int ValueCompare(T value1, T value2) {
   if (value1 < value2)
@@ -84,6 +90,9 @@ string16 FormatStatsSize(const WebKit::WebCache::ResourceTypeStat& stat) {
 TaskManagerModel::TaskManagerModel(TaskManager* task_manager)
     : update_requests_(0),
       update_state_(IDLE),
+      visible_start_(0),
+      visible_length_(-1),
+      update_time_ms_(kUpdateTimeMs),
       goat_salt_(base::RandUint64()),
       last_unique_id_(0) {
   AddResourceProvider(
@@ -629,6 +638,9 @@ void TaskManagerModel::StartUpdating() {
   DCHECK_EQ(1, update_requests_);
   DCHECK_NE(TASK_PENDING, update_state_);
 
+  // Start each session at the full refresh rate.
+  update_time_ms_ = kUpdateTimeMs;
+
   // If update_state_ is STOPPING, it means a task is still pending.  Setting
   // it to TASK_PENDING ensures the tasks keep being posted (by Refresh()).
   if (update_state_ == IDLE) {
@@ -671,6 +683,17 @@ void TaskManagerModel::StopUpdating() {
   Clear();
 }
 
+void TaskManagerModel::SetVisibleRange(int start, int length) {
+  DCHECK_GE(start, 0);
+  if (start == visible_start_ && length == visible_length_)
+    return;
+  visible_start_ = start;
+  visible_length_ = length;
+  // A new set of rows is being metered; sample them at full rate again.
+  update_time_ms_ = kUpdateTimeMs;
+  last_refresh_values_.clear();
+}
+
 void TaskManagerModel::AddResourceProvider(
     TaskManager::ResourceProvider* provider) {
   DCHECK(provider);
@@ -802,6 +825,8 @@ void TaskManagerModel::Clear() {
     current_byte_count_map_.clear();
     displayed_network_usage_map_.clear();
 
+    last_refresh_values_.clear();
+
     FOR_EACH_OBSERVER(TaskManagerModelObserver, observer_list_,
                       OnItemsRemoved(0, size));
   }
@@ -858,15 +883,18 @@ void TaskManagerModel::Refresh() {
 
   goat_salt_ = base::RandUint64();
 
-  // Compute the CPU usage values.
-  // Note that we compute the CPU usage for all resources (instead of doing it
-  // lazily) as process_util::GetCPUUsage() returns the CPU usage since the last
-  // time it was called, and not calling it everytime would skew the value the
-  // next time it is retrieved (as it would be for more than 1 cycle).
+  int start = 0;
+  int length = 0;
+  GetRefreshRange(&start, &length);
+
+  // Compute the CPU usage values for the processes backing the refreshed
+  // rows, sampling each process at most once. process_util::GetCPUUsage()
+  // returns the CPU usage since the last time it was called, so rows that
+  // come back into the visible range simply report their usage averaged over
+  // the cycles they sat out.
   cpu_usage_map_.clear();
-  for (ResourceList::iterator iter = resources_.begin();
-       iter != resources_.end(); ++iter) {
-    base::ProcessHandle process = (*iter)->GetProcess();
+  for (int i = start; i < start + length; ++i) {
+    base::ProcessHandle process = resources_[i]->GetProcess();
     CPUUsageMap::iterator cpu_iter = cpu_usage_map_.find(process);
     if (cpu_iter != cpu_usage_map_.end())
       continue;  // Already computed.
@@ -882,7 +910,7 @@ void TaskManagerModel::Refresh() {
   // Compute the new network usage values.
   displayed_network_usage_map_.clear();
   base::TimeDelta update_time =
-      base::TimeDelta::FromMilliseconds(kUpdateTimeMs);
+      base::TimeDelta::FromMilliseconds(update_time_ms_);
   for (ResourceValueMap::iterator iter = current_byte_count_map_.begin();
        iter != current_byte_count_map_.end(); ++iter) {
     if (update_time > base::TimeDelta::FromSeconds(1)) {
@@ -897,22 +925,45 @@ void TaskManagerModel::Refresh() {
     iter->second = 0;
   }
 
-  // Let resources update themselves if they need to.
-  for (ResourceList::iterator iter = resources_.begin();
-       iter != resources_.end(); ++iter) {
-     (*iter)->Refresh();
-  }
+  // Let the refreshed resources update themselves if they need to.
+  for (int i = start; i < start + length; ++i)
+    resources_[i]->Refresh();
 
-  if (!resources_.empty()) {
+  if (length > 0) {
     FOR_EACH_OBSERVER(TaskManagerModelObserver, observer_list_,
-                      OnItemsChanged(0, ResourceCount()));
+                      OnItemsChanged(start, length));
+  }
+
+  // Back off the refresh rate while the displayed values are not changing, so
+  // that watching an idle session does not itself cost CPU.
+  std::vector<std::pair<int, int64> > current_values;
+  current_values.reserve(length);
+  for (int i = start; i < start + length; ++i) {
+    current_values.push_back(std::make_pair(
+        static_cast<int>(GetCPUUsage(resources_[i]) + 0.5),
+        GetNetworkUsage(resources_[i])));
   }
+  if (current_values == last_refresh_values_)
+    update_time_ms_ = std::min(2 * update_time_ms_, kMaxUpdateTimeMs);
+  else
+    update_time_ms_ = kUpdateTimeMs;
+  last_refresh_values_.swap(current_values);
 
   // Schedule the next update.
   MessageLoop::current()->PostDelayedTask(
       FROM_HERE,
       base::Bind(&TaskManagerModel::Refresh, this),
-      base::TimeDelta::FromMilliseconds(kUpdateTimeMs));
+      base::TimeDelta::FromMilliseconds(update_time_ms_));
+}
+
+void TaskManagerModel::GetRefreshRange(int* start, int* length) const {
+  if (visible_length_ == -1) {
+    *start = 0;
+    *length = ResourceCount();
+    return;
+  }
+  *start = std::min(visible_start_, ResourceCount());
+  *length = std::min(visible_length_, ResourceCount() - *start);
 }
 
 int64 TaskManagerModel::GetNetworkUsageForResource(
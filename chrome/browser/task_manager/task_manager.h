@@ -216,6 +216,8 @@ class TaskManager {
   FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, Basic);
   FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, Resources);
   FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, RefreshCalled);
+  FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, RefreshVisibleRowsOnly);
+  FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, RefreshBacksOffWhenIdle);
   FRIEND_TEST_ALL_PREFIXES(TaskManagerWindowControllerTest, Init);
   FRIEND_TEST_ALL_PREFIXES(TaskManagerWindowControllerTest, Sort);
   FRIEND_TEST_ALL_PREFIXES(TaskManagerWindowControllerTest,
@@ -397,6 +399,14 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
   void StartUpdating();
   void StopUpdating();
 
+  // Restricts the periodic refresh to the resources in the range
+  // [start, start + length). Values for the other rows are neither collected
+  // nor reported until they come back into range. A |length| of -1 removes
+  // the restriction. Views displaying only a few of many rows can use this so
+  // that the task manager does not meter processes nobody is looking at;
+  // views that reorder rows can simply leave the restriction unset.
+  void SetVisibleRange(int start, int length);
+
   void Clear();  // Removes all items.
 
   // Sends OnModelChanged() to all observers to inform them of significant
@@ -420,6 +430,8 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
  private:
   friend class base::RefCountedThreadSafe<TaskManagerModel>;
   FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, RefreshCalled);
+  FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, RefreshVisibleRowsOnly);
+  FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, RefreshBacksOffWhenIdle);
   FRIEND_TEST_ALL_PREFIXES(ExtensionApiTest, ProcessesVsTaskManager);
 
   ~TaskManagerModel();
@@ -463,9 +475,13 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
   typedef std::pair<size_t, size_t> MemoryUsageEntry;
   typedef std::map<base::ProcessHandle, MemoryUsageEntry> MemoryUsageMap;
 
-  // Updates the values for all rows.
+  // Updates the values for the rows selected by SetVisibleRange().
   void Refresh();
 
+  // Returns the range of rows Refresh() should update, which is the visible
+  // range clamped against the current resource count.
+  void GetRefreshRange(int* start, int* length) const;
+
   void AddItem(TaskManager::Resource* resource, bool notify_table);
   void RemoveItem(TaskManager::Resource* resource);
 
@@ -545,6 +561,22 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
   // Whether we are currently in the process of updating.
   UpdateState update_state_;
 
+  // The range of rows the periodic refresh is restricted to, as set by
+  // SetVisibleRange(). A length of -1 means all rows.
+  int visible_start_;
+  int visible_length_;
+
+  // The delay until the next refresh (in ms). Starts at the platform default
+  // and backs off while successive refreshes observe no change in the
+  // displayed values, so an idle task manager does not perturb what it
+  // measures.
+  int update_time_ms_;
+
+  // The (CPU, network) values observed for the refreshed rows at the last
+  // refresh, used to detect quiescence. CPU is kept at percentage-point
+  // granularity, matching what the table displays.
+  std::vector<std::pair<int, int64> > last_refresh_values_;
+
   // A salt lick for the goats.
   uint64 goat_salt_;
 
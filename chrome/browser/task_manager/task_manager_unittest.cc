@@ -122,3 +122,44 @@ TEST_F(TaskManagerTest, RefreshCalled) {
   ASSERT_TRUE(resource.refresh_called());
   task_manager.RemoveResource(&resource);
 }
+
+// Tests that only the rows in the visible range are refreshed.
+TEST_F(TaskManagerTest, RefreshVisibleRowsOnly) {
+  MessageLoop loop;
+  TaskManager task_manager;
+  TaskManagerModel* model = task_manager.model_;
+  TestResource resource1, resource2;
+
+  task_manager.AddResource(&resource1);
+  task_manager.AddResource(&resource2);
+  model->update_state_ = TaskManagerModel::TASK_PENDING;
+
+  model->SetVisibleRange(1, 1);
+  model->Refresh();
+  EXPECT_FALSE(resource1.refresh_called());
+  EXPECT_TRUE(resource2.refresh_called());
+
+  resource2.set_refresh_called(false);
+  model->SetVisibleRange(0, -1);
+  model->Refresh();
+  EXPECT_TRUE(resource1.refresh_called());
+  EXPECT_TRUE(resource2.refresh_called());
+
+  task_manager.RemoveResource(&resource1);
+  task_manager.RemoveResource(&resource2);
+}
+
+// Tests that the refresh delay grows while nothing observable changes.
+TEST_F(TaskManagerTest, RefreshBacksOffWhenIdle) {
+  MessageLoop loop;
+  TaskManager task_manager;
+  TaskManagerModel* model = task_manager.model_;
+
+  // With no resources every refresh looks identical to the previous one, so
+  // each one should double the delay until it hits the cap.
+  model->update_state_ = TaskManagerModel::TASK_PENDING;
+  model->Refresh();
+  int first_delay = model->update_time_ms_;
+  model->Refresh();
+  EXPECT_EQ(2 * first_delay, model->update_time_ms_);
+}
@@ -1219,6 +1219,7 @@ void AboutMemoryHandler::BindProcessMetrics(DictionaryValue* data,
   data->SetInteger("pid", info->pid);
   data->SetString("version", info->version);
   data->SetInteger("processes", info->num_processes);
+  data->SetString("heap_sample", info->heap_sample_report);
 }
 
 // Helper for AboutMemory to append memory usage information for all
@@ -13,6 +13,7 @@
 
 #include <algorithm>
 
+#include "base/atomicops.h"
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/file_util.h"
@@ -186,6 +187,7 @@ void VisitedLinkMaster::InitMembers(Listener* listener, Profile* profile) {
   file_ = NULL;
   shared_memory_ = NULL;
   shared_memory_serial_ = 0;
+  table_capacity_ = 0;
   used_items_ = 0;
   table_size_override_ = 0;
   history_service_override_ = NULL;
@@ -623,8 +625,11 @@ bool VisitedLinkMaster::GetDatabaseFileName(FilePath* filename) {
 // Initializes the shared memory structure. The salt should already be filled
 // in so that it can be written to the shared memory
 bool VisitedLinkMaster::CreateURLTable(int32 num_entries, bool init_to_empty) {
-  // The table is the size of the table followed by the entries.
-  uint32 alloc_size = num_entries * sizeof(Fingerprint) + sizeof(SharedHeader);
+  int32 capacity = TableCapacityForSize(num_entries);
+
+  // The segment is the header followed by room for |capacity| entries, of
+  // which only the first |num_entries| are in use initially.
+  uint32 alloc_size = capacity * sizeof(Fingerprint) + sizeof(SharedHeader);
 
   // Create the shared memory object.
   shared_memory_ = new base::SharedMemory();
@@ -638,14 +643,21 @@ bool VisitedLinkMaster::CreateURLTable(int32 num_entries, bool init_to_empty) {
   }
 
   if (init_to_empty) {
-    memset(shared_memory_->memory(), 0, alloc_size);
+    // Only clear the portion in use. The reserved tail is freshly allocated
+    // anonymous memory, which the OS zero-fills on first touch, and leaving
+    // it untouched keeps its pages uncommitted.
+    memset(shared_memory_->memory(), 0,
+           num_entries * sizeof(Fingerprint) + sizeof(SharedHeader));
     used_items_ = 0;
   }
   table_length_ = num_entries;
+  table_capacity_ = capacity;
 
   // Save the header for other processes to read.
   SharedHeader* header = static_cast<SharedHeader*>(shared_memory_->memory());
   header->length = table_length_;
+  header->capacity = table_capacity_;
+  base::subtle::NoBarrier_Store(&header->generation, 0);
   memcpy(header->salt, salt_, LINK_SALT_LENGTH);
 
   // Our table pointer is just the data immediately following the size.
@@ -659,11 +671,13 @@ bool VisitedLinkMaster::BeginReplaceURLTable(int32 num_entries) {
   base::SharedMemory *old_shared_memory = shared_memory_;
   Fingerprint* old_hash_table = hash_table_;
   int32 old_table_length = table_length_;
+  int32 old_table_capacity = table_capacity_;
   if (!CreateURLTable(num_entries, true)) {
     // Try to put back the old state.
     shared_memory_ = old_shared_memory;
     hash_table_ = old_hash_table;
     table_length_ = old_table_length;
+    table_capacity_ = old_table_capacity;
     return false;
   }
 
@@ -710,6 +724,15 @@ bool VisitedLinkMaster::ResizeTableIfNecessary() {
 
 void VisitedLinkMaster::ResizeTable(int32 new_size) {
   DCHECK(shared_memory_ && shared_memory_->memory() && hash_table_);
+
+  // Grows that fit in the reserved capacity don't need a new segment, so the
+  // renderers can keep their existing mappings. Shrinks always replace the
+  // segment, since that is the only way to give the memory back.
+  if (new_size > table_length_ && new_size <= table_capacity_) {
+    GrowTableInPlace(new_size);
+    return;
+  }
+
   shared_memory_serial_++;
 
 #ifndef NDEBUG
@@ -746,6 +769,53 @@ void VisitedLinkMaster::ResizeTable(int32 new_size) {
   WriteFullTable();
 }
 
+void VisitedLinkMaster::GrowTableInPlace(int32 new_size) {
+  DCHECK_GT(new_size, table_length_);
+  DCHECK_LE(new_size, table_capacity_);
+
+#ifndef NDEBUG
+  DebugValidate();
+#endif
+
+  // Move the entries aside and clear their slots. The slots between the old
+  // and new length have never been written, so they are still zero from the
+  // original allocation.
+  Fingerprints old_fingerprints;
+  old_fingerprints.reserve(used_items_);
+  for (int32 i = 0; i < table_length_; i++) {
+    if (hash_table_[i]) {
+      old_fingerprints.push_back(hash_table_[i]);
+      hash_table_[i] = null_fingerprint_;
+    }
+  }
+
+  // Rehash under the new length. AddFingerprint restores used_items_.
+  // Renderers are still probing with the old length during this migration,
+  // so they can transiently miss a link, the same window deletions already
+  // have (see DeleteFingerprint). They can not see false positives, since a
+  // positive requires finding the queried fingerprint itself.
+  table_length_ = new_size;
+  used_items_ = 0;
+  for (size_t i = 0; i < old_fingerprints.size(); i++)
+    AddFingerprint(old_fingerprints[i], false);
+
+  // Publish the new length. The release store on the generation counter
+  // makes the migrated entries and the length visible to any reader that
+  // acquires the new generation; no table re-broadcast is needed.
+  SharedHeader* header = static_cast<SharedHeader*>(shared_memory_->memory());
+  header->length = table_length_;
+  base::subtle::Release_Store(
+      &header->generation,
+      base::subtle::NoBarrier_Load(&header->generation) + 1);
+
+#ifndef NDEBUG
+  DebugValidate();
+#endif
+
+  // The layout changed, so rewrite the whole file.
+  WriteFullTable();
+}
+
 uint32 VisitedLinkMaster::NewTableSizeForCount(int32 item_count) const {
   // These table sizes are selected to be the maximum prime number less than
   // a "convenient" multiple of 1K.
@@ -778,6 +848,16 @@ uint32 VisitedLinkMaster::NewTableSizeForCount(int32 item_count) const {
   return item_count * 2 - 1;
 }
 
+uint32 VisitedLinkMaster::TableCapacityForSize(int32 num_entries) const {
+  // Reserve enough shared memory for the table to roughly quadruple (two
+  // steps of NewTableSizeForCount's size ladder), so that the next couple of
+  // grows can happen in place instead of replacing the segment and
+  // re-broadcasting the handle to every renderer process. The reservation is
+  // mostly address space: the pages behind the unused tail are not committed
+  // until a grow reaches them.
+  return NewTableSizeForCount(num_entries * 4 / 3);
+}
+
 // See the TableBuilder definition in the header file for how this works.
 bool VisitedLinkMaster::RebuildTableFromHistory() {
   DCHECK(!table_builder_);
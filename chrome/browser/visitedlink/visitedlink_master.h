@@ -262,12 +262,25 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   bool ResizeTableIfNecessary();
 
   // Resizes the table (growing or shrinking) as necessary to accomodate the
-  // current count.
+  // current count. Grows that fit within the capacity reserved in the shared
+  // memory segment are done in place by GrowTableInPlace; otherwise the
+  // segment is replaced and the new handle is broadcast to all processes.
   void ResizeTable(int32 new_size);
 
+  // Grows the table to |new_size| entries within the current shared memory
+  // segment, which must have been allocated with at least that much capacity.
+  // Renderers keep their existing mapping and pick up the new length through
+  // the generation counter in the shared header, so no handle re-broadcast
+  // is needed.
+  void GrowTableInPlace(int32 new_size);
+
   // Returns the desired table size for |item_count| URLs.
   uint32 NewTableSizeForCount(int32 item_count) const;
 
+  // Returns the number of entries to reserve shared memory for when creating
+  // a table of |num_entries|, so that the next few grows can happen in place.
+  uint32 TableCapacityForSize(int32 num_entries) const;
+
   // Computes the table load as fraction. For example, if 1/4 of the entries are
   // full, this value will be 0.25
   float ComputeTableLoad() const {
@@ -348,6 +361,11 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // shared memory object.
   int32 shared_memory_serial_;
 
+  // Number of entries the current shared memory segment can hold. When a
+  // grow stays within this capacity, ResizeTable() migrates the entries in
+  // place instead of replacing the segment.
+  int32 table_capacity_;
+
   // Number of non-empty items in the table, used to compute fullness.
   int32 used_items_;
 
@@ -2,7 +2,6 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -11,12 +10,11 @@
 #include "base/perftimer.h"
 #include "base/shared_memory.h"
 #include "base/stringprintf.h"
+#include "base/test/perf_benchmark.h"
 #include "base/test/test_file_util.h"
 #include "chrome/browser/visitedlink/visitedlink_master.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
-using base::TimeDelta;
-
 namespace {
 
 // how we generate URLs, note that the two strings should be the same length
@@ -138,17 +136,18 @@ TEST_F(VisitedLink, TestLoad) {
   }
 
   // test loading the DB back, we do this several times since the flushing is
-  // not very reliable.
+  // not very reliable.  The percentiles reported by the benchmark absorb the
+  // occasional slow load, so no samples need to be discarded.
   const int load_count = 5;
-  std::vector<double> cold_load_times;
-  std::vector<double> hot_load_times;
+  base::PerfBenchmark cold_benchmark("Visited_link_cold_load_time");
+  base::PerfBenchmark hot_benchmark("Visited_link_hot_load_time");
   for (int i = 0; i < load_count; i++) {
     // make sure the file has to be re-loaded
     file_util::EvictFileFromSystemCache(db_path_);
 
     // cold load (no OS cache, hopefully)
     {
-      PerfTimer cold_timer;
+      cold_benchmark.StartIteration();
 
       VisitedLinkMaster master(DummyVisitedLinkEventListener::GetInstance(),
                                NULL,
@@ -156,15 +155,13 @@ TEST_F(VisitedLink, TestLoad) {
                                db_path_,
                                0);
       bool success = master.Init();
-      TimeDelta elapsed = cold_timer.Elapsed();
+      cold_benchmark.StopIteration();
       ASSERT_TRUE(success);
-
-      cold_load_times.push_back(elapsed.InMillisecondsF());
     }
 
     // hot load (with OS caching the file in memory)
     {
-      PerfTimer hot_timer;
+      hot_benchmark.StartIteration();
 
       VisitedLinkMaster master(DummyVisitedLinkEventListener::GetInstance(),
                                NULL,
@@ -172,26 +169,11 @@ TEST_F(VisitedLink, TestLoad) {
                                db_path_,
                                0);
       bool success = master.Init();
-      TimeDelta elapsed = hot_timer.Elapsed();
+      hot_benchmark.StopIteration();
       ASSERT_TRUE(success);
-
-      hot_load_times.push_back(elapsed.InMillisecondsF());
     }
   }
 
-  // We discard the max and return the average time.
-  cold_load_times.erase(std::max_element(cold_load_times.begin(),
-                                         cold_load_times.end()));
-  hot_load_times.erase(std::max_element(hot_load_times.begin(),
-                                        hot_load_times.end()));
-
-  double cold_sum = 0, hot_sum = 0;
-  for (int i = 0; i < static_cast<int>(cold_load_times.size()); i++) {
-    cold_sum += cold_load_times[i];
-    hot_sum += hot_load_times[i];
-  }
-  LogPerfResult("Visited_link_cold_load_time",
-                cold_sum / cold_load_times.size(), "ms");
-  LogPerfResult("Visited_link_hot_load_time",
-                hot_sum / hot_load_times.size(), "ms");
+  cold_benchmark.Report();
+  hot_benchmark.Report();
 }
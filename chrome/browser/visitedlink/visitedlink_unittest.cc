@@ -355,7 +355,7 @@ TEST_F(VisitedLinkTest, Resizing) {
   ASSERT_EQ(used_count, g_test_count) <<
                 "table count doesn't match the # of things we added";
 
-  // Verify that the slave got the resize message and has the same
+  // Verify that the slave followed the in-place growth and has the same
   // table information.
   int32 child_table_size;
   VisitedLinkCommon::Fingerprint* child_table;
@@ -520,6 +520,11 @@ const char kEnableExtensionTimelineApi[]    = "enable-extension-timeline-api";
 // for example page cycler and layout tests. See bug 1157243.
 const char kEnableFileCookies[]             = "enable-file-cookies";
 
+// Layers an in-memory tier over the HTTP disk cache, so hot small entries
+// (favicons, scripts, style sheets) are revalidated without going through the
+// cache thread.
+const char kEnableHttpCacheRamTier[]        = "enable-http-cache-ram-tier";
+
 // Enable HTTP pipelining. Attempt to pipeline HTTP connections. Heuristics will
 // try to figure out if pipelining can be used for a given host and request.
 // Without this flag, pipelining will never be used.
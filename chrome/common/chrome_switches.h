@@ -151,6 +151,7 @@ extern const char kEnableExtensionActivityLogging[];
 extern const char kEnableExtensionActivityUI[];
 extern const char kEnableExtensionTimelineApi[];
 extern const char kEnableFileCookies[];
+extern const char kEnableHttpCacheRamTier[];
 extern const char kEnableHttpPipelining[];
 extern const char kEnableInBrowserThumbnailing[];
 extern const char kEnableIPv6[];
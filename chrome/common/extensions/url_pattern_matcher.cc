@@ -0,0 +1,147 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/common/extensions/url_pattern_matcher.h"
+
+#include <map>
+
+#include "base/stl_util.h"
+#include "base/string_split.h"
+#include "chrome/common/extensions/url_pattern_set.h"
+#include "chrome/common/url_constants.h"
+#include "googleurl/src/gurl.h"
+
+// A node of the host trie. The path from the root to a node spells a host,
+// rightmost label first, so all patterns for "google.com" live at
+// root -> "com" -> "google".
+struct URLPatternMatcher::HostNode {
+  HostNode() {}
+  ~HostNode() {
+    STLDeleteValues(&children);
+  }
+
+  // Children keyed by the next host label, walking right to left.
+  std::map<std::string, HostNode*> children;
+
+  // Patterns whose host is exactly the labels walked so far.
+  std::vector<size_t> exact;
+
+  // Patterns matching the labels walked so far or any subdomain of them.
+  std::vector<size_t> subdomain;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HostNode);
+};
+
+URLPatternMatcher::URLPatternMatcher() {
+}
+
+URLPatternMatcher::~URLPatternMatcher() {
+}
+
+void URLPatternMatcher::Compile(const URLPatternSet& patterns) {
+  patterns_.assign(patterns.begin(), patterns.end());
+  unkeyed_patterns_.clear();
+  root_.reset(new HostNode);
+
+  for (size_t i = 0; i < patterns_.size(); ++i) {
+    const URLPattern& pattern = patterns_[i];
+
+    // Patterns the host trie can't discriminate: <all_urls>, host wildcards
+    // ("*://*/..."), and file: patterns, which ignore the host entirely.
+    if (pattern.match_all_urls() ||
+        pattern.scheme() == chrome::kFileScheme ||
+        (pattern.host().empty() && pattern.match_subdomains())) {
+      unkeyed_patterns_.push_back(i);
+      continue;
+    }
+
+    HostNode* node = root_.get();
+    if (!pattern.host().empty()) {
+      std::vector<std::string> labels;
+      base::SplitString(pattern.host(), '.', &labels);
+      for (size_t j = labels.size(); j > 0; --j) {
+        HostNode*& child = node->children[labels[j - 1]];
+        if (!child)
+          child = new HostNode;
+        node = child;
+      }
+    }
+    if (pattern.match_subdomains())
+      node->subdomain.push_back(i);
+    else
+      node->exact.push_back(i);
+  }
+}
+
+bool URLPatternMatcher::MatchesURL(const GURL& url) const {
+  if (!root_.get())
+    return false;
+
+  // The side list is short (typically a couple of broad patterns); these are
+  // matched the ordinary way.
+  for (size_t i = 0; i < unkeyed_patterns_.size(); ++i) {
+    if (patterns_[unkeyed_patterns_[i]].MatchesURL(url))
+      return true;
+  }
+
+  // Mirrors URLPattern::MatchesURL's handling of nested filesystem URLs.
+  const GURL* test_url = &url;
+  bool has_inner_url = url.inner_url() != NULL;
+  if (has_inner_url) {
+    if (!url.SchemeIsFileSystem())
+      return false;  // The only nested URLs we handle are filesystem URLs.
+    test_url = url.inner_url();
+  }
+
+  std::string path_for_request = url.PathForRequest();
+  if (has_inner_url)
+    path_for_request = test_url->path() + path_for_request;
+
+  const std::string& scheme = test_url->scheme();
+  int port = test_url->EffectiveIntPort();
+  bool host_is_ip = test_url->HostIsIPAddress();
+
+  std::vector<std::string> labels;
+  if (!test_url->host().empty())
+    base::SplitString(test_url->host(), '.', &labels);
+
+  const HostNode* node = root_.get();
+  for (size_t remaining = labels.size();; --remaining) {
+    // Subdomain patterns apply at every node on the walk; exact patterns only
+    // once the whole host has been consumed. Two exceptions mirror
+    // URLPattern::MatchesHost: a pattern never expands to subdomains of an IP
+    // address, and a test host that only prepends "." to the pattern host
+    // (one leading empty label left) is rejected there as too short.
+    bool subdomain_applies =
+        remaining == 0 ||
+        (!host_is_ip && !(remaining == 1 && labels[0].empty()));
+    if (subdomain_applies &&
+        MatchesAnyCandidate(node->subdomain, scheme, port, path_for_request))
+      return true;
+
+    if (remaining == 0) {
+      return MatchesAnyCandidate(node->exact, scheme, port, path_for_request);
+    }
+
+    std::map<std::string, HostNode*>::const_iterator child =
+        node->children.find(labels[remaining - 1]);
+    if (child == node->children.end())
+      return false;
+    node = child->second;
+  }
+}
+
+bool URLPatternMatcher::MatchesAnyCandidate(const std::vector<size_t>& indices,
+                                            const std::string& scheme,
+                                            int port,
+                                            const std::string& path) const {
+  for (size_t i = 0; i < indices.size(); ++i) {
+    const URLPattern& pattern = patterns_[indices[i]];
+    if (pattern.MatchesScheme(scheme) && pattern.MatchesPort(port) &&
+        pattern.MatchesPath(path))
+      return true;
+  }
+  return false;
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_COMMON_EXTENSIONS_URL_PATTERN_MATCHER_H_
+#define CHROME_COMMON_EXTENSIONS_URL_PATTERN_MATCHER_H_
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "chrome/common/extensions/url_pattern.h"
+
+class GURL;
+class URLPatternSet;
+
+// Matches a URL against a whole URLPatternSet in one pass.
+//
+// URLPatternSet::MatchesURL tests the URL against every pattern in turn,
+// which gets expensive when the set is large: with many extensions installed
+// each webRequest-relevant URL ends up tested against hundreds of patterns.
+// URLPatternMatcher compiles the set once, bucketing patterns by host into a
+// trie keyed on the host's dot-separated labels in reverse order. Matching
+// then walks the request host through the trie once and only evaluates the
+// scheme, port and path of the few patterns whose host component already
+// matched. Patterns that can't be keyed by host (<all_urls>, host wildcards,
+// and file: patterns, which ignore the host) are kept in a short side list.
+//
+// The matcher gives exactly the same answer as calling MatchesURL on every
+// pattern of the compiled set.
+class URLPatternMatcher {
+ public:
+  URLPatternMatcher();
+  ~URLPatternMatcher();
+
+  // Compiles |patterns|, replacing anything compiled previously. The matcher
+  // keeps its own copies of the patterns.
+  void Compile(const URLPatternSet& patterns);
+
+  // Returns true if any compiled pattern matches |url|. Equivalent to
+  // URLPatternSet::MatchesURL on the compiled set.
+  bool MatchesURL(const GURL& url) const;
+
+ private:
+  // A node of the host trie (see the .cc file).
+  struct HostNode;
+
+  // Returns true if any of the patterns at |indices| matches the given
+  // scheme, port and request path. The host has already been matched by the
+  // trie walk.
+  bool MatchesAnyCandidate(const std::vector<size_t>& indices,
+                           const std::string& scheme,
+                           int port,
+                           const std::string& path) const;
+
+  // Copies of all patterns in the compiled set. The trie and
+  // unkeyed_patterns_ hold indices into this vector.
+  URLPatternList patterns_;
+
+  // Patterns matched without consulting the host trie.
+  std::vector<size_t> unkeyed_patterns_;
+
+  // Root of the host trie. NULL until Compile is called.
+  scoped_ptr<HostNode> root_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLPatternMatcher);
+};
+
+#endif  // CHROME_COMMON_EXTENSIONS_URL_PATTERN_MATCHER_H_
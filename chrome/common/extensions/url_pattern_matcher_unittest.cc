@@ -0,0 +1,161 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/common/extensions/url_pattern_matcher.h"
+
+#include "chrome/common/extensions/url_pattern_set.h"
+#include "googleurl/src/gurl.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+static void AddPattern(URLPatternSet* set, const std::string& pattern) {
+  int schemes = URLPattern::SCHEME_ALL;
+  set->AddPattern(URLPattern(schemes, pattern));
+}
+
+// Verifies that the matcher and a plain URLPatternSet scan agree on |url|.
+static void ExpectAgreement(const URLPatternMatcher& matcher,
+                            const URLPatternSet& set,
+                            const std::string& url) {
+  GURL gurl(url);
+  EXPECT_EQ(set.MatchesURL(gurl), matcher.MatchesURL(gurl))
+      << "Disagreed on " << url;
+}
+
+}  // namespace
+
+TEST(URLPatternMatcherTest, Empty) {
+  URLPatternMatcher matcher;
+  EXPECT_FALSE(matcher.MatchesURL(GURL("http://www.foo.com/bar")));
+
+  matcher.Compile(URLPatternSet());
+  EXPECT_FALSE(matcher.MatchesURL(GURL("http://www.foo.com/bar")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL()));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("invalid")));
+}
+
+TEST(URLPatternMatcherTest, HostMatching) {
+  URLPatternSet set;
+  AddPattern(&set, "http://www.google.com/*");
+  AddPattern(&set, "http://*.yahoo.com/*");
+  AddPattern(&set, "http://com/*");
+  AddPattern(&set, "http://127.0.0.1/*");
+  AddPattern(&set, "http://*.0.1/*");
+
+  URLPatternMatcher matcher;
+  matcher.Compile(set);
+
+  // Exact hosts.
+  EXPECT_TRUE(matcher.MatchesURL(GURL("http://www.google.com/")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("http://mail.google.com/")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("http://google.com/")));
+
+  // Subdomain expansion, including the bare host.
+  EXPECT_TRUE(matcher.MatchesURL(GURL("http://yahoo.com/")));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("http://mail.yahoo.com/")));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("http://a.b.yahoo.com/")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("http://myahoo.com/")));
+
+  // A registry-level pattern matches anything under it.
+  EXPECT_FALSE(matcher.MatchesURL(GURL("http://dotcom.org/")));
+
+  // No subdomain expansion against IP addresses, but exact matches work.
+  EXPECT_TRUE(matcher.MatchesURL(GURL("http://127.0.0.1/")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("http://10.0.0.1/")));
+
+  const char* urls[] = {
+    "http://www.google.com/foo",
+    "http://images.google.com/",
+    "http://com/",
+    "http://a.com/",
+    "http://yahoo.com.example.com/",
+    "http://127.0.0.1/index.html",
+  };
+  for (size_t i = 0; i < arraysize(urls); ++i)
+    ExpectAgreement(matcher, set, urls[i]);
+}
+
+TEST(URLPatternMatcherTest, SchemePortAndPath) {
+  URLPatternSet set;
+  AddPattern(&set, "http://www.example.com/foo*");
+  AddPattern(&set, "https://www.example.com/bar/*");
+  AddPattern(&set, "http://www.example.com:8080/*");
+
+  URLPatternMatcher matcher;
+  matcher.Compile(set);
+
+  EXPECT_TRUE(matcher.MatchesURL(GURL("http://www.example.com/foo")));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("http://www.example.com/foobar")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("http://www.example.com/bar/baz")));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("https://www.example.com/bar/baz")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("ftp://www.example.com/foo")));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("http://www.example.com:8080/baz")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("https://www.example.com:8080/baz")));
+}
+
+TEST(URLPatternMatcherTest, UnkeyedPatterns) {
+  URLPatternSet set;
+  AddPattern(&set, "<all_urls>");
+
+  URLPatternMatcher matcher;
+  matcher.Compile(set);
+  EXPECT_TRUE(matcher.MatchesURL(GURL("http://anything.example.com/")));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("file:///foo/bar")));
+
+  URLPatternSet set2;
+  AddPattern(&set2, "http://*/blah/*");
+  AddPattern(&set2, "file:///etc/*");
+
+  matcher.Compile(set2);
+  EXPECT_TRUE(matcher.MatchesURL(GURL("http://www.example.com/blah/")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("http://www.example.com/no/")));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("file:///etc/passwd")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("file:///var/log")));
+  // Recompiling replaced the old patterns.
+  EXPECT_FALSE(matcher.MatchesURL(GURL("https://anything.example.com/")));
+}
+
+TEST(URLPatternMatcherTest, AgreesWithLinearScan) {
+  URLPatternSet set;
+  AddPattern(&set, "http://www.google.com/*");
+  AddPattern(&set, "http://*.google.com/mail/*");
+  AddPattern(&set, "https://*.example.org/*");
+  AddPattern(&set, "http://example.org/index.html");
+  AddPattern(&set, "*://*.wildcard.com/*");
+  AddPattern(&set, "ftp://ftp.example.com/pub/*");
+  AddPattern(&set, "http://*/global*");
+  AddPattern(&set, "file:///etc/hosts*");
+  AddPattern(&set, "http://192.168.0.1/*");
+
+  URLPatternMatcher matcher;
+  matcher.Compile(set);
+
+  const char* urls[] = {
+    "http://www.google.com/",
+    "http://www.google.com/mail/inbox",
+    "http://mail.google.com/mail/inbox",
+    "http://mail.google.com/",
+    "https://www.example.org/",
+    "https://example.org/",
+    "http://example.org/index.html",
+    "http://example.org/index.htm",
+    "http://wildcard.com/",
+    "https://a.b.wildcard.com/anything",
+    "ftp://ftp.example.com/pub/file",
+    "ftp://ftp.example.com/private/file",
+    "http://unrelated.net/global-reach",
+    "http://unrelated.net/local",
+    "file:///etc/hosts",
+    "file:///etc/passwd",
+    "http://192.168.0.1/router",
+    "http://192.168.0.2/router",
+    "http://0.1/",
+    "filesystem:http://www.google.com/temporary/file",
+    "about:blank",
+    "",
+  };
+  for (size_t i = 0; i < arraysize(urls); ++i)
+    ExpectAgreement(matcher, set, urls[i]);
+}
@@ -10,9 +10,12 @@
 #include "base/callback.h"
 #include "base/file_util.h"
 #include "base/json/json_file_value_serializer.h"
+#include "base/json/json_reader.h"
 #include "base/json/json_string_value_serializer.h"
+#include "base/md5.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop_proxy.h"
+#include "base/pickle.h"
 #include "base/sequenced_task_runner.h"
 #include "base/values.h"
 
@@ -21,6 +24,265 @@ namespace {
 // Some extensions we'll tack on to copies of the Preferences files.
 const FilePath::CharType* kBadExtension = FILE_PATH_LITERAL("bad");
 
+// Extension of the append-only journal kept beside the preferences file.
+// Each line is a JSON dictionary describing one pref change, so a single
+// change costs an append proportional to the change instead of a rewrite
+// of the whole preferences dictionary.
+const FilePath::CharType* kJournalExtension = FILE_PATH_LITERAL("journal");
+
+// Keys used within a journal entry.
+const char kJournalEntryKey[] = "key";
+const char kJournalEntryValue[] = "value";
+const char kJournalEntryRemoved[] = "removed";
+
+// Size at which the journal is folded back into the preferences file.
+// Replaying the journal is O(size), so keep it modest.
+const int64 kMaxJournalBytes = 64 * 1024;
+
+// Extension of the binary snapshot kept beside the preferences file. It
+// holds the parsed preference tree in pickled form plus a hash of the JSON
+// text it was derived from, so a startup whose preferences file hasn't
+// changed deserializes the tree instead of re-parsing the JSON.
+const FilePath::CharType* kSnapshotExtension = FILE_PATH_LITERAL("snapshot");
+
+// Bump to invalidate snapshots whose pickled layout has changed.
+const int kSnapshotVersion = 1;
+
+FilePath JournalPath(const FilePath& pref_path) {
+  return pref_path.AddExtension(kJournalExtension);
+}
+
+FilePath SnapshotPath(const FilePath& pref_path) {
+  return pref_path.AddExtension(kSnapshotExtension);
+}
+
+// Runs on the file thread.
+void AppendLineToFile(const FilePath& path, const std::string& line) {
+  file_util::AppendToFile(path, line.data(), line.size());
+}
+
+// Runs on the file thread.
+void WriteStringToFile(const FilePath& path, const std::string& data) {
+  file_util::WriteFile(path, data.data(), data.size());
+}
+
+// Serializes |value| into |pickle| as a type tag followed by the payload;
+// containers write their size and then their children.
+bool PickleValue(const Value* value, Pickle* pickle) {
+  if (!pickle->WriteInt(value->GetType()))
+    return false;
+  switch (value->GetType()) {
+    case Value::TYPE_NULL:
+      return true;
+    case Value::TYPE_BOOLEAN: {
+      bool bool_value = false;
+      value->GetAsBoolean(&bool_value);
+      return pickle->WriteBool(bool_value);
+    }
+    case Value::TYPE_INTEGER: {
+      int int_value = 0;
+      value->GetAsInteger(&int_value);
+      return pickle->WriteInt(int_value);
+    }
+    case Value::TYPE_DOUBLE: {
+      double double_value = 0;
+      value->GetAsDouble(&double_value);
+      return pickle->WriteData(reinterpret_cast<const char*>(&double_value),
+                               sizeof(double_value));
+    }
+    case Value::TYPE_STRING: {
+      std::string string_value;
+      value->GetAsString(&string_value);
+      return pickle->WriteString(string_value);
+    }
+    case Value::TYPE_BINARY: {
+      const base::BinaryValue* binary =
+          static_cast<const base::BinaryValue*>(value);
+      return pickle->WriteData(binary->GetBuffer(),
+                               static_cast<int>(binary->GetSize()));
+    }
+    case Value::TYPE_DICTIONARY: {
+      const DictionaryValue* dict = static_cast<const DictionaryValue*>(value);
+      if (!pickle->WriteInt(static_cast<int>(dict->size())))
+        return false;
+      for (DictionaryValue::key_iterator key = dict->begin_keys();
+           key != dict->end_keys(); ++key) {
+        Value* child = NULL;
+        if (!dict->GetWithoutPathExpansion(*key, &child) ||
+            !pickle->WriteString(*key) ||
+            !PickleValue(child, pickle)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case Value::TYPE_LIST: {
+      const ListValue* list = static_cast<const ListValue*>(value);
+      if (!pickle->WriteInt(static_cast<int>(list->GetSize())))
+        return false;
+      for (size_t i = 0; i < list->GetSize(); ++i) {
+        Value* child = NULL;
+        if (!list->Get(i, &child) || !PickleValue(child, pickle))
+          return false;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+// Inverse of PickleValue. Returns NULL if |iter| doesn't hold a well-formed
+// value (e.g. the snapshot file is truncated or corrupt).
+Value* UnpickleValue(PickleIterator* iter) {
+  int type = -1;
+  if (!iter->ReadInt(&type))
+    return NULL;
+  switch (type) {
+    case Value::TYPE_NULL:
+      return Value::CreateNullValue();
+    case Value::TYPE_BOOLEAN: {
+      bool bool_value = false;
+      if (!iter->ReadBool(&bool_value))
+        return NULL;
+      return Value::CreateBooleanValue(bool_value);
+    }
+    case Value::TYPE_INTEGER: {
+      int int_value = 0;
+      if (!iter->ReadInt(&int_value))
+        return NULL;
+      return Value::CreateIntegerValue(int_value);
+    }
+    case Value::TYPE_DOUBLE: {
+      const char* data = NULL;
+      int length = 0;
+      if (!iter->ReadData(&data, &length) ||
+          length != static_cast<int>(sizeof(double))) {
+        return NULL;
+      }
+      double double_value;
+      memcpy(&double_value, data, sizeof(double_value));
+      return Value::CreateDoubleValue(double_value);
+    }
+    case Value::TYPE_STRING: {
+      std::string string_value;
+      if (!iter->ReadString(&string_value))
+        return NULL;
+      return Value::CreateStringValue(string_value);
+    }
+    case Value::TYPE_BINARY: {
+      const char* data = NULL;
+      int length = 0;
+      if (!iter->ReadData(&data, &length))
+        return NULL;
+      return base::BinaryValue::CreateWithCopiedBuffer(data, length);
+    }
+    case Value::TYPE_DICTIONARY: {
+      int count = 0;
+      if (!iter->ReadInt(&count) || count < 0)
+        return NULL;
+      scoped_ptr<DictionaryValue> dict(new DictionaryValue);
+      for (int i = 0; i < count; ++i) {
+        std::string key;
+        if (!iter->ReadString(&key))
+          return NULL;
+        Value* child = UnpickleValue(iter);
+        if (!child)
+          return NULL;
+        dict->SetWithoutPathExpansion(key, child);
+      }
+      return dict.release();
+    }
+    case Value::TYPE_LIST: {
+      int count = 0;
+      if (!iter->ReadInt(&count) || count < 0)
+        return NULL;
+      scoped_ptr<ListValue> list(new ListValue);
+      for (int i = 0; i < count; ++i) {
+        Value* child = UnpickleValue(iter);
+        if (!child)
+          return NULL;
+        list->Append(child);
+      }
+      return list.release();
+    }
+  }
+  return NULL;
+}
+
+// Tries to satisfy a preferences read from the snapshot beside |pref_path|.
+// Returns the deserialized dictionary if the snapshot was written against
+// exactly the bytes the preferences file holds now, NULL otherwise (the
+// caller then parses the JSON as usual).
+Value* ReadSnapshot(const FilePath& pref_path) {
+  std::string snapshot;
+  if (!file_util::ReadFileToString(SnapshotPath(pref_path), &snapshot))
+    return NULL;
+
+  Pickle pickle(snapshot.data(), snapshot.size());
+  PickleIterator iter(pickle);
+  int version = 0;
+  std::string digest;
+  if (!iter.ReadInt(&version) || version != kSnapshotVersion ||
+      !iter.ReadString(&digest)) {
+    return NULL;
+  }
+
+  std::string contents;
+  if (!file_util::ReadFileToString(pref_path, &contents) ||
+      base::MD5String(contents) != digest) {
+    return NULL;
+  }
+
+  scoped_ptr<Value> value(UnpickleValue(&iter));
+  if (!value.get() || !value->IsType(Value::TYPE_DICTIONARY))
+    return NULL;
+  return value.release();
+}
+
+// Runs on the file thread.
+void DeleteJournalFile(const FilePath& path) {
+  file_util::Delete(path, false);
+}
+
+// Replays the journal beside |pref_path| on top of |dict|, returning true
+// if any entry was applied.  Entries are applied oldest first, so the last
+// write to a key wins, matching the order the changes were made in.  A
+// torn final line (machine lost power mid-append) is expected and ignored,
+// as are individually unparseable lines.
+bool ApplyJournal(const FilePath& pref_path, DictionaryValue* dict) {
+  std::string contents;
+  if (!file_util::ReadFileToString(JournalPath(pref_path), &contents))
+    return false;
+
+  bool applied = false;
+  size_t start = 0;
+  while (start < contents.size()) {
+    size_t end = contents.find('\n', start);
+    if (end == std::string::npos)
+      break;  // Torn final line.
+    scoped_ptr<Value> parsed(
+        base::JSONReader::Read(contents.substr(start, end - start)));
+    start = end + 1;
+
+    DictionaryValue* entry = NULL;
+    std::string key;
+    if (!parsed.get() || !parsed->GetAsDictionary(&entry) ||
+        !entry->GetString(kJournalEntryKey, &key))
+      continue;
+
+    bool removed = false;
+    Value* value = NULL;
+    if (entry->GetBoolean(kJournalEntryRemoved, &removed) && removed) {
+      dict->Remove(key, NULL);
+      applied = true;
+    } else if (entry->Remove(kJournalEntryValue, &value)) {
+      dict->Set(key, value);
+      applied = true;
+    }
+  }
+  return applied;
+}
+
 // Differentiates file loading between origin thread and passed
 // (aka file) thread.
 class FileThreadDeserializer
@@ -29,6 +291,7 @@ class FileThreadDeserializer
   FileThreadDeserializer(JsonPrefStore* delegate,
                          base::SequencedTaskRunner* blocking_task_runner)
       : no_dir_(false),
+        journal_applied_(false),
         error_(PersistentPrefStore::PREF_READ_ERROR_NONE),
         delegate_(delegate),
         blocking_task_runner_(blocking_task_runner),
@@ -45,7 +308,7 @@ class FileThreadDeserializer
 
   // Deserializes JSON on the file thread.
   void ReadFileAndReport(const FilePath& path) {
-    value_.reset(DoReading(path, &error_, &no_dir_));
+    value_.reset(DoReading(path, &error_, &no_dir_, &journal_applied_));
 
     origin_loop_proxy_->PostTask(
         FROM_HERE,
@@ -55,18 +318,47 @@ class FileThreadDeserializer
   // Reports deserialization result on the origin thread.
   void ReportOnOriginThread() {
     DCHECK(origin_loop_proxy_->BelongsToCurrentThread());
-    delegate_->OnFileRead(value_.release(), error_, no_dir_);
+    delegate_->OnFileRead(value_.release(), error_, no_dir_, journal_applied_);
   }
 
   static Value* DoReading(const FilePath& path,
                           PersistentPrefStore::PrefReadError* error,
-                          bool* no_dir) {
+                          bool* no_dir,
+                          bool* journal_applied) {
+    // An up-to-date binary snapshot spares re-parsing the JSON.
+    Value* value = ReadSnapshot(path);
+    if (value) {
+      *error = PersistentPrefStore::PREF_READ_ERROR_NONE;
+      *no_dir = !file_util::PathExists(path.DirName());
+      *journal_applied =
+          ApplyJournal(path, static_cast<DictionaryValue*>(value));
+      return value;
+    }
+
     int error_code;
     std::string error_msg;
     JSONFileValueSerializer serializer(path);
-    Value* value = serializer.Deserialize(&error_code, &error_msg);
+    value = serializer.Deserialize(&error_code, &error_msg);
     HandleErrors(value, path, error_code, error_msg, error);
     *no_dir = !file_util::PathExists(path.DirName());
+
+    // Changes made since the preferences file was last rewritten live in
+    // the journal; replay them on top of the file's contents.
+    *journal_applied = false;
+    if (value && value->IsType(Value::TYPE_DICTIONARY)) {
+      *journal_applied =
+          ApplyJournal(path, static_cast<DictionaryValue*>(value));
+    } else if (!value &&
+               *error == PersistentPrefStore::PREF_READ_ERROR_NO_FILE) {
+      // The journal may hold changes made before the first full rewrite of
+      // the preferences file ever happened.
+      scoped_ptr<DictionaryValue> dict(new DictionaryValue);
+      if (ApplyJournal(path, dict.get())) {
+        *journal_applied = true;
+        *error = PersistentPrefStore::PREF_READ_ERROR_NONE;
+        value = dict.release();
+      }
+    }
     return value;
   }
 
@@ -81,6 +373,7 @@ class FileThreadDeserializer
   ~FileThreadDeserializer() {}
 
   bool no_dir_;
+  bool journal_applied_;
   PersistentPrefStore::PrefReadError error_;
   scoped_ptr<Value> value_;
   scoped_refptr<JsonPrefStore> delegate_;
@@ -139,13 +432,15 @@ void FileThreadDeserializer::HandleErrors(
 JsonPrefStore::JsonPrefStore(const FilePath& filename,
                              base::SequencedTaskRunner* blocking_task_runner)
     : path_(filename),
+      journal_path_(filename.empty() ? FilePath() : JournalPath(filename)),
       blocking_task_runner_(blocking_task_runner),
       prefs_(new DictionaryValue()),
       read_only_(false),
       writer_(filename, blocking_task_runner),
       error_delegate_(NULL),
       initialized_(false),
-      read_error_(PREF_READ_ERROR_OTHER) {
+      read_error_(PREF_READ_ERROR_OTHER),
+      journal_bytes_pending_(0) {
 }
 
 PrefStore::ReadResult JsonPrefStore::GetValue(const std::string& key,
@@ -199,7 +494,7 @@ void JsonPrefStore::SetValueSilently(const std::string& key, Value* value) {
   if (!old_value || !value->Equals(old_value)) {
     prefs_->Set(key, new_value.release());
     if (!read_only_)
-      writer_.ScheduleWrite(this);
+      AppendToJournal(key, false);
   }
 }
 
@@ -222,14 +517,16 @@ PersistentPrefStore::PrefReadError JsonPrefStore::GetReadError() const {
 
 PersistentPrefStore::PrefReadError JsonPrefStore::ReadPrefs() {
   if (path_.empty()) {
-    OnFileRead(NULL, PREF_READ_ERROR_FILE_NOT_SPECIFIED, false);
+    OnFileRead(NULL, PREF_READ_ERROR_FILE_NOT_SPECIFIED, false, false);
     return PREF_READ_ERROR_FILE_NOT_SPECIFIED;
   }
 
   PrefReadError error;
   bool no_dir;
-  Value* value = FileThreadDeserializer::DoReading(path_, &error, &no_dir);
-  OnFileRead(value, error, no_dir);
+  bool journal_applied;
+  Value* value = FileThreadDeserializer::DoReading(path_, &error, &no_dir,
+                                                   &journal_applied);
+  OnFileRead(value, error, no_dir, journal_applied);
   return error;
 }
 
@@ -237,7 +534,7 @@ void JsonPrefStore::ReadPrefsAsync(ReadErrorDelegate *error_delegate) {
   initialized_ = false;
   error_delegate_.reset(error_delegate);
   if (path_.empty()) {
-    OnFileRead(NULL, PREF_READ_ERROR_FILE_NOT_SPECIFIED, false);
+    OnFileRead(NULL, PREF_READ_ERROR_FILE_NOT_SPECIFIED, false, false);
     return;
   }
 
@@ -249,19 +546,79 @@ void JsonPrefStore::ReadPrefsAsync(ReadErrorDelegate *error_delegate) {
 }
 
 void JsonPrefStore::CommitPendingWrite() {
-  if (writer_.HasPendingWrite() && !read_only_)
+  if (read_only_)
+    return;
+  if (journal_bytes_pending_ > 0)
+    CompactJournal();
+  else if (writer_.HasPendingWrite())
     writer_.DoScheduledWrite();
 }
 
 void JsonPrefStore::ReportValueChanged(const std::string& key) {
   FOR_EACH_OBSERVER(PrefStore::Observer, observers_, OnPrefValueChanged(key));
   if (!read_only_)
+    AppendToJournal(key, !prefs_->Get(key, NULL));
+}
+
+void JsonPrefStore::AppendToJournal(const std::string& key, bool removed) {
+  DCHECK(!read_only_);
+  if (path_.empty())
+    return;
+
+  // Until the initial read completes we don't know what is on disk, so a
+  // journal entry might be replayed against the wrong base. Fall back to
+  // scheduling a full write.
+  if (!initialized_) {
     writer_.ScheduleWrite(this);
+    return;
+  }
+
+  DictionaryValue entry;
+  entry.SetString(kJournalEntryKey, key);
+  if (removed) {
+    entry.SetBoolean(kJournalEntryRemoved, true);
+  } else {
+    Value* value = NULL;
+    if (!prefs_->Get(key, &value))
+      return;
+    entry.Set(kJournalEntryValue, value->DeepCopy());
+  }
+
+  std::string line;
+  JSONStringValueSerializer serializer(&line);
+  if (!serializer.Serialize(entry)) {
+    writer_.ScheduleWrite(this);
+    return;
+  }
+  line.push_back('\n');
+
+  journal_bytes_pending_ += line.size();
+  if (journal_bytes_pending_ > kMaxJournalBytes) {
+    CompactJournal();
+    return;
+  }
+
+  blocking_task_runner_->PostTask(
+      FROM_HERE, base::Bind(&AppendLineToFile, journal_path_, line));
+}
+
+void JsonPrefStore::CompactJournal() {
+  DCHECK(!read_only_);
+  journal_bytes_pending_ = 0;
+
+  // The rewrite and the journal deletion run on the same sequence as the
+  // journal appends, in that order, so the journal can never be deleted
+  // while it holds entries the rewritten file lacks.
+  writer_.ScheduleWrite(this);
+  writer_.DoScheduledWrite();
+  blocking_task_runner_->PostTask(
+      FROM_HERE, base::Bind(&DeleteJournalFile, journal_path_));
 }
 
 void JsonPrefStore::OnFileRead(Value* value_owned,
                                PersistentPrefStore::PrefReadError error,
-                               bool no_dir) {
+                               bool no_dir,
+                               bool journal_applied) {
   scoped_ptr<Value> value(value_owned);
   initialized_ = true;
   read_error_ = error;
@@ -299,6 +656,11 @@ void JsonPrefStore::OnFileRead(Value* value_owned,
   if (error_delegate_.get() && error != PREF_READ_ERROR_NONE)
     error_delegate_->OnError(error);
 
+  // Fold any replayed journal entries into the preferences file so the
+  // journal doesn't grow without bound across sessions.
+  if (journal_applied && !read_only_)
+    CompactJournal();
+
   FOR_EACH_OBSERVER(PrefStore::Observer,
                     observers_,
                     OnInitializationCompleted(true));
@@ -338,5 +700,22 @@ bool JsonPrefStore::SerializeData(std::string* output) {
     }
   }
 
-  return serializer.Serialize(*(copy.get()));
+  if (!serializer.Serialize(*(copy.get())))
+    return false;
+
+  // Refresh the snapshot to match the file about to be written, so the next
+  // startup deserializes the tree instead of re-parsing the JSON. A crash
+  // between the two writes just leaves a snapshot whose hash no longer
+  // matches, which the reader ignores.
+  Pickle pickle;
+  if (pickle.WriteInt(kSnapshotVersion) &&
+      pickle.WriteString(base::MD5String(*output)) &&
+      PickleValue(copy.get(), &pickle)) {
+    blocking_task_runner_->PostTask(
+        FROM_HERE,
+        base::Bind(&WriteStringToFile, SnapshotPath(path_),
+                   std::string(static_cast<const char*>(pickle.data()),
+                               pickle.size())));
+  }
+  return true;
 }
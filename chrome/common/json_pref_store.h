@@ -58,10 +58,14 @@ class JsonPrefStore : public PersistentPrefStore,
   virtual void ReportValueChanged(const std::string& key) OVERRIDE;
 
   // This method is called after JSON file has been read. Method takes
-  // ownership of the |value| pointer. Note, this method is used with
-  // asynchronous file reading, so class exposes it only for the internal needs.
-  // (read: do not call it manually).
-  void OnFileRead(base::Value* value_owned, PrefReadError error, bool no_dir);
+  // ownership of the |value| pointer. |journal_applied| is true if pref
+  // changes were replayed from the sidecar journal on top of the main file.
+  // Note, this method is used with asynchronous file reading, so class
+  // exposes it only for the internal needs. (read: do not call it manually).
+  void OnFileRead(base::Value* value_owned,
+                  PrefReadError error,
+                  bool no_dir,
+                  bool journal_applied);
 
  private:
   virtual ~JsonPrefStore();
@@ -69,7 +73,22 @@ class JsonPrefStore : public PersistentPrefStore,
   // ImportantFileWriter::DataSerializer overrides:
   virtual bool SerializeData(std::string* output) OVERRIDE;
 
+  // Records a change to |key| in the sidecar journal rather than
+  // re-serializing and rewriting the whole preferences file.  The journal is
+  // an append-only file of one JSON entry per change, so the I/O is
+  // proportional to the change, not to the size of the dictionary.  |removed|
+  // indicates the key was removed rather than set.
+  void AppendToJournal(const std::string& key, bool removed);
+
+  // Folds the journal back into the main preferences file: schedules a full
+  // rewrite through |writer_| and deletes the journal once that write has
+  // landed.  Called when the journal grows past its size budget, when
+  // replayed journal entries are detected at load time, and from
+  // CommitPendingWrite().
+  void CompactJournal();
+
   FilePath path_;
+  FilePath journal_path_;
   scoped_refptr<base::SequencedTaskRunner> blocking_task_runner_;
 
   scoped_ptr<base::DictionaryValue> prefs_;
@@ -86,6 +105,11 @@ class JsonPrefStore : public PersistentPrefStore,
   bool initialized_;
   PrefReadError read_error_;
 
+  // Bytes appended to the journal since the last compaction. Only an
+  // estimate of the on-disk size; it is reset without waiting for the
+  // compaction write to complete.
+  int64 journal_bytes_pending_;
+
   std::set<std::string> keys_need_empty_value_;
 
   DISALLOW_COPY_AND_ASSIGN(JsonPrefStore);
@@ -3,11 +3,13 @@
 // found in the LICENSE file.
 
 #include "base/file_util.h"
+#include "base/md5.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop.h"
 #include "base/message_loop_proxy.h"
 #include "base/path_service.h"
+#include "base/pickle.h"
 #include "base/scoped_temp_dir.h"
 #include "base/string_number_conversions.h"
 #include "base/string_util.h"
@@ -245,6 +247,134 @@ TEST_F(JsonPrefStoreTest, AsyncNonExistingFile) {
   EXPECT_FALSE(pref_store->ReadOnly());
 }
 
+// Changes are appended to a sidecar journal instead of rewriting the whole
+// preferences file; a store reading the file must replay the journal and
+// then fold it back into the main file.
+TEST_F(JsonPrefStoreTest, JournalRecovery) {
+  FilePath pref_file = temp_dir_.path().AppendASCII("write.json");
+  FilePath journal_file = temp_dir_.path().AppendASCII("write.json.journal");
+
+  // Keep the first store alive for the whole test so its destructor can't
+  // flush a full snapshot; this simulates a crash after the journal appends
+  // but before any rewrite of the main file.
+  scoped_refptr<JsonPrefStore> pref_store =
+      new JsonPrefStore(pref_file, message_loop_proxy_.get());
+  EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NO_FILE,
+            pref_store->ReadPrefs());
+
+  pref_store->SetValue(prefs::kHomePage,
+                       Value::CreateStringValue("http://www.cnn.com"));
+  pref_store->SetValue("tabs.max_tabs", Value::CreateIntegerValue(20));
+  pref_store->RemoveValue("tabs.max_tabs");
+  message_loop_.RunAllPending();
+
+  // Only the journal has been written.
+  EXPECT_FALSE(file_util::PathExists(pref_file));
+  EXPECT_TRUE(file_util::PathExists(journal_file));
+
+  // A second store sees the journaled values...
+  scoped_refptr<JsonPrefStore> pref_store2 =
+      new JsonPrefStore(pref_file, message_loop_proxy_.get());
+  EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            pref_store2->ReadPrefs());
+
+  const Value* actual;
+  std::string string_value;
+  EXPECT_EQ(PrefStore::READ_OK,
+            pref_store2->GetValue(prefs::kHomePage, &actual));
+  EXPECT_TRUE(actual->GetAsString(&string_value));
+  EXPECT_EQ("http://www.cnn.com", string_value);
+  EXPECT_EQ(PrefStore::READ_NO_VALUE,
+            pref_store2->GetValue("tabs.max_tabs", NULL));
+
+  // ...and compacts the journal into the main file.
+  message_loop_.RunAllPending();
+  EXPECT_TRUE(file_util::PathExists(pref_file));
+  EXPECT_FALSE(file_util::PathExists(journal_file));
+}
+
+// A full rewrite of the preferences file also refreshes the binary snapshot
+// beside it, and the next read is served from the snapshot as long as its
+// hash still matches the JSON text.
+TEST_F(JsonPrefStoreTest, Snapshot) {
+  FilePath pref_file = temp_dir_.path().AppendASCII("write.json");
+  FilePath snapshot_file = temp_dir_.path().AppendASCII("write.json.snapshot");
+
+  {
+    scoped_refptr<JsonPrefStore> pref_store =
+        new JsonPrefStore(pref_file, message_loop_proxy_.get());
+    EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NO_FILE,
+              pref_store->ReadPrefs());
+    pref_store->SetValue(prefs::kHomePage,
+                         Value::CreateStringValue("http://www.cnn.com"));
+    pref_store->CommitPendingWrite();
+    message_loop_.RunAllPending();
+  }
+  EXPECT_TRUE(file_util::PathExists(pref_file));
+  EXPECT_TRUE(file_util::PathExists(snapshot_file));
+
+  // Prove the snapshot is what gets deserialized: hand it a tree that
+  // disagrees with the JSON but carries the JSON's hash.
+  std::string contents;
+  ASSERT_TRUE(file_util::ReadFileToString(pref_file, &contents));
+  Pickle pickle;
+  pickle.WriteInt(1);  // kSnapshotVersion
+  pickle.WriteString(base::MD5String(contents));
+  pickle.WriteInt(Value::TYPE_DICTIONARY);
+  pickle.WriteInt(1);
+  pickle.WriteString(prefs::kHomePage);
+  pickle.WriteInt(Value::TYPE_STRING);
+  pickle.WriteString("http://www.snapshot.com");
+  file_util::WriteFile(snapshot_file,
+                       static_cast<const char*>(pickle.data()),
+                       pickle.size());
+
+  scoped_refptr<JsonPrefStore> pref_store2 =
+      new JsonPrefStore(pref_file, message_loop_proxy_.get());
+  EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            pref_store2->ReadPrefs());
+  const Value* actual;
+  std::string string_value;
+  EXPECT_EQ(PrefStore::READ_OK,
+            pref_store2->GetValue(prefs::kHomePage, &actual));
+  EXPECT_TRUE(actual->GetAsString(&string_value));
+  EXPECT_EQ("http://www.snapshot.com", string_value);
+}
+
+// A snapshot written against an older version of the JSON must be ignored.
+TEST_F(JsonPrefStoreTest, StaleSnapshotIgnored) {
+  FilePath pref_file = temp_dir_.path().AppendASCII("write.json");
+  FilePath snapshot_file = temp_dir_.path().AppendASCII("write.json.snapshot");
+
+  {
+    scoped_refptr<JsonPrefStore> pref_store =
+        new JsonPrefStore(pref_file, message_loop_proxy_.get());
+    EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NO_FILE,
+              pref_store->ReadPrefs());
+    pref_store->SetValue(prefs::kHomePage,
+                         Value::CreateStringValue("http://www.cnn.com"));
+    pref_store->CommitPendingWrite();
+    message_loop_.RunAllPending();
+  }
+  EXPECT_TRUE(file_util::PathExists(snapshot_file));
+
+  // Rewrite the preferences file behind the store's back (e.g. by another
+  // program or an older Chrome); the snapshot's hash no longer matches.
+  std::string new_json = "{\"homepage\": \"http://www.example.com\"}";
+  file_util::WriteFile(pref_file, new_json.data(), new_json.size());
+
+  scoped_refptr<JsonPrefStore> pref_store2 =
+      new JsonPrefStore(pref_file, message_loop_proxy_.get());
+  EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            pref_store2->ReadPrefs());
+  const Value* actual;
+  std::string string_value;
+  EXPECT_EQ(PrefStore::READ_OK,
+            pref_store2->GetValue(prefs::kHomePage, &actual));
+  EXPECT_TRUE(actual->GetAsString(&string_value));
+  EXPECT_EQ("http://www.example.com", string_value);
+}
+
 TEST_F(JsonPrefStoreTest, NeedsEmptyValue) {
   FilePath pref_file = temp_dir_.path().AppendASCII("write.json");
 
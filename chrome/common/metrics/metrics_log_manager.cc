@@ -51,15 +51,26 @@ void MetricsLogManager::BeginLoggingWithLog(MetricsLogBase* log,
 }
 
 void MetricsLogManager::FinishCurrentLog() {
+  LogType log_type = NO_LOG;
+  scoped_ptr<MetricsLogBase> log(ReleaseCurrentLog(&log_type));
+  SerializedLog compressed_log;
+  SerializeAndCompressLog(log.get(), &compressed_log);
+  StoreSerializedLog(&compressed_log, log_type);
+}
+
+MetricsLogBase* MetricsLogManager::ReleaseCurrentLog(LogType* log_type) {
   DCHECK(current_log_.get());
   DCHECK(current_log_type_ != NO_LOG);
   current_log_->CloseLog();
-  SerializedLog compressed_log;
-  CompressCurrentLog(&compressed_log);
-  if (!compressed_log.empty())
-    StoreLog(&compressed_log, current_log_type_, NORMAL_STORE);
-  current_log_.reset();
+  *log_type = current_log_type_;
   current_log_type_ = NO_LOG;
+  return current_log_.release();
+}
+
+void MetricsLogManager::StoreSerializedLog(SerializedLog* serialized,
+                                           LogType log_type) {
+  if (!serialized->empty())
+    StoreLog(serialized, log_type, NORMAL_STORE);
 }
 
 void MetricsLogManager::StageNextLogForUpload() {
@@ -200,21 +211,22 @@ void MetricsLogManager::LoadPersistedUnsentLogs() {
   log_serializer_->DeserializeLogs(ONGOING_LOG, &unsent_ongoing_logs_);
 }
 
-void MetricsLogManager::CompressCurrentLog(SerializedLog* compressed_log) {
-  int text_size = current_log_->GetEncodedLogSizeXml();
+// static
+void MetricsLogManager::SerializeAndCompressLog(MetricsLogBase* log,
+                                                SerializedLog* serialized) {
+  int text_size = log->GetEncodedLogSizeXml();
   DCHECK_GT(text_size, 0);
   std::string log_text;
-  current_log_->GetEncodedLogXml(WriteInto(&log_text, text_size + 1),
-                                 text_size);
+  log->GetEncodedLogXml(WriteInto(&log_text, text_size + 1), text_size);
 
-  bool success = Bzip2Compress(log_text, &(compressed_log->xml));
+  bool success = Bzip2Compress(log_text, &(serialized->xml));
   if (success) {
     // Allow security-conscious users to see all metrics logs that we send.
     DVLOG(1) << "METRICS LOG: " << log_text;
 
     // Note that we only save the protobuf version if we succeeded in
     // compressing the XML, so that the two data streams are the same.
-    current_log_->GetEncodedLogProto(&(compressed_log->proto));
+    log->GetEncodedLogProto(&(serialized->proto));
   } else {
     NOTREACHED() << "Failed to compress log for transmission.";
   }
@@ -56,6 +56,23 @@ class MetricsLogManager {
   // later, leaving current_log() NULL.
   void FinishCurrentLog();
 
+  // Closes and detaches the current log, leaving current_log() NULL. The
+  // caller takes ownership of the returned log; its type is returned through
+  // |log_type|. Together with SerializeAndCompressLog() and
+  // StoreSerializedLog() this allows the expensive part of
+  // FinishCurrentLog() to run on a background thread.
+  MetricsLogBase* ReleaseCurrentLog(LogType* log_type);
+
+  // Serializes the closed |log| and compresses the result into |serialized|.
+  // Touches no state on any manager, so it may be called on any thread as
+  // long as the caller owns |log|.
+  static void SerializeAndCompressLog(MetricsLogBase* log,
+                                      SerializedLog* serialized);
+
+  // Stores a log produced by SerializeAndCompressLog() as an unsent log of
+  // type |log_type|. Logs left empty by a failed compression are dropped.
+  void StoreSerializedLog(SerializedLog* serialized, LogType log_type);
+
   // Returns true if there are any logs waiting to be uploaded.
   bool has_unsent_logs() const {
     return !unsent_initial_logs_.empty() || !unsent_ongoing_logs_.empty();
@@ -162,9 +179,6 @@ class MetricsLogManager {
                 LogType log_type,
                 StoreType store_type);
 
-  // Compresses current_log_ into compressed_log.
-  void CompressCurrentLog(SerializedLog* compressed_log);
-
   // Compresses the text in |input| using bzip2, store the result in |output|.
   static bool Bzip2Compress(const std::string& input, std::string* output);
 
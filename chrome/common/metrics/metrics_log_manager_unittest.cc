@@ -6,6 +6,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/memory/scoped_ptr.h"
 #include "chrome/common/metrics/metrics_log_base.h"
 #include "chrome/common/metrics/metrics_log_manager.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -78,6 +79,34 @@ TEST(MetricsLogManagerTest, StandardFlow) {
   EXPECT_FALSE(log_manager.has_unsent_logs());
 }
 
+TEST(MetricsLogManagerTest, ReleaseAndStoreFlow) {
+  MetricsLogManager log_manager;
+
+  // Detaching, serializing and storing a log by hand (as done on a
+  // background thread) must be equivalent to FinishCurrentLog().
+  MetricsLogBase* log = new MetricsLogBase("id", 0, "version");
+  log_manager.BeginLoggingWithLog(log, MetricsLogManager::ONGOING_LOG);
+
+  MetricsLogManager::LogType log_type = MetricsLogManager::NO_LOG;
+  scoped_ptr<MetricsLogBase> released(
+      log_manager.ReleaseCurrentLog(&log_type));
+  EXPECT_EQ(log, released.get());
+  EXPECT_EQ(MetricsLogManager::ONGOING_LOG, log_type);
+  EXPECT_EQ(NULL, log_manager.current_log());
+  EXPECT_FALSE(log_manager.has_unsent_logs());
+
+  SerializedLog serialized;
+  MetricsLogManager::SerializeAndCompressLog(released.get(), &serialized);
+  EXPECT_FALSE(serialized.empty());
+
+  log_manager.StoreSerializedLog(&serialized, log_type);
+  EXPECT_TRUE(log_manager.has_unsent_logs());
+
+  log_manager.StageNextLogForUpload();
+  EXPECT_TRUE(log_manager.has_staged_log());
+  EXPECT_FALSE(log_manager.staged_log_text().empty());
+}
+
 TEST(MetricsLogManagerTest, AbandonedLog) {
   MetricsLogManager log_manager;
 
@@ -383,6 +383,11 @@ const char kDnsHostReferralList[] = "HostReferralList";
 const char kDnsPrefetchingHostReferralList[] =
     "dns_prefetching.host_referral_list";
 
+// A snapshot of the unexpired host resolver cache entries from the previous
+// session, used to serve DNS results for the first navigations of the next
+// startup while their TTLs are still valid.
+const char kDnsHostCacheSnapshot[] = "dns_prefetching.host_cache_snapshot";
+
 // Disables the SPDY protocol.
 const char kDisableSpdy[] = "spdy.disabled";
 
@@ -262,6 +262,9 @@ IPC_MESSAGE_CONTROL1(ChromeViewMsg_WriteTcmallocHeapProfile,
 // Asks the renderer to send back V8 heap stats.
 IPC_MESSAGE_CONTROL0(ChromeViewMsg_GetV8HeapStats)
 
+// Asks the renderer to send back its sampled heap call-site report.
+IPC_MESSAGE_CONTROL0(ChromeViewMsg_GetHeapSample)
+
 // Posts a message to the renderer.
 IPC_MESSAGE_ROUTED3(ChromeViewMsg_HandleMessageFromExternalHost,
                     std::string /* The message */,
@@ -518,6 +521,11 @@ IPC_MESSAGE_CONTROL2(ChromeViewHostMsg_V8HeapStats,
                      int /* size of heap (allocated from the OS) */,
                      int /* bytes in use */)
 
+// Sends back the sampled heap call-site report, one
+// "<address> <allocs> <bytes>" line per call site.
+IPC_MESSAGE_CONTROL1(ChromeViewHostMsg_HeapSample,
+                     std::string /* report */)
+
 // Request for a DNS prefetch of the names in the array.
 // NameList is typedef'ed std::vector<std::string>
 IPC_MESSAGE_CONTROL1(ChromeViewHostMsg_DnsPrefetch,
@@ -15,7 +15,9 @@ const VisitedLinkCommon::Hash VisitedLinkCommon::null_hash_ = -1;
 
 VisitedLinkCommon::VisitedLinkCommon()
     : hash_table_(NULL),
-      table_length_(0) {
+      table_length_(0),
+      live_header_(NULL),
+      live_generation_(0) {
   memset(salt_, 0, sizeof(salt_));
 }
 
@@ -38,6 +40,8 @@ bool VisitedLinkCommon::IsVisited(const GURL& url) const {
 }
 
 bool VisitedLinkCommon::IsVisited(Fingerprint fingerprint) const {
+  SyncWithLiveHeader();
+
   // Go through the table until we find the item or an empty spot (meaning it
   // wasn't found). This loop will terminate as long as the table isn't full,
   // which should be enforced by AddFingerprint.
@@ -64,6 +68,24 @@ bool VisitedLinkCommon::IsVisited(Fingerprint fingerprint) const {
   }
 }
 
+void VisitedLinkCommon::SyncWithLiveHeader() const {
+  if (!live_header_)
+    return;
+
+  base::subtle::Atomic32 generation =
+      base::subtle::Acquire_Load(&live_header_->generation);
+  if (generation == live_generation_)
+    return;
+
+  // The master zeroes the new slots and migrates the entries before it
+  // publishes the new length, so reading the length after acquiring the
+  // generation is safe. A lookup racing the migration itself can transiently
+  // miss a link, which is the same window deletions already have (see
+  // VisitedLinkMaster::DeleteFingerprint).
+  table_length_ = static_cast<int32>(live_header_->length);
+  live_generation_ = generation;
+}
+
 // Uses the top 64 bits of the MD5 sum of the canonical URL as the fingerprint,
 // this is as random as any other subset of the MD5SUM.
 //
@@ -8,6 +8,7 @@
 
 #include <vector>
 
+#include "base/atomicops.h"
 #include "base/basictypes.h"
 
 class GURL;
@@ -19,8 +20,12 @@ class GURL;
 // should be exactly one process that has write access (implemented by
 // VisitedLinkMaster), while all other processes should be read-only
 // (implemented by VisitedLinkSlave). These other processes add links by calling
-// the writer process to add them for it. The writer may also notify the readers
-// to replace their table when the table is resized.
+// the writer process to add them for it. The shared memory segment is
+// allocated with headroom beyond the current table size, so the writer can
+// usually grow the table in place and publish the new length through the
+// header; readers follow along without being sent a new handle. Only when a
+// resize exceeds the reserved capacity does the writer notify the readers to
+// replace their table.
 //
 // IPC is not implemented in these classes. This is done through callback
 // functions supplied by the creator of these objects to allow more flexibility,
@@ -74,6 +79,7 @@ class VisitedLinkCommon {
   // Returns statistics about DB usage
   void GetUsageStatistics(int32* table_size,
                           VisitedLinkCommon::Fingerprint** fingerprints) {
+    SyncWithLiveHeader();
     *table_size = table_length_;
     *fingerprints = hash_table_;
   }
@@ -88,6 +94,16 @@ class VisitedLinkCommon {
 
     // goes into salt_
     uint8 salt[LINK_SALT_LENGTH];
+
+    // The number of entries the shared memory segment was allocated for. The
+    // master may grow |length| up to this value in place, without replacing
+    // the segment.
+    uint32 capacity;
+
+    // Incremented by the master after it publishes a new |length|. Readers
+    // compare this against the last value they synchronized with to know
+    // when to re-read |length|; see SyncWithLiveHeader().
+    base::subtle::Atomic32 generation;
   };
 
   // Returns the fingerprint at the given index into the URL table. This
@@ -119,11 +135,26 @@ class VisitedLinkCommon {
     return HashFingerprint(fingerprint, table_length_);
   }
 
+  // Picks up a table length grown in place by the master. Called at the
+  // start of lookups on the slave side; no-op when |live_header_| is NULL.
+  // Const because lookups are const; the fields it refreshes are mutable.
+  void SyncWithLiveHeader() const;
+
   // pointer to the first item
   VisitedLinkCommon::Fingerprint* hash_table_;
 
-  // the number of items in the hash table
-  int32 table_length_;
+  // the number of items in the hash table. Mutable so that slave-side
+  // lookups can refresh it from the shared header when the master grows the
+  // table in place (see SyncWithLiveHeader()).
+  mutable int32 table_length_;
+
+  // When non-NULL, points to the header of the mapped table. The slave sets
+  // this so that lookups can follow in-place growth published by the master.
+  // The master leaves it NULL since it updates |table_length_| directly.
+  const SharedHeader* live_header_;
+
+  // The value of |live_header_->generation| that |table_length_| reflects.
+  mutable base::subtle::Atomic32 live_generation_;
 
   // salt used for each URL when computing the fingerprint
   uint8 salt_[LINK_SALT_LENGTH];
@@ -4,11 +4,18 @@
 
 #include "chrome/common/zip.h"
 
+#include <algorithm>
+#include <queue>
+
 #include "base/bind.h"
 #include "base/file_util.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
 #include "base/string16.h"
 #include "base/string_util.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/sys_info.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "chrome/common/zip_internal.h"
 #include "chrome/common/zip_reader.h"
 #include "net/base/file_stream.h"
@@ -17,6 +24,25 @@
 
 namespace {
 
+// Entries whose compressed or uncompressed size reaches this no longer fit
+// the classic 32-bit local header fields and need ZIP64 records.
+const int64 kZip64Threshold = 0xffffffffLL;
+
+// How many compressed entries ZipInParallel lets sit in memory ahead of the
+// writer, per worker. Bounds peak memory while keeping the workers busy.
+const size_t kEntriesInFlightPerWorker = 2;
+
+// The name an entry gets inside the zip: |path| relative to |root_path|,
+// with forward slashes.
+std::string GetZipEntryName(const FilePath& path, const FilePath& root_path) {
+  std::string str_path =
+      path.AsUTF8Unsafe().substr(root_path.value().length() + 1);
+#if defined(OS_WIN)
+  ReplaceSubstringsAfterOffset(&str_path, 0u, "\\", "/");
+#endif
+  return str_path;
+}
+
 bool AddFileToZip(zipFile zip_file, const FilePath& src_dir) {
   net::FileStream stream(NULL);
   int flags = base::PLATFORM_FILE_OPEN | base::PLATFORM_FILE_READ;
@@ -44,21 +70,23 @@ bool AddFileToZip(zipFile zip_file, const FilePath& src_dir) {
 
 bool AddEntryToZip(zipFile zip_file, const FilePath& path,
                    const FilePath& root_path) {
-  std::string str_path =
-      path.AsUTF8Unsafe().substr(root_path.value().length() + 1);
-#if defined(OS_WIN)
-  ReplaceSubstringsAfterOffset(&str_path, 0u, "\\", "/");
-#endif
+  std::string str_path = GetZipEntryName(path, root_path);
 
   bool is_directory = file_util::DirectoryExists(path);
   if (is_directory)
     str_path += "/";
 
-  if (ZIP_OK != zipOpenNewFileInZip(
+  // Files too large for the classic 32-bit header fields get ZIP64 records.
+  int64 file_size = 0;
+  int zip64 = !is_directory &&
+      file_util::GetFileSize(path, &file_size) &&
+      file_size >= kZip64Threshold;
+
+  if (ZIP_OK != zipOpenNewFileInZip64(
       zip_file, str_path.c_str(),
       NULL, NULL, 0u, NULL, 0u, NULL,  // file info, extrafield local, length,
                                        // extrafield global, length, comment
-      Z_DEFLATED, Z_DEFAULT_COMPRESSION)) {
+      Z_DEFLATED, Z_DEFAULT_COMPRESSION, zip64)) {
     DLOG(ERROR) << "Could not open zip file entry " << str_path;
     return false;
   }
@@ -76,6 +104,158 @@ bool AddEntryToZip(zipFile zip_file, const FilePath& path,
   return success;
 }
 
+// One file entry being deflate-compressed ahead of the writer in
+// ZipInParallel. Refcounted because both the writer and the worker task that
+// fills it in hold a reference.
+struct PendingEntry : public base::RefCountedThreadSafe<PendingEntry> {
+  PendingEntry(const FilePath& path,
+               const std::string& name_in_zip,
+               bool is_directory)
+      : path(path),
+        name_in_zip(name_in_zip),
+        is_directory(is_directory),
+        success(is_directory),  // Directories carry no data to compress.
+        crc(crc32(0L, Z_NULL, 0u)),
+        uncompressed_size(0),
+        done(true /* manual reset */, is_directory /* initially signaled */) {}
+
+  const FilePath path;
+  const std::string name_in_zip;
+  const bool is_directory;
+
+  // The fields below are written by the worker task before |done| is
+  // signaled and read by the writer only after waiting on it.
+  bool success;
+  uLong crc;
+  int64 uncompressed_size;
+  std::string compressed_data;  // Raw deflate stream, no zlib wrapper.
+
+  base::WaitableEvent done;
+
+ private:
+  friend class base::RefCountedThreadSafe<PendingEntry>;
+  ~PendingEntry() {}
+
+  DISALLOW_COPY_AND_ASSIGN(PendingEntry);
+};
+
+// Reads |entry->path| and deflate-compresses it into
+// |entry->compressed_data|, then signals |entry->done|. Runs on a worker
+// pool thread.
+void CompressEntry(scoped_refptr<PendingEntry> entry) {
+  bool success = false;
+
+  net::FileStream stream(NULL);
+  int flags = base::PLATFORM_FILE_OPEN | base::PLATFORM_FILE_READ;
+  if (stream.OpenSync(entry->path, flags) != 0) {
+    DLOG(ERROR) << "Could not open stream for path "
+                << entry->path.value();
+  } else {
+    z_stream zlib_stream;
+    memset(&zlib_stream, 0, sizeof(zlib_stream));
+    // Negative window bits select a raw deflate stream, which is what a zip
+    // entry stores.
+    if (Z_OK != deflateInit2(&zlib_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                             -MAX_WBITS, 8, Z_DEFAULT_STRATEGY)) {
+      DLOG(ERROR) << "Could not initialize deflate for path "
+                  << entry->path.value();
+    } else {
+      success = true;
+      char in_buf[zip::internal::kZipBufSize];
+      char out_buf[zip::internal::kZipBufSize];
+      int flush = Z_NO_FLUSH;
+      do {
+        int num_bytes = stream.ReadSync(in_buf, zip::internal::kZipBufSize);
+        if (num_bytes < 0) {
+          DLOG(ERROR) << "Could not read data for path "
+                      << entry->path.value();
+          success = false;
+          break;
+        }
+        if (num_bytes == 0)
+          flush = Z_FINISH;
+        entry->crc = crc32(entry->crc,
+                           reinterpret_cast<Bytef*>(in_buf), num_bytes);
+        entry->uncompressed_size += num_bytes;
+        zlib_stream.next_in = reinterpret_cast<Bytef*>(in_buf);
+        zlib_stream.avail_in = num_bytes;
+        do {
+          zlib_stream.next_out = reinterpret_cast<Bytef*>(out_buf);
+          zlib_stream.avail_out = sizeof(out_buf);
+          if (Z_STREAM_ERROR == deflate(&zlib_stream, flush)) {
+            DLOG(ERROR) << "Could not compress data for path "
+                        << entry->path.value();
+            success = false;
+            break;
+          }
+          entry->compressed_data.append(
+              out_buf, sizeof(out_buf) - zlib_stream.avail_out);
+        } while (zlib_stream.avail_out == 0);
+      } while (success && flush != Z_FINISH);
+      deflateEnd(&zlib_stream);
+    }
+  }
+
+  entry->success = success;
+  entry->done.Signal();
+}
+
+// Writes one entry to |zip_file|, blocking until its compression task has
+// finished. The writer emits entries in enumeration order, so the resulting
+// archive has the same layout as the sequential path's.
+bool WriteEntryToZip(zipFile zip_file, PendingEntry* entry) {
+  entry->done.Wait();
+  if (!entry->success)
+    return false;
+
+  if (entry->is_directory) {
+    if (ZIP_OK != zipOpenNewFileInZip(
+        zip_file, entry->name_in_zip.c_str(),
+        NULL, NULL, 0u, NULL, 0u, NULL,
+        Z_DEFLATED, Z_DEFAULT_COMPRESSION) ||
+        ZIP_OK != zipCloseFileInZip(zip_file)) {
+      DLOG(ERROR) << "Could not write zip file entry "
+                  << entry->name_in_zip;
+      return false;
+    }
+    return true;
+  }
+
+  const std::string& data = entry->compressed_data;
+  int zip64 = entry->uncompressed_size >= kZip64Threshold ||
+      data.size() >= static_cast<size_t>(kZip64Threshold);
+  if (ZIP_OK != zipOpenNewFileInZip2_64(
+      zip_file, entry->name_in_zip.c_str(),
+      NULL, NULL, 0u, NULL, 0u, NULL,
+      Z_DEFLATED, Z_DEFAULT_COMPRESSION,
+      1,  // raw: the data is already a deflate stream.
+      zip64)) {
+    DLOG(ERROR) << "Could not open zip file entry " << entry->name_in_zip;
+    return false;
+  }
+
+  for (size_t offset = 0; offset < data.size();) {
+    size_t num_bytes = std::min(
+        data.size() - offset,
+        static_cast<size_t>(zip::internal::kZipBufSize));
+    if (ZIP_OK != zipWriteInFileInZip(zip_file, data.data() + offset,
+                                      num_bytes)) {
+      DLOG(ERROR) << "Could not write data to zip for entry "
+                  << entry->name_in_zip;
+      return false;
+    }
+    offset += num_bytes;
+  }
+
+  // In raw mode the sizes and checksum come from us, not the writer.
+  if (ZIP_OK != zipCloseFileInZipRaw64(zip_file, entry->uncompressed_size,
+                                       entry->crc)) {
+    DLOG(ERROR) << "Could not close zip file entry " << entry->name_in_zip;
+    return false;
+  }
+  return true;
+}
+
 bool ExcludeNoFilesFilter(const FilePath& file_path) {
   return true;
 }
@@ -166,4 +346,76 @@ bool Zip(const FilePath& src_dir, const FilePath& dest_file,
   }
 }
 
+bool ZipInParallel(const FilePath& src_dir, const FilePath& dest_file,
+                   bool include_hidden_files) {
+  DCHECK(file_util::DirectoryExists(src_dir));
+
+  zipFile zip_file = internal::OpenForZipping(dest_file.AsUTF8Unsafe(),
+                                              APPEND_STATUS_CREATE);
+  if (!zip_file) {
+    DLOG(WARNING) << "couldn't create file " << dest_file.value();
+    return false;
+  }
+
+  size_t num_workers = std::max(1, base::SysInfo::NumberOfProcessors());
+  scoped_refptr<base::SequencedWorkerPool> pool(
+      new base::SequencedWorkerPool(num_workers, "ZipWorker"));
+
+  // The enumerating thread doubles as the writer: it posts a compression
+  // task per file and streams finished entries out in enumeration order,
+  // stalling when too many compressed entries are waiting in memory.
+  const size_t max_in_flight = num_workers * kEntriesInFlightPerWorker;
+  std::queue<scoped_refptr<PendingEntry> > in_flight;
+
+  bool success = true;
+  file_util::FileEnumerator file_enumerator(
+      src_dir, true,  // recursive
+      static_cast<file_util::FileEnumerator::FileType>(
+          file_util::FileEnumerator::FILES |
+          file_util::FileEnumerator::DIRECTORIES));
+  for (FilePath path = file_enumerator.Next(); !path.value().empty();
+       path = file_enumerator.Next()) {
+    if (!include_hidden_files && !ExcludeHiddenFilesFilter(path))
+      continue;
+
+    bool is_directory = file_util::DirectoryExists(path);
+    std::string name_in_zip = GetZipEntryName(path, src_dir);
+    if (is_directory)
+      name_in_zip += "/";
+
+    scoped_refptr<PendingEntry> entry(
+        new PendingEntry(path, name_in_zip, is_directory));
+    if (!is_directory) {
+      pool->PostWorkerTaskWithShutdownBehavior(
+          FROM_HERE,
+          base::Bind(&CompressEntry, entry),
+          base::SequencedWorkerPool::CONTINUE_ON_SHUTDOWN);
+    }
+    in_flight.push(entry);
+
+    if (in_flight.size() >= max_in_flight) {
+      success = WriteEntryToZip(zip_file, in_flight.front());
+      in_flight.pop();
+      if (!success)
+        break;
+    }
+  }
+
+  while (success && !in_flight.empty()) {
+    success = WriteEntryToZip(zip_file, in_flight.front());
+    in_flight.pop();
+  }
+  // On failure any remaining tasks keep their entries alive through their
+  // own references; no need to wait for them.
+  in_flight = std::queue<scoped_refptr<PendingEntry> >();
+  pool->Shutdown();
+
+  if (ZIP_OK != zipClose(zip_file, NULL)) {  // global comment
+    DLOG(ERROR) << "Error closing zip file " << dest_file.value();
+    return false;
+  }
+
+  return success;
+}
+
 }  // namespace zip
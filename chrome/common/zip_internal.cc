@@ -65,6 +65,12 @@ void* ZipOpenFunc(void *opaque, const char* filename, int mode) {
   }
   return ret;
 }
+
+// 64-bit variant of ZipOpenFunc. The 64-bit ioapi passes the filename
+// through as const void*.
+void* ZipOpenFunc64(void* opaque, const void* filename, int mode) {
+  return ZipOpenFunc(opaque, static_cast<const char*>(filename), mode);
+}
 #endif
 
 #if defined(OS_POSIX)
@@ -132,17 +138,19 @@ unzFile OpenFdForUnzipping(int zip_fd) {
 #endif
 
 zipFile OpenForZipping(const std::string& file_name_utf8, int append_flag) {
-  zlib_filefunc_def* zip_func_ptrs = NULL;
+  zlib_filefunc64_def* zip_func_ptrs = NULL;
 #if defined(OS_WIN)
-  zlib_filefunc_def zip_funcs;
-  fill_win32_filefunc(&zip_funcs);
-  zip_funcs.zopen_file = ZipOpenFunc;
+  zlib_filefunc64_def zip_funcs;
+  fill_win32_filefunc64(&zip_funcs);
+  zip_funcs.zopen64_file = ZipOpenFunc64;
   zip_func_ptrs = &zip_funcs;
 #endif
-  return zipOpen2(file_name_utf8.c_str(),
-                  append_flag,
-                  NULL,  // global comment
-                  zip_func_ptrs);
+  // The 64-bit open gives the writer 64-bit file offsets, which ZIP64
+  // archives need once they grow past 4GB.
+  return zipOpen2_64(file_name_utf8.c_str(),
+                     append_flag,
+                     NULL,  // global comment
+                     zip_func_ptrs);
 }
 
 }  // namespace internal
@@ -26,7 +26,7 @@ unzFile OpenFdForUnzipping(int zip_fd);
 #endif
 
 // Opens the given file name in UTF-8 for zipping, with some setup for
-// Windows. |append_flag| will be passed to zipOpen2().
+// Windows. |append_flag| will be passed to zipOpen2_64().
 zipFile OpenForZipping(const std::string& file_name_utf8, int append_flag);
 
 const int kZipMaxPath = 256;
@@ -138,6 +138,19 @@ TEST_F(ZipTest, Zip) {
   TestUnzipFile(zip_file, true);
 }
 
+TEST_F(ZipTest, ZipInParallel) {
+  FilePath src_dir;
+  ASSERT_TRUE(PathService::Get(chrome::DIR_TEST_DATA, &src_dir));
+  src_dir = src_dir.AppendASCII("zip").AppendASCII("test");
+
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  FilePath zip_file = temp_dir.path().AppendASCII("out.zip");
+
+  EXPECT_TRUE(zip::ZipInParallel(src_dir, zip_file, true));
+  TestUnzipFile(zip_file, true);
+}
+
 TEST_F(ZipTest, ZipIgnoreHidden) {
   FilePath src_dir;
   ASSERT_TRUE(PathService::Get(chrome::DIR_TEST_DATA, &src_dir));
@@ -5,6 +5,7 @@
 #include "chrome/renderer/chrome_render_process_observer.h"
 
 #include "base/allocator/allocator_extension.h"
+#include "base/allocator/sampled_heap_profiler.h"
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/file_util.h"
@@ -220,6 +221,7 @@ bool ChromeRenderProcessObserver::OnControlMessageReceived(
                         OnWriteTcmallocHeapProfile)
 #endif
     IPC_MESSAGE_HANDLER(ChromeViewMsg_GetV8HeapStats, OnGetV8HeapStats)
+    IPC_MESSAGE_HANDLER(ChromeViewMsg_GetHeapSample, OnGetHeapSample)
     IPC_MESSAGE_HANDLER(ChromeViewMsg_GetCacheResourceStats,
                         OnGetCacheResourceStats)
     IPC_MESSAGE_HANDLER(ChromeViewMsg_PurgeMemory, OnPurgeMemory)
@@ -309,6 +311,11 @@ void ChromeRenderProcessObserver::OnGetV8HeapStats() {
       heap_stats.total_heap_size(), heap_stats.used_heap_size()));
 }
 
+void ChromeRenderProcessObserver::OnGetHeapSample() {
+  RenderThread::Get()->Send(new ChromeViewHostMsg_HeapSample(
+      base::allocator::SampledHeapProfiler::GetReport()));
+}
+
 void ChromeRenderProcessObserver::OnPurgeMemory() {
   RenderThread::Get()->EnsureWebKitInitialized();
 
@@ -65,6 +65,7 @@ class ChromeRenderProcessObserver : public content::RenderProcessObserver {
   void OnSetTcmallocHeapProfiling(bool profiling, const std::string& prefix);
   void OnWriteTcmallocHeapProfile(const FilePath::StringType& filename);
   void OnGetV8HeapStats();
+  void OnGetHeapSample();
   void OnPurgeMemory();
 
   static bool is_incognito_process_;
@@ -25,6 +25,14 @@ using WebKit::WebVector;
 using WebKit::WebTextCheckingResult;
 using WebKit::WebTextCheckingType;
 
+namespace {
+
+// The number of entries kept in |word_cache_|. Large enough to cover the
+// words WebKit re-checks while the user types into a sizable text area.
+const size_t kMaxCachedWords = 1024;
+
+}  // namespace
+
 namespace spellcheck {
 void ToWebResultList(
     int offset,
@@ -93,7 +101,8 @@ SpellCheck::SpellCheck()
       auto_spell_correct_turned_on_(false),
       is_using_platform_spelling_engine_(false),
       initialized_(false),
-      dictionary_requested_(false) {
+      dictionary_requested_(false),
+      word_cache_(kMaxCachedWords) {
   // Wait till we check the first word before doing any initializing.
 }
 
@@ -152,6 +161,9 @@ void SpellCheck::Init(base::PlatformFile file,
 
   character_attributes_.SetDefaultLanguage(language);
 
+  // Cached verdicts came from the previous dictionary.
+  word_cache_.Clear();
+
   custom_words_.insert(custom_words_.end(),
                        custom_words.begin(), custom_words.end());
 
@@ -373,6 +385,9 @@ void SpellCheck::InitializeHunspell() {
 void SpellCheck::AddWordToHunspell(const std::string& word) {
   if (!word.empty() && word.length() < MAXWORDUTF8LEN)
     hunspell_->add(word.c_str());
+
+  // The word may have been cached as misspelled before it was added.
+  word_cache_.Clear();
 }
 
 bool SpellCheck::InitializeIfNeeded() {
@@ -405,6 +420,10 @@ bool SpellCheck::CheckSpelling(const string16& word_to_check, int tag) {
         word_to_check, tag, &word_correct));
 #endif
   } else {
+    WordCache::iterator cached = word_cache_.Get(word_to_check);
+    if (cached != word_cache_.end())
+      return cached->second;
+
     std::string word_to_check_utf8(UTF16ToUTF8(word_to_check));
     // Hunspell shouldn't let us exceed its max, but check just in case
     if (word_to_check_utf8.length() < MAXWORDUTF8LEN) {
@@ -412,6 +431,7 @@ bool SpellCheck::CheckSpelling(const string16& word_to_check, int tag) {
         // |hunspell_->spell| returns 0 if the word is spelled correctly and
         // non-zero otherwsie.
         word_correct = (hunspell_->spell(word_to_check_utf8.c_str()) != 0);
+        word_cache_.Put(word_to_check, word_correct);
       } else {
         // If |hunspell_| is NULL here, an error has occurred, but it's better
         // to check rather than crash.
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "base/gtest_prod_util.h"
+#include "base/memory/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -107,9 +108,12 @@ class SpellCheck : public content::RenderProcessObserver,
   FRIEND_TEST_ALL_PREFIXES(SpellCheckTest, GetAutoCorrectionWord_EN_US);
   FRIEND_TEST_ALL_PREFIXES(SpellCheckTest,
       RequestSpellCheckMultipleTimesWithoutInitialization);
+  FRIEND_TEST_ALL_PREFIXES(SpellCheckTest, SpellingCacheUpdatedOnWordAdded);
 
   class SpellCheckRequestParam;
 
+  typedef base::HashingMRUCache<string16, bool> WordCache;
+
   // RenderProcessObserver implementation:
   virtual bool OnControlMessageReceived(const IPC::Message& message) OVERRIDE;
 
@@ -192,6 +196,14 @@ class SpellCheck : public content::RenderProcessObserver,
   // This flags is true if we have requested dictionary.
   bool dictionary_requested_;
 
+  // Caches the hunspell verdict for recently checked words. WebKit re-checks
+  // the text around the caret on every edit, so most of the words it hands us
+  // have not changed since the last call and their lookups can be answered
+  // from here without touching hunspell. The cache is not consulted when the
+  // platform spelling engine is in use because its results can depend on the
+  // document tag.
+  WordCache word_cache_;
+
   // The parameters of a pending background-spellchecking request. When WebKit
   // sends a background-spellchecking request before initializing hunspell,
   // we save its parameters and start spellchecking after we finish initializing
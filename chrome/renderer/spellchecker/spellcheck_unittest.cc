@@ -971,4 +971,33 @@ TEST_F(SpellCheckTest, RequestSpellCheckMultipleTimesWithoutInitialization) {
     EXPECT_EQ(completion[i].completion_count_, 1U);
 }
 
+// Checks that a word reported as misspelled (and therefore cached as such)
+// is accepted once the user adds it to the dictionary.
+TEST_F(SpellCheckTest, SpellingCacheUpdatedOnWordAdded) {
+  const string16 word(ASCIIToUTF16("ifmmp"));
+  int misspelling_start = 0;
+  int misspelling_length = 0;
+
+  EXPECT_FALSE(spell_check()->SpellCheckWord(word.c_str(),
+                                             static_cast<int>(word.length()),
+                                             0,
+                                             &misspelling_start,
+                                             &misspelling_length, NULL));
+
+  // The second check is answered from the cache and must agree.
+  EXPECT_FALSE(spell_check()->SpellCheckWord(word.c_str(),
+                                             static_cast<int>(word.length()),
+                                             0,
+                                             &misspelling_start,
+                                             &misspelling_length, NULL));
+
+  spell_check()->OnWordAdded("ifmmp");
+
+  EXPECT_TRUE(spell_check()->SpellCheckWord(word.c_str(),
+                                            static_cast<int>(word.length()),
+                                            0,
+                                            &misspelling_start,
+                                            &misspelling_length, NULL));
+}
+
 #endif
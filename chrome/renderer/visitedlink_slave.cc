@@ -51,22 +51,31 @@ void VisitedLinkSlave::OnUpdateVisitedLinks(base::SharedMemoryHandle table) {
   SharedHeader* header =
     static_cast<SharedHeader*>(shared_memory_->memory());
   DCHECK(header);
-  int32 table_len = header->length;
+  int32 table_capacity = header->capacity;
+  DCHECK_LE(header->length, header->capacity);
   memcpy(salt_, header->salt, sizeof(salt_));
   shared_memory_->Unmap();
 
-  // now do the whole table because we know the length
+  // Map the entire reserved capacity, not just the portion currently in use,
+  // so the master can grow the table in place and publish the new length
+  // through the header without sending us a new handle.
   if (!shared_memory_->Map(sizeof(SharedHeader) +
-                          table_len * sizeof(Fingerprint))) {
+                          table_capacity * sizeof(Fingerprint))) {
     shared_memory_->Close();
     return;
   }
 
   // commit the data
   DCHECK(shared_memory_->memory());
+  live_header_ = static_cast<SharedHeader*>(shared_memory_->memory());
   hash_table_ = reinterpret_cast<Fingerprint*>(
       static_cast<char*>(shared_memory_->memory()) + sizeof(SharedHeader));
-  table_length_ = table_len;
+
+  // Read the length after the generation so that if the master grows the
+  // table between the two reads, the stale length is paired with the old
+  // generation and the next lookup re-reads it (see SyncWithLiveHeader()).
+  live_generation_ = base::subtle::Acquire_Load(&live_header_->generation);
+  table_length_ = static_cast<int32>(live_header_->length);
 }
 
 void VisitedLinkSlave::OnAddVisitedLinks(
@@ -84,6 +93,7 @@ void VisitedLinkSlave::FreeTable() {
     delete shared_memory_;
     shared_memory_ = NULL;
   }
+  live_header_ = NULL;
   hash_table_ = NULL;
   table_length_ = 0;
 }
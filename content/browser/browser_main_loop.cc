@@ -408,13 +408,30 @@ void BrowserMainLoop::CreateThreads() {
       webkit_thread_.reset(new WebKitThread);
       webkit_thread_->Initialize();
     } else if (thread_to_start) {
+      // Spawn the thread without waiting for it to come up; the startups are
+      // joined below so that they overlap rather than happening in sequence.
       (*thread_to_start).reset(new BrowserProcessSubThread(id));
-      (*thread_to_start)->StartWithOptions(*options);
+      (*thread_to_start)->StartWithOptionsAsync(*options);
     } else {
       NOTREACHED();
     }
   }
 
+  // Join all the thread startups started above. Nothing may post to these
+  // threads until every one of them is known to be running.
+  scoped_ptr<BrowserProcessSubThread>* started_threads[] = {
+    &db_thread_,
+    &file_user_blocking_thread_,
+    &file_thread_,
+    &process_launcher_thread_,
+    &cache_thread_,
+    &io_thread_,
+  };
+  for (size_t i = 0; i < arraysize(started_threads); ++i) {
+    if (started_threads[i]->get())
+      (*started_threads[i])->WaitUntilThreadStarted();
+  }
+
   BrowserGpuChannelHostFactory::Initialize();
 #if defined(USE_AURA)
   ImageTransportFactory::Initialize();
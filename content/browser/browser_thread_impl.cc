@@ -12,6 +12,7 @@
 #include "base/lazy_instance.h"
 #include "base/message_loop.h"
 #include "base/message_loop_proxy.h"
+#include "base/metrics/histogram.h"
 #include "base/threading/sequenced_worker_pool.h"
 #include "base/threading/thread_restrictions.h"
 #include "content/public/browser/browser_thread_delegate.h"
@@ -32,12 +33,19 @@ static const char* g_browser_thread_names[BrowserThread::ID_COUNT] = {
   "Chrome_IOThread",  // IO
 };
 
+// Tasks that hold a browser thread at least this long are recorded in a
+// separate histogram, so field data can distinguish saturation caused by a
+// few very slow tasks from saturation caused by sheer task volume.
+const int64 kLongTaskThresholdMs = 100;
+
 struct BrowserThreadGlobals {
   BrowserThreadGlobals()
       : blocking_pool(new base::SequencedWorkerPool(3, "BrowserBlocking")) {
     memset(threads, 0, BrowserThread::ID_COUNT * sizeof(threads[0]));
     memset(thread_delegates, 0,
            BrowserThread::ID_COUNT * sizeof(thread_delegates[0]));
+    memset(pending_task_counts, 0,
+           BrowserThread::ID_COUNT * sizeof(pending_task_counts[0]));
   }
 
   // This lock protects |threads|. Do not read or modify that array
@@ -54,14 +62,100 @@ struct BrowserThreadGlobals {
   // by this array, rather by whoever calls BrowserThread::SetDelegate.
   BrowserThreadDelegate* thread_delegates[BrowserThread::ID_COUNT];
 
+  // Only atomic operations are used on this array. Each entry counts the
+  // tasks posted through PostTaskHelper that have not yet started running
+  // on the corresponding thread.
+  base::subtle::Atomic32 pending_task_counts[BrowserThread::ID_COUNT];
+
   const scoped_refptr<base::SequencedWorkerPool> blocking_pool;
 };
 
 base::LazyInstance<BrowserThreadGlobals>::Leaky
     g_globals = LAZY_INSTANCE_INITIALIZER;
 
+// Decrements the pending-task count for |identifier| when a task starts
+// running.  Tasks posted directly to the thread's MessageLoop bypass
+// PostTaskHelper and were never counted, so executions can outnumber
+// recorded posts; clamp the counter at zero instead of letting it drift
+// negative.
+void DecrementPendingTaskCount(BrowserThread::ID identifier) {
+  BrowserThreadGlobals& globals = g_globals.Get();
+  base::subtle::Atomic32 count =
+      base::subtle::NoBarrier_Load(&globals.pending_task_counts[identifier]);
+  while (count > 0) {
+    base::subtle::Atomic32 prev = base::subtle::NoBarrier_CompareAndSwap(
+        &globals.pending_task_counts[identifier], count, count - 1);
+    if (prev == count)
+      break;
+    count = prev;
+  }
+}
+
 }  // namespace
 
+// Records per-task queueing delay and execution time for one browser thread
+// into UMA histograms, where about:histograms and the UMA servers can see
+// them.  All methods run on the thread being measured; the observer must be
+// extremely fast since it runs around every task.
+class BrowserThreadTaskMetrics : public MessageLoop::TaskObserver {
+ public:
+  BrowserThreadTaskMetrics(BrowserThread::ID identifier,
+                           const std::string& thread_name)
+      : identifier_(identifier) {
+    // The histograms are never deleted, so the raw pointers stay valid for
+    // the life of the process.
+    queue_time_histogram_ = base::Histogram::FactoryTimeGet(
+        "BrowserThread.TaskQueueTime_" + thread_name,
+        base::TimeDelta::FromMilliseconds(1),
+        base::TimeDelta::FromSeconds(10),
+        50, base::Histogram::kUmaTargetedHistogramFlag);
+    run_time_histogram_ = base::Histogram::FactoryTimeGet(
+        "BrowserThread.TaskRunTime_" + thread_name,
+        base::TimeDelta::FromMilliseconds(1),
+        base::TimeDelta::FromSeconds(10),
+        50, base::Histogram::kUmaTargetedHistogramFlag);
+    long_task_histogram_ = base::Histogram::FactoryTimeGet(
+        "BrowserThread.LongTaskRunTime_" + thread_name,
+        base::TimeDelta::FromMilliseconds(kLongTaskThresholdMs),
+        base::TimeDelta::FromMinutes(3),
+        50, base::Histogram::kUmaTargetedHistogramFlag);
+  }
+
+  virtual ~BrowserThreadTaskMetrics() {}
+
+  // MessageLoop::TaskObserver implementation.
+  virtual void WillProcessTask(base::TimeTicks time_posted) OVERRIDE {
+    base::TimeTicks now = base::TimeTicks::Now();
+    // |time_posted| is when the task was posted, so for delayed tasks this
+    // includes the requested delay.  Immediate tasks dominate the browser
+    // threads, so the histogram remains a usable saturation signal.
+    queue_time_histogram_->AddTime(now - time_posted);
+    run_start_time_ = now;
+    DecrementPendingTaskCount(identifier_);
+  }
+
+  virtual void DidProcessTask(base::TimeTicks time_posted) OVERRIDE {
+    // Tasks that spin a nested loop are measured from the start of the last
+    // nested task rather than their own; they are rare enough not to matter.
+    base::TimeDelta run_time = base::TimeTicks::Now() - run_start_time_;
+    run_time_histogram_->AddTime(run_time);
+    if (run_time.InMilliseconds() >= kLongTaskThresholdMs)
+      long_task_histogram_->AddTime(run_time);
+  }
+
+ private:
+  BrowserThread::ID identifier_;
+
+  // Not owned; histograms live for the process lifetime.
+  base::Histogram* queue_time_histogram_;
+  base::Histogram* run_time_histogram_;
+  base::Histogram* long_task_histogram_;
+
+  base::TimeTicks run_start_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(BrowserThreadTaskMetrics);
+};
+
 BrowserThreadImpl::BrowserThreadImpl(ID identifier)
     : Thread(g_browser_thread_names[identifier]),
       identifier_(identifier) {
@@ -83,6 +177,11 @@ void BrowserThreadImpl::ShutdownThreadPool() {
 }
 
 void BrowserThreadImpl::Init() {
+  // Instrument every task this thread runs.  The observer must be added (and
+  // later removed) on the thread itself.
+  task_metrics_.reset(new BrowserThreadTaskMetrics(identifier_, thread_name()));
+  message_loop()->AddTaskObserver(task_metrics_.get());
+
   BrowserThreadGlobals& globals = g_globals.Get();
 
   using base::subtle::AtomicWord;
@@ -107,6 +206,11 @@ void BrowserThreadImpl::CleanUp() {
 
   if (delegate)
     delegate->CleanUp();
+
+  if (task_metrics_.get()) {
+    message_loop()->RemoveTaskObserver(task_metrics_.get());
+    task_metrics_.reset();
+  }
 }
 
 void BrowserThreadImpl::Initialize() {
@@ -162,6 +266,10 @@ bool BrowserThreadImpl::PostTaskHelper(
   MessageLoop* message_loop = globals.threads[identifier] ?
       globals.threads[identifier]->message_loop() : NULL;
   if (message_loop) {
+    // Counted from post time, so delayed tasks are included before they
+    // become due.  The count is decremented when the task starts running.
+    base::subtle::NoBarrier_AtomicIncrement(
+        &globals.pending_task_counts[identifier], 1);
     if (nestable) {
       message_loop->PostDelayedTask(from_here, task, delay);
     } else {
@@ -262,6 +370,17 @@ bool BrowserThread::IsWellKnownThread(ID identifier) {
           globals.threads[identifier]);
 }
 
+// static
+int BrowserThread::GetPendingTaskCount(ID identifier) {
+  if (g_globals == NULL)
+    return 0;
+
+  BrowserThreadGlobals& globals = g_globals.Get();
+  DCHECK(identifier >= 0 && identifier < ID_COUNT);
+  return base::subtle::NoBarrier_Load(
+      &globals.pending_task_counts[identifier]);
+}
+
 // static
 bool BrowserThread::CurrentlyOn(ID identifier) {
   // We shouldn't use MessageLoop::current() since it uses LazyInstance which
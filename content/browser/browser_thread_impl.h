@@ -6,12 +6,15 @@
 #define CONTENT_BROWSER_BROWSER_THREAD_IMPL_H_
 #pragma once
 
+#include "base/memory/scoped_ptr.h"
 #include "base/threading/thread.h"
 #include "content/common/content_export.h"
 #include "content/public/browser/browser_thread.h"
 
 namespace content {
 
+class BrowserThreadTaskMetrics;
+
 class CONTENT_EXPORT BrowserThreadImpl
     : public BrowserThread, public base::Thread {
  public:
@@ -49,6 +52,11 @@ class CONTENT_EXPORT BrowserThreadImpl
   // The identifier of this thread.  Only one thread can exist with a given
   // identifier at a given time.
   ID identifier_;
+
+  // Records queueing delay and execution time for every task run on this
+  // thread.  Created and installed as a task observer in Init() and removed
+  // in CleanUp(), both of which run on the thread itself.
+  scoped_ptr<BrowserThreadTaskMetrics> task_metrics_;
 };
 
 }  // namespace content
@@ -121,6 +121,15 @@ TEST_F(BrowserThreadTest, ReleaseViaMessageLoopProxy) {
   MessageLoop::current()->Run();
 }
 
+TEST_F(BrowserThreadTest, GetPendingTaskCount) {
+  // A delayed task that never becomes due stays queued, so the count is
+  // stable while we read it.
+  EXPECT_TRUE(BrowserThread::PostDelayedTask(
+      BrowserThread::FILE, FROM_HERE, base::Bind(&base::DoNothing),
+      base::TimeDelta::FromHours(1)));
+  EXPECT_GE(BrowserThread::GetPendingTaskCount(BrowserThread::FILE), 1);
+}
+
 TEST_F(BrowserThreadTest, PostTaskAndReply) {
   // Most of the heavy testing for PostTaskAndReply() is done inside the
   // MessageLoopProxy test.  This just makes sure we get piped through at all.
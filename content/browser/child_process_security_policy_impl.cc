@@ -92,17 +92,6 @@ class ChildProcessSecurityPolicyImpl::SecurityState {
     can_read_raw_cookies_ = false;
   }
 
-  // Determine whether permission has been granted to request url.
-  // Schemes that have not been granted default to being denied.
-  bool CanRequestURL(const GURL& url) {
-    SchemeMap::const_iterator judgment(scheme_policy_.find(url.scheme()));
-
-    if (judgment == scheme_policy_.end())
-      return false;  // Unmentioned schemes are disallowed.
-
-    return judgment->second;
-  }
-
   // Determine if the certain permissions have been granted to a file.
   bool HasPermissionsForFile(const FilePath& file, int permissions) {
     FilePath current_path = file.StripTrailingSeparators();
@@ -136,6 +125,11 @@ class ChildProcessSecurityPolicyImpl::SecurityState {
     return can_read_raw_cookies_;
   }
 
+  // Copies the per-scheme grant map into |out| for the URL check snapshot.
+  void CopySchemePolicy(std::map<std::string, bool>* out) const {
+    *out = scheme_policy_;
+  }
+
  private:
   typedef std::map<std::string, bool> SchemeMap;
   typedef std::map<FilePath, int> FileMap;  // bit-set of PlatformFileFlags
@@ -163,6 +157,32 @@ class ChildProcessSecurityPolicyImpl::SecurityState {
   DISALLOW_COPY_AND_ASSIGN(SecurityState);
 };
 
+// An immutable copy of the state CanRequestURL consults.  A snapshot is built
+// whenever the master state mutates and is then shared, read-only, by any
+// number of threads; readers only hold the policy lock long enough to copy
+// the reference.
+class ChildProcessSecurityPolicyImpl::UrlCheckSnapshot
+    : public base::RefCountedThreadSafe<UrlCheckSnapshot> {
+ public:
+  typedef std::map<std::string, bool> SchemeMap;
+  typedef std::map<int, SchemeMap> SchemeGrantMap;
+
+  UrlCheckSnapshot() {}
+
+  SchemeSet web_safe_schemes;
+  SchemeSet pseudo_schemes;
+  SchemeSet disabled_schemes;
+
+  // Per-child copies of SecurityState::scheme_policy_.
+  SchemeGrantMap scheme_grants;
+
+ private:
+  friend class base::RefCountedThreadSafe<UrlCheckSnapshot>;
+  ~UrlCheckSnapshot() {}
+
+  DISALLOW_COPY_AND_ASSIGN(UrlCheckSnapshot);
+};
+
 ChildProcessSecurityPolicyImpl::ChildProcessSecurityPolicyImpl() {
   // We know about these schemes and believe them to be safe.
   RegisterWebSafeScheme(chrome::kHttpScheme);
@@ -199,6 +219,7 @@ ChildProcessSecurityPolicyImpl* ChildProcessSecurityPolicyImpl::GetInstance() {
 void ChildProcessSecurityPolicyImpl::Add(int child_id) {
   base::AutoLock lock(lock_);
   AddChild(child_id);
+  UpdateUrlCheckSnapshot();
 }
 
 void ChildProcessSecurityPolicyImpl::AddWorker(int child_id,
@@ -206,6 +227,7 @@ void ChildProcessSecurityPolicyImpl::AddWorker(int child_id,
   base::AutoLock lock(lock_);
   AddChild(child_id);
   worker_map_[child_id] = main_render_process_id;
+  UpdateUrlCheckSnapshot();
 }
 
 void ChildProcessSecurityPolicyImpl::Remove(int child_id) {
@@ -216,6 +238,7 @@ void ChildProcessSecurityPolicyImpl::Remove(int child_id) {
   delete security_state_[child_id];
   security_state_.erase(child_id);
   worker_map_.erase(child_id);
+  UpdateUrlCheckSnapshot();
 }
 
 void ChildProcessSecurityPolicyImpl::RegisterWebSafeScheme(
@@ -225,13 +248,14 @@ void ChildProcessSecurityPolicyImpl::RegisterWebSafeScheme(
   DCHECK(pseudo_schemes_.count(scheme) == 0) << "Web-safe implies not pseudo.";
 
   web_safe_schemes_.insert(scheme);
+  UpdateUrlCheckSnapshot();
 }
 
 bool ChildProcessSecurityPolicyImpl::IsWebSafeScheme(
     const std::string& scheme) {
-  base::AutoLock lock(lock_);
+  scoped_refptr<UrlCheckSnapshot> snapshot(GetUrlCheckSnapshot());
 
-  return (web_safe_schemes_.find(scheme) != web_safe_schemes_.end());
+  return (snapshot->web_safe_schemes.count(scheme) != 0);
 }
 
 void ChildProcessSecurityPolicyImpl::RegisterPseudoScheme(
@@ -242,25 +266,27 @@ void ChildProcessSecurityPolicyImpl::RegisterPseudoScheme(
       "Pseudo implies not web-safe.";
 
   pseudo_schemes_.insert(scheme);
+  UpdateUrlCheckSnapshot();
 }
 
 bool ChildProcessSecurityPolicyImpl::IsPseudoScheme(
     const std::string& scheme) {
-  base::AutoLock lock(lock_);
+  scoped_refptr<UrlCheckSnapshot> snapshot(GetUrlCheckSnapshot());
 
-  return (pseudo_schemes_.find(scheme) != pseudo_schemes_.end());
+  return (snapshot->pseudo_schemes.count(scheme) != 0);
 }
 
 void ChildProcessSecurityPolicyImpl::RegisterDisabledSchemes(
     const std::set<std::string>& schemes) {
   base::AutoLock lock(lock_);
   disabled_schemes_ = schemes;
+  UpdateUrlCheckSnapshot();
 }
 
 bool ChildProcessSecurityPolicyImpl::IsDisabledScheme(
     const std::string& scheme) {
-  base::AutoLock lock(lock_);
-  return disabled_schemes_.find(scheme) != disabled_schemes_.end();
+  scoped_refptr<UrlCheckSnapshot> snapshot(GetUrlCheckSnapshot());
+  return snapshot->disabled_schemes.count(scheme) != 0;
 }
 
 void ChildProcessSecurityPolicyImpl::GrantRequestURL(
@@ -295,6 +321,7 @@ void ChildProcessSecurityPolicyImpl::GrantRequestURL(
     // If the child process has been commanded to request a scheme, then we
     // grant it the capability to request URLs of that scheme.
     state->second->GrantScheme(url.scheme());
+    UpdateUrlCheckSnapshot();
   }
 }
 
@@ -350,6 +377,7 @@ void ChildProcessSecurityPolicyImpl::GrantScheme(int child_id,
     return;
 
   state->second->GrantScheme(scheme);
+  UpdateUrlCheckSnapshot();
 }
 
 void ChildProcessSecurityPolicyImpl::GrantWebUIBindings(int child_id) {
@@ -366,6 +394,8 @@ void ChildProcessSecurityPolicyImpl::GrantWebUIBindings(int child_id) {
 
   // Web UI pages can contain links to file:// URLs.
   state->second->GrantScheme(chrome::kFileScheme);
+
+  UpdateUrlCheckSnapshot();
 }
 
 void ChildProcessSecurityPolicyImpl::GrantReadRawCookies(int child_id) {
@@ -390,16 +420,25 @@ void ChildProcessSecurityPolicyImpl::RevokeReadRawCookies(int child_id) {
 
 bool ChildProcessSecurityPolicyImpl::CanRequestURL(
     int child_id, const GURL& url) {
+  // This runs per resource request on the IO thread, so read through an
+  // immutable snapshot of the policy rather than holding |lock_| while
+  // inspecting the URL.
+  scoped_refptr<UrlCheckSnapshot> snapshot(GetUrlCheckSnapshot());
+  return CanRequestURLInternal(*snapshot, child_id, url);
+}
+
+bool ChildProcessSecurityPolicyImpl::CanRequestURLInternal(
+    const UrlCheckSnapshot& snapshot, int child_id, const GURL& url) {
   if (!url.is_valid())
     return false;  // Can't request invalid URLs.
 
-  if (IsDisabledScheme(url.scheme()))
+  if (snapshot.disabled_schemes.count(url.scheme()))
     return false; // The scheme is disabled by policy.
 
-  if (IsWebSafeScheme(url.scheme()))
+  if (snapshot.web_safe_schemes.count(url.scheme()))
     return true;  // The scheme has been white-listed for every child process.
 
-  if (IsPseudoScheme(url.scheme())) {
+  if (snapshot.pseudo_schemes.count(url.scheme())) {
     // There are a number of special cases for pseudo schemes.
 
     if (url.SchemeIs(chrome::kViewSourceScheme)) {
@@ -410,7 +449,7 @@ bool ChildProcessSecurityPolicyImpl::CanRequestURL(
           url.SchemeIs(chrome::kViewSourceScheme))
           return false;
 
-      return CanRequestURL(child_id, child_url);
+      return CanRequestURLInternal(snapshot, child_id, child_url);
     }
 
     if (LowerCaseEqualsASCII(url.spec(), chrome::kAboutBlankURL))
@@ -427,17 +466,19 @@ bool ChildProcessSecurityPolicyImpl::CanRequestURL(
     return true;  // This URL request is destined for ShellExecute.
   }
 
-  {
-    base::AutoLock lock(lock_);
+  UrlCheckSnapshot::SchemeGrantMap::const_iterator grants =
+      snapshot.scheme_grants.find(child_id);
+  if (grants == snapshot.scheme_grants.end())
+    return false;
 
-    SecurityStateMap::iterator state = security_state_.find(child_id);
-    if (state == security_state_.end())
-      return false;
+  // Otherwise, we consult the child process's scheme grants to see if it is
+  // allowed to request the URL.  Unmentioned schemes are disallowed.
+  UrlCheckSnapshot::SchemeMap::const_iterator judgment =
+      grants->second.find(url.scheme());
+  if (judgment == grants->second.end())
+    return false;
 
-    // Otherwise, we consult the child process's security state to see if it is
-    // allowed to request the URL.
-    return state->second->CanRequestURL(url);
-  }
+  return judgment->second;
 }
 
 bool ChildProcessSecurityPolicyImpl::CanReadFile(int child_id,
@@ -498,6 +539,25 @@ void ChildProcessSecurityPolicyImpl::AddChild(int child_id) {
   security_state_[child_id] = new SecurityState();
 }
 
+scoped_refptr<ChildProcessSecurityPolicyImpl::UrlCheckSnapshot>
+    ChildProcessSecurityPolicyImpl::GetUrlCheckSnapshot() {
+  base::AutoLock lock(lock_);
+  return url_check_snapshot_;
+}
+
+void ChildProcessSecurityPolicyImpl::UpdateUrlCheckSnapshot() {
+  lock_.AssertAcquired();
+  scoped_refptr<UrlCheckSnapshot> snapshot(new UrlCheckSnapshot);
+  snapshot->web_safe_schemes = web_safe_schemes_;
+  snapshot->pseudo_schemes = pseudo_schemes_;
+  snapshot->disabled_schemes = disabled_schemes_;
+  for (SecurityStateMap::iterator iter = security_state_.begin();
+       iter != security_state_.end(); ++iter) {
+    iter->second->CopySchemePolicy(&snapshot->scheme_grants[iter->first]);
+  }
+  url_check_snapshot_ = snapshot;
+}
+
 bool ChildProcessSecurityPolicyImpl::ChildProcessHasPermissionsForFile(
     int child_id, const FilePath& file, int permissions) {
   SecurityStateMap::iterator state = security_state_.find(child_id);
@@ -13,6 +13,7 @@
 
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/singleton.h"
 #include "base/synchronization/lock.h"
 #include "content/public/browser/child_process_security_policy.h"
@@ -134,6 +135,7 @@ class CONTENT_EXPORT ChildProcessSecurityPolicyImpl
                            NoLeak);
 
   class SecurityState;
+  class UrlCheckSnapshot;
 
   typedef std::set<std::string> SchemeSet;
   typedef std::map<int, SecurityState*> SecurityStateMap;
@@ -152,6 +154,22 @@ class CONTENT_EXPORT ChildProcessSecurityPolicyImpl
                                          const FilePath& file,
                                          int permissions);
 
+  // Returns the current immutable snapshot of the state consulted by
+  // CanRequestURL.  Briefly acquires |lock_| to copy the reference; the
+  // snapshot itself can then be read without any locking.
+  scoped_refptr<UrlCheckSnapshot> GetUrlCheckSnapshot();
+
+  // Rebuilds |url_check_snapshot_| from the master state.  Must be called,
+  // with |lock_| held, after any mutation of the scheme sets or per-child
+  // scheme grants.
+  void UpdateUrlCheckSnapshot();
+
+  // The body of CanRequestURL, evaluated against a particular snapshot so
+  // that the view-source recursion sees a consistent policy.
+  bool CanRequestURLInternal(const UrlCheckSnapshot& snapshot,
+                             int child_id,
+                             const GURL& url);
+
   // You must acquire this lock before reading or writing any members of this
   // class.  You must not block while holding this lock.
   base::Lock lock_;
@@ -180,6 +198,13 @@ class CONTENT_EXPORT ChildProcessSecurityPolicyImpl
   // corresponds to which main js thread child process.
   WorkerToMainProcessMap worker_map_;
 
+  // An immutable copy of the scheme sets and per-child scheme grants above,
+  // rebuilt on every mutation.  URL checks run per resource request on the IO
+  // thread; reading through the snapshot keeps them from serializing against
+  // permission grants on other threads.  Protected by |lock_|, but only for
+  // the duration of the pointer copy or swap.
+  scoped_refptr<UrlCheckSnapshot> url_check_snapshot_;
+
   DISALLOW_COPY_AND_ASSIGN(ChildProcessSecurityPolicyImpl);
 };
 
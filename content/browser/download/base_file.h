@@ -104,6 +104,13 @@ class CONTENT_EXPORT BaseFile {
   // Resets the current state of the hash to the contents of |hash_state_bytes|.
   virtual bool SetHashState(const std::string& hash_state_bytes);
 
+  // Writes any data sitting in |write_buffer_| to |file_stream_|.  On POSIX,
+  // also asks the kernel to start writing back the flushed range and drop it
+  // from the page cache once clean.  Returns net::OK on success, or a network
+  // error code on failure; a failure is remembered and re-reported by the
+  // next call to AppendDataToFile().
+  net::Error FlushWriteBuffer();
+
   net::Error ClearStream(net::Error error);
 
   static const size_t kSha256HashLen = 32;
@@ -118,9 +125,30 @@ class CONTENT_EXPORT BaseFile {
   // OS file stream for writing
   linked_ptr<net::FileStream> file_stream_;
 
-  // Amount of data received up so far, in bytes.
+  // Amount of data received up so far, in bytes.  Includes data still
+  // sitting in |write_buffer_|.
   int64 bytes_so_far_;
 
+  // Coalesces the small chunks delivered to AppendDataToFile() into fewer,
+  // larger disk writes.  Allocated on first append.
+  scoped_array<char> write_buffer_;
+
+  // Amount of |write_buffer_| currently in use, in bytes.
+  size_t write_buffer_used_;
+
+  // The first error encountered while flushing |write_buffer_|, or net::OK.
+  // Buffering can delay a write failure past the append that supplied the
+  // data, so the error is kept and returned by the next append.
+  net::Error pending_write_error_;
+
+  // Number of bytes actually written to |file_stream_|, i.e. |bytes_so_far_|
+  // minus whatever is still buffered.
+  int64 flushed_offset_;
+
+  // End of the file range already passed to posix_fadvise().  Unused on
+  // platforms without fadvise.
+  int64 fadvise_offset_;
+
   // Start time for calculating speed.
   base::TimeTicks start_tick_;
 
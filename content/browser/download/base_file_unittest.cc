@@ -135,6 +135,10 @@ class BaseFileTest : public testing::Test {
     mock_file_stream_->set_forced_error(error);
   }
 
+  int FlushWriteBuffer() {
+    return base_file_->FlushWriteBuffer();
+  }
+
   int AppendDataToFile(const std::string& data) {
     EXPECT_EQ(expect_in_progress_, base_file_->in_progress());
     expected_error_ = mock_file_stream_.get() &&
@@ -480,6 +484,11 @@ TEST_F(BaseFileTest, MultipleWritesWithError) {
   ASSERT_EQ(net::OK, AppendDataToFile(kTestData1));
   ASSERT_EQ(net::OK, AppendDataToFile(kTestData2));
   ForceError(net::ERR_ACCESS_DENIED);
+  // Appends are coalesced in a write buffer, so the error doesn't surface
+  // until the buffer is flushed...
+  ASSERT_EQ(net::OK, AppendDataToFile(kTestData3));
+  ASSERT_NE(net::OK, FlushWriteBuffer());
+  // ...and is then sticky, failing subsequent appends.
   ASSERT_NE(net::OK, AppendDataToFile(kTestData3));
   std::string hash;
   EXPECT_FALSE(base_file_->GetHash(&hash));
@@ -109,7 +109,7 @@ void GamepadProvider::DoPoll() {
   GamepadHardwareBuffer* hwbuf = SharedMemoryAsHardwareBuffer();
 
   ANNOTATE_BENIGN_RACE_SIZED(
-      &hwbuf->buffer,
+      &hwbuf->data,
       sizeof(WebKit::WebGamepads),
       "Racey reads are discarded");
 
@@ -122,7 +122,7 @@ void GamepadProvider::DoPoll() {
   // Acquire the SeqLock. There is only ever one writer to this data.
   // See gamepad_hardware_buffer.h.
   hwbuf->sequence.WriteBegin();
-  data_fetcher_->GetGamepadData(&hwbuf->buffer, changed);
+  data_fetcher_->GetGamepadData(&hwbuf->data, changed);
   hwbuf->sequence.WriteEnd();
 
   // Schedule our next interval of polling.
@@ -93,7 +93,7 @@ TEST_F(GamepadProviderTest, DISABLED_PollingAccess) {
   base::subtle::Atomic32 version;
   do {
     version = hwbuf->sequence.ReadBegin();
-    memcpy(&output, &hwbuf->buffer, sizeof(output));
+    memcpy(&output, &hwbuf->data, sizeof(output));
   } while (hwbuf->sequence.ReadRetry(version));
 
   EXPECT_EQ(1u, output.length);
@@ -38,6 +38,9 @@ namespace {
 // this buffer around for the next read as a small optimization.
 SharedIOBuffer* g_spare_read_buffer = NULL;
 
+// The minimum size of the shared memory buffer. (4 kilobytes).
+const int kMinReadBufSize = 4096;
+
 // The initial size of the shared memory buffer. (32 kilobytes).
 const int kInitialReadBufSize = 32768;
 
@@ -147,6 +150,15 @@ bool AsyncResourceHandler::OnResponseStarted(
             request_url))));
   }
 
+  // If the headers announce a response smaller than the initial buffer,
+  // size the first buffer to fit it so small responses don't tie up a full
+  // 32k shared memory segment each.
+  if (response->content_length > 0 &&
+      response->content_length < kInitialReadBufSize) {
+    next_buffer_size_ = std::max(
+        static_cast<int>(response->content_length), kMinReadBufSize);
+  }
+
   response->request_start = request->creation_time();
   response->response_start = TimeTicks::Now();
   filter_->Send(new ResourceMsg_ReceivedResponse(
@@ -173,7 +185,12 @@ bool AsyncResourceHandler::OnWillRead(int request_id, net::IOBuffer** buf,
                                       int* buf_size, int min_size) {
   DCHECK_EQ(-1, min_size);
 
-  if (g_spare_read_buffer) {
+  // Only reuse the spare buffer if its size is a reasonable fit for what we
+  // want to allocate; handing a large leftover buffer to a request we expect
+  // to be small wastes shared memory.
+  if (g_spare_read_buffer &&
+      g_spare_read_buffer->buffer_size() >= next_buffer_size_ &&
+      g_spare_read_buffer->buffer_size() <= 4 * next_buffer_size_) {
     DCHECK(!read_buffer_);
     read_buffer_.swap(&g_spare_read_buffer);
     DCHECK(read_buffer_->data());
@@ -205,6 +222,10 @@ bool AsyncResourceHandler::OnReadCompleted(int request_id, int* bytes_read) {
     // a bigger buffer for it to fill, to minimize the number of round trips we
     // do with the renderer process.
     next_buffer_size_ = std::min(next_buffer_size_ * 2, kMaxReadBufSize);
+  } else if (*bytes_read < read_buffer_->buffer_size() / 4) {
+    // The network layer filled less than a quarter of the buffer. Shrink the
+    // next one so slow transfers don't hold large shared memory segments.
+    next_buffer_size_ = std::max(next_buffer_size_ / 2, kMinReadBufSize);
   }
 
   if (!rdh_->WillSendData(filter_->child_id(), request_id)) {
@@ -219,7 +240,7 @@ bool AsyncResourceHandler::OnReadCompleted(int request_id, int* bytes_read) {
     // to fix this. We can't move this call above the WillSendData because
     // it's killing our read_buffer_, and we don't want that when we pause
     // the request.
-    rdh_->DataReceivedACK(filter_->child_id(), request_id);
+    rdh_->DataReceivedACK(filter_->child_id(), request_id, 1);
     // We just unmapped the memory.
     read_buffer_ = NULL;
     return false;
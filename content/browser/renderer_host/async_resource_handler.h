@@ -63,10 +63,10 @@ class AsyncResourceHandler : public ResourceHandler {
   ResourceDispatcherHostImpl* rdh_;
 
   // |next_buffer_size_| is the size of the buffer to be allocated on the next
-  // OnWillRead() call.  We exponentially grow the size of the buffer allocated
-  // when our owner fills our buffers. On the first OnWillRead() call, we
-  // allocate a buffer of 32k and double it in OnReadCompleted() if the buffer
-  // was filled, up to a maximum size of 512k.
+  // OnWillRead() call.  It adapts to the observed throughput of the request:
+  // it starts at 32k (or the announced content length, if smaller), doubles
+  // in OnReadCompleted() whenever the network layer fills the buffer, and
+  // halves whenever a read fills less than a quarter of it, within 4k-512k.
   int next_buffer_size_;
 
   // TODO(battre): Remove url. This is only for debugging
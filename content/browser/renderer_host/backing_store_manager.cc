@@ -90,22 +90,59 @@ size_t ExpireLastBackingStore(BackingStoreCache* cache) {
   return entry_size;
 }
 
+// When evicting for memory (rather than for the entry count cap), how many of
+// the least recently used entries to consider.
+const size_t kEvictionCandidateWindow = 3;
+
+// Evicts one entry from |cache| to reclaim memory.  Rather than blindly
+// dropping the least recently used entry, look at the few oldest entries and
+// drop the largest of them: restoring any evicted entry costs its widget
+// roughly one full repaint regardless of size, so evicting the largest frees
+// the most memory per repaint we cause.  The most recently used entry is
+// never considered since it is the one most likely to be visible.
+size_t ExpireCostliestBackingStore(BackingStoreCache* cache) {
+  if (cache->size() < 1)
+    return 0;
+
+  // Crazy C++ alert: rbegin.base() is a forward iterator pointing to end(),
+  // so we need to do -- to move one back to the actual last item.
+  BackingStoreCache::iterator candidate = --cache->rbegin().base();
+  size_t candidate_size = candidate->second->MemorySize();
+
+  BackingStoreCache::iterator it = candidate;
+  for (size_t i = 1;
+       i < kEvictionCandidateWindow && it != cache->begin();
+       ++i) {
+    --it;
+    if (it == cache->begin())
+      break;
+    size_t it_size = it->second->MemorySize();
+    if (it_size > candidate_size) {
+      candidate = it;
+      candidate_size = it_size;
+    }
+  }
+
+  ExpireBackingStoreAt(cache, candidate);
+  return candidate_size;
+}
+
 void CreateCacheSpace(size_t size) {
   // Given a request for |size|, first free from the large cache (until there's
   // only one item left) and then do the same from the small cache if we still
-  // don't have enough.
+  // don't have enough.  May free less than |size| if the caches run down to
+  // one entry each first.
   while (size > 0 && (large_cache->size() > 1 || small_cache->size() > 1)) {
     BackingStoreCache* cache =
         (large_cache->size() > 1) ? large_cache : small_cache;
     while (size > 0 && cache->size() > 1) {
-      size_t entry_size = ExpireLastBackingStore(cache);
+      size_t entry_size = ExpireCostliestBackingStore(cache);
       if (size > entry_size)
         size -= entry_size;
       else
         size = 0;
     }
   }
-  DCHECK(size == 0);
 }
 
 // Creates the backing store for the host based on the dimensions passed in.
@@ -263,6 +300,21 @@ void BackingStoreManager::RemoveAllBackingStores() {
   }
 }
 
+// static
+void BackingStoreManager::ReduceMemoryUsage() {
+  if (!large_cache)
+    return;
+
+  // Trim the caches to half the normal budget.  Unlike
+  // RemoveAllBackingStores(), this keeps the most recently used entries, so
+  // reclaiming memory under pressure doesn't force a repaint of the visible
+  // widget.
+  size_t target = MaxBackingStoreMemory() / 2;
+  size_t current = BackingStoreManager::MemorySize();
+  if (current > target)
+    CreateCacheSpace(current - target);
+}
+
 // static
 size_t BackingStoreManager::MemorySize() {
   if (!large_cache)
@@ -67,6 +67,12 @@ class BackingStoreManager {
   // Removes all backing stores.
   static void RemoveAllBackingStores();
 
+  // Expires backing stores until the cache is within half its normal memory
+  // budget, preferring large, stale entries.  For callers responding to
+  // system memory pressure; cheaper for the user than RemoveAllBackingStores
+  // since recently used widgets keep their stores.
+  static void ReduceMemoryUsage();
+
   // Current size in bytes of the backing store cache.
   static size_t MemorySize();
 
@@ -98,7 +98,15 @@ bool BufferedResourceHandler::OnWillRead(int request_id, net::IOBuffer** buf,
                                          int* buf_size, int min_size) {
   if (buffering_) {
     DCHECK(!my_buffer_.get());
-    my_buffer_ = new net::IOBuffer(net::kMaxBytesToSniff);
+    DCHECK(read_buffer_.get());
+    // Hand out the unused tail of the main buffer, so the extra bytes we
+    // buffer for sniffing land directly in it instead of being copied
+    // through a temporary buffer.
+    CHECK_LT(bytes_read_ + net::kMaxBytesToSniff, read_buffer_size_);
+    scoped_refptr<net::DrainableIOBuffer> buffer(
+        new net::DrainableIOBuffer(read_buffer_, read_buffer_size_));
+    buffer->SetOffset(bytes_read_);
+    my_buffer_ = buffer;
     *buf = my_buffer_.get();
     *buf_size = net::kMaxBytesToSniff;
     return true;
@@ -201,12 +209,12 @@ bool BufferedResourceHandler::DidBufferEnough(int bytes_read) {
 bool BufferedResourceHandler::KeepBuffering(int bytes_read) {
   DCHECK(read_buffer_);
   if (my_buffer_) {
-    // We are using our own buffer to read, update the main buffer.
+    // The read landed directly in the unused tail of the main buffer, so
+    // there is nothing to copy; just drop our window into it.
     // TODO(darin): We should handle the case where read_buffer_size_ is small!
     // See RedirectToFileResourceHandler::BufIsFull to see how this impairs
     // downstream ResourceHandler implementations.
     CHECK_LT(bytes_read + bytes_read_, read_buffer_size_);
-    memcpy(read_buffer_->data() + bytes_read_, my_buffer_->data(), bytes_read);
     my_buffer_ = NULL;
   }
   bytes_read_ += bytes_read;
@@ -32,7 +32,6 @@
 #include "base/path_service.h"
 #include "base/platform_file.h"
 #include "base/process_util.h"
-#include "base/rand_util.h"
 #include "base/stl_util.h"
 #include "base/string_util.h"
 #include "base/sys_info.h"
@@ -85,6 +84,7 @@
 #include "content/common/gpu/gpu_messages.h"
 #include "content/common/resource_messages.h"
 #include "content/common/view_messages.h"
+#include "content/public/browser/browser_child_process_host.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/content_browser_client.h"
 #include "content/public/browser/notification_service.h"
@@ -217,6 +217,52 @@ class RendererURLRequestContextSelector
 base::LazyInstance<IDMap<content::RenderProcessHost> >::Leaky
     g_all_hosts = LAZY_INSTANCE_INITIALIZER;
 
+// A pre-launched render process host that the next navigation needing a
+// fresh process can claim, so it doesn't pay for process startup and
+// sandbox initialization. See {Take,Warmup}SpareRenderProcessHost.
+RenderProcessHostImpl* g_spare_render_process_host = NULL;
+
+// How long a process must stay in the background before we ask it to
+// release the memory it can do without.
+const int kBackgroundPurgeDelaySeconds = 5 * 60;
+
+// Weights used by GetReuseCost(). A widget is more of a load signal than a
+// megabyte of memory, and a visible widget means the user is watching the
+// process, which outweighs everything else.
+const size_t kWidgetReuseCost = 16;
+const size_t kVisibleWidgetReuseCost = 1 << 16;
+
+// Returns an estimate of how expensive it would be to host another site in
+// |host|; lower is better. The estimate combines the number of widgets the
+// process is servicing (a proxy for its message queue depth), whether any of
+// them are visible, and the process memory footprint, so that new tabs land
+// in the renderers that are doing and holding the least.
+size_t GetReuseCost(content::RenderProcessHost* host) {
+  size_t widgets = 0;
+  content::RenderProcessHost::RenderWidgetHostsIterator widget_iter(
+      host->GetRenderWidgetHostsIterator());
+  while (!widget_iter.IsAtEnd()) {
+    widgets++;
+    widget_iter.Advance();
+  }
+
+  size_t memory_mb = 0;
+  base::ProcessHandle handle = host->GetHandle();
+  if (handle) {
+    scoped_ptr<base::ProcessMetrics> metrics(
+#if !defined(OS_MACOSX)
+        base::ProcessMetrics::CreateProcessMetrics(handle));
+#else
+        base::ProcessMetrics::CreateProcessMetrics(
+            handle, content::BrowserChildProcessHost::GetPortProvider()));
+#endif
+    memory_mb = metrics->GetWorkingSetSize() / (1024 * 1024);
+  }
+
+  return memory_mb + kWidgetReuseCost * widgets +
+      kVisibleWidgetReuseCost * host->VisibleWidgetCount();
+}
+
 }  // namespace
 
 // Stores the maximum number of renderer processes the content module can
@@ -336,6 +382,9 @@ RenderProcessHostImpl::RenderProcessHostImpl(
 }
 
 RenderProcessHostImpl::~RenderProcessHostImpl() {
+  if (g_spare_render_process_host == this)
+    g_spare_render_process_host = NULL;
+
   ChildProcessSecurityPolicyImpl::GetInstance()->Remove(GetID());
 
   // We may have some unsent messages at this point, but that's OK.
@@ -1128,6 +1177,42 @@ void RenderProcessHostImpl::UnregisterHost(int host_id) {
     g_all_hosts.Get().Remove(host_id);
 }
 
+// static
+void RenderProcessHostImpl::WarmupSpareRenderProcessHost(
+    content::BrowserContext* browser_context) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (g_spare_render_process_host || run_renderer_in_process())
+    return;
+
+  // Don't grow the process count past the limit for the sake of a spare;
+  // navigations will share existing processes in that regime anyway.
+  if (g_all_hosts.Get().size() >= GetMaxRendererProcessCount())
+    return;
+
+  RenderProcessHostImpl* spare = new RenderProcessHostImpl(browser_context);
+  if (!spare->Init()) {
+    delete spare;
+    return;
+  }
+  g_spare_render_process_host = spare;
+}
+
+// static
+content::RenderProcessHost*
+    RenderProcessHostImpl::TakeSpareRenderProcessHost(
+        content::BrowserContext* browser_context,
+        const GURL& site_url) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  RenderProcessHostImpl* spare = g_spare_render_process_host;
+  if (!spare)
+    return NULL;
+  if (spare->GetBrowserContext() != browser_context ||
+      !IsSuitableHost(spare, browser_context, site_url))
+    return NULL;
+  g_spare_render_process_host = NULL;
+  return spare;
+}
+
 // static
 bool RenderProcessHostImpl::IsSuitableHost(
     content::RenderProcessHost* host,
@@ -1211,14 +1296,21 @@ content::RenderProcessHost*
     iter.Advance();
   }
 
-  // Now pick a random suitable renderer, if we have any.
-  if (!suitable_renderers.empty()) {
-    int suitable_count = static_cast<int>(suitable_renderers.size());
-    int random_index = base::RandInt(0, suitable_count - 1);
-    return suitable_renderers[random_index];
+  // Now pick the cheapest suitable renderer, if we have any. Picking the one
+  // with the lowest reuse cost steers new tabs away from processes that are
+  // busy or bloated, which keeps the foreground responsive when we are
+  // sharing processes because we are at the process limit.
+  content::RenderProcessHost* best_host = NULL;
+  size_t best_cost = 0;
+  for (size_t i = 0; i < suitable_renderers.size(); ++i) {
+    size_t cost = GetReuseCost(suitable_renderers[i]);
+    if (!best_host || cost < best_cost) {
+      best_host = suitable_renderers[i];
+      best_cost = cost;
+    }
   }
 
-  return NULL;
+  return best_host;
 }
 
 void RenderProcessHostImpl::ProcessDied(base::ProcessHandle handle,
@@ -1231,6 +1323,10 @@ void RenderProcessHostImpl::ProcessDied(base::ProcessHandle handle,
   // calls to a renderer. If we don't have a valid channel here it means we
   // already handled the error.
 
+  // A dead process is of no use as a spare.
+  if (g_spare_render_process_host == this)
+    g_spare_render_process_host = NULL;
+
   RendererClosedDetails details(handle, status, exit_code, was_alive);
   content::NotificationService::current()->Notify(
       content::NOTIFICATION_RENDERER_PROCESS_CLOSED,
@@ -1285,6 +1381,19 @@ void RenderProcessHostImpl::SetBackgrounded(bool backgrounded) {
   // (and hence hasn't been created yet), we will set the process priority
   // later when we create the process.
   backgrounded_ = backgrounded;
+
+  // Dropping the OS priority is only the first step: a process that stays in
+  // the background long enough is also asked to give back the memory it can
+  // do without, since it may be a while before the user returns to it.
+  if (backgrounded) {
+    background_purge_timer_.Start(
+        FROM_HERE,
+        base::TimeDelta::FromSeconds(kBackgroundPurgeDelaySeconds),
+        this, &RenderProcessHostImpl::OnBackgroundPurgeTimerFired);
+  } else {
+    background_purge_timer_.Stop();
+  }
+
   if (!child_process_launcher_.get() || child_process_launcher_->IsStarting())
     return;
 
@@ -1302,6 +1411,12 @@ void RenderProcessHostImpl::SetBackgrounded(bool backgrounded) {
   child_process_launcher_->SetProcessBackgrounded(backgrounded);
 }
 
+void RenderProcessHostImpl::OnBackgroundPurgeTimerFired() {
+  if (!backgrounded_ || !HasConnection())
+    return;
+  Send(new ViewMsg_ReleaseFreeMemory());
+}
+
 void RenderProcessHostImpl::OnProcessLaunched() {
   // No point doing anything, since this object will be destructed soon.  We
   // especially don't want to send the RENDERER_PROCESS_CREATED notification,
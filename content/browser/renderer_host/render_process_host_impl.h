@@ -128,6 +128,20 @@ class CONTENT_EXPORT RenderProcessHostImpl
                              content::BrowserContext* browser_context,
                              const GURL& site_url);
 
+  // Pre-launches a single "spare" render process host for |browser_context|
+  // if none exists, so the fork and sandbox setup happen ahead of the
+  // navigation that will need the process. Does nothing when running
+  // in-process or when we are already at the process count limit.
+  static void WarmupSpareRenderProcessHost(
+      content::BrowserContext* browser_context);
+
+  // Returns the pre-launched process host and gives up ownership of it, or
+  // NULL if there is none or it isn't suitable for |browser_context| and
+  // |site_url|.
+  static content::RenderProcessHost* TakeSpareRenderProcessHost(
+      content::BrowserContext* browser_context,
+      const GURL& site_url);
+
  protected:
   // A proxy for our IPC::Channel that lives on the IO thread (see
   // browser_process.h)
@@ -181,6 +195,10 @@ class CONTENT_EXPORT RenderProcessHostImpl
   // Callers can reduce the RenderProcess' priority.
   void SetBackgrounded(bool backgrounded);
 
+  // Invoked when the process has spent a long stretch in the background.
+  // Asks the renderer to release the memory it can do without.
+  void OnBackgroundPurgeTimerFired();
+
   // Handle termination of our process. |was_alive| indicates that when we
   // tried to retrieve the exit code the process had not finished yet.
   void ProcessDied(base::ProcessHandle handle,
@@ -264,6 +282,10 @@ class CONTENT_EXPORT RenderProcessHostImpl
   // Records the last time we regarded the child process active.
   base::TimeTicks child_process_activity_time_;
 
+  // Fires once the process has been in the background for a long time, so we
+  // can ask the renderer to give back memory it can do without.
+  base::OneShotTimer<RenderProcessHostImpl> background_purge_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(RenderProcessHostImpl);
 };
 
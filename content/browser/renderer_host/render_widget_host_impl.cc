@@ -90,6 +90,11 @@ void RenderWidgetHost::RemoveAllBackingStores() {
   BackingStoreManager::RemoveAllBackingStores();
 }
 
+// static
+void RenderWidgetHost::ReduceBackingStoreMemory() {
+  BackingStoreManager::ReduceMemoryUsage();
+}
+
 // static
 size_t RenderWidgetHost::BackingStoreMemorySize() {
   return BackingStoreManager::MemorySize();
@@ -961,12 +961,13 @@ void ResourceDispatcherHostImpl::OnReleaseDownloadedFile(int request_id) {
   UnregisterDownloadedTempFile(filter_->child_id(), request_id);
 }
 
-void ResourceDispatcherHostImpl::OnDataReceivedACK(int request_id) {
-  DataReceivedACK(filter_->child_id(), request_id);
+void ResourceDispatcherHostImpl::OnDataReceivedACK(int request_id, int count) {
+  DataReceivedACK(filter_->child_id(), request_id, count);
 }
 
 void ResourceDispatcherHostImpl::DataReceivedACK(int child_id,
-                                                 int request_id) {
+                                                 int request_id,
+                                                 int count) {
   PendingRequestList::iterator i = pending_requests_.find(
       GlobalRequestID(child_id, request_id));
   if (i == pending_requests_.end())
@@ -975,14 +976,26 @@ void ResourceDispatcherHostImpl::DataReceivedACK(int child_id,
   ResourceRequestInfoImpl* info =
       ResourceRequestInfoImpl::ForRequest(i->second);
 
-  // Decrement the number of pending data messages.
-  info->DecrementPendingDataCount();
+  // A pending data count above the max means the request was paused in
+  // WillSendData, with the extra count acting as the pause marker.
+  bool was_paused = info->pending_data_count() > kMaxPendingDataMessages;
+
+  // Decrement the number of pending data messages. The renderer batches its
+  // ACKs, so one message may acknowledge several of them. Guard against a
+  // compromised renderer sending a bogus count.
+  for (int acked = 0;
+       acked < count && info->pending_data_count() > 0;
+       ++acked) {
+    info->DecrementPendingDataCount();
+  }
 
   // If the pending data count was higher than the max, resume the request.
-  if (info->pending_data_count() == kMaxPendingDataMessages) {
+  if (was_paused &&
+      info->pending_data_count() <= kMaxPendingDataMessages) {
     // Decrement the pending data count one more time because we also
     // incremented it before pausing the request.
-    info->DecrementPendingDataCount();
+    if (info->pending_data_count() > 0)
+      info->DecrementPendingDataCount();
 
     // Resume the request.
     PauseRequest(child_id, request_id, false);
@@ -225,10 +225,10 @@ class CONTENT_EXPORT ResourceDispatcherHostImpl
   // Cancels any blocked request for the specified route id.
   void CancelBlockedRequestsForRoute(int child_id, int route_id);
 
-  // Decrements the pending_data_count for the request and resumes
-  // the request if it was paused due to too many pending data
-  // messages sent.
-  void DataReceivedACK(int child_id, int request_id);
+  // Decrements the pending_data_count for the request by |count| (the
+  // renderer batches its ACKs) and resumes the request if it was paused
+  // due to too many pending data messages sent.
+  void DataReceivedACK(int child_id, int request_id, int count);
 
   // Maintains a collection of temp files created in support of
   // the download_to_file capability. Used to grant access to the
@@ -390,7 +390,7 @@ class CONTENT_EXPORT ResourceDispatcherHostImpl
                     const ResourceHostMsg_Request& request_data,
                     IPC::Message* sync_result,  // only valid for sync
                     int route_id);  // only valid for async
-  void OnDataReceivedACK(int request_id);
+  void OnDataReceivedACK(int request_id, int count);
   void OnDataDownloadedACK(int request_id);
   void OnUploadProgressACK(int request_id);
   void OnCancelRequest(int request_id);
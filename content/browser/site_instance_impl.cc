@@ -88,8 +88,17 @@ content::RenderProcessHost* SiteInstanceImpl::GetProcess() {
         process_ = render_process_host_factory_->CreateRenderProcessHost(
             browsing_instance_->browser_context());
       } else {
-        process_ =
-            new RenderProcessHostImpl(browsing_instance_->browser_context());
+        // Prefer the pre-launched spare process, if any, so we don't pay for
+        // process startup on this navigation.
+        process_ = RenderProcessHostImpl::TakeSpareRenderProcessHost(
+            browsing_instance_->browser_context(), site_);
+        if (!process_) {
+          process_ =
+              new RenderProcessHostImpl(browsing_instance_->browser_context());
+        }
+        // Start launching the next spare while this navigation proceeds.
+        RenderProcessHostImpl::WarmupSpareRenderProcessHost(
+            browsing_instance_->browser_context());
       }
     }
 
@@ -22,8 +22,10 @@ namespace {
 
 class AutoStopTraceSubscriberStdio : public content::TraceSubscriberStdio {
  public:
-  AutoStopTraceSubscriberStdio(const FilePath& file_path)
-      : TraceSubscriberStdio(file_path) {}
+  AutoStopTraceSubscriberStdio(const FilePath& file_path,
+                               Format format,
+                               bool compress)
+      : TraceSubscriberStdio(file_path, format, compress) {}
 
   static void EndStartupTrace(TraceSubscriberStdio* subscriber) {
     if (!TraceControllerImpl::GetInstance()->EndTracingAsync(subscriber))
@@ -80,8 +82,23 @@ void TraceControllerImpl::InitStartupTracing(const CommandLine& command_line) {
     // Default to saving the startup trace into the current dir.
     trace_file = FilePath().AppendASCII("chrometrace.log");
   }
+
+  std::string format_str = command_line.GetSwitchValueASCII(
+      switches::kTraceStartupFormat);
+  TraceSubscriberStdio::Format format = TraceSubscriberStdio::FORMAT_JSON;
+  if (format_str == "binary") {
+    // The subscriber must pass binary records through untouched; wrapping
+    // them in JSON array syntax would corrupt the stream.
+    TraceLog::GetInstance()->SetOutputFormat(TraceLog::OUTPUT_BINARY);
+    format = TraceSubscriberStdio::FORMAT_RAW;
+  } else if (!format_str.empty() && format_str != "json") {
+    DLOG(WARNING) << "Unknown --" << switches::kTraceStartupFormat
+        << "=" << format_str << " defaulting to json";
+  }
+  bool compress = command_line.HasSwitch(switches::kTraceStartupCompress);
+
   scoped_ptr<AutoStopTraceSubscriberStdio> subscriber(
-      new AutoStopTraceSubscriberStdio(trace_file));
+      new AutoStopTraceSubscriberStdio(trace_file, format, compress));
   DCHECK(can_begin_tracing(subscriber.get()));
 
   std::string delay_str = command_line.GetSwitchValueASCII(
@@ -4,41 +4,83 @@
 
 #include "content/browser/trace_subscriber_stdio.h"
 
+#include <string.h>
+
 #include "base/bind.h"
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
 #include "base/threading/sequenced_worker_pool.h"
 #include "content/public/browser/browser_thread.h"
+#include "third_party/zlib/zlib.h"
 
 namespace content {
 
+namespace {
+
+// Output buffer handed to deflate() per call; the compressed stream hits
+// the disk in chunks of at most this size.
+const size_t kCompressBufferSize = 1 << 16;  // 64 KB
+
+}  // namespace
+
 // All method calls on this class are done on a SequencedWorkerPool thread.
 class TraceSubscriberStdioImpl
     : public base::RefCountedThreadSafe<TraceSubscriberStdioImpl> {
  public:
-  explicit TraceSubscriberStdioImpl(const FilePath& path)
+  TraceSubscriberStdioImpl(const FilePath& path,
+                           TraceSubscriberStdio::Format format,
+                           bool compress)
       : path_(path),
-        file_(0) {}
+        file_(0),
+        format_(format),
+        compress_(compress),
+        compressor_ready_(false) {}
 
   void OnStart() {
     DCHECK(!file_);
-    file_ = file_util::OpenFile(path_, "w+");
-    if (IsValid()) {
-      LOG(INFO) << "Logging performance trace to file: " << path_.value();
+    file_ = file_util::OpenFile(path_, "w+b");
+    if (!IsValid()) {
+      LOG(ERROR) << "Failed to open performance trace file: " << path_.value();
+      return;
+    }
+    LOG(INFO) << "Logging performance trace to file: " << path_.value();
+    if (compress_) {
+      memset(&stream_, 0, sizeof(stream_));
+      // 15 window bits plus 16 selects the gzip wrapper, so the output is
+      // a regular .gz file.
+      int result = deflateInit2(&stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                                15 + 16, 8, Z_DEFAULT_STRATEGY);
+      if (result != Z_OK) {
+        LOG(ERROR) << "deflateInit2() failed: " << result;
+        CloseFile();
+        return;
+      }
+      compressor_ready_ = true;
+    }
+    if (format_ == TraceSubscriberStdio::FORMAT_JSON) {
       trace_buffer_.SetOutputCallback(
           base::Bind(&TraceSubscriberStdioImpl::Write, this));
       trace_buffer_.Start();
-    } else {
-      LOG(ERROR) << "Failed to open performance trace file: " << path_.value();
     }
   }
 
   void OnData(const scoped_refptr<base::RefCountedString>& data_ptr) {
-    trace_buffer_.AddFragment(data_ptr->data());
+    if (format_ == TraceSubscriberStdio::FORMAT_JSON)
+      trace_buffer_.AddFragment(data_ptr->data());
+    else
+      Write(data_ptr->data());
   }
 
   void OnEnd() {
-    trace_buffer_.Finish();
+    if (format_ == TraceSubscriberStdio::FORMAT_JSON)
+      trace_buffer_.Finish();
+    if (compressor_ready_) {
+      // Flush whatever deflate is still holding and write the gzip
+      // trailer.
+      Compress(std::string(), Z_FINISH);
+      deflateEnd(&stream_);
+      compressor_ready_ = false;
+    }
     CloseFile();
   }
 
@@ -46,6 +88,10 @@ class TraceSubscriberStdioImpl
   friend class base::RefCountedThreadSafe<TraceSubscriberStdioImpl>;
 
   ~TraceSubscriberStdioImpl() {
+    if (compressor_ready_) {
+      deflateEnd(&stream_);
+      compressor_ready_ = false;
+    }
     CloseFile();
   }
 
@@ -61,22 +107,66 @@ class TraceSubscriberStdioImpl
   }
 
   void Write(const std::string& output_str) {
-    if (IsValid()) {
-      size_t written = fwrite(output_str.data(), 1, output_str.size(), file_);
-      if (written != output_str.size()) {
-        LOG(ERROR) << "Error " << ferror(file_) << " in fwrite() to trace file";
+    if (compress_) {
+      if (compressor_ready_)
+        Compress(output_str, Z_NO_FLUSH);
+      return;
+    }
+    WriteRaw(output_str.data(), output_str.size());
+  }
+
+  // Runs |input| through deflate and writes whatever output it produces.
+  // Only a fixed-size buffer of compressed data is ever held in memory.
+  void Compress(const std::string& input, int flush_mode) {
+    char buffer[kCompressBufferSize];
+    stream_.next_in =
+        reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream_.avail_in = input.size();
+    do {
+      stream_.next_out = reinterpret_cast<Bytef*>(buffer);
+      stream_.avail_out = sizeof(buffer);
+      int result = deflate(&stream_, flush_mode);
+      if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+        LOG(ERROR) << "deflate() failed: " << result;
+        deflateEnd(&stream_);
+        compressor_ready_ = false;
         CloseFile();
+        return;
       }
+      WriteRaw(buffer, sizeof(buffer) - stream_.avail_out);
+    } while (stream_.avail_out == 0);
+  }
+
+  void WriteRaw(const char* data, size_t size) {
+    if (!IsValid() || !size)
+      return;
+    size_t written = fwrite(data, 1, size, file_);
+    if (written != size) {
+      LOG(ERROR) << "Error " << ferror(file_) << " in fwrite() to trace file";
+      CloseFile();
     }
   }
 
   FilePath path_;
   FILE* file_;
   base::debug::TraceResultBuffer trace_buffer_;
+  TraceSubscriberStdio::Format format_;
+  bool compress_;
+  bool compressor_ready_;
+  z_stream stream_;
 };
 
 TraceSubscriberStdio::TraceSubscriberStdio(const FilePath& path)
-    : impl_(new TraceSubscriberStdioImpl(path)) {
+    : impl_(new TraceSubscriberStdioImpl(path, FORMAT_JSON, false)) {
+  BrowserThread::PostBlockingPoolSequencedTask(
+      __FILE__, FROM_HERE,
+      base::Bind(&TraceSubscriberStdioImpl::OnStart, impl_.get()));
+}
+
+TraceSubscriberStdio::TraceSubscriberStdio(const FilePath& path,
+                                           Format format,
+                                           bool compress)
+    : impl_(new TraceSubscriberStdioImpl(path, format, compress)) {
   BrowserThread::PostBlockingPoolSequencedTask(
       __FILE__, FROM_HERE,
       base::Bind(&TraceSubscriberStdioImpl::OnStart, impl_.get()));
@@ -21,8 +21,22 @@ class TraceSubscriberStdioImpl;
 class CONTENT_EXPORT TraceSubscriberStdio
     : NON_EXPORTED_BASE(public content::TraceSubscriber) {
  public:
+  enum Format {
+    // Wrap the JSON fragments delivered by TraceLog into a JSON array.
+    FORMAT_JSON,
+    // Write the fragments to the file untouched.  Use this when TraceLog
+    // is in OUTPUT_BINARY mode; the records are converted to JSON offline.
+    FORMAT_RAW
+  };
+
   // Creates or overwrites the specified file. Check IsValid() for success.
   explicit TraceSubscriberStdio(const FilePath& path);
+
+  // As above. If |compress| is true the output is gzipped as it is
+  // written, chunk by chunk, so arbitrarily long traces are exported with
+  // bounded memory.
+  TraceSubscriberStdio(const FilePath& path, Format format, bool compress);
+
   virtual ~TraceSubscriberStdio();
 
   // Implementation of TraceSubscriber
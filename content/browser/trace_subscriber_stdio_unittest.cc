@@ -33,3 +33,28 @@ TEST_F(TraceSubscriberStdioTest, CanWriteDataToFile) {
   EXPECT_TRUE(file_util::ReadFileToString(trace_file, &result));
   EXPECT_EQ("[foo,bar]", result);
 }
+
+TEST_F(TraceSubscriberStdioTest, CompressesDataToGzipFile) {
+  ScopedTempDir trace_dir;
+  ASSERT_TRUE(trace_dir.CreateUniqueTempDir());
+  FilePath trace_file(trace_dir.path().AppendASCII("trace.gz"));
+  {
+    content::TraceSubscriberStdio subscriber(
+        trace_file, content::TraceSubscriberStdio::FORMAT_JSON, true);
+
+    std::string foo("foo");
+    subscriber.OnTraceDataCollected(
+        make_scoped_refptr(base::RefCountedString::TakeString(&foo)));
+
+    subscriber.OnEndTracingComplete();
+  }
+  content::BrowserThread::GetBlockingPool()->FlushForTesting();
+  std::string result;
+  EXPECT_TRUE(file_util::ReadFileToString(trace_file, &result));
+  // The file must carry the gzip stream magic and a finished trailer
+  // rather than the raw JSON.
+  ASSERT_GE(result.size(), 2u);
+  EXPECT_EQ(0x1f, static_cast<unsigned char>(result[0]));
+  EXPECT_EQ(0x8b, static_cast<unsigned char>(result[1]));
+  EXPECT_EQ(std::string::npos, result.find("[foo]"));
+}
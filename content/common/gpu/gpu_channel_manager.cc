@@ -7,10 +7,24 @@
 #include "base/bind.h"
 #include "content/common/child_thread.h"
 #include "content/common/gpu/gpu_channel.h"
+#include "content/common/gpu/gpu_command_buffer_stub.h"
 #include "content/common/gpu/gpu_messages.h"
 #include "content/common/gpu/gpu_memory_manager.h"
 #include "ui/gfx/gl/gl_share_group.h"
 
+namespace {
+
+// Time slices for command processing, by priority class. Compositor contexts
+// are frame critical so they get the longest slice; offscreen contexts
+// (WebGL, canvas) come next; hidden tabs get just enough to keep making
+// progress. Any context waits at most one slice of whichever context is
+// currently running before the thread is yielded back to the message loop.
+const int64 kVisibleSurfaceCommandBudgetMs = 8;
+const int64 kOffscreenCommandBudgetMs = 4;
+const int64 kHiddenSurfaceCommandBudgetMs = 2;
+
+}  // namespace
+
 GpuChannelManager::GpuChannelManager(ChildThread* gpu_child_thread,
                                      GpuWatchdog* watchdog,
                                      base::MessageLoopProxy* io_message_loop,
@@ -57,6 +71,15 @@ GpuChannel* GpuChannelManager::LookupChannel(int32 client_id) {
     return iter->second;
 }
 
+base::TimeDelta GpuChannelManager::GetCommandProcessingBudget(
+    GpuCommandBufferStubBase* stub) const {
+  if (!stub->has_surface_state())
+    return base::TimeDelta::FromMilliseconds(kOffscreenCommandBudgetMs);
+  if (stub->surface_state().visible)
+    return base::TimeDelta::FromMilliseconds(kVisibleSurfaceCommandBudgetMs);
+  return base::TimeDelta::FromMilliseconds(kHiddenSurfaceCommandBudgetMs);
+}
+
 void GpuChannelManager::AppendAllCommandBufferStubs(
     std::vector<GpuCommandBufferStubBase*>& stubs) {
   for (GpuChannelMap::const_iterator it = gpu_channels_.begin();
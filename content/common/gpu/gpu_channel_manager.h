@@ -10,6 +10,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/message_loop_proxy.h"
+#include "base/time.h"
 #include "build/build_config.h"
 #include "content/common/gpu/gpu_memory_manager.h"
 #include "ipc/ipc_channel.h"
@@ -78,6 +79,14 @@ class GpuChannelManager : public IPC::Channel::Listener,
 
   GpuChannel* LookupChannel(int32 client_id);
 
+  // Returns the time slice the given stub may spend processing commands
+  // before it has to yield to other contexts. Compositor contexts get the
+  // longest slice, offscreen contexts (WebGL, canvas) a shorter one, and
+  // hidden tabs just enough to make progress, which bounds how long a
+  // frame-critical context can be kept waiting by anyone else.
+  base::TimeDelta GetCommandProcessingBudget(
+      GpuCommandBufferStubBase* stub) const;
+
  private:
   // Message handlers.
   void OnEstablishChannel(int client_id, bool share_context);
@@ -252,6 +252,8 @@ void GpuCommandBufferStub::OnInitialize(
   scheduler_.reset(new gpu::GpuScheduler(command_buffer_.get(),
                                          decoder_.get(),
                                          decoder_.get()));
+  scheduler_->SetCommandProcessingBudget(
+      channel_->gpu_channel_manager()->GetCommandProcessingBudget(this));
 
   decoder_->set_engine(scheduler_.get());
 
@@ -573,6 +575,10 @@ void GpuCommandBufferStub::OnSetSurfaceVisible(bool visible) {
   DCHECK(surface_state_.get());
   surface_state_->visible = visible;
   surface_state_->last_used_time = base::TimeTicks::Now();
+  if (scheduler_.get()) {
+    scheduler_->SetCommandProcessingBudget(
+        channel_->gpu_channel_manager()->GetCommandProcessingBudget(this));
+  }
   channel_->gpu_channel_manager()->gpu_memory_manager()->ScheduleManage();
 }
 
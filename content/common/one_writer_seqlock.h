@@ -2,8 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#ifndef CONTENT_COMMON_GAMEPAD_SEQLOCK_H_
-#define CONTENT_COMMON_GAMEPAD_SEQLOCK_H_
+#ifndef CONTENT_COMMON_ONE_WRITER_SEQLOCK_H_
+#define CONTENT_COMMON_ONE_WRITER_SEQLOCK_H_
 
 #include "base/atomicops.h"
 #include "base/threading/platform_thread.h"
@@ -18,9 +18,9 @@ namespace content {
 //   http://www.concurrencykit.org/doc/ck_sequence.html
 // This implementation is based on ck_sequence.h from http://concurrencykit.org.
 //
-// Currently, this is used in only one location. It may make sense to
-// generalize with a higher-level construct that owns both the lock and the
-// data buffer, if it is to be used more widely.
+// For the common case of a fixed-size payload in shared memory, see
+// SharedMemorySeqLockBuffer and SharedMemorySeqLockReader, which own both the
+// lock and the data and implement the copy-then-validate read loop.
 //
 // You must be very careful not to operate on potentially inconsistent read
 // buffers. If the read must be retry'd, the data in the read buffer could
@@ -28,9 +28,9 @@ namespace content {
 // garbage, or indices could be out of range. Probably the only suitable thing
 // to do during the read loop is to make a copy of the data, and operate on it
 // only after the read was found to be consistent.
-class CONTENT_EXPORT GamepadSeqLock {
+class CONTENT_EXPORT OneWriterSeqLock {
  public:
-  GamepadSeqLock();
+  OneWriterSeqLock();
   base::subtle::Atomic32 ReadBegin();
   bool ReadRetry(base::subtle::Atomic32 version);
   void WriteBegin();
@@ -38,9 +38,9 @@ class CONTENT_EXPORT GamepadSeqLock {
 
  private:
   base::subtle::Atomic32 sequence_;
-  DISALLOW_COPY_AND_ASSIGN(GamepadSeqLock);
+  DISALLOW_COPY_AND_ASSIGN(OneWriterSeqLock);
 };
 
 }  // namespace content
 
-#endif  // CONTENT_COMMON_GAMEPAD_SEQLOCK_H_
+#endif  // CONTENT_COMMON_ONE_WRITER_SEQLOCK_H_
@@ -30,6 +30,9 @@ using content::LocalTimeTicks;
 using content::RemoteTimeDelta;
 using content::RemoteTimeTicks;
 
+// static
+const int ResourceDispatcher::kDataAckBatchSize = 5;
+
 // Each resource request is assigned an ID scoped to this process.
 static int MakeRequestID() {
   // NOTE: The resource_dispatcher_host also needs probably unique
@@ -387,17 +390,28 @@ void ResourceDispatcher::OnReceivedData(const IPC::Message& message,
                                         base::SharedMemoryHandle shm_handle,
                                         int data_len,
                                         int encoded_data_length) {
-  // Acknowledge the reception of this data.
-  message_sender()->Send(
-      new ResourceHostMsg_DataReceived_ACK(message.routing_id(), request_id));
-
   const bool shm_valid = base::SharedMemory::IsHandleValid(shm_handle);
   DCHECK((shm_valid && data_len > 0) || (!shm_valid && !data_len));
   base::SharedMemory shared_mem(shm_handle, true);  // read only
 
   PendingRequestInfo* request_info = GetPendingRequestInfo(request_id);
-  if (!request_info)
+  if (!request_info) {
+    // The request was canceled on this side; keep draining the browser's
+    // pending data count so it does not stay paused until the cancel
+    // message arrives.
+    message_sender()->Send(new ResourceHostMsg_DataReceived_ACK(
+        message.routing_id(), request_id, 1));
     return;
+  }
+
+  // Acknowledge the reception of this data in batches, so fast transfers
+  // are not throttled by one ACK round trip per chunk.
+  if (++request_info->unacked_data_messages >= kDataAckBatchSize) {
+    message_sender()->Send(new ResourceHostMsg_DataReceived_ACK(
+        message.routing_id(), request_id,
+        request_info->unacked_data_messages));
+    request_info->unacked_data_messages = 0;
+  }
 
   if (data_len > 0 && shared_mem.Map(data_len)) {
     const char* data = static_cast<char*>(shared_mem.memory());
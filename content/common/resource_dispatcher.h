@@ -30,6 +30,12 @@ struct ResourceResponseHead;
 // the child process.  It can be used from any child process.
 class CONTENT_EXPORT ResourceDispatcher : public IPC::Channel::Listener {
  public:
+  // How many DataReceived messages we process before acknowledging them to
+  // the browser with a single batched ACK.  Must be small enough relative to
+  // the browser's pending data message limit that a paused request is always
+  // acknowledged (and therefore resumed) eventually.
+  static const int kDataAckBatchSize;
+
   explicit ResourceDispatcher(IPC::Message::Sender* sender);
   virtual ~ResourceDispatcher();
 
@@ -73,13 +79,14 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Channel::Listener {
 
   typedef std::deque<IPC::Message*> MessageQueue;
   struct PendingRequestInfo {
-    PendingRequestInfo() { }
+    PendingRequestInfo() : unacked_data_messages(0) { }
     PendingRequestInfo(webkit_glue::ResourceLoaderBridge::Peer* peer,
                        ResourceType::Type resource_type,
                        const GURL& request_url)
         : peer(peer),
           resource_type(resource_type),
           is_deferred(false),
+          unacked_data_messages(0),
           url(request_url),
           request_start(base::TimeTicks::Now()) {
     }
@@ -88,6 +95,9 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Channel::Listener {
     ResourceType::Type resource_type;
     MessageQueue deferred_message_queue;
     bool is_deferred;
+    // Number of DataReceived messages processed but not yet acknowledged to
+    // the browser; acknowledged in batches of kDataAckBatchSize.
+    int unacked_data_messages;
     GURL url;
     linked_ptr<IPC::Message> pending_redirect_message;
     base::TimeTicks request_start;
@@ -122,29 +122,37 @@ class ResourceDispatcherTest : public testing::Test,
       response.charset = test_page_charset;
       dispatcher_->OnReceivedResponse(request_id, response);
 
-      // received data message with the test contents
-      base::SharedMemory shared_mem;
-      EXPECT_TRUE(shared_mem.CreateAndMapAnonymous(test_page_contents_len));
-      char* put_data_here = static_cast<char*>(shared_mem.memory());
-      memcpy(put_data_here, test_page_contents, test_page_contents_len);
-      base::SharedMemoryHandle dup_handle;
-      EXPECT_TRUE(shared_mem.GiveToProcess(
-          base::Process::Current().handle(), &dup_handle));
-      dispatcher_->OnReceivedData(
-          message_queue_[0],
-          request_id,
-          dup_handle,
-          test_page_contents_len,
-          test_page_contents_len);
+      // received data messages with the test contents; the dispatcher only
+      // acknowledges them once a full batch has been processed.
+      for (int i = 0; i < ResourceDispatcher::kDataAckBatchSize; ++i) {
+        base::SharedMemory shared_mem;
+        EXPECT_TRUE(shared_mem.CreateAndMapAnonymous(test_page_contents_len));
+        char* put_data_here = static_cast<char*>(shared_mem.memory());
+        memcpy(put_data_here, test_page_contents, test_page_contents_len);
+        base::SharedMemoryHandle dup_handle;
+        EXPECT_TRUE(shared_mem.GiveToProcess(
+            base::Process::Current().handle(), &dup_handle));
+
+        // No ack should be sent until the batch is complete.
+        EXPECT_EQ(1U, message_queue_.size());
+
+        dispatcher_->OnReceivedData(
+            message_queue_[0],
+            request_id,
+            dup_handle,
+            test_page_contents_len,
+            test_page_contents_len);
+      }
 
       message_queue_.erase(message_queue_.begin());
 
-      // read the ack message.
-      Tuple1<int> request_ack;
+      // read the batched ack message.
+      Tuple2<int, int> request_ack;
       ASSERT_TRUE(ResourceHostMsg_DataReceived_ACK::Read(
           &message_queue_[0], &request_ack));
 
       ASSERT_EQ(request_ack.a, request_id);
+      ASSERT_EQ(request_ack.b, ResourceDispatcher::kDataAckBatchSize);
 
       message_queue_.erase(message_queue_.begin());
     }
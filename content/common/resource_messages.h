@@ -206,10 +206,12 @@ IPC_SYNC_MESSAGE_ROUTED2_1(ResourceHostMsg_SyncLoad,
                            ResourceHostMsg_Request,
                            content::SyncLoadResult)
 
-// Sent when the renderer process is done processing a DataReceived
-// message.
-IPC_MESSAGE_ROUTED1(ResourceHostMsg_DataReceived_ACK,
-                    int /* request_id */)
+// Sent when the renderer process is done processing DataReceived
+// messages.  A single ACK may cover several DataReceived messages;
+// |count| says how many.
+IPC_MESSAGE_ROUTED2(ResourceHostMsg_DataReceived_ACK,
+                    int /* request_id */,
+                    int /* count */)
 
 // Sent when the renderer has processed a DataDownloaded message.
 IPC_MESSAGE_ROUTED1(ResourceHostMsg_DataDownloaded_ACK,
@@ -0,0 +1,33 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_COMMON_SHARED_MEMORY_SEQLOCK_BUFFER_H_
+#define CONTENT_COMMON_SHARED_MEMORY_SEQLOCK_BUFFER_H_
+#pragma once
+
+#include "content/common/one_writer_seqlock.h"
+
+namespace content {
+
+// A shared memory region holding one high-frequency, small, fixed-size
+// payload, produced by a single writer and sampled by any number of readers
+// without IPC round trips. The writer brackets each update with
+// sequence.WriteBegin()/WriteEnd(); readers should use
+// SharedMemorySeqLockReader, which implements the copy-then-validate loop.
+//
+// |Data| must be plain-old-data: both sides memcpy it, and since the buffer
+// lives in memory shared between processes it must not contain pointers,
+// handles, or anything with a constructor that matters. Both sides compile
+// the same Data definition, so the layout is validated at compile time.
+template <typename Data>
+struct SharedMemorySeqLockBuffer {
+  OneWriterSeqLock sequence;
+  Data data;
+
+  SharedMemorySeqLockBuffer() {}
+};
+
+}  // namespace content
+
+#endif  // CONTENT_COMMON_SHARED_MEMORY_SEQLOCK_BUFFER_H_
@@ -0,0 +1,85 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_COMMON_SHARED_MEMORY_SEQLOCK_READER_H_
+#define CONTENT_COMMON_SHARED_MEMORY_SEQLOCK_READER_H_
+#pragma once
+
+#include <string.h>
+
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/shared_memory.h"
+#include "content/common/shared_memory_seqlock_buffer.h"
+
+namespace content {
+
+// Consumer side of a SharedMemorySeqLockBuffer. Maps the region produced by
+// the writer and samples the latest payload on demand. The whole payload is
+// copied out first and the sequence validated once afterwards, so readers
+// never operate on a torn Data; on failure the output is left untouched.
+template <typename Data>
+class SharedMemorySeqLockReader {
+ public:
+  SharedMemorySeqLockReader() : buffer_(NULL) {}
+  ~SharedMemorySeqLockReader() {}
+
+  // Maps |handle| read-only. Returns false if the handle is invalid or the
+  // region cannot be mapped, in which case TryRead must not be called.
+  bool Initialize(const base::SharedMemoryHandle& handle) {
+    if (!base::SharedMemory::IsHandleValid(handle))
+      return false;
+    shared_memory_.reset(new base::SharedMemory(handle, true));
+    if (!shared_memory_->Map(sizeof(SharedMemorySeqLockBuffer<Data>)))
+      return false;
+    buffer_ = static_cast<SharedMemorySeqLockBuffer<Data>*>(
+        shared_memory_->memory());
+    return buffer_ != NULL;
+  }
+
+  bool is_initialized() const { return buffer_ != NULL; }
+
+  // Copies the latest consistent payload into |data|. Returns false, leaving
+  // |data| untouched, if the writer kept invalidating the read; this bounds
+  // the time spent here when contending with a stalled or busy writer. If
+  // |contention_count| is non-NULL it receives the number of retries, for
+  // callers that track contention histograms.
+  bool TryRead(Data* data, int* contention_count) {
+    DCHECK(buffer_);
+
+    // Only try to read this many times before failing, to avoid waiting here
+    // very long in case of contention with the writer.
+    const int kMaximumContentionCount = 10;
+
+    Data read_into;
+    int attempts = -1;
+    base::subtle::Atomic32 version;
+    do {
+      version = buffer_->sequence.ReadBegin();
+      memcpy(&read_into, &buffer_->data, sizeof(read_into));
+      ++attempts;
+      if (attempts == kMaximumContentionCount)
+        break;
+    } while (buffer_->sequence.ReadRetry(version));
+
+    if (contention_count)
+      *contention_count = attempts;
+
+    if (attempts >= kMaximumContentionCount)
+      return false;
+
+    memcpy(data, &read_into, sizeof(*data));
+    return true;
+  }
+
+ private:
+  scoped_ptr<base::SharedMemory> shared_memory_;
+  SharedMemorySeqLockBuffer<Data>* buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedMemorySeqLockReader);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_COMMON_SHARED_MEMORY_SEQLOCK_READER_H_
@@ -1166,6 +1166,11 @@ IPC_MESSAGE_ROUTED3(ViewMsg_PpapiBrokerChannelCreated,
 IPC_MESSAGE_CONTROL1(ViewMsg_PurgePluginListCache,
                      bool /* reload_pages */)
 
+// Tells the renderer to release memory it can do without (free malloc pages,
+// idle V8 garbage). Sent to processes that have been in the background for a
+// long time.
+IPC_MESSAGE_CONTROL0(ViewMsg_ReleaseFreeMemory)
+
 // Sent to the renderer when a popup window should no longer count against
 // the current popup count (either because it's not a popup or because it was
 // a generated by a user action).
@@ -209,6 +209,13 @@ class CONTENT_EXPORT BrowserThread {
   // down.
   static bool IsMessageLoopValid(ID identifier);
 
+  // Callable on any thread.  Returns the approximate number of tasks posted
+  // through BrowserThread that have not yet started running on the given
+  // thread, including delayed tasks that are not yet due.  Intended for
+  // lightweight saturation monitoring; tasks posted directly to the thread's
+  // MessageLoop are not counted.
+  static int GetPendingTaskCount(ID identifier);
+
   // If the current message loop is one of the known threads, returns true and
   // sets identifier to its ID.  Otherwise returns false.
   static bool GetCurrentThreadIdentifier(ID* identifier);
@@ -107,6 +107,11 @@ class CONTENT_EXPORT RenderWidgetHost : public IPC::Channel::Sender {
   // Free all backing stores used for rendering to drop memory usage.
   static void RemoveAllBackingStores();
 
+  // Free backing stores until they fit in half their normal memory budget,
+  // keeping the most recently used ones. Intended for reacting to system
+  // memory pressure; gentler than RemoveAllBackingStores().
+  static void ReduceBackingStoreMemory();
+
   // Returns the size of all the backing stores used for rendering
   static size_t BackingStoreMemorySize();
 
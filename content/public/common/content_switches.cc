@@ -560,6 +560,17 @@ const char kTraceStartupFile[]              = "trace-startup-file";
 // --startup-trace-file=none was supplied.
 const char kTraceStartupDuration[]          = "trace-startup-duration";
 
+// Gzips the startup trace file as it is written, so long traces stay
+// small on disk. Has no effect without --trace-startup, or if
+// --trace-startup-file=none was supplied.
+const char kTraceStartupCompress[]          = "trace-startup-compress";
+
+// Selects the startup trace record format. The default is "json"; "binary"
+// writes compact binary records that serialize faster and are converted to
+// JSON offline, allowing much longer capture windows. Has no effect
+// without --trace-startup, or if --trace-startup-file=none was supplied.
+const char kTraceStartupFormat[]            = "trace-startup-format";
+
 // Enables the use of the GPU process for UI. Only meaningful for Aura.
 const char kUIUseGPUProcess[]               = "ui-use-gpu-process";
 
@@ -170,6 +170,8 @@ CONTENT_EXPORT extern const char kTestSandbox[];
 extern const char kTraceStartup[];
 extern const char kTraceStartupFile[];
 extern const char kTraceStartupDuration[];
+extern const char kTraceStartupCompress[];
+extern const char kTraceStartupFormat[];
 extern const char kUIUseGPUProcess[];
 CONTENT_EXPORT extern const char kUserAgent[];
 extern const char kUtilityCmdPrefix[];
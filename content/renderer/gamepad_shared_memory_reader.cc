@@ -8,55 +8,37 @@
 #include "base/metrics/histogram.h"
 #include "content/common/gamepad_messages.h"
 #include "content/public/renderer/render_thread.h"
-#include "content/common/gamepad_hardware_buffer.h"
 #include "ipc/ipc_sync_message_filter.h"
 
 namespace content {
 
 GamepadSharedMemoryReader::GamepadSharedMemoryReader() {
   memset(ever_interacted_with_, 0, sizeof(ever_interacted_with_));
+  base::SharedMemoryHandle renderer_shared_memory_handle;
   CHECK(RenderThread::Get()->Send(new GamepadHostMsg_StartPolling(
-      &renderer_shared_memory_handle_)));
+      &renderer_shared_memory_handle)));
   // If we don't get a valid handle from the browser, don't try to Map (we're
   // probably out of memory or file handles).
   bool valid_handle = base::SharedMemory::IsHandleValid(
-      renderer_shared_memory_handle_);
+      renderer_shared_memory_handle);
   UMA_HISTOGRAM_BOOLEAN("Gamepad.ValidSharedMemoryHandle", valid_handle);
   if (!valid_handle)
     return;
-  renderer_shared_memory_.reset(
-      new base::SharedMemory(renderer_shared_memory_handle_, true));
-  CHECK(renderer_shared_memory_->Map(sizeof(GamepadHardwareBuffer)));
-  void *memory = renderer_shared_memory_->memory();
-  CHECK(memory);
-  gamepad_hardware_buffer_ =
-      static_cast<GamepadHardwareBuffer*>(memory);
+  CHECK(reader_.Initialize(renderer_shared_memory_handle));
 }
 
 void GamepadSharedMemoryReader::SampleGamepads(WebKit::WebGamepads& gamepads) {
   WebKit::WebGamepads read_into;
   TRACE_EVENT0("GAMEPAD", "SampleGamepads");
 
-  if (!base::SharedMemory::IsHandleValid(renderer_shared_memory_handle_))
+  if (!reader_.is_initialized())
     return;
 
-  // Only try to read this many times before failing to avoid waiting here
-  // very long in case of contention with the writer. TODO(scottmg) Tune this
-  // number (as low as 1?) if histogram shows distribution as mostly
-  // 0-and-maximum.
-  const int kMaximumContentionCount = 10;
-  int contention_count = -1;
-  base::subtle::Atomic32 version;
-  do {
-    version = gamepad_hardware_buffer_->sequence.ReadBegin();
-    memcpy(&read_into, &gamepad_hardware_buffer_->buffer, sizeof(read_into));
-    ++contention_count;
-    if (contention_count == kMaximumContentionCount)
-      break;
-  } while (gamepad_hardware_buffer_->sequence.ReadRetry(version));
+  int contention_count = 0;
+  bool read_ok = reader_.TryRead(&read_into, &contention_count);
   UMA_HISTOGRAM_COUNTS("Gamepad.ReadContentionCount", contention_count);
 
-  if (contention_count >= kMaximumContentionCount) {
+  if (!read_ok) {
       // We failed to successfully read, presumably because the hardware
       // thread was taking unusually long. Don't copy the data to the output
       // buffer, and simply leave what was there before.
@@ -5,14 +5,11 @@
 #ifndef GAMEPAD_UTIL_H_
 #define GAMEPAD_UTIL_H_
 
-#include "base/shared_memory.h"
-#include "base/memory/scoped_ptr.h"
+#include "content/common/shared_memory_seqlock_reader.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/platform/WebGamepads.h"
 
 namespace content {
 
-struct GamepadHardwareBuffer;
-
 class GamepadSharedMemoryReader {
  public:
   GamepadSharedMemoryReader();
@@ -20,9 +17,7 @@ class GamepadSharedMemoryReader {
   void SampleGamepads(WebKit::WebGamepads&);
 
  private:
-  base::SharedMemoryHandle renderer_shared_memory_handle_;
-  scoped_ptr<base::SharedMemory> renderer_shared_memory_;
-  GamepadHardwareBuffer* gamepad_hardware_buffer_;
+  SharedMemorySeqLockReader<WebKit::WebGamepads> reader_;
 
   bool ever_interacted_with_[WebKit::WebGamepads::itemsLengthCap];
 };
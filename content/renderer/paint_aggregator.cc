@@ -38,6 +38,13 @@ static const size_t kMaxPaintRects = 5;
 // paint rects exceeds this threshold, then we will combine the paint rects.
 static const float kMaxPaintRectsAreaRatio = 0.7f;
 
+// Disjoint paint rects are merged if the extra area pulled in by their
+// bounding box is no larger than this.  Deciding what to paint for a rect
+// costs WebKit a fixed amount of work regardless of the rect's size, so for
+// small neighboring rects it is cheaper to paint a few extra pixels once than
+// to pay that setup cost for each rect.
+static const int kRectSetupCostEquivalentArea = 32 * 32;
+
 PaintAggregator::PendingUpdate::PendingUpdate() {}
 
 PaintAggregator::PendingUpdate::~PendingUpdate() {}
@@ -118,9 +125,13 @@ void PaintAggregator::InvalidateRect(const gfx::Rect& rect) {
     const gfx::Rect& existing_rect = update_.paint_rects[i];
     if (existing_rect.Contains(rect))  // Optimize out redundancy.
       return;
-    if (rect.Intersects(existing_rect) || rect.SharesEdgeWith(existing_rect)) {
+    gfx::Rect combined_rect = existing_rect.Union(rect);
+    int wasted_area = combined_rect.size().GetArea() -
+                      existing_rect.size().GetArea() -
+                      rect.size().GetArea();
+    if (rect.Intersects(existing_rect) || rect.SharesEdgeWith(existing_rect) ||
+        wasted_area <= kRectSetupCostEquivalentArea) {
       // Re-invalidate in case the union intersects other paint rects.
-      gfx::Rect combined_rect = existing_rect.Union(rect);
       update_.paint_rects.erase(update_.paint_rects.begin() + i);
       InvalidateRect(combined_rect);
       return;
@@ -71,6 +71,30 @@ TEST(PaintAggregator, DisjointInvalidationsCombined) {
   EXPECT_EQ(expected_bounds, update.paint_rects[0]);
 }
 
+TEST(PaintAggregator, NearbySmallRectsCombined) {
+  PaintAggregator greg;
+
+  // Two small disjoint rects a few pixels apart.  Their bounding box adds
+  // less area than a second per-rect paint setup is worth, so they should be
+  // merged into a single paint rect.
+  gfx::Rect r1(10, 10, 10, 10);
+  gfx::Rect r2(25, 10, 10, 10);
+
+  greg.InvalidateRect(r1);
+  greg.InvalidateRect(r2);
+
+  gfx::Rect expected_bounds = r1.Union(r2);
+
+  EXPECT_TRUE(greg.HasPendingUpdate());
+  PaintAggregator::PendingUpdate update;
+  greg.PopPendingUpdate(&update);
+
+  EXPECT_TRUE(update.scroll_rect.IsEmpty());
+  ASSERT_EQ(1U, update.paint_rects.size());
+
+  EXPECT_EQ(expected_bounds, update.paint_rects[0]);
+}
+
 TEST(PaintAggregator, SingleScroll) {
   PaintAggregator greg;
 
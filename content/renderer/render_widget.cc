@@ -74,6 +74,13 @@ using content::RenderThread;
 
 namespace {
 
+// The maximum wall-clock time to spend painting a single software update.
+// When a batch of paint rects blows past this budget, the rects we have not
+// gotten to yet are handed back to the PaintAggregator and painted in a
+// follow-up update, keeping the message loop (and input handling) responsive
+// during heavy invalidation storms.
+const int kMaxPaintTimeMs = 50;
+
 bool CanSendMessageWhileClosing(const IPC::Message* msg) {
   // We filter out most IPC messages when closing. However, some are
   // important for allowing pepper plugins to update their unsaved state
@@ -976,8 +983,26 @@ void RenderWidget::DoDeferredUpdate() {
     if (!scroll_damage.IsEmpty())
       copy_rects.push_back(scroll_damage);
 
-    for (size_t i = 0; i < copy_rects.size(); ++i)
+    // When there is no scroll, a large batch of paint rects may be sliced
+    // across several updates: rects that don't fit in this update's time
+    // budget go back to the aggregator and get painted when the browser ACKs
+    // this update (see OnUpdateRectAck).  Scrolling updates are never sliced
+    // since the scroll damage must be painted in the same update that moves
+    // the pixels.
+    bool can_defer_paint_rects = update.scroll_rect.IsEmpty();
+    base::TimeTicks paint_begin_ticks = base::TimeTicks::Now();
+    for (size_t i = 0; i < copy_rects.size(); ++i) {
       PaintRect(copy_rects[i], bounds.origin(), canvas.get());
+      if (can_defer_paint_rects && i + 1 < copy_rects.size() &&
+          base::TimeTicks::Now() - paint_begin_ticks >
+              base::TimeDelta::FromMilliseconds(kMaxPaintTimeMs)) {
+        TRACE_EVENT0("renderer", "PaintTimeBudgetExhausted");
+        for (size_t j = i + 1; j < copy_rects.size(); ++j)
+          paint_aggregator_.InvalidateRect(copy_rects[j]);
+        copy_rects.resize(i + 1);
+        break;
+      }
+    }
 
     // Software FPS tick for performance tests. The accelerated path traces the
     // frame events in didCommitAndDrawCompositorFrame. See throughput_tests.cc.
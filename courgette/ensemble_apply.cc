@@ -9,6 +9,7 @@
 #include "base/basictypes.h"
 #include "base/file_util.h"
 #include "base/logging.h"
+#include "base/scoped_temp_dir.h"
 
 #include "courgette/crc.h"
 #include "courgette/region.h"
@@ -53,6 +54,8 @@ class EnsemblePatchApplication {
                              SourceStream* correction,
                              SinkStream* corrected_ensemble);
 
+  Status ValidateOutput(const void* output, size_t size);
+
  private:
   Status SubpatchStreamSets(SinkStreamSet* predicted_items,
                             SourceStream* correction,
@@ -273,6 +276,15 @@ Status EnsemblePatchApplication::SubpatchFinalOutput(
   return C_OK;
 }
 
+Status EnsemblePatchApplication::ValidateOutput(const void* output,
+                                                size_t size) {
+  uint32 checksum = CalculateCrc(static_cast<const uint8*>(output), size);
+  if (target_checksum_ != checksum)
+    return C_BAD_ENSEMBLE_CRC;
+
+  return C_OK;
+}
+
 Status EnsemblePatchApplication::SubpatchStreamSets(
     SinkStreamSet* predicted_items,
     SourceStream* correction,
@@ -298,66 +310,78 @@ Status EnsemblePatchApplication::SubpatchStreamSets(
   return C_OK;
 }
 
-Status ApplyEnsemblePatch(SourceStream* base,
-                          SourceStream* patch,
-                          SinkStream* output) {
-  Status status;
-  EnsemblePatchApplication patch_process;
-
-  status = patch_process.ReadHeader(patch);
+// Runs the transformation stages of |patch_process| over the patch
+// sub-streams, building |prediction|: the bytes of the original ensemble
+// followed by the corrected base elements.  The final correction in
+// |patch_streams| stream 3 is applied to |prediction| by the caller to
+// produce the new ensemble.
+static Status BuildPredictedEnsemble(EnsemblePatchApplication* patch_process,
+                                     SourceStreamSet* patch_streams,
+                                     SinkStream* prediction) {
+  SourceStream* transformation_descriptions     = patch_streams->stream(0);
+  SourceStream* parameter_correction            = patch_streams->stream(1);
+  SourceStream* transformed_elements_correction = patch_streams->stream(2);
+
+  Status status =
+      patch_process->ReadInitialParameters(transformation_descriptions);
   if (status != C_OK)
     return status;
 
-  status = patch_process.InitBase(Region(base->Buffer(), base->Remaining()));
+  SinkStreamSet predicted_parameters;
+  status = patch_process->PredictTransformParameters(&predicted_parameters);
   if (status != C_OK)
     return status;
 
-  status = patch_process.ValidateBase();
+  SourceStreamSet corrected_parameters;
+  status = patch_process->SubpatchTransformParameters(&predicted_parameters,
+                                                      parameter_correction,
+                                                      &corrected_parameters);
   if (status != C_OK)
     return status;
 
-  // The rest of the patch stream is a StreamSet.
-  SourceStreamSet patch_streams;
-  patch_streams.Init(patch);
-
-  SourceStream* transformation_descriptions     = patch_streams.stream(0);
-  SourceStream* parameter_correction            = patch_streams.stream(1);
-  SourceStream* transformed_elements_correction = patch_streams.stream(2);
-  SourceStream* ensemble_correction             = patch_streams.stream(3);
-
-  status = patch_process.ReadInitialParameters(transformation_descriptions);
+  SinkStreamSet transformed_elements;
+  status = patch_process->TransformUp(&corrected_parameters,
+                                      &transformed_elements);
   if (status != C_OK)
     return status;
 
-  SinkStreamSet predicted_parameters;
-  status = patch_process.PredictTransformParameters(&predicted_parameters);
+  SourceStreamSet corrected_transformed_elements;
+  status = patch_process->SubpatchTransformedElements(
+          &transformed_elements,
+          transformed_elements_correction,
+          &corrected_transformed_elements);
   if (status != C_OK)
     return status;
 
-  SourceStreamSet corrected_parameters;
-  status = patch_process.SubpatchTransformParameters(&predicted_parameters,
-                                                     parameter_correction,
-                                                     &corrected_parameters);
+  return patch_process->TransformDown(&corrected_transformed_elements,
+                                      prediction);
+}
+
+Status ApplyEnsemblePatch(SourceStream* base,
+                          SourceStream* patch,
+                          SinkStream* output) {
+  Status status;
+  EnsemblePatchApplication patch_process;
+
+  status = patch_process.ReadHeader(patch);
   if (status != C_OK)
     return status;
 
-  SinkStreamSet transformed_elements;
-  status = patch_process.TransformUp(&corrected_parameters,
-                                     &transformed_elements);
+  status = patch_process.InitBase(Region(base->Buffer(), base->Remaining()));
   if (status != C_OK)
     return status;
 
-  SourceStreamSet corrected_transformed_elements;
-  status = patch_process.SubpatchTransformedElements(
-          &transformed_elements,
-          transformed_elements_correction,
-          &corrected_transformed_elements);
+  status = patch_process.ValidateBase();
   if (status != C_OK)
     return status;
 
+  // The rest of the patch stream is a StreamSet.
+  SourceStreamSet patch_streams;
+  patch_streams.Init(patch);
+
   SinkStream original_ensemble_and_corrected_base_elements;
-  status = patch_process.TransformDown(
-      &corrected_transformed_elements,
+  status = BuildPredictedEnsemble(
+      &patch_process, &patch_streams,
       &original_ensemble_and_corrected_base_elements);
   if (status != C_OK)
     return status;
@@ -365,7 +389,7 @@ Status ApplyEnsemblePatch(SourceStream* base,
   SourceStream final_patch_prediction;
   final_patch_prediction.Init(original_ensemble_and_corrected_base_elements);
   status = patch_process.SubpatchFinalOutput(&final_patch_prediction,
-                                             ensemble_correction, output);
+                                             patch_streams.stream(3), output);
   if (status != C_OK)
     return status;
 
@@ -375,51 +399,97 @@ Status ApplyEnsemblePatch(SourceStream* base,
 Status ApplyEnsemblePatch(const FilePath::CharType* old_file_name,
                           const FilePath::CharType* patch_file_name,
                           const FilePath::CharType* new_file_name) {
-  // First read enough of the patch file to validate the header is well-formed.
-  // A few varint32 numbers should fit in 100.
+  // The inputs, the intermediate prediction and the output are accessed
+  // through memory maps or written in small chunks, so peak heap usage is
+  // bounded by the transformation stages rather than by several whole-file
+  // buffers held at once.
   FilePath patch_file_path(patch_file_name);
   file_util::MemoryMappedFile patch_file;
   if (!patch_file.Initialize(patch_file_path))
     return C_READ_OPEN_ERROR;
 
-  // 'Dry-run' the first step of the patch process to validate format of header.
-  SourceStream patch_header_stream;
-  patch_header_stream.Init(patch_file.data(), patch_file.length());
+  SourceStream patch_source_stream;
+  patch_source_stream.Init(patch_file.data(), patch_file.length());
   EnsemblePatchApplication patch_process;
-  Status status = patch_process.ReadHeader(&patch_header_stream);
+  Status status = patch_process.ReadHeader(&patch_source_stream);
   if (status != C_OK)
     return status;
 
-  // Read the old_file.
+  // Map the old_file.
   FilePath old_file_path(old_file_name);
   file_util::MemoryMappedFile old_file;
   if (!old_file.Initialize(old_file_path))
     return C_READ_ERROR;
 
-  // Apply patch on streams.
-  SourceStream old_source_stream;
-  SourceStream patch_source_stream;
-  old_source_stream.Init(old_file.data(), old_file.length());
-  patch_source_stream.Init(patch_file.data(), patch_file.length());
-  SinkStream new_sink_stream;
-  status = ApplyEnsemblePatch(&old_source_stream, &patch_source_stream,
-                              &new_sink_stream);
+  status = patch_process.InitBase(Region(old_file.data(), old_file.length()));
   if (status != C_OK)
     return status;
 
-  // Write the patched data to |new_file_name|.
+  status = patch_process.ValidateBase();
+  if (status != C_OK)
+    return status;
+
+  // The rest of the patch stream is a StreamSet.
+  SourceStreamSet patch_streams;
+  if (!patch_streams.Init(&patch_source_stream))
+    return C_BAD_ENSEMBLE_HEADER;
+
+  SinkStream prediction;
+  status = BuildPredictedEnsemble(&patch_process, &patch_streams, &prediction);
+  if (status != C_OK)
+    return status;
+
+  // Spill the prediction to a temporary file and map it back in, releasing
+  // the heap copy.  The final subpatch seeks around the prediction, so it
+  // needs random access, but through the mapping that is provided by the
+  // page cache instead of by a heap buffer held alongside the output.
+  ScopedTempDir temp_dir;
+  file_util::MemoryMappedFile prediction_file;
+  SourceStream final_patch_prediction;
+  if (prediction.Length() != 0) {
+    if (!temp_dir.CreateUniqueTempDir())
+      return C_WRITE_OPEN_ERROR;
+    FilePath prediction_path;
+    if (!file_util::CreateTemporaryFileInDir(temp_dir.path(),
+                                             &prediction_path))
+      return C_WRITE_OPEN_ERROR;
+    int written = file_util::WriteFile(
+        prediction_path,
+        reinterpret_cast<const char*>(prediction.Buffer()),
+        static_cast<int>(prediction.Length()));
+    if (written == -1 || static_cast<size_t>(written) != prediction.Length())
+      return C_WRITE_ERROR;
+    prediction.Retire();
+
+    if (!prediction_file.Initialize(prediction_path))
+      return C_READ_ERROR;
+    final_patch_prediction.Init(prediction_file.data(),
+                                prediction_file.length());
+  }
+
+  // Write the new ensemble directly to |new_file_name|.
   FilePath new_file_path(new_file_name);
-  int written =
-      file_util::WriteFile(
-          new_file_path,
-          reinterpret_cast<const char*>(new_sink_stream.Buffer()),
-          static_cast<int>(new_sink_stream.Length()));
-  if (written == -1)
+  file_util::ScopedFILE new_file(file_util::OpenFile(new_file_path, "wb"));
+  if (!new_file.get())
     return C_WRITE_OPEN_ERROR;
-  if (static_cast<size_t>(written) != new_sink_stream.Length())
+
+  status = ApplySimpleDeltaToFile(&final_patch_prediction,
+                                  patch_streams.stream(3),
+                                  new_file.get());
+  if (status != C_OK)
+    return status;
+
+  if (!file_util::CloseFile(new_file.release()))
     return C_WRITE_ERROR;
 
-  return C_OK;
+  // Validate the checksum of the patched result through a mapping of the
+  // file just written.
+  file_util::MemoryMappedFile new_file_map;
+  if (!new_file_map.Initialize(new_file_path))
+    return C_READ_ERROR;
+
+  return patch_process.ValidateOutput(new_file_map.data(),
+                                      new_file_map.length());
 }
 
 }  // namespace
@@ -15,6 +15,11 @@ namespace courgette {
 Status ApplySimpleDelta(SourceStream* old, SourceStream* delta,
                         SinkStream* target);
 
+// As ApplySimpleDelta, but writes the result directly to |target| instead of
+// materializing it in memory.  |target| is not closed by this call.
+Status ApplySimpleDeltaToFile(SourceStream* old, SourceStream* delta,
+                              FILE* target);
+
 Status GenerateSimpleDelta(SourceStream* old, SourceStream* target,
                            SinkStream* delta);
 
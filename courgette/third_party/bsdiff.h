@@ -35,6 +35,8 @@
 #ifndef COURGETTE_BSDIFF_H_
 #define COURGETTE_BSDIFF_H_
 
+#include <stdio.h>  // for FILE*
+
 #include "base/basictypes.h"
 
 namespace courgette {
@@ -44,7 +46,8 @@ enum BSDiffStatus {
   MEM_ERROR = 1,
   CRC_ERROR = 2,
   READ_ERROR = 3,
-  UNEXPECTED_ERROR = 4
+  UNEXPECTED_ERROR = 4,
+  WRITE_ERROR = 5
 };
 
 class SourceStream;
@@ -64,6 +67,14 @@ BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
                               SourceStream* patch_stream,
                               SinkStream* new_stream);
 
+// As above, but writes the result directly to |new_file| instead of
+// materializing it in memory.  Output is buffered in small fixed-size chunks,
+// so peak memory use is independent of the size of the result.  |new_file|
+// is not closed or flushed to disk by this call.
+BSDiffStatus ApplyBinaryPatchToFile(SourceStream* old_stream,
+                                    SourceStream* patch_stream,
+                                    FILE* new_file);
+
 
 // The following declarations are common to the patch-creation and
 // patch-application code.
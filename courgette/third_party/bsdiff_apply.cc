@@ -34,6 +34,9 @@
 
 #include "courgette/third_party/bsdiff.h"
 
+#include <string.h>
+#include <algorithm>
+
 #include "courgette/crc.h"
 #include "courgette/streams.h"
 
@@ -54,10 +57,49 @@ BSDiffStatus MBS_ReadHeader(SourceStream* stream, MBSPatchHeader* header) {
   return OK;
 }
 
-BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
-                            SourceStream* patch_stream,
-                            const uint8* old_start, size_t old_size,
-                            SinkStream* new_stream) {
+// Accumulates output in a fixed-size buffer that is flushed to a FILE* when
+// full.  Implements the subset of the SinkStream interface used by
+// MBS_ApplyPatchToSink, so the patch loop can fill in the new file in memory
+// or directly on disk.
+class FileSink {
+ public:
+  explicit FileSink(FILE* file) : file_(file), used_(0) {}
+
+  CheckBool Reserve(size_t /*length*/) WARN_UNUSED_RESULT { return true; }
+
+  CheckBool Write(const void* data, size_t byte_count) WARN_UNUSED_RESULT {
+    const uint8* bytes = static_cast<const uint8*>(data);
+    while (byte_count > 0) {
+      if (used_ == sizeof(buffer_) && !Flush())
+        return false;
+      size_t count = std::min(byte_count, sizeof(buffer_) - used_);
+      memcpy(buffer_ + used_, bytes, count);
+      used_ += count;
+      bytes += count;
+      byte_count -= count;
+    }
+    return true;
+  }
+
+  CheckBool Flush() WARN_UNUSED_RESULT {
+    if (used_ > 0 && fwrite(buffer_, 1, used_, file_) != used_)
+      return false;
+    used_ = 0;
+    return true;
+  }
+
+ private:
+  FILE* file_;
+  uint8 buffer_[64 * 1024];
+  size_t used_;
+};
+
+template<class Sink>
+static BSDiffStatus MBS_ApplyPatchToSink(const MBSPatchHeader *header,
+                                         SourceStream* patch_stream,
+                                         const uint8* old_start,
+                                         size_t old_size,
+                                         Sink* new_stream) {
   const uint8* old_end = old_start + old_size;
 
   SourceStreamSet patch_streams;
@@ -71,10 +113,6 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
   SourceStream* diff_bytes = patch_streams.stream(4);
   SourceStream* extra_bytes = patch_streams.stream(5);
 
-  const uint8* extra_start = extra_bytes->Buffer();
-  const uint8* extra_end = extra_start + extra_bytes->Remaining();
-  const uint8* extra_position = extra_start;
-
   const uint8* old_position = old_start;
 
   if (header->dlen && !new_stream->Reserve(header->dlen))
@@ -121,13 +159,14 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
     old_position += copy_count;
 
     // Copy bytes from the extra block.
-    if (extra_count > static_cast<size_t>(extra_end - extra_position))
+    if (extra_count > extra_bytes->Remaining())
       return UNEXPECTED_ERROR;
 
-    if (!new_stream->Write(extra_position, extra_count))
+    if (!new_stream->Write(extra_bytes->Buffer(), extra_count))
       return MEM_ERROR;
 
-    extra_position += extra_count;
+    if (!extra_bytes->Skip(extra_count))
+      return UNEXPECTED_ERROR;
 
     // "seek" forwards (or backwards) in oldfile.
     if (old_position + seek_adjustment < old_start ||
@@ -148,6 +187,14 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
   return OK;
 }
 
+BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
+                            SourceStream* patch_stream,
+                            const uint8* old_start, size_t old_size,
+                            SinkStream* new_stream) {
+  return MBS_ApplyPatchToSink(header, patch_stream, old_start, old_size,
+                              new_stream);
+}
+
 BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
                               SourceStream* patch_stream,
                               SinkStream* new_stream) {
@@ -163,7 +210,35 @@ BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
   if (CalculateCrc(old_start, old_size) != header.scrc32)
     return CRC_ERROR;
 
-  MBS_ApplyPatch(&header, patch_stream, old_start, old_size, new_stream);
+  return MBS_ApplyPatch(&header, patch_stream, old_start, old_size,
+                        new_stream);
+}
+
+BSDiffStatus ApplyBinaryPatchToFile(SourceStream* old_stream,
+                                    SourceStream* patch_stream,
+                                    FILE* new_file) {
+  MBSPatchHeader header;
+  BSDiffStatus ret = MBS_ReadHeader(patch_stream, &header);
+  if (ret != OK) return ret;
+
+  const uint8* old_start = old_stream->Buffer();
+  size_t old_size = old_stream->Remaining();
+
+  if (old_size != header.slen) return UNEXPECTED_ERROR;
+
+  if (CalculateCrc(old_start, old_size) != header.scrc32)
+    return CRC_ERROR;
+
+  FileSink sink(new_file);
+  ret = MBS_ApplyPatchToSink(&header, patch_stream, old_start, old_size,
+                             &sink);
+  if (ret != OK) {
+    // The sink only fails if writing to |new_file| fails.
+    return ret == MEM_ERROR ? WRITE_ERROR : ret;
+  }
+
+  if (!sink.Flush())
+    return WRITE_ERROR;
 
   return OK;
 }
@@ -26,10 +26,14 @@
 
 #include <stdlib.h>
 #include <algorithm>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/string_util.h"
+#include "base/sys_info.h"
+#include "base/threading/platform_thread.h"
 #include "base/time.h"
 
 #include "courgette/crc.h"
@@ -199,55 +203,50 @@ static CheckBool WriteHeader(SinkStream* stream, MBSPatchHeader* header) {
   return ok;
 }
 
-BSDiffStatus CreateBinaryPatch(SourceStream* old_stream,
-                               SourceStream* new_stream,
-                               SinkStream* patch_stream)
-{
-  base::Time start_bsdiff_time = base::Time::Now();
-  VLOG(1) << "Start bsdiff";
-  size_t initial_patch_stream_length = patch_stream->Length();
-
-  SinkStreamSet patch_streams;
-  SinkStream* control_stream_copy_counts = patch_streams.stream(0);
-  SinkStream* control_stream_extra_counts = patch_streams.stream(1);
-  SinkStream* control_stream_seeks = patch_streams.stream(2);
-  SinkStream* diff_skips = patch_streams.stream(3);
-  SinkStream* diff_bytes = patch_streams.stream(4);
-  SinkStream* extra_bytes = patch_streams.stream(5);
-
-  const uint8* old = old_stream->Buffer();
-  const int oldsize = static_cast<int>(old_stream->Remaining());
-
-  uint32 pending_diff_zeros = 0;
-
-  PagedArray<int> I;
-  PagedArray<int> V;
-
-  if (!I.Allocate(oldsize + 1)) {
-    LOG(ERROR) << "Could not allocate I[], " << ((oldsize + 1) * sizeof(int))
-               << " bytes";
-    return MEM_ERROR;
+// Minimum number of bytes of the new file per diff section.  Below this the
+// per-thread overhead and the patch growth from matches not spanning section
+// boundaries outweigh the speedup from diffing sections concurrently.
+static const int kMinimumSectionSize = 4 * 1024 * 1024;
+
+// Counts reported by VLOG when patch generation completes.
+struct DiffStats {
+  DiffStats()
+      : control_length(0),
+        diff_bytes_length(0),
+        diff_bytes_nonzero(0),
+        extra_bytes_length(0) {
   }
 
-  if (!V.Allocate(oldsize + 1)) {
-    LOG(ERROR) << "Could not allocate V[], " << ((oldsize + 1) * sizeof(int))
-               << " bytes";
-    return MEM_ERROR;
-  }
+  int control_length;
+  int diff_bytes_length;
+  int diff_bytes_nonzero;
+  int extra_bytes_length;
+};
 
-  base::Time q_start_time = base::Time::Now();
-  qsufsort(I, V, old, oldsize);
-  VLOG(1) << " done qsufsort "
-          << (base::Time::Now() - q_start_time).InSecondsF();
-  V.clear();
-
-  const uint8* newbuf = new_stream->Buffer();
-  const int newsize = static_cast<int>(new_stream->Remaining());
+// Diffs newbuf[0,newsize) against the whole old file, using the suffix array
+// |I| computed by qsufsort() over |old|, and writes the resulting patch
+// streams into |patch_streams|.
+//
+// The caller concatenates sections in order, so each section must be
+// self-contained: the old-file cursor implied by the seeks in control
+// stream 2 starts at zero and is returned to zero by the final triple.
+// Trailing zero diff bytes are not flushed into the diff skips stream;
+// their count is returned through |final_pending_diff_zeros| so that a run
+// of zeros can be combined across a section boundary.
+static BSDiffStatus DiffSection(PagedArray<int>& I,
+                                const uint8* old, int oldsize,
+                                const uint8* newbuf, int newsize,
+                                SinkStreamSet* patch_streams,
+                                uint32* final_pending_diff_zeros,
+                                DiffStats* stats) {
+  SinkStream* control_stream_copy_counts = patch_streams->stream(0);
+  SinkStream* control_stream_extra_counts = patch_streams->stream(1);
+  SinkStream* control_stream_seeks = patch_streams->stream(2);
+  SinkStream* diff_skips = patch_streams->stream(3);
+  SinkStream* diff_bytes = patch_streams->stream(4);
+  SinkStream* extra_bytes = patch_streams->stream(5);
 
-  int control_length = 0;
-  int diff_bytes_length = 0;
-  int diff_bytes_nonzero = 0;
-  int extra_bytes_length = 0;
+  uint32 pending_diff_zeros = 0;
 
   // The patch format is a sequence of triples <copy,extra,seek> where 'copy' is
   // the number of bytes to copy from the old file (possibly with mistakes),
@@ -375,7 +374,7 @@ BSDiffStatus CreateBinaryPatch(SourceStream* old_stream,
       for (int i = 0;  i < lenf;  i++) {
         uint8 diff_byte = newbuf[lastscan + i] - old[lastpos + i];
         if (diff_byte) {
-          ++diff_bytes_nonzero;
+          ++stats->diff_bytes_nonzero;
           if (!diff_skips->WriteVarint32(pending_diff_zeros))
             return MEM_ERROR;
           pending_diff_zeros = 0;
@@ -391,8 +390,15 @@ BSDiffStatus CreateBinaryPatch(SourceStream* old_stream,
           return MEM_ERROR;
       }
 
-      diff_bytes_length += lenf;
-      extra_bytes_length += gap;
+      stats->diff_bytes_length += lenf;
+      stats->extra_bytes_length += gap;
+
+      // Pin the final seek so the old-file cursor returns to zero.  The
+      // cursor position after the last triple is otherwise unused, and a
+      // known exit position lets the next section's triples be generated
+      // without knowing which section precedes them.
+      if (scan == newsize)
+        pos = 0;
 
       uint32 copy_count = lenf;
       uint32 extra_count = gap;
@@ -404,7 +410,7 @@ BSDiffStatus CreateBinaryPatch(SourceStream* old_stream,
         return MEM_ERROR;
       }
 
-      ++control_length;
+      ++stats->control_length;
 #ifdef DEBUG_bsmedberg
       VLOG(1) << StringPrintf("Writing a block:  copy: %-8u extra: %-8u seek: "
                               "%+-9d", copy_count, extra_count,
@@ -417,6 +423,187 @@ BSDiffStatus CreateBinaryPatch(SourceStream* old_stream,
     }
   }
 
+  *final_pending_diff_zeros = pending_diff_zeros;
+  return OK;
+}
+
+// Runs DiffSection() for one section of the new file on its own thread.  The
+// suffix array and the underlying file buffers are shared between sections
+// and are read-only while the threads run.
+class SectionDiffThread : public base::PlatformThread::Delegate {
+ public:
+  SectionDiffThread(PagedArray<int>* I,
+                    const uint8* old, int oldsize,
+                    const uint8* newbuf, int newsize)
+      : I_(I),
+        old_(old),
+        oldsize_(oldsize),
+        newbuf_(newbuf),
+        newsize_(newsize),
+        pending_diff_zeros_(0),
+        status_(UNEXPECTED_ERROR) {
+  }
+
+  virtual void ThreadMain() OVERRIDE {
+    status_ = DiffSection(*I_, old_, oldsize_, newbuf_, newsize_,
+                          &patch_streams_, &pending_diff_zeros_, &stats_);
+  }
+
+  BSDiffStatus status() const { return status_; }
+  SinkStreamSet* patch_streams() { return &patch_streams_; }
+  uint32 pending_diff_zeros() const { return pending_diff_zeros_; }
+  const DiffStats& stats() const { return stats_; }
+
+ private:
+  PagedArray<int>* I_;
+  const uint8* old_;
+  int oldsize_;
+  const uint8* newbuf_;
+  int newsize_;
+
+  SinkStreamSet patch_streams_;
+  uint32 pending_diff_zeros_;
+  DiffStats stats_;
+  BSDiffStatus status_;
+
+  DISALLOW_COPY_AND_ASSIGN(SectionDiffThread);
+};
+
+// Appends one section's diff skips stream to |merged|.  The skip count
+// preceding the section's first nonzero diff byte is combined with
+// |*pending_zeros|, the count of zero diff bytes still unflushed from the
+// preceding sections, and |section_pending_zeros| becomes the new unflushed
+// count.
+static CheckBool AppendDiffSkips(SinkStream* merged,
+                                 SinkStream* section_skips,
+                                 uint32 section_pending_zeros,
+                                 uint32* pending_zeros) {
+  if (section_skips->Length() == 0) {
+    // The section had no nonzero diff bytes; its zeros spill into the next
+    // section's leading skip count.
+    *pending_zeros += section_pending_zeros;
+    return true;
+  }
+
+  SourceStream reader;
+  reader.Init(*section_skips);
+  uint32 first_skip = 0;
+  if (!reader.ReadVarint32(&first_skip))
+    return false;
+  if (!merged->WriteVarint32(*pending_zeros + first_skip))
+    return false;
+  if (!merged->Write(reader.Buffer(), reader.Remaining()))
+    return false;
+  *pending_zeros = section_pending_zeros;
+  return true;
+}
+
+BSDiffStatus CreateBinaryPatch(SourceStream* old_stream,
+                               SourceStream* new_stream,
+                               SinkStream* patch_stream)
+{
+  base::Time start_bsdiff_time = base::Time::Now();
+  VLOG(1) << "Start bsdiff";
+  size_t initial_patch_stream_length = patch_stream->Length();
+
+  const uint8* old = old_stream->Buffer();
+  const int oldsize = static_cast<int>(old_stream->Remaining());
+
+  PagedArray<int> I;
+  PagedArray<int> V;
+
+  if (!I.Allocate(oldsize + 1)) {
+    LOG(ERROR) << "Could not allocate I[], " << ((oldsize + 1) * sizeof(int))
+               << " bytes";
+    return MEM_ERROR;
+  }
+
+  if (!V.Allocate(oldsize + 1)) {
+    LOG(ERROR) << "Could not allocate V[], " << ((oldsize + 1) * sizeof(int))
+               << " bytes";
+    return MEM_ERROR;
+  }
+
+  base::Time q_start_time = base::Time::Now();
+  qsufsort(I, V, old, oldsize);
+  VLOG(1) << " done qsufsort "
+          << (base::Time::Now() - q_start_time).InSecondsF();
+  V.clear();
+
+  const uint8* newbuf = new_stream->Buffer();
+  const int newsize = static_cast<int>(new_stream->Remaining());
+
+  // Partition the new file into sections that are diffed concurrently
+  // against the whole old file.  Each section produces a self-contained run
+  // of patch streams, and the runs are concatenated in section order, so the
+  // patch does not depend on thread scheduling.  A match cannot span a
+  // section boundary, which costs a little patch size; small inputs are
+  // diffed as a single section.
+  int section_count = std::min(base::SysInfo::NumberOfProcessors(),
+                               newsize / kMinimumSectionSize);
+  if (section_count < 1)
+    section_count = 1;
+
+  ScopedVector<SectionDiffThread> sections;
+  int section_start = 0;
+  for (int i = 0;  i < section_count;  ++i) {
+    int section_end =
+        (i == section_count - 1) ? newsize
+                                 : section_start + newsize / section_count;
+    sections.push_back(new SectionDiffThread(&I, old, oldsize,
+                                             newbuf + section_start,
+                                             section_end - section_start));
+    section_start = section_end;
+  }
+
+  if (section_count == 1) {
+    sections[0]->ThreadMain();
+  } else {
+    std::vector<base::PlatformThreadHandle> handles(section_count,
+                                                    base::kNullThreadHandle);
+    for (int i = 0;  i < section_count;  ++i) {
+      if (!base::PlatformThread::Create(0, sections[i], &handles[i])) {
+        // Could not start a thread; diff the section on this one.
+        handles[i] = base::kNullThreadHandle;
+        sections[i]->ThreadMain();
+      }
+    }
+    for (int i = 0;  i < section_count;  ++i) {
+      if (handles[i] != base::kNullThreadHandle)
+        base::PlatformThread::Join(handles[i]);
+    }
+  }
+
+  SinkStreamSet patch_streams;
+  SinkStream* diff_skips = patch_streams.stream(3);
+
+  DiffStats stats;
+  uint32 pending_diff_zeros = 0;
+  for (int i = 0;  i < section_count;  ++i) {
+    SectionDiffThread* section = sections[i];
+    if (section->status() != OK)
+      return section->status();
+
+    SinkStreamSet* section_streams = section->patch_streams();
+    if (!patch_streams.stream(0)->Append(section_streams->stream(0)) ||
+        !patch_streams.stream(1)->Append(section_streams->stream(1)) ||
+        !patch_streams.stream(2)->Append(section_streams->stream(2)) ||
+        !patch_streams.stream(4)->Append(section_streams->stream(4)) ||
+        !patch_streams.stream(5)->Append(section_streams->stream(5))) {
+      return MEM_ERROR;
+    }
+    if (!AppendDiffSkips(diff_skips, section_streams->stream(3),
+                         section->pending_diff_zeros(),
+                         &pending_diff_zeros)) {
+      return MEM_ERROR;
+    }
+
+    stats.control_length += section->stats().control_length;
+    stats.diff_bytes_length += section->stats().diff_bytes_length;
+    stats.diff_bytes_nonzero += section->stats().diff_bytes_nonzero;
+    stats.extra_bytes_length += section->stats().extra_bytes_length;
+  }
+
   if (!diff_skips->WriteVarint32(pending_diff_zeros))
     return MEM_ERROR;
 
@@ -438,11 +625,12 @@ BSDiffStatus CreateBinaryPatch(SourceStream* old_stream,
   if (!patch_streams.CopyTo(patch_stream))
     return MEM_ERROR;
 
-  VLOG(1) << "Control tuples: " << control_length
-          << "  copy bytes: " << diff_bytes_length
-          << "  mistakes: " << diff_bytes_nonzero
+  VLOG(1) << "Control tuples: " << stats.control_length
+          << "  copy bytes: " << stats.diff_bytes_length
+          << "  mistakes: " << stats.diff_bytes_nonzero
           << "  (skips: " << diff_skips_length << ")"
-          << "  extra bytes: " << extra_bytes_length
+          << "  extra bytes: " << stats.extra_bytes_length
+          << "\nSections: " << section_count
           << "\nUncompressed bsdiff patch size "
           << patch_stream->Length() - initial_patch_stream_length
           << "\nEnd bsdiff "
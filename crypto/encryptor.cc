@@ -81,6 +81,26 @@ bool Encryptor::GenerateCounterMask(size_t plaintext_len,
   return true;
 }
 
+#if defined(USE_OPENSSL) || !defined(USE_NSS)
+// The non-NSS backends have no chunked cipher path, so the chain is
+// coalesced into one buffer and processed with a single-shot operation.
+bool Encryptor::EncryptChunks(const std::vector<base::StringPiece>& plaintext,
+                              std::string* ciphertext) {
+  std::string input;
+  for (size_t i = 0; i < plaintext.size(); ++i)
+    plaintext[i].AppendToString(&input);
+  return Encrypt(input, ciphertext);
+}
+
+bool Encryptor::DecryptChunks(const std::vector<base::StringPiece>& ciphertext,
+                              std::string* plaintext) {
+  std::string input;
+  for (size_t i = 0; i < ciphertext.size(); ++i)
+    ciphertext[i].AppendToString(&input);
+  return Decrypt(input, plaintext);
+}
+#endif
+
 void Encryptor::MaskMessage(const void* plaintext,
                             size_t plaintext_len,
                             const void* mask,
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
@@ -80,6 +81,24 @@ class CRYPTO_EXPORT Encryptor {
   // be used as a padding oracle to attack the cryptosystem.
   bool Decrypt(const base::StringPiece& ciphertext, std::string* plaintext);
 
+  // Scatter-gather versions of Encrypt()/Decrypt(). The chunks are
+  // processed as if they were one contiguous buffer, but are fed to the
+  // cipher straight from the caller's buffers (e.g. the spans of an
+  // IOBuffer chain), so the caller does not have to coalesce them first.
+  // The whole chain shares one cipher context, which is also cheaper than
+  // one Encrypt() call per chunk. Produces exactly the output that
+  // Encrypt()/Decrypt() would produce for the concatenated input.
+  //
+  // The actual AES rounds are performed by the platform crypto library,
+  // which selects hardware implementations such as AES-NI at runtime
+  // where available.
+  bool EncryptChunks(const std::vector<base::StringPiece>& plaintext,
+                     std::string* ciphertext);
+
+  // See the warning on Decrypt() about unauthenticated ciphertext.
+  bool DecryptChunks(const std::vector<base::StringPiece>& ciphertext,
+                     std::string* plaintext);
+
   // Sets the counter value when in CTR mode. Currently only 128-bits
   // counter value is supported.
   //
@@ -122,12 +141,12 @@ class CRYPTO_EXPORT Encryptor {
              std::string* output);
   std::string iv_;
 #elif defined(USE_NSS)
-  bool Crypt(PK11Context* context,
-             const base::StringPiece& input,
-             std::string* output);
-  bool CryptCTR(PK11Context* context,
-                const base::StringPiece& input,
-                std::string* output);
+  bool CryptChunks(PK11Context* context,
+                   const std::vector<base::StringPiece>& input,
+                   std::string* output);
+  bool CryptCTRChunks(PK11Context* context,
+                      const std::vector<base::StringPiece>& input,
+                      std::string* output);
   ScopedPK11Slot slot_;
   ScopedSECItem param_;
 #elif defined(OS_MACOSX)
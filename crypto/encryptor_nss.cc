@@ -30,6 +30,13 @@ inline CK_MECHANISM_TYPE GetMechanism(Encryptor::Mode mode) {
   return static_cast<CK_MECHANISM_TYPE>(-1);
 }
 
+size_t TotalLength(const std::vector<base::StringPiece>& chunks) {
+  size_t total = 0;
+  for (size_t i = 0; i < chunks.size(); ++i)
+    total += chunks[i].size();
+  return total;
+}
+
 }  // namespace
 
 Encryptor::Encryptor()
@@ -78,6 +85,20 @@ bool Encryptor::Init(SymmetricKey* key,
 bool Encryptor::Encrypt(const base::StringPiece& plaintext,
                         std::string* ciphertext) {
   CHECK(!plaintext.empty() || (mode_ == CBC));
+  return EncryptChunks(std::vector<base::StringPiece>(1, plaintext),
+                       ciphertext);
+}
+
+bool Encryptor::Decrypt(const base::StringPiece& ciphertext,
+                        std::string* plaintext) {
+  CHECK(!ciphertext.empty());
+  return DecryptChunks(std::vector<base::StringPiece>(1, ciphertext),
+                       plaintext);
+}
+
+bool Encryptor::EncryptChunks(const std::vector<base::StringPiece>& plaintext,
+                              std::string* ciphertext) {
+  CHECK(TotalLength(plaintext) > 0 || (mode_ == CBC));
   ScopedPK11Context context(PK11_CreateContextBySymKey(GetMechanism(mode_),
                                                        CKA_ENCRYPT,
                                                        key_->key(),
@@ -86,13 +107,13 @@ bool Encryptor::Encrypt(const base::StringPiece& plaintext,
     return false;
 
   return (mode_ == CTR) ?
-      CryptCTR(context.get(), plaintext, ciphertext) :
-      Crypt(context.get(), plaintext, ciphertext);
+      CryptCTRChunks(context.get(), plaintext, ciphertext) :
+      CryptChunks(context.get(), plaintext, ciphertext);
 }
 
-bool Encryptor::Decrypt(const base::StringPiece& ciphertext,
-                        std::string* plaintext) {
-  CHECK(!ciphertext.empty());
+bool Encryptor::DecryptChunks(const std::vector<base::StringPiece>& ciphertext,
+                              std::string* plaintext) {
+  CHECK_GT(TotalLength(ciphertext), 0u);
   ScopedPK11Context context(PK11_CreateContextBySymKey(
       GetMechanism(mode_), (mode_ == CTR ? CKA_ENCRYPT : CKA_DECRYPT),
       key_->key(), param_.get()));
@@ -100,71 +121,81 @@ bool Encryptor::Decrypt(const base::StringPiece& ciphertext,
     return false;
 
   return (mode_ == CTR) ?
-      CryptCTR(context.get(), ciphertext, plaintext) :
-      Crypt(context.get(), ciphertext, plaintext);
+      CryptCTRChunks(context.get(), ciphertext, plaintext) :
+      CryptChunks(context.get(), ciphertext, plaintext);
 }
 
-bool Encryptor::Crypt(PK11Context* context,
-                      const base::StringPiece& input,
-                      std::string* output) {
-  size_t output_len = input.size() + AES_BLOCK_SIZE;
-  CHECK_GT(output_len, input.size());
+bool Encryptor::CryptChunks(PK11Context* context,
+                            const std::vector<base::StringPiece>& input,
+                            std::string* output) {
+  size_t input_len = TotalLength(input);
+  size_t output_len = input_len + AES_BLOCK_SIZE;
+  CHECK_GT(output_len, input_len);
 
   output->resize(output_len);
   uint8* output_data =
       reinterpret_cast<uint8*>(const_cast<char*>(output->data()));
 
-  int input_len = input.size();
-  uint8* input_data =
-      reinterpret_cast<uint8*>(const_cast<char*>(input.data()));
-
-  int op_len;
-  SECStatus rv = PK11_CipherOp(context,
-                               output_data,
-                               &op_len,
-                               output_len,
-                               input_data,
-                               input_len);
-
-  if (SECSuccess != rv) {
-    output->clear();
-    return false;
+  // The PK11 context buffers trailing partial blocks internally, so each
+  // chunk is fed to the cipher straight from the caller's buffer; chunk
+  // boundaries need not be block-aligned.
+  size_t filled = 0;
+  for (size_t i = 0; i < input.size(); ++i) {
+    if (input[i].empty())
+      continue;
+
+    int op_len;
+    SECStatus rv = PK11_CipherOp(
+        context,
+        output_data + filled,
+        &op_len,
+        output_len - filled,
+        reinterpret_cast<uint8*>(const_cast<char*>(input[i].data())),
+        input[i].size());
+
+    if (SECSuccess != rv) {
+      output->clear();
+      return false;
+    }
+    filled += op_len;
   }
 
   unsigned int digest_len;
-  rv = PK11_DigestFinal(context,
-                        output_data + op_len,
-                        &digest_len,
-                        output_len - op_len);
+  SECStatus rv = PK11_DigestFinal(context,
+                                  output_data + filled,
+                                  &digest_len,
+                                  output_len - filled);
   if (SECSuccess != rv) {
     output->clear();
     return false;
   }
 
-  output->resize(op_len + digest_len);
+  output->resize(filled + digest_len);
   return true;
 }
 
-bool Encryptor::CryptCTR(PK11Context* context,
-                         const base::StringPiece& input,
-                         std::string* output) {
+bool Encryptor::CryptCTRChunks(PK11Context* context,
+                               const std::vector<base::StringPiece>& input,
+                               std::string* output) {
   if (!counter_.get()) {
     LOG(ERROR) << "Counter value not set in CTR mode.";
     return false;
   }
 
-  size_t output_len = ((input.size() + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE) *
+  size_t input_len = TotalLength(input);
+  size_t output_len = ((input_len + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE) *
       AES_BLOCK_SIZE;
-  CHECK_GE(output_len, input.size());
+  CHECK_GE(output_len, input_len);
   output->resize(output_len);
   uint8* output_data =
       reinterpret_cast<uint8*>(const_cast<char*>(output->data()));
 
   size_t mask_len;
-  bool ret = GenerateCounterMask(input.size(), output_data, &mask_len);
+  bool ret = GenerateCounterMask(input_len, output_data, &mask_len);
   if (!ret)
     return false;
 
+  // Encrypt the counter blocks for the whole chain in one cipher call.
   CHECK_EQ(mask_len, output_len);
   int op_len;
   SECStatus rv = PK11_CipherOp(context,
@@ -186,11 +217,15 @@ bool Encryptor::CryptCTR(PK11Context* context,
     return false;
   CHECK(!digest_len);
 
-  // Use |output_data| to mask |input|.
-  MaskMessage(
-      reinterpret_cast<uint8*>(const_cast<char*>(input.data())),
-      input.length(), output_data, output_data);
-  output->resize(input.length());
+  // XOR each chunk with its slice of the encrypted counter stream.
+  size_t offset = 0;
+  for (size_t i = 0; i < input.size(); ++i) {
+    MaskMessage(
+        reinterpret_cast<uint8*>(const_cast<char*>(input[i].data())),
+        input[i].length(), output_data + offset, output_data + offset);
+    offset += input[i].length();
+  }
+  output->resize(input_len);
   return true;
 }
 
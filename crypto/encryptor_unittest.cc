@@ -5,9 +5,11 @@
 #include "crypto/encryptor.h"
 
 #include <string>
+#include <vector>
 
 #include "base/memory/scoped_ptr.h"
 #include "base/string_number_conversions.h"
+#include "base/string_piece.h"
 #include "crypto/symmetric_key.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -35,6 +37,43 @@ TEST(EncryptorTest, EncryptDecrypt) {
   EXPECT_EQ(plaintext, decypted);
 }
 
+TEST(EncryptorTest, EncryptDecryptChunks) {
+  scoped_ptr<crypto::SymmetricKey> key(
+      crypto::SymmetricKey::DeriveKeyFromPassword(
+          crypto::SymmetricKey::AES, "password", "saltiest", 1000, 256));
+  EXPECT_TRUE(NULL != key.get());
+
+  crypto::Encryptor encryptor;
+  std::string iv("the iv: 16 bytes");
+  EXPECT_TRUE(encryptor.Init(key.get(), crypto::Encryptor::CBC, iv));
+
+  std::string plaintext("chunked plaintext of uneven length");
+  std::string expected;
+  EXPECT_TRUE(encryptor.Encrypt(plaintext, &expected));
+
+  // Split the input at boundaries that are not multiples of the block size.
+  // The chunked result must match the single-shot result exactly.
+  std::vector<base::StringPiece> chunks;
+  chunks.push_back(base::StringPiece(plaintext.data(), 5));
+  chunks.push_back(base::StringPiece());  // Empty chunks are allowed.
+  chunks.push_back(base::StringPiece(plaintext.data() + 5, 17));
+  chunks.push_back(base::StringPiece(plaintext.data() + 22,
+                                     plaintext.size() - 22));
+
+  std::string ciphertext;
+  EXPECT_TRUE(encryptor.EncryptChunks(chunks, &ciphertext));
+  EXPECT_EQ(expected, ciphertext);
+
+  std::vector<base::StringPiece> cipher_chunks;
+  cipher_chunks.push_back(base::StringPiece(ciphertext.data(), 3));
+  cipher_chunks.push_back(base::StringPiece(ciphertext.data() + 3,
+                                            ciphertext.size() - 3));
+
+  std::string decrypted;
+  EXPECT_TRUE(encryptor.DecryptChunks(cipher_chunks, &decrypted));
+  EXPECT_EQ(plaintext, decrypted);
+}
+
 TEST(EncryptorTest, DecryptWrongKey) {
   scoped_ptr<crypto::SymmetricKey> key(
       crypto::SymmetricKey::DeriveKeyFromPassword(
@@ -128,6 +167,42 @@ TEST(EncryptorTest, EncryptDecryptCTR) {
   EXPECT_EQ(plaintext, decypted);
 }
 
+TEST(EncryptorTest, EncryptDecryptChunksCTR) {
+  scoped_ptr<crypto::SymmetricKey> key(
+      crypto::SymmetricKey::GenerateRandomKey(
+          crypto::SymmetricKey::AES, 128));
+  EXPECT_TRUE(NULL != key.get());
+  const std::string kInitialCounter = "0000000000000000";
+
+  crypto::Encryptor encryptor;
+  EXPECT_TRUE(encryptor.Init(key.get(), crypto::Encryptor::CTR, ""));
+
+  std::string plaintext("chunked plaintext in counter mode");
+  std::string expected;
+  EXPECT_TRUE(encryptor.SetCounter(kInitialCounter));
+  EXPECT_TRUE(encryptor.Encrypt(plaintext, &expected));
+
+  std::vector<base::StringPiece> chunks;
+  chunks.push_back(base::StringPiece(plaintext.data(), 7));
+  chunks.push_back(base::StringPiece(plaintext.data() + 7,
+                                     plaintext.size() - 7));
+
+  std::string ciphertext;
+  EXPECT_TRUE(encryptor.SetCounter(kInitialCounter));
+  EXPECT_TRUE(encryptor.EncryptChunks(chunks, &ciphertext));
+  EXPECT_EQ(expected, ciphertext);
+
+  std::vector<base::StringPiece> cipher_chunks;
+  cipher_chunks.push_back(base::StringPiece(ciphertext.data(), 20));
+  cipher_chunks.push_back(base::StringPiece(ciphertext.data() + 20,
+                                            ciphertext.size() - 20));
+
+  std::string decrypted;
+  EXPECT_TRUE(encryptor.SetCounter(kInitialCounter));
+  EXPECT_TRUE(encryptor.DecryptChunks(cipher_chunks, &decrypted));
+  EXPECT_EQ(plaintext, decrypted);
+}
+
 TEST(EncryptorTest, CTRCounter) {
   const int kCounterSize = 16;
   const char kTest1[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
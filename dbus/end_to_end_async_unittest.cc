@@ -313,6 +313,57 @@ TEST_F(EndToEndAsyncTest, EchoThreeTimes) {
   EXPECT_EQ("foo", response_strings_[2]);
 }
 
+// Call Echo method three times, submitted as a single batch.
+TEST_F(EndToEndAsyncTest, EchoThreeTimesInBatch) {
+  const char* kMessages[] = { "foo", "bar", "baz" };
+
+  // Create the method calls. They only need to outlive CallMethods().
+  scoped_ptr<dbus::MethodCall> method_calls[arraysize(kMessages)];
+  std::vector<dbus::ObjectProxy::MethodCallRequest> requests;
+  for (size_t i = 0; i < arraysize(kMessages); ++i) {
+    method_calls[i].reset(
+        new dbus::MethodCall("org.chromium.TestInterface", "Echo"));
+    dbus::MessageWriter writer(method_calls[i].get());
+    writer.AppendString(kMessages[i]);
+    requests.push_back(dbus::ObjectProxy::MethodCallRequest(
+        method_calls[i].get(),
+        dbus::ObjectProxy::TIMEOUT_USE_DEFAULT,
+        base::Bind(&EndToEndAsyncTest::OnResponse, base::Unretained(this))));
+  }
+
+  // Call the methods in one batch.
+  object_proxy_->CallMethods(requests);
+
+  // Check the responses.
+  WaitForResponses(3);
+  // Sort as the order of the returned messages is not deterministic.
+  std::sort(response_strings_.begin(), response_strings_.end());
+  EXPECT_EQ("bar", response_strings_[0]);
+  EXPECT_EQ("baz", response_strings_[1]);
+  EXPECT_EQ("foo", response_strings_[2]);
+}
+
+// A batch submitted to a broken bus must still fail every callback.
+TEST_F(EndToEndAsyncTest, BatchWithBrokenBus) {
+  // Set up a broken bus.
+  SetUpBrokenBus();
+
+  dbus::MethodCall method_call("org.chromium.TestInterface", "Echo");
+  dbus::MessageWriter writer(&method_call);
+  writer.AppendString("hello");
+
+  std::vector<dbus::ObjectProxy::MethodCallRequest> requests;
+  requests.push_back(dbus::ObjectProxy::MethodCallRequest(
+      &method_call,
+      dbus::ObjectProxy::TIMEOUT_USE_DEFAULT,
+      base::Bind(&EndToEndAsyncTest::OnResponse, base::Unretained(this))));
+  object_proxy_->CallMethods(requests);
+  WaitForResponses(1);
+
+  // Should fail because of the broken bus.
+  ASSERT_EQ("", response_strings_[0]);
+}
+
 TEST_F(EndToEndAsyncTest, BrokenBus) {
   const char* kHello = "hello";
 
@@ -128,6 +128,39 @@ void ObjectProxy::CallMethodWithErrorCallback(MethodCall* method_call,
   bus_->PostTaskToDBusThread(FROM_HERE, task);
 }
 
+void ObjectProxy::CallMethods(
+    const std::vector<MethodCallRequest>& requests) {
+  bus_->AssertOnOriginThread();
+
+  std::vector<PreparedMethodCall> prepared_calls;
+  prepared_calls.reserve(requests.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    const MethodCallRequest& request = requests[i];
+    request.method_call->SetDestination(service_name_);
+    request.method_call->SetPath(object_path_);
+    // Increment the reference count so we can safely reference the
+    // underlying request message until the method call is complete. This
+    // will be unref'ed in StartAsyncMethodCallBatch().
+    DBusMessage* request_message = request.method_call->raw_message();
+    dbus_message_ref(request_message);
+    prepared_calls.push_back(
+        PreparedMethodCall(request_message,
+                           request.timeout_ms,
+                           request.callback,
+                           base::Bind(&ObjectProxy::OnCallMethodError,
+                                      this,
+                                      request.callback)));
+  }
+
+  const base::TimeTicks start_time = base::TimeTicks::Now();
+  // Send the whole batch from a single task in the D-Bus thread.
+  bus_->PostTaskToDBusThread(FROM_HERE,
+                             base::Bind(&ObjectProxy::StartAsyncMethodCallBatch,
+                                        this,
+                                        prepared_calls,
+                                        start_time));
+}
+
 void ObjectProxy::ConnectToSignal(const std::string& interface_name,
                                   const std::string& signal_name,
                                   SignalCallback signal_callback,
@@ -169,6 +202,31 @@ ObjectProxy::ResponseCallback ObjectProxy::EmptyResponseCallback() {
   return base::Bind(&EmptyResponseCallbackBody);
 }
 
+ObjectProxy::MethodCallRequest::MethodCallRequest(MethodCall* in_method_call,
+                                                  int in_timeout_ms,
+                                                  ResponseCallback in_callback)
+    : method_call(in_method_call),
+      timeout_ms(in_timeout_ms),
+      callback(in_callback) {
+}
+
+ObjectProxy::MethodCallRequest::~MethodCallRequest() {
+}
+
+ObjectProxy::PreparedMethodCall::PreparedMethodCall(
+    DBusMessage* in_request_message,
+    int in_timeout_ms,
+    ResponseCallback in_response_callback,
+    ErrorCallback in_error_callback)
+    : request_message(in_request_message),
+      timeout_ms(in_timeout_ms),
+      response_callback(in_response_callback),
+      error_callback(in_error_callback) {
+}
+
+ObjectProxy::PreparedMethodCall::~PreparedMethodCall() {
+}
+
 ObjectProxy::OnPendingCallIsCompleteData::OnPendingCallIsCompleteData(
     ObjectProxy* in_object_proxy,
     ResponseCallback in_response_callback,
@@ -205,6 +263,46 @@ void ObjectProxy::StartAsyncMethodCall(int timeout_ms,
     return;
   }
 
+  SendAsyncMethodCall(timeout_ms, request_message, response_callback,
+                      error_callback, start_time);
+}
+
+void ObjectProxy::StartAsyncMethodCallBatch(
+    const std::vector<PreparedMethodCall>& calls,
+    base::TimeTicks start_time) {
+  bus_->AssertOnDBusThread();
+
+  const bool ready = bus_->Connect() && bus_->SetUpAsyncOperations();
+  for (size_t i = 0; i < calls.size(); ++i) {
+    const PreparedMethodCall& call = calls[i];
+    if (!ready) {
+      // In case of a failure, run the error callback with NULL.
+      DBusMessage* response_message = NULL;
+      bus_->PostTaskToOriginThread(FROM_HERE,
+                                   base::Bind(&ObjectProxy::RunResponseCallback,
+                                              this,
+                                              call.response_callback,
+                                              call.error_callback,
+                                              start_time,
+                                              response_message));
+      dbus_message_unref(call.request_message);
+      continue;
+    }
+    // All requests are written to the bus before any reply is processed,
+    // so the method calls overlap on the wire.
+    SendAsyncMethodCall(call.timeout_ms, call.request_message,
+                        call.response_callback, call.error_callback,
+                        start_time);
+  }
+}
+
+void ObjectProxy::SendAsyncMethodCall(int timeout_ms,
+                                      DBusMessage* request_message,
+                                      ResponseCallback response_callback,
+                                      ErrorCallback error_callback,
+                                      base::TimeTicks start_time) {
+  bus_->AssertOnDBusThread();
+
   DBusPendingCall* pending_call = NULL;
 
   bus_->SendWithReply(request_message, &pending_call, timeout_ms);
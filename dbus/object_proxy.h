@@ -11,6 +11,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
@@ -70,6 +71,20 @@ class ObjectProxy : public base::RefCountedThreadSafe<ObjectProxy> {
   // Called when a signal is received. Signal* is the incoming signal.
   typedef base::Callback<void (Signal*)> SignalCallback;
 
+  // Describes a single method call in a batch passed to CallMethods().
+  // As with CallMethod(), |method_call| is not owned and only needs to
+  // stay alive for the duration of the CallMethods() call itself.
+  struct MethodCallRequest {
+    MethodCallRequest(MethodCall* method_call,
+                      int timeout_ms,
+                      ResponseCallback callback);
+    ~MethodCallRequest();
+
+    MethodCall* method_call;
+    int timeout_ms;
+    ResponseCallback callback;
+  };
+
   // Called when the object proxy is connected to the signal.
   // Parameters:
   // - the interface name.
@@ -124,6 +139,18 @@ class ObjectProxy : public base::RefCountedThreadSafe<ObjectProxy> {
                                            ResponseCallback callback,
                                            ErrorCallback error_callback);
 
+  // Requests to call several methods of the remote object at once.
+  //
+  // Behaves like calling CallMethod() once per entry of |requests|, but
+  // the whole batch is handed to the D-Bus thread in a single task and
+  // every request is written to the bus before any reply is waited on,
+  // so a burst of calls overlaps on the wire instead of paying a
+  // separate origin-to-D-Bus-thread hop per call. The callbacks are run
+  // in the origin thread as the replies arrive, in no particular order.
+  //
+  // Must be called in the origin thread.
+  virtual void CallMethods(const std::vector<MethodCallRequest>& requests);
+
   // Requests to connect to the signal from the remote object, replacing
   // any previous |signal_callback| connected to that signal.
   //
@@ -173,6 +200,24 @@ class ObjectProxy : public base::RefCountedThreadSafe<ObjectProxy> {
     base::TimeTicks start_time;
   };
 
+  // A request of a batch after the underlying message has been prepared
+  // for sending. Used to pass the batch from CallMethods() to
+  // StartAsyncMethodCallBatch().
+  struct PreparedMethodCall {
+    PreparedMethodCall(DBusMessage* request_message,
+                       int timeout_ms,
+                       ResponseCallback response_callback,
+                       ErrorCallback error_callback);
+    ~PreparedMethodCall();
+
+    // The reference added in CallMethods() is released on the D-Bus
+    // thread once the message is sent.
+    DBusMessage* request_message;
+    int timeout_ms;
+    ResponseCallback response_callback;
+    ErrorCallback error_callback;
+  };
+
   // Starts the async method call. This is a helper function to implement
   // CallMethod().
   void StartAsyncMethodCall(int timeout_ms,
@@ -181,6 +226,21 @@ class ObjectProxy : public base::RefCountedThreadSafe<ObjectProxy> {
                             ErrorCallback error_callback,
                             base::TimeTicks start_time);
 
+  // Like StartAsyncMethodCall() but submits every call of the batch to
+  // the bus in one go. This is a helper function to implement
+  // CallMethods().
+  void StartAsyncMethodCallBatch(const std::vector<PreparedMethodCall>& calls,
+                                 base::TimeTicks start_time);
+
+  // Sends |request_message| and arranges for the reply to be delivered
+  // through the callbacks. The bus must be connected and set up for
+  // async operations. Helper function for the two functions above.
+  void SendAsyncMethodCall(int timeout_ms,
+                           DBusMessage* request_message,
+                           ResponseCallback response_callback,
+                           ErrorCallback error_callback,
+                           base::TimeTicks start_time);
+
   // Called when the pending call is complete.
   void OnPendingCallIsComplete(DBusPendingCall* pending_call,
                                ResponseCallback response_callback,
@@ -12,11 +12,13 @@ namespace gpu {
 
 #ifndef _MSC_VER
 const FencedAllocator::Offset FencedAllocator::kInvalidOffset;
+const unsigned int FencedAllocator::kSmallAllocationThreshold;
 #endif
 
 FencedAllocator::FencedAllocator(unsigned int size,
                                  CommandBufferHelper *helper)
-    : helper_(helper) {
+    : helper_(helper),
+      free_block_hint_(0) {
   Block block = { FREE, 0, size, kUnusedToken };
   blocks_.push_back(block);
 }
@@ -33,31 +35,73 @@ FencedAllocator::~FencedAllocator() {
   // GPU_DCHECK_EQ(blocks_[0].state, FREE);
 }
 
-// Looks for a non-allocated block that is big enough. Search in the FREE
-// blocks first (for direct usage), first-fit, then in the FREE_PENDING_TOKEN
-// blocks, waiting for them. The current implementation isn't smart about
-// optimizing what to wait for, just looks inside the block in order (first-fit
-// as well).
+// Looks for a non-allocated block that is big enough, without waiting if at
+// all possible. Search in the FREE blocks first (for direct usage), then
+// reclaim the blocks whose tokens have already been read and search again.
+// Only if that fails do we wait - on the oldest outstanding token first, so
+// that a small allocation never stalls on a fence newer than the one it
+// actually needs.
 FencedAllocator::Offset FencedAllocator::Alloc(unsigned int size) {
   // Similarly to malloc, an allocation of 0 allocates at least 1 byte, to
   // return different pointers every time.
   if (size == 0) size = 1;
 
   // Try first to allocate in a free block.
-  for (unsigned int i = 0; i < blocks_.size(); ++i) {
-    Block &block = blocks_[i];
-    if (block.state == FREE && block.size >= size) {
-      return AllocInBlock(i, size);
+  Offset offset = AllocInFreeBlock(size);
+  if (offset != kInvalidOffset)
+    return offset;
+
+  // Toss out the blocks whose tokens have passed - this doesn't wait - and
+  // retry.
+  FreeUnused();
+  offset = AllocInFreeBlock(size);
+  if (offset != kInvalidOffset)
+    return offset;
+
+  // No free block is available. Wait on the blocks pending tokens, oldest
+  // token first, until enough contiguous space has been collapsed.
+  for (;;) {
+    BlockIndex oldest = blocks_.size();
+    for (BlockIndex i = 0; i < blocks_.size(); ++i) {
+      if (blocks_[i].state != FREE_PENDING_TOKEN)
+        continue;
+      if (oldest == blocks_.size() ||
+          blocks_[i].token < blocks_[oldest].token) {
+        oldest = i;
+      }
     }
+    if (oldest == blocks_.size())
+      return kInvalidOffset;
+    oldest = WaitForTokenAndFreeBlock(oldest);
+    if (blocks_[oldest].size >= size)
+      return AllocInBlock(oldest, size);
   }
+}
 
-  // No free block is available. Look for blocks pending tokens, and wait for
-  // them to be re-usable.
-  for (unsigned int i = 0; i < blocks_.size(); ++i) {
-    if (blocks_[i].state != FREE_PENDING_TOKEN)
-      continue;
-    i = WaitForTokenAndFreeBlock(i);
-    if (blocks_[i].size >= size)
+// Scans the FREE blocks for one that fits. Small allocations resume the scan
+// at the block that follows the previous small allocation, wrapping around:
+// transient uploads then march through the buffer in the order their tokens
+// retire, instead of fragmenting the low offsets. Larger allocations stay
+// first-fit so they pack against the start of the buffer.
+FencedAllocator::Offset FencedAllocator::AllocInFreeBlock(unsigned int size) {
+  BlockIndex count = blocks_.size();
+  if (size <= kSmallAllocationThreshold) {
+    for (BlockIndex i = 0; i < count; ++i) {
+      BlockIndex index = (free_block_hint_ + i) % count;
+      Block &block = blocks_[index];
+      if (block.state == FREE && block.size >= size) {
+        Offset offset = AllocInBlock(index, size);
+        // If the block was split, index + 1 is the FREE remainder, so the
+        // next small allocation carves it up contiguously.
+        free_block_hint_ = index + 1;
+        return offset;
+      }
+    }
+    return kInvalidOffset;
+  }
+  for (BlockIndex i = 0; i < count; ++i) {
+    Block &block = blocks_[i];
+    if (block.state == FREE && block.size >= size)
       return AllocInBlock(i, size);
   }
   return kInvalidOffset;
@@ -112,9 +112,20 @@ class GPU_EXPORT FencedAllocator {
 
   static const int32 kUnusedToken = 0;
 
+  // Allocations of at most this size take the ring fast path: the free-block
+  // search resumes after the previous small allocation (wrapping around), so
+  // transient uploads cycle through the buffer in roughly the order their
+  // tokens retire instead of repeatedly splitting the lowest free block.
+  static const unsigned int kSmallAllocationThreshold = 4096;
+
   // Gets the index of a memory block, given its offset.
   BlockIndex GetBlockByOffset(Offset offset);
 
+  // Looks for a FREE block big enough for the allocation and allocates in
+  // it. Small allocations use the ring fast path, larger ones are first-fit.
+  // Returns kInvalidOffset if no FREE block is big enough.
+  Offset AllocInFreeBlock(unsigned int size);
+
   // Collapse a free block with its neighbours if they are free. Returns the
   // index of the collapsed block.
   // NOTE: this will invalidate block indices.
@@ -134,6 +145,10 @@ class GPU_EXPORT FencedAllocator {
 
   CommandBufferHelper *helper_;
   Container blocks_;
+  // Index of the block where the small-allocation ring search resumes. This
+  // is only a hint: frees and collapses may invalidate it, so it is taken
+  // modulo the current block count.
+  BlockIndex free_block_hint_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(FencedAllocator);
 };
@@ -208,6 +208,67 @@ TEST_F(FencedAllocatorTest, TestFreePendingToken) {
   }
 }
 
+// Checks that small allocations cycle through the buffer instead of
+// immediately re-using freed space at low offsets.
+TEST_F(FencedAllocatorTest, SmallAllocationsRing) {
+  EXPECT_TRUE(allocator_->CheckConsistency());
+
+  const unsigned int kSize = 16;
+  FencedAllocator::Offset offset0 = allocator_->Alloc(kSize);
+  FencedAllocator::Offset offset1 = allocator_->Alloc(kSize);
+  EXPECT_EQ(offset0 + kSize, offset1);
+
+  // Freeing the first allocation leaves a hole at the start of the buffer,
+  // but the next small allocation keeps marching forward.
+  allocator_->Free(offset0);
+  FencedAllocator::Offset offset2 = allocator_->Alloc(kSize);
+  EXPECT_EQ(offset1 + kSize, offset2);
+  EXPECT_TRUE(allocator_->CheckConsistency());
+
+  allocator_->Free(offset1);
+  allocator_->Free(offset2);
+  EXPECT_FALSE(allocator_->InUse());
+}
+
+// Checks that an allocation that has to wait does so on the oldest pending
+// token, not on the pending block with the lowest offset.
+TEST_F(FencedAllocatorTest, WaitsOnOldestTokenFirst) {
+  EXPECT_TRUE(allocator_->CheckConsistency());
+
+  const unsigned int kSize = 16;
+  const unsigned int kAllocCount = kBufferSize / kSize;
+  CHECK(kAllocCount * kSize == kBufferSize);
+
+  // Allocate several buffers to fill in the memory.
+  FencedAllocator::Offset offsets[kAllocCount];
+  for (unsigned int i = 0; i < kAllocCount; ++i) {
+    offsets[i] = allocator_->Alloc(kSize);
+    EXPECT_NE(FencedAllocator::kInvalidOffset, offsets[i]);
+  }
+
+  // Free a block in the middle pending an old token, then the block with the
+  // lowest offset pending a newer one.
+  int32 old_token = helper_.get()->InsertToken();
+  allocator_->FreePendingToken(offsets[5], old_token);
+  int32 new_token = helper_.get()->InsertToken();
+  allocator_->FreePendingToken(offsets[0], new_token);
+  EXPECT_TRUE(allocator_->CheckConsistency());
+
+  // This allocation has to wait; it should reclaim the block with the oldest
+  // token even though a pending block at a lower offset exists.
+  FencedAllocator::Offset reclaimed = allocator_->Alloc(kSize);
+  EXPECT_EQ(offsets[5], reclaimed);
+  EXPECT_LE(old_token, GetToken());
+  EXPECT_TRUE(allocator_->CheckConsistency());
+
+  // Free up everything but offsets[0], which is still pending its token and
+  // is taken care of by the allocator's destructor.
+  for (unsigned int i = 1; i < kAllocCount; ++i) {
+    allocator_->Free(offsets[i]);
+    EXPECT_TRUE(allocator_->CheckConsistency());
+  }
+}
+
 // Checks the free-pending-token mechanism using FreeUnused
 TEST_F(FencedAllocatorTest, FreeUnused) {
   EXPECT_TRUE(allocator_->CheckConsistency());
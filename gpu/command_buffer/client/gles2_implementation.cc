@@ -592,30 +592,31 @@ GLenum GLES2Implementation::GetError() {
 
 GLenum GLES2Implementation::GetGLError() {
   TRACE_EVENT0("gpu", "GLES2::GetGLError");
-  // Check the GL error first, then our wrapped error.
-  typedef gles2::GetError::Result Result;
-  Result* result = GetResultAs<Result*>();
-  if (!result) {
-    return GL_NO_ERROR;
-  }
-  *result = GL_NO_ERROR;
-  helper_->GetError(GetResultShmId(), GetResultShmOffset());
-  WaitForCmd();
-  GLenum error = *result;
-  if (error == GL_NO_ERROR && error_bits_ != 0) {
+  // If there is a wrapped client side error, report it without a synchronous
+  // round trip to the service. GL allows pending errors to be returned in
+  // any order, and any service side error stays recorded until queried.
+  if (error_bits_ != 0) {
+    GLenum error = GL_NO_ERROR;
     for (uint32 mask = 1; mask != 0; mask = mask << 1) {
       if ((error_bits_ & mask) != 0) {
         error = GLES2Util::GLErrorBitToGLError(mask);
         break;
       }
     }
+    // Clear the corresponding wrapped error.
+    error_bits_ &= ~GLES2Util::GLErrorToErrorBit(error);
+    return error;
   }
 
-  if (error != GL_NO_ERROR) {
-    // There was an error, clear the corresponding wrapped error.
-    error_bits_ &= ~GLES2Util::GLErrorToErrorBit(error);
+  typedef gles2::GetError::Result Result;
+  Result* result = GetResultAs<Result*>();
+  if (!result) {
+    return GL_NO_ERROR;
   }
-  return error;
+  *result = GL_NO_ERROR;
+  helper_->GetError(GetResultShmId(), GetResultShmOffset());
+  WaitForCmd();
+  return *result;
 }
 
 void GLES2Implementation::SetGLError(GLenum error, const char* msg) {
@@ -811,6 +812,142 @@ bool GLES2Implementation::GetHelper(GLenum pname, GLint* params) {
         return true;
       }
       return false;
+    case GL_BLEND:
+    case GL_CULL_FACE:
+    case GL_DEPTH_TEST:
+    case GL_DITHER:
+    case GL_POLYGON_OFFSET_FILL:
+    case GL_SAMPLE_ALPHA_TO_COVERAGE:
+    case GL_SAMPLE_COVERAGE:
+    case GL_SCISSOR_TEST:
+    case GL_STENCIL_TEST: {
+      GLboolean enabled = GL_FALSE;
+      if (!GetEnableStateHelper(pname, &enabled)) {
+        return false;
+      }
+      *params = enabled;
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+void GLES2Implementation::SetEnableStateHelper(GLenum cap, bool enabled) {
+  switch (cap) {
+    case GL_BLEND:
+      enable_state_.blend = enabled;
+      break;
+    case GL_CULL_FACE:
+      enable_state_.cull_face = enabled;
+      break;
+    case GL_DEPTH_TEST:
+      enable_state_.depth_test = enabled;
+      break;
+    case GL_DITHER:
+      enable_state_.dither = enabled;
+      break;
+    case GL_POLYGON_OFFSET_FILL:
+      enable_state_.polygon_offset_fill = enabled;
+      break;
+    case GL_SAMPLE_ALPHA_TO_COVERAGE:
+      enable_state_.sample_alpha_to_coverage = enabled;
+      break;
+    case GL_SAMPLE_COVERAGE:
+      enable_state_.sample_coverage = enabled;
+      break;
+    case GL_SCISSOR_TEST:
+      enable_state_.scissor_test = enabled;
+      break;
+    case GL_STENCIL_TEST:
+      enable_state_.stencil_test = enabled;
+      break;
+    default:
+      // Unknown caps are validated by the service, which generates the
+      // GL error.
+      break;
+  }
+}
+
+bool GLES2Implementation::GetEnableStateHelper(
+    GLenum cap, GLboolean* enabled) const {
+  switch (cap) {
+    case GL_BLEND:
+      *enabled = enable_state_.blend;
+      break;
+    case GL_CULL_FACE:
+      *enabled = enable_state_.cull_face;
+      break;
+    case GL_DEPTH_TEST:
+      *enabled = enable_state_.depth_test;
+      break;
+    case GL_DITHER:
+      *enabled = enable_state_.dither;
+      break;
+    case GL_POLYGON_OFFSET_FILL:
+      *enabled = enable_state_.polygon_offset_fill;
+      break;
+    case GL_SAMPLE_ALPHA_TO_COVERAGE:
+      *enabled = enable_state_.sample_alpha_to_coverage;
+      break;
+    case GL_SAMPLE_COVERAGE:
+      *enabled = enable_state_.sample_coverage;
+      break;
+    case GL_SCISSOR_TEST:
+      *enabled = enable_state_.scissor_test;
+      break;
+    case GL_STENCIL_TEST:
+      *enabled = enable_state_.stencil_test;
+      break;
+    default:
+      // Not cached. The service also validates unknown caps and generates
+      // the GL error.
+      return false;
+  }
+  return true;
+}
+
+bool GLES2Implementation::GetBoundBufferHelper(
+    GLenum target, GLuint* buffer_id) const {
+  switch (target) {
+    case GL_ARRAY_BUFFER:
+      *buffer_id = bound_array_buffer_id_;
+      return true;
+    case GL_ELEMENT_ARRAY_BUFFER:
+      *buffer_id = bound_element_array_buffer_id_;
+      return true;
+    default:
+      return false;
+  }
+}
+
+void GLES2Implementation::UpdateBufferInfo(
+    GLenum target, GLsizeiptr size, GLenum usage) {
+  GLuint buffer_id = 0;
+  if (GetBoundBufferHelper(target, &buffer_id) && buffer_id != 0) {
+    buffer_infos_[buffer_id] = BufferInfo(size, usage);
+  }
+}
+
+bool GLES2Implementation::GetBufferParameterivHelper(
+    GLenum target, GLenum pname, GLint* params) {
+  // Only answer for buffers this context has defined; anything else falls
+  // through to the service, which also handles the error cases.
+  GLuint buffer_id = 0;
+  if (!GetBoundBufferHelper(target, &buffer_id) || buffer_id == 0) {
+    return false;
+  }
+  BufferInfoMap::const_iterator it = buffer_infos_.find(buffer_id);
+  if (it == buffer_infos_.end()) {
+    return false;
+  }
+  switch (pname) {
+    case GL_BUFFER_SIZE:
+      *params = static_cast<GLint>(it->second.size);
+      return true;
+    case GL_BUFFER_USAGE:
+      *params = static_cast<GLint>(it->second.usage);
+      return true;
     default:
       return false;
   }
@@ -1387,6 +1524,7 @@ void GLES2Implementation::BufferDataHelper(
   // If there is no data just send BufferData
   if (!data) {
     helper_->BufferData(target, size, 0, 0, usage);
+    UpdateBufferInfo(target, size, usage);
     return;
   }
 
@@ -1404,11 +1542,13 @@ void GLES2Implementation::BufferDataHelper(
         buffer.shm_id(),
         buffer.offset(),
         usage);
+    UpdateBufferInfo(target, size, usage);
     return;
   }
 
   // Make the buffer with BufferData then send via BufferSubData
   helper_->BufferData(target, size, 0, 0, usage);
+  UpdateBufferInfo(target, size, usage);
   BufferSubDataHelperImpl(target, 0, size, data, &buffer);
 }
 
@@ -2272,6 +2412,7 @@ void GLES2Implementation::DeleteBuffersHelper(
     if (buffers[ii] == bound_element_array_buffer_id_) {
       bound_element_array_buffer_id_ = 0;
     }
+    buffer_infos_.erase(buffers[ii]);
   }
 }
 
@@ -130,6 +130,33 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
     GLint num_shader_binary_formats;
   };
 
+  // Stores the enable state set by glEnable/glDisable so that glIsEnabled
+  // and the corresponding glGet queries can be answered without a round trip
+  // to the service.
+  struct EnableState {
+    EnableState()
+        : blend(false),
+          cull_face(false),
+          depth_test(false),
+          dither(true),
+          polygon_offset_fill(false),
+          sample_alpha_to_coverage(false),
+          sample_coverage(false),
+          scissor_test(false),
+          stencil_test(false) {
+    }
+
+    bool blend;
+    bool cull_face;
+    bool depth_test;
+    bool dither;
+    bool polygon_offset_fill;
+    bool sample_alpha_to_coverage;
+    bool sample_coverage;
+    bool scissor_test;
+    bool stencil_test;
+  };
+
   // The maxiumum result size from simple GL get commands.
   static const size_t kMaxSizeOfSimpleResult = 16 * sizeof(uint32);  // NOLINT.
 
@@ -300,6 +327,23 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
     GLsizeiptr size;
   };
 
+  // The size and usage of a buffer object as last set by glBufferData,
+  // tracked so glGetBufferParameteriv can be answered locally.
+  struct BufferInfo {
+    BufferInfo()
+        : size(0),
+          usage(GL_STATIC_DRAW) {
+    }
+    BufferInfo(GLsizeiptr _size, GLenum _usage)
+        : size(_size),
+          usage(_usage) {
+    }
+
+    GLsizeiptr size;
+    GLenum usage;
+  };
+  typedef std::map<GLuint, BufferInfo> BufferInfoMap;
+
   struct TextureUnit {
     TextureUnit()
         : bound_texture_2d(0),
@@ -421,6 +465,22 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
       const void* pixels, uint32 pixels_padded_row_size, GLboolean internal,
       ScopedTransferBufferPtr* buffer, uint32 buffer_padded_row_size);
 
+  // Updates the cached enable state for |cap|. Unknown caps are ignored and
+  // left for the service to validate.
+  void SetEnableStateHelper(GLenum cap, bool enabled);
+
+  // Gets the cached enable state for |cap|. Returns false for caps that are
+  // not cached; the caller must then query the service.
+  bool GetEnableStateHelper(GLenum cap, GLboolean* enabled) const;
+
+  // Gets the id of the buffer bound to |target|. Returns false if |target|
+  // is not a valid buffer target.
+  bool GetBoundBufferHelper(GLenum target, GLuint* buffer_id) const;
+
+  // Records the size and usage of the buffer bound to |target| as set by
+  // glBufferData.
+  void UpdateBufferInfo(GLenum target, GLsizeiptr size, GLenum usage);
+
   // Helpers for query functions.
   bool GetHelper(GLenum pname, GLint* params);
   bool GetBooleanvHelper(GLenum pname, GLboolean* params);
@@ -453,6 +513,8 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
 
   GLState gl_state_;
 
+  EnableState enable_state_;
+
   // pack alignment as last set by glPixelStorei
   GLint pack_alignment_;
 
@@ -519,6 +581,11 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
   typedef std::map<const void*, MappedBuffer> MappedBufferMap;
   MappedBufferMap mapped_buffers_;
 
+  // Tracks buffers this context has defined with glBufferData. Note that a
+  // buffer defined by another context in the share group is not tracked here,
+  // so queries for it still go to the service.
+  BufferInfoMap buffer_infos_;
+
   typedef std::map<const void*, MappedTexture> MappedTextureMap;
   MappedTextureMap mapped_textures_;
 
@@ -534,11 +601,6 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
   DISALLOW_COPY_AND_ASSIGN(GLES2Implementation);
 };
 
-inline bool GLES2Implementation::GetBufferParameterivHelper(
-    GLenum /* target */, GLenum /* pname */, GLint* /* params */) {
-  return false;
-}
-
 inline bool GLES2Implementation::GetFramebufferAttachmentParameterivHelper(
     GLenum /* target */,
     GLenum /* attachment */,
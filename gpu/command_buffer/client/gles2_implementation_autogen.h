@@ -353,6 +353,7 @@ void DetachShader(GLuint program, GLuint shader) {
 void Disable(GLenum cap) {
   GPU_CLIENT_SINGLE_THREAD_CHECK();
   GPU_CLIENT_LOG("[" << this << "] glDisable(" << GLES2Util::GetStringCapability(cap) << ")");  // NOLINT
+  SetEnableStateHelper(cap, false);
   helper_->Disable(cap);
 }
 
@@ -365,6 +366,7 @@ void Enable(GLenum cap) {
   GPU_CLIENT_SINGLE_THREAD_CHECK();
   GPU_CLIENT_LOG("[" << this << "] glEnable(" << GLES2Util::GetStringCapability(
       cap) << ")");
+  SetEnableStateHelper(cap, true);
   helper_->Enable(cap);
 }
 
@@ -831,6 +833,11 @@ GLboolean IsBuffer(GLuint buffer) {
 GLboolean IsEnabled(GLenum cap) {
   GPU_CLIENT_SINGLE_THREAD_CHECK();
   GPU_CLIENT_LOG("[" << this << "] glIsEnabled(" << GLES2Util::GetStringCapability(cap) << ")");  // NOLINT
+  GLboolean state = GL_FALSE;
+  if (GetEnableStateHelper(cap, &state)) {
+    GPU_CLIENT_LOG("returned " << state);
+    return state;
+  }
   typedef IsEnabled::Result Result;
   Result* result = GetResultAs<Result*>();
   if (!result) {
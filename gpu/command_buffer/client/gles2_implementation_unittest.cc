@@ -1197,21 +1197,8 @@ TEST_F(GLES2ImplementationTest, GetVertexAttrib) {
 }
 
 TEST_F(GLES2ImplementationTest, ReservedIds) {
-  // Only the get error command should be issued.
-  struct Cmds {
-    GetError get;
-  };
-  Cmds expected;
-
-  ExpectedMemoryInfo mem1 = GetExpectedResultMemory(sizeof(GetError::Result));
-
-  expected.get.Init(mem1.id, mem1.offset);
-
-  // One call to flush to wait for GetError
-  EXPECT_CALL(*command_buffer(), OnFlush())
-      .WillOnce(SetMemory(mem1.ptr, GLuint(GL_NO_ERROR)))
-      .RetiresOnSaturation();
-
+  // The error is generated client side so no commands should be issued;
+  // in particular glGetError should not round trip to the service.
   gl_->BindBuffer(
       GL_ARRAY_BUFFER,
       GLES2Implementation::kClientSideArrayId);
@@ -1220,7 +1207,7 @@ TEST_F(GLES2ImplementationTest, ReservedIds) {
       GLES2Implementation::kClientSideElementArrayId);
   GLenum err = gl_->GetError();
   EXPECT_EQ(static_cast<GLenum>(GL_INVALID_OPERATION), err);
-  EXPECT_EQ(0, memcmp(&expected, commands_, sizeof(expected)));
+  EXPECT_TRUE(NoCommandsWritten());
 }
 
 #endif  // defined(GLES2_SUPPORT_CLIENT_SIDE_ARRAYS)
@@ -1353,23 +1340,8 @@ TEST_F(GLES2ImplementationTest, MapUnmapBufferSubDataCHROMIUMBadArgs) {
   const GLintptr kOffset = 15;
   const GLsizeiptr kSize = 16;
 
-  ExpectedMemoryInfo result1 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result2 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result3 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result4 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-
-  // Calls to flush to wait for GetError
-  EXPECT_CALL(*command_buffer(), OnFlush())
-      .WillOnce(SetMemory(result1.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result2.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result3.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result4.ptr, GLuint(GL_NO_ERROR)))
-      .RetiresOnSaturation();
-
+  // The errors are generated client side, so glGetError does not round trip
+  // to the service.
   void* mem;
   mem = gl_->MapBufferSubDataCHROMIUM(kTarget, -1, kSize, GL_WRITE_ONLY);
   ASSERT_TRUE(mem == NULL);
@@ -1430,32 +1402,8 @@ TEST_F(GLES2ImplementationTest, MapUnmapTexSubImage2DCHROMIUMBadArgs) {
   const GLenum kFormat = GL_RGBA;
   const GLenum kType = GL_UNSIGNED_BYTE;
 
-  ExpectedMemoryInfo result1 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result2 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result3 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result4 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result5 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result6 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result7 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-
-  // Calls to flush to wait for GetError
-  EXPECT_CALL(*command_buffer(), OnFlush())
-      .WillOnce(SetMemory(result1.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result2.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result3.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result4.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result5.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result6.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result7.ptr, GLuint(GL_NO_ERROR)))
-      .RetiresOnSaturation();
-
+  // The errors are generated client side, so glGetError does not round trip
+  // to the service.
   void* mem;
   mem = gl_->MapTexSubImage2DCHROMIUM(
     GL_TEXTURE_2D,
@@ -1594,23 +1542,8 @@ TEST_F(GLES2ImplementationTest, GetMultipleIntegervCHROMIUMBadArgs) {
   const GLsizei kNumPnames = arraysize(pnames);
   const GLsizeiptr kResultsSize = num_results * sizeof(results[0]);
 
-  ExpectedMemoryInfo result1 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result2 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result3 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result4 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-
-  // Calls to flush to wait for GetError
-  EXPECT_CALL(*command_buffer(), OnFlush())
-      .WillOnce(SetMemory(result1.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result2.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result3.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result4.ptr, GLuint(GL_NO_ERROR)))
-      .RetiresOnSaturation();
-
+  // The errors are generated client side, so glGetError does not round trip
+  // to the service.
   const GLint kSentinel = 0x12345678;
   memset(results, 0, sizeof(results));
   results[num_results] = kSentinel;
@@ -1705,19 +1638,12 @@ TEST_F(GLES2ImplementationTest, GetProgramInfoCHROMIUMBadArgs) {
   ExpectedMemoryInfo mem1 = GetExpectedMemory(MaxTransferBufferSize());
   ExpectedMemoryInfo result1 =
       GetExpectedResultMemory(sizeof(cmd::GetBucketStart::Result));
-  ExpectedMemoryInfo result2 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result3 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
-  ExpectedMemoryInfo result4 =
-      GetExpectedResultMemory(sizeof(GetError::Result));
 
+  // The errors are generated client side, so glGetError does not round trip
+  // to the service.
   EXPECT_CALL(*command_buffer(), OnFlush())
       .WillOnce(DoAll(SetMemory(result1.ptr, uint32(sizeof(kString))),
                       SetMemory(mem1.ptr,  kString)))
-      .WillOnce(SetMemory(result2.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result3.ptr, GLuint(GL_NO_ERROR)))
-      .WillOnce(SetMemory(result4.ptr, GLuint(GL_NO_ERROR)))
       .RetiresOnSaturation();
 
   // try bufsize not big enough.
@@ -1836,6 +1762,41 @@ TEST_F(GLES2ImplementationTest, GetIntegerCacheWrite) {
   EXPECT_EQ(static_cast<GLenum>(GL_NO_ERROR), gl_->GetError());
 }
 
+TEST_F(GLES2ImplementationTest, IsEnabledCache) {
+  // Initially everything but GL_DITHER is disabled and the answers come from
+  // the cache without a round trip to the service.
+  EXPECT_FALSE(gl_->IsEnabled(GL_BLEND));
+  EXPECT_TRUE(gl_->IsEnabled(GL_DITHER));
+  EXPECT_TRUE(NoCommandsWritten());
+
+  gl_->Enable(GL_BLEND);
+  gl_->Disable(GL_DITHER);
+  ClearCommands();
+
+  EXPECT_TRUE(gl_->IsEnabled(GL_BLEND));
+  EXPECT_FALSE(gl_->IsEnabled(GL_DITHER));
+  GLint v = -1;
+  gl_->GetIntegerv(GL_BLEND, &v);
+  EXPECT_EQ(1, v);
+  EXPECT_TRUE(NoCommandsWritten());
+}
+
+TEST_F(GLES2ImplementationTest, GetBufferParameterCache) {
+  const GLsizeiptr kSize = 32;
+
+  gl_->BindBuffer(GL_ARRAY_BUFFER, 2);
+  gl_->BufferData(GL_ARRAY_BUFFER, kSize, NULL, GL_DYNAMIC_DRAW);
+  ClearCommands();
+
+  GLint size = -1;
+  gl_->GetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+  EXPECT_EQ(kSize, size);
+  GLint usage = -1;
+  gl_->GetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_USAGE, &usage);
+  EXPECT_EQ(GL_DYNAMIC_DRAW, usage);
+  EXPECT_TRUE(NoCommandsWritten());
+}
+
 static bool CheckRect(
     int width, int height, GLenum format, GLenum type, int alignment,
     bool flip_y, const uint8* r1, const uint8* r2) {
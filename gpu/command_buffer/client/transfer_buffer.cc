@@ -50,8 +50,16 @@ bool TransferBuffer::Initialize(
 }
 
 void TransferBuffer::Free() {
-  if (HaveBuffer()) {
+  if (HaveBuffer() || !retired_buffers_.empty()) {
     helper_->Finish();
+  }
+  // The Finish above guarantees that every retired buffer's token has passed.
+  while (!retired_buffers_.empty()) {
+    helper_->command_buffer()->DestroyTransferBuffer(
+        retired_buffers_.front().id);
+    retired_buffers_.pop_front();
+  }
+  if (HaveBuffer()) {
     helper_->command_buffer()->DestroyTransferBuffer(buffer_id_);
     buffer_id_ = -1;
     buffer_.ptr = NULL;
@@ -73,12 +81,45 @@ RingBuffer::Offset TransferBuffer::GetOffset(void* pointer) const {
 
 void TransferBuffer::FreePendingToken(void* p, unsigned int token) {
   ring_buffer_->FreePendingToken(p, token);
+  FreeRetiredBuffers();
   if (bytes_since_last_flush_ >= size_to_flush_ && size_to_flush_ > 0) {
     helper_->Flush();
     bytes_since_last_flush_ = 0;
   }
 }
 
+// The old buffer must stay alive until the commands that reference it have
+// been processed, but that doesn't require stalling: a token inserted here
+// can only pass once those commands have run, so we queue the buffer and
+// destroy it when the token does.
+void TransferBuffer::RetireRingBuffer() {
+  if (!HaveBuffer()) {
+    return;
+  }
+  retired_buffers_.push_back(
+      RetiredBuffer(buffer_id_, helper_->InsertToken()));
+  buffer_id_ = -1;
+  buffer_.ptr = NULL;
+  buffer_.size = 0;
+  result_buffer_ = NULL;
+  result_shm_offset_ = 0;
+  ring_buffer_.reset();
+  bytes_since_last_flush_ = 0;
+}
+
+void TransferBuffer::FreeRetiredBuffers() {
+  if (retired_buffers_.empty()) {
+    return;
+  }
+  int32 last_token_read = helper_->last_token_read();
+  while (!retired_buffers_.empty() &&
+         retired_buffers_.front().token <= last_token_read) {
+    helper_->command_buffer()->DestroyTransferBuffer(
+        retired_buffers_.front().id);
+    retired_buffers_.pop_front();
+  }
+}
+
 void TransferBuffer::AllocateRingBuffer(unsigned int size) {
   for (;size >= min_buffer_size_; size /= 2) {
     int32 id = helper_->command_buffer()->CreateTransferBuffer(size, -1);
@@ -142,18 +183,30 @@ void TransferBuffer::ReallocateRingBuffer(unsigned int size) {
   needed_buffer_size = std::min(needed_buffer_size, max_buffer_size_);
 
   if (usable_ && (!HaveBuffer() || needed_buffer_size > buffer_.size)) {
-    if (HaveBuffer()) {
-      Free();
-    }
+    RetireRingBuffer();
     AllocateRingBuffer(needed_buffer_size);
   }
 }
 
+void TransferBuffer::GrowRingBufferForDemand(unsigned int size) {
+  if (!HaveBuffer() || buffer_.size >= max_buffer_size_) {
+    return;
+  }
+  if (size <= ring_buffer_->GetLargestFreeSizeNoWaiting()) {
+    return;
+  }
+  // The remaining space is all tied up by in-flight allocations. Ask for the
+  // current size plus the request, which at least doubles the buffer.
+  ReallocateRingBuffer(buffer_.size - result_size_ + size);
+}
+
 void* TransferBuffer::AllocUpTo(
     unsigned int size, unsigned int* size_allocated) {
   GPU_DCHECK(size_allocated);
 
   ReallocateRingBuffer(size);
+  GrowRingBufferForDemand(size);
+  FreeRetiredBuffers();
 
   if (!HaveBuffer()) {
     return NULL;
@@ -167,6 +220,8 @@ void* TransferBuffer::AllocUpTo(
 
 void* TransferBuffer::Alloc(unsigned int size) {
   ReallocateRingBuffer(size);
+  GrowRingBufferForDemand(size);
+  FreeRetiredBuffers();
 
   if (!HaveBuffer()) {
     return NULL;
@@ -5,6 +5,8 @@
 #ifndef GPU_COMMAND_BUFFER_CLIENT_TRANSFER_BUFFER_H_
 #define GPU_COMMAND_BUFFER_CLIENT_TRANSFER_BUFFER_H_
 
+#include <deque>
+
 #include "../../gpu_export.h"
 #include "../common/buffer.h"
 #include "../common/compiler_specific.h"
@@ -114,14 +116,42 @@ class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
   unsigned int GetMaxAllocation() const;
 
  private:
+  // A buffer that has been replaced by a larger one but may still be
+  // referenced by commands that have not been processed yet. It is destroyed
+  // once its token has passed.
+  struct RetiredBuffer {
+    RetiredBuffer(int32 _id, int32 _token)
+        : id(_id),
+          token(_token) {
+    }
+    int32 id;
+    int32 token;
+  };
+
   // Tries to reallocate the ring buffer if it's not large enough for size.
   void ReallocateRingBuffer(unsigned int size);
 
   void AllocateRingBuffer(unsigned int size);
 
+  // Grows the ring buffer if the requested size cannot be allocated without
+  // waiting on a token, so that a buffer full of in-flight uploads does not
+  // stall the client. Growth is capped at max_buffer_size_; once at the cap
+  // allocations fall back to waiting.
+  void GrowRingBufferForDemand(unsigned int size);
+
+  // Queues the current buffer for destruction once the commands written so
+  // far have been processed, instead of stalling on Finish.
+  void RetireRingBuffer();
+
+  // Destroys retired buffers whose tokens have passed.
+  void FreeRetiredBuffers();
+
   CommandBufferHelper* helper_;
   scoped_ptr<AlignedRingBuffer> ring_buffer_;
 
+  // Buffers waiting for their token to pass before they can be destroyed.
+  std::deque<RetiredBuffer> retired_buffers_;
+
   // size reserved for results
   unsigned int result_size_;
 
@@ -345,6 +345,46 @@ TEST_F(TransferBufferExpandContractTest, Expand) {
   EXPECT_EQ(kSize2, size_allocated);
   EXPECT_EQ(kSize2, transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
   transfer_buffer_->FreePendingToken(ptr, 1);
+
+  // Retiring the old buffers inserted tokens, which the Finish on teardown
+  // has to flush.
+  EXPECT_CALL(*command_buffer(), OnFlush())
+      .Times(1)
+      .RetiresOnSaturation();
+}
+
+TEST_F(TransferBufferExpandContractTest, ExpandWithInFlightAllocation) {
+  const size_t kSize1 = kStartTransferBufferSize - kStartingOffset;
+  unsigned int size_allocated = 0;
+  void* ptr = transfer_buffer_->AllocUpTo(kSize1, &size_allocated);
+  ASSERT_TRUE(ptr != NULL);
+  EXPECT_EQ(kSize1, size_allocated);
+  // Free with a token that has not been reached, so the space stays tied up
+  // by an in-flight allocation.
+  transfer_buffer_->FreePendingToken(ptr, 10001);
+
+  // The next allocation does not fit without waiting on the token, so the
+  // buffer should grow instead. The old buffer is destroyed once its
+  // retirement token has passed.
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*command_buffer(),
+              CreateTransferBuffer(kStartTransferBufferSize * 2, _))
+      .WillOnce(Invoke(
+          command_buffer(),
+          &MockClientCommandBufferCanFail::RealCreateTransferBuffer))
+      .RetiresOnSaturation();
+  ptr = transfer_buffer_->AllocUpTo(kSize1, &size_allocated);
+  ASSERT_TRUE(ptr != NULL);
+  EXPECT_EQ(kSize1, size_allocated);
+  transfer_buffer_->FreePendingToken(ptr, 1);
+
+  // Retiring the old buffer inserted a token, which the Finish on teardown
+  // has to flush.
+  EXPECT_CALL(*command_buffer(), OnFlush())
+      .Times(1)
+      .RetiresOnSaturation();
 }
 
 TEST_F(TransferBufferExpandContractTest, Contract) {
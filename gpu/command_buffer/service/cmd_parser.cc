@@ -10,12 +10,15 @@
 
 namespace gpu {
 
+const int CommandParser::kParseCommandsSlice;
+
 CommandParser::CommandParser(AsyncAPIInterface* handler)
     : get_(0),
       put_(0),
       buffer_(NULL),
       entry_count_(0),
-      handler_(handler) {
+      handler_(handler),
+      stop_processing_(false) {
 }
 
 void CommandParser::SetBuffer(
@@ -38,41 +41,65 @@ void CommandParser::SetBuffer(
 
 // Process one command, reading the header from the command buffer, and
 // forwarding the command index and the arguments to the handler.
+error::Error CommandParser::ProcessCommand() {
+  return ProcessCommands(1);
+}
+
+// Processes commands in one tight loop, reading each header from the command
+// buffer and forwarding the command index and the arguments to the handler.
+// The buffer pointer, entry count and put offset are hoisted out of the loop;
+// get_ is only re-read to detect jumps performed by the handler through
+// set_get().
 // Note that:
 // - validation needs to happen on a copy of the data (to avoid race
 // conditions). This function only validates the header, leaving the arguments
 // validation to the handler, so it can pass a reference to them.
-// - get_ is modified *after* the command has been executed.
-error::Error CommandParser::ProcessCommand() {
-  CommandBufferOffset get = get_;
-  if (get == put_)
-    return error::kNoError;
-
-  CommandHeader header = buffer_[get].value_header;
-  if (header.size == 0) {
-    DVLOG(1) << "Error: zero sized command in command buffer";
-    return error::kInvalidSize;
-  }
+// - get_ is modified *after* each command has been executed.
+error::Error CommandParser::ProcessCommands(int num_commands) {
+  const CommandBufferEntry* buffer = buffer_;
+  int32 entry_count = entry_count_;
+  CommandBufferOffset put = put_;
+  stop_processing_ = false;
 
-  if (static_cast<int>(header.size) + get > entry_count_) {
-    DVLOG(1) << "Error: get offset out of bounds";
-    return error::kOutOfBounds;
-  }
+  for (int i = 0; i < num_commands; ++i) {
+    CommandBufferOffset get = get_;
+    if (get == put)
+      break;
 
-  error::Error result = handler_->DoCommand(
-      header.command, header.size - 1, buffer_ + get);
+    CommandHeader header = buffer[get].value_header;
+    if (header.size == 0) {
+      DVLOG(1) << "Error: zero sized command in command buffer";
+      return error::kInvalidSize;
+    }
 
-  // TODO(gman): If you want to log errors this is the best place to catch them.
-  //     It seems like we need an official way to turn on a debug mode and
-  //     get these errors.
-  if (error::IsError(result)) {
-    ReportError(header.command, result);
-  }
+    if (static_cast<int>(header.size) + get > entry_count) {
+      DVLOG(1) << "Error: get offset out of bounds";
+      return error::kOutOfBounds;
+    }
+
+    error::Error result = handler_->DoCommand(
+        header.command, header.size - 1, buffer + get);
+
+    // TODO(gman): If you want to log errors this is the best place to catch
+    //     them. It seems like we need an official way to turn on a debug mode
+    //     and get these errors.
+    if (error::IsError(result)) {
+      ReportError(header.command, result);
+    }
+
+    // If get was not set somewhere else advance it.
+    if (get == get_)
+      get_ = (get + header.size) % entry_count;
 
-  // If get was not set somewhere else advance it.
-  if (get == get_)
-    get_ = (get + header.size) % entry_count_;
-  return result;
+    if (error::IsError(result))
+      return result;
+
+    // A command may have unscheduled further processing (e.g. to throttle on
+    // a pending swap); the commands after it must wait.
+    if (stop_processing_)
+      break;
+  }
+  return error::kNoError;
 }
 
 void CommandParser::ReportError(unsigned int command_id,
@@ -82,12 +109,14 @@ void CommandParser::ReportError(unsigned int command_id,
 }
 
 // Processes all the commands, while the buffer is not empty. Stop if an error
-// is encountered.
+// is encountered or processing is stopped from within a command.
 error::Error CommandParser::ProcessAllCommands() {
   while (!IsEmpty()) {
-    error::Error error = ProcessCommand();
+    error::Error error = ProcessCommands(kParseCommandsSlice);
     if (error)
       return error;
+    if (stop_processing_)
+      return error::kNoError;
   }
   return error::kNoError;
 }
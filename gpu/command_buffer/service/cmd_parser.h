@@ -57,18 +57,37 @@ class GPU_EXPORT CommandParser {
   // if there are no commands in the buffer.
   error::Error ProcessCommand();
 
+  // Processes up to |num_commands| commands in one pass, updating the get
+  // pointer as each command completes. Decoding the common header and the
+  // buffer bounds checks stay in one tight loop rather than paying a full
+  // call per command. Returns when the buffer empties, on the first error,
+  // or after StopProcessingCommands() is called while a command executes.
+  error::Error ProcessCommands(int num_commands);
+
   // Processes all commands until get == put.
   error::Error ProcessAllCommands();
 
+  // Causes ProcessCommands() to return after the command that is currently
+  // executing. Used when a command unschedules further processing (for
+  // example to throttle on a pending swap); the commands after it must not
+  // run until processing is explicitly resumed.
+  void StopProcessingCommands() { stop_processing_ = true; }
+
   // Reports an error.
   void ReportError(unsigned int command_id, error::Error result);
 
+  // The number of commands to process per ProcessCommands() call when the
+  // caller wants to do per-slice work (publishing the get offset, poking the
+  // watchdog) between batches of commands.
+  static const int kParseCommandsSlice = 20;
+
  private:
   CommandBufferOffset get_;
   CommandBufferOffset put_;
   CommandBufferEntry* buffer_;
   int32 entry_count_;
   AsyncAPIInterface* handler_;
+  bool stop_processing_;
 };
 
 // This class defines the interface for an asynchronous API handler, that
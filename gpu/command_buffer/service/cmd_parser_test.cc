@@ -12,6 +12,8 @@
 
 namespace gpu {
 
+using testing::DoAll;
+using testing::InvokeWithoutArgs;
 using testing::Return;
 using testing::Mock;
 using testing::Truly;
@@ -169,6 +171,66 @@ TEST_F(CommandParserTest, TestMultipleCommands) {
   Mock::VerifyAndClearExpectations(api_mock());
 }
 
+// Tests that ProcessCommands() stops after |num_commands| commands.
+TEST_F(CommandParserTest, TestProcessCommandsSlice) {
+  scoped_ptr<CommandParser> parser(MakeParser(10));
+  CommandBufferOffset put = parser->put();
+  CommandHeader header;
+
+  // add 3 commands with no args (1 word each)
+  for (unsigned int i = 0; i < 3; ++i) {
+    header.size = 1;
+    header.command = i;
+    buffer()[put++].value_header = header;
+  }
+  parser->set_put(put);
+  EXPECT_EQ(put, parser->put());
+
+  AddDoCommandExpect(error::kNoError, 0, 0, NULL);
+  AddDoCommandExpect(error::kNoError, 1, 0, NULL);
+  EXPECT_EQ(error::kNoError, parser->ProcessCommands(2));
+  EXPECT_EQ(2, parser->get());
+  Mock::VerifyAndClearExpectations(api_mock());
+
+  AddDoCommandExpect(error::kNoError, 2, 0, NULL);
+  EXPECT_EQ(error::kNoError, parser->ProcessCommands(2));
+  EXPECT_EQ(put, parser->get());
+  Mock::VerifyAndClearExpectations(api_mock());
+}
+
+// Tests that StopProcessingCommands() ends the slice after the command that
+// is currently executing.
+TEST_F(CommandParserTest, TestStopProcessingCommands) {
+  scoped_ptr<CommandParser> parser(MakeParser(10));
+  CommandBufferOffset put = parser->put();
+  CommandHeader header;
+
+  // add 2 commands with no args (1 word each)
+  for (unsigned int i = 0; i < 2; ++i) {
+    header.size = 1;
+    header.command = i;
+    buffer()[put++].value_header = header;
+  }
+  parser->set_put(put);
+  EXPECT_EQ(put, parser->put());
+
+  // The first command requests a stop, so the second must not run until the
+  // next call to ProcessCommands().
+  EXPECT_CALL(*api_mock(), DoCommand(0, 0, _))
+      .WillOnce(DoAll(
+          InvokeWithoutArgs(parser.get(),
+                            &CommandParser::StopProcessingCommands),
+          Return(error::kNoError)));
+  EXPECT_EQ(error::kNoError, parser->ProcessCommands(2));
+  EXPECT_EQ(1, parser->get());
+  Mock::VerifyAndClearExpectations(api_mock());
+
+  AddDoCommandExpect(error::kNoError, 1, 0, NULL);
+  EXPECT_EQ(error::kNoError, parser->ProcessCommands(2));
+  EXPECT_EQ(put, parser->get());
+  Mock::VerifyAndClearExpectations(api_mock());
+}
+
 // Tests that the parser will wrap correctly at the end of the buffer.
 TEST_F(CommandParserTest, TestWrap) {
   scoped_ptr<CommandParser> parser(MakeParser(5));
@@ -1185,6 +1185,12 @@ class GLES2DecoderImpl : public base::SupportsWeakPtr<GLES2DecoderImpl>,
   // Checks if the current program and vertex attributes are valid for drawing.
   bool IsDrawValid(GLuint max_vertex_accessed, GLsizei primcount);
 
+  // Invalidates the result cached from the last successful IsDrawValid()
+  // call. Must be called whenever state that check depends on changes: the
+  // current program or its link state, which vertex attribs are enabled,
+  // their pointers or divisors, or the size of a buffer an attrib reads.
+  void MarkDrawValidationDirty();
+
   // Returns true if successful, simulated will be true if attrib0 was
   // simulated.
   bool SimulateAttrib0(
@@ -1422,6 +1428,14 @@ class GLES2DecoderImpl : public base::SupportsWeakPtr<GLES2DecoderImpl>,
   // The program in use by glUseProgram
   ProgramManager::ProgramInfo::Ref current_program_;
 
+  // The last draw call state validated by IsDrawValid(). NULL when no cached
+  // validation is available. |validated_program_| is only ever compared
+  // against |current_program_|, never dereferenced, and is cleared by
+  // MarkDrawValidationDirty() before any cached program can be destroyed.
+  ProgramManager::ProgramInfo* validated_program_;
+  GLuint validated_max_vertex_accessed_;
+  GLsizei validated_primcount_;
+
   // The currently bound framebuffers
   FramebufferManager::FramebufferInfo::Ref bound_read_framebuffer_;
   FramebufferManager::FramebufferInfo::Ref bound_draw_framebuffer_;
@@ -1893,6 +1907,9 @@ GLES2DecoderImpl::GLES2DecoderImpl(ContextGroup* group)
       enable_depth_test_(false),
       enable_stencil_test_(false),
       state_dirty_(true),
+      validated_program_(NULL),
+      validated_max_vertex_accessed_(0),
+      validated_primcount_(0),
       offscreen_target_color_format_(0),
       offscreen_target_depth_format_(0),
       offscreen_target_stencil_format_(0),
@@ -2379,6 +2396,7 @@ void GLES2DecoderImpl::DeleteBuffersHelper(
     BufferManager::BufferInfo* buffer = GetBufferInfo(client_ids[ii]);
     if (buffer && !buffer->IsDeleted()) {
       vertex_attrib_manager_->Unbind(buffer);
+      MarkDrawValidationDirty();
       if (bound_array_buffer_ == buffer) {
         bound_array_buffer_ = NULL;
       }
@@ -3436,6 +3454,7 @@ void GLES2DecoderImpl::DoBindTexture(GLenum target, GLuint client_id) {
 
 void GLES2DecoderImpl::DoDisableVertexAttribArray(GLuint index) {
   if (vertex_attrib_manager_->Enable(index, false)) {
+    MarkDrawValidationDirty();
     if (index != 0 ||
         gfx::GetGLImplementation() == gfx::kGLImplementationEGLGLES2) {
       glDisableVertexAttribArray(index);
@@ -3448,6 +3467,7 @@ void GLES2DecoderImpl::DoDisableVertexAttribArray(GLuint index) {
 
 void GLES2DecoderImpl::DoEnableVertexAttribArray(GLuint index) {
   if (vertex_attrib_manager_->Enable(index, true)) {
+    MarkDrawValidationDirty();
     glEnableVertexAttribArray(index);
   } else {
     SetGLError(GL_INVALID_VALUE,
@@ -4486,6 +4506,8 @@ void GLES2DecoderImpl::DoLinkProgram(GLuint program) {
   if (info->Link()) {
     if (info == current_program_.get()) {
       program_manager()->ClearUniforms(info);
+      // Relinking can change which attrib locations the program uses.
+      MarkDrawValidationDirty();
     }
   }
 };
@@ -4809,6 +4831,9 @@ void GLES2DecoderImpl::DoUseProgram(GLuint program) {
     program_manager()->UnuseProgram(shader_manager(), current_program_);
   }
   current_program_ = info;
+  // Always invalidate, even when re-using a program, since a new ProgramInfo
+  // could have been allocated at the address of a cached one.
+  MarkDrawValidationDirty();
   glUseProgram(service_id);
   if (current_program_) {
     program_manager()->UseProgram(current_program_);
@@ -4971,6 +4996,10 @@ bool GLES2DecoderImpl::ClearUnclearedTextures() {
   return true;
 }
 
+void GLES2DecoderImpl::MarkDrawValidationDirty() {
+  validated_program_ = NULL;
+}
+
 bool GLES2DecoderImpl::IsDrawValid(
     GLuint max_vertex_accessed, GLsizei primcount) {
   // NOTE: We specifically do not check current_program->IsValid() because
@@ -4983,6 +5012,19 @@ bool GLES2DecoderImpl::IsDrawValid(
     return false;
   }
 
+  // If nothing this check depends on has changed since the last successful
+  // validation then a draw that accesses no more vertices or instances than
+  // that one cannot newly fail, since MaxVertexAccessed() is monotonic in
+  // both arguments. Instanced and non-instanced draws compute vertex counts
+  // differently for attribs with non-zero divisors, so only draws of the same
+  // kind can share a cached result.
+  if (current_program_.get() == validated_program_ &&
+      max_vertex_accessed <= validated_max_vertex_accessed_ &&
+      primcount <= validated_primcount_ &&
+      (primcount != 0) == (validated_primcount_ != 0)) {
+    return true;
+  }
+
   // true if any enabled, used divisor is zero
   bool divisor0 = false;
   // Validate all attribs currently enabled. If they are used by the current
@@ -5025,6 +5067,9 @@ bool GLES2DecoderImpl::IsDrawValid(
     return false;
   }
 
+  validated_program_ = current_program_.get();
+  validated_max_vertex_accessed_ = max_vertex_accessed;
+  validated_primcount_ = primcount;
   return true;
 }
 
@@ -6031,6 +6076,7 @@ error::Error GLES2DecoderImpl::HandleVertexAttribPointer(
       stride,
       stride != 0 ? stride : component_size * size,
       offset);
+  MarkDrawValidationDirty();
   if (type != GL_FIXED) {
     glVertexAttribPointer(indx, size, type, normalized, stride, ptr);
   }
@@ -6063,6 +6109,7 @@ error::Error GLES2DecoderImpl::HandleVertexAttribDivisorANGLE(
   vertex_attrib_manager_->SetDivisor(
       index,
       divisor);
+  MarkDrawValidationDirty();
   glVertexAttribDivisorANGLE(index, divisor);
   return error::kNoError;
 }
@@ -6501,6 +6548,9 @@ void GLES2DecoderImpl::DoBufferData(
   if (error == GL_NO_ERROR) {
     buffer_manager()->SetInfo(info, size, usage);
     info->SetRange(0, size, data);
+    // The buffer's size may have changed, which changes how many vertices
+    // attribs bound to it can supply.
+    MarkDrawValidationDirty();
   }
 }
 
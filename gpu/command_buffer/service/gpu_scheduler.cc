@@ -61,12 +61,20 @@ void GpuScheduler::PutChanged() {
   if (!IsScheduled())
     return;
 
+  base::TimeTicks begin_ticks;
+  if (command_processing_budget_ != base::TimeDelta())
+    begin_ticks = base::TimeTicks::Now();
+
   error::Error error = error::kNoError;
   while (!parser_->IsEmpty()) {
     DCHECK(IsScheduled());
     DCHECK(unschedule_fences_.empty());
 
-    error = parser_->ProcessCommand();
+    // Process commands a slice at a time, so that the get offset publication
+    // and the watchdog accounting below happen once per slice rather than
+    // once per command. WebGL-heavy pages submit hundreds of thousands of
+    // commands per frame, so the per-command overhead adds up.
+    error = parser_->ProcessCommands(CommandParser::kParseCommandsSlice);
 
     // TODO(piman): various classes duplicate various pieces of state, leading
     // to needlessly complex update logic. It should be possible to simply
@@ -86,6 +94,16 @@ void GpuScheduler::PutChanged() {
 
     if (unscheduled_count_ > 0)
       return;
+
+    // Preemption point: once this context has used up its time slice, leave
+    // the remaining commands in the buffer. The stub notices it still has
+    // unprocessed commands and reschedules them, giving other contexts a
+    // chance to run first.
+    if (!begin_ticks.is_null() &&
+        base::TimeTicks::Now() - begin_ticks >= command_processing_budget_) {
+      TRACE_EVENT0("gpu", "GpuScheduler:TimeSliceExpired");
+      return;
+    }
   }
 }
 
@@ -129,6 +147,11 @@ void GpuScheduler::SetScheduled(bool scheduled) {
     }
 
     ++unscheduled_count_;
+
+    // If this happens from within a command, the rest of the current slice
+    // of commands must not run until we are rescheduled.
+    if (parser_.get())
+      parser_->StopProcessingCommands();
   }
 }
 
@@ -141,6 +164,10 @@ bool GpuScheduler::HasMoreWork() {
          (decoder_ && decoder_->ProcessPendingQueries());
 }
 
+void GpuScheduler::SetCommandProcessingBudget(base::TimeDelta budget) {
+  command_processing_budget_ = budget;
+}
+
 void GpuScheduler::SetScheduledCallback(
     const base::Closure& scheduled_callback) {
   scheduled_callback_ = scheduled_callback;
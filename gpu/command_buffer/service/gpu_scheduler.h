@@ -12,6 +12,7 @@
 #include "base/memory/linked_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/shared_memory.h"
+#include "base/time.h"
 #include "gpu/command_buffer/common/command_buffer.h"
 #include "gpu/command_buffer/service/cmd_buffer_engine.h"
 #include "gpu/command_buffer/service/cmd_parser.h"
@@ -52,6 +53,12 @@ class GPU_EXPORT GpuScheduler
   // Returns whether the scheduler needs to be polled again in the future.
   bool HasMoreWork();
 
+  // Sets a soft cap on how long a single PutChanged invocation may spend
+  // processing commands. A zero budget (the default) means no cap. When the
+  // budget runs out, PutChanged returns with commands still pending; the
+  // owner is expected to reschedule the remaining work.
+  void SetCommandProcessingBudget(base::TimeDelta budget);
+
   // Sets a callback that is invoked just before scheduler is rescheduled.
   // Takes ownership of callback object.
   void SetScheduledCallback(const base::Closure& scheduled_callback);
@@ -98,6 +105,10 @@ class GPU_EXPORT GpuScheduler
   // This should be an argument to the constructor.
   scoped_ptr<CommandParser> parser_;
 
+  // Maximum time a single PutChanged invocation may spend processing
+  // commands. Zero means unlimited.
+  base::TimeDelta command_processing_budget_;
+
   // Greater than zero if this is waiting to be rescheduled before continuing.
   int unscheduled_count_;
 
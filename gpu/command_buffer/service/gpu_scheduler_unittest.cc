@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "base/message_loop.h"
+#include "base/threading/platform_thread.h"
 #include "gpu/command_buffer/common/command_buffer_mock.h"
 #include "gpu/command_buffer/service/gpu_scheduler.h"
 #include "gpu/command_buffer/service/gles2_cmd_decoder.h"
@@ -18,6 +19,7 @@
 using testing::_;
 using testing::DoAll;
 using testing::Invoke;
+using testing::InvokeWithoutArgs;
 using testing::NiceMock;
 using testing::Return;
 using testing::SetArgumentPointee;
@@ -28,6 +30,12 @@ namespace gpu {
 const size_t kRingBufferSize = 1024;
 const size_t kRingBufferEntries = kRingBufferSize / sizeof(CommandBufferEntry);
 
+// Sleeps long enough that any non-zero command processing budget has expired
+// by the time the clock is read again.
+void BurnTimeSlice() {
+  base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(2));
+}
+
 class GpuSchedulerTest : public testing::Test {
  protected:
   static const int32 kTransferBufferId = 123;
@@ -148,15 +156,51 @@ TEST_F(GpuSchedulerTest, ProcessesTwoCommands) {
 
   EXPECT_CALL(*decoder_, DoCommand(7, 1, &buffer_[0]))
     .WillOnce(Return(error::kNoError));
-  EXPECT_CALL(*command_buffer_, SetGetOffset(2));
-
   EXPECT_CALL(*decoder_, DoCommand(8, 0, &buffer_[2]))
     .WillOnce(Return(error::kNoError));
+
+  // Both commands fit in one slice, so the get offset is only published once,
+  // after the slice completes.
   EXPECT_CALL(*command_buffer_, SetGetOffset(3));
 
   scheduler_->PutChanged();
 }
 
+TEST_F(GpuSchedulerTest, PreemptsWhenBudgetExhausted) {
+  const int32 kNumCommands = CommandParser::kParseCommandsSlice + 1;
+  CommandHeader* header = reinterpret_cast<CommandHeader*>(&buffer_[0]);
+  for (int32 ii = 0; ii < kNumCommands; ++ii) {
+    header[ii].command = 7;
+    header[ii].size = 1;
+  }
+
+  scheduler_->SetCommandProcessingBudget(
+      base::TimeDelta::FromMicroseconds(1));
+
+  CommandBuffer::State state;
+  state.put_offset = kNumCommands;
+  EXPECT_CALL(*command_buffer_, GetState())
+    .WillRepeatedly(Return(state));
+
+  // The first command burns enough time to exhaust the budget, so only the
+  // first slice of commands is processed before the scheduler yields.
+  EXPECT_CALL(*decoder_, DoCommand(7, 0, _))
+    .Times(kNumCommands)
+    .WillOnce(DoAll(InvokeWithoutArgs(&BurnTimeSlice),
+                    Return(error::kNoError)))
+    .WillRepeatedly(Return(error::kNoError));
+
+  EXPECT_CALL(*command_buffer_,
+              SetGetOffset(CommandParser::kParseCommandsSlice));
+  scheduler_->PutChanged();
+  EXPECT_EQ(CommandParser::kParseCommandsSlice, scheduler_->GetGetOffset());
+
+  // The next invocation picks up the remaining command.
+  EXPECT_CALL(*command_buffer_, SetGetOffset(kNumCommands));
+  scheduler_->PutChanged();
+  EXPECT_EQ(kNumCommands, scheduler_->GetGetOffset());
+}
+
 TEST_F(GpuSchedulerTest, SetsErrorCodeOnCommandBuffer) {
   CommandHeader* header = reinterpret_cast<CommandHeader*>(&buffer_[0]);
   header[0].command = 7;
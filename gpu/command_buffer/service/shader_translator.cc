@@ -6,6 +6,8 @@
 
 #include <string.h>
 
+#include <map>
+
 #include "base/at_exit.h"
 #include "base/logging.h"
 
@@ -71,6 +73,30 @@ void GetVariableInfo(ShHandle compiler, ShShaderInfo var_type,
     (*var_map)[mapped_name.get()] = info;
   }
 }
+
+// Process-wide cache of successful translation results, keyed by the
+// translator configuration and the shader source, so that recompiling the
+// same shaders - for example when a page creates a fresh context with the
+// same content - skips ANGLE entirely. Translation dominates context warmup
+// for shader-heavy pages. Only successful translations are cached, and a
+// cache hit produces no info log, matching a translation without warnings.
+struct TranslationCacheEntry {
+  std::string translated_shader;
+  ShaderTranslator::VariableMap attrib_map;
+  ShaderTranslator::VariableMap uniform_map;
+};
+
+typedef std::map<std::string, TranslationCacheEntry> TranslationCache;
+
+// Bounds the memory held by the cache; entries are never evicted, new ones
+// simply stop being added. Shader-heavy pages use a few hundred shaders.
+const size_t kTranslationCacheMaxEntries = 512;
+
+TranslationCache* GetTranslationCache() {
+  // Intentionally leaked: results stay valid for the life of the process.
+  static TranslationCache* cache = new TranslationCache;
+  return cache;
+}
 }  // namespace
 
 namespace gpu {
@@ -111,6 +137,17 @@ bool ShaderTranslator::Init(
   implementation_is_glsl_es_ = (glsl_implementation_type == kGlslES);
   needs_built_in_function_emulation_ =
       (glsl_built_in_function_behavior == kGlslBuiltInFunctionEmulated);
+
+  // The cache key has to distinguish translators with different
+  // configurations. The built-in resources are derived from the driver's
+  // capabilities, so including them keys the cache to the driver as well.
+  int config[] = { shader_type, shader_spec, glsl_implementation_type,
+                   glsl_built_in_function_behavior };
+  cache_key_prefix_.assign(reinterpret_cast<const char*>(config),
+                           sizeof(config));
+  cache_key_prefix_.append(reinterpret_cast<const char*>(resources),
+                           sizeof(*resources));
+
   return compiler_ != NULL;
 }
 
@@ -120,6 +157,19 @@ bool ShaderTranslator::Translate(const char* shader) {
   DCHECK(shader != NULL);
   ClearResults();
 
+  std::string key = cache_key_prefix_ + shader;
+  TranslationCache* cache = GetTranslationCache();
+  TranslationCache::const_iterator hit = cache->find(key);
+  if (hit != cache->end()) {
+    const TranslationCacheEntry& entry = hit->second;
+    translated_shader_.reset(new char[entry.translated_shader.size() + 1]);
+    memcpy(translated_shader_.get(), entry.translated_shader.c_str(),
+           entry.translated_shader.size() + 1);
+    attrib_map_ = entry.attrib_map;
+    uniform_map_ = entry.uniform_map;
+    return true;
+  }
+
   bool success = false;
   int compile_options =
       SH_OBJECT_CODE | SH_ATTRIBUTES_UNIFORMS | SH_MAP_LONG_VARIABLE_NAMES;
@@ -149,6 +199,14 @@ bool ShaderTranslator::Translate(const char* shader) {
     info_log_.reset();
   }
 
+  if (success && translated_shader_.get() &&
+      cache->size() < kTranslationCacheMaxEntries) {
+    TranslationCacheEntry& entry = (*cache)[key];
+    entry.translated_shader = translated_shader_.get();
+    entry.attrib_map = attrib_map_;
+    entry.uniform_map = uniform_map_;
+  }
+
   return success;
 }
 
@@ -102,6 +102,9 @@ class GPU_EXPORT ShaderTranslator
   void ClearResults();
 
   ShHandle compiler_;
+  // Prefix for translation cache keys; encodes the translator configuration,
+  // including the driver-derived built-in resources.
+  std::string cache_key_prefix_;
   scoped_array<char> translated_shader_;
   scoped_array<char> info_log_;
   VariableMap attrib_map_;
@@ -194,6 +194,32 @@ TEST_F(ShaderTranslatorTest, GetUniforms) {
   EXPECT_EQ("bar[1].foo.color[0]", iter->second.name);
 }
 
+TEST_F(ShaderTranslatorTest, CachedTranslationMatches) {
+  const char* shader =
+      "attribute vec4 vPosition;\n"
+      "void main() {\n"
+      "  gl_Position = vPosition;\n"
+      "}";
+
+  // The first translation populates the process-wide cache.
+  ASSERT_TRUE(vertex_translator_.Translate(shader));
+  std::string translated_shader(vertex_translator_.translated_shader());
+  ShaderTranslator::VariableMap attrib_map = vertex_translator_.attrib_map();
+
+  // A second translator with the same configuration must produce the same
+  // results from the cache.
+  ShBuiltInResources resources;
+  ShInitBuiltInResources(&resources);
+  ShaderTranslator translator;
+  ASSERT_TRUE(translator.Init(
+      SH_VERTEX_SHADER, SH_GLES2_SPEC, &resources,
+      ShaderTranslatorInterface::kGlsl,
+      ShaderTranslatorInterface::kGlslBuiltInFunctionEmulated));
+  ASSERT_TRUE(translator.Translate(shader));
+  EXPECT_STREQ(translated_shader.c_str(), translator.translated_shader());
+  EXPECT_EQ(attrib_map.size(), translator.attrib_map().size());
+}
+
 #if defined(OS_MACOSX)
 TEST_F(ShaderTranslatorTest, BuiltInFunctionEmulation) {
   // This test might become invalid in the future when ANGLE Translator is no
@@ -23,15 +23,22 @@ class IPC_EXPORT FileDescriptorSet
  public:
   FileDescriptorSet();
 
-  // This is the maximum number of descriptors per message. We need to know this
-  // because the control message kernel interface has to be given a buffer which
-  // is large enough to store all the descriptor numbers. Otherwise the kernel
-  // tells us that it truncated the control data and the extra descriptors are
-  // lost.
+  // This is the maximum number of descriptors per message. The channel
+  // transmits a larger set as a series of control-message chunks (see
+  // kMaxDescriptorsPerChunk below), so this cap bounds the kernel resources
+  // one message can pin on the receiving side rather than what a single
+  // sendmsg can carry.
   //
   // In debugging mode, it's a fatal error to try and add more than this number
   // of descriptors to a FileDescriptorSet.
-  static const size_t kMaxDescriptorsPerMessage = 5;
+  static const size_t kMaxDescriptorsPerMessage = 64;
+
+  // The maximum number of descriptors in one SCM_RIGHTS control message. We
+  // need to know this because the control message kernel interface has to be
+  // given a buffer which is large enough to store all the descriptor numbers.
+  // Otherwise the kernel tells us that it truncated the control data and the
+  // extra descriptors are lost.
+  static const size_t kMaxDescriptorsPerChunk = 5;
 
   // ---------------------------------------------------------------------------
   // Interfaces for building during message serialisation...
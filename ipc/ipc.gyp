@@ -49,6 +49,7 @@
         'ipc_channel_posix_unittest.cc',
         'ipc_fuzzing_tests.cc',
         'ipc_message_unittest.cc',
+        'ipc_ring_buffer_posix_unittest.cc',
         'ipc_send_fds_test.cc',
         'ipc_sync_channel_unittest.cc',
         'ipc_sync_message_unittest.cc',
@@ -79,6 +80,23 @@
         }]
       ],
     },
+    {
+      'target_name': 'ipc_perftests',
+      'type': '<(gtest_target_type)',
+      'dependencies': [
+        'ipc',
+        '../base/base.gyp:base',
+        '../base/base.gyp:test_support_base',
+        '../base/base.gyp:test_support_perf',
+        '../testing/gtest.gyp:gtest',
+      ],
+      'include_dirs': [
+        '..'
+      ],
+      'sources': [
+        'ipc_perftests.cc',
+      ],
+    },
     {
       'target_name': 'test_support_ipc',
       'type': 'static_library',
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/process.h"
@@ -73,6 +74,13 @@ class IPC_EXPORT Channel : public Message::Sender {
     MODE_NAMED_FLAG = 0x4,
 #if defined(OS_POSIX)
     MODE_OPEN_ACCESS_FLAG = 0x8, // Don't restrict access based on client UID.
+    // Transport message payload through a shared-memory ring buffer instead
+    // of the socket, which is kept for wakeup signaling and descriptor
+    // passing. Only meaningful on the server side; the client picks the
+    // transport up from the connection handshake. The server falls back to
+    // the socket if the shared memory cannot be set up, so only use this
+    // flag with peers that run this channel implementation.
+    MODE_SHM_TRANSPORT_FLAG = 0x10,
 #endif
   };
 
@@ -102,10 +110,15 @@ class IPC_EXPORT Channel : public Message::Sender {
   // just the process id (pid).  The message has a special routing_id
   // (MSG_ROUTING_NONE) and type (HELLO_MESSAGE_TYPE).
   enum {
-    HELLO_MESSAGE_TYPE = kuint16max  // Maximum value of message type (uint16),
-                                     // to avoid conflicting with normal
-                                     // message types, which are enumeration
-                                     // constants starting from 0.
+    HELLO_MESSAGE_TYPE = kuint16max,  // Maximum value of message type (uint16),
+                                      // to avoid conflicting with normal
+                                      // message types, which are enumeration
+                                      // constants starting from 0.
+    // Internal to the POSIX Channel: sent by a MODE_SHM_TRANSPORT_FLAG
+    // server right after its Hello message, carrying the ring buffer and
+    // wakeup descriptors the client needs to join the shared-memory
+    // transport. Never dispatched to the Listener.
+    SHM_SETUP_MESSAGE_TYPE = kuint16max - 1
   };
 
   // The maximum message size in bytes. Attempting to receive a message of this
@@ -160,6 +173,12 @@ class IPC_EXPORT Channel : public Message::Sender {
   // deleted once the contents of the Message have been sent.
   virtual bool Send(Message* message) OVERRIDE;
 
+  // Sends every message in |messages| over the Channel, writing them to the
+  // pipe with as few system calls as possible. |messages| is cleared; as with
+  // Send, ownership of each message is taken. Returns false if the Channel
+  // ran into an error while sending.
+  virtual bool SendBatch(std::vector<Message*>* messages);
+
 #if defined(OS_POSIX)
   // On POSIX an IPC::Channel wraps a socketpair(), this method returns the
   // FD # for the client end of the socket.
@@ -6,18 +6,18 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stddef.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/un.h>
 
-#if defined(OS_OPENBSD)
 #include <sys/uio.h>
-#endif
 
-#include <string>
+#include <algorithm>
 #include <map>
+#include <string>
 
 #include "base/command_line.h"
 #include "base/eintr_wrapper.h"
@@ -58,6 +58,31 @@ namespace IPC {
 //------------------------------------------------------------------------------
 namespace {
 
+// The most messages ProcessOutgoingMessages will coalesce into a single
+// writev call. Each message is one contiguous Pickle buffer, so one iovec
+// entry covers it; the kernel limits a single call to IOV_MAX entries.
+// Messages carrying file descriptors never join a batch since their
+// descriptors have to travel ahead of their payload.
+const size_t kMaxSendIovCount = 256;
+COMPILE_ASSERT(kMaxSendIovCount <= IOV_MAX, send_batch_exceeds_iov_max);
+
+// Points |msgh| at a control message in |buf| carrying |count| descriptors
+// copied from |fds|. |buf| must have room for CMSG_SPACE(sizeof(int) *
+// count) bytes.
+void FillDescriptorControlMessage(struct msghdr* msgh,
+                                  char* buf,
+                                  const int* fds,
+                                  unsigned count) {
+  msgh->msg_control = buf;
+  msgh->msg_controllen = CMSG_SPACE(sizeof(int) * count);
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(msgh);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * count);
+  msgh->msg_controllen = cmsg->cmsg_len;
+}
+
 // The PipeMap class works around this quirk related to unit tests:
 //
 // When running as a server, we install the client socket in a
@@ -299,6 +324,10 @@ bool SocketWriteErrorIsRecoverable() {
 int Channel::ChannelImpl::global_pid_ = 0;
 #endif  // OS_LINUX
 
+#if defined(IPC_USES_READWRITE)
+const size_t Channel::ChannelImpl::kShmTransportRingSize;
+#endif
+
 Channel::ChannelImpl::ChannelImpl(const IPC::ChannelHandle& channel_handle,
                                   Mode mode, Listener* listener)
     : ChannelReader(listener),
@@ -307,12 +336,20 @@ Channel::ChannelImpl::ChannelImpl(const IPC::ChannelHandle& channel_handle,
       is_blocked_on_write_(false),
       waiting_connect_(true),
       message_send_bytes_written_(0),
+      message_send_fds_written_(0),
       server_listen_pipe_(-1),
       pipe_(-1),
       client_pipe_(-1),
 #if defined(IPC_USES_READWRITE)
       fd_pipe_(-1),
       remote_fd_pipe_(-1),
+      wakeup_pipe_(-1),
+      remote_wakeup_pipe_(-1),
+      shm_transport_active_(false),
+      message_on_ring_(false),
+      is_blocked_on_ring_write_(false),
+      check_socket_read_(true),
+      shm_setup_failed_(false),
 #endif  // IPC_USES_READWRITE
       pipe_name_(channel_handle.name),
       must_unlink_(false) {
@@ -490,6 +527,9 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
 
   // Write out all the messages we can till the write blocks or there are no
   // more outgoing messages.
+#if defined(IPC_USES_READWRITE)
+  bool wrote_to_ring = false;
+#endif
   while (!output_queue_.empty()) {
     Message* msg = output_queue_.front();
 
@@ -498,22 +538,68 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
     const char* out_bytes = reinterpret_cast<const char*>(msg->data()) +
         message_send_bytes_written_;
 
+#if defined(IPC_USES_READWRITE)
+    // Pick the transport at message boundaries only; a partially written
+    // message has to finish on the transport it started on.
+    if (message_send_bytes_written_ == 0)
+      message_on_ring_ = shm_transport_active_;
+
+    if (message_on_ring_) {
+      if (message_send_bytes_written_ == 0 &&
+          !msg->file_descriptor_set()->empty()) {
+        // The payload goes through the ring, so the descriptors take the
+        // same route they do in READWRITE mode: over fd_pipe_, ahead of the
+        // payload.
+        bool blocked = false;
+        if (!SendFileDescriptorsOnFDPipe(msg, &blocked))
+          return false;
+        if (blocked) {
+          if (wrote_to_ring)
+            SendRingWakeup();
+          return true;
+        }
+      }
+
+      size_t ring_bytes_written = send_ring_.Write(out_bytes, amt_to_write);
+      if (ring_bytes_written > 0) {
+        wrote_to_ring = true;
+        message_send_bytes_written_ += ring_bytes_written;
+      }
+      if (message_send_bytes_written_ != msg->size()) {
+        // The ring is full. Raise the producer-waiting flag so the peer
+        // answers with a wakeup byte once it has drained some data, unless
+        // space opened up while we were raising it.
+        if (send_ring_.SetProducerWaiting())
+          continue;
+        is_blocked_on_ring_write_ = true;
+        break;
+      }
+
+      message_send_bytes_written_ = 0;
+      DVLOG(2) << "sent message @" << msg << " on channel @" << this
+               << " with type " << msg->type() << " via ring buffer";
+      delete output_queue_.front();
+      output_queue_.pop_front();
+      continue;
+    }
+#endif  // IPC_USES_READWRITE
+
     struct msghdr msgh = {0};
-    struct iovec iov = {const_cast<char*>(out_bytes), amt_to_write};
-    msgh.msg_iov = &iov;
+    struct iovec iov[kMaxSendIovCount];
+    iov[0].iov_base = const_cast<char*>(out_bytes);
+    iov[0].iov_len = amt_to_write;
+    msgh.msg_iov = iov;
     msgh.msg_iovlen = 1;
     char buf[CMSG_SPACE(
-        sizeof(int) * FileDescriptorSet::kMaxDescriptorsPerMessage)];
+        sizeof(int) * FileDescriptorSet::kMaxDescriptorsPerChunk)];
 
     ssize_t bytes_written = 1;
     int fd_written = -1;
 
-    if (message_send_bytes_written_ == 0 &&
-        !msg->file_descriptor_set()->empty()) {
-      // This is the first chunk of a message which has descriptors to send
-      struct cmsghdr *cmsg;
-      const unsigned num_fds = msg->file_descriptor_set()->size();
-
+    const unsigned num_fds = msg->file_descriptor_set()->size();
+    if (num_fds && message_send_fds_written_ < num_fds) {
+      // This message has descriptors which have to travel ahead of (or
+      // with) its payload.
       DCHECK(num_fds <= FileDescriptorSet::kMaxDescriptorsPerMessage);
       if (msg->file_descriptor_set()->ContainsDirectoryDescriptor()) {
         LOG(FATAL) << "Panic: attempting to transport directory descriptor over"
@@ -525,18 +611,6 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
         // filesystem.
       }
 
-      msgh.msg_control = buf;
-      msgh.msg_controllen = CMSG_SPACE(sizeof(int) * num_fds);
-      cmsg = CMSG_FIRSTHDR(&msgh);
-      cmsg->cmsg_level = SOL_SOCKET;
-      cmsg->cmsg_type = SCM_RIGHTS;
-      cmsg->cmsg_len = CMSG_LEN(sizeof(int) * num_fds);
-      msg->file_descriptor_set()->GetDescriptors(
-          reinterpret_cast<int*>(CMSG_DATA(cmsg)));
-      msgh.msg_controllen = cmsg->cmsg_len;
-
-      // DCHECK_LE above already checks that
-      // num_fds < kMaxDescriptorsPerMessage so no danger of overflow.
       msg->header()->num_fds = static_cast<uint16>(num_fds);
 
 #if defined(IPC_USES_READWRITE)
@@ -544,19 +618,55 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
         // Only the Hello message sends the file descriptor with the message.
         // Subsequently, we can send file descriptors on the dedicated
         // fd_pipe_ which makes Seccomp sandbox operation more efficient.
-        struct iovec fd_pipe_iov = { const_cast<char *>(""), 1 };
-        msgh.msg_iov = &fd_pipe_iov;
-        fd_written = fd_pipe_;
-        bytes_written = HANDLE_EINTR(sendmsg(fd_pipe_, &msgh, MSG_DONTWAIT));
-        msgh.msg_iov = &iov;
-        msgh.msg_controllen = 0;
-        if (bytes_written > 0) {
-          msg->file_descriptor_set()->CommitAll();
+        bool blocked = false;
+        if (!SendFileDescriptorsOnFDPipe(msg, &blocked))
+          return false;
+        if (blocked)
+          return true;
+      } else
+#endif  // IPC_USES_READWRITE
+      {
+        fd_written = pipe_;
+        int fds[FileDescriptorSet::kMaxDescriptorsPerMessage];
+        msg->file_descriptor_set()->GetDescriptors(fds);
+
+        // A control message carries at most kMaxDescriptorsPerChunk
+        // descriptors. Descriptors beyond that go out as full chunks, each
+        // riding on a single byte of the payload; the last chunk is
+        // attached to the write of the remaining payload below. The kernel
+        // keeps every chunk with its payload byte, so the receiver has all
+        // the descriptors, in order, by the time the payload completes.
+        while (num_fds - message_send_fds_written_ >
+               FileDescriptorSet::kMaxDescriptorsPerChunk) {
+          struct iovec chunk_iov = { const_cast<char*>(out_bytes), 1 };
+          msgh.msg_iov = &chunk_iov;
+          msgh.msg_iovlen = 1;
+          FillDescriptorControlMessage(
+              &msgh, buf, fds + message_send_fds_written_,
+              FileDescriptorSet::kMaxDescriptorsPerChunk);
+          bytes_written = HANDLE_EINTR(sendmsg(pipe_, &msgh, MSG_DONTWAIT));
+          if (bytes_written != 1)
+            break;
+          message_send_fds_written_ +=
+              FileDescriptorSet::kMaxDescriptorsPerChunk;
+          ++message_send_bytes_written_;
+          ++out_bytes;
+          --amt_to_write;
+        }
+        msgh.msg_iov = iov;
+        msgh.msg_iovlen = 1;
+        iov[0].iov_base = const_cast<char*>(out_bytes);
+        iov[0].iov_len = amt_to_write;
+        if (bytes_written == 1) {
+          FillDescriptorControlMessage(&msgh, buf,
+                                       fds + message_send_fds_written_,
+                                       num_fds - message_send_fds_written_);
         }
       }
-#endif  // IPC_USES_READWRITE
     }
 
+    size_t amt_to_write_total = amt_to_write;
+
     if (bytes_written == 1) {
       fd_written = pipe_;
 #if defined(IPC_USES_READWRITE)
@@ -564,15 +674,28 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
         DCHECK_EQ(msg->file_descriptor_set()->size(), 1U);
       }
       if (!msgh.msg_controllen) {
-        bytes_written = HANDLE_EINTR(write(pipe_, out_bytes, amt_to_write));
+        // No descriptors ride along with this write, so following queued
+        // messages that carry no descriptors either can share the system
+        // call: a burst of small sends becomes one writev.
+        size_t iov_count = 1;
+        while (iov_count < kMaxSendIovCount &&
+               iov_count < output_queue_.size()) {
+          Message* next = output_queue_[iov_count];
+          if (!next->file_descriptor_set()->empty())
+            break;
+          iov[iov_count].iov_base =
+              const_cast<void*>(static_cast<const void*>(next->data()));
+          iov[iov_count].iov_len = next->size();
+          amt_to_write_total += next->size();
+          ++iov_count;
+        }
+        bytes_written = HANDLE_EINTR(writev(pipe_, iov, iov_count));
       } else
 #endif  // IPC_USES_READWRITE
       {
         bytes_written = HANDLE_EINTR(sendmsg(pipe_, &msgh, MSG_DONTWAIT));
       }
     }
-    if (bytes_written > 0)
-      msg->file_descriptor_set()->CommitAll();
 
     if (bytes_written < 0 && !SocketWriteErrorIsRecoverable()) {
 #if defined(OS_MACOSX)
@@ -593,12 +716,43 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
       return false;
     }
 
-    if (static_cast<size_t>(bytes_written) != amt_to_write) {
-      if (bytes_written > 0) {
-        // If write() fails with EAGAIN then bytes_written will be -1.
-        message_send_bytes_written_ += bytes_written;
+    if (bytes_written > 0) {
+      msg->file_descriptor_set()->CommitAll();
+      message_send_fds_written_ = 0;
+
+      // Pop every message that went out in full; a partially written one
+      // records its progress in message_send_bytes_written_ and stays at the
+      // front of the queue. If write() fails with EAGAIN then bytes_written
+      // will be -1 and nothing is popped.
+      size_t written = static_cast<size_t>(bytes_written);
+      while (written != 0) {
+        Message* sent_msg = output_queue_.front();
+        size_t remaining = sent_msg->size() - message_send_bytes_written_;
+        if (written < remaining) {
+          message_send_bytes_written_ += written;
+          break;
+        }
+        written -= remaining;
+        message_send_bytes_written_ = 0;
+
+#if defined(IPC_USES_READWRITE)
+        // Once the setup message is on the wire the client has everything it
+        // needs to join the shared-memory transport, so all messages after it
+        // go through the ring.
+        if (!shm_transport_active_ && send_ring_.IsValid() &&
+            sent_msg->type() == SHM_SETUP_MESSAGE_TYPE)
+          shm_transport_active_ = true;
+#endif  // IPC_USES_READWRITE
+
+        // Message sent OK!
+        DVLOG(2) << "sent message @" << sent_msg << " on channel @" << this
+                 << " with type " << sent_msg->type() << " on fd " << pipe_;
+        delete sent_msg;
+        output_queue_.pop_front();
       }
+    }
 
+    if (static_cast<size_t>(bytes_written) != amt_to_write_total) {
       // Tell libevent to call us back once things are unblocked.
       is_blocked_on_write_ = true;
       MessageLoopForIO::current()->WatchFileDescriptor(
@@ -608,16 +762,13 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
           &write_watcher_,
           this);
       return true;
-    } else {
-      message_send_bytes_written_ = 0;
-
-      // Message sent OK!
-      DVLOG(2) << "sent message @" << msg << " on channel @" << this
-               << " with type " << msg->type() << " on fd " << pipe_;
-      delete output_queue_.front();
-      output_queue_.pop();
     }
   }
+#if defined(IPC_USES_READWRITE)
+  // Wake the peer once per batch, after all ring writes are visible.
+  if (wrote_to_ring)
+    SendRingWakeup();
+#endif  // IPC_USES_READWRITE
   return true;
 }
 
@@ -630,7 +781,39 @@ bool Channel::ChannelImpl::Send(Message* message) {
   Logging::GetInstance()->OnSendMessage(message, "");
 #endif  // IPC_MESSAGE_LOG_ENABLED
 
-  output_queue_.push(message);
+  output_queue_.push_back(message);
+#if defined(IPC_USES_READWRITE)
+  if (is_blocked_on_ring_write_)
+    return true;
+#endif
+  if (!is_blocked_on_write_ && !waiting_connect_) {
+    return ProcessOutgoingMessages();
+  }
+
+  return true;
+}
+
+bool Channel::ChannelImpl::SendBatch(std::vector<Message*>* messages) {
+  // Queue everything up front so that ProcessOutgoingMessages sees the whole
+  // batch and can coalesce it into as few writes as possible.
+  for (size_t i = 0; i < messages->size(); ++i) {
+    Message* message = (*messages)[i];
+    DVLOG(2) << "sending message @" << message << " on channel @" << this
+             << " with type " << message->type()
+             << " (" << output_queue_.size() << " in queue)";
+
+#ifdef IPC_MESSAGE_LOG_ENABLED
+    Logging::GetInstance()->OnSendMessage(message, "");
+#endif  // IPC_MESSAGE_LOG_ENABLED
+
+    output_queue_.push_back(message);
+  }
+  messages->clear();
+
+#if defined(IPC_USES_READWRITE)
+  if (is_blocked_on_ring_write_)
+    return true;
+#endif
   if (!is_blocked_on_write_ && !waiting_connect_) {
     return ProcessOutgoingMessages();
   }
@@ -720,13 +903,32 @@ void Channel::ChannelImpl::ResetToAcceptingConnectionState() {
       PLOG(ERROR) << "close remote_fd_pipe_ " << pipe_name_;
     remote_fd_pipe_ = -1;
   }
+  wakeup_watcher_.StopWatchingFileDescriptor();
+  if (wakeup_pipe_ != -1) {
+    if (HANDLE_EINTR(close(wakeup_pipe_)) < 0)
+      PLOG(ERROR) << "close wakeup_pipe_ " << pipe_name_;
+    wakeup_pipe_ = -1;
+  }
+  if (remote_wakeup_pipe_ != -1) {
+    if (HANDLE_EINTR(close(remote_wakeup_pipe_)) < 0)
+      PLOG(ERROR) << "close remote_wakeup_pipe_ " << pipe_name_;
+    remote_wakeup_pipe_ = -1;
+  }
+  send_ring_.Reset();
+  receive_ring_.Reset();
+  shm_transport_active_ = false;
+  message_on_ring_ = false;
+  is_blocked_on_ring_write_ = false;
+  check_socket_read_ = true;
+  shm_setup_failed_ = false;
 #endif  // IPC_USES_READWRITE
 
   while (!output_queue_.empty()) {
     Message* m = output_queue_.front();
-    output_queue_.pop();
+    output_queue_.pop_front();
     delete m;
   }
+  message_send_fds_written_ = 0;
 
   // Close any outstanding, received file descriptors.
   ClearInputFDs();
@@ -792,12 +994,41 @@ void Channel::ChannelImpl::OnFileCanReadWithoutBlocking(int fd) {
       send_server_hello_msg = true;
       waiting_connect_ = false;
     }
+#if defined(IPC_USES_READWRITE)
+    check_socket_read_ = true;
+#endif
     if (!ProcessIncomingMessages()) {
       // ClosePipeOnError may delete this object, so we mustn't call
       // ProcessOutgoingMessages.
       send_server_hello_msg = false;
       ClosePipeOnError();
     }
+#if defined(IPC_USES_READWRITE)
+  } else if (fd == wakeup_pipe_) {
+    // Drain the wakeup bytes; each one just means "look at the rings".
+    char wakeup_buf[64];
+    ssize_t len;
+    do {
+      len = HANDLE_EINTR(read(wakeup_pipe_, wakeup_buf, sizeof(wakeup_buf)));
+    } while (len == static_cast<ssize_t>(sizeof(wakeup_buf)));
+    if (len == 0) {
+      // The peer closed its end of the wakeup socketpair.
+      ClosePipeOnError();
+      return;
+    }
+    if (is_blocked_on_ring_write_) {
+      // The peer made room in our send ring.
+      is_blocked_on_ring_write_ = false;
+      if (!ProcessOutgoingMessages()) {
+        // ClosePipeOnError may delete this object.
+        ClosePipeOnError();
+        return;
+      }
+    }
+    if (!ProcessIncomingMessages())
+      ClosePipeOnError();
+    return;
+#endif  // IPC_USES_READWRITE
   } else {
     NOTREACHED() << "Unknown pipe " << fd;
   }
@@ -813,7 +1044,13 @@ void Channel::ChannelImpl::OnFileCanReadWithoutBlocking(int fd) {
 
 // Called by libevent when we can write to the pipe without blocking.
 void Channel::ChannelImpl::OnFileCanWriteWithoutBlocking(int fd) {
+#if defined(IPC_USES_READWRITE)
+  // In shared-memory transport mode the descriptors of a ring-bound message
+  // may block on fd_pipe_ instead of pipe_.
+  DCHECK(fd == pipe_ || fd == fd_pipe_);
+#else
   DCHECK_EQ(pipe_, fd);
+#endif
   is_blocked_on_write_ = false;
   if (!ProcessOutgoingMessages()) {
     ClosePipeOnError();
@@ -828,6 +1065,14 @@ bool Channel::ChannelImpl::AcceptConnection() {
                                                    this);
   QueueHelloMessage();
 
+#if defined(IPC_USES_READWRITE)
+  if ((mode_ & MODE_SHM_TRANSPORT_FLAG) && (mode_ & MODE_SERVER_FLAG)) {
+    CreateShmTransport();
+    if (send_ring_.IsValid())
+      QueueShmSetupMessage();
+  }
+#endif  // IPC_USES_READWRITE
+
   if (mode_ & MODE_CLIENT_FLAG) {
     // If we are a client we want to send a hello message out immediately.
     // In server mode we will send a hello message when we receive one from a
@@ -886,8 +1131,127 @@ void Channel::ChannelImpl::QueueHelloMessage() {
     DCHECK_EQ(msg->file_descriptor_set()->size(), 1U);
   }
 #endif  // IPC_USES_READWRITE
-  output_queue_.push(msg.release());
+  output_queue_.push_back(msg.release());
+}
+
+#if defined(IPC_USES_READWRITE)
+void Channel::ChannelImpl::CreateShmTransport() {
+  DCHECK(mode_ & MODE_SERVER_FLAG);
+  DCHECK(!send_ring_.IsValid());
+
+  if (!send_ring_.Create(kShmTransportRingSize) ||
+      !receive_ring_.Create(kShmTransportRingSize) ||
+      !SocketPair(&wakeup_pipe_, &remote_wakeup_pipe_)) {
+    // Silently stay on the socket transport.
+    LOG(WARNING) << "Unable to set up shared-memory transport for "
+                 << pipe_name_;
+    send_ring_.Reset();
+    receive_ring_.Reset();
+    return;
+  }
+  MessageLoopForIO::current()->WatchFileDescriptor(
+      wakeup_pipe_,
+      true,
+      MessageLoopForIO::WATCH_READ,
+      &wakeup_watcher_,
+      this);
+}
+
+void Channel::ChannelImpl::QueueShmSetupMessage() {
+  scoped_ptr<Message> msg(new Message(MSG_ROUTING_NONE,
+                                      SHM_SETUP_MESSAGE_TYPE,
+                                      IPC::Message::PRIORITY_NORMAL));
+  // From the client's point of view: its receive ring (our send ring), its
+  // send ring, and its end of the wakeup socketpair.
+  if (!msg->WriteInt(static_cast<int>(kShmTransportRingSize)) ||
+      !msg->WriteFileDescriptor(
+          base::FileDescriptor(send_ring_.GetFileDescriptor(), false)) ||
+      !msg->WriteFileDescriptor(
+          base::FileDescriptor(receive_ring_.GetFileDescriptor(), false)) ||
+      !msg->WriteFileDescriptor(
+          base::FileDescriptor(remote_wakeup_pipe_, false))) {
+    NOTREACHED() << "Unable to pickle shm setup message";
+  }
+  output_queue_.push_back(msg.release());
+}
+
+bool Channel::ChannelImpl::SendFileDescriptorsOnFDPipe(Message* msg,
+                                                       bool* blocked) {
+  *blocked = false;
+
+  const unsigned num_fds = msg->file_descriptor_set()->size();
+  DCHECK(num_fds <= FileDescriptorSet::kMaxDescriptorsPerMessage);
+  if (msg->file_descriptor_set()->ContainsDirectoryDescriptor()) {
+    LOG(FATAL) << "Panic: attempting to transport directory descriptor over"
+                  " IPC. Aborting to maintain sandbox isolation.";
+    // See the matching check in ProcessOutgoingMessages for why this is
+    // fatal.
+  }
+
+  int fds[FileDescriptorSet::kMaxDescriptorsPerMessage];
+  msg->file_descriptor_set()->GetDescriptors(fds);
+  msg->header()->num_fds = static_cast<uint16>(num_fds);
+
+  // A control message carries at most kMaxDescriptorsPerChunk descriptors,
+  // so a large set goes out as a series of one-byte sends. The receiver
+  // accumulates chunks until the count in the message header is satisfied;
+  // message_send_fds_written_ records our progress in case a chunk blocks.
+  char buf[CMSG_SPACE(
+      sizeof(int) * FileDescriptorSet::kMaxDescriptorsPerChunk)];
+  while (message_send_fds_written_ < num_fds) {
+    const unsigned chunk_fds = std::min(
+        num_fds - static_cast<unsigned>(message_send_fds_written_),
+        static_cast<unsigned>(FileDescriptorSet::kMaxDescriptorsPerChunk));
+    struct msghdr msgh = {0};
+    struct iovec iov = { const_cast<char*>(""), 1 };
+    msgh.msg_iov = &iov;
+    msgh.msg_iovlen = 1;
+    FillDescriptorControlMessage(&msgh, buf,
+                                 fds + message_send_fds_written_, chunk_fds);
+
+    ssize_t bytes_written =
+        HANDLE_EINTR(sendmsg(fd_pipe_, &msgh, MSG_DONTWAIT));
+    if (bytes_written != 1) {
+      if (bytes_written < 0 && !SocketWriteErrorIsRecoverable()) {
+        if (errno == EPIPE) {
+          Close();
+          return false;
+        }
+        PLOG(ERROR) << "fd pipe error on "
+                    << fd_pipe_
+                    << " Currently writing message of size: "
+                    << msg->size();
+        return false;
+      }
+      // Tell libevent to call us back once fd_pipe_ has room again.
+      *blocked = true;
+      is_blocked_on_write_ = true;
+      MessageLoopForIO::current()->WatchFileDescriptor(
+          fd_pipe_,
+          false,  // One shot
+          MessageLoopForIO::WATCH_WRITE,
+          &write_watcher_,
+          this);
+      return true;
+    }
+    message_send_fds_written_ += chunk_fds;
+  }
+
+  msg->file_descriptor_set()->CommitAll();
+  message_send_fds_written_ = 0;
+  return true;
+}
+
+void Channel::ChannelImpl::SendRingWakeup() {
+  DCHECK_NE(-1, wakeup_pipe_);
+  char wakeup_byte = 0;
+  ssize_t bytes_written = HANDLE_EINTR(write(wakeup_pipe_, &wakeup_byte, 1));
+  if (bytes_written < 0 && errno != EAGAIN) {
+    // A dead peer gets discovered through pipe_, so just log here.
+    PLOG(WARNING) << "wakeup pipe error on " << wakeup_pipe_;
+  }
 }
+#endif  // IPC_USES_READWRITE
 
 Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadData(
     char* buffer,
@@ -896,6 +1260,18 @@ Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadData(
   if (pipe_ == -1)
     return READ_FAILED;
 
+#if defined(IPC_USES_READWRITE)
+  if (shm_setup_failed_)
+    return READ_FAILED;
+  // Ring fast path: while the socket is known to be dry, serve data without
+  // any syscall. The socket watcher sets check_socket_read_ again whenever
+  // the socket has something (residual handshake data, or EOF on close),
+  // and the socket is always drained before the ring so that messages sent
+  // before the peer switched transports keep their order.
+  if (receive_ring_.IsValid() && !check_socket_read_)
+    return ReadDataFromRing(buffer, buffer_len, bytes_read);
+#endif  // IPC_USES_READWRITE
+
   struct msghdr msg = {0};
 
   struct iovec iov = {buffer, buffer_len};
@@ -918,6 +1294,11 @@ Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadData(
   }
   if (*bytes_read < 0) {
     if (errno == EAGAIN) {
+#if defined(IPC_USES_READWRITE)
+      check_socket_read_ = false;
+      if (receive_ring_.IsValid())
+        return ReadDataFromRing(buffer, buffer_len, bytes_read);
+#endif  // IPC_USES_READWRITE
       return READ_PENDING;
 #if defined(OS_MACOSX)
     } else if (errno == EPERM) {
@@ -946,6 +1327,24 @@ Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadData(
   return READ_SUCCEEDED;
 }
 
+#if defined(IPC_USES_READWRITE)
+Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadDataFromRing(
+    char* buffer,
+    int buffer_len,
+    int* bytes_read) {
+  size_t ring_bytes =
+      receive_ring_.Read(buffer, static_cast<size_t>(buffer_len));
+  // If the peer filled the ring and is waiting for room, wake it now that
+  // some has been made.
+  if (ring_bytes > 0 && receive_ring_.TakeProducerWaiting())
+    SendRingWakeup();
+  if (ring_bytes == 0)
+    return READ_PENDING;
+  *bytes_read = static_cast<int>(ring_bytes);
+  return READ_SUCCEEDED;
+}
+#endif  // IPC_USES_READWRITE
+
 #if defined(IPC_USES_READWRITE)
 bool Channel::ChannelImpl::ReadFileDescriptorsFromFDPipe() {
   char dummy;
@@ -983,8 +1382,16 @@ bool Channel::ChannelImpl::WillDispatchInputMessage(Message* msg) {
     // The message has been completely received, but we didn't get
     // enough file descriptors.
 #if defined(IPC_USES_READWRITE)
-    if (!ReadFileDescriptorsFromFDPipe())
-      return false;
+    // The descriptors may span several control-message chunks on the fd
+    // pipe; keep reading until the header's count is satisfied or the pipe
+    // runs dry.
+    size_t fds_before;
+    do {
+      fds_before = input_fds_.size();
+      if (!ReadFileDescriptorsFromFDPipe())
+        return false;
+    } while (header_fds > input_fds_.size() &&
+             input_fds_.size() > fds_before);
     if (header_fds > input_fds_.size())
 #endif  // IPC_USES_READWRITE
       error = "Message needs unreceived descriptors";
@@ -1089,6 +1496,55 @@ void Channel::ChannelImpl::HandleHelloMessage(const Message& msg) {
   listener()->OnChannelConnected(pid);
 }
 
+#if defined(IPC_USES_READWRITE)
+void Channel::ChannelImpl::HandleShmSetupMessage(const Message& msg) {
+  // Only a client should ever receive this, and only once.
+  if (!(mode_ & MODE_CLIENT_FLAG) || shm_transport_active_) {
+    NOTREACHED() << "Unexpected shm setup message";
+    shm_setup_failed_ = true;
+    return;
+  }
+
+  PickleIterator iter(msg);
+  int ring_size = 0;
+  base::FileDescriptor receive_fd;
+  base::FileDescriptor send_fd;
+  base::FileDescriptor wakeup_fd;
+  if (!msg.ReadInt(&iter, &ring_size) ||
+      !msg.ReadFileDescriptor(&iter, &receive_fd) ||
+      !msg.ReadFileDescriptor(&iter, &send_fd) ||
+      !msg.ReadFileDescriptor(&iter, &wakeup_fd) ||
+      ring_size <= 0) {
+    NOTREACHED() << "Invalid shm setup message";
+    shm_setup_failed_ = true;
+    return;
+  }
+
+  // The rings take ownership of their descriptors, even on failure.
+  if (!receive_ring_.Map(receive_fd.fd, static_cast<size_t>(ring_size)) ||
+      !send_ring_.Map(send_fd.fd, static_cast<size_t>(ring_size))) {
+    // The server switched transports when it sent this message, so there is
+    // no way to carry on over the socket; fail the channel cleanly instead.
+    LOG(ERROR) << "Unable to join shared-memory transport for " << pipe_name_;
+    if (HANDLE_EINTR(close(wakeup_fd.fd)) < 0)
+      PLOG(ERROR) << "close " << pipe_name_;
+    receive_ring_.Reset();
+    send_ring_.Reset();
+    shm_setup_failed_ = true;
+    return;
+  }
+
+  wakeup_pipe_ = wakeup_fd.fd;
+  MessageLoopForIO::current()->WatchFileDescriptor(
+      wakeup_pipe_,
+      true,
+      MessageLoopForIO::WATCH_READ,
+      &wakeup_watcher_,
+      this);
+  shm_transport_active_ = true;
+}
+#endif  // IPC_USES_READWRITE
+
 void Channel::ChannelImpl::Close() {
   // Close can be called multiple time, so we need to make sure we're
   // idempotent.
@@ -1141,6 +1597,10 @@ bool Channel::Send(Message* message) {
   return channel_impl_->Send(message);
 }
 
+bool Channel::SendBatch(std::vector<Message*>* messages) {
+  return channel_impl_->SendBatch(messages);
+}
+
 int Channel::GetClientFileDescriptor() const {
   return channel_impl_->GetClientFileDescriptor();
 }
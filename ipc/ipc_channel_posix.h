@@ -10,7 +10,7 @@
 
 #include <sys/socket.h>  // for CMSG macros
 
-#include <queue>
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -18,6 +18,7 @@
 #include "base/process.h"
 #include "ipc/file_descriptor_set_posix.h"
 #include "ipc/ipc_channel_reader.h"
+#include "ipc/ipc_ring_buffer_posix.h"
 
 #if !defined(OS_MACOSX)
 // On Linux, the seccomp sandbox makes it very expensive to call
@@ -59,6 +60,7 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   bool Connect();
   void Close();
   bool Send(Message* message);
+  bool SendBatch(std::vector<Message*>* messages);
   int GetClientFileDescriptor();
   int TakeClientFileDescriptor();
   void CloseClientFileDescriptor();
@@ -77,6 +79,32 @@ class Channel::ChannelImpl : public internal::ChannelReader,
 
   bool ProcessOutgoingMessages();
 
+#if defined(IPC_USES_READWRITE)
+  // Creates the ring buffers and the wakeup socketpair for
+  // MODE_SHM_TRANSPORT_FLAG. On failure the channel silently stays on the
+  // socket transport.
+  void CreateShmTransport();
+
+  // Queues the SHM_SETUP_MESSAGE_TYPE message that carries the transport
+  // descriptors to the client.
+  void QueueShmSetupMessage();
+
+  // Sends the descriptors of |msg| over fd_pipe_, as the socket path does
+  // for the first chunk of a message. Used when the payload itself goes
+  // through the ring buffer. Sets |*blocked| and registers a write watcher
+  // if the fd pipe is full; returns false on fatal error.
+  bool SendFileDescriptorsOnFDPipe(Message* msg, bool* blocked);
+
+  // Writes one byte to the wakeup socket to get the peer to look at the
+  // rings. Send-buffer overflow is ignored: it implies the peer already has
+  // unread wakeups pending.
+  void SendRingWakeup();
+
+  // ReadData helper that serves data from receive_ring_, waking a blocked
+  // peer producer if needed.
+  ReadState ReadDataFromRing(char* buffer, int buffer_len, int* bytes_read);
+#endif
+
   bool AcceptConnection();
   void ClosePipeOnError();
   int GetHelloMessageProcId();
@@ -89,6 +117,9 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   virtual bool WillDispatchInputMessage(Message* msg) OVERRIDE;
   virtual bool DidEmptyInputBuffers() OVERRIDE;
   virtual void HandleHelloMessage(const Message& msg) OVERRIDE;
+#if defined(IPC_USES_READWRITE)
+  virtual void HandleShmSetupMessage(const Message& msg) OVERRIDE;
+#endif
 
 #if defined(IPC_USES_READWRITE)
   // Reads the next message from the fd_pipe_ and appends them to the
@@ -131,6 +162,11 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   // to keep track of where we are.
   size_t message_send_bytes_written_;
 
+  // Tracks the number of descriptors of the front message that have already
+  // been transmitted, for messages whose descriptor set spans several
+  // control-message chunks.
+  size_t message_send_fds_written_;
+
   // File descriptor we're listening on for new connections if we listen
   // for connections.
   int server_listen_pipe_;
@@ -147,20 +183,72 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   // Linux/BSD use a dedicated socketpair() for passing file descriptors.
   int fd_pipe_;
   int remote_fd_pipe_;
+
+  // Shared-memory ring-buffer transport (MODE_SHM_TRANSPORT_FLAG). The
+  // server creates one ring per direction plus a socketpair used purely for
+  // wakeup signaling, and passes the client's ends in the shm setup message
+  // it sends right after its Hello. From then on message payload bypasses
+  // the socket entirely; file descriptors keep traveling over fd_pipe_ just
+  // like in plain READWRITE mode.
+  //
+  // Bytes on a ring only move in one direction, so ordering between the two
+  // transports is maintained by construction: each side writes its last
+  // pre-switch message to the socket before its first ring write, and the
+  // reader always drains the socket before touching its receive ring.
+
+  // Size of the data area of each ring. Messages larger than this are
+  // simply written in several chunks, with a wakeup round-trip in between.
+  static const size_t kShmTransportRingSize = 256 * 1024;
+
+  internal::RingBuffer send_ring_;
+  internal::RingBuffer receive_ring_;
+
+  // Our end of the wakeup socketpair, and (server side only) the end that
+  // is passed to the client.
+  int wakeup_pipe_;
+  int remote_wakeup_pipe_;
+  MessageLoopForIO::FileDescriptorWatcher wakeup_watcher_;
+
+  // True once both sides of the handshake are done and newly sent messages
+  // go to send_ring_ instead of the socket.
+  bool shm_transport_active_;
+
+  // Whether the message currently at the front of output_queue_ started out
+  // on the ring; a partially written message must finish on the transport
+  // it started on.
+  bool message_on_ring_;
+
+  // True while we are waiting for the peer to drain send_ring_. The peer
+  // sends a wakeup byte once it has; there is no descriptor to watch, so
+  // this is deliberately separate from is_blocked_on_write_.
+  bool is_blocked_on_ring_write_;
+
+  // Whether ReadData should try the socket before the receive ring. Set
+  // whenever the socket watcher fires, cleared when the socket runs dry, so
+  // an idle socket costs no syscall on the ring fast path.
+  bool check_socket_read_;
+
+  // Set by HandleShmSetupMessage if joining the transport fails after the
+  // server has already switched over; makes the next read fail cleanly.
+  bool shm_setup_failed_;
 #endif
 
   // The "name" of our pipe.  On Windows this is the global identifier for
   // the pipe.  On POSIX it's used as a key in a local map of file descriptors.
   std::string pipe_name_;
 
-  // Messages to be sent are queued here.
-  std::queue<Message*> output_queue_;
+  // Messages to be sent are queued here. A deque rather than a queue so that
+  // ProcessOutgoingMessages can coalesce several queued messages into one
+  // writev call.
+  std::deque<Message*> output_queue_;
 
   // We assume a worst case: kReadBufferSize bytes of messages, where each
-  // message has no payload and a full complement of descriptors.
+  // message has no payload and a full control-message chunk of descriptors.
+  // (A chunk that carries descriptors terminates a recvmsg, so no single
+  // read sees more than one chunk per message.)
   static const size_t kMaxReadFDs =
       (Channel::kReadBufferSize / sizeof(IPC::Message::Header)) *
-      FileDescriptorSet::kMaxDescriptorsPerMessage;
+      FileDescriptorSet::kMaxDescriptorsPerChunk;
 
   // Buffer size for file descriptors used for recvmsg. On Mac the CMSG macros
   // don't seem to be constant so we have to pick a "large enough" value.
@@ -8,12 +8,34 @@
 #include "base/location.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/stl_util.h"
 #include "ipc/ipc_channel_proxy.h"
 #include "ipc/ipc_logging.h"
+#include "ipc/ipc_message_filter_router.h"
 #include "ipc/ipc_message_utils.h"
 
 namespace IPC {
 
+namespace {
+
+// Index into Context::pending_dispatch_messages_ for a received message:
+// higher priority classes live in lower queues and get dispatched first.
+size_t DispatchQueueIndex(const Message& message) {
+  switch (message.priority()) {
+    case Message::PRIORITY_HIGH:
+      return 0;
+    case Message::PRIORITY_NORMAL:
+      return 1;
+    case Message::PRIORITY_LOW:
+      return 2;
+  }
+  // The flag bits come from the (possibly compromised) peer; treat an
+  // out-of-range priority as normal.
+  return 1;
+}
+
+}  // namespace
+
 //------------------------------------------------------------------------------
 
 ChannelProxy::MessageFilter::MessageFilter() {}
@@ -32,6 +54,11 @@ bool ChannelProxy::MessageFilter::OnMessageReceived(const Message& message) {
   return false;
 }
 
+bool ChannelProxy::MessageFilter::GetSupportedMessageClasses(
+    std::vector<uint32>* supported_message_classes) const {
+  return false;
+}
+
 void ChannelProxy::MessageFilter::OnDestruct() const {
   delete this;
 }
@@ -44,12 +71,14 @@ ChannelProxy::Context::Context(Channel::Listener* listener,
                                base::MessageLoopProxy* ipc_message_loop)
     : listener_message_loop_(base::MessageLoopProxy::current()),
       listener_(listener),
+      message_filter_router_(new MessageFilterRouter()),
       ipc_message_loop_(ipc_message_loop),
       channel_connected_called_(false),
       peer_pid_(base::kNullProcessId) {
 }
 
 ChannelProxy::Context::~Context() {
+  STLDeleteElements(&pending_send_messages_);
 }
 
 void ChannelProxy::Context::CreateChannel(const IPC::ChannelHandle& handle,
@@ -66,14 +95,12 @@ bool ChannelProxy::Context::TryFilters(const Message& message) {
     logger->OnPreDispatchMessage(message);
 #endif
 
-  for (size_t i = 0; i < filters_.size(); ++i) {
-    if (filters_[i]->OnMessageReceived(message)) {
+  if (message_filter_router_->TryFilters(message)) {
 #ifdef IPC_MESSAGE_LOG_ENABLED
-      if (logger->Enabled())
-        logger->OnPostDispatchMessage(message, channel_id_);
+    if (logger->Enabled())
+      logger->OnPostDispatchMessage(message, channel_id_);
 #endif
-      return true;
-    }
+    return true;
   }
   return false;
 }
@@ -92,8 +119,22 @@ bool ChannelProxy::Context::OnMessageReceivedNoFilter(const Message& message) {
   // this thread is active.  That should be a reasonable assumption, but it
   // feels risky.  We may want to invent some more indirect way of referring to
   // a MessageLoop if this becomes a problem.
-  listener_message_loop_->PostTask(
-      FROM_HERE, base::Bind(&Context::OnDispatchMessage, this, message));
+  //
+  // Only the message that finds the queues empty posts a task; the messages
+  // of a burst all get dispatched by that one task, so the listener thread
+  // wakes up once per burst instead of once per message.
+  bool needs_task = true;
+  {
+    base::AutoLock auto_lock(pending_dispatch_messages_lock_);
+    for (size_t i = 0; i < arraysize(pending_dispatch_messages_); ++i)
+      needs_task &= pending_dispatch_messages_[i].empty();
+    pending_dispatch_messages_[DispatchQueueIndex(message)].
+        push_back(message);
+  }
+  if (needs_task) {
+    listener_message_loop_->PostTask(
+        FROM_HERE, base::Bind(&Context::OnDispatchMessages, this));
+  }
   return true;
 }
 
@@ -156,6 +197,7 @@ void ChannelProxy::Context::OnChannelClosed() {
 
   // We don't need the filters anymore.
   filters_.clear();
+  message_filter_router_->Clear();
 
   channel_.reset();
 
@@ -164,13 +206,33 @@ void ChannelProxy::Context::OnChannelClosed() {
   Release();
 }
 
+// Called on any thread
+void ChannelProxy::Context::Send(Message* message) {
+  bool needs_task;
+  {
+    base::AutoLock auto_lock(pending_send_messages_lock_);
+    needs_task = pending_send_messages_.empty();
+    pending_send_messages_.push_back(message);
+  }
+  if (needs_task) {
+    ipc_message_loop_->PostTask(
+        FROM_HERE, base::Bind(&Context::OnSendMessages, this));
+  }
+}
+
 // Called on the IPC::Channel thread
-void ChannelProxy::Context::OnSendMessage(scoped_ptr<Message> message) {
+void ChannelProxy::Context::OnSendMessages() {
+  std::vector<Message*> messages;
+  {
+    base::AutoLock auto_lock(pending_send_messages_lock_);
+    messages.swap(pending_send_messages_);
+  }
   if (!channel_.get()) {
+    STLDeleteElements(&messages);
     OnChannelClosed();
     return;
   }
-  if (!channel_->Send(message.release()))
+  if (!channel_->SendBatch(&messages))
     OnChannelError();
 }
 
@@ -184,6 +246,7 @@ void ChannelProxy::Context::OnAddFilter() {
 
   for (size_t i = 0; i < new_filters.size(); ++i) {
     filters_.push_back(new_filters[i]);
+    message_filter_router_->AddFilter(new_filters[i].get());
 
     // If the channel has already been created, then we need to send this
     // message so that the filter gets access to the Channel.
@@ -199,6 +262,7 @@ void ChannelProxy::Context::OnAddFilter() {
 void ChannelProxy::Context::OnRemoveFilter(MessageFilter* filter) {
   for (size_t i = 0; i < filters_.size(); ++i) {
     if (filters_[i].get() == filter) {
+      message_filter_router_->RemoveFilter(filter);
       filter->OnFilterRemoved();
       filters_.erase(filters_.begin() + i);
       return;
@@ -252,6 +316,20 @@ void ChannelProxy::Context::OnDispatchMessage(const Message& message) {
 #endif
 }
 
+// Called on the listener's thread
+void ChannelProxy::Context::OnDispatchMessages() {
+  std::vector<Message> messages[arraysize(pending_dispatch_messages_)];
+  {
+    base::AutoLock auto_lock(pending_dispatch_messages_lock_);
+    for (size_t i = 0; i < arraysize(pending_dispatch_messages_); ++i)
+      messages[i].swap(pending_dispatch_messages_[i]);
+  }
+  for (size_t queue = 0; queue < arraysize(messages); ++queue) {
+    for (size_t i = 0; i < messages[queue].size(); ++i)
+      OnDispatchMessage(messages[queue][i]);
+  }
+}
+
 // Called on the listener's thread
 void ChannelProxy::Context::OnDispatchConnected() {
   if (channel_connected_called_)
@@ -344,10 +422,7 @@ bool ChannelProxy::Send(Message* message) {
   Logging::GetInstance()->OnSendMessage(message, context_->channel_id());
 #endif
 
-  context_->ipc_message_loop()->PostTask(
-      FROM_HERE,
-      base::Bind(&ChannelProxy::Context::OnSendMessage,
-                 context_, base::Passed(scoped_ptr<Message>(message))));
+  context_->Send(message);
   return true;
 }
 
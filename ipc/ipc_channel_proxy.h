@@ -17,6 +17,7 @@
 
 namespace IPC {
 
+class MessageFilterRouter;
 class SendCallbackHelper;
 
 //-----------------------------------------------------------------------------
@@ -85,6 +86,13 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
     // the message be handled in the default way.
     virtual bool OnMessageReceived(const Message& message);
 
+    // Called to query the Message classes (IPCMessageStart values) handled
+    // by the filter.  Filters that return true only receive messages of the
+    // classes they append to |supported_message_classes|; return false (the
+    // default) to have every message offered to OnMessageReceived.
+    virtual bool GetSupportedMessageClasses(
+        std::vector<uint32>* supported_message_classes) const;
+
     // Called when the message filter is about to be deleted.  This gives
     // derived classes the option of controlling which thread they're deleted
     // on etc.
@@ -239,13 +247,19 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
     void CreateChannel(const IPC::ChannelHandle& channel_handle,
                        const Channel::Mode& mode);
 
+    // Queues a message to be sent and, if none were queued yet, posts a
+    // single OnSendMessages task to flush the queue. May be called on any
+    // thread.
+    void Send(Message* message);
+
     // Methods called on the IO thread.
-    void OnSendMessage(scoped_ptr<Message> message_ptr);
+    void OnSendMessages();
     void OnAddFilter();
     void OnRemoveFilter(MessageFilter* filter);
 
     // Methods called on the listener thread.
     void AddFilter(MessageFilter* filter);
+    void OnDispatchMessages();
     void OnDispatchConnected();
     void OnDispatchError();
 
@@ -254,6 +268,10 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
 
     // List of filters.  This is only accessed on the IPC thread.
     std::vector<scoped_refptr<MessageFilter> > filters_;
+
+    // Routes messages to the filters above by message class.  This is only
+    // accessed on the IPC thread.
+    scoped_ptr<MessageFilterRouter> message_filter_router_;
     scoped_refptr<base::MessageLoopProxy> ipc_message_loop_;
     scoped_ptr<Channel> channel_;
     std::string channel_id_;
@@ -265,6 +283,22 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
     // Lock for pending_filters_.
     base::Lock pending_filters_lock_;
 
+    // Messages queued by Send and not yet passed to the Channel. All the
+    // sends of one burst are flushed by a single OnSendMessages task on the
+    // IO thread.
+    std::vector<Message*> pending_send_messages_;
+    // Lock for pending_send_messages_.
+    base::Lock pending_send_messages_lock_;
+
+    // Received messages waiting to be dispatched, one queue per
+    // Message::PriorityValue class so that PRIORITY_HIGH traffic (input,
+    // vsync) overtakes bulk messages. All the messages of one burst are
+    // dispatched by a single OnDispatchMessages task on the listener
+    // thread, highest class first.
+    std::vector<Message> pending_dispatch_messages_[3];
+    // Lock for pending_dispatch_messages_.
+    base::Lock pending_dispatch_messages_lock_;
+
     // Cached copy of the peer process ID. Set on IPC but read on both IPC and
     // listener threads.
     base::ProcessId peer_pid_;
@@ -40,6 +40,14 @@ bool ChannelReader::IsHelloMessage(const Message& m) const {
          m.type() == Channel::HELLO_MESSAGE_TYPE;
 }
 
+bool ChannelReader::IsShmSetupMessage(const Message& m) const {
+  return m.routing_id() == MSG_ROUTING_NONE &&
+         m.type() == Channel::SHM_SETUP_MESSAGE_TYPE;
+}
+
+void ChannelReader::HandleShmSetupMessage(const Message& msg) {
+}
+
 bool ChannelReader::DispatchInputData(const char* input_data,
                                       int input_data_len) {
   const char* p;
@@ -72,6 +80,8 @@ bool ChannelReader::DispatchInputData(const char* input_data,
 
       if (IsHelloMessage(m))
         HandleHelloMessage(m);
+      else if (IsShmSetupMessage(m))
+        HandleShmSetupMessage(m);
       else
         listener_->OnMessageReceived(m);
       p = message_tail;
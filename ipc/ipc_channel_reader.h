@@ -46,6 +46,10 @@ class ChannelReader {
   // set-up.
   bool IsHelloMessage(const Message& m) const;
 
+  // Returns true if the given message is the shared-memory transport set-up
+  // message used by the POSIX channel implementation.
+  bool IsShmSetupMessage(const Message& m) const;
+
  protected:
   enum ReadState { READ_SUCCEEDED, READ_FAILED, READ_PENDING };
 
@@ -79,6 +83,12 @@ class ChannelReader {
   // Handles the first message sent over the pipe which contains setup info.
   virtual void HandleHelloMessage(const Message& msg) = 0;
 
+  // Handles the shared-memory transport set-up message. Like the hello
+  // message this is internal to the channel and never reaches the listener.
+  // The default implementation ignores it, for platforms without that
+  // transport.
+  virtual void HandleShmSetupMessage(const Message& msg);
+
  private:
   // Takes the given data received from the IPC channel and dispatches any
   // fully completed messages.
@@ -477,6 +477,16 @@ bool Channel::Send(Message* message) {
   return channel_impl_->Send(message);
 }
 
+bool Channel::SendBatch(std::vector<Message*>* messages) {
+  // Windows writes are already asynchronous and get queued by the impl, so
+  // there is no system call to save by coalescing; just send each message.
+  bool ok = true;
+  for (size_t i = 0; i < messages->size(); ++i)
+    ok = channel_impl_->Send((*messages)[i]) && ok;
+  messages->clear();
+  return ok;
+}
+
 // static
 bool Channel::IsNamedServerInitialized(const std::string& channel_id) {
   return ChannelImpl::IsNamedServerInitialized(channel_id);
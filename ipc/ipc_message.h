@@ -88,6 +88,13 @@ class IPC_EXPORT Message : public Pickle {
     return static_cast<PriorityValue>(header()->flags & PRIORITY_MASK);
   }
 
+  // Sets the priority class used by the dispatch queues in ChannelProxy:
+  // PRIORITY_HIGH messages (input, vsync) overtake queued bulk traffic on
+  // the receiving listener thread, PRIORITY_LOW messages yield to it.
+  void set_priority(PriorityValue priority) {
+    header()->flags = (header()->flags & ~PRIORITY_MASK) | priority;
+  }
+
   // True if this is a synchronous message.
   void set_sync() {
     header()->flags |= SYNC_BIT;
@@ -226,6 +233,9 @@ class IPC_EXPORT Message : public Pickle {
   friend class Channel;
   friend class MessageReplyDeserializer;
   friend class SyncMessage;
+  // WriteBlob spills large parameters into shared memory and needs to know
+  // whether the message can still take the segment's descriptor.
+  friend void WriteBlob(Message* m, const char* data, size_t size);
 
 #pragma pack(push, 4)
   struct Header : Pickle::Header {
@@ -0,0 +1,84 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_message_filter_router.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "ipc/ipc_message.h"
+
+namespace IPC {
+
+namespace {
+
+// Mirrors IPC_MESSAGE_ID_CLASS from ipc_message_macros.h without pulling in
+// the message definition machinery.
+uint32 MessageClass(const Message& message) {
+  return message.type() >> 16;
+}
+
+bool TryFiltersImpl(std::vector<ChannelProxy::MessageFilter*>& filters,
+                    const Message& message) {
+  for (size_t i = 0; i < filters.size(); ++i) {
+    if (filters[i]->OnMessageReceived(message))
+      return true;
+  }
+  return false;
+}
+
+void RemoveFilterImpl(std::vector<ChannelProxy::MessageFilter*>* filters,
+                      ChannelProxy::MessageFilter* filter) {
+  filters->erase(std::remove(filters->begin(), filters->end(), filter),
+                 filters->end());
+}
+
+}  // namespace
+
+MessageFilterRouter::MessageFilterRouter() {}
+
+MessageFilterRouter::~MessageFilterRouter() {}
+
+void MessageFilterRouter::AddFilter(MessageFilter* filter) {
+  // Determine whether the filter should be applied to all messages, or only
+  // to the message classes it declared.
+  std::vector<uint32> supported_message_classes;
+  if (filter->GetSupportedMessageClasses(&supported_message_classes)) {
+    DCHECK(!supported_message_classes.empty());
+    for (size_t i = 0; i < supported_message_classes.size(); ++i) {
+      const uint32 message_class = supported_message_classes[i];
+      DCHECK_LT(message_class, static_cast<uint32>(LastIPCMsgStart));
+      message_class_filters_[message_class].push_back(filter);
+    }
+  } else {
+    global_filters_.push_back(filter);
+  }
+}
+
+void MessageFilterRouter::RemoveFilter(MessageFilter* filter) {
+  RemoveFilterImpl(&global_filters_, filter);
+  for (size_t i = 0; i < LastIPCMsgStart; ++i)
+    RemoveFilterImpl(&message_class_filters_[i], filter);
+}
+
+bool MessageFilterRouter::TryFilters(const Message& message) {
+  if (TryFiltersImpl(global_filters_, message))
+    return true;
+
+  // The type comes off the wire, so an unknown class simply has no
+  // registered filters.
+  const uint32 message_class = MessageClass(message);
+  if (message_class >= static_cast<uint32>(LastIPCMsgStart))
+    return false;
+
+  return TryFiltersImpl(message_class_filters_[message_class], message);
+}
+
+void MessageFilterRouter::Clear() {
+  global_filters_.clear();
+  for (size_t i = 0; i < LastIPCMsgStart; ++i)
+    message_class_filters_[i].clear();
+}
+
+}  // namespace IPC
@@ -0,0 +1,52 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_IPC_MESSAGE_FILTER_ROUTER_H_
+#define IPC_IPC_MESSAGE_FILTER_ROUTER_H_
+#pragma once
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "ipc/ipc_channel_proxy.h"
+#include "ipc/ipc_message_utils.h"
+
+namespace IPC {
+
+// Routes a received message to the ChannelProxy::MessageFilters that might
+// handle it.  Filters that declare the message classes they support (see
+// MessageFilter::GetSupportedMessageClasses) are kept in a table indexed by
+// IPCMessageStart, so routing a message to them costs one lookup instead of
+// a virtual OnMessageReceived call on every installed filter.  Filters that
+// do not declare their classes keep the old behavior and see every message.
+class MessageFilterRouter {
+ public:
+  typedef ChannelProxy::MessageFilter MessageFilter;
+
+  MessageFilterRouter();
+  ~MessageFilterRouter();
+
+  void AddFilter(MessageFilter* filter);
+  void RemoveFilter(MessageFilter* filter);
+  bool TryFilters(const Message& message);
+  void Clear();
+
+ private:
+  typedef std::vector<MessageFilter*> MessageFilterList;
+
+  // The filters are not referenced here; ChannelProxy::Context::filters_
+  // owns them and keeps the entries below alive.
+
+  // Filters that see every message because they declared no classes.
+  MessageFilterList global_filters_;
+
+  // Filters that only see the message classes they registered for.
+  MessageFilterList message_class_filters_[LastIPCMsgStart];
+
+  DISALLOW_COPY_AND_ASSIGN(MessageFilterRouter);
+};
+
+}  // namespace IPC
+
+#endif  // IPC_IPC_MESSAGE_FILTER_ROUTER_H_
@@ -4,10 +4,16 @@
 
 #include "ipc/ipc_message_utils.h"
 
+#if defined(OS_POSIX)
+#include <sys/stat.h>
+#endif
+
 #include "base/file_path.h"
 #include "base/json/json_writer.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/nullable_string16.h"
+#include "base/process_util.h"
+#include "base/shared_memory.h"
 #include "base/string_number_conversions.h"
 #include "base/time.h"
 #include "base/utf_string_conversions.h"
@@ -21,6 +27,124 @@ namespace IPC {
 
 const int kMaxRecursionDepth = 100;
 
+const size_t kMessageBlobSpillThreshold = 64 * 1024;
+
+// Blob spilling.
+//
+// The wire format is a bool telling whether the bytes were spilled, followed
+// by either the usual length-prefixed data or, for a spilled blob, its size
+// and the shared memory handle carrying the bytes.
+
+void WriteBlob(Message* m, const char* data, size_t size) {
+#if defined(OS_POSIX)
+  if (size >= kMessageBlobSpillThreshold &&
+      m->file_descriptor_set()->size() <
+          FileDescriptorSet::kMaxDescriptorsPerMessage) {
+    base::SharedMemory shared_memory;
+    if (shared_memory.CreateAndMapAnonymous(static_cast<uint32>(size))) {
+      memcpy(shared_memory.memory(), data, size);
+      base::SharedMemoryHandle handle;
+      if (shared_memory.GiveToProcess(base::GetCurrentProcessHandle(),
+                                      &handle)) {
+        m->WriteBool(true);
+        m->WriteUInt32(static_cast<uint32>(size));
+        WriteParam(m, handle);
+        return;
+      }
+    }
+    // Shared memory was not available; fall through to the inline path.
+  }
+#endif  // defined(OS_POSIX)
+  m->WriteBool(false);
+  // Reserving the length prefix and payload together keeps a large blob
+  // from costing two realloc+copy cycles.
+  m->Reserve(Pickle::SizeOfData(size));
+  m->WriteData(data, static_cast<int>(size));
+}
+
+namespace {
+
+// Reads the bytes written by WriteBlob, either straight out of the message
+// or by mapping the attached shared memory segment, which then owns the
+// returned bytes.
+bool ReadBlobBytes(const Message* m, PickleIterator* iter,
+                   scoped_ptr<base::SharedMemory>* shared_memory,
+                   const char** data, int* size) {
+  bool spilled;
+  if (!m->ReadBool(iter, &spilled))
+    return false;
+
+  if (!spilled)
+    return m->ReadData(iter, data, size) && *size >= 0;
+
+#if defined(OS_POSIX)
+  uint32 blob_size;
+  base::SharedMemoryHandle handle;
+  if (!m->ReadUInt32(iter, &blob_size) ||
+      static_cast<int>(blob_size) < 0 ||
+      !ReadParam(m, iter, &handle)) {
+    return false;
+  }
+
+  shared_memory->reset(new base::SharedMemory(handle, true /* read_only */));
+
+  // The handle comes from the (possibly compromised) peer, so check that the
+  // segment really is big enough before mapping it; touching pages beyond
+  // the end of an undersized segment would fault.
+  struct stat sb;
+  if (fstat((*shared_memory)->handle().fd, &sb) != 0 ||
+      sb.st_size < static_cast<off_t>(blob_size)) {
+    return false;
+  }
+
+  if (!(*shared_memory)->Map(blob_size))
+    return false;
+  *data = static_cast<const char*>((*shared_memory)->memory());
+  *size = static_cast<int>(blob_size);
+  return true;
+#else
+  // Blobs are never spilled on this platform.
+  return false;
+#endif  // defined(OS_POSIX)
+}
+
+}  // namespace
+
+bool ReadBlob(const Message* m, PickleIterator* iter, std::string* r) {
+  scoped_ptr<base::SharedMemory> shared_memory;
+  const char* data;
+  int size = 0;
+  if (!ReadBlobBytes(m, iter, &shared_memory, &data, &size))
+    return false;
+  r->assign(data, size);
+  return true;
+}
+
+bool ReadBlob(const Message* m, PickleIterator* iter,
+              std::vector<unsigned char>* r) {
+  scoped_ptr<base::SharedMemory> shared_memory;
+  const char* data;
+  int size = 0;
+  if (!ReadBlobBytes(m, iter, &shared_memory, &data, &size))
+    return false;
+  r->resize(size);
+  if (size)
+    memcpy(&r->front(), data, size);
+  return true;
+}
+
+bool ReadBlob(const Message* m, PickleIterator* iter, std::vector<char>* r) {
+  scoped_ptr<base::SharedMemory> shared_memory;
+  const char* data;
+  int size = 0;
+  if (!ReadBlobBytes(m, iter, &shared_memory, &data, &size))
+    return false;
+  r->resize(size);
+  if (size)
+    memcpy(&r->front(), data, size);
+  return true;
+}
+
 // Value serialization
 
 static bool ReadValue(const Message* m, PickleIterator* iter, Value** value,
@@ -426,15 +426,33 @@ struct IPC_EXPORT ParamTraits<base::ListValue> {
   static void Log(const param_type& p, std::string* l);
 };
 
+// A string or binary-blob parameter of at least this size has its bytes
+// carried in an anonymous shared memory segment instead of being copied
+// inline into the message (POSIX only; on Windows blobs always travel
+// inline). Spilling turns the four copies a multi-megabyte parameter costs
+// end to end into one memcpy on each side.
+IPC_EXPORT extern const size_t kMessageBlobSpillThreshold;
+
+// Helpers behind the string and character-vector ParamTraits below: write
+// |size| bytes at |data| inline or, above kMessageBlobSpillThreshold, via a
+// shared memory handle attached to the message; read them back into |r|.
+IPC_EXPORT void WriteBlob(Message* m, const char* data, size_t size);
+IPC_EXPORT bool ReadBlob(const Message* m, PickleIterator* iter,
+                         std::string* r);
+IPC_EXPORT bool ReadBlob(const Message* m, PickleIterator* iter,
+                         std::vector<unsigned char>* r);
+IPC_EXPORT bool ReadBlob(const Message* m, PickleIterator* iter,
+                         std::vector<char>* r);
+
 template <>
 struct ParamTraits<std::string> {
   typedef std::string param_type;
   static void Write(Message* m, const param_type& p) {
-    m->WriteString(p);
+    WriteBlob(m, p.data(), p.size());
   }
   static bool Read(const Message* m, PickleIterator* iter,
                    param_type* r) {
-    return m->ReadString(iter, r);
+    return ReadBlob(m, iter, r);
   }
   static void Log(const param_type& p, std::string* l) {
     l->append(p);
@@ -468,23 +486,12 @@ template <>
 struct ParamTraits<std::vector<unsigned char> > {
   typedef std::vector<unsigned char> param_type;
   static void Write(Message* m, const param_type& p) {
-    if (p.empty()) {
-      m->WriteData(NULL, 0);
-    } else {
-      m->WriteData(reinterpret_cast<const char*>(&p.front()),
-                   static_cast<int>(p.size()));
-    }
+    WriteBlob(m, p.empty() ? NULL : reinterpret_cast<const char*>(&p.front()),
+              p.size());
   }
   static bool Read(const Message* m, PickleIterator* iter,
                    param_type* r) {
-    const char *data;
-    int data_size = 0;
-    if (!m->ReadData(iter, &data, &data_size) || data_size < 0)
-      return false;
-    r->resize(data_size);
-    if (data_size)
-      memcpy(&r->front(), data, data_size);
-    return true;
+    return ReadBlob(m, iter, r);
   }
   static void Log(const param_type& p, std::string* l) {
     LogBytes(p, l);
@@ -495,22 +502,11 @@ template <>
 struct ParamTraits<std::vector<char> > {
   typedef std::vector<char> param_type;
   static void Write(Message* m, const param_type& p) {
-    if (p.empty()) {
-      m->WriteData(NULL, 0);
-    } else {
-      m->WriteData(&p.front(), static_cast<int>(p.size()));
-    }
+    WriteBlob(m, p.empty() ? NULL : &p.front(), p.size());
   }
   static bool Read(const Message* m, PickleIterator* iter,
                    param_type* r) {
-    const char *data;
-    int data_size = 0;
-    if (!m->ReadData(iter, &data, &data_size) || data_size < 0)
-      return false;
-    r->resize(data_size);
-    if (data_size)
-      memcpy(&r->front(), data, data_size);
-    return true;
+    return ReadBlob(m, iter, r);
   }
   static void Log(const param_type& p, std::string* l) {
     LogBytes(p, l);
@@ -646,6 +642,7 @@ template <>
 struct ParamTraits<std::wstring> {
   typedef std::wstring param_type;
   static void Write(Message* m, const param_type& p) {
+    m->Reserve(Pickle::SizeOfWString(p));
     m->WriteWString(p);
   }
   static bool Read(const Message* m, PickleIterator* iter,
@@ -691,6 +688,7 @@ template <>
 struct ParamTraits<string16> {
   typedef string16 param_type;
   static void Write(Message* m, const param_type& p) {
+    m->Reserve(Pickle::SizeOfString16(p));
     m->WriteString16(p);
   }
   static bool Read(const Message* m, PickleIterator* iter,
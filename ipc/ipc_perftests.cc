@@ -0,0 +1,432 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Performance tests for the IPC transport. These measure the Channel and
+// SyncChannel rather than correctness, and report messages/sec plus p50/p99
+// round-trip latency through the perf log. The defaults cover a small matrix
+// of message sizes and pipelining depths; the switches below override them
+// so a single configuration can be re-run while tuning channel or kernel
+// settings:
+//
+//   --ipc-perf-message-count=N
+//   --ipc-perf-message-size=N   (bytes of payload per message)
+//   --ipc-perf-fds=N            (descriptors attached to each message)
+//   --ipc-perf-depth=N          (messages kept in flight at once)
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/eintr_wrapper.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/string_number_conversions.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "base/time.h"
+#include "ipc/ipc_channel.h"
+#include "ipc/ipc_sync_channel.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "base/file_descriptor_posix.h"
+#endif
+
+// IPC messages for the SyncChannel test --------------------------------------
+
+#define IPC_MESSAGE_IMPL
+#include "ipc/ipc_message_macros.h"
+
+#define IPC_MESSAGE_START TestMsgStart
+
+// The reply carries the request payload back to the sender.
+IPC_SYNC_MESSAGE_CONTROL1_1(PerfTestMsg_SyncPing,
+                            std::string /* payload */,
+                            std::string /* payload */)
+
+// ----------------------------------------------------------------------------
+
+namespace {
+
+const char kMessageCountSwitch[] = "ipc-perf-message-count";
+const char kMessageSizeSwitch[] = "ipc-perf-message-size";
+const char kFdsSwitch[] = "ipc-perf-fds";
+const char kDepthSwitch[] = "ipc-perf-depth";
+
+// Message types used on the raw Channel. The values are arbitrary; they only
+// have to agree between the two listeners.
+const uint32 kPingMessageType = 1;
+const uint32 kPongMessageType = 2;
+
+// One run of the ping-pong loop.
+struct PingPongConfig {
+  const char* name;
+  int message_count;
+  int message_size;
+  int num_fds;
+  int depth;
+};
+
+const PingPongConfig kPingPongConfigs[] = {
+  { "IPC_Channel_64B_depth1", 20000, 64, 0, 1 },
+  { "IPC_Channel_4K_depth1", 10000, 4096, 0, 1 },
+  { "IPC_Channel_64K_depth1", 2000, 64 * 1024, 0, 1 },
+  { "IPC_Channel_64B_depth16", 20000, 64, 0, 16 },
+  { "IPC_Channel_4K_depth16", 10000, 4096, 0, 16 },
+#if defined(OS_POSIX)
+  { "IPC_Channel_64B_2fds", 5000, 64, 2, 1 },
+#endif
+};
+
+// Returns the integer value of |switch_name| or |default_value| if the
+// switch is absent or malformed.
+int SwitchValue(const char* switch_name, int default_value) {
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(switch_name))
+    return default_value;
+  int result;
+  if (!base::StringToInt(command_line.GetSwitchValueASCII(switch_name),
+                         &result))
+    return default_value;
+  return result;
+}
+
+// Sorts |latencies_us| and writes throughput and latency percentiles for one
+// run to the perf log.
+void LogPingPongResults(const std::string& name,
+                        int message_count,
+                        base::TimeDelta elapsed,
+                        std::vector<int64>* latencies_us) {
+  std::sort(latencies_us->begin(), latencies_us->end());
+  const size_t count = latencies_us->size();
+  const int64 p50 = (*latencies_us)[count / 2];
+  const int64 p99 = (*latencies_us)[std::min(count - 1, count * 99 / 100)];
+  LogPerfResult((name + "_throughput").c_str(),
+                message_count / elapsed.InSecondsF(), "msgs/sec");
+  LogPerfResult((name + "_latency_p50").c_str(),
+                static_cast<double>(p50), "us");
+  LogPerfResult((name + "_latency_p99").c_str(),
+                static_cast<double>(p99), "us");
+}
+
+// Bounces every ping straight back to the sender, echoing the timestamp and
+// payload. Runs on its own IO thread.
+class EchoListener : public IPC::Channel::Listener {
+ public:
+  EchoListener() : channel_(NULL) {}
+
+  void set_channel(IPC::Channel* channel) { channel_ = channel; }
+
+  virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE {
+    PickleIterator iter(message);
+    int64 time_sent;
+    int num_fds;
+    int payload_size;
+    const char* payload;
+    EXPECT_TRUE(message.ReadInt64(&iter, &time_sent));
+    EXPECT_TRUE(message.ReadInt(&iter, &num_fds));
+    EXPECT_TRUE(message.ReadData(&iter, &payload, &payload_size));
+#if defined(OS_POSIX)
+    for (int i = 0; i < num_fds; ++i) {
+      base::FileDescriptor descriptor;
+      EXPECT_TRUE(message.ReadFileDescriptor(&iter, &descriptor));
+      if (HANDLE_EINTR(close(descriptor.fd)) < 0)
+        PLOG(ERROR) << "close";
+    }
+#endif
+
+    IPC::Message* pong = new IPC::Message(0, kPongMessageType,
+                                          IPC::Message::PRIORITY_NORMAL);
+    pong->WriteInt64(time_sent);
+    pong->WriteData(payload, payload_size);
+    channel_->Send(pong);
+    return true;
+  }
+
+ private:
+  IPC::Channel* channel_;
+
+  DISALLOW_COPY_AND_ASSIGN(EchoListener);
+};
+
+// Sends pings, keeping |depth| messages in flight, and records the
+// round-trip time of each reply. Runs on its own IO thread.
+class PingListener : public IPC::Channel::Listener {
+ public:
+  PingListener(int message_count, int message_size, int num_fds, int depth)
+      : channel_(NULL),
+        message_count_(message_count),
+        num_fds_(num_fds),
+        depth_(depth),
+        sent_(0),
+        received_(0),
+        payload_(message_size, 'a'),
+        done_(false /* manual_reset */, false /* initially_signaled */) {
+    latencies_us_.reserve(message_count);
+  }
+
+  void set_channel(IPC::Channel* channel) { channel_ = channel; }
+
+  virtual void OnChannelConnected(int32 peer_pid) OVERRIDE {
+    start_time_ = base::TimeTicks::Now();
+    for (int i = 0; i < depth_ && sent_ < message_count_; ++i)
+      SendPing();
+  }
+
+  virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE {
+    PickleIterator iter(message);
+    int64 time_sent;
+    EXPECT_TRUE(message.ReadInt64(&iter, &time_sent));
+    latencies_us_.push_back(
+        (base::TimeTicks::Now() -
+         base::TimeTicks::FromInternalValue(time_sent)).InMicroseconds());
+
+    ++received_;
+    if (sent_ < message_count_) {
+      SendPing();
+    } else if (received_ == message_count_) {
+      elapsed_ = base::TimeTicks::Now() - start_time_;
+      done_.Signal();
+    }
+    return true;
+  }
+
+  base::WaitableEvent* done_event() { return &done_; }
+  base::TimeDelta elapsed() const { return elapsed_; }
+  std::vector<int64>* latencies_us() { return &latencies_us_; }
+
+ private:
+  void SendPing() {
+    IPC::Message* ping = new IPC::Message(0, kPingMessageType,
+                                          IPC::Message::PRIORITY_NORMAL);
+    ping->WriteInt64(base::TimeTicks::Now().ToInternalValue());
+    ping->WriteInt(num_fds_);
+    ping->WriteData(payload_.data(), payload_.size());
+#if defined(OS_POSIX)
+    for (int i = 0; i < num_fds_; ++i) {
+      int fd = HANDLE_EINTR(open("/dev/null", O_RDONLY));
+      ASSERT_GE(fd, 0);
+      ASSERT_TRUE(ping->WriteFileDescriptor(base::FileDescriptor(fd, true)));
+    }
+#endif
+    ++sent_;
+    channel_->Send(ping);
+  }
+
+  IPC::Channel* channel_;
+  const int message_count_;
+  const int num_fds_;
+  const int depth_;
+  int sent_;
+  int received_;
+  std::string payload_;
+  std::vector<int64> latencies_us_;
+  base::TimeTicks start_time_;
+  base::TimeDelta elapsed_;
+  base::WaitableEvent done_;
+
+  DISALLOW_COPY_AND_ASSIGN(PingListener);
+};
+
+// The channels have to be created, connected and destroyed on their IO
+// threads.
+void CreateChannel(scoped_ptr<IPC::Channel>* channel,
+                   const std::string& name,
+                   IPC::Channel::Mode mode,
+                   IPC::Channel::Listener* listener,
+                   base::WaitableEvent* done) {
+  channel->reset(new IPC::Channel(name, mode, listener));
+  done->Signal();
+}
+
+void ConnectChannel(IPC::Channel* channel, base::WaitableEvent* done) {
+  EXPECT_TRUE(channel->Connect());
+  done->Signal();
+}
+
+void DestroyChannel(scoped_ptr<IPC::Channel>* channel,
+                    base::WaitableEvent* done) {
+  channel->reset();
+  done->Signal();
+}
+
+void RunPingPong(const PingPongConfig& config) {
+  base::Thread echo_thread("ipc perf echo");
+  base::Thread ping_thread("ipc perf ping");
+  base::Thread::Options options;
+  options.message_loop_type = MessageLoop::TYPE_IO;
+  ASSERT_TRUE(echo_thread.StartWithOptions(options));
+  ASSERT_TRUE(ping_thread.StartWithOptions(options));
+
+  EchoListener echo_listener;
+  PingListener ping_listener(config.message_count, config.message_size,
+                             config.num_fds, config.depth);
+
+  // The server side must exist before the client side tries to connect.
+  const std::string channel_name = "ipc_perftest_channel";
+  scoped_ptr<IPC::Channel> echo_channel;
+  scoped_ptr<IPC::Channel> ping_channel;
+  base::WaitableEvent created(false, false);
+  echo_thread.message_loop()->PostTask(
+      FROM_HERE,
+      base::Bind(&CreateChannel, &echo_channel, channel_name,
+                 IPC::Channel::MODE_SERVER, &echo_listener, &created));
+  created.Wait();
+  ping_thread.message_loop()->PostTask(
+      FROM_HERE,
+      base::Bind(&CreateChannel, &ping_channel, channel_name,
+                 IPC::Channel::MODE_CLIENT, &ping_listener, &created));
+  created.Wait();
+  echo_listener.set_channel(echo_channel.get());
+  ping_listener.set_channel(ping_channel.get());
+
+  base::WaitableEvent connected(false, false);
+  echo_thread.message_loop()->PostTask(
+      FROM_HERE, base::Bind(&ConnectChannel, echo_channel.get(), &connected));
+  connected.Wait();
+  ping_thread.message_loop()->PostTask(
+      FROM_HERE, base::Bind(&ConnectChannel, ping_channel.get(), &connected));
+  connected.Wait();
+
+  ping_listener.done_event()->Wait();
+
+  LogPingPongResults(config.name, config.message_count,
+                     ping_listener.elapsed(), ping_listener.latencies_us());
+
+  base::WaitableEvent destroyed(false, false);
+  ping_thread.message_loop()->PostTask(
+      FROM_HERE, base::Bind(&DestroyChannel, &ping_channel, &destroyed));
+  destroyed.Wait();
+  echo_thread.message_loop()->PostTask(
+      FROM_HERE, base::Bind(&DestroyChannel, &echo_channel, &destroyed));
+  destroyed.Wait();
+}
+
+TEST(IPCPerfTest, ChannelPingPong) {
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  if (command_line.HasSwitch(kMessageCountSwitch) ||
+      command_line.HasSwitch(kMessageSizeSwitch) ||
+      command_line.HasSwitch(kFdsSwitch) ||
+      command_line.HasSwitch(kDepthSwitch)) {
+    PingPongConfig config = {
+      "IPC_Channel_custom",
+      SwitchValue(kMessageCountSwitch, 10000),
+      SwitchValue(kMessageSizeSwitch, 64),
+      SwitchValue(kFdsSwitch, 0),
+      SwitchValue(kDepthSwitch, 1)
+    };
+    RunPingPong(config);
+    return;
+  }
+
+  for (size_t i = 0; i < arraysize(kPingPongConfigs); ++i)
+    RunPingPong(kPingPongConfigs[i]);
+}
+
+// Answers PerfTestMsg_SyncPing on its own listener thread.
+class SyncEchoListener : public IPC::Channel::Listener {
+ public:
+  SyncEchoListener() : channel_(NULL) {}
+
+  void set_channel(IPC::SyncChannel* channel) { channel_ = channel; }
+
+  // Needed by the message map to deliver the sync reply.
+  bool Send(IPC::Message* message) { return channel_->Send(message); }
+
+  virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE {
+    IPC_BEGIN_MESSAGE_MAP(SyncEchoListener, message)
+     IPC_MESSAGE_HANDLER(PerfTestMsg_SyncPing, OnSyncPing)
+    IPC_END_MESSAGE_MAP()
+    return true;
+  }
+
+ private:
+  void OnSyncPing(const std::string& payload, std::string* reply) {
+    *reply = payload;
+  }
+
+  IPC::SyncChannel* channel_;
+
+  DISALLOW_COPY_AND_ASSIGN(SyncEchoListener);
+};
+
+void CreateSyncChannel(scoped_ptr<IPC::SyncChannel>* channel,
+                       const std::string& name,
+                       IPC::Channel::Mode mode,
+                       IPC::Channel::Listener* listener,
+                       base::MessageLoopProxy* ipc_message_loop,
+                       base::WaitableEvent* shutdown_event,
+                       base::WaitableEvent* done) {
+  channel->reset(new IPC::SyncChannel(name, mode, listener, ipc_message_loop,
+                                      true, shutdown_event));
+  done->Signal();
+}
+
+void DestroySyncChannel(scoped_ptr<IPC::SyncChannel>* channel,
+                        base::WaitableEvent* done) {
+  channel->reset();
+  done->Signal();
+}
+
+TEST(IPCPerfTest, SyncChannelPingPong) {
+  const int message_count = SwitchValue(kMessageCountSwitch, 10000);
+  const int message_size = SwitchValue(kMessageSizeSwitch, 64);
+
+  MessageLoop loop;
+  base::Thread io_thread("ipc perf io");
+  base::Thread echo_thread("ipc perf sync echo");
+  base::Thread::Options options;
+  options.message_loop_type = MessageLoop::TYPE_IO;
+  ASSERT_TRUE(io_thread.StartWithOptions(options));
+  ASSERT_TRUE(echo_thread.Start());
+
+  base::WaitableEvent shutdown_event(true, false);
+  SyncEchoListener echo_listener;
+
+  const std::string channel_name = "ipc_perftest_sync_channel";
+  scoped_ptr<IPC::SyncChannel> echo_channel;
+  base::WaitableEvent created(false, false);
+  echo_thread.message_loop()->PostTask(
+      FROM_HERE,
+      base::Bind(&CreateSyncChannel, &echo_channel, channel_name,
+                 IPC::Channel::MODE_SERVER, &echo_listener,
+                 io_thread.message_loop_proxy(),
+                 &shutdown_event, &created));
+  created.Wait();
+  echo_listener.set_channel(echo_channel.get());
+
+  IPC::SyncChannel ping_channel(channel_name, IPC::Channel::MODE_CLIENT,
+                                NULL, io_thread.message_loop_proxy(), true,
+                                &shutdown_event);
+
+  const std::string payload(message_size, 'a');
+  std::vector<int64> latencies_us;
+  latencies_us.reserve(message_count);
+
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  for (int i = 0; i < message_count; ++i) {
+    std::string reply;
+    PerfTimer round_trip;
+    EXPECT_TRUE(ping_channel.Send(new PerfTestMsg_SyncPing(payload, &reply)));
+    latencies_us.push_back(round_trip.Elapsed().InMicroseconds());
+    EXPECT_EQ(payload.size(), reply.size());
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start_time;
+
+  LogPingPongResults("IPC_SyncChannel_64B", message_count, elapsed,
+                     &latencies_us);
+
+  base::WaitableEvent destroyed(false, false);
+  echo_thread.message_loop()->PostTask(
+      FROM_HERE, base::Bind(&DestroySyncChannel, &echo_channel, &destroyed));
+  destroyed.Wait();
+}
+
+}  // namespace
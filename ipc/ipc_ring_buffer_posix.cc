@@ -0,0 +1,150 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_ring_buffer_posix.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace IPC {
+namespace internal {
+
+using base::subtle::Acquire_Load;
+using base::subtle::Atomic32;
+using base::subtle::NoBarrier_Load;
+using base::subtle::Release_Store;
+
+RingBuffer::RingBuffer()
+    : header_(NULL),
+      data_(NULL),
+      capacity_(0) {
+}
+
+RingBuffer::~RingBuffer() {
+  Reset();
+}
+
+bool RingBuffer::Create(size_t data_size) {
+  DCHECK(!IsValid());
+  DCHECK_GT(data_size, 0u);
+
+  scoped_ptr<base::SharedMemory> shared_memory(new base::SharedMemory);
+  if (!shared_memory->CreateAndMapAnonymous(
+          static_cast<uint32>(sizeof(SharedHeader) + data_size))) {
+    DLOG(ERROR) << "Unable to create ring buffer of " << data_size << " bytes";
+    return false;
+  }
+
+  shared_memory_.swap(shared_memory);
+  header_ = static_cast<SharedHeader*>(shared_memory_->memory());
+  data_ = reinterpret_cast<char*>(header_ + 1);
+  capacity_ = data_size;
+  // Anonymous shared memory is zero-filled, so the offsets and the waiting
+  // flag already hold their initial values.
+  return true;
+}
+
+bool RingBuffer::Map(int fd, size_t data_size) {
+  DCHECK(!IsValid());
+  DCHECK_GT(data_size, 0u);
+
+  scoped_ptr<base::SharedMemory> shared_memory(
+      new base::SharedMemory(base::FileDescriptor(fd, true), false));
+  if (!shared_memory->Map(
+          static_cast<uint32>(sizeof(SharedHeader) + data_size))) {
+    DLOG(ERROR) << "Unable to map ring buffer of " << data_size << " bytes";
+    return false;
+  }
+
+  shared_memory_.swap(shared_memory);
+  header_ = static_cast<SharedHeader*>(shared_memory_->memory());
+  data_ = reinterpret_cast<char*>(header_ + 1);
+  capacity_ = data_size;
+  return true;
+}
+
+void RingBuffer::Reset() {
+  shared_memory_.reset();
+  header_ = NULL;
+  data_ = NULL;
+  capacity_ = 0;
+}
+
+int RingBuffer::GetFileDescriptor() const {
+  DCHECK(IsValid());
+  return shared_memory_->handle().fd;
+}
+
+size_t RingBuffer::Write(const char* data, size_t len) {
+  DCHECK(IsValid());
+  // Only this side moves write_offset, so no barrier is needed to load it.
+  size_t write_offset = SanitizeOffset(NoBarrier_Load(&header_->write_offset));
+  size_t read_offset = SanitizeOffset(Acquire_Load(&header_->read_offset));
+
+  // One byte is left unused so that write_offset == read_offset always means
+  // "empty" rather than being ambiguous with "full".
+  size_t available =
+      (read_offset + capacity_ - write_offset - 1) % capacity_;
+  size_t amount = std::min(len, available);
+
+  size_t first_chunk = std::min(amount, capacity_ - write_offset);
+  memcpy(data_ + write_offset, data, first_chunk);
+  memcpy(data_, data + first_chunk, amount - first_chunk);
+
+  // Publish the data before exposing the new offset to the consumer.
+  Release_Store(&header_->write_offset,
+                static_cast<Atomic32>((write_offset + amount) % capacity_));
+  return amount;
+}
+
+size_t RingBuffer::Read(char* buffer, size_t buffer_len) {
+  DCHECK(IsValid());
+  size_t read_offset = SanitizeOffset(NoBarrier_Load(&header_->read_offset));
+  size_t write_offset = SanitizeOffset(Acquire_Load(&header_->write_offset));
+
+  size_t used = (write_offset + capacity_ - read_offset) % capacity_;
+  size_t amount = std::min(buffer_len, used);
+
+  size_t first_chunk = std::min(amount, capacity_ - read_offset);
+  memcpy(buffer, data_ + read_offset, first_chunk);
+  memcpy(buffer + first_chunk, data_, amount - first_chunk);
+
+  // Release the space before exposing the new offset to the producer.
+  Release_Store(&header_->read_offset,
+                static_cast<Atomic32>((read_offset + amount) % capacity_));
+  return amount;
+}
+
+bool RingBuffer::SetProducerWaiting() {
+  DCHECK(IsValid());
+  Release_Store(&header_->producer_waiting, 1);
+  // Re-check for space after the flag is published. This closes the race
+  // where the consumer drains the buffer (and finds the flag still clear)
+  // between our failed write and the store above, which would otherwise
+  // leave the producer waiting for a wakeup that never comes.
+  size_t write_offset = SanitizeOffset(NoBarrier_Load(&header_->write_offset));
+  size_t read_offset = SanitizeOffset(Acquire_Load(&header_->read_offset));
+  return (read_offset + capacity_ - write_offset - 1) % capacity_ > 0;
+}
+
+bool RingBuffer::TakeProducerWaiting() {
+  DCHECK(IsValid());
+  if (!Acquire_Load(&header_->producer_waiting))
+    return false;
+  Release_Store(&header_->producer_waiting, 0);
+  return true;
+}
+
+size_t RingBuffer::SanitizeOffset(Atomic32 offset) const {
+  size_t result = static_cast<size_t>(offset);
+  if (result >= capacity_)
+    return 0;
+  return result;
+}
+
+}  // namespace internal
+}  // namespace IPC
@@ -0,0 +1,100 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_IPC_RING_BUFFER_POSIX_H_
+#define IPC_IPC_RING_BUFFER_POSIX_H_
+#pragma once
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/shared_memory.h"
+
+namespace IPC {
+namespace internal {
+
+// A single-producer, single-consumer byte ring buffer backed by a shared
+// memory segment, used by the POSIX Channel's shared-memory transport mode
+// (see ipc_channel_posix.h). One end Create()s the segment and passes its
+// file descriptor to the peer, which Map()s it; each side then uses one
+// RingBuffer exclusively as producer and another exclusively as consumer.
+//
+// The buffer itself carries no wakeup mechanism; the Channel signals the
+// peer over a socket after writing. When the producer runs out of space it
+// raises a flag in the shared header (SetProducerWaiting()) and the consumer
+// answers with a wakeup once it has drained some data
+// (TakeProducerWaiting()).
+//
+// The peer process is not trusted: all offsets read from the shared header
+// are range-checked, so a compromised peer can at worst corrupt its own
+// message bytes, which the message parser already has to cope with.
+class RingBuffer {
+ public:
+  RingBuffer();
+  ~RingBuffer();
+
+  // Creates an anonymous shared memory segment with |data_size| bytes of
+  // buffer space and maps it. Returns false on failure.
+  bool Create(size_t data_size);
+
+  // Maps a segment of |data_size| buffer bytes received from the peer.
+  // Takes ownership of |fd| (it is closed on failure too). Returns false on
+  // failure.
+  bool Map(int fd, size_t data_size);
+
+  // Unmaps and closes the segment, if any.
+  void Reset();
+
+  bool IsValid() const { return header_ != NULL; }
+
+  // The descriptor to pass to the peer. Only valid after a successful
+  // Create() or Map(); ownership stays with this object.
+  int GetFileDescriptor() const;
+
+  // Producer side: copies up to |len| bytes of |data| into the buffer.
+  // Returns the number of bytes accepted, which is less than |len| when the
+  // buffer fills up.
+  size_t Write(const char* data, size_t len);
+
+  // Consumer side: copies up to |buffer_len| buffered bytes into |buffer|
+  // and returns the number copied (zero when the buffer is empty).
+  size_t Read(char* buffer, size_t buffer_len);
+
+  // Producer side: called after a short Write() to ask the consumer for a
+  // wakeup once it drains data. Returns true if space became available
+  // between the failed write and the flag becoming visible, in which case
+  // the producer should simply retry instead of waiting.
+  bool SetProducerWaiting();
+
+  // Consumer side: called after consuming data. Returns true if the
+  // producer asked to be woken, clearing the request.
+  bool TakeProducerWaiting();
+
+ private:
+  // Lives at the start of the shared segment. Each field is written by
+  // exactly one side (offsets by their owners, the flag by both, but only
+  // ever to opposite values).
+  struct SharedHeader {
+    base::subtle::Atomic32 write_offset;     // Owned by the producer.
+    base::subtle::Atomic32 read_offset;      // Owned by the consumer.
+    base::subtle::Atomic32 producer_waiting;
+    base::subtle::Atomic32 unused;           // Keeps data 16-byte aligned.
+  };
+
+  // Returns |offset| if it is a plausible offset into the data area, and 0
+  // if the (untrusted) peer scribbled on the header.
+  size_t SanitizeOffset(base::subtle::Atomic32 offset) const;
+
+  scoped_ptr<base::SharedMemory> shared_memory_;
+  SharedHeader* header_;
+  char* data_;
+  size_t capacity_;
+
+  DISALLOW_COPY_AND_ASSIGN(RingBuffer);
+};
+
+}  // namespace internal
+}  // namespace IPC
+
+#endif  // IPC_IPC_RING_BUFFER_POSIX_H_
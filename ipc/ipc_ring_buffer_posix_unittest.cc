@@ -0,0 +1,112 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This test is POSIX only.
+
+#include "ipc/ipc_ring_buffer_posix.h"
+
+#include <unistd.h>
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/eintr_wrapper.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Small enough that the tests can easily fill and wrap the buffer.
+const size_t kTestRingSize = 32;
+
+TEST(IPCRingBufferTest, BasicWriteRead) {
+  IPC::internal::RingBuffer ring;
+  ASSERT_TRUE(ring.Create(kTestRingSize));
+  EXPECT_TRUE(ring.IsValid());
+
+  char buffer[kTestRingSize];
+  EXPECT_EQ(0u, ring.Read(buffer, sizeof(buffer)));
+
+  EXPECT_EQ(5u, ring.Write("hello", 5));
+  EXPECT_EQ(5u, ring.Read(buffer, sizeof(buffer)));
+  EXPECT_EQ(0, memcmp(buffer, "hello", 5));
+  EXPECT_EQ(0u, ring.Read(buffer, sizeof(buffer)));
+}
+
+TEST(IPCRingBufferTest, FillAndWrapAround) {
+  IPC::internal::RingBuffer ring;
+  ASSERT_TRUE(ring.Create(kTestRingSize));
+
+  // One byte is reserved to tell "full" from "empty".
+  std::string input;
+  for (size_t i = 0; i < kTestRingSize; ++i)
+    input.push_back(static_cast<char>('a' + (i % 26)));
+  EXPECT_EQ(kTestRingSize - 1, ring.Write(input.data(), input.size()));
+  EXPECT_EQ(0u, ring.Write(input.data(), input.size()));
+
+  // Drain a few bytes and refill so that the write wraps around the end of
+  // the buffer; the data must still come out in order.
+  char buffer[kTestRingSize];
+  EXPECT_EQ(10u, ring.Read(buffer, 10));
+  EXPECT_EQ(0, memcmp(buffer, input.data(), 10));
+  EXPECT_EQ(10u, ring.Write("0123456789", 10));
+
+  std::string output;
+  size_t bytes_read;
+  while ((bytes_read = ring.Read(buffer, sizeof(buffer))) > 0)
+    output.append(buffer, bytes_read);
+  EXPECT_EQ(input.substr(10, kTestRingSize - 1 - 10) + "0123456789", output);
+}
+
+TEST(IPCRingBufferTest, MapSharesMemory) {
+  IPC::internal::RingBuffer producer;
+  ASSERT_TRUE(producer.Create(kTestRingSize));
+
+  // The channel passes the descriptor to another process; here a dup() is
+  // enough to prove both mappings see the same bytes.
+  IPC::internal::RingBuffer consumer;
+  int fd = HANDLE_EINTR(dup(producer.GetFileDescriptor()));
+  ASSERT_GE(fd, 0);
+  ASSERT_TRUE(consumer.Map(fd, kTestRingSize));
+
+  EXPECT_EQ(4u, producer.Write("ping", 4));
+  char buffer[kTestRingSize];
+  EXPECT_EQ(4u, consumer.Read(buffer, sizeof(buffer)));
+  EXPECT_EQ(0, memcmp(buffer, "ping", 4));
+
+  // And the consumed space must be visible to the producer again.
+  std::string input(kTestRingSize - 1, 'x');
+  EXPECT_EQ(kTestRingSize - 1, producer.Write(input.data(), input.size()));
+}
+
+TEST(IPCRingBufferTest, ProducerWaitingHandshake) {
+  IPC::internal::RingBuffer producer;
+  ASSERT_TRUE(producer.Create(kTestRingSize));
+
+  IPC::internal::RingBuffer consumer;
+  int fd = HANDLE_EINTR(dup(producer.GetFileDescriptor()));
+  ASSERT_GE(fd, 0);
+  ASSERT_TRUE(consumer.Map(fd, kTestRingSize));
+
+  EXPECT_FALSE(consumer.TakeProducerWaiting());
+
+  std::string input(kTestRingSize, 'y');
+  EXPECT_EQ(kTestRingSize - 1, producer.Write(input.data(), input.size()));
+  // The buffer is full and stays full, so the producer has to wait.
+  EXPECT_FALSE(producer.SetProducerWaiting());
+
+  char buffer[kTestRingSize];
+  EXPECT_EQ(10u, consumer.Read(buffer, 10));
+  // The consumer finds the request and the producer can continue.
+  EXPECT_TRUE(consumer.TakeProducerWaiting());
+  EXPECT_FALSE(consumer.TakeProducerWaiting());
+  EXPECT_EQ(10u, producer.Write(input.data(), input.size()));
+
+  // If the consumer drains between the failed write and the flag being
+  // raised, SetProducerWaiting reports that space is already available.
+  EXPECT_EQ(0u, producer.Write(input.data(), input.size()));
+  EXPECT_EQ(5u, consumer.Read(buffer, 5));
+  EXPECT_TRUE(producer.SetProducerWaiting());
+}
+
+}  // namespace
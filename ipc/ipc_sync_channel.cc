@@ -8,6 +8,7 @@
 #include "base/lazy_instance.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/threading/platform_thread.h"
 #include "base/threading/thread_local.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/synchronization/waitable_event_watcher.h"
@@ -18,6 +19,40 @@ using base::TimeTicks;
 using base::WaitableEvent;
 
 namespace IPC {
+
+namespace {
+
+// CPU budget for the adaptive spin in WaitForReply, settable through
+// SyncChannel::SetReplySpinBudget. A reply that arrives within the budget
+// costs some burned CPU instead of a sleep/wake round trip through the
+// scheduler, which for very fast sync calls dominates the actual work.
+int64 g_reply_spin_budget_us = 50;
+
+// Polls |objects| for up to |spin_budget_us| before handing off to WaitMany.
+// The dispatch and send done events are manual-reset, so checking
+// IsSignaled() does not eat a signal that WaitMany would then miss; for an
+// auto-reset pump messages event the check consumes the signal exactly like
+// WaitMany would. Like WaitMany, returns the index of a signaled event,
+// preferring the lowest one.
+size_t SpinThenWaitMany(WaitableEvent** objects,
+                        size_t count,
+                        int64 spin_budget_us) {
+  if (spin_budget_us > 0) {
+    TimeTicks spin_deadline = TimeTicks::Now() +
+        TimeDelta::FromMicroseconds(spin_budget_us);
+    do {
+      for (size_t i = 0; i < count; ++i) {
+        if (objects[i]->IsSignaled())
+          return i;
+      }
+      base::PlatformThread::YieldCurrentThread();
+    } while (TimeTicks::Now() < spin_deadline);
+  }
+  return WaitableEvent::WaitMany(objects, count);
+}
+
+}  // namespace
+
 // When we're blocked in a Send(), we need to process incoming synchronous
 // messages right away because it could be blocking our reply (either
 // directly from the same object we're calling, or indirectly through one or
@@ -229,7 +264,8 @@ SyncChannel::SyncContext::SyncContext(
     : ChannelProxy::Context(listener, ipc_thread),
       received_sync_msgs_(ReceivedSyncMsgQueue::AddContext()),
       shutdown_event_(shutdown_event),
-      restrict_dispatch_group_(kRestrictDispatchGroup_None) {
+      restrict_dispatch_group_(kRestrictDispatchGroup_None),
+      avg_reply_wait_us_(base::Time::kMicrosecondsPerSecond) {
 }
 
 SyncChannel::SyncContext::~SyncContext() {
@@ -364,6 +400,21 @@ void SyncChannel::SyncContext::OnSendTimeout(int message_id) {
   }
 }
 
+int64 SyncChannel::SyncContext::GetReplySpinBudget() const {
+  // Spin only when the recent replies themselves came back within the
+  // budget; otherwise the spin would burn its budget and block anyway.
+  if (avg_reply_wait_us_ > g_reply_spin_budget_us)
+    return 0;
+  return g_reply_spin_budget_us;
+}
+
+void SyncChannel::SyncContext::RecordReplyWait(base::TimeDelta wait) {
+  // Exponential moving average weighting history against the new sample
+  // 7:1. The initial value is high, so a channel has to prove itself fast
+  // before any CPU gets burned on it.
+  avg_reply_wait_us_ = (7 * avg_reply_wait_us_ + wait.InMicroseconds()) / 8;
+}
+
 void SyncChannel::SyncContext::CancelPendingSends() {
   base::AutoLock auto_lock(deserializers_lock_);
   PendingSyncMessageQueue::iterator iter;
@@ -409,6 +460,11 @@ SyncChannel::SyncChannel(
 SyncChannel::~SyncChannel() {
 }
 
+// static
+void SyncChannel::SetReplySpinBudget(base::TimeDelta budget) {
+  g_reply_spin_budget_us = budget.InMicroseconds();
+}
+
 void SyncChannel::SetRestrictDispatchChannelGroup(int group) {
   sync_context()->set_restrict_dispatch_group(group);
 }
@@ -459,6 +515,7 @@ bool SyncChannel::SendWithTimeout(Message* message, int timeout_ms) {
 void SyncChannel::WaitForReply(
     SyncContext* context, WaitableEvent* pump_messages_event) {
   context->DispatchMessages();
+  TimeTicks wait_start = TimeTicks::Now();
   while (true) {
     WaitableEvent* objects[] = {
       context->GetDispatchEvent(),
@@ -467,7 +524,8 @@ void SyncChannel::WaitForReply(
     };
 
     unsigned count = pump_messages_event ? 3: 2;
-    size_t result = WaitableEvent::WaitMany(objects, count);
+    size_t result = SpinThenWaitMany(objects, count,
+                                     context->GetReplySpinBudget());
     if (result == 0 /* dispatch event */) {
       // We're waiting for a reply, but we received a blocking synchronous
       // call.  We must process it or otherwise a deadlock might occur.
@@ -481,6 +539,7 @@ void SyncChannel::WaitForReply(
 
     break;
   }
+  context->RecordReplyWait(TimeTicks::Now() - wait_start);
 }
 
 void SyncChannel::WaitForReplyWithNestedMessageLoop(SyncContext* context) {
@@ -13,6 +13,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event_watcher.h"
+#include "base/time.h"
 #include "ipc/ipc_channel_handle.h"
 #include "ipc/ipc_channel_proxy.h"
 #include "ipc/ipc_sync_message.h"
@@ -92,6 +93,13 @@ class IPC_EXPORT SyncChannel : public ChannelProxy,
     sync_messages_with_no_timeout_allowed_ = value;
   }
 
+  // Adjusts how much CPU time a blocked sync Send may burn polling for its
+  // reply before parking on the done event. When the recent replies on a
+  // channel came back within the budget, the next wait spins instead of
+  // paying a scheduler round trip that can dominate sub-100us sync calls
+  // (cookie lookups, clipboard). Zero disables spinning entirely.
+  static void SetReplySpinBudget(base::TimeDelta budget);
+
   // Sets the dispatch group for this channel, to only allow re-entrant dispatch
   // of messages to other channels in the same group.
   //
@@ -164,6 +172,12 @@ class IPC_EXPORT SyncChannel : public ChannelProxy,
       return restrict_dispatch_group_;
     }
 
+    // Adaptive spin bookkeeping for WaitForReply, only used on the listener
+    // thread. The budget is non-zero only while the recent replies have been
+    // coming back quickly enough that spinning is likely to pay off.
+    int64 GetReplySpinBudget() const;
+    void RecordReplyWait(base::TimeDelta wait);
+
    private:
     virtual ~SyncContext();
     // ChannelProxy methods that we override.
@@ -192,6 +206,10 @@ class IPC_EXPORT SyncChannel : public ChannelProxy,
     base::WaitableEvent* shutdown_event_;
     base::WaitableEventWatcher shutdown_watcher_;
     int restrict_dispatch_group_;
+
+    // Moving average of how long the recent WaitForReply calls took, in
+    // microseconds. Only touched on the listener thread.
+    int64 avg_reply_wait_us_;
   };
 
  private:
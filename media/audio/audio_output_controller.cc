@@ -37,7 +37,7 @@ AudioOutputController::AudioOutputController(EventHandler* handler,
 }
 
 AudioOutputController::~AudioOutputController() {
-  DCHECK_EQ(kClosed, state_);
+  DCHECK_EQ(kClosed, GetState());
   DCHECK(message_loop_);
 
   if (!message_loop_.get() || message_loop_->BelongsToCurrentThread()) {
@@ -114,9 +114,9 @@ void AudioOutputController::DoCreate(AudioManager* audio_manager,
   DCHECK(message_loop_->BelongsToCurrentThread());
 
   // Close() can be called before DoCreate() is executed.
-  if (state_ == kClosed)
+  if (GetState() == kClosed)
     return;
-  DCHECK_EQ(kEmpty, state_);
+  DCHECK_EQ(kEmpty, GetState());
 
   DoStopCloseAndClearStream(NULL);
   stream_ = audio_manager->MakeAudioOutputStreamProxy(params);
@@ -138,7 +138,7 @@ void AudioOutputController::DoCreate(AudioManager* audio_manager,
   stream_->SetVolume(volume_);
 
   // Finally set the state to kCreated.
-  state_ = kCreated;
+  SetState(kCreated);
 
   // And then report we have been created.
   handler_->OnCreated(this);
@@ -148,10 +148,11 @@ void AudioOutputController::DoPlay() {
   DCHECK(message_loop_->BelongsToCurrentThread());
 
   // We can start from created or paused state.
-  if (state_ != kCreated && state_ != kPaused)
+  State state = GetState();
+  if (state != kCreated && state != kPaused)
     return;
 
-  state_ = kStarting;
+  SetState(kStarting);
 
   // Ask for first packet.
   sync_reader_->UpdatePendingBytes(0);
@@ -172,10 +173,11 @@ void AudioOutputController::PollAndStartIfDataReady() {
   DCHECK(message_loop_->BelongsToCurrentThread());
 
   // Being paranoid: do nothing if state unexpectedly changed.
-  if ((state_ != kStarting) && (state_ != kPausedWhenStarting))
+  State state = GetState();
+  if ((state != kStarting) && (state != kPausedWhenStarting))
     return;
 
-  bool pausing = (state_ == kPausedWhenStarting);
+  bool pausing = (state == kPausedWhenStarting);
   // If we are ready to start the stream, start it.
   // Of course we may have to stop it immediately...
   if (--number_polling_attempts_left_ == 0 ||
@@ -196,7 +198,7 @@ void AudioOutputController::PollAndStartIfDataReady() {
 
 void AudioOutputController::StartStream() {
   DCHECK(message_loop_->BelongsToCurrentThread());
-  state_ = kPlaying;
+  SetState(kPlaying);
 
   // We start the AudioOutputStream lazily.
   stream_->Start(this);
@@ -211,16 +213,16 @@ void AudioOutputController::DoPause() {
   if (stream_)
     stream_->Stop();
 
-  switch (state_) {
+  switch (GetState()) {
     case kStarting:
       // We were asked to pause while starting. There is delayed task that will
       // try starting playback, and there is no way to remove that task from the
       // queue. If we stop now that task will be executed anyway.
       // Delay pausing, let delayed task to do pause after it start playback.
-      state_ = kPausedWhenStarting;
+      SetState(kPausedWhenStarting);
       break;
     case kPlaying:
-      state_ = kPaused;
+      SetState(kPaused);
 
       // Then we stop the audio device. This is not the perfect solution
       // because it discards all the internal buffer in the audio device.
@@ -246,10 +248,10 @@ void AudioOutputController::DoFlush() {
 void AudioOutputController::DoClose() {
   DCHECK(message_loop_->BelongsToCurrentThread());
 
-  if (state_ != kClosed) {
+  if (GetState() != kClosed) {
     DoStopCloseAndClearStream(NULL);
     sync_reader_->Close();
-    state_ = kClosed;
+    SetState(kClosed);
   }
 }
 
@@ -260,7 +262,7 @@ void AudioOutputController::DoSetVolume(double volume) {
   // right away but when the stream is created we'll set the volume.
   volume_ = volume;
 
-  switch (state_) {
+  switch (GetState()) {
     case kCreated:
     case kStarting:
     case kPausedWhenStarting:
@@ -275,7 +277,7 @@ void AudioOutputController::DoSetVolume(double volume) {
 
 void AudioOutputController::DoReportError(int code) {
   DCHECK(message_loop_->BelongsToCurrentThread());
-  if (state_ != kClosed)
+  if (GetState() != kClosed)
     handler_->OnError(this, code);
 }
 
@@ -284,14 +286,13 @@ uint32 AudioOutputController::OnMoreData(uint8* dest,
                                          AudioBuffersState buffers_state) {
   TRACE_EVENT0("audio", "AudioOutputController::OnMoreData");
 
-  {
-    // Check state and do nothing if we are not playing.
-    // We are on the hardware audio thread, so lock is needed.
-    base::AutoLock auto_lock(lock_);
-    if (state_ != kPlaying) {
-      return 0;
-    }
-  }
+  // Check state and do nothing if we are not playing. We are on the
+  // hardware audio thread, so the state is read with an acquire load
+  // rather than under a lock; the realtime callback must never block on
+  // the audio manager thread.
+  if (GetState() != kPlaying)
+    return 0;
+
   uint32 size = sync_reader_->Read(dest, max_size);
   sync_reader_->UpdatePendingBytes(buffers_state.total_bytes() + size);
   return size;
@@ -333,4 +334,13 @@ void AudioOutputController::DoStopCloseAndClearStream(WaitableEvent *done) {
     done->Signal();
 }
 
+void AudioOutputController::SetState(State state) {
+  DCHECK(message_loop_->BelongsToCurrentThread());
+  base::subtle::Release_Store(&state_, state);
+}
+
+AudioOutputController::State AudioOutputController::GetState() const {
+  return static_cast<State>(base::subtle::Acquire_Load(&state_));
+}
+
 }  // namespace media
@@ -5,11 +5,11 @@
 #ifndef MEDIA_AUDIO_AUDIO_OUTPUT_CONTROLLER_H_
 #define MEDIA_AUDIO_AUDIO_OUTPUT_CONTROLLER_H_
 
+#include "base/atomicops.h"
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
-#include "base/synchronization/lock.h"
 #include "base/time.h"
 #include "media/audio/audio_buffers_state.h"
 #include "media/audio/audio_io.h"
@@ -194,6 +194,12 @@ class MEDIA_EXPORT AudioOutputController
   // Signals event when done if it is not NULL.
   void DoStopCloseAndClearStream(base::WaitableEvent *done);
 
+  // |state_| accessors. SetState() must be called on the audio manager
+  // thread; GetState() may be called from any thread, including the
+  // hardware audio thread, without taking a lock.
+  void SetState(State state);
+  State GetState() const;
+
   // |handler_| may be called only if |state_| is not kClosed.
   EventHandler* handler_;
   AudioOutputStream* stream_;
@@ -202,13 +208,10 @@ class MEDIA_EXPORT AudioOutputController
   double volume_;
 
   // |state_| is written on the audio manager thread and is read on the
-  // hardware audio thread. These operations need to be locked. But lock
-  // is not required for reading on the audio manager thread.
-  State state_;
-
-  // The |lock_| must be acquired whenever we access |state_| from a thread
-  // other than the audio manager thread.
-  base::Lock lock_;
+  // hardware audio thread. Stores are releases and loads are acquires so
+  // that the hardware audio thread observes a consistent state without
+  // ever blocking on a lock held by the audio manager thread.
+  base::subtle::Atomic32 state_;
 
   // SyncReader is used only in low latency mode for synchronous reading.
   SyncReader* sync_reader_;
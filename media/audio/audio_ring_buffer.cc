@@ -0,0 +1,93 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/audio/audio_ring_buffer.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+using base::subtle::Acquire_Load;
+using base::subtle::NoBarrier_Load;
+using base::subtle::Release_Store;
+
+namespace media {
+
+AudioRingBuffer::AudioRingBuffer(void* memory, uint32 memory_size)
+    : header_(static_cast<Header*>(memory)),
+      data_(static_cast<uint8*>(memory) + sizeof(Header)),
+      capacity_(memory_size - sizeof(Header)) {
+  DCHECK(memory);
+  DCHECK_GT(memory_size, GetMemoryOverhead());
+}
+
+AudioRingBuffer::~AudioRingBuffer() {}
+
+// static
+uint32 AudioRingBuffer::GetMemoryOverhead() {
+  // One byte of the data area is sacrificed to distinguish full from empty.
+  return sizeof(Header) + 1;
+}
+
+// static
+uint32 AudioRingBuffer::GetDataCapacity(uint32 memory_size) {
+  DCHECK_GT(memory_size, GetMemoryOverhead());
+  return memory_size - GetMemoryOverhead();
+}
+
+void AudioRingBuffer::Reset() {
+  Release_Store(&header_->read_position, 0);
+  Release_Store(&header_->write_position, 0);
+}
+
+uint32 AudioRingBuffer::Push(const void* source, uint32 size) {
+  // Only the producer moves |write_position|, so a plain load suffices for
+  // it.  Acquiring |read_position| guarantees the consumer is done reading
+  // any bytes we are about to overwrite.
+  const uint32 write = NoBarrier_Load(&header_->write_position);
+  const uint32 read = Acquire_Load(&header_->read_position);
+  const uint32 free_space = (read + capacity_ - write - 1) % capacity_;
+  const uint32 count = std::min(size, free_space);
+
+  const uint32 first_chunk = std::min(count, capacity_ - write);
+  memcpy(data_ + write, source, first_chunk);
+  memcpy(data_, static_cast<const uint8*>(source) + first_chunk,
+         count - first_chunk);
+
+  // Publish the data before exposing the new write position.
+  Release_Store(&header_->write_position, (write + count) % capacity_);
+  return count;
+}
+
+uint32 AudioRingBuffer::Pop(void* destination, uint32 size) {
+  // Only the consumer moves |read_position|.  Acquiring |write_position|
+  // guarantees the producer's writes to the data area are visible.
+  const uint32 read = NoBarrier_Load(&header_->read_position);
+  const uint32 write = Acquire_Load(&header_->write_position);
+  const uint32 available = (write + capacity_ - read) % capacity_;
+  const uint32 count = std::min(size, available);
+
+  const uint32 first_chunk = std::min(count, capacity_ - read);
+  memcpy(destination, data_ + read, first_chunk);
+  memcpy(static_cast<uint8*>(destination) + first_chunk, data_,
+         count - first_chunk);
+
+  // Release the consumed bytes back to the producer.
+  Release_Store(&header_->read_position, (read + count) % capacity_);
+  return count;
+}
+
+uint32 AudioRingBuffer::GetAvailable() const {
+  const uint32 read = Acquire_Load(&header_->read_position);
+  const uint32 write = Acquire_Load(&header_->write_position);
+  return (write + capacity_ - read) % capacity_;
+}
+
+uint32 AudioRingBuffer::GetFreeSpace() const {
+  return capacity_ - 1 - GetAvailable();
+}
+
+}  // namespace media
@@ -0,0 +1,82 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MEDIA_AUDIO_AUDIO_RING_BUFFER_H_
+#define MEDIA_AUDIO_AUDIO_RING_BUFFER_H_
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
+#include "media/base/media_export.h"
+
+namespace media {
+
+// A lock-free single-producer/single-consumer ring buffer for audio data.
+//
+// The ring operates on a caller-owned region of memory, so it can be placed
+// in shared memory and used to stream audio between a renderer-side producer
+// and a browser-side consumer.  One thread (or process) may call Push()
+// while another concurrently calls Pop(); neither call blocks or takes a
+// lock, which makes Pop() safe to call from a realtime OS audio callback.
+// CrossProcessNotification can be used alongside the ring to wake up a
+// producer that has run out of space.
+//
+// The first bytes of the region hold the read and write positions; the rest
+// holds audio data.  Both sides must construct their AudioRingBuffer over
+// the same region with the same size, and exactly one side must call Reset()
+// before the first Push() or Pop().
+class MEDIA_EXPORT AudioRingBuffer {
+ public:
+  // Creates a ring over |memory| of |memory_size| bytes.  Does not take
+  // ownership of |memory| and does not modify it during construction.
+  // |memory_size| must be larger than GetMemoryOverhead().
+  AudioRingBuffer(void* memory, uint32 memory_size);
+  ~AudioRingBuffer();
+
+  // Number of bytes of |memory| used for bookkeeping rather than data.
+  static uint32 GetMemoryOverhead();
+
+  // Number of bytes of audio data a ring over a region of |memory_size|
+  // bytes can hold.
+  static uint32 GetDataCapacity(uint32 memory_size);
+
+  // Resets the read and write positions, discarding all buffered data.
+  // Must not be called concurrently with Push() or Pop().
+  void Reset();
+
+  // Appends up to |size| bytes from |source| to the ring and returns the
+  // number of bytes actually written.  Only the producer may call this.
+  uint32 Push(const void* source, uint32 size);
+
+  // Removes up to |size| bytes from the ring into |destination| and returns
+  // the number of bytes actually read.  Only the consumer may call this.
+  uint32 Pop(void* destination, uint32 size);
+
+  // Number of buffered bytes available to Pop().  The result is a lower
+  // bound when called by the producer and exact when called by the consumer.
+  uint32 GetAvailable() const;
+
+  // Number of free bytes available to Push().  The result is a lower bound
+  // when called by the consumer and exact when called by the producer.
+  uint32 GetFreeSpace() const;
+
+ private:
+  // Lives at the start of the shared region.  Positions are byte offsets
+  // into the data area in the range [0, capacity).  One byte of the data
+  // area is always kept free so that an empty ring (read == write) can be
+  // told apart from a full one.
+  struct Header {
+    base::subtle::Atomic32 read_position;
+    base::subtle::Atomic32 write_position;
+  };
+
+  Header* header_;
+  uint8* data_;
+  uint32 capacity_;
+
+  DISALLOW_COPY_AND_ASSIGN(AudioRingBuffer);
+};
+
+}  // namespace media
+
+#endif  // MEDIA_AUDIO_AUDIO_RING_BUFFER_H_
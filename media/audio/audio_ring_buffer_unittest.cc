@@ -0,0 +1,141 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/audio/audio_ring_buffer.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/threading/platform_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+namespace {
+
+const uint32 kMemorySize = 64;
+
+// Produces |total_bytes| of a deterministic byte pattern, pushing whatever
+// the ring has room for and yielding when the ring is full.
+class Producer : public base::PlatformThread::Delegate {
+ public:
+  Producer(AudioRingBuffer* ring, uint32 total_bytes)
+      : ring_(ring), total_bytes_(total_bytes) {
+  }
+  virtual ~Producer() {}
+
+  virtual void ThreadMain() OVERRIDE {
+    uint32 produced = 0;
+    while (produced < total_bytes_) {
+      uint8 chunk[13];
+      uint32 chunk_size = std::min(
+          static_cast<uint32>(sizeof(chunk)), total_bytes_ - produced);
+      for (uint32 i = 0; i < chunk_size; ++i)
+        chunk[i] = static_cast<uint8>(produced + i);
+      uint32 pushed = ring_->Push(chunk, chunk_size);
+      produced += pushed;
+      if (pushed < chunk_size)
+        base::PlatformThread::YieldCurrentThread();
+    }
+  }
+
+ private:
+  AudioRingBuffer* ring_;
+  uint32 total_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(Producer);
+};
+
+}  // namespace
+
+TEST(AudioRingBufferTest, PushPop) {
+  uint8 memory[kMemorySize];
+  AudioRingBuffer ring(memory, kMemorySize);
+  ring.Reset();
+
+  EXPECT_EQ(0u, ring.GetAvailable());
+  EXPECT_EQ(AudioRingBuffer::GetDataCapacity(kMemorySize),
+            ring.GetFreeSpace());
+
+  const uint8 kData[] = { 1, 2, 3, 4, 5 };
+  EXPECT_EQ(sizeof(kData), ring.Push(kData, sizeof(kData)));
+  EXPECT_EQ(sizeof(kData), ring.GetAvailable());
+
+  uint8 read_back[sizeof(kData)] = { 0 };
+  EXPECT_EQ(sizeof(kData), ring.Pop(read_back, sizeof(read_back)));
+  EXPECT_EQ(0, memcmp(kData, read_back, sizeof(kData)));
+  EXPECT_EQ(0u, ring.GetAvailable());
+}
+
+TEST(AudioRingBufferTest, PushToFullRing) {
+  uint8 memory[kMemorySize];
+  AudioRingBuffer ring(memory, kMemorySize);
+  ring.Reset();
+
+  uint32 capacity = AudioRingBuffer::GetDataCapacity(kMemorySize);
+  std::vector<uint8> data(capacity + 10, 0xab);
+
+  // A push larger than the capacity is truncated, and further pushes fail
+  // until data has been popped.
+  EXPECT_EQ(capacity, ring.Push(&data[0], data.size()));
+  EXPECT_EQ(0u, ring.GetFreeSpace());
+  EXPECT_EQ(0u, ring.Push(&data[0], 1));
+
+  uint8 byte = 0;
+  EXPECT_EQ(1u, ring.Pop(&byte, 1));
+  EXPECT_EQ(0xab, byte);
+  EXPECT_EQ(1u, ring.GetFreeSpace());
+}
+
+TEST(AudioRingBufferTest, WrapAround) {
+  uint8 memory[kMemorySize];
+  AudioRingBuffer ring(memory, kMemorySize);
+  ring.Reset();
+
+  // Repeatedly push and pop chunks whose size does not divide the capacity
+  // so that reads and writes straddle the end of the data area.
+  uint32 counter = 0;
+  for (int i = 0; i < 100; ++i) {
+    uint8 chunk[7];
+    for (size_t j = 0; j < sizeof(chunk); ++j)
+      chunk[j] = static_cast<uint8>(counter + j);
+    ASSERT_EQ(sizeof(chunk), ring.Push(chunk, sizeof(chunk)));
+
+    uint8 read_back[sizeof(chunk)] = { 0 };
+    ASSERT_EQ(sizeof(chunk), ring.Pop(read_back, sizeof(read_back)));
+    ASSERT_EQ(0, memcmp(chunk, read_back, sizeof(chunk)));
+    counter += sizeof(chunk);
+  }
+}
+
+TEST(AudioRingBufferTest, ThreadedProducerConsumer) {
+  uint8 memory[kMemorySize];
+  AudioRingBuffer ring(memory, kMemorySize);
+  ring.Reset();
+
+  const uint32 kTotalBytes = 100000;
+  Producer producer(&ring, kTotalBytes);
+  base::PlatformThreadHandle thread;
+  ASSERT_TRUE(base::PlatformThread::Create(0, &producer, &thread));
+
+  // Consume on this thread and verify that the byte pattern arrives intact
+  // and in order.
+  uint32 consumed = 0;
+  while (consumed < kTotalBytes) {
+    uint8 chunk[32];
+    uint32 popped = ring.Pop(chunk, sizeof(chunk));
+    for (uint32 i = 0; i < popped; ++i)
+      ASSERT_EQ(static_cast<uint8>(consumed + i), chunk[i]);
+    consumed += popped;
+    if (popped == 0)
+      base::PlatformThread::YieldCurrentThread();
+  }
+
+  base::PlatformThread::Join(thread);
+  EXPECT_EQ(0u, ring.GetAvailable());
+}
+
+}  // namespace media
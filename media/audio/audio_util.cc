@@ -20,12 +20,14 @@
 #include "base/logging.h"
 #include "base/shared_memory.h"
 #include "base/time.h"
+#include "build/build_config.h"
 #if defined(OS_WIN)
 #include "base/win/windows_version.h"
 #include "media/audio/audio_manager_base.h"
 #endif
 #include "media/audio/audio_parameters.h"
 #include "media/audio/audio_util.h"
+#include "media/base/cpu_features.h"
 #if defined(OS_MACOSX)
 #include "media/audio/mac/audio_low_latency_input_mac.h"
 #include "media/audio/mac/audio_low_latency_output_mac.h"
@@ -35,6 +37,14 @@
 #include "media/audio/win/audio_low_latency_output_win.h"
 #endif
 
+#if defined(ARCH_CPU_X86_FAMILY)
+#if defined(COMPILER_MSVC)
+#include <intrin.h>
+#else
+#include <emmintrin.h>
+#endif
+#endif
+
 using base::subtle::Atomic32;
 
 const uint32 kUnknownDataSize = static_cast<uint32>(-1);
@@ -57,6 +67,37 @@ static void AdjustVolume(Format* buf_out,
   }
 }
 
+#if defined(ARCH_CPU_X86_FAMILY)
+// Scales eight signed 16 bit samples by a 16.16 fixed point volume, matching
+// ScaleChannel() bit for bit: the unsigned high product is corrected for
+// negative samples so the result equals an arithmetic shift of the full
+// 32 bit product.  |volume| lanes must hold a value below 65536; both
+// AdjustVolume() and MixStreams() guarantee that since a volume of exactly
+// 1.0 never reaches the scaling path.
+static inline __m128i ScaleSamples_SSE2(__m128i samples, __m128i volume) {
+  __m128i correction = _mm_and_si128(_mm_srai_epi16(samples, 15), volume);
+  return _mm_sub_epi16(_mm_mulhi_epu16(samples, volume), correction);
+}
+
+// Vectorized volume scale for the most common sample format.  Processes
+// eight samples per iteration and hands the remainder to the scalar
+// template.
+static void AdjustVolume_SSE2(int16* buf_out,
+                              int sample_count,
+                              int fixed_volume) {
+  __m128i volume = _mm_set1_epi16(static_cast<int16>(fixed_volume));
+  while (sample_count >= 8) {
+    __m128i samples =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf_out));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(buf_out),
+                     ScaleSamples_SSE2(samples, volume));
+    buf_out += 8;
+    sample_count -= 8;
+  }
+  AdjustVolume<int16, int32, 0>(buf_out, sample_count, fixed_volume);
+}
+#endif
+
 static const int kChannel_L = 0;
 static const int kChannel_R = 1;
 static const int kChannel_C = 2;
@@ -131,6 +172,14 @@ bool AdjustVolume(void* buf,
                                       fixed_volume);
       return true;
     } else if (bytes_per_sample == 2) {
+#if defined(ARCH_CPU_X86_FAMILY)
+      if (hasSSE2()) {
+        AdjustVolume_SSE2(reinterpret_cast<int16*>(buf),
+                          sample_count,
+                          fixed_volume);
+        return true;
+      }
+#endif
       AdjustVolume<int16, int32, 0>(reinterpret_cast<int16*>(buf),
                                     sample_count,
                                     fixed_volume);
@@ -181,6 +230,37 @@ bool FoldChannels(void* buf,
   return false;
 }
 
+#if defined(ARCH_CPU_X86_FAMILY)
+// Deinterleaves one channel of 16 bit stereo frames into normalized floats,
+// four frames at a time.  The conversion is exact, so results are identical
+// to the scalar loop, which also handles the remaining frames.
+static void DeinterleaveStereo16_SSE2(const int16* source,
+                                      float* destination,
+                                      int channel_index,
+                                      size_t number_of_frames) {
+  const float kScale = 1.0f / 32768.0f;
+  __m128 scale = _mm_set1_ps(kScale);
+  size_t vector_frames = number_of_frames & ~static_cast<size_t>(3);
+  for (size_t i = 0; i < vector_frames; i += 4) {
+    __m128i stereo =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 2));
+    // Sign extend the 16 bit samples of the requested channel to 32 bits.
+    __m128i samples;
+    if (channel_index == 0)
+      samples = _mm_srai_epi32(_mm_slli_epi32(stereo, 16), 16);
+    else
+      samples = _mm_srai_epi32(stereo, 16);
+    _mm_storeu_ps(destination + i,
+                  _mm_mul_ps(_mm_cvtepi32_ps(samples), scale));
+  }
+  const int16* source16 = source + vector_frames * 2 + channel_index;
+  for (size_t i = vector_frames; i < number_of_frames; ++i) {
+    destination[i] = kScale * *source16;
+    source16 += 2;
+  }
+}
+#endif
+
 bool DeinterleaveAudioChannel(void* source,
                               float* destination,
                               int channels,
@@ -201,6 +281,15 @@ bool DeinterleaveAudioChannel(void* source,
 
     case 2:
     {
+#if defined(ARCH_CPU_X86_FAMILY)
+      if (channels == 2 && hasSSE2()) {
+        DeinterleaveStereo16_SSE2(reinterpret_cast<int16*>(source),
+                                  destination,
+                                  channel_index,
+                                  number_of_frames);
+        return true;
+      }
+#endif
       int16* source16 = reinterpret_cast<int16*>(source) + channel_index;
       const float kScale = 1.0f / 32768.0f;
       for (unsigned i = 0; i < number_of_frames; ++i) {
@@ -258,6 +347,42 @@ static void InterleaveFloatToInt(const std::vector<float*>& source,
   }
 }
 
+#if defined(ARCH_CPU_X86_FAMILY)
+// Interleaves two float channels into clamped 16 bit stereo frames, four
+// frames at a time.  _mm_cvttps_epi32() truncates and _mm_packs_epi32()
+// saturates exactly like the scalar template, which handles the remaining
+// frames.
+static void InterleaveStereoFloatToInt16_SSE2(
+    const std::vector<float*>& source,
+    int16* destination,
+    size_t number_of_frames) {
+  const float* left = source[0];
+  const float* right = source[1];
+  __m128 max_value = _mm_set1_ps(32767.0f);
+  size_t vector_frames = number_of_frames & ~static_cast<size_t>(3);
+  for (size_t i = 0; i < vector_frames; i += 4) {
+    __m128i left_samples =
+        _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(left + i), max_value));
+    __m128i right_samples =
+        _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(right + i), max_value));
+    __m128i frames_lo = _mm_unpacklo_epi32(left_samples, right_samples);
+    __m128i frames_hi = _mm_unpackhi_epi32(left_samples, right_samples);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 2),
+                     _mm_packs_epi32(frames_lo, frames_hi));
+  }
+  for (size_t i = vector_frames; i < number_of_frames; ++i) {
+    for (int channel = 0; channel < 2; ++channel) {
+      int32 sample = static_cast<int32>(32767.0f * source[channel][i]);
+      if (sample > 32767)
+        sample = 32767;
+      else if (sample < -32768)
+        sample = -32768;
+      destination[i * 2 + channel] = static_cast<int16>(sample);
+    }
+  }
+}
+#endif
+
 void InterleaveFloatToInt(const std::vector<float*>& source, void* dst,
                           size_t number_of_frames, int bytes_per_sample) {
   switch(bytes_per_sample) {
@@ -265,6 +390,13 @@ void InterleaveFloatToInt(const std::vector<float*>& source, void* dst,
       InterleaveFloatToInt<uint8, int32>(source, dst, number_of_frames);
       break;
     case 2:
+#if defined(ARCH_CPU_X86_FAMILY)
+      if (source.size() == 2 && hasSSE2()) {
+        InterleaveStereoFloatToInt16_SSE2(
+            source, reinterpret_cast<int16*>(dst), number_of_frames);
+        break;
+      }
+#endif
       InterleaveFloatToInt<int16, int32>(source, dst, number_of_frames);
       break;
     case 4:
@@ -275,10 +407,9 @@ void InterleaveFloatToInt(const std::vector<float*>& source, void* dst,
   }
 }
 
-// TODO(enal): use template specialization and size-specific intrinsics.
-//             Call is on the time-critical path, and by using SSE/AVX
-//             instructions we can speed things up by ~4-8x, more for the case
-//             when we have to adjust volume as well.
+// Scalar mix, also used for the leftover samples of the vectorized path.
+// The 16 bit case has an SSE2 implementation below; 8 and 32 bit samples
+// are rare enough that they always take this loop.
 template<class Format, class Fixed, int min_value, int max_value, int bias>
 static void MixStreams(Format* dst, Format* src, int count, float volume) {
   if (volume == 1.0f) {
@@ -300,6 +431,29 @@ static void MixStreams(Format* dst, Format* src, int count, float volume) {
   }
 }
 
+#if defined(ARCH_CPU_X86_FAMILY)
+// Vectorized mix for 16 bit samples, fusing the volume scale and the
+// saturated add into one pass over eight samples per iteration.  Results
+// are identical to the scalar template, which handles the remainder.
+static void MixStreams_SSE2(int16* dst, int16* src, int count, float volume) {
+  const int fixed_volume = static_cast<int>(volume * 65536);
+  const bool adjust_volume = volume != 1.0f;
+  __m128i volume_v = _mm_set1_epi16(static_cast<int16>(fixed_volume));
+  while (count >= 8) {
+    __m128i src_v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i dst_v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+    if (adjust_volume)
+      src_v = ScaleSamples_SSE2(src_v, volume_v);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_adds_epi16(dst_v, src_v));
+    src += 8;
+    dst += 8;
+    count -= 8;
+  }
+  MixStreams<int16, int32, -32768, 32767, 0>(dst, src, count, volume);
+}
+#endif
+
 void MixStreams(void* dst,
                 void* src,
                 size_t buflen,
@@ -318,6 +472,15 @@ void MixStreams(void* dst,
       break;
     case 2:
       DCHECK_EQ(0u, buflen % 2);
+#if defined(ARCH_CPU_X86_FAMILY)
+      if (hasSSE2()) {
+        MixStreams_SSE2(static_cast<int16*>(dst),
+                        static_cast<int16*>(src),
+                        buflen / 2,
+                        volume);
+        break;
+      }
+#endif
       MixStreams<int16, int32, -32768, 32767, 0>(static_cast<int16*>(dst),
                                                  static_cast<int16*>(src),
                                                  buflen / 2,
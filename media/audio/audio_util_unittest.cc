@@ -66,6 +66,20 @@ TEST(AudioUtilTest, AdjustVolume_s16_one) {
   EXPECT_EQ(0, expected_test);
 }
 
+TEST(AudioUtilTest, AdjustVolume_s16_long) {
+  // Use more samples than fit in one SIMD register plus a remainder so both
+  // the vectorized path and the scalar tail get exercised.
+  int16 samples_s16[11] = { -4, 7, -32768, 123, -1, 2, -3, 32767, 9, -9, 100 };
+  int16 expected_s16[11] = { -2, 3, -16384, 61, -1, 1, -2, 16383, 4, -5, 50 };
+  bool result_s16 = media::AdjustVolume(samples_s16, sizeof(samples_s16),
+                                        1,  // channels.
+                                        sizeof(samples_s16[0]),
+                                        0.5f);
+  EXPECT_TRUE(result_s16);
+  int expected_test = memcmp(samples_s16, expected_s16, sizeof(expected_s16));
+  EXPECT_EQ(0, expected_test);
+}
+
 TEST(AudioUtilTest, AdjustVolume_s32) {
   // Test AdjustVolume() on 32 bit samples.
   int32 samples_s32[kNumberOfSamples] = { -4, 0x40, -32768, 123 };
@@ -133,6 +147,24 @@ TEST(AudioUtilTest, MixStreams_s16_FullVolume) {
   EXPECT_EQ(0, expected_test);
 }
 
+TEST(AudioUtilTest, MixStreams_s16_long) {
+  // Use more samples than fit in one SIMD register plus a remainder so both
+  // the vectorized path and the scalar tail get exercised.
+  int16 dst_s16[12] = { 32000, -32000, 5, -5, 100, -100,
+                        32767, -32768, 7, 8, 9, 10 };
+  int16 src_s16[12] = { 1000, -1000, 5, -5, -50, 50,
+                        1, -1, 7, 8, 9, 10 };
+  int16 expected_s16[12] = { 32767, -32768, 10, -10, 50, -50,
+                             32767, -32768, 14, 16, 18, 20 };
+  media::MixStreams(dst_s16,
+                    src_s16,
+                    sizeof(dst_s16),
+                    sizeof(src_s16[0]),
+                    1.0f);
+  int expected_test = memcmp(dst_s16, expected_s16, sizeof(expected_s16));
+  EXPECT_EQ(0, expected_test);
+}
+
 TEST(AudioUtilTest, MixStreams_s32_QuarterVolume) {
   // Test MixStreams() on 32 bit samples.
   int32 dst_s32[kNumberOfSamples] = { -4, 0x40, -32768, 2147483640 };
@@ -205,6 +237,40 @@ TEST(AudioUtilTest, FoldChannels_s32) {
   EXPECT_EQ(0, expected_test);
 }
 
+TEST(AudioUtilTest, DeinterleaveAudioChannel_s16_Stereo) {
+  // Six frames: multiple of four plus a remainder, so both the vectorized
+  // path and the scalar tail get exercised.
+  int16 source[12] = { 1000, -1000, 2000, -2000, 3000, -3000,
+                       4000, -4000, 5000, -5000, 6000, -6000 };
+  const float kScale = 1.0f / 32768.0f;
+  float left[6];
+  float right[6];
+  EXPECT_TRUE(media::DeinterleaveAudioChannel(source, left, 2, 0,
+                                              sizeof(source[0]), 6));
+  EXPECT_TRUE(media::DeinterleaveAudioChannel(source, right, 2, 1,
+                                              sizeof(source[0]), 6));
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(kScale * source[i * 2], left[i]);
+    EXPECT_EQ(kScale * source[i * 2 + 1], right[i]);
+  }
+}
+
+TEST(AudioUtilTest, InterleaveFloatToInt_s16_Stereo) {
+  // Six frames: multiple of four plus a remainder, so both the vectorized
+  // path and the scalar tail get exercised.  Includes values that clamp.
+  float left[6] = { -1.5f, -1.0f, -0.5f, 0.0f, 0.5f, 1.0f };
+  float right[6] = { 1.5f, 1.0f, 0.25f, -0.25f, -1.0f, -1.5f };
+  std::vector<float*> source;
+  source.push_back(left);
+  source.push_back(right);
+  int16 interleaved[12];
+  media::InterleaveFloatToInt(source, interleaved, 6, sizeof(interleaved[0]));
+  int16 expected[12] = { -32768, 32767, -32767, 32767, -16383, 8191,
+                         0, -8191, 16383, -32767, 32767, -32768 };
+  int expected_test = memcmp(interleaved, expected, sizeof(expected));
+  EXPECT_EQ(0, expected_test);
+}
+
 // Fold 7.1
 TEST(AudioUtilTest, FoldChannels71_s16) {
   // Test FoldChannels() on 16 bit samples.
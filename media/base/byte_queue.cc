@@ -72,11 +72,11 @@ void ByteQueue::Pop(int count) {
   offset_ += count;
   used_ -= count;
 
-  // Move the offset back to 0 if we have reached the end of the buffer.
-  if (offset_ == size_) {
-    DCHECK_EQ(used_, 0);
+  // Move the offset back to 0 once the queue drains so the free space stays
+  // contiguous and later Push() calls don't have to memmove() the contents
+  // or grow the buffer just to reclaim the dead space at the front.
+  if (used_ == 0)
     offset_ = 0;
-  }
 }
 
 uint8* ByteQueue::front() const { return buffer_.get() + offset_; }
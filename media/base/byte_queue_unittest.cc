@@ -0,0 +1,94 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/byte_queue.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+static void VerifyQueueContents(const ByteQueue& queue,
+                                const uint8* expected, int expected_size) {
+  const uint8* data = NULL;
+  int size = 0;
+  queue.Peek(&data, &size);
+  ASSERT_EQ(expected_size, size);
+  EXPECT_EQ(0, memcmp(expected, data, size));
+}
+
+TEST(ByteQueueTest, PushPeekPop) {
+  ByteQueue queue;
+  const uint8 kData[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+  queue.Push(kData, 4);
+  queue.Push(kData + 4, 4);
+  VerifyQueueContents(queue, kData, 8);
+
+  queue.Pop(3);
+  VerifyQueueContents(queue, kData + 3, 5);
+
+  queue.Pop(5);
+  const uint8* data = NULL;
+  int size = 0;
+  queue.Peek(&data, &size);
+  EXPECT_EQ(0, size);
+}
+
+TEST(ByteQueueTest, GrowsBeyondInitialSize) {
+  ByteQueue queue;
+
+  // Push substantially more data than the initial buffer size and verify
+  // that ordering survives the reallocations.
+  const int kChunkSize = 77;
+  const int kChunks = 100;
+  uint8 chunk[kChunkSize];
+  for (int i = 0; i < kChunks; ++i) {
+    for (int j = 0; j < kChunkSize; ++j)
+      chunk[j] = static_cast<uint8>(i * kChunkSize + j);
+    queue.Push(chunk, kChunkSize);
+  }
+
+  const uint8* data = NULL;
+  int size = 0;
+  queue.Peek(&data, &size);
+  ASSERT_EQ(kChunks * kChunkSize, size);
+  for (int i = 0; i < size; ++i)
+    ASSERT_EQ(static_cast<uint8>(i), data[i]);
+}
+
+TEST(ByteQueueTest, InterleavedPushPop) {
+  ByteQueue queue;
+
+  // Stream data through the queue with a consumer that nearly keeps up, so
+  // reads and writes repeatedly cross the end of the underlying buffer.
+  const int kPushSize = 1000;
+  const int kPopSize = 990;
+  uint8 chunk[kPushSize];
+  int pushed = 0;
+  int popped = 0;
+  for (int i = 0; i < 100; ++i) {
+    for (int j = 0; j < kPushSize; ++j)
+      chunk[j] = static_cast<uint8>(pushed + j);
+    queue.Push(chunk, kPushSize);
+    pushed += kPushSize;
+
+    const uint8* data = NULL;
+    int size = 0;
+    queue.Peek(&data, &size);
+    ASSERT_GE(size, kPopSize);
+    for (int j = 0; j < kPopSize; ++j)
+      ASSERT_EQ(static_cast<uint8>(popped + j), data[j]);
+    queue.Pop(kPopSize);
+    popped += kPopSize;
+  }
+  EXPECT_EQ(pushed - popped, 100 * (kPushSize - kPopSize));
+
+  queue.Reset();
+  const uint8* data = NULL;
+  int size = 0;
+  queue.Peek(&data, &size);
+  EXPECT_EQ(0, size);
+}
+
+}  // namespace media
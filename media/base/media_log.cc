@@ -69,14 +69,8 @@ const char* MediaLog::PipelineStateToString(Pipeline::State state) {
       return "created";
     case Pipeline::kInitDemuxer:
       return "initDemuxer";
-    case Pipeline::kInitAudioDecoder:
-      return "initAudioDecoder";
-    case Pipeline::kInitAudioRenderer:
-      return "initAudioRenderer";
-    case Pipeline::kInitVideoDecoder:
-      return "initVideoDecoder";
-    case Pipeline::kInitVideoRenderer:
-      return "initVideoRenderer";
+    case Pipeline::kInitFilters:
+      return "initFilters";
     case Pipeline::kPausing:
       return "pausing";
     case Pipeline::kSeeking:
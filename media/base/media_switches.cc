@@ -23,6 +23,10 @@ const char kUseCras[] = "use-cras";
 const char kUsePulseAudio[] = "use-pulseaudio";
 #endif
 
+// Set number of seconds of media the demuxer buffers ahead of the current
+// read position for each stream.  Zero disables readahead.
+const char kDemuxerReadahead[] = "demuxer-readahead";
+
 // Set number of threads to use for video decoding.
 const char kVideoThreads[] = "video-threads";
 
@@ -25,6 +25,8 @@ extern const char kUseCras[];
 MEDIA_EXPORT extern const char kUsePulseAudio[];
 #endif
 
+MEDIA_EXPORT extern const char kDemuxerReadahead[];
+
 MEDIA_EXPORT extern const char kVideoThreads[];
 
 MEDIA_EXPORT extern const char kEnableAudioMixer[];
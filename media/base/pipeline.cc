@@ -59,9 +59,23 @@ media::PipelineStatus PipelineStatusNotification::status() {
 }
 
 struct Pipeline::PipelineInitState {
+  PipelineInitState()
+      : audio_decoder_initialized(false),
+        video_decoder_initialized(false),
+        pending_chains(0) {
+  }
+
   scoped_refptr<AudioDecoder> audio_decoder;
   scoped_refptr<VideoDecoder> video_decoder;
   scoped_refptr<CompositeFilter> composite;
+
+  // True once the corresponding decoder has finished initializing and its
+  // renderer has been kicked off.
+  bool audio_decoder_initialized;
+  bool video_decoder_initialized;
+
+  // Number of filter chains (audio, video) still initializing.
+  int pending_chains;
 };
 
 Pipeline::Pipeline(MessageLoop* message_loop, MediaLog* media_log)
@@ -558,6 +572,18 @@ void Pipeline::OnFilterInitialize(PipelineStatus status) {
       &Pipeline::InitializeTask, this, status));
 }
 
+// Called from any thread.
+void Pipeline::OnAudioChainInitialize(PipelineStatus status) {
+  message_loop_->PostTask(FROM_HERE, base::Bind(
+      &Pipeline::InitializeAudioChainTask, this, status));
+}
+
+// Called from any thread.
+void Pipeline::OnVideoChainInitialize(PipelineStatus status) {
+  message_loop_->PostTask(FROM_HERE, base::Bind(
+      &Pipeline::InitializeVideoChainTask, this, status));
+}
+
 // Called from any thread.
 void Pipeline::OnFilterStateTransition() {
   message_loop_->PostTask(FROM_HERE, base::Bind(
@@ -614,117 +640,149 @@ void Pipeline::StartTask(scoped_ptr<FilterCollection> filter_collection,
   InitializeDemuxer();
 }
 
-// Main initialization method called on the pipeline thread.  This code attempts
-// to use the specified filter factory to build a pipeline.
-// Initialization step performed in this method depends on current state of this
-// object, indicated by |state_|.  After each step of initialization, this
-// object transits to the next stage.  It starts by creating a Demuxer, and then
-// connects the Demuxer's audio stream to an AudioDecoder which is then
-// connected to an AudioRenderer.  If the media has video, then it connects a
-// VideoDecoder to the Demuxer's video stream, and then connects the
-// VideoDecoder to a VideoRenderer.
-//
-// When all required filters have been created and have called their
-// FilterHost's InitializationComplete() method, the pipeline will update its
-// state to kStarted and |init_cb_|, will be executed.
-//
-// TODO(hclam): InitializeTask() is now starting the pipeline asynchronously. It
-// works like a big state change table. If we no longer need to start filters
-// in order, we need to get rid of all the state change.
+// Called on the pipeline thread when the demuxer has finished initializing.
+// Once the demuxer is available we know which streams exist, so the audio
+// chain (decoder then renderer) and the video chain are kicked off here and
+// initialize concurrently; within each chain the renderer still waits for its
+// decoder.  When the last outstanding chain completes,
+// FinishFilterInitialization() finishes bringing up the pipeline.
 void Pipeline::InitializeTask(PipelineStatus last_stage_status) {
   DCHECK(message_loop_->BelongsToCurrentThread());
 
-  if (last_stage_status != PIPELINE_OK) {
-    // Currently only VideoDecoders have a recoverable error code.
-    if (state_ == kInitVideoDecoder &&
-        last_stage_status == DECODER_ERROR_NOT_SUPPORTED) {
-      state_ = kInitAudioRenderer;
-    } else {
-      SetError(last_stage_status);
-    }
-  }
+  if (last_stage_status != PIPELINE_OK)
+    SetError(last_stage_status);
 
   // If we have received the stop or error signal, return immediately.
   if (IsPipelineStopPending() || IsPipelineStopped() || !IsPipelineOk())
     return;
 
-  DCHECK(state_ == kInitDemuxer ||
-         state_ == kInitAudioDecoder ||
-         state_ == kInitAudioRenderer ||
-         state_ == kInitVideoDecoder ||
-         state_ == kInitVideoRenderer);
-
-  // Demuxer created, create audio decoder.
-  if (state_ == kInitDemuxer) {
-    SetState(kInitAudioDecoder);
-    // If this method returns false, then there's no audio stream.
-    if (InitializeAudioDecoder(demuxer_))
-      return;
+  DCHECK_EQ(kInitDemuxer, state_);
+  SetState(kInitFilters);
+
+  // Each of these methods returns false when the corresponding stream does
+  // not exist, in which case the chain never starts.
+  int started_chains = 0;
+  if (InitializeAudioDecoder(demuxer_))
+    ++started_chains;
+  if (InitializeVideoDecoder(demuxer_))
+    ++started_chains;
+  pipeline_init_state_->pending_chains = started_chains;
+
+  if (!started_chains)
+    FinishFilterInitialization();
+}
+
+void Pipeline::InitializeAudioChainTask(PipelineStatus last_stage_status) {
+  DCHECK(message_loop_->BelongsToCurrentThread());
+
+  if (last_stage_status != PIPELINE_OK) {
+    SetError(last_stage_status);
+    return;
   }
 
-  // Assuming audio decoder was created, create audio renderer.
-  if (state_ == kInitAudioDecoder) {
-    SetState(kInitAudioRenderer);
+  // If we have received the stop or error signal, return immediately.
+  if (IsPipelineStopPending() || IsPipelineStopped() || !IsPipelineOk())
+    return;
+
+  DCHECK_EQ(kInitFilters, state_);
 
-    // Returns false if there's no audio stream.
+  // Audio decoder created, create audio renderer.
+  if (!pipeline_init_state_->audio_decoder_initialized) {
+    pipeline_init_state_->audio_decoder_initialized = true;
     if (InitializeAudioRenderer(pipeline_init_state_->audio_decoder)) {
       base::AutoLock auto_lock(lock_);
       has_audio_ = true;
       return;
     }
+    // The renderer was missing; InitializeAudioRenderer() reported the error.
+    return;
   }
 
-  // Assuming audio renderer was created, create video decoder.
-  if (state_ == kInitAudioRenderer) {
-    // Then perform the stage of initialization, i.e. initialize video decoder.
-    SetState(kInitVideoDecoder);
-    if (InitializeVideoDecoder(demuxer_))
+  // Audio renderer created, the chain is complete.
+  OnFilterChainInitialized();
+}
+
+void Pipeline::InitializeVideoChainTask(PipelineStatus last_stage_status) {
+  DCHECK(message_loop_->BelongsToCurrentThread());
+
+  if (last_stage_status != PIPELINE_OK) {
+    // A video decoder may report that it cannot handle the stream, in which
+    // case we fall back to the next video decoder in the collection, if any.
+    if (!pipeline_init_state_->video_decoder_initialized &&
+        last_stage_status == DECODER_ERROR_NOT_SUPPORTED) {
+      InitializeVideoDecoder(demuxer_);
       return;
+    }
+    SetError(last_stage_status);
+    return;
   }
 
-  // Assuming video decoder was created, create video renderer.
-  if (state_ == kInitVideoDecoder) {
-    SetState(kInitVideoRenderer);
+  // If we have received the stop or error signal, return immediately.
+  if (IsPipelineStopPending() || IsPipelineStopped() || !IsPipelineOk())
+    return;
+
+  DCHECK_EQ(kInitFilters, state_);
+
+  // Video decoder created, create video renderer.
+  if (!pipeline_init_state_->video_decoder_initialized) {
+    pipeline_init_state_->video_decoder_initialized = true;
     if (InitializeVideoRenderer(pipeline_init_state_->video_decoder)) {
       base::AutoLock auto_lock(lock_);
       has_video_ = true;
       return;
     }
+    // The renderer was missing; InitializeVideoRenderer() reported the error.
+    return;
   }
 
-  if (state_ == kInitVideoRenderer) {
-    if (!IsPipelineOk() || !(HasAudio() || HasVideo())) {
-      SetError(PIPELINE_ERROR_COULD_NOT_RENDER);
-      return;
-    }
+  // Video renderer created, the chain is complete.
+  OnFilterChainInitialized();
+}
 
-    // Clear the collection of filters.
-    filter_collection_->Clear();
+void Pipeline::OnFilterChainInitialized() {
+  DCHECK(message_loop_->BelongsToCurrentThread());
+  DCHECK_GT(pipeline_init_state_->pending_chains, 0);
 
-    pipeline_filter_ = pipeline_init_state_->composite;
+  if (--pipeline_init_state_->pending_chains == 0)
+    FinishFilterInitialization();
+}
 
-    // Clear init state since we're done initializing.
-    pipeline_init_state_.reset();
+void Pipeline::FinishFilterInitialization() {
+  DCHECK(message_loop_->BelongsToCurrentThread());
+  DCHECK_EQ(kInitFilters, state_);
+  DCHECK_EQ(0, pipeline_init_state_->pending_chains);
 
-    if (audio_disabled_) {
-      // Audio was disabled at some point during initialization. Notify
-      // the pipeline filter now that it has been initialized.
-      demuxer_->OnAudioRendererDisabled();
-      pipeline_filter_->OnAudioRendererDisabled();
-    }
+  if (!IsPipelineOk() || !(HasAudio() || HasVideo())) {
+    SetError(PIPELINE_ERROR_COULD_NOT_RENDER);
+    return;
+  }
 
-    // Initialization was successful, we are now considered paused, so it's safe
-    // to set the initial playback rate and volume.
-    PlaybackRateChangedTask(GetPlaybackRate());
-    VolumeChangedTask(GetVolume());
-
-    // Fire a seek request to get the renderers to preroll. We don't need to
-    // tell the demuxer to seek since it should already be at the start.
-    seek_pending_ = true;
-    SetState(kSeeking);
-    seek_timestamp_ = demuxer_->GetStartTime();
-    OnDemuxerSeekDone(seek_timestamp_, PIPELINE_OK);
+  // Clear the collection of filters.
+  filter_collection_->Clear();
+
+  pipeline_filter_ = pipeline_init_state_->composite;
+
+  // Clear init state since we're done initializing.
+  pipeline_init_state_.reset();
+
+  if (audio_disabled_) {
+    // Audio was disabled at some point during initialization. Notify
+    // the pipeline filter now that it has been initialized.
+    demuxer_->OnAudioRendererDisabled();
+    pipeline_filter_->OnAudioRendererDisabled();
   }
+
+  // Initialization was successful, we are now considered paused, so it's safe
+  // to set the initial playback rate and volume.
+  PlaybackRateChangedTask(GetPlaybackRate());
+  VolumeChangedTask(GetVolume());
+
+  // Fire a seek request to get the renderers to preroll. We don't need to
+  // tell the demuxer to seek since it should already be at the start.
+  seek_pending_ = true;
+  SetState(kSeeking);
+  seek_timestamp_ = demuxer_->GetStartTime();
+  OnDemuxerSeekDone(seek_timestamp_, PIPELINE_OK);
 }
 
 // This method is called as a result of the client calling Pipeline::Stop() or
@@ -1042,10 +1100,7 @@ void Pipeline::TeardownStateTransitionTask() {
     case kCreated:
     case kError:
     case kInitDemuxer:
-    case kInitAudioDecoder:
-    case kInitAudioRenderer:
-    case kInitVideoDecoder:
-    case kInitVideoRenderer:
+    case kInitFilters:
     case kSeeking:
     case kStarting:
     case kStopped:
@@ -1139,7 +1194,7 @@ bool Pipeline::InitializeAudioDecoder(
 
   pipeline_init_state_->audio_decoder->Initialize(
       stream,
-      base::Bind(&Pipeline::OnFilterInitialize, this),
+      base::Bind(&Pipeline::OnAudioChainInitialize, this),
       base::Bind(&Pipeline::OnUpdateStatistics, this));
   return true;
 }
@@ -1165,7 +1220,7 @@ bool Pipeline::InitializeVideoDecoder(
 
   pipeline_init_state_->video_decoder->Initialize(
       stream,
-      base::Bind(&Pipeline::OnFilterInitialize, this),
+      base::Bind(&Pipeline::OnVideoChainInitialize, this),
       base::Bind(&Pipeline::OnUpdateStatistics, this));
 
   video_decoder_ = pipeline_init_state_->video_decoder;
@@ -1190,7 +1245,7 @@ bool Pipeline::InitializeAudioRenderer(
 
   audio_renderer_->Initialize(
       decoder,
-      base::Bind(&Pipeline::OnFilterInitialize, this),
+      base::Bind(&Pipeline::OnAudioChainInitialize, this),
       base::Bind(&Pipeline::OnAudioUnderflow, this),
       base::Bind(&Pipeline::OnAudioTimeUpdate, this));
 
@@ -1215,7 +1270,7 @@ bool Pipeline::InitializeVideoRenderer(
 
   video_renderer_->Initialize(
       decoder,
-      base::Bind(&Pipeline::OnFilterInitialize, this),
+      base::Bind(&Pipeline::OnVideoChainInitialize, this),
       base::Bind(&Pipeline::OnUpdateStatistics, this),
       base::Bind(&Pipeline::OnVideoTimeUpdate, this));
   return true;
@@ -1243,10 +1298,7 @@ void Pipeline::TearDownPipeline() {
       break;
 
     case kInitDemuxer:
-    case kInitAudioDecoder:
-    case kInitAudioRenderer:
-    case kInitVideoDecoder:
-    case kInitVideoRenderer:
+    case kInitFilters:
       // Make it look like initialization was successful.
       pipeline_filter_ = pipeline_init_state_->composite;
       pipeline_init_state_.reset();
@@ -99,12 +99,13 @@ class MEDIA_EXPORT PipelineStatusNotification {
 //                                         [ Any State Other Than InitXXX ]
 
 //
-// Initialization is a series of state transitions from "Created" through each
-// filter initialization state.  When all filter initialization states have
-// completed, we are implicitly in a "Paused" state.  At that point we simulate
-// a Seek() to the beginning of the media to give filters a chance to preroll.
-// From then on the normal Seek() transitions are carried out and we start
-// playing the media.
+// Initialization transitions from "Created" to "InitDemuxer" and then to
+// "InitFilters", during which the audio chain (decoder then renderer) and the
+// video chain initialize in parallel since they are independent of each
+// other.  When both chains have completed, we are implicitly in a "Paused"
+// state.  At that point we simulate a Seek() to the beginning of the media to
+// give filters a chance to preroll.  From then on the normal Seek()
+// transitions are carried out and we start playing the media.
 //
 // If any error ever happens, this object will transition to the "Error" state
 // from any state. If Stop() is ever called, this object will transition to
@@ -256,10 +257,7 @@ class MEDIA_EXPORT Pipeline
   enum State {
     kCreated,
     kInitDemuxer,
-    kInitAudioDecoder,
-    kInitAudioRenderer,
-    kInitVideoDecoder,
-    kInitVideoRenderer,
+    kInitFilters,
     kPausing,
     kSeeking,
     kFlushing,
@@ -325,9 +323,14 @@ class MEDIA_EXPORT Pipeline
   virtual void NotifyEnded() OVERRIDE;
   virtual void DisableAudioRenderer() OVERRIDE;
 
-  // Callbacks executed by filters upon completing initialization.
+  // Callback executed by the demuxer upon completing initialization.
   void OnFilterInitialize(PipelineStatus status);
 
+  // Callbacks executed by filters in the audio/video chains upon completing a
+  // stage of initialization.  May be called from any thread.
+  void OnAudioChainInitialize(PipelineStatus status);
+  void OnVideoChainInitialize(PipelineStatus status);
+
   // Callback executed by filters upon completing Play(), Pause(), or Stop().
   void OnFilterStateTransition();
 
@@ -355,13 +358,27 @@ class MEDIA_EXPORT Pipeline
                  const NetworkEventCB& network_cb,
                  const PipelineStatusCB& start_cb);
 
-  // InitializeTask() performs initialization in multiple passes. It is executed
-  // as a result of calling Start() or InitializationComplete() that advances
-  // initialization to the next state. It works as a hub of state transition for
-  // initialization.  One stage communicates its status to the next through
-  // |last_stage_status|.
+  // InitializeTask() runs when the demuxer has finished initializing.  It
+  // records the demuxer's status through |last_stage_status| and kicks off the
+  // audio and video filter chains, which initialize concurrently.
   void InitializeTask(PipelineStatus last_stage_status);
 
+  // Advance the audio/video chain to its next initialization stage (decoder
+  // first, then renderer).  One stage communicates its status to the next
+  // through |last_stage_status|.
+  void InitializeAudioChainTask(PipelineStatus last_stage_status);
+  void InitializeVideoChainTask(PipelineStatus last_stage_status);
+
+  // Called on the pipeline thread when a filter chain has finished
+  // initializing.  When the last outstanding chain finishes,
+  // FinishFilterInitialization() runs.
+  void OnFilterChainInitialized();
+
+  // Completes initialization once every chain has finished: promotes the
+  // composite filter to |pipeline_filter_| and kicks off the initial preroll
+  // seek.
+  void FinishFilterInitialization();
+
   // Stops and destroys all filters, placing the pipeline in the kStopped state.
   void StopTask(const base::Closure& stop_cb);
 
@@ -60,10 +60,27 @@ scoped_refptr<VideoFrame> VideoFrame::WrapNativeTexture(
       new VideoFrame(NATIVE_TEXTURE, width, height, timestamp, duration));
   frame->texture_id_ = texture_id;
   frame->texture_target_ = texture_target;
-  frame->texture_no_longer_needed_ = no_longer_needed;
+  frame->no_longer_needed_cb_ = no_longer_needed;
   return frame;
 }
 
+// static
+scoped_refptr<VideoFrame> VideoFrame::WrapVideoFrame(
+    const scoped_refptr<VideoFrame>& frame,
+    base::TimeDelta timestamp,
+    base::TimeDelta duration,
+    const base::Closure& no_longer_needed) {
+  DCHECK(frame->format_ == RGB32 || frame->format_ == YV12 ||
+         frame->format_ == YV16);
+  scoped_refptr<VideoFrame> wrapped(new VideoFrame(
+      frame->format_, frame->width_, frame->height_, timestamp, duration));
+  memcpy(wrapped->strides_, frame->strides_, sizeof(wrapped->strides_));
+  memcpy(wrapped->data_, frame->data_, sizeof(wrapped->data_));
+  wrapped->owns_data_ = false;
+  wrapped->no_longer_needed_cb_ = no_longer_needed;
+  return wrapped;
+}
+
 // static
 scoped_refptr<VideoFrame> VideoFrame::CreateEmptyFrame() {
   return new VideoFrame(
@@ -141,6 +158,7 @@ VideoFrame::VideoFrame(VideoFrame::Format format,
     : format_(format),
       width_(width),
       height_(height),
+      owns_data_(true),
       texture_id_(0),
       texture_target_(0),
       timestamp_(timestamp),
@@ -150,15 +168,16 @@ VideoFrame::VideoFrame(VideoFrame::Format format,
 }
 
 VideoFrame::~VideoFrame() {
-  if (format_ == NATIVE_TEXTURE && !texture_no_longer_needed_.is_null()) {
-    texture_no_longer_needed_.Run();
-    texture_no_longer_needed_.Reset();
+  if (!no_longer_needed_cb_.is_null()) {
+    no_longer_needed_cb_.Run();
+    no_longer_needed_cb_.Reset();
   }
 
   // In multi-plane allocations, only a single block of memory is allocated
   // on the heap, and other |data| pointers point inside the same, single block
-  // so just delete index 0.
-  delete[] data_[0];
+  // so just delete index 0.  Wrapped frames do not own their plane data.
+  if (owns_data_)
+    delete[] data_[0];
 }
 
 bool VideoFrame::IsValidPlane(size_t plane) const {
@@ -64,6 +64,17 @@ class MEDIA_EXPORT VideoFrame : public base::RefCountedThreadSafe<VideoFrame> {
       base::TimeDelta duration,
       const base::Closure& no_longer_needed);
 
+  // Wraps |frame| in a new frame that shares the same plane data.  The
+  // wrapping frame carries its own timestamp and duration, and runs
+  // |no_longer_needed.Run()| when destroyed.  |frame| must be a system
+  // memory frame; callers keep it alive by binding a reference into
+  // |no_longer_needed|.  Used by VideoFramePool to recycle allocations.
+  static scoped_refptr<VideoFrame> WrapVideoFrame(
+      const scoped_refptr<VideoFrame>& frame,
+      base::TimeDelta timestamp,
+      base::TimeDelta duration,
+      const base::Closure& no_longer_needed);
+
   // Creates a frame with format equals to VideoFrame::EMPTY, width, height
   // timestamp and duration are all 0.
   static scoped_refptr<VideoFrame> CreateEmptyFrame();
@@ -151,10 +162,17 @@ class MEDIA_EXPORT VideoFrame : public base::RefCountedThreadSafe<VideoFrame> {
   // Array of data pointers to each plane.
   uint8* data_[kMaxPlanes];
 
+  // False for frames created by WrapVideoFrame(), which share plane data
+  // owned by another frame.
+  bool owns_data_;
+
   // Native texture ID, if this is a NATIVE_TEXTURE frame.
   uint32 texture_id_;
   uint32 texture_target_;
-  base::Closure texture_no_longer_needed_;
+
+  // Runs when this frame is destroyed.  Set for NATIVE_TEXTURE frames and
+  // frames created by WrapVideoFrame().
+  base::Closure no_longer_needed_cb_;
 
   base::TimeDelta timestamp_;
   base::TimeDelta duration_;
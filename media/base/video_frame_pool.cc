@@ -0,0 +1,127 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/video_frame_pool.h"
+
+#include <list>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/synchronization/lock.h"
+
+namespace media {
+
+// Outstanding frames hold a reference to the pool implementation, so the
+// recycling callback stays valid even if the VideoFramePool itself is
+// destroyed first.
+class VideoFramePool::PoolImpl
+    : public base::RefCountedThreadSafe<VideoFramePool::PoolImpl> {
+ public:
+  PoolImpl();
+
+  scoped_refptr<VideoFrame> CreateFrame(VideoFrame::Format format,
+                                        size_t width,
+                                        size_t height,
+                                        base::TimeDelta timestamp,
+                                        base::TimeDelta duration);
+
+  // Called by the owning VideoFramePool on destruction.  Frames released
+  // after shutdown are freed instead of recycled.
+  void Shutdown();
+
+  size_t GetPoolSize() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<VideoFramePool::PoolImpl>;
+  ~PoolImpl();
+
+  // Runs when a frame handed out by CreateFrame() is destroyed; returns the
+  // underlying allocation to the pool.
+  void FrameReleased(const scoped_refptr<VideoFrame>& frame);
+
+  mutable base::Lock lock_;
+  bool is_shutdown_;
+  std::list<scoped_refptr<VideoFrame> > frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(PoolImpl);
+};
+
+VideoFramePool::PoolImpl::PoolImpl() : is_shutdown_(false) {}
+
+VideoFramePool::PoolImpl::~PoolImpl() {
+  DCHECK(is_shutdown_);
+}
+
+scoped_refptr<VideoFrame> VideoFramePool::PoolImpl::CreateFrame(
+    VideoFrame::Format format,
+    size_t width,
+    size_t height,
+    base::TimeDelta timestamp,
+    base::TimeDelta duration) {
+  scoped_refptr<VideoFrame> frame;
+  {
+    base::AutoLock auto_lock(lock_);
+    DCHECK(!is_shutdown_);
+    // Discard mismatched allocations so the pool drains naturally after a
+    // format or size change.
+    while (!frame && !frames_.empty()) {
+      scoped_refptr<VideoFrame> candidate = frames_.front();
+      frames_.pop_front();
+      if (candidate->format() == format &&
+          candidate->width() == width &&
+          candidate->height() == height) {
+        frame = candidate;
+      }
+    }
+  }
+
+  if (!frame)
+    frame = VideoFrame::CreateFrame(format, width, height, timestamp, duration);
+
+  // The bound reference to |frame| keeps the allocation alive until the
+  // wrapping frame is destroyed and FrameReleased() recycles it.
+  return VideoFrame::WrapVideoFrame(
+      frame, timestamp, duration,
+      base::Bind(&VideoFramePool::PoolImpl::FrameReleased, this, frame));
+}
+
+void VideoFramePool::PoolImpl::Shutdown() {
+  base::AutoLock auto_lock(lock_);
+  is_shutdown_ = true;
+  frames_.clear();
+}
+
+size_t VideoFramePool::PoolImpl::GetPoolSize() const {
+  base::AutoLock auto_lock(lock_);
+  return frames_.size();
+}
+
+void VideoFramePool::PoolImpl::FrameReleased(
+    const scoped_refptr<VideoFrame>& frame) {
+  base::AutoLock auto_lock(lock_);
+  if (is_shutdown_)
+    return;
+  frames_.push_back(frame);
+}
+
+VideoFramePool::VideoFramePool() : pool_(new PoolImpl()) {}
+
+VideoFramePool::~VideoFramePool() {
+  pool_->Shutdown();
+}
+
+scoped_refptr<VideoFrame> VideoFramePool::CreateFrame(
+    VideoFrame::Format format,
+    size_t width,
+    size_t height,
+    base::TimeDelta timestamp,
+    base::TimeDelta duration) {
+  return pool_->CreateFrame(format, width, height, timestamp, duration);
+}
+
+size_t VideoFramePool::GetPoolSizeForTesting() const {
+  return pool_->GetPoolSize();
+}
+
+}  // namespace media
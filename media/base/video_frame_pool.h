@@ -0,0 +1,55 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MEDIA_BASE_VIDEO_FRAME_POOL_H_
+#define MEDIA_BASE_VIDEO_FRAME_POOL_H_
+
+#include "base/memory/ref_counted.h"
+#include "media/base/media_export.h"
+#include "media/base/video_frame.h"
+
+namespace media {
+
+// A pool of recycled VideoFrame allocations.  Decoders allocate a frame for
+// every decoded picture and release it a few frames later when the renderer
+// is done with it; at HD resolutions and full frame rates that churns
+// hundreds of megabytes per second through the allocator.  The pool hands
+// out frames backed by previously released allocations of the same format
+// and dimensions, falling back to a fresh allocation when none is available.
+//
+// Frames are returned to the pool automatically through the normal
+// scoped_refptr lifetime: CreateFrame() wraps the pooled allocation in a
+// frame whose destruction recycles the memory.  Like
+// VideoFrame::CreateFrame(), frame memory is not cleared; callers that do
+// not overwrite every pixel must clear it themselves.
+//
+// The pool is thread-safe and may outlive, or be outlived by, the frames it
+// created.
+class MEDIA_EXPORT VideoFramePool {
+ public:
+  VideoFramePool();
+  ~VideoFramePool();
+
+  // Returns a frame of the given format and dimensions, recycling a
+  // previously released allocation when one matches.  Pooled allocations
+  // with a stale format or size are dropped.
+  scoped_refptr<VideoFrame> CreateFrame(VideoFrame::Format format,
+                                        size_t width,
+                                        size_t height,
+                                        base::TimeDelta timestamp,
+                                        base::TimeDelta duration);
+
+  // Returns the number of recycled allocations currently held by the pool.
+  size_t GetPoolSizeForTesting() const;
+
+ private:
+  class PoolImpl;
+  scoped_refptr<PoolImpl> pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(VideoFramePool);
+};
+
+}  // namespace media
+
+#endif  // MEDIA_BASE_VIDEO_FRAME_POOL_H_
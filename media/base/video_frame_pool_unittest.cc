@@ -0,0 +1,63 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/video_frame_pool.h"
+
+#include "media/base/buffers.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+static const size_t kWidth = 320;
+static const size_t kHeight = 240;
+
+TEST(VideoFramePoolTest, FrameReuse) {
+  VideoFramePool pool;
+
+  scoped_refptr<VideoFrame> frame = pool.CreateFrame(
+      VideoFrame::YV12, kWidth, kHeight, kNoTimestamp(), kNoTimestamp());
+  const uint8* y_data = frame->data(VideoFrame::kYPlane);
+
+  // Releasing the only reference returns the allocation to the pool, and
+  // the next request of the same geometry reuses it.
+  frame = NULL;
+  EXPECT_EQ(1u, pool.GetPoolSizeForTesting());
+
+  frame = pool.CreateFrame(
+      VideoFrame::YV12, kWidth, kHeight, kNoTimestamp(), kNoTimestamp());
+  EXPECT_EQ(y_data, frame->data(VideoFrame::kYPlane));
+  EXPECT_EQ(0u, pool.GetPoolSizeForTesting());
+}
+
+TEST(VideoFramePoolTest, MismatchedFramesAreDropped) {
+  VideoFramePool pool;
+
+  pool.CreateFrame(VideoFrame::YV12, kWidth, kHeight,
+                   kNoTimestamp(), kNoTimestamp());
+  EXPECT_EQ(1u, pool.GetPoolSizeForTesting());
+
+  // A request with different dimensions cannot reuse the pooled allocation,
+  // which gets dropped rather than hoarded.
+  scoped_refptr<VideoFrame> frame = pool.CreateFrame(
+      VideoFrame::YV12, 2 * kWidth, 2 * kHeight,
+      kNoTimestamp(), kNoTimestamp());
+  EXPECT_EQ(0u, pool.GetPoolSizeForTesting());
+  EXPECT_EQ(2 * kWidth, frame->width());
+  EXPECT_EQ(2 * kHeight, frame->height());
+}
+
+TEST(VideoFramePoolTest, FrameOutlivesPool) {
+  scoped_refptr<VideoFrame> frame;
+  {
+    VideoFramePool pool;
+    frame = pool.CreateFrame(VideoFrame::YV12, kWidth, kHeight,
+                             kNoTimestamp(), kNoTimestamp());
+  }
+
+  // The frame's memory must remain valid after the pool is gone.
+  memset(frame->data(VideoFrame::kYPlane), 0,
+         frame->stride(VideoFrame::kYPlane) * frame->rows(VideoFrame::kYPlane));
+}
+
+}  // namespace media
@@ -102,6 +102,7 @@ void AudioRendererAlgorithm::Initialize(
   AlignToFrameBoundary(&bytes_in_crossfade_);
 
   crossfade_buffer_.reset(new uint8[bytes_in_crossfade_]);
+  intro_frame_buffer_.reset(new uint8[bytes_per_frame_]);
 }
 
 int AudioRendererAlgorithm::FillBuffer(
@@ -117,21 +118,24 @@ int AudioRendererAlgorithm::FillBuffer(
     if (index_into_window_ == window_size_)
       ResetWindow();
 
-    bool rendered_frame = true;
+    int frames_rendered;
     if (playback_rate_ > 1.0)
-      rendered_frame = OutputFasterPlayback(output_ptr);
+      frames_rendered = OutputFasterPlayback(
+          output_ptr, requested_frames - total_frames_rendered);
     else if (playback_rate_ < 1.0)
-      rendered_frame = OutputSlowerPlayback(output_ptr);
+      frames_rendered = OutputSlowerPlayback(
+          output_ptr, requested_frames - total_frames_rendered);
     else
-      rendered_frame = OutputNormalPlayback(output_ptr);
+      frames_rendered = OutputNormalPlayback(
+          output_ptr, requested_frames - total_frames_rendered);
 
-    if (!rendered_frame) {
+    if (frames_rendered == 0) {
       needs_more_data_ = true;
       break;
     }
 
-    output_ptr += bytes_per_frame_;
-    total_frames_rendered++;
+    output_ptr += frames_rendered * bytes_per_frame_;
+    total_frames_rendered += frames_rendered;
   }
   return total_frames_rendered;
 }
@@ -142,12 +146,13 @@ void AudioRendererAlgorithm::ResetWindow() {
   crossfade_frame_number_ = 0;
 }
 
-bool AudioRendererAlgorithm::OutputFasterPlayback(uint8* dest) {
+int AudioRendererAlgorithm::OutputFasterPlayback(uint8* dest,
+                                                 int requested_frames) {
   DCHECK_LT(index_into_window_, window_size_);
   DCHECK_GT(playback_rate_, 1.0);
 
   if (audio_buffer_.forward_bytes() < bytes_per_frame_)
-    return false;
+    return 0;
 
   // The audio data is output in a series of windows. For sped-up playback,
   // the window is comprised of the following phases:
@@ -179,18 +184,24 @@ bool AudioRendererAlgorithm::OutputFasterPlayback(uint8* dest) {
   // which point the window restarts.
   int intro_crossfade_begin = input_step - bytes_to_crossfade;
 
-  // a) Output a raw frame if we haven't reached the crossfade section.
+  // a) Output raw frames in bulk if we haven't reached the crossfade section.
   if (index_into_window_ < outtro_crossfade_begin) {
-    CopyWithAdvance(dest);
-    index_into_window_ += bytes_per_frame_;
-    return true;
+    int frames = std::min(requested_frames,
+        (outtro_crossfade_begin - index_into_window_) / bytes_per_frame_);
+    frames = std::min(frames,
+                      audio_buffer_.forward_bytes() / bytes_per_frame_);
+    if (frames == 0)
+      return 0;
+    CopyBulkWithAdvance(dest, frames);
+    index_into_window_ += frames * bytes_per_frame_;
+    return frames;
   }
 
   // b) Save outtro crossfade frames into intermediate buffer, but do not output
   //    anything to |dest|.
   while (index_into_window_ < outtro_crossfade_end) {
     if (audio_buffer_.forward_bytes() < bytes_per_frame_)
-      return false;
+      return 0;
 
     // This phase only applies if there are bytes to crossfade.
     DCHECK_GT(bytes_to_crossfade, 0);
@@ -200,23 +211,29 @@ bool AudioRendererAlgorithm::OutputFasterPlayback(uint8* dest) {
     index_into_window_ += bytes_per_frame_;
   }
 
-  // c) Drop frames until we reach the intro crossfade section.
-  while (index_into_window_ < intro_crossfade_begin) {
-    if (audio_buffer_.forward_bytes() < bytes_per_frame_)
-      return false;
+  // c) Drop frames in bulk until we reach the intro crossfade section.
+  if (index_into_window_ < intro_crossfade_begin) {
+    int bytes_to_drop = std::min(intro_crossfade_begin - index_into_window_,
+                                 audio_buffer_.forward_bytes());
+    AlignToFrameBoundary(&bytes_to_drop);
+    if (bytes_to_drop > 0) {
+      DropBytes(bytes_to_drop);
+      index_into_window_ += bytes_to_drop;
+    }
 
-    DropFrame();
-    index_into_window_ += bytes_per_frame_;
+    // Return if we have run out of data before reaching the crossfade.
+    if (index_into_window_ < intro_crossfade_begin)
+      return 0;
   }
 
   // Return if we have run out of data after Phase c).
   if (audio_buffer_.forward_bytes() < bytes_per_frame_)
-    return false;
+    return 0;
 
   // Phase d) doesn't apply if there are no bytes to crossfade.
   if (bytes_to_crossfade == 0) {
     DCHECK_EQ(index_into_window_, window_size_);
-    return false;
+    return 0;
   }
 
   // d) Crossfade and output a frame.
@@ -224,20 +241,20 @@ bool AudioRendererAlgorithm::OutputFasterPlayback(uint8* dest) {
   int offset_into_buffer = index_into_window_ - intro_crossfade_begin;
   memcpy(dest, crossfade_buffer_.get() + offset_into_buffer,
          bytes_per_frame_);
-  scoped_array<uint8> intro_frame_ptr(new uint8[bytes_per_frame_]);
-  audio_buffer_.Read(intro_frame_ptr.get(), bytes_per_frame_);
-  OutputCrossfadedFrame(dest, intro_frame_ptr.get());
+  audio_buffer_.Read(intro_frame_buffer_.get(), bytes_per_frame_);
+  OutputCrossfadedFrame(dest, intro_frame_buffer_.get());
   index_into_window_ += bytes_per_frame_;
-  return true;
+  return 1;
 }
 
-bool AudioRendererAlgorithm::OutputSlowerPlayback(uint8* dest) {
+int AudioRendererAlgorithm::OutputSlowerPlayback(uint8* dest,
+                                                 int requested_frames) {
   DCHECK_LT(index_into_window_, window_size_);
   DCHECK_LT(playback_rate_, 1.0);
   DCHECK_NE(playback_rate_, 0.0);
 
   if (audio_buffer_.forward_bytes() < bytes_per_frame_)
-    return false;
+    return 0;
 
   // The audio data is output in a series of windows. For slowed down playback,
   // the window is comprised of the following phases:
@@ -272,11 +289,17 @@ bool AudioRendererAlgorithm::OutputSlowerPlayback(uint8* dest) {
   // which point the window restarts.
   int outtro_crossfade_begin = output_step - bytes_to_crossfade;
 
-  // a) Output a raw frame.
+  // a) Output raw frames in bulk.
   if (index_into_window_ < intro_crossfade_begin) {
-    CopyWithAdvance(dest);
-    index_into_window_ += bytes_per_frame_;
-    return true;
+    int frames = std::min(requested_frames,
+        (intro_crossfade_begin - index_into_window_) / bytes_per_frame_);
+    frames = std::min(frames,
+                      audio_buffer_.forward_bytes() / bytes_per_frame_);
+    if (frames == 0)
+      return 0;
+    CopyBulkWithAdvance(dest, frames);
+    index_into_window_ += frames * bytes_per_frame_;
+    return frames;
   }
 
   // b) Save the raw frame for the intro crossfade section, then output the
@@ -287,40 +310,55 @@ bool AudioRendererAlgorithm::OutputSlowerPlayback(uint8* dest) {
     CopyWithoutAdvance(place_to_copy);
     CopyWithAdvance(dest);
     index_into_window_ += bytes_per_frame_;
-    return true;
+    return 1;
   }
 
   int audio_buffer_offset = index_into_window_ - intro_crossfade_end;
 
   if (audio_buffer_.forward_bytes() < audio_buffer_offset + bytes_per_frame_)
-    return false;
+    return 0;
 
-  // c) Output a raw frame into |dest| without advancing the |audio_buffer_|
-  //    cursor. See function-level comment.
+  // c) Output raw frames into |dest| in bulk without advancing the
+  //    |audio_buffer_| cursor. See function-level comment.
   DCHECK_GE(index_into_window_, intro_crossfade_end);
-  CopyWithoutAdvance(dest, audio_buffer_offset);
-
-  // d) Crossfade the next frame of |crossfade_buffer_| into |dest| if we've
-  //    reached the outtro crossfade section of the window.
-  if (index_into_window_ >= outtro_crossfade_begin) {
-    int offset_into_crossfade_buffer =
-        index_into_window_ - outtro_crossfade_begin;
-    uint8* intro_frame_ptr =
-        crossfade_buffer_.get() + offset_into_crossfade_buffer;
-    OutputCrossfadedFrame(dest, intro_frame_ptr);
+  if (index_into_window_ < outtro_crossfade_begin) {
+    int frames = std::min(requested_frames,
+        (outtro_crossfade_begin - index_into_window_) / bytes_per_frame_);
+    frames = std::min(frames,
+        (audio_buffer_.forward_bytes() - audio_buffer_offset) /
+            bytes_per_frame_);
+    if (frames == 0)
+      return 0;
+    CopyBulkWithoutAdvance(dest, frames, audio_buffer_offset);
+    index_into_window_ += frames * bytes_per_frame_;
+    return frames;
   }
 
+  // d) Output a raw frame without advancing the |audio_buffer_| cursor and
+  //    crossfade the next frame of |crossfade_buffer_| into it.
+  CopyWithoutAdvance(dest, audio_buffer_offset);
+  int offset_into_crossfade_buffer =
+      index_into_window_ - outtro_crossfade_begin;
+  uint8* intro_frame_ptr =
+      crossfade_buffer_.get() + offset_into_crossfade_buffer;
+  OutputCrossfadedFrame(dest, intro_frame_ptr);
+
   index_into_window_ += bytes_per_frame_;
-  return true;
+  return 1;
 }
 
-bool AudioRendererAlgorithm::OutputNormalPlayback(uint8* dest) {
-  if (audio_buffer_.forward_bytes() >= bytes_per_frame_) {
-    CopyWithAdvance(dest);
-    index_into_window_ += bytes_per_frame_;
-    return true;
-  }
-  return false;
+int AudioRendererAlgorithm::OutputNormalPlayback(uint8* dest,
+                                                 int requested_frames) {
+  // Cap the copy at the end of the window so the window bookkeeping in
+  // FillBuffer() stays intact.
+  int frames = std::min(requested_frames,
+                        (window_size_ - index_into_window_) / bytes_per_frame_);
+  frames = std::min(frames, audio_buffer_.forward_bytes() / bytes_per_frame_);
+  if (frames == 0)
+    return 0;
+  CopyBulkWithAdvance(dest, frames);
+  index_into_window_ += frames * bytes_per_frame_;
+  return frames;
 }
 
 void AudioRendererAlgorithm::CopyWithAdvance(uint8* dest) {
@@ -343,7 +381,33 @@ void AudioRendererAlgorithm::CopyWithoutAdvance(
 }
 
 void AudioRendererAlgorithm::DropFrame() {
-  audio_buffer_.Seek(bytes_per_frame_);
+  DropBytes(bytes_per_frame_);
+}
+
+void AudioRendererAlgorithm::CopyBulkWithAdvance(uint8* dest, int frames) {
+  int bytes = frames * bytes_per_frame_;
+  if (muted_) {
+    memset(dest, 0, bytes);
+  } else {
+    int copied = audio_buffer_.Peek(dest, bytes);
+    DCHECK_EQ(bytes, copied);
+  }
+  DropBytes(bytes);
+}
+
+void AudioRendererAlgorithm::CopyBulkWithoutAdvance(
+    uint8* dest, int frames, int offset) {
+  int bytes = frames * bytes_per_frame_;
+  if (muted_) {
+    memset(dest, 0, bytes);
+    return;
+  }
+  int copied = audio_buffer_.Peek(dest, bytes, offset);
+  DCHECK_EQ(bytes, copied);
+}
+
+void AudioRendererAlgorithm::DropBytes(int bytes) {
+  audio_buffer_.Seek(bytes);
 
   if (!IsQueueFull())
     request_read_cb_.Run();
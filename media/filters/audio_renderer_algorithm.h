@@ -102,30 +102,35 @@ class MEDIA_EXPORT AudioRendererAlgorithm {
   // Returns true if |audio_buffer_| is empty.
   bool IsQueueEmpty();
 
-  // Fills |dest| with one frame of audio data at normal speed. Returns true if
-  // a frame was rendered, false otherwise.
-  bool OutputNormalPlayback(uint8* dest);
-
-  // Fills |dest| with one frame of audio data at faster than normal speed.
-  // Returns true if a frame was rendered, false otherwise.
+  // Fills |dest| with up to |requested_frames| frames of audio data at normal
+  // speed. Returns the number of frames rendered; zero means more data is
+  // needed.
+  int OutputNormalPlayback(uint8* dest, int requested_frames);
+
+  // Fills |dest| with up to |requested_frames| frames of audio data at faster
+  // than normal speed. Returns the number of frames rendered; zero means more
+  // data is needed or the end of the window was reached.
   //
   // When the audio playback is > 1.0, we use a variant of Overlap-Add to squish
   // audio output while preserving pitch. Essentially, we play a bit of audio
   // data at normal speed, then we "fast forward" by dropping the next bit of
   // audio data, and then we stich the pieces together by crossfading from one
-  // audio chunk to the next.
-  bool OutputFasterPlayback(uint8* dest);
+  // audio chunk to the next. The raw and dropped segments of the window are
+  // processed in bulk; only the crossfaded frames are rendered one at a time.
+  int OutputFasterPlayback(uint8* dest, int requested_frames);
 
-  // Fills |dest| with one frame of audio data at slower than normal speed.
-  // Returns true if a frame was rendered, false otherwise.
+  // Fills |dest| with up to |requested_frames| frames of audio data at slower
+  // than normal speed. Returns the number of frames rendered; zero means more
+  // data is needed.
   //
   // When the audio playback is < 1.0, we use a variant of Overlap-Add to
   // stretch audio output while preserving pitch. This works by outputting a
   // segment of audio data at normal speed. The next audio segment then starts
   // by repeating some of the audio data from the previous audio segment.
   // Segments are stiched together by crossfading from one audio chunk to the
-  // next.
-  bool OutputSlowerPlayback(uint8* dest);
+  // next. The raw segments of the window are processed in bulk; only the
+  // crossfaded frames are rendered one at a time.
+  int OutputSlowerPlayback(uint8* dest, int requested_frames);
 
   // Resets the window state to the start of a new window.
   void ResetWindow();
@@ -143,6 +148,20 @@ class MEDIA_EXPORT AudioRendererAlgorithm {
   // Moves the |audio_buffer_| forward by one frame.
   void DropFrame();
 
+  // Copies |frames| raw frames from |audio_buffer_| into |dest| and
+  // progresses the |audio_buffer_| forward, requesting a read afterwards if
+  // the queue is not full. The caller must ensure the frames are available.
+  void CopyBulkWithAdvance(uint8* dest, int frames);
+
+  // Copies |frames| raw frames from |audio_buffer_| into |dest| starting at
+  // forward byte |offset| without progressing |audio_buffer_|'s internal
+  // "current" cursor. The caller must ensure the frames are available.
+  void CopyBulkWithoutAdvance(uint8* dest, int frames, int offset);
+
+  // Moves the |audio_buffer_| forward by |bytes|, requesting a read
+  // afterwards if the queue is not full.
+  void DropBytes(int bytes);
+
   // Does a linear crossfade from |intro| into |outtro| for one frame.
   // Assumes pointers are valid and are at least size of |bytes_per_frame_|.
   void OutputCrossfadedFrame(uint8* outtro, const uint8* intro);
@@ -192,6 +211,10 @@ class MEDIA_EXPORT AudioRendererAlgorithm {
   // Temporary buffer to hold crossfade data.
   scoped_array<uint8> crossfade_buffer_;
 
+  // Temporary buffer holding the frame read from |audio_buffer_| while
+  // crossfading during sped-up playback.
+  scoped_array<uint8> intro_frame_buffer_;
+
   // Window size, in bytes (calculated from audio properties).
   int window_size_;
 
@@ -8,6 +8,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop.h"
 #include "base/stl_util.h"
+#include "base/string_number_conversions.h"
 #include "base/string_util.h"
 #include "base/time.h"
 #include "media/base/data_buffer.h"
@@ -21,6 +22,30 @@
 
 namespace media {
 
+// Duration of demuxed packets to buffer ahead of the readers for each stream
+// when --demuxer-readahead is not specified.
+static const int kDefaultReadaheadSeconds = 2;
+
+// Hard limit on the amount of encoded data buffered for a single stream.
+// This guards against demuxing unbounded amounts of a media file whose
+// timestamps are broken or missing.
+static const int kMaxBufferedBytes = 4 * 1024 * 1024;
+
+// Returns the duration of media each stream should keep demuxed ahead of its
+// readers, honoring the --demuxer-readahead switch when present.  A value of
+// zero disables readahead and reverts to demand-only demuxing.
+static base::TimeDelta GetMaxBufferedDuration() {
+  const CommandLine* cmd_line = CommandLine::ForCurrentProcess();
+  std::string readahead(
+      cmd_line->GetSwitchValueASCII(switches::kDemuxerReadahead));
+  int seconds = 0;
+  if (readahead.empty() || !base::StringToInt(readahead, &seconds) ||
+      seconds < 0) {
+    seconds = kDefaultReadaheadSeconds;
+  }
+  return base::TimeDelta::FromSeconds(seconds);
+}
+
 //
 // AVPacketBuffer
 //
@@ -60,7 +85,9 @@ FFmpegDemuxerStream::FFmpegDemuxerStream(FFmpegDemuxer* demuxer,
       stream_(stream),
       type_(UNKNOWN),
       discontinuous_(false),
-      stopped_(false) {
+      stopped_(false),
+      buffered_bytes_(0),
+      last_packet_timestamp_(kNoTimestamp()) {
   DCHECK(demuxer_);
 
   // Determine our media format.
@@ -104,6 +131,7 @@ void FFmpegDemuxerStream::EnqueuePacket(
       ConvertStreamTimestamp(stream_->time_base, packet->pts);
   base::TimeDelta duration =
       ConvertStreamTimestamp(stream_->time_base, packet->duration);
+  bool keyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
 
   base::AutoLock auto_lock(lock_);
   if (stopped_) {
@@ -124,7 +152,15 @@ void FFmpegDemuxerStream::EnqueuePacket(
     NOTREACHED() << "Unable to allocate AVPacketBuffer";
     return;
   }
-  buffer_queue_.push_back(buffer);
+  BufferedPacket buffered_packet;
+  buffered_packet.buffer = buffer;
+  buffered_packet.keyframe = keyframe;
+  buffer_queue_.push_back(buffered_packet);
+  if (!buffer->IsEndOfStream()) {
+    buffered_bytes_ += buffer->GetDataSize();
+    if (timestamp != kNoTimestamp())
+      last_packet_timestamp_ = timestamp;
+  }
   FulfillPendingRead();
   return;
 }
@@ -134,12 +170,86 @@ void FFmpegDemuxerStream::FlushBuffers() {
   base::AutoLock auto_lock(lock_);
   DCHECK(read_queue_.empty()) << "Read requests should be empty";
   buffer_queue_.clear();
+  buffered_bytes_ = 0;
+  last_packet_timestamp_ = kNoTimestamp();
+}
+
+bool FFmpegDemuxerStream::HasAvailableCapacity() {
+  DCHECK_EQ(MessageLoop::current(), demuxer_->message_loop());
+  base::AutoLock auto_lock(lock_);
+  if (stopped_ || buffered_bytes_ >= kMaxBufferedBytes)
+    return false;
+
+  // There is no point in demuxing past the end of the stream.
+  if (!buffer_queue_.empty() && buffer_queue_.back().buffer->IsEndOfStream())
+    return false;
+
+  if (buffer_queue_.empty() || last_packet_timestamp_ == kNoTimestamp())
+    return true;
+
+  base::TimeDelta front_timestamp =
+      buffer_queue_.front().buffer->GetTimestamp();
+  if (front_timestamp == kNoTimestamp())
+    return true;
+
+  return last_packet_timestamp_ - front_timestamp <
+      demuxer_->max_buffered_duration();
+}
+
+base::TimeDelta FFmpegDemuxerStream::FindBufferedSeekPoint(
+    base::TimeDelta timestamp) {
+  DCHECK_EQ(MessageLoop::current(), demuxer_->message_loop());
+  base::AutoLock auto_lock(lock_);
+  if (buffer_queue_.empty() || buffer_queue_.front().buffer->IsEndOfStream() ||
+      last_packet_timestamp_ == kNoTimestamp()) {
+    return kNoTimestamp();
+  }
+
+  base::TimeDelta front_timestamp =
+      buffer_queue_.front().buffer->GetTimestamp();
+  if (front_timestamp == kNoTimestamp() || front_timestamp > timestamp ||
+      last_packet_timestamp_ < timestamp) {
+    return kNoTimestamp();
+  }
+
+  // Audio packets can be decoded from any point, so the stream can resume
+  // exactly at |timestamp|.  Video must resume from a keyframe at or before
+  // |timestamp|.
+  if (type_ != VIDEO)
+    return timestamp;
+
+  base::TimeDelta seek_point = kNoTimestamp();
+  for (BufferQueue::const_iterator iter = buffer_queue_.begin();
+       iter != buffer_queue_.end(); ++iter) {
+    base::TimeDelta buffer_timestamp = iter->buffer->GetTimestamp();
+    if (buffer_timestamp == kNoTimestamp() || buffer_timestamp > timestamp)
+      break;
+    if (iter->keyframe)
+      seek_point = buffer_timestamp;
+  }
+  return seek_point;
+}
+
+void FFmpegDemuxerStream::DropBufferedPacketsBefore(
+    base::TimeDelta seek_point) {
+  DCHECK_EQ(MessageLoop::current(), demuxer_->message_loop());
+  base::AutoLock auto_lock(lock_);
+  DCHECK(read_queue_.empty()) << "Read requests should be empty";
+  while (!buffer_queue_.empty()) {
+    const scoped_refptr<Buffer>& buffer = buffer_queue_.front().buffer;
+    if (buffer->IsEndOfStream() || buffer->GetTimestamp() >= seek_point)
+      break;
+    buffered_bytes_ -= buffer->GetDataSize();
+    buffer_queue_.pop_front();
+  }
 }
 
 void FFmpegDemuxerStream::Stop() {
   DCHECK_EQ(MessageLoop::current(), demuxer_->message_loop());
   base::AutoLock auto_lock(lock_);
   buffer_queue_.clear();
+  buffered_bytes_ = 0;
+  last_packet_timestamp_ = kNoTimestamp();
   for (ReadQueue::iterator it = read_queue_.begin();
        it != read_queue_.end(); ++it) {
     it->Run(scoped_refptr<Buffer>(new DataBuffer(0)));
@@ -179,9 +289,14 @@ void FFmpegDemuxerStream::Read(const ReadCB& read_cb) {
   }
 
   // Send the oldest buffer back.
-  scoped_refptr<Buffer> buffer = buffer_queue_.front();
+  scoped_refptr<Buffer> buffer = buffer_queue_.front().buffer;
+  buffered_bytes_ -= buffer->GetDataSize();
   buffer_queue_.pop_front();
   read_cb.Run(buffer);
+
+  // Now that the queue has drained a bit, give the demuxer a chance to
+  // extend the readahead.
+  demuxer_->PostDemuxTask();
 }
 
 void FFmpegDemuxerStream::ReadTask(const ReadCB& read_cb) {
@@ -214,8 +329,9 @@ void FFmpegDemuxerStream::FulfillPendingRead() {
   }
 
   // Dequeue a buffer and pending read pair.
-  scoped_refptr<Buffer> buffer = buffer_queue_.front();
+  scoped_refptr<Buffer> buffer = buffer_queue_.front().buffer;
   ReadCB read_cb(read_queue_.front());
+  buffered_bytes_ -= buffer->GetDataSize();
   buffer_queue_.pop_front();
   read_queue_.pop_front();
 
@@ -288,6 +404,7 @@ FFmpegDemuxer::FFmpegDemuxer(
       last_read_bytes_(0),
       read_position_(0),
       bitrate_(0),
+      max_buffered_duration_(GetMaxBufferedDuration()),
       start_time_(kNoTimestamp()),
       audio_disabled_(false) {
   DCHECK(message_loop_);
@@ -429,6 +546,10 @@ MessageLoop* FFmpegDemuxer::message_loop() {
   return message_loop_;
 }
 
+base::TimeDelta FFmpegDemuxer::max_buffered_duration() const {
+  return max_buffered_duration_;
+}
+
 // Helper for calculating the bitrate of the media based on information stored
 // in |format_context| or failing that the size and duration of the media.
 //
@@ -575,6 +696,10 @@ void FFmpegDemuxer::InitializeTask(DemuxerHost* host,
   if (bitrate_ > 0)
     data_source_->SetBitrate(bitrate_);
 
+  // Begin buffering packets so that playback and the first seeks can be
+  // serviced without waiting on demand reads.
+  PostDemuxTask();
+
   status_cb.Run(PIPELINE_OK);
 }
 
@@ -592,9 +717,49 @@ bool FFmpegDemuxer::IsSeekable() {
   return !IsStreaming();
 }
 
+bool FFmpegDemuxer::SeekToBufferedTime(base::TimeDelta time) {
+  DCHECK_EQ(MessageLoop::current(), message_loop_);
+
+  // Every active stream must have the seek target buffered.  The video
+  // stream, which has to resume from a keyframe, determines the final seek
+  // point; audio before that point is discarded alongside it.
+  bool found_active_stream = false;
+  base::TimeDelta seek_point = time;
+  StreamVector::iterator iter;
+  for (iter = streams_.begin(); iter != streams_.end(); ++iter) {
+    if (!*iter ||
+        (audio_disabled_ && (*iter)->type() == DemuxerStream::AUDIO)) {
+      continue;
+    }
+    base::TimeDelta stream_seek_point = (*iter)->FindBufferedSeekPoint(time);
+    if (stream_seek_point == kNoTimestamp())
+      return false;
+    seek_point = std::min(seek_point, stream_seek_point);
+    found_active_stream = true;
+  }
+  if (!found_active_stream)
+    return false;
+
+  for (iter = streams_.begin(); iter != streams_.end(); ++iter) {
+    if (!*iter ||
+        (audio_disabled_ && (*iter)->type() == DemuxerStream::AUDIO)) {
+      continue;
+    }
+    (*iter)->DropBufferedPacketsBefore(seek_point);
+  }
+  return true;
+}
+
 void FFmpegDemuxer::SeekTask(base::TimeDelta time, const PipelineStatusCB& cb) {
   DCHECK_EQ(MessageLoop::current(), message_loop_);
 
+  // Service the seek from the buffered packets when possible so the
+  // readahead behind the target is not thrown away.
+  if (SeekToBufferedTime(time)) {
+    cb.Run(PIPELINE_OK);
+    return;
+  }
+
   // Tell streams to flush buffers due to seeking.
   StreamVector::iterator iter;
   for (iter = streams_.begin(); iter != streams_.end(); ++iter) {
@@ -615,6 +780,9 @@ void FFmpegDemuxer::SeekTask(base::TimeDelta time, const PipelineStatusCB& cb) {
     VLOG(1) << "Not implemented";
   }
 
+  // Refill the readahead queues from the new position.
+  PostDemuxTask();
+
   // Notify we're finished seeking.
   cb.Run(PIPELINE_OK);
 }
@@ -622,8 +790,9 @@ void FFmpegDemuxer::SeekTask(base::TimeDelta time, const PipelineStatusCB& cb) {
 void FFmpegDemuxer::DemuxTask() {
   DCHECK_EQ(MessageLoop::current(), message_loop_);
 
-  // Make sure we have work to do before demuxing.
-  if (!StreamsHavePendingReads()) {
+  // Make sure we have work to do before demuxing: either a stream is
+  // waiting on a read or the readahead queues have room for more packets.
+  if (!StreamsHavePendingReads() && !StreamsHaveAvailableCapacity()) {
     return;
   }
 
@@ -665,7 +834,7 @@ void FFmpegDemuxer::DemuxTask() {
 
   // Create a loop by posting another task.  This allows seek and message loop
   // quit tasks to get processed.
-  if (StreamsHavePendingReads()) {
+  if (StreamsHavePendingReads() || StreamsHaveAvailableCapacity()) {
     PostDemuxTask();
   }
 }
@@ -706,6 +875,17 @@ bool FFmpegDemuxer::StreamsHavePendingReads() {
   return false;
 }
 
+bool FFmpegDemuxer::StreamsHaveAvailableCapacity() {
+  DCHECK_EQ(MessageLoop::current(), message_loop_);
+  StreamVector::iterator iter;
+  for (iter = streams_.begin(); iter != streams_.end(); ++iter) {
+    if (*iter && (*iter)->HasAvailableCapacity()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void FFmpegDemuxer::StreamHasEnded() {
   DCHECK_EQ(MessageLoop::current(), message_loop_);
   StreamVector::iterator iter;
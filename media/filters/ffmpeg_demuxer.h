@@ -11,6 +11,13 @@
 // FFmpegDemuxer sets the duration of pipeline during initialization by using
 // the duration of the longest audio/video stream.
 //
+// FFmpegDemuxer keeps a bounded amount of demuxed packets buffered ahead of
+// the renderers for each stream so that short stalls in the data source do
+// not immediately starve the pipeline.  Seeks whose target lies within the
+// buffered packets are serviced by discarding the leading packets instead of
+// flushing the queues and seeking the underlying media.  The readahead
+// duration can be adjusted with the --demuxer-readahead switch.
+//
 // NOTE: since FFmpegDemuxer reads packets sequentially without seeking, media
 // files with very large drift between audio/video streams may result in
 // excessive memory consumption.
@@ -64,6 +71,26 @@ class FFmpegDemuxerStream : public DemuxerStream {
   // Signals to empty the buffer queue and mark next packet as discontinuous.
   void FlushBuffers();
 
+  // Returns true if this stream should buffer additional demuxed packets,
+  // i.e. the queue is below both its byte and duration limits.
+  //
+  // Must be called on the demuxer thread.
+  bool HasAvailableCapacity();
+
+  // Returns the timestamp this stream can resume from if a seek to
+  // |timestamp| were serviced from the buffered packets: the timestamp of
+  // the latest buffered keyframe at or before |timestamp| for video, or
+  // |timestamp| itself for audio.  Returns kNoTimestamp() if the buffered
+  // packets do not cover |timestamp|.
+  //
+  // Must be called on the demuxer thread.
+  base::TimeDelta FindBufferedSeekPoint(base::TimeDelta timestamp);
+
+  // Discards buffered packets with a timestamp before |seek_point|.
+  //
+  // Must be called on the demuxer thread.
+  void DropBufferedPacketsBefore(base::TimeDelta seek_point);
+
   // Empties the queues and ignores any additional calls to Read().
   void Stop();
 
@@ -109,9 +136,21 @@ class FFmpegDemuxerStream : public DemuxerStream {
   bool discontinuous_;
   bool stopped_;
 
-  typedef std::deque<scoped_refptr<Buffer> > BufferQueue;
+  // A demuxed packet and the metadata required to service seeks from the
+  // buffered data.
+  struct BufferedPacket {
+    scoped_refptr<Buffer> buffer;
+    bool keyframe;
+  };
+  typedef std::deque<BufferedPacket> BufferQueue;
   BufferQueue buffer_queue_;
 
+  // Number of bytes of packet data in |buffer_queue_| and the timestamp of
+  // the most recently enqueued packet, used to enforce the buffering limits.
+  // Protected by |lock_|.
+  int buffered_bytes_;
+  base::TimeDelta last_packet_timestamp_;
+
   typedef std::deque<ReadCB> ReadQueue;
   ReadQueue read_queue_;
 
@@ -162,6 +201,10 @@ class MEDIA_EXPORT FFmpegDemuxer : public Demuxer, public FFmpegURLProtocol {
   // Provide access to FFmpegDemuxerStream.
   MessageLoop* message_loop();
 
+  // Maximum duration of demuxed packets each FFmpegDemuxerStream should
+  // keep buffered ahead of its reader.
+  base::TimeDelta max_buffered_duration() const;
+
  private:
   // To allow tests access to privates.
   friend class FFmpegDemuxerTest;
@@ -188,6 +231,20 @@ class MEDIA_EXPORT FFmpegDemuxer : public Demuxer, public FFmpegURLProtocol {
   // Must be called on the demuxer thread.
   bool StreamsHavePendingReads();
 
+  // Returns true if any of the streams can buffer additional demuxed
+  // packets, in which case readahead demuxing should continue.
+  //
+  // Must be called on the demuxer thread.
+  bool StreamsHaveAvailableCapacity();
+
+  // Attempts to service a seek to |time| entirely from the packets already
+  // buffered by the streams so the readahead behind the target is not thrown
+  // away.  Returns true if all active streams were repositioned, false if
+  // the seek must go through the underlying media.
+  //
+  // Must be called on the demuxer thread.
+  bool SeekToBufferedTime(base::TimeDelta time);
+
   // Signal all FFmpegDemuxerStream that the stream has ended.
   //
   // Must be called on the demuxer thread.
@@ -242,6 +299,10 @@ class MEDIA_EXPORT FFmpegDemuxer : public Demuxer, public FFmpegURLProtocol {
   // Derived bitrate after initialization has completed.
   int bitrate_;
 
+  // Maximum duration of demuxed packets to buffer ahead of the readers for
+  // each stream.  Derived from the --demuxer-readahead switch.
+  base::TimeDelta max_buffered_duration_;
+
   // The first timestamp of the opened media file. This is used to set the
   // starting clock value to match the timestamps in the media file. Default
   // is 0.
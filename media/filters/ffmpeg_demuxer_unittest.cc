@@ -113,6 +113,12 @@ class FFmpegDemuxerTest : public testing::Test {
     return static_cast<FFmpegDemuxerStream*>(stream)->stopped_;
   }
 
+  int GetBufferedBytes(DemuxerStream::Type type) {
+    DemuxerStream* stream = demuxer_->GetStream(type);
+    CHECK(stream);
+    return static_cast<FFmpegDemuxerStream*>(stream)->buffered_bytes_;
+  }
+
   // Fixture members.
   scoped_refptr<FileDataSource> data_source_;
   scoped_refptr<FFmpegDemuxer> demuxer_;
@@ -361,9 +367,67 @@ TEST_F(FFmpegDemuxerTest, Read_EndOfStream) {
   EXPECT_TRUE(got_eos_buffer);
 }
 
+TEST_F(FFmpegDemuxerTest, Readahead) {
+  // Initialization kicks off readahead, so packets should be buffered for
+  // both streams before any Read() is issued.
+  CreateDemuxer("bear-320x240.webm");
+  InitializeDemuxer();
+
+  EXPECT_GT(GetBufferedBytes(DemuxerStream::AUDIO), 0);
+  EXPECT_GT(GetBufferedBytes(DemuxerStream::VIDEO), 0);
+
+  // Reads should be satisfied from the buffered packets without having to
+  // run the message loop.
+  scoped_refptr<DemuxerStream> audio =
+      demuxer_->GetStream(DemuxerStream::AUDIO);
+  scoped_refptr<DemuxerStreamReader> reader(new DemuxerStreamReader());
+  reader->Read(audio);
+  EXPECT_TRUE(reader->called());
+  ValidateBuffer(FROM_HERE, reader->buffer(), 29, 0);
+}
+
+TEST_F(FFmpegDemuxerTest, SeekToBufferedTime) {
+  // A seek whose target lies within the readahead should be serviced from
+  // the buffered packets without rewinding the underlying media.
+  CreateDemuxer("bear-320x240.webm");
+  InitializeDemuxer();
+
+  int64 position_before_seek = 0;
+  EXPECT_TRUE(demuxer_->GetPosition(&position_before_seek));
+
+  demuxer_->Seek(base::TimeDelta::FromMicroseconds(1000000),
+                 NewExpectedStatusCB(PIPELINE_OK));
+  message_loop_.RunAllPending();
+
+  // The read position never moves backwards when the seek is buffered.
+  int64 position_after_seek = 0;
+  EXPECT_TRUE(demuxer_->GetPosition(&position_after_seek));
+  EXPECT_GE(position_after_seek, position_before_seek);
+
+  // The streams should resume at the same packets that seeking the media
+  // would have produced: the last video keyframe at or before the target
+  // and the first audio packet after that keyframe.
+  scoped_refptr<DemuxerStream> video =
+      demuxer_->GetStream(DemuxerStream::VIDEO);
+  scoped_refptr<DemuxerStream> audio =
+      demuxer_->GetStream(DemuxerStream::AUDIO);
+  scoped_refptr<DemuxerStreamReader> reader(new DemuxerStreamReader());
+
+  reader->Read(video);
+  message_loop_.RunAllPending();
+  EXPECT_TRUE(reader->called());
+  ValidateBuffer(FROM_HERE, reader->buffer(), 5425, 801000);
+
+  reader->Reset();
+  reader->Read(audio);
+  message_loop_.RunAllPending();
+  EXPECT_TRUE(reader->called());
+  ValidateBuffer(FROM_HERE, reader->buffer(), 145, 803000);
+}
+
 TEST_F(FFmpegDemuxerTest, Seek) {
-  // We're testing that the demuxer frees all queued packets when it receives
-  // a Seek().
+  // We're testing that the demuxer repositions its queued packets when it
+  // receives a Seek().
   CreateDemuxer("bear-320x240.webm");
   InitializeDemuxer();
 
@@ -421,7 +421,7 @@ scoped_refptr<VideoFrame> FFmpegVideoDecoder::AllocateVideoFrame() {
   size_t width = codec_context_->width;
   size_t height = codec_context_->height;
 
-  return VideoFrame::CreateFrame(format, width, height,
+  return frame_pool_.CreateFrame(format, width, height,
                                  kNoTimestamp(), kNoTimestamp());
 }
 
@@ -10,6 +10,7 @@
 #include "base/callback.h"
 #include "base/memory/scoped_ptr.h"
 #include "media/base/video_decoder.h"
+#include "media/base/video_frame_pool.h"
 #include "media/crypto/aes_decryptor.h"
 
 class MessageLoop;
@@ -96,6 +97,9 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
   // Pointer to the demuxer stream that will feed us compressed buffers.
   scoped_refptr<DemuxerStream> demuxer_stream_;
 
+  // Recycles frame allocations between decoded frames.
+  VideoFramePool frame_pool_;
+
   AesDecryptor decryptor_;
 
   DISALLOW_COPY_AND_ASSIGN(FFmpegVideoDecoder);
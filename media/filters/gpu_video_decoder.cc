@@ -4,10 +4,14 @@
 
 #include "media/filters/gpu_video_decoder.h"
 
+#include <set>
+
 #include "base/bind.h"
 #include "base/callback_helpers.h"
+#include "base/lazy_instance.h"
 #include "base/message_loop.h"
 #include "base/stl_util.h"
+#include "base/synchronization/lock.h"
 #include "media/base/demuxer_stream.h"
 #include "media/base/filter_host.h"
 #include "media/base/pipeline.h"
@@ -22,6 +26,30 @@ GpuVideoDecoder::Factories::~Factories() {}
 // be on the beefy side.
 static const size_t kSharedMemorySegmentBytes = 100 << 10;
 
+// Per-process cache of codec profiles the platform accelerator has refused.
+// Each failed CreateVideoDecodeAccelerator() call costs a GPU-process round
+// trip, so mixed-codec playlists would otherwise pay a doomed probe on every
+// pipeline build before falling back to software decode.
+struct UnsupportedProfileCache {
+  base::Lock lock;
+  std::set<VideoCodecProfile> profiles;
+};
+
+static base::LazyInstance<UnsupportedProfileCache> g_unsupported_profiles =
+    LAZY_INSTANCE_INITIALIZER;
+
+static bool IsProfileKnownUnsupported(VideoCodecProfile profile) {
+  UnsupportedProfileCache* cache = g_unsupported_profiles.Pointer();
+  base::AutoLock auto_lock(cache->lock);
+  return cache->profiles.count(profile) > 0;
+}
+
+static void RecordUnsupportedProfile(VideoCodecProfile profile) {
+  UnsupportedProfileCache* cache = g_unsupported_profiles.Pointer();
+  base::AutoLock auto_lock(cache->lock);
+  cache->profiles.insert(profile);
+}
+
 GpuVideoDecoder::SHMBuffer::SHMBuffer(base::SharedMemory* m, size_t s)
     : shm(m), size(s) {
 }
@@ -151,8 +179,16 @@ void GpuVideoDecoder::Initialize(const scoped_refptr<DemuxerStream>& stream,
     return;
   }
 
+  // Skip the accelerator probe entirely when this profile has already been
+  // refused; the pipeline falls back to the next decoder in its collection.
+  if (IsProfileKnownUnsupported(config.profile())) {
+    status_cb.Run(DECODER_ERROR_NOT_SUPPORTED);
+    return;
+  }
+
   vda_ = factories_->CreateVideoDecodeAccelerator(config.profile(), this);
   if (!vda_) {
+    RecordUnsupportedProfile(config.profile());
     status_cb.Run(DECODER_ERROR_NOT_SUPPORTED);
     return;
   }
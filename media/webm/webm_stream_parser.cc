@@ -4,6 +4,8 @@
 
 #include "media/webm/webm_stream_parser.h"
 
+#include <algorithm>
+
 #include "base/callback.h"
 #include "base/logging.h"
 #include "media/ffmpeg/ffmpeg_common.h"
@@ -181,7 +183,8 @@ bool FFmpegConfigHelper::SetupStreamConfigs() {
 }
 
 WebMStreamParser::WebMStreamParser()
-    : state_(kWaitingForInit) {
+    : state_(kWaitingForInit),
+      bytes_to_skip_(0) {
 }
 
 WebMStreamParser::~WebMStreamParser() {}
@@ -210,6 +213,7 @@ void WebMStreamParser::Flush() {
   DCHECK_NE(state_, kWaitingForInit);
 
   byte_queue_.Reset();
+  bytes_to_skip_ = 0;
 
   if (state_ != kParsingClusters)
     return;
@@ -366,6 +370,14 @@ int WebMStreamParser::ParseCluster(const uint8* data, int size) {
   if (!cluster_parser_.get())
     return -1;
 
+  // Finish discarding a skipped element whose bytes are still arriving.
+  if (bytes_to_skip_ > 0) {
+    int to_skip = static_cast<int>(std::min(bytes_to_skip_,
+                                            static_cast<int64>(size)));
+    bytes_to_skip_ -= to_skip;
+    return to_skip;
+  }
+
   int id;
   int64 element_size;
   int result = WebMParseElementHeader(data, size, &id, &element_size);
@@ -374,12 +386,13 @@ int WebMStreamParser::ParseCluster(const uint8* data, int size) {
     return result;
 
   if (id == kWebMIdCues) {
-    if (size < (result + element_size)) {
-      // We don't have the whole element yet. Signal we need more data.
-      return 0;
-    }
-    // Skip the element.
-    return result + element_size;
+    // We don't use the Cues data, so discard its bytes as they are appended
+    // instead of buffering the whole element and skipping it in one go.
+    int64 total_size = result + element_size;
+    int to_skip = static_cast<int>(std::min(total_size,
+                                            static_cast<int64>(size)));
+    bytes_to_skip_ = total_size - to_skip;
+    return to_skip;
   }
 
   int bytes_parsed = cluster_parser_->Parse(data, size);
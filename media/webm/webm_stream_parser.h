@@ -68,6 +68,12 @@ class WebMStreamParser : public StreamParser {
   scoped_ptr<WebMClusterParser> cluster_parser_;
   ByteQueue byte_queue_;
 
+  // Number of bytes of a skipped level 1 element (e.g. Cues) that have not
+  // been appended yet.  Tracking this lets large skipped elements be
+  // discarded as their bytes arrive instead of accumulating the entire
+  // element in |byte_queue_| first.
+  int64 bytes_to_skip_;
+
   DISALLOW_COPY_AND_ASSIGN(WebMStreamParser);
 };
 
@@ -12,6 +12,12 @@
 #include "base/string_util.h"
 #include "base/utf_offset_string_conversions.h"
 #include "base/utf_string_conversions.h"
+#include "build/build_config.h"
+
+#if defined(__SSE2__) || (defined(COMPILER_MSVC) && defined(ARCH_CPU_X86_64))
+#define NET_ESCAPE_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
 
 namespace net {
 
@@ -36,6 +42,70 @@ struct Charmap {
   uint32 map[8];
 };
 
+// Contains nonzero for characters that no Charmap in this file escapes and
+// that use_plus never rewrites: alphanumerics plus "()*-._~".  Runs of these
+// can be copied to the output without consulting the charmap at all.
+const char kAlwaysSafeChars[128] = {
+//   NULL, control chars...
+     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+//  ' ' !  "  #  $  %  &  '  (  )  *  +  ,  -  .  /
+     0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 1, 1, 0,
+//   0  1  2  3  4  5  6  7  8  9  :  ;  <  =  >  ?
+     1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+//   @  A  B  C  D  E  F  G  H  I  J  K  L  M  N  O
+     0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+//   P  Q  R  S  T  U  V  W  X  Y  Z  [  \  ]  ^  _
+     1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,
+//   `  a  b  c  d  e  f  g  h  i  j  k  l  m  n  o
+     0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+//   p  q  r  s  t  u  v  w  x  y  z  {  |  }  ~  <DEL>
+     1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 0
+};
+
+#if defined(NET_ESCAPE_HAVE_SSE2)
+// Returns a mask of the bytes in |chunk| that lie in [lo, hi].  Signed
+// compares suffice: every character of interest is below 0x80, and bytes
+// with the high bit set compare negative and are correctly rejected.
+inline __m128i InRange(__m128i chunk, char lo, char hi) {
+  return _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8(lo - 1)),
+                       _mm_cmplt_epi8(chunk, _mm_set1_epi8(hi + 1)));
+}
+#endif
+
+// Returns the length of the run of characters in |text| starting at |pos|
+// that are in kAlwaysSafeChars.  Where SSE2 is available, whole 16 byte
+// chunks are classified with a handful of range compares.
+size_t SafeRunLength(const std::string& text, size_t pos) {
+  const char* data = text.data();
+  const size_t len = text.length();
+  size_t i = pos;
+#if defined(NET_ESCAPE_HAVE_SSE2)
+  while (i + 16 <= len) {
+    __m128i chunk = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + i));
+    __m128i safe = _mm_or_si128(
+        _mm_or_si128(InRange(chunk, '0', '9'), InRange(chunk, 'A', 'Z')),
+        _mm_or_si128(InRange(chunk, 'a', 'z'), InRange(chunk, '(', '*')));
+    safe = _mm_or_si128(safe, InRange(chunk, '-', '.'));
+    safe = _mm_or_si128(safe,
+                        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('_')));
+    safe = _mm_or_si128(safe,
+                        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('~')));
+    if (_mm_movemask_epi8(safe) != 0xFFFF)
+      break;
+    i += 16;
+  }
+#endif
+  while (i < len) {
+    unsigned char c = static_cast<unsigned char>(data[i]);
+    if (c >= 128 || !kAlwaysSafeChars[c])
+      break;
+    ++i;
+  }
+  return i - pos;
+}
+
 // Given text to escape and a Charmap defining which values to escape,
 // return an escaped string.  If use_plus is true, spaces are converted
 // to +, otherwise, if spaces are in the charmap, they are converted to
@@ -44,7 +114,15 @@ std::string Escape(const std::string& text, const Charmap& charmap,
                    bool use_plus) {
   std::string escaped;
   escaped.reserve(text.length() * 3);
-  for (unsigned int i = 0; i < text.length(); ++i) {
+  for (size_t i = 0; i < text.length(); ) {
+    // Most input needs no escaping at all, so bulk-copy runs of characters
+    // that no charmap escapes and only classify the rest per character.
+    size_t run = SafeRunLength(text, i);
+    if (run) {
+      escaped.append(text, i, run);
+      i += run;
+      continue;
+    }
     unsigned char c = static_cast<unsigned char>(text[i]);
     if (use_plus && ' ' == c) {
       escaped.push_back('+');
@@ -55,6 +133,7 @@ std::string Escape(const std::string& text, const Charmap& charmap,
     } else {
       escaped.push_back(c);
     }
+    ++i;
   }
   return escaped;
 }
@@ -97,6 +176,50 @@ const char kUrlUnescape[128] = {
      1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 0
 };
 
+// Returns the length of the run of characters in |escaped_text| starting at
+// |pos| that contain neither '%' nor '+'.  Such runs are copied to the
+// unescaped output verbatim, whatever the rules.
+template<typename STR>
+size_t LiteralRunLength(const STR& escaped_text, size_t pos) {
+  size_t i = pos;
+  const size_t len = escaped_text.length();
+  while (i < len && escaped_text[i] != '%' && escaped_text[i] != '+')
+    ++i;
+  return i - pos;
+}
+
+// 8-bit overload: where SSE2 is available, scan for the next '%' or '+' 16
+// bytes at a time.
+size_t LiteralRunLength(const std::string& escaped_text, size_t pos) {
+  const char* data = escaped_text.data();
+  const size_t len = escaped_text.length();
+  size_t i = pos;
+#if defined(NET_ESCAPE_HAVE_SSE2)
+  const __m128i percent = _mm_set1_epi8('%');
+  const __m128i plus = _mm_set1_epi8('+');
+  while (i + 16 <= len) {
+    __m128i chunk = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + i));
+    __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, percent),
+                                _mm_cmpeq_epi8(chunk, plus));
+    int mask = _mm_movemask_epi8(hits);
+    if (mask) {
+      // Count the literal bytes preceding the first hit.
+      size_t offset = 0;
+      while (!(mask & 1)) {
+        mask >>= 1;
+        ++offset;
+      }
+      return i + offset - pos;
+    }
+    i += 16;
+  }
+#endif
+  while (i < len && data[i] != '%' && data[i] != '+')
+    ++i;
+  return i - pos;
+}
+
 template<typename STR>
 STR UnescapeURLWithOffsetsImpl(const STR& escaped_text,
                                UnescapeRule::Type rules,
@@ -119,6 +242,15 @@ STR UnescapeURLWithOffsetsImpl(const STR& escaped_text,
   // Locations of adjusted text.
   net::internal::AdjustEncodingOffset::Adjustments adjustments;
   for (size_t i = 0, max = escaped_text.size(); i < max; ++i) {
+    // Anything other than '%' and '+' is copied through verbatim (including
+    // non-ASCII), so bulk-copy such runs and only reason about the rest.
+    size_t run = LiteralRunLength(escaped_text, i);
+    if (run) {
+      result.append(escaped_text, i, run);
+      i += run;
+      if (i == max)
+        break;
+    }
     if (static_cast<unsigned char>(escaped_text[i]) >= 128) {
       // Non ASCII character, append as is.
       result.push_back(escaped_text[i]);
@@ -91,8 +91,8 @@ void FileStream::SetBoundNetLogSource(
   impl_.SetBoundNetLogSource(owner_bound_net_log);
 }
 
-base::PlatformFile FileStream::GetPlatformFileForTesting() {
-  return impl_.GetPlatformFileForTesting();
+base::PlatformFile FileStream::GetPlatformFile() {
+  return impl_.GetPlatformFile();
 }
 
 }  // namespace net
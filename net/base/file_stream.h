@@ -213,8 +213,9 @@ class NET_EXPORT FileStream {
   // of ownership happened, but without details.
   void SetBoundNetLogSource(const net::BoundNetLog& owner_bound_net_log);
 
-  // Returns the underlying platform file for testing.
-  base::PlatformFile GetPlatformFileForTesting();
+  // Returns the underlying platform file. Note that the FileStream retains
+  // ownership of the handle.
+  base::PlatformFile GetPlatformFile();
 
  private:
 #if defined(OS_WIN)
@@ -626,7 +626,7 @@ void FileStreamPosix::SetBoundNetLogSource(
                                          bound_net_log_.source())));
 }
 
-base::PlatformFile FileStreamPosix::GetPlatformFileForTesting() {
+base::PlatformFile FileStreamPosix::GetPlatformFile() {
   return file_;
 }
 
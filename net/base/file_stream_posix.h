@@ -53,7 +53,7 @@ class NET_EXPORT FileStreamPosix {
   void EnableErrorStatistics();
   void SetBoundNetLogSource(
       const net::BoundNetLog& owner_bound_net_log);
-  base::PlatformFile GetPlatformFileForTesting();
+  base::PlatformFile GetPlatformFile();
 
   // Resets on_io_complete_ and WeakPtr's.
   // Called when Read() or Write() is completed.
@@ -112,7 +112,7 @@ TEST_F(FileStreamTest, BasicOpenClose) {
         base::PLATFORM_FILE_OPEN | base::PLATFORM_FILE_READ);
     EXPECT_EQ(OK, rv);
     EXPECT_TRUE(stream.IsOpen());
-    file = stream.GetPlatformFileForTesting();
+    file = stream.GetPlatformFile();
   }
   EXPECT_NE(base::kInvalidPlatformFileValue, file);
   base::PlatformFileInfo info;
@@ -667,7 +667,7 @@ void FileStreamWin::SetBoundNetLogSource(
                                          bound_net_log_.source())));
 }
 
-base::PlatformFile FileStreamWin::GetPlatformFileForTesting() {
+base::PlatformFile FileStreamWin::GetPlatformFile() {
   return file_;
 }
 
@@ -53,7 +53,7 @@ class NET_EXPORT FileStreamWin {
   int Flush();
   void EnableErrorStatistics();
   void SetBoundNetLogSource(const net::BoundNetLog& owner_bound_net_log);
-  base::PlatformFile GetPlatformFileForTesting();
+  base::PlatformFile GetPlatformFile();
 
  private:
   class AsyncContext;
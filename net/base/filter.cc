@@ -122,6 +122,19 @@ Filter::FilterStatus Filter::ReadData(char* dest_buffer, int* dest_len) {
   return FILTER_OK;
 }
 
+bool Filter::IsPassThroughChain() const {
+  for (const Filter* filter = this; filter;
+       filter = filter->next_filter_.get()) {
+    if (!filter->IsPassThrough() || filter->stream_data_len_)
+      return false;
+  }
+  return true;
+}
+
+bool Filter::IsPassThrough() const {
+  return false;
+}
+
 bool Filter::FlushStreamBuffer(int stream_data_len) {
   DCHECK_LE(stream_data_len, stream_buffer_size_);
   if (stream_data_len <= 0 || stream_data_len > stream_buffer_size_)
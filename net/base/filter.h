@@ -158,6 +158,13 @@ class NET_EXPORT_PRIVATE Filter {
   // next_filter_, then it obtains data from this specific filter.
   FilterStatus ReadData(char* dest_buffer, int* dest_len);
 
+  // Returns true if every filter in this chain has degenerated into a pure
+  // pass through (e.g. a decoder fell back to copying bytes verbatim after
+  // seeing a mislabeled Content-Encoding) and no filter holds buffered data.
+  // When this is the case, the caller may bypass the chain entirely and read
+  // pre-filter data directly into its destination buffer.
+  bool IsPassThroughChain() const;
+
   // Returns a pointer to the stream_buffer_.
   IOBuffer* stream_buffer() const { return stream_buffer_.get(); }
 
@@ -216,6 +223,11 @@ class NET_EXPORT_PRIVATE Filter {
   // but not produce output yet.
   virtual FilterStatus ReadFilteredData(char* dest_buffer, int* dest_len) = 0;
 
+  // Returns true if this filter would copy its input to its output verbatim
+  // for the rest of the stream.  The default is false; subclasses that can
+  // turn into a pass through override this.  See IsPassThroughChain().
+  virtual bool IsPassThrough() const;
+
   // Copy pre-filter data directly to destination buffer without decoding.
   FilterStatus CopyOut(char* dest_buffer, int* dest_len);
 
@@ -151,6 +151,14 @@ Filter::FilterStatus GZipFilter::ReadFilteredData(char* dest_buffer,
   return status;
 }
 
+bool GZipFilter::IsPassThrough() const {
+  // A valid stream that reached DECODING_DONE still needs its footer (and any
+  // trailing junk) consumed here, so only the invalid-header fallback counts
+  // as a pure pass through.
+  return decoding_status_ == DECODING_DONE &&
+         gzip_header_status_ == GZIP_GET_INVALID_HEADER;
+}
+
 Filter::FilterStatus GZipFilter::CheckGZipHeader() {
   DCHECK_EQ(gzip_header_status_, GZIP_CHECK_HEADER_IN_PROGRESS);
 
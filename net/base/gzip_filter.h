@@ -52,6 +52,11 @@ class GZipFilter : public Filter {
   virtual FilterStatus ReadFilteredData(char* dest_buffer,
                                         int* dest_len) OVERRIDE;
 
+  // Returns true once the filter has reverted to copying data through
+  // verbatim, i.e. after an invalid gzip header made it fall back to pass
+  // through mode (see |possible_sdch_pass_through_|).
+  virtual bool IsPassThrough() const OVERRIDE;
+
  private:
   enum DecodingStatus {
     DECODING_UNINITIALIZED,
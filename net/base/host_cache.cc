@@ -5,10 +5,26 @@
 #include "net/base/host_cache.h"
 
 #include "base/logging.h"
+#include "base/string_number_conversions.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
+#include "net/base/sys_addrinfo.h"
 
 namespace net {
 
+namespace {
+
+// Keys of the dictionaries produced by HostCache::GetPersistentEntries().
+const char kHostnameKey[] = "hostname";
+const char kAddressFamilyKey[] = "address_family";
+const char kFlagsKey[] = "flags";
+const char kExpirationKey[] = "expiration";
+const char kAddressesKey[] = "addresses";
+const char kCanonicalNameKey[] = "canonical_name";
+
+}  // namespace
+
 //-----------------------------------------------------------------------------
 
 HostCache::Entry::Entry(int error, const AddressList& addrlist)
@@ -70,6 +86,108 @@ const HostCache::EntryMap& HostCache::entries() const {
   return entries_;
 }
 
+void HostCache::GetPersistentEntries(base::TimeTicks now,
+                                     base::Time now_wall,
+                                     base::ListValue* entries) const {
+  DCHECK(CalledOnValidThread());
+  DCHECK(entries);
+
+  for (EntryMap::Iterator it(entries_); it.HasNext(); it.Advance()) {
+    // Failed resolutions are not worth carrying across launches.
+    if (it.value().error != OK)
+      continue;
+    if (it.expiration() <= now)
+      continue;
+
+    ListValue* addresses = new ListValue();
+    for (const struct addrinfo* ai = it.value().addrlist.head(); ai;
+         ai = ai->ai_next) {
+      addresses->Append(new StringValue(NetAddressToString(ai)));
+    }
+
+    base::Time expiration_wall = now_wall + (it.expiration() - now);
+
+    DictionaryValue* entry_dict = new DictionaryValue();
+    entry_dict->SetString(kHostnameKey, it.key().hostname);
+    entry_dict->SetInteger(kAddressFamilyKey,
+                           static_cast<int>(it.key().address_family));
+    entry_dict->SetInteger(kFlagsKey, it.key().host_resolver_flags);
+    entry_dict->SetString(
+        kExpirationKey,
+        base::Int64ToString(expiration_wall.ToInternalValue()));
+    entry_dict->Set(kAddressesKey, addresses);
+    std::string canonical_name;
+    if (it.value().addrlist.GetCanonicalName(&canonical_name))
+      entry_dict->SetString(kCanonicalNameKey, canonical_name);
+
+    entries->Append(entry_dict);
+  }
+}
+
+void HostCache::RestorePersistentEntries(const base::ListValue& entries,
+                                         base::TimeTicks now,
+                                         base::Time now_wall) {
+  DCHECK(CalledOnValidThread());
+  if (caching_is_disabled())
+    return;
+
+  for (size_t i = 0; i < entries.GetSize(); ++i) {
+    DictionaryValue* entry_dict;
+    if (!entries.GetDictionary(i, &entry_dict))
+      continue;
+
+    std::string hostname;
+    int address_family;
+    int flags;
+    std::string expiration_string;
+    ListValue* addresses;
+    if (!entry_dict->GetString(kHostnameKey, &hostname) ||
+        !entry_dict->GetInteger(kAddressFamilyKey, &address_family) ||
+        !entry_dict->GetInteger(kFlagsKey, &flags) ||
+        !entry_dict->GetString(kExpirationKey, &expiration_string) ||
+        !entry_dict->GetList(kAddressesKey, &addresses))
+      continue;
+
+    int64 expiration_internal;
+    if (!base::StringToInt64(expiration_string, &expiration_internal))
+      continue;
+    base::Time expiration_wall =
+        base::Time::FromInternalValue(expiration_internal);
+    if (expiration_wall <= now_wall)
+      continue;
+
+    IPAddressList ip_addresses;
+    bool parsed = !addresses->empty();
+    for (size_t j = 0; j < addresses->GetSize(); ++j) {
+      std::string ip_literal;
+      IPAddressNumber ip_number;
+      if (!addresses->GetString(j, &ip_literal) ||
+          !ParseIPLiteralToNumber(ip_literal, &ip_number)) {
+        parsed = false;
+        break;
+      }
+      ip_addresses.push_back(ip_number);
+    }
+    if (!parsed)
+      continue;
+
+    Key key(hostname, static_cast<AddressFamily>(address_family), flags);
+    // A result obtained this session is always fresher than the snapshot.
+    if (entries_.Get(key, now))
+      continue;
+
+    std::string canonical_name;
+    entry_dict->GetString(kCanonicalNameKey, &canonical_name);
+
+    entries_.Put(
+        key,
+        Entry(OK, AddressList::CreateFromIPAddressList(ip_addresses,
+                                                       canonical_name)),
+        now,
+        expiration_wall - now_wall);
+  }
+}
+
 // static
 HostCache* HostCache::CreateDefaultCache() {
   static const size_t kMaxHostCacheEntries = 100;
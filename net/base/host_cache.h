@@ -16,6 +16,10 @@
 #include "net/base/expiring_cache.h"
 #include "net/base/net_export.h"
 
+namespace base {
+class ListValue;
+}
+
 namespace net {
 
 // Cache used by HostResolver to map hostnames to their resolved result.
@@ -85,6 +89,23 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
 
   const EntryMap& entries() const;
 
+  // Serializes the unexpired, successful entries of the cache into |entries|,
+  // a list of dictionaries suitable for persisting across browser launches.
+  // Expiration times are converted from TimeTicks to wall clock time, using
+  // |now| and |now_wall| as the common reference point, so that they remain
+  // meaningful after a restart.
+  void GetPersistentEntries(base::TimeTicks now,
+                            base::Time now_wall,
+                            base::ListValue* entries) const;
+
+  // Restores entries previously produced by GetPersistentEntries(),
+  // converting wall clock expiration times back to TimeTicks. Entries that
+  // have expired, entries that fail to parse, and entries for keys that have
+  // already been resolved this session are ignored.
+  void RestorePersistentEntries(const base::ListValue& entries,
+                                base::TimeTicks now,
+                                base::Time now_wall);
+
   // Creates a default cache.
   static HostCache* CreateDefaultCache();
 
@@ -44,6 +44,11 @@ class NET_EXPORT HostPortPair {
     return host_ == other.host_ && port_ == other.port_;
   }
 
+  // Needed so std::pairs of HostPortPairs can be used as hash_map keys.
+  bool operator==(const HostPortPair& other) const {
+    return Equals(other);
+  }
+
   bool IsEmpty() const {
     return host_.empty() && port_ == 0;
   }
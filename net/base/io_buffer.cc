@@ -4,7 +4,12 @@
 
 #include "net/base/io_buffer.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "base/logging.h"
+#include "net/base/io_buffer_pool.h"
 
 namespace net {
 
@@ -14,7 +19,7 @@ IOBuffer::IOBuffer()
 
 IOBuffer::IOBuffer(int buffer_size) {
   DCHECK(buffer_size > 0);
-  data_ = new char[buffer_size];
+  data_ = IOBufferPool::Allocate(buffer_size);
 }
 
 IOBuffer::IOBuffer(char* data)
@@ -22,7 +27,7 @@ IOBuffer::IOBuffer(char* data)
 }
 
 IOBuffer::~IOBuffer() {
-  delete[] data_;
+  IOBufferPool::Free(data_);
   data_ = NULL;
 }
 
@@ -91,8 +96,13 @@ GrowableIOBuffer::GrowableIOBuffer()
 
 void GrowableIOBuffer::SetCapacity(int capacity) {
   DCHECK_GE(capacity, 0);
-  // realloc will crash if it fails.
-  real_data_.reset(static_cast<char*>(realloc(real_data_.release(), capacity)));
+  char* new_data = NULL;
+  if (capacity > 0) {
+    new_data = IOBufferPool::Allocate(capacity);
+    if (real_data_.get())
+      memcpy(new_data, real_data_.get(), std::min(capacity, capacity_));
+  }
+  real_data_.reset(new_data);
   capacity_ = capacity;
   if (offset_ > capacity)
     set_offset(capacity);
@@ -127,6 +137,18 @@ void PickledIOBuffer::Done() {
 
 PickledIOBuffer::~PickledIOBuffer() { data_ = NULL; }
 
+SlicedIOBuffer::SlicedIOBuffer(IOBuffer* base, int offset, int size)
+    : IOBufferWithSize(base->data() + offset, size),
+      base_(base) {
+  DCHECK_GE(offset, 0);
+  DCHECK_GE(size, 0);
+}
+
+SlicedIOBuffer::~SlicedIOBuffer() {
+  // The buffer is owned by the |base_| instance.
+  data_ = NULL;
+}
+
 WrappedIOBuffer::WrappedIOBuffer(const char* data)
     : IOBuffer(const_cast<char*>(data)) {
 }
@@ -11,6 +11,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/pickle.h"
+#include "net/base/io_buffer_pool.h"
 #include "net/base/net_export.h"
 
 namespace net {
@@ -204,7 +205,7 @@ class NET_EXPORT GrowableIOBuffer : public IOBuffer {
  private:
   virtual ~GrowableIOBuffer();
 
-  scoped_ptr_malloc<char> real_data_;
+  scoped_ptr_malloc<char, IOBufferPoolFree> real_data_;
   int capacity_;
   int offset_;
 };
@@ -227,6 +228,19 @@ class NET_EXPORT PickledIOBuffer : public IOBuffer {
   Pickle pickle_;
 };
 
+// This version wraps a region of an existing IOBuffer, keeping the underlying
+// buffer alive for as long as the slice is referenced. It is useful for
+// handing out portions of a large read buffer without copying the data.
+class NET_EXPORT SlicedIOBuffer : public IOBufferWithSize {
+ public:
+  SlicedIOBuffer(IOBuffer* base, int offset, int size);
+
+ private:
+  virtual ~SlicedIOBuffer();
+
+  scoped_refptr<IOBuffer> base_;
+};
+
 // This class allows the creation of a temporary IOBuffer that doesn't really
 // own the underlying buffer. Please use this class only as a last resort.
 // A good example is the buffer for a synchronous operation, where we can be
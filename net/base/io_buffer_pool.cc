@@ -0,0 +1,165 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/io_buffer_pool.h"
+
+#include <stdlib.h>
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/message_loop.h"
+#include "base/threading/thread_local.h"
+
+namespace net {
+
+namespace {
+
+// Every block handed out by IOBufferPool is preceded by a header recording
+// the block's bucket size, so Free() can find the right free list without
+// the caller passing a size.  Eight bytes keeps the data 8-byte aligned on
+// both 32 and 64 bit targets.
+const size_t kHeaderSize = 8;
+
+// Allocations are rounded up to power-of-two buckets between these bounds.
+// Larger requests bypass the pool and go straight to the allocator.
+const size_t kMinBucketSize = 256;
+const size_t kMaxBucketSize = 256 * 1024;
+
+// The number of power-of-two buckets in [kMinBucketSize, kMaxBucketSize].
+const int kNumBuckets = 11;
+
+// High-water mark for the bytes cached by one thread's pool.  Blocks freed
+// while at the mark are returned to the allocator immediately.
+const size_t kMaxCachedBytesPerThread = 1024 * 1024;
+
+class PerThreadPool;
+
+base::LazyInstance<base::ThreadLocalPointer<PerThreadPool> >::Leaky
+    g_thread_pool = LAZY_INSTANCE_INITIALIZER;
+
+// The per-thread cache of free blocks.  Created lazily on threads that run a
+// MessageLoop; each instance is only ever touched by its own thread, so no
+// locking is needed.  A block freed on a different thread than it was
+// allocated on simply migrates to the freeing thread's cache.
+class PerThreadPool : public MessageLoop::DestructionObserver {
+ public:
+  // Returns the calling thread's pool, creating it if the thread runs a
+  // MessageLoop.  Returns NULL (no caching) otherwise.
+  static PerThreadPool* Current() {
+    PerThreadPool* pool = g_thread_pool.Get().Get();
+    if (!pool && MessageLoop::current())
+      pool = new PerThreadPool;
+    return pool;
+  }
+
+  // Removes and returns a cached block of exactly |bucket| bytes, or NULL.
+  char* Take(size_t bucket) {
+    int index = BucketIndex(bucket);
+    if (index < 0 || free_lists_[index].empty())
+      return NULL;
+    char* block = free_lists_[index].back();
+    free_lists_[index].pop_back();
+    cached_bytes_ -= bucket;
+    return block;
+  }
+
+  // Caches |block| of |bucket| bytes and returns true.  Returns false,
+  // leaving ownership with the caller, if the block is not poolable, the
+  // high-water mark would be exceeded, or the cache has shut down.
+  bool Give(char* block, size_t bucket) {
+    int index = BucketIndex(bucket);
+    if (shut_down_ || index < 0 ||
+        cached_bytes_ + bucket > kMaxCachedBytesPerThread) {
+      return false;
+    }
+    free_lists_[index].push_back(block);
+    cached_bytes_ += bucket;
+    return true;
+  }
+
+  // MessageLoop::DestructionObserver implementation.
+  virtual void WillDestroyCurrentMessageLoop() OVERRIDE {
+    // Release the cached blocks, but keep this (small) object alive and
+    // registered in TLS: buffers may still be freed while the loop (and
+    // whatever else the thread owns) is torn down, and re-registering an
+    // observer on a dying loop is not an option.  From here on the thread
+    // gets no caching.
+    for (int i = 0; i < kNumBuckets; ++i) {
+      for (size_t j = 0; j < free_lists_[i].size(); ++j)
+        free(free_lists_[i][j]);
+      free_lists_[i].clear();
+    }
+    cached_bytes_ = 0;
+    shut_down_ = true;
+  }
+
+ private:
+  PerThreadPool() : cached_bytes_(0), shut_down_(false) {
+    g_thread_pool.Get().Set(this);
+    MessageLoop::current()->AddDestructionObserver(this);
+  }
+
+  virtual ~PerThreadPool() {}
+
+  // Maps a bucket size to its free list index, or -1 if it isn't poolable.
+  static int BucketIndex(size_t bucket) {
+    if (bucket < kMinBucketSize || bucket > kMaxBucketSize)
+      return -1;
+    int index = 0;
+    for (size_t size = kMinBucketSize; size != bucket; size <<= 1)
+      ++index;
+    return index;
+  }
+
+  std::vector<char*> free_lists_[kNumBuckets];
+  size_t cached_bytes_;
+  bool shut_down_;
+
+  DISALLOW_COPY_AND_ASSIGN(PerThreadPool);
+};
+
+// Rounds |size| up to its bucket size; sizes beyond kMaxBucketSize are left
+// as-is (and will never be cached).
+size_t RoundUpToBucket(size_t size) {
+  if (size > kMaxBucketSize)
+    return size;
+  size_t bucket = kMinBucketSize;
+  while (bucket < size)
+    bucket <<= 1;
+  return bucket;
+}
+
+}  // namespace
+
+// static
+char* IOBufferPool::Allocate(size_t size) {
+  size_t bucket = RoundUpToBucket(size);
+  char* block = NULL;
+  PerThreadPool* pool = PerThreadPool::Current();
+  if (pool)
+    block = pool->Take(bucket);
+  if (!block) {
+    block = static_cast<char*>(malloc(kHeaderSize + bucket));
+    CHECK(block);
+  }
+  *reinterpret_cast<size_t*>(block) = bucket;
+  return block + kHeaderSize;
+}
+
+// static
+void IOBufferPool::Free(char* data) {
+  if (!data)
+    return;
+  char* block = data - kHeaderSize;
+  size_t bucket = *reinterpret_cast<size_t*>(block);
+  PerThreadPool* pool = PerThreadPool::Current();
+  if (pool && pool->Give(block, bucket))
+    return;
+  free(block);
+}
+
+}  // namespace net
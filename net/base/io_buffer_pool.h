@@ -0,0 +1,48 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_IO_BUFFER_POOL_H_
+#define NET_BASE_IO_BUFFER_POOL_H_
+#pragma once
+
+#include <stddef.h>
+
+#include "net/base/net_export.h"
+
+namespace net {
+
+// IOBufferPool recycles the data blocks backing IOBuffer and its subclasses.
+// A busy connection allocates and frees thousands of transient buffers per
+// second, enough that the global allocator's lock shows up in IO thread
+// profiles.  The pool keeps a per-thread, size-classed cache of recently
+// freed blocks, so steady-state network I/O mostly stops touching the global
+// allocator, and no locking is needed.  The cache is bounded by a high-water
+// mark; blocks freed past it are returned to the allocator.  Only threads
+// that run a MessageLoop cache blocks (the cache's lifetime is tied to the
+// loop's); on other threads Allocate() and Free() fall through to the
+// allocator.
+class NET_EXPORT_PRIVATE IOBufferPool {
+ public:
+  // Returns a block of at least |size| bytes, re-using a block cached on the
+  // current thread when one is available.  The block must be released with
+  // Free().
+  static char* Allocate(size_t size);
+
+  // Releases |data|, a pointer previously returned by Allocate().  The block
+  // is cached on the calling thread for re-use when possible, which need not
+  // be the thread it was allocated on.  |data| may be NULL.
+  static void Free(char* data);
+};
+
+// Adaptor allowing scoped_ptr_malloc to own a block from the pool.
+class IOBufferPoolFree {
+ public:
+  inline void operator()(void* ptr) const {
+    IOBufferPool::Free(static_cast<char*>(ptr));
+  }
+};
+
+}  // namespace net
+
+#endif  // NET_BASE_IO_BUFFER_POOL_H_
@@ -77,6 +77,10 @@ const unsigned kMaxCacheEntries = 256;
 // The number of seconds for which we'll cache a cache entry.
 const unsigned kTTLSecs = 1800;  // 30 minutes.
 
+// The default value of max_concurrent_verifications_.  Verifications beyond
+// this are queued; see MultiThreadedCertVerifier::StartQueuedJobs().
+const size_t kMaxConcurrentVerifications = 16;
+
 }  // namespace
 
 MultiThreadedCertVerifier::CachedResult::CachedResult() : error(ERR_FAILED) {}
@@ -262,6 +266,7 @@ class CertVerifierJob {
                   const BoundNetLog& net_log)
       : start_time_(base::TimeTicks::Now()),
         worker_(worker),
+        started_(false),
         net_log_(net_log) {
     scoped_refptr<NetLog::EventParameters> params(
         new X509CertificateNetLogParam(worker_->certificate()));
@@ -272,11 +277,25 @@ class CertVerifierJob {
     if (worker_) {
       net_log_.AddEvent(NetLog::TYPE_CANCELLED, NULL);
       net_log_.EndEvent(NetLog::TYPE_CERT_VERIFIER_JOB, NULL);
-      worker_->Cancel();
+      if (started_)
+        worker_->Cancel();
+      else
+        delete worker_;
       DeleteAllCanceled();
     }
   }
 
+  // Dispatches the verification to a worker thread.  On failure, the worker
+  // is destroyed and the job's requests must be failed by the caller.
+  bool Start() {
+    started_ = worker_->Start();
+    if (!started_) {
+      delete worker_;
+      worker_ = NULL;
+    }
+    return started_;
+  }
+
   void AddRequest(CertVerifierRequest* request) {
     request->net_log().AddEvent(
         NetLog::TYPE_CERT_VERIFIER_REQUEST_BOUND_TO_JOB,
@@ -324,11 +343,14 @@ class CertVerifierJob {
   const base::TimeTicks start_time_;
   std::vector<CertVerifierRequest*> requests_;
   CertVerifierWorker* worker_;
+  bool started_;
   const BoundNetLog net_log_;
 };
 
 MultiThreadedCertVerifier::MultiThreadedCertVerifier()
     : cache_(kMaxCacheEntries),
+      num_active_jobs_(0),
+      max_concurrent_verifications_(kMaxConcurrentVerifications),
       requests_(0),
       cache_hits_(0),
       inflight_joins_(0),
@@ -337,6 +359,8 @@ MultiThreadedCertVerifier::MultiThreadedCertVerifier()
 }
 
 MultiThreadedCertVerifier::~MultiThreadedCertVerifier() {
+  // Queued jobs are owned by |inflight_|, so just drop the queue.
+  queued_jobs_.clear();
   STLDeleteValues(&inflight_);
 
   CertDatabase::RemoveObserver(this);
@@ -387,13 +411,19 @@ int MultiThreadedCertVerifier::Verify(X509Certificate* cert,
     job = new CertVerifierJob(
         worker,
         BoundNetLog::Make(net_log.net_log(), NetLog::SOURCE_CERT_VERIFIER_JOB));
-    if (!worker->Start()) {
-      delete job;
-      delete worker;
-      *out_req = NULL;
-      // TODO(wtc): log to the NetLog.
-      LOG(ERROR) << "CertVerifierWorker couldn't be started.";
-      return ERR_INSUFFICIENT_RESOURCES;  // Just a guess.
+    if (num_active_jobs_ < max_concurrent_verifications_) {
+      if (!job->Start()) {
+        delete job;
+        *out_req = NULL;
+        // TODO(wtc): log to the NetLog.
+        LOG(ERROR) << "CertVerifierWorker couldn't be started.";
+        return ERR_INSUFFICIENT_RESOURCES;  // Just a guess.
+      }
+      num_active_jobs_++;
+    } else {
+      // The dispatch limit has been reached, so the job will start when a
+      // running verification finishes.
+      queued_jobs_.push_back(job);
     }
     inflight_.insert(std::make_pair(key, job));
   }
@@ -441,6 +471,45 @@ void MultiThreadedCertVerifier::HandleResult(
 
   job->HandleResult(cached_result);
   delete job;
+
+  DCHECK_GT(num_active_jobs_, 0u);
+  num_active_jobs_--;
+  StartQueuedJobs();
+}
+
+void MultiThreadedCertVerifier::set_max_concurrent_verifications(
+    size_t max_concurrent_verifications) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_GT(max_concurrent_verifications, 0u);
+
+  max_concurrent_verifications_ = max_concurrent_verifications;
+  StartQueuedJobs();
+}
+
+void MultiThreadedCertVerifier::StartQueuedJobs() {
+  while (num_active_jobs_ < max_concurrent_verifications_ &&
+         !queued_jobs_.empty()) {
+    CertVerifierJob* job = queued_jobs_.front();
+    queued_jobs_.pop_front();
+    if (job->Start()) {
+      num_active_jobs_++;
+      continue;
+    }
+
+    // The job could not be dispatched, so fail its requests.
+    LOG(ERROR) << "CertVerifierWorker couldn't be started.";
+    std::map<RequestParams, CertVerifierJob*>::iterator j;
+    for (j = inflight_.begin(); j != inflight_.end(); ++j) {
+      if (j->second == job) {
+        inflight_.erase(j);
+        break;
+      }
+    }
+    CachedResult cached_result;
+    cached_result.error = ERR_INSUFFICIENT_RESOURCES;
+    job->HandleResult(cached_result);
+    delete job;
+  }
 }
 
 void MultiThreadedCertVerifier::OnCertTrustChanged(
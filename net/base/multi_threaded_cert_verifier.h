@@ -6,6 +6,7 @@
 #define NET_BASE_MULTI_THREADED_CERT_VERIFIER_H_
 #pragma once
 
+#include <deque>
 #include <map>
 #include <string>
 
@@ -54,6 +55,16 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier :
 
   virtual void CancelRequest(CertVerifier::RequestHandle req) OVERRIDE;
 
+  // Configures how many verifications may be dispatched to worker threads at
+  // once.  Further jobs are queued and started as running ones finish.  This
+  // bounds contention on the underlying certificate library's locks when many
+  // distinct chains arrive at once (e.g. session restore).  Raising the limit
+  // starts queued jobs immediately.
+  void set_max_concurrent_verifications(size_t max_concurrent_verifications);
+  size_t max_concurrent_verifications() const {
+    return max_concurrent_verifications_;
+  }
+
  private:
   friend class CertVerifierWorker;  // Calls HandleResult.
   friend class CertVerifierRequest;
@@ -63,6 +74,7 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier :
   FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest, DifferentCACerts);
   FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest, InflightJoin);
   FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest, CancelRequest);
+  FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest, ConcurrencyLimit);
   FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest,
                            RequestParamsComparators);
 
@@ -118,12 +130,17 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier :
   // CertDatabase::Observer methods:
   virtual void OnCertTrustChanged(const X509Certificate* cert) OVERRIDE;
 
+  // Starts jobs from |queued_jobs_| while the number of running jobs is
+  // below |max_concurrent_verifications_|.
+  void StartQueuedJobs();
+
   // For unit testing.
   void ClearCache() { cache_.Clear(); }
   size_t GetCacheSize() const { return cache_.size(); }
   uint64 cache_hits() const { return cache_hits_; }
   uint64 requests() const { return requests_; }
   uint64 inflight_joins() const { return inflight_joins_; }
+  size_t queued_jobs() const { return queued_jobs_.size(); }
   void SetCertVerifyProc(CertVerifyProc* verify_proc);
 
   // cache_ maps from a request to a cached result.
@@ -134,6 +151,15 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier :
   // place.
   std::map<RequestParams, CertVerifierJob*> inflight_;
 
+  // Jobs waiting for a free verification slot, in FIFO order.  Each queued
+  // job is also in |inflight_|, which owns it.
+  std::deque<CertVerifierJob*> queued_jobs_;
+
+  // The number of jobs currently running on worker threads.
+  size_t num_active_jobs_;
+
+  size_t max_concurrent_verifications_;
+
   uint64 requests_;
   uint64 cache_hits_;
   uint64 inflight_joins_;
@@ -188,6 +188,47 @@ TEST_F(MultiThreadedCertVerifierTest, InflightJoin) {
   ASSERT_EQ(1u, verifier_.inflight_joins());
 }
 
+// Tests that verifications beyond the concurrency limit are queued and run
+// once a dispatched verification finishes.
+TEST_F(MultiThreadedCertVerifierTest, ConcurrencyLimit) {
+  FilePath certs_dir = GetTestCertsDirectory();
+  scoped_refptr<X509Certificate> test_cert(
+      ImportCertFromFile(certs_dir, "ok_cert.pem"));
+  ASSERT_NE(static_cast<X509Certificate*>(NULL), test_cert);
+
+  verifier_.set_max_concurrent_verifications(1);
+
+  int error;
+  CertVerifyResult verify_result;
+  TestCompletionCallback callback;
+  CertVerifier::RequestHandle request_handle;
+  CertVerifyResult verify_result2;
+  TestCompletionCallback callback2;
+  CertVerifier::RequestHandle request_handle2;
+
+  error = verifier_.Verify(test_cert, "www.example.com", 0, NULL,
+                           &verify_result, callback.callback(),
+                           &request_handle, BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  ASSERT_TRUE(request_handle != NULL);
+  // A request with different parameters cannot join the first job, and the
+  // only verification slot is taken, so its job must wait in the queue.
+  error = verifier_.Verify(test_cert, "www2.example.com", 0, NULL,
+                           &verify_result2, callback2.callback(),
+                           &request_handle2, BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  ASSERT_TRUE(request_handle2 != NULL);
+  ASSERT_EQ(1u, verifier_.queued_jobs());
+
+  error = callback.WaitForResult();
+  ASSERT_TRUE(IsCertificateError(error));
+  error = callback2.WaitForResult();
+  ASSERT_TRUE(IsCertificateError(error));
+  ASSERT_EQ(0u, verifier_.queued_jobs());
+  ASSERT_EQ(2u, verifier_.requests());
+  ASSERT_EQ(0u, verifier_.inflight_joins());
+}
+
 // Tests that the callback of a canceled request is never made.
 TEST_F(MultiThreadedCertVerifierTest, CancelRequest) {
   FilePath certs_dir = GetTestCertsDirectory();
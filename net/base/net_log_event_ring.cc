@@ -0,0 +1,76 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/net_log_event_ring.h"
+
+#include "base/logging.h"
+
+namespace net {
+
+NetLogEventRing::Entry::Entry()
+    : type(NetLog::TYPE_CANCELLED),
+      phase(NetLog::PHASE_NONE) {
+}
+
+NetLogEventRing::NetLogEventRing(size_t capacity)
+    : capacity_(capacity),
+      slots_(new Slot[capacity]),
+      next_sequence_(0) {
+  // The capacity must be a power of two so slot selection can use a mask
+  // rather than a division.
+  DCHECK_GT(capacity, 0u);
+  DCHECK_EQ(0u, capacity & (capacity - 1));
+}
+
+NetLogEventRing::~NetLogEventRing() {
+}
+
+void NetLogEventRing::Add(NetLog::EventType type,
+                          const base::TimeTicks& time,
+                          const NetLog::Source& source,
+                          NetLog::EventPhase phase) {
+  base::subtle::Atomic32 sequence =
+      base::subtle::NoBarrier_AtomicIncrement(&next_sequence_, 1);
+  Slot* slot = &slots_[(sequence - 1) & (capacity_ - 1)];
+
+  // Mark the slot invalid before touching the payload, so a concurrent
+  // snapshot can't pair the old sequence number with the new payload.  The
+  // release semantics order the store before the payload writes as seen by
+  // an acquiring reader.
+  base::subtle::Release_Store(&slot->sequence, 0);
+  base::subtle::MemoryBarrier();
+
+  slot->entry.type = type;
+  slot->entry.time = time;
+  slot->entry.source = source;
+  slot->entry.phase = phase;
+
+  // Publish the payload.
+  base::subtle::Release_Store(&slot->sequence, sequence);
+}
+
+void NetLogEventRing::GetEntries(std::vector<Entry>* entries) const {
+  base::subtle::Atomic32 end =
+      base::subtle::Acquire_Load(&next_sequence_);
+  base::subtle::Atomic32 begin = 1;
+  if (end > static_cast<base::subtle::Atomic32>(capacity_))
+    begin = end - capacity_ + 1;
+
+  for (base::subtle::Atomic32 sequence = begin; sequence <= end; ++sequence) {
+    const Slot* slot = &slots_[(sequence - 1) & (capacity_ - 1)];
+
+    if (base::subtle::Acquire_Load(&slot->sequence) != sequence)
+      continue;
+    Entry entry = slot->entry;
+    // Re-check after the copy; if a writer got in between, the copy may be
+    // torn, so drop it.
+    base::subtle::MemoryBarrier();
+    if (base::subtle::NoBarrier_Load(&slot->sequence) != sequence)
+      continue;
+
+    entries->push_back(entry);
+  }
+}
+
+}  // namespace net
@@ -0,0 +1,89 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_NET_LOG_EVENT_RING_H_
+#define NET_BASE_NET_LOG_EVENT_RING_H_
+#pragma once
+
+#include <vector>
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/time.h"
+#include "net/base/net_export.h"
+#include "net/base/net_log.h"
+
+namespace net {
+
+// NetLogEventRing is a bounded ring buffer that records the most recent
+// NetLog events without taking a lock.  It is intended for always-on capture
+// on performance critical threads: Add() costs one atomic increment plus a
+// few plain stores, regardless of how many readers there are.
+//
+// Event parameters are deliberately not captured.  Keeping the slots free of
+// pointers and reference counts is what allows writers to overwrite them
+// without any synchronization.
+//
+// Consistency is verified per-slot with a sequence number, written after the
+// payload.  If the ring laps a slot while a snapshot is copying it, the
+// snapshot simply drops that entry.  If the ring laps a slot while another
+// writer is still filling it in (which requires |capacity| events to be
+// logged during a single Add() call), a garbled entry may be reported; with
+// thousands of slots this is vanishingly rare, and harmless for a diagnostic
+// log.
+class NET_EXPORT NetLogEventRing {
+ public:
+  // A recorded event, minus its parameters.
+  struct NET_EXPORT Entry {
+    Entry();
+
+    NetLog::EventType type;
+    base::TimeTicks time;
+    NetLog::Source source;
+    NetLog::EventPhase phase;
+  };
+
+  // Constructs a ring holding the last |capacity| events.  |capacity| must be
+  // a power of two.
+  explicit NetLogEventRing(size_t capacity);
+  ~NetLogEventRing();
+
+  // Records an event.  Safe to call from any thread, and never blocks.
+  void Add(NetLog::EventType type,
+           const base::TimeTicks& time,
+           const NetLog::Source& source,
+           NetLog::EventPhase phase);
+
+  // Appends a snapshot of the recorded events to |entries|, oldest first.
+  // Safe to call from any thread.  Entries that are overwritten while the
+  // snapshot is being taken are skipped.
+  void GetEntries(std::vector<Entry>* entries) const;
+
+ private:
+  struct Slot {
+    Slot() : sequence(0) {}
+
+    // The 1-based sequence number of the event stored in this slot, or 0 if
+    // the slot is empty or currently being written.  Written with release
+    // semantics after the payload, so a reader that sees the same non-zero
+    // value before and after copying the payload got a consistent copy.
+    base::subtle::Atomic32 sequence;
+
+    Entry entry;
+  };
+
+  const size_t capacity_;
+  const scoped_array<Slot> slots_;
+
+  // Sequence number to assign to the next event.  Also identifies which slot
+  // the event lands in: (sequence - 1) % |capacity_|.
+  base::subtle::Atomic32 next_sequence_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetLogEventRing);
+};
+
+}  // namespace net
+
+#endif  // NET_BASE_NET_LOG_EVENT_RING_H_
@@ -35,6 +35,7 @@
 #include "base/json/string_escape.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/memory/mru_cache.h"
 #include "base/memory/singleton.h"
 #include "base/message_loop.h"
 #include "base/metrics/histogram.h"
@@ -649,6 +650,119 @@ void LimitOffsets(const string16& str,
   }
 }
 
+// Memo of recent host-to-IDN conversions. The omnibox re-formats the same
+// URLs on every keystroke to repaint its dropdown, and each conversion runs
+// ICU's IDN transform plus per-component script-safety checks. Keyed by both
+// the host and |languages| since the safety check depends on the accepted
+// languages. Conversions can be requested from several threads, hence the
+// lock.
+class IDNConversionCache {
+ public:
+  IDNConversionCache() : cache_(kMaxEntries) {}
+
+  bool Lookup(const std::string& host,
+              const std::string& languages,
+              string16* result) {
+    base::AutoLock lock(lock_);
+    CacheType::iterator it = cache_.Get(MakeKey(host, languages));
+    if (it == cache_.end())
+      return false;
+    *result = it->second;
+    return true;
+  }
+
+  void Store(const std::string& host,
+             const std::string& languages,
+             const string16& result) {
+    base::AutoLock lock(lock_);
+    cache_.Put(MakeKey(host, languages), result);
+  }
+
+ private:
+  typedef base::HashingMRUCache<std::string, string16> CacheType;
+
+  static const size_t kMaxEntries = 256;
+
+  static std::string MakeKey(const std::string& host,
+                             const std::string& languages) {
+    // '\n' cannot appear in a canonicalized host or a language list, so the
+    // concatenation is unambiguous.
+    return host + '\n' + languages;
+  }
+
+  base::Lock lock_;
+  CacheType cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(IDNConversionCache);
+};
+
+base::LazyInstance<IDNConversionCache>::Leaky g_idn_conversion_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+// A formatted URL together with the out-parameters FormatUrl() produced
+// alongside it.
+struct FormatUrlResult {
+  FormatUrlResult() : prefix_end(0) {}
+
+  string16 text;
+  url_parse::Parsed parsed;
+  size_t prefix_end;
+};
+
+// Memo of complete FormatUrl() results, keyed by everything the output
+// depends on. Offset adjustment depends on caller-supplied positions and so
+// cannot be replayed from a cached entry; FormatUrl() only consults the cache
+// when no adjustment was requested.
+class FormatUrlCache {
+ public:
+  FormatUrlCache() : cache_(kMaxEntries) {}
+
+  bool Lookup(const std::string& spec,
+              const std::string& languages,
+              FormatUrlTypes format_types,
+              UnescapeRule::Type unescape_rules,
+              FormatUrlResult* result) {
+    base::AutoLock lock(lock_);
+    CacheType::iterator it =
+        cache_.Get(MakeKey(spec, languages, format_types, unescape_rules));
+    if (it == cache_.end())
+      return false;
+    *result = it->second;
+    return true;
+  }
+
+  void Store(const std::string& spec,
+             const std::string& languages,
+             FormatUrlTypes format_types,
+             UnescapeRule::Type unescape_rules,
+             const FormatUrlResult& result) {
+    base::AutoLock lock(lock_);
+    cache_.Put(MakeKey(spec, languages, format_types, unescape_rules),
+               result);
+  }
+
+ private:
+  typedef base::HashingMRUCache<std::string, FormatUrlResult> CacheType;
+
+  static const size_t kMaxEntries = 64;
+
+  static std::string MakeKey(const std::string& spec,
+                             const std::string& languages,
+                             FormatUrlTypes format_types,
+                             UnescapeRule::Type unescape_rules) {
+    return spec + '\n' + languages +
+        base::StringPrintf("\n%u\n%u", format_types, unescape_rules);
+  }
+
+  base::Lock lock_;
+  CacheType cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(FormatUrlCache);
+};
+
+base::LazyInstance<FormatUrlCache>::Leaky g_format_url_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
 // TODO(brettw) bug 734373: check the scripts for each host component and
 // don't un-IDN-ize if there is more than one. Alternatively, only IDN for
 // scripts that the user has installed. For now, just put the entire
@@ -659,6 +773,13 @@ void LimitOffsets(const string16& str,
 string16 IDNToUnicodeWithOffsets(const std::string& host,
                                  const std::string& languages,
                                  std::vector<size_t>* offsets_for_adjustment) {
+  // Results that carry offset adjustments cannot be served from the memo.
+  if (!offsets_for_adjustment) {
+    string16 cached;
+    if (g_idn_conversion_cache.Get().Lookup(host, languages, &cached))
+      return cached;
+  }
+
   // Convert the ASCII input to a string16 for ICU.
   string16 input16;
   input16.reserve(host.length());
@@ -699,6 +820,8 @@ string16 IDNToUnicodeWithOffsets(const std::string& host,
   }
 
   LimitOffsets(out16, offsets_for_adjustment);
+  if (!offsets_for_adjustment)
+    g_idn_conversion_cache.Get().Store(host, languages, out16);
   return out16;
 }
 
@@ -1887,13 +2010,31 @@ string16 FormatUrl(const GURL& url,
                    url_parse::Parsed* new_parsed,
                    size_t* prefix_end,
                    size_t* offset_for_adjustment) {
+  // Without an offset to adjust, the result depends only on the URL and the
+  // formatting arguments, so recent results can be reused. The omnibox
+  // formats the same URLs repeatedly while the user types.
+  if (!offset_for_adjustment) {
+    const std::string& spec = url.possibly_invalid_spec();
+    FormatUrlResult result;
+    if (!g_format_url_cache.Get().Lookup(spec, languages, format_types,
+                                         unescape_rules, &result)) {
+      result.text = FormatUrlWithOffsets(url, languages, format_types,
+          unescape_rules, &result.parsed, &result.prefix_end, NULL);
+      g_format_url_cache.Get().Store(spec, languages, format_types,
+                                     unescape_rules, result);
+    }
+    if (new_parsed)
+      *new_parsed = result.parsed;
+    if (prefix_end)
+      *prefix_end = result.prefix_end;
+    return result.text;
+  }
+
   std::vector<size_t> offsets;
-  if (offset_for_adjustment)
-    offsets.push_back(*offset_for_adjustment);
+  offsets.push_back(*offset_for_adjustment);
   string16 result = FormatUrlWithOffsets(url, languages, format_types,
       unescape_rules, new_parsed, prefix_end, &offsets);
-  if (offset_for_adjustment)
-    *offset_for_adjustment = offsets[0];
+  *offset_for_adjustment = offsets[0];
   return result;
 }
 
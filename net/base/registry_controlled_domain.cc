@@ -45,8 +45,11 @@
 
 #include "net/base/registry_controlled_domain.h"
 
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/memory/mru_cache.h"
 #include "base/string_util.h"
+#include "base/synchronization/lock.h"
 #include "base/utf_string_conversions.h"
 #include "googleurl/src/gurl.h"
 #include "googleurl/src/url_parse.h"
@@ -62,6 +65,55 @@ namespace {
 const int kExceptionRule = 1;
 const int kWildcardRule = 2;
 
+// A memoized registry length, always computed as if unknown registries were
+// allowed.  When |found_rule| is false no rule matched, and callers that
+// disallow unknown registries should treat the length as 0.
+struct RegistryLengthResult {
+  size_t registry_length;
+  bool found_rule;
+};
+
+// CookieMonster consults the registry for every cookie operation, and a page
+// load tends to touch the same few hosts over and over, so recent results are
+// memoized by host.  The static entry points can be called from any thread,
+// hence the lock.
+class RegistryLengthCache {
+ public:
+  RegistryLengthCache() : cache_(kMaxCacheSize) {}
+
+  bool Lookup(const std::string& host, RegistryLengthResult* result) {
+    base::AutoLock lock(lock_);
+    CacheType::iterator it = cache_.Get(host);
+    if (it == cache_.end())
+      return false;
+    *result = it->second;
+    return true;
+  }
+
+  void Store(const std::string& host, const RegistryLengthResult& result) {
+    base::AutoLock lock(lock_);
+    cache_.Put(host, result);
+  }
+
+  void Clear() {
+    base::AutoLock lock(lock_);
+    cache_.Clear();
+  }
+
+ private:
+  typedef base::HashingMRUCache<std::string, RegistryLengthResult> CacheType;
+
+  static const size_t kMaxCacheSize = 128;
+
+  base::Lock lock_;
+  CacheType cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(RegistryLengthCache);
+};
+
+static base::LazyInstance<RegistryLengthCache>::Leaky
+    g_registry_length_cache = LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 RegistryControlledDomainService::FindDomainPtr
@@ -143,6 +195,8 @@ size_t RegistryControlledDomainService::GetRegistryLength(
 void RegistryControlledDomainService::UseFindDomainFunction(
     FindDomainPtr function) {
   find_domain_function_ = function ? function : Perfect_Hash::FindDomain;
+  // Memoized results computed with the old function are now stale.
+  g_registry_length_cache.Get().Clear();
 }
 
 // static
@@ -177,6 +231,26 @@ size_t RegistryControlledDomainService::GetRegistryLengthImpl(
     bool allow_unknown_registries) {
   DCHECK(!host.empty());
 
+  // The rule walk does not depend on |allow_unknown_registries| until no rule
+  // is found, so one memoized entry per host serves both callers.
+  RegistryLengthResult result;
+  RegistryLengthCache& cache = g_registry_length_cache.Get();
+  if (!cache.Lookup(host, &result)) {
+    result.registry_length = GetRegistryLengthUncached(host,
+                                                       &result.found_rule);
+    cache.Store(host, result);
+  }
+  if (!result.found_rule && !allow_unknown_registries)
+    return 0;
+  return result.registry_length;
+}
+
+// static
+size_t RegistryControlledDomainService::GetRegistryLengthUncached(
+    const std::string& host,
+    bool* found_rule) {
+  *found_rule = true;
+
   // Skip leading dots.
   const size_t host_check_begin = host.find_first_not_of('.');
   if (host_check_begin == std::string::npos)
@@ -246,9 +320,11 @@ size_t RegistryControlledDomainService::GetRegistryLengthImpl(
   }
 
   // No rule found in the registry.  curr_start now points to the first
-  // character of the last subcomponent of the host, so if we allow unknown
-  // registries, return the length of this subcomponent.
-  return allow_unknown_registries ? (host.length() - curr_start) : 0;
+  // character of the last subcomponent of the host, so return the length of
+  // this subcomponent; GetRegistryLengthImpl maps it to 0 for callers that
+  // disallow unknown registries.
+  *found_rule = false;
+  return host.length() - curr_start;
 }
 
 }  // namespace net
@@ -200,6 +200,13 @@ class NET_EXPORT RegistryControlledDomainService {
   static size_t GetRegistryLengthImpl(const std::string& host,
                                       bool allow_unknown_registries);
 
+  // Walks the effective-TLD rules for |host| as if unknown registries were
+  // allowed.  Sets |*found_rule| to false when no rule matched, in which case
+  // the returned length is that of the last subcomponent and callers that
+  // disallow unknown registries should treat it as 0.
+  static size_t GetRegistryLengthUncached(const std::string& host,
+                                          bool* found_rule);
+
   typedef const struct DomainRule* (*FindDomainPtr)(const char *, unsigned int);
 
   // Used for unit tests, so that a different perfect hash map from the full
@@ -142,6 +142,10 @@ static const char* kDecompressionErrorHtml =
   "<head><META HTTP-EQUIV=\"Refresh\" CONTENT=\"0\"></head>";
 #endif
 
+bool SdchFilter::IsPassThrough() const {
+  return decoding_status_ == PASS_THROUGH && dest_buffer_excess_.empty();
+}
+
 Filter::FilterStatus SdchFilter::ReadFilteredData(char* dest_buffer,
                                                   int* dest_len) {
   int available_space = *dest_len;
@@ -44,6 +44,10 @@ class NET_EXPORT_PRIVATE SdchFilter : public Filter {
   virtual FilterStatus ReadFilteredData(char* dest_buffer,
                                         int* dest_len) OVERRIDE;
 
+  // Returns true once non-sdch content is being passed through unaltered and
+  // all previously decoded output has been emitted.
+  virtual bool IsPassThrough() const OVERRIDE;
+
  private:
   // Internal status.  Once we enter an error state, we stop processing data.
   enum DecodingStatus {
@@ -162,8 +162,9 @@ void TCPListenSocket::SendInternal(const char* bytes, int len) {
 }
 
 void TCPListenSocket::Listen() {
-  int backlog = 10;  // TODO(erikkay): maybe don't allow any backlog?
-  listen(socket_, backlog);
+  // Use the largest backlog the system allows; a small backlog drops
+  // connections during accept bursts.
+  listen(socket_, SOMAXCONN);
   // TODO(erikkay): error handling
 #if defined(OS_POSIX)
   WatchSocket(WAITING_ACCEPT);
@@ -171,8 +172,15 @@ void TCPListenSocket::Listen() {
 }
 
 void TCPListenSocket::Accept() {
-  SOCKET conn = Accept(socket_);
-  if (conn != kInvalidSocket) {
+  // A single readiness notification may cover several pending connections,
+  // so drain the backlog rather than accepting one connection per callback.
+  while (true) {
+    SOCKET conn = Accept(socket_);
+    if (conn == kInvalidSocket) {
+      // No more pending connections (or an error occurred).
+      // TODO(ibrar): some error handling required here
+      break;
+    }
     scoped_refptr<TCPListenSocket> sock(
         new TCPListenSocket(conn, socket_delegate_));
     // it's up to the delegate to AddRef if it wants to keep it around
@@ -180,8 +188,6 @@ void TCPListenSocket::Accept() {
     sock->WatchSocket(WAITING_READ);
 #endif
     socket_delegate_->DidAccept(this, sock);
-  } else {
-    // TODO(ibrar): some error handling required here
   }
 }
 
@@ -31,6 +31,8 @@ void OnGetContentLengthComplete(
 
 UploadData::Element::Element()
     : type_(TYPE_BYTES),
+      shared_bytes_(NULL),
+      shared_bytes_length_(0),
       file_range_offset_(0),
       file_range_length_(kuint64max),
       is_last_chunk_(false),
@@ -54,6 +56,7 @@ UploadData::Element::~Element() {
 void UploadData::Element::SetToChunk(const char* bytes,
                                      int bytes_len,
                                      bool is_last_chunk) {
+  shared_bytes_ = NULL;
   bytes_.clear();
   bytes_.insert(bytes_.end(), bytes, bytes + bytes_len);
   type_ = TYPE_CHUNK;
@@ -65,7 +68,7 @@ uint64 UploadData::Element::GetContentLength() {
     return content_length_;
 
   if (type_ == TYPE_BYTES || type_ == TYPE_CHUNK)
-    return static_cast<uint64>(bytes_.size());
+    return static_cast<uint64>(bytes_length());
   else if (type_ == TYPE_BLOB)
     // The blob reference will be resolved later.
     return 0;
@@ -145,11 +148,10 @@ int UploadData::Element::ReadFromMemorySync(char* buf, int buf_len) {
   const size_t num_bytes_to_read = std::min(BytesRemaining(),
                                             static_cast<uint64>(buf_len));
 
-  // Check if we have anything to copy first, because we are getting
-  // the address of an element in |bytes_| and that will throw an
-  // exception if |bytes_| is an empty vector.
+  // Check if we have anything to copy first, because bytes_start() returns
+  // NULL for an empty element.
   if (num_bytes_to_read > 0) {
-    memcpy(buf, &bytes_[offset_], num_bytes_to_read);
+    memcpy(buf, bytes_start() + offset_, num_bytes_to_read);
   }
 
   offset_ += num_bytes_to_read;
@@ -6,6 +6,8 @@
 #define NET_BASE_UPLOAD_DATA_H_
 #pragma once
 
+#include <string.h>
+
 #include <vector>
 
 #include "base/basictypes.h"
@@ -67,6 +69,19 @@ class NET_EXPORT UploadData
     }
 
     const std::vector<char>& bytes() const { return bytes_; }
+
+    // The bytes of a TYPE_BYTES or TYPE_CHUNK element, regardless of whether
+    // this element owns them or shares them with another object. May return
+    // NULL if the element is empty.
+    const char* bytes_start() const {
+      if (shared_bytes_)
+        return shared_bytes_;
+      return bytes_.empty() ? NULL : &bytes_[0];
+    }
+    size_t bytes_length() const {
+      return shared_bytes_ ? shared_bytes_length_ : bytes_.size();
+    }
+
     const FilePath& file_path() const { return file_path_; }
     uint64 file_range_offset() const { return file_range_offset_; }
     uint64 file_range_length() const { return file_range_length_; }
@@ -78,9 +93,21 @@ class NET_EXPORT UploadData
 
     void SetToBytes(const char* bytes, int bytes_len) {
       type_ = TYPE_BYTES;
+      shared_bytes_ = NULL;
       bytes_.assign(bytes, bytes + bytes_len);
     }
 
+    // Sets the element to reference bytes owned by somebody else, without
+    // copying them. The caller must ensure that the data outlives this
+    // element, for example by attaching the owning object to the UploadData
+    // with SetUserData().
+    void SetToSharedBytes(const char* bytes, int bytes_len) {
+      type_ = TYPE_BYTES;
+      bytes_.clear();
+      shared_bytes_ = bytes;
+      shared_bytes_length_ = bytes_len;
+    }
+
     void SetToFilePath(const FilePath& path) {
       SetToFilePathRange(path, 0, kuint64max, base::Time());
     }
@@ -153,6 +180,9 @@ class NET_EXPORT UploadData
 
     Type type_;
     std::vector<char> bytes_;
+    // Non-NULL when the bytes are shared rather than stored in |bytes_|.
+    const char* shared_bytes_;
+    size_t shared_bytes_length_;
     FilePath file_path_;
     uint64 file_range_offset_;
     uint64 file_range_length_;
@@ -260,8 +290,12 @@ inline bool operator==(const UploadData::Element& a,
                        const UploadData::Element& b) {
   if (a.type() != b.type())
     return false;
-  if (a.type() == UploadData::TYPE_BYTES)
-    return a.bytes() == b.bytes();
+  if (a.type() == UploadData::TYPE_BYTES) {
+    if (a.bytes_length() != b.bytes_length())
+      return false;
+    return a.bytes_length() == 0 ||
+           memcmp(a.bytes_start(), b.bytes_start(), a.bytes_length()) == 0;
+  }
   if (a.type() == UploadData::TYPE_FILE) {
     return a.file_path() == b.file_path() &&
            a.file_range_offset() == b.file_range_offset() &&
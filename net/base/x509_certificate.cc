@@ -14,6 +14,7 @@
 #include "base/base64.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/memory/mru_cache.h"
 #include "base/memory/singleton.h"
 #include "base/metrics/histogram.h"
 #include "base/pickle.h"
@@ -198,6 +199,68 @@ void RemoveFromCache(X509Certificate::OSCertHandle cert_handle) {
 #endif
 }
 
+// An intern pool for fully-constructed certificate objects, keyed by the
+// concatenated SHA-1 digests of every certificate in the chain.  While the
+// handle cache above deduplicates the underlying OS handles, each connection
+// still pays to re-create the X509Certificate wrapper and re-derive its
+// parsed fields; during session restore the same CDN chain can be handed to
+// us dozens of times in quick succession.  The pool holds strong references
+// and evicts the least-recently interned chains beyond |kMaxInternedChains|.
+class X509CertificateInternPool {
+ public:
+  // Returns the interned certificate for |chain_key|, or NULL if the chain
+  // has not been seen recently.
+  scoped_refptr<X509Certificate> Find(const std::string& chain_key) {
+    base::AutoLock lock(lock_);
+    ChainMap::iterator pos = chains_.Get(chain_key);
+    if (pos == chains_.end())
+      return NULL;
+    return pos->second;
+  }
+
+  void Insert(const std::string& chain_key, X509Certificate* cert) {
+    base::AutoLock lock(lock_);
+    chains_.Put(chain_key, make_scoped_refptr(cert));
+  }
+
+ private:
+  enum { kMaxInternedChains = 256 };
+
+  typedef base::MRUCache<std::string, scoped_refptr<X509Certificate> >
+      ChainMap;
+
+  // Obtain an instance of X509CertificateInternPool via a LazyInstance.
+  X509CertificateInternPool() : chains_(kMaxInternedChains) {}
+  ~X509CertificateInternPool() {}
+  friend struct base::DefaultLazyInstanceTraits<X509CertificateInternPool>;
+
+  // You must acquire this lock before using |chains_|.  You must not block
+  // while holding this lock.
+  base::Lock lock_;
+  ChainMap chains_;
+
+  DISALLOW_COPY_AND_ASSIGN(X509CertificateInternPool);
+};
+
+base::LazyInstance<X509CertificateInternPool>::Leaky
+    g_x509_certificate_intern_pool = LAZY_INSTANCE_INITIALIZER;
+
+// Computes the intern pool key for |der_certs|: the SHA-1 digest of each
+// certificate in chain order, concatenated.
+std::string ComputeChainInternKey(
+    const std::vector<base::StringPiece>& der_certs) {
+  std::string key;
+  key.reserve(der_certs.size() * base::kSHA1Length);
+  for (size_t i = 0; i < der_certs.size(); ++i) {
+    unsigned char digest[base::kSHA1Length];
+    base::SHA1HashBytes(
+        reinterpret_cast<const unsigned char*>(der_certs[i].data()),
+        der_certs[i].size(), digest);
+    key.append(reinterpret_cast<const char*>(digest), sizeof(digest));
+  }
+  return key;
+}
+
 // Utility to split |src| on the first occurrence of |c|, if any. |right| will
 // either be empty if |c| was not found, or will contain the remainder of the
 // string including the split character itself.
@@ -259,6 +322,14 @@ X509Certificate* X509Certificate::CreateFromDERCertChain(
   if (der_certs.empty())
     return NULL;
 
+  // Serve repeated chains from the intern pool; the pool keeps the returned
+  // object alive, so the caller can take its own reference as usual.
+  const std::string intern_key = ComputeChainInternKey(der_certs);
+  scoped_refptr<X509Certificate> interned =
+      g_x509_certificate_intern_pool.Pointer()->Find(intern_key);
+  if (interned)
+    return interned.get();
+
   X509Certificate::OSCertHandles intermediate_ca_certs;
   for (size_t i = 1; i < der_certs.size(); i++) {
     OSCertHandle handle = CreateOSCertHandleFromBytes(
@@ -279,6 +350,7 @@ X509Certificate* X509Certificate::CreateFromDERCertChain(
   if (handle) {
     cert = CreateFromHandle(handle, intermediate_ca_certs);
     FreeOSCertHandle(handle);
+    g_x509_certificate_intern_pool.Pointer()->Insert(intern_key, cert);
   }
 
   for (size_t i = 0; i < intermediate_ca_certs.size(); i++)
@@ -484,6 +556,11 @@ void X509Certificate::Persist(Pickle* pickle) {
 }
 
 void X509Certificate::GetDNSNames(std::vector<std::string>* dns_names) const {
+  if (!dns_names_.empty()) {
+    *dns_names = dns_names_;
+    return;
+  }
+  // Certificates constructed without an OS handle have no precomputed list.
   GetSubjectAltName(dns_names, NULL);
   if (dns_names->empty())
     dns_names->push_back(subject_.common_name);
@@ -685,6 +762,12 @@ X509Certificate::X509Certificate(OSCertHandle cert_handle,
   }
   // Platform-specific initialization.
   Initialize();
+  // Precompute the subjectAltName DNS names so that shared (interned)
+  // certificates serve GetDNSNames() without re-walking the extension on
+  // every hostname verification.
+  GetSubjectAltName(&dns_names_, NULL);
+  if (dns_names_.empty())
+    dns_names_.push_back(subject_.common_name);
 }
 
 X509Certificate::~X509Certificate() {
@@ -157,6 +157,10 @@ class NET_EXPORT X509Certificate
   // handle is returned. The other certificates in the chain are intermediate
   // certificates. The returned pointer must be stored in a
   // scoped_refptr<X509Certificate>.
+  //
+  // Identical chains are interned: repeated calls with the same DER data
+  // return a shared certificate object whose fingerprints and parsed fields
+  // were computed the first time the chain was seen.
   static X509Certificate* CreateFromDERCertChain(
       const std::vector<base::StringPiece>& der_certs);
 
@@ -504,6 +508,12 @@ class NET_EXPORT X509Certificate
   // The serial number of this certificate, DER encoded.
   std::string serial_number_;
 
+  // The DNS names from the subjectAltName extension, or the subject common
+  // name if the extension was absent.  Precomputed at construction so shared
+  // certificates can serve GetDNSNames() without reparsing.  Empty for
+  // certificates constructed without an OS handle.
+  std::vector<std::string> dns_names_;
+
   // A handle to the certificate object in the underlying crypto library.
   OSCertHandle cert_handle_;
 
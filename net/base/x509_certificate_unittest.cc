@@ -568,6 +568,34 @@ TEST(X509CertificateTest, Cache) {
       cert3->GetIntermediateCertificates().size());
 }
 
+// Tests the certificate intern pool via CreateFromDERCertChain.  Repeated
+// calls with identical DER chains should return the same shared object.
+TEST(X509CertificateTest, InternPool) {
+  std::vector<base::StringPiece> chain;
+  chain.push_back(base::StringPiece(
+      reinterpret_cast<const char*>(google_der), sizeof(google_der)));
+  chain.push_back(base::StringPiece(
+      reinterpret_cast<const char*>(thawte_der), sizeof(thawte_der)));
+
+  scoped_refptr<X509Certificate> cert1(
+      X509Certificate::CreateFromDERCertChain(chain));
+  ASSERT_NE(static_cast<X509Certificate*>(NULL), cert1.get());
+  scoped_refptr<X509Certificate> cert2(
+      X509Certificate::CreateFromDERCertChain(chain));
+  ASSERT_NE(static_cast<X509Certificate*>(NULL), cert2.get());
+
+  // The identical chain is interned, so the very same object comes back.
+  EXPECT_EQ(cert1.get(), cert2.get());
+
+  // A different chain (leaf only) must not be conflated with the full one.
+  chain.resize(1);
+  scoped_refptr<X509Certificate> cert3(
+      X509Certificate::CreateFromDERCertChain(chain));
+  ASSERT_NE(static_cast<X509Certificate*>(NULL), cert3.get());
+  EXPECT_NE(cert1.get(), cert3.get());
+  EXPECT_EQ(0u, cert3->GetIntermediateCertificates().size());
+}
+
 TEST(X509CertificateTest, Pickle) {
   X509Certificate::OSCertHandle google_cert_handle =
       X509Certificate::CreateOSCertHandleFromBytes(
@@ -358,6 +358,22 @@ void BuildCookieInfoList(const CanonicalCookieVector& cookies,
 
 }  // namespace
 
+// Snapshot of the cookies stored under a single eTLD+1 key.  A snapshot is
+// built under |lock_| and never modified afterwards, so readers holding a
+// reference may inspect it without the lock; see GetCookiesWithOptions().
+struct CookieMonster::KeySnapshot
+    : public base::RefCountedThreadSafe<CookieMonster::KeySnapshot> {
+  KeySnapshot() {}
+
+  CookieList cookies;
+
+ private:
+  friend class base::RefCountedThreadSafe<KeySnapshot>;
+  ~KeySnapshot() {}
+
+  DISALLOW_COPY_AND_ASSIGN(KeySnapshot);
+};
+
 // static
 bool CookieMonster::enable_file_scheme_ = false;
 
@@ -1405,18 +1421,33 @@ bool CookieMonster::SetCookieWithOptions(const GURL& url,
 
 std::string CookieMonster::GetCookiesWithOptions(const GURL& url,
                                                  const CookieOptions& options) {
-  base::AutoLock autolock(lock_);
-
-  if (!HasCookieableScheme(url))
-    return std::string();
-
   TimeTicks start_time(TimeTicks::Now());
 
-  std::vector<CanonicalCookie*> cookies;
-  FindCookiesForHostAndDomain(url, options, true, &cookies);
-  std::sort(cookies.begin(), cookies.end(), CookieSorter);
+  // Common case: serve the request from a shared snapshot of this eTLD+1
+  // bucket, so that concurrent readers only hold |lock_| long enough to grab
+  // a reference.  The snapshot cannot be used when the bucket needs
+  // maintenance (an expired cookie to delete, or a last access time to
+  // refresh), as those updates must happen under the lock.
+  scoped_refptr<KeySnapshot> snapshot;
+  {
+    base::AutoLock autolock(lock_);
+    if (!HasCookieableScheme(url))
+      return std::string();
+    snapshot = GetSnapshotForKey(GetKey(url.host()));
+  }
 
-  std::string cookie_line = BuildCookieLine(cookies);
+  std::string cookie_line;
+  std::vector<CanonicalCookie*> cookies;
+  if (FindCookiesInSnapshot(snapshot.get(), url, options, &cookies)) {
+    std::sort(cookies.begin(), cookies.end(), CookieSorter);
+    cookie_line = BuildCookieLine(cookies);
+  } else {
+    base::AutoLock autolock(lock_);
+    cookies.clear();
+    FindCookiesForHostAndDomain(url, options, true, &cookies);
+    std::sort(cookies.begin(), cookies.end(), CookieSorter);
+    cookie_line = BuildCookieLine(cookies);
+  }
 
   histogram_time_get_->AddTime(TimeTicks::Now() - start_time);
 
@@ -1826,6 +1857,70 @@ void CookieMonster::FindCookiesForKey(
   }
 }
 
+bool CookieMonster::FindCookiesInSnapshot(
+    KeySnapshot* snapshot,
+    const GURL& url,
+    const CookieOptions& options,
+    std::vector<CanonicalCookie*>* cookies) {
+  const std::string scheme(url.scheme());
+  const std::string host(url.host());
+  bool secure = url.SchemeIsSecure();
+  Time current(Time::Now());
+
+  for (CookieList::iterator it = snapshot->cookies.begin();
+       it != snapshot->cookies.end(); ++it) {
+    CanonicalCookie* cc = &*it;
+
+    // An expired cookie must be deleted from the store, which requires the
+    // lock; send the caller down the slow path.
+    if (cc->IsExpired(current) && !keep_expired_cookies_)
+      return false;
+
+    if (options.exclude_httponly() && cc->IsHttpOnly())
+      continue;
+
+    if (!secure && cc->IsSecure())
+      continue;
+
+    if (!cc->IsDomainMatch(scheme, host))
+      continue;
+
+    if (!cc->IsOnPath(url.path()))
+      continue;
+
+    // A stale last access time must be refreshed under the lock (see
+    // InternalUpdateCookieAccessTime); send the caller down the slow path.
+    if (current - cc->LastAccessDate() >= last_access_threshold_)
+      return false;
+
+    cookies->push_back(cc);
+  }
+  return true;
+}
+
+scoped_refptr<CookieMonster::KeySnapshot> CookieMonster::GetSnapshotForKey(
+    const std::string& key) {
+  lock_.AssertAcquired();
+
+  SnapshotMap::iterator it = snapshots_.find(key);
+  if (it != snapshots_.end())
+    return it->second;
+
+  scoped_refptr<KeySnapshot> snapshot(new KeySnapshot);
+  for (CookieMapItPair its = cookies_.equal_range(key);
+       its.first != its.second; ++its.first) {
+    snapshot->cookies.push_back(*its.first->second);
+  }
+  snapshots_[key] = snapshot;
+  return snapshot;
+}
+
+void CookieMonster::InvalidateSnapshot(const std::string& key) {
+  lock_.AssertAcquired();
+
+  snapshots_.erase(key);
+}
+
 bool CookieMonster::DeleteAnyEquivalentCookie(const std::string& key,
                                               const CanonicalCookie& ecc,
                                               bool skip_httponly,
@@ -1866,6 +1961,7 @@ void CookieMonster::InternalInsertCookie(const std::string& key,
       store_ && sync_to_store)
     store_->AddCookie(*cc);
   cookies_.insert(CookieMap::value_type(key, cc));
+  InvalidateSnapshot(key);
   if (delegate_.get()) {
     delegate_->OnCookieChanged(
         *cc, false, CookieMonster::Delegate::CHANGE_COOKIE_EXPLICIT);
@@ -1980,6 +2076,7 @@ void CookieMonster::InternalUpdateCookieAccessTime(CanonicalCookie* cc,
       (current - cc->LastAccessDate()).InMinutes());
 
   cc->SetLastAccessDate(current);
+  InvalidateSnapshot(GetKey(cc->Domain()));
   if ((cc->IsPersistent() || persist_session_cookies_) && store_)
     store_->UpdateCookieAccessTime(*cc);
 }
@@ -2011,6 +2108,7 @@ void CookieMonster::InternalDeleteCookie(CookieMap::iterator it,
     if (mapping.notify)
       delegate_->OnCookieChanged(*cc, true, mapping.cause);
   }
+  InvalidateSnapshot(it->first);
   cookies_.erase(it);
   delete cc;
 }
@@ -270,6 +270,12 @@ class NET_EXPORT CookieMonster : public CookieStore {
   static const int kDefaultCookieableSchemesCount;
 
  private:
+  // Snapshot of the cookies stored under a single eTLD+1 key, shared by
+  // reference with readers so that the common GetCookies() path can run
+  // without holding |lock_|.  Defined in cookie_monster.cc.
+  struct KeySnapshot;
+  typedef std::map<std::string, scoped_refptr<KeySnapshot> > SnapshotMap;
+
   // For queueing the cookie monster calls.
   class CookieMonsterTask;
   class DeleteAllCreatedBetweenTask;
@@ -305,6 +311,10 @@ class NET_EXPORT CookieMonster : public CookieStore {
   // For FindCookiesForKey.
   FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest, ShortLivedSessionCookies);
 
+  // For snapshots_ and cookies_.
+  FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest, SnapshotReadsSeeMutations);
+  FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest, SnapshotReadsDropExpiredCookies);
+
   // Internal reasons for deletion, used to populate informative histograms
   // and to provide a public cause for onCookieChange notifications.
   //
@@ -483,6 +493,26 @@ class NET_EXPORT CookieMonster : public CookieStore {
                          bool update_access_time,
                          std::vector<CanonicalCookie*>* cookies);
 
+  // Collects the cookies in |snapshot| that apply to |url| into |cookies|,
+  // mirroring the filters of FindCookiesForKey().  Returns false if the
+  // snapshot cannot answer the request because a cookie needs work that must
+  // be done with |lock_| held (deleting an expired cookie or refreshing a
+  // stale last access time); the caller should then fall back to
+  // FindCookiesForHostAndDomain().
+  bool FindCookiesInSnapshot(KeySnapshot* snapshot,
+                             const GURL& url,
+                             const CookieOptions& options,
+                             std::vector<CanonicalCookie*>* cookies);
+
+  // Returns the shared snapshot of the cookies stored under |key|, building
+  // and caching one if necessary.  Must be called with |lock_| held; the
+  // returned snapshot may be read without the lock.
+  scoped_refptr<KeySnapshot> GetSnapshotForKey(const std::string& key);
+
+  // Discards any cached snapshot for |key|.  Must be called, with |lock_|
+  // held, whenever the cookies stored under |key| change.
+  void InvalidateSnapshot(const std::string& key);
+
   // Delete any cookies that are equivalent to |ecc| (same path, domain, etc).
   // If |skip_httponly| is true, httponly cookies will not be deleted.  The
   // return value with be true if |skip_httponly| skipped an httponly cookie.
@@ -593,6 +623,10 @@ class NET_EXPORT CookieMonster : public CookieStore {
 
   CookieMap cookies_;
 
+  // Cached per-key snapshots of |cookies_|, lazily built by
+  // GetSnapshotForKey() and discarded whenever the cookies for a key change.
+  SnapshotMap snapshots_;
+
   // Indicates whether the cookie store has been initialized. This happens
   // lazily in InitStoreIfNecessary().
   bool initialized_;
@@ -9,6 +9,7 @@
 #include "base/perftimer.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
+#include "base/test/perf_benchmark.h"
 #include "googleurl/src/gurl.h"
 #include "net/cookies/cookie_monster.h"
 #include "net/cookies/cookie_monster_store_test.h"
@@ -143,22 +144,26 @@ TEST_F(CookieMonsterTest, TestAddCookiesOnSingleHost) {
   SetCookieCallback setCookieCallback;
 
   // Add a bunch of cookies on a single host
-  PerfTimeLogger timer("Cookie_monster_add_single_host");
+  base::PerfBenchmark add_benchmark("Cookie_monster_add_single_host");
 
   for (std::vector<std::string>::const_iterator it = cookies.begin();
        it != cookies.end(); ++it) {
+    add_benchmark.StartIteration();
     setCookieCallback.SetCookie(cm, kUrlGoogle, *it);
+    add_benchmark.StopIteration();
   }
-  timer.Done();
+  add_benchmark.Report();
 
   GetCookiesCallback getCookiesCallback;
 
-  PerfTimeLogger timer2("Cookie_monster_query_single_host");
+  base::PerfBenchmark query_benchmark("Cookie_monster_query_single_host");
   for (std::vector<std::string>::const_iterator it = cookies.begin();
        it != cookies.end(); ++it) {
+    query_benchmark.StartIteration();
     getCookiesCallback.GetCookies(cm, kUrlGoogle);
+    query_benchmark.StopIteration();
   }
-  timer2.Done();
+  query_benchmark.Report();
 
   PerfTimeLogger timer3("Cookie_monster_deleteall_single_host");
   cm->DeleteAllAsync(CookieMonster::DeleteCallback());
@@ -274,11 +279,13 @@ TEST_F(CookieMonsterTest, TestDomainTree) {
   std::string cookie_line = getCookiesCallback.GetCookies(cm, probe_gurl);
   EXPECT_EQ(5, CountInString(cookie_line, '=')) << "Cookie line: " <<
       cookie_line;
-  PerfTimeLogger timer("Cookie_monster_query_domain_tree");
+  base::PerfBenchmark benchmark("Cookie_monster_query_domain_tree");
   for (int i = 0; i < kNumCookies; i++) {
+    benchmark.StartIteration();
     getCookiesCallback.GetCookies(cm, probe_gurl);
+    benchmark.StopIteration();
   }
-  timer.Done();
+  benchmark.Report();
 }
 
 TEST_F(CookieMonsterTest, TestDomainLine) {
@@ -314,11 +321,13 @@ TEST_F(CookieMonsterTest, TestDomainLine) {
 
   cookie_line = getCookiesCallback.GetCookies(cm, probe_gurl);
   EXPECT_EQ(32, CountInString(cookie_line, '='));
-  PerfTimeLogger timer2("Cookie_monster_query_domain_line");
+  base::PerfBenchmark benchmark("Cookie_monster_query_domain_line");
   for (int i = 0; i < kNumCookies; i++) {
+    benchmark.StartIteration();
     getCookiesCallback.GetCookies(cm, probe_gurl);
+    benchmark.StopIteration();
   }
-  timer2.Done();
+  benchmark.Report();
 }
 
 TEST_F(CookieMonsterTest, TestImport) {
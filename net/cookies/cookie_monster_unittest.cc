@@ -2669,6 +2669,83 @@ TEST_F(CookieMonsterTest, ShortLivedSessionCookies) {
   EXPECT_EQ(0U, cookies.size());
 }
 
+// Tests that the per-key snapshots serving GetCookiesWithOptions() are
+// discarded by inserts and deletes, so a read right after a mutation sees
+// the change.
+TEST_F(CookieMonsterTest, SnapshotReadsSeeMutations) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  const std::string key(cm->GetKey(url_google_.host()));
+
+  // Prime the snapshot for the key.
+  EXPECT_TRUE(SetCookie(cm, url_google_, "A=B"));
+  EXPECT_EQ("A=B", GetCookies(cm, url_google_));
+  {
+    base::AutoLock auto_lock(cm->lock_);
+    EXPECT_EQ(1U, cm->snapshots_.count(key));
+  }
+
+  // An insert discards the snapshot, and the next read sees the new cookie.
+  EXPECT_TRUE(SetCookie(cm, url_google_, "C=D"));
+  {
+    base::AutoLock auto_lock(cm->lock_);
+    EXPECT_EQ(0U, cm->snapshots_.count(key));
+  }
+  EXPECT_EQ("A=B; C=D", GetCookies(cm, url_google_));
+
+  // So does a delete.
+  EXPECT_TRUE(FindAndDeleteCookie(cm, url_google_.host(), "A"));
+  {
+    base::AutoLock auto_lock(cm->lock_);
+    EXPECT_EQ(0U, cm->snapshots_.count(key));
+  }
+  EXPECT_EQ("C=D", GetCookies(cm, url_google_));
+}
+
+// Tests that a read that runs into an expired cookie bypasses the snapshot
+// and takes the locked path, which deletes the cookie from the store rather
+// than just filtering it out of the result.
+TEST_F(CookieMonsterTest, SnapshotReadsDropExpiredCookies) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+
+  EXPECT_TRUE(SetCookie(cm, url_google_, "A=B"));
+  EXPECT_TRUE(SetCookieWithDetails(
+      cm, url_google_, "C", "D", "", "/",
+      Time::Now() + TimeDelta::FromMilliseconds(300), false, false));
+  EXPECT_EQ("A=B; C=D", GetCookies(cm, url_google_));
+
+  base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(400));
+
+  EXPECT_EQ("A=B", GetCookies(cm, url_google_));
+  {
+    base::AutoLock auto_lock(cm->lock_);
+    EXPECT_EQ(1U, cm->cookies_.size());
+  }
+}
+
+// Tests that a stale last access time sends a read down the locked path,
+// where the time is refreshed, and that the refresh is visible to later
+// (snapshot) reads.
+TEST_F(CookieMonsterTest, SnapshotReadsRefreshAccessTime) {
+  scoped_refptr<CookieMonster> cm(
+      new CookieMonster(NULL, NULL, kLastAccessThresholdMilliseconds));
+
+  EXPECT_TRUE(SetCookie(cm, url_google_, "A=B"));
+  EXPECT_EQ("A=B", GetCookies(cm, url_google_));
+
+  base::PlatformThread::Sleep(
+      base::TimeDelta::FromMilliseconds(kAccessDelayMs));
+
+  const Time stale_date(GetFirstCookieAccessDate(cm));
+  EXPECT_EQ("A=B", GetCookies(cm, url_google_));
+  const Time refreshed_date(GetFirstCookieAccessDate(cm));
+  EXPECT_TRUE(stale_date < refreshed_date);
+
+  // The refreshed time is inside the threshold again, so this read is
+  // served from a snapshot and must not move it.
+  EXPECT_EQ("A=B", GetCookies(cm, url_google_));
+  EXPECT_TRUE(refreshed_date == GetFirstCookieAccessDate(cm));
+}
+
 TEST_F(CookieMonsterTest, InvalidExpiryTime) {
   CookieMonster::ParsedCookie pc(
       std::string(kValidCookieLine) + "; expires=Blarg arg arg");
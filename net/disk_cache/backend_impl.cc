@@ -52,6 +52,13 @@ const int kDefaultCacheSize = 80 * 1024 * 1024;
 // Avoid trimming the cache for the first 5 minutes (10 timer ticks).
 const int kTrimDelay = 10;
 
+// Number of index buckets verified by each background sweep task, and the
+// delay before the first sweep. Walking the table also faults the memory
+// mapped index in, so by the time the sweep finishes the old behavior of
+// reading the whole file is matched without blocking initialization.
+const int kIndexBucketsPerSweep = 8 * 1024;
+const int kIndexSweepDelayMs = 1000;
+
 int DesiredIndexTableLen(int32 storage_size) {
   if (storage_size <= k64kEntriesStore)
     return kBaseTableLen;
@@ -2104,9 +2111,40 @@ bool BackendImpl::CheckIndex() {
   if (!mask_)
     mask_ = data_->header.table_len - 1;
 
-  // Load the table into memory with a single read.
-  scoped_array<char> buf(new char[current_size]);
-  return index_->Read(buf.get(), current_size, 0);
+  // The table is memory mapped, so lookups can be served right away. Verify
+  // the buckets from background tasks instead of stalling initialization
+  // behind a read of the whole file.
+  if (!(user_flags_ & kNoRandom)) {
+    MessageLoop::current()->PostDelayedTask(FROM_HERE,
+        base::Bind(&BackendImpl::CheckIndexBuckets, GetWeakPtr(), 0),
+        base::TimeDelta::FromMilliseconds(kIndexSweepDelayMs));
+  }
+  return true;
+}
+
+void BackendImpl::CheckIndexBuckets(int start_bucket) {
+  if (disabled_ || read_only_)
+    return;
+
+  int limit = start_bucket + kIndexBucketsPerSweep;
+  if (limit > data_->header.table_len)
+    limit = data_->header.table_len;
+
+  for (int i = start_bucket; i < limit; i++) {
+    Addr address(data_->table[i]);
+    if (!address.is_initialized())
+      continue;
+    if (!address.SanityCheckForEntry()) {
+      LOG(WARNING) << "Invalid address at bucket " << i;
+      data_->table[i] = 0;
+    }
+  }
+
+  if (limit < data_->header.table_len) {
+    MessageLoop::current()->PostDelayedTask(FROM_HERE,
+        base::Bind(&BackendImpl::CheckIndexBuckets, GetWeakPtr(), limit),
+        base::TimeDelta::FromMilliseconds(kIndexSweepDelayMs));
+  }
 }
 
 int BackendImpl::CheckAllEntries() {
@@ -339,6 +339,10 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   // Performs basic checks on the index file. Returns false on failure.
   bool CheckIndex();
 
+  // Verifies (and repairs) a range of index buckets starting at
+  // |start_bucket|, re-posting itself until the whole table is covered.
+  void CheckIndexBuckets(int start_bucket);
+
   // Part of the self test. Returns the number or dirty entries, or an error.
   int CheckAllEntries();
 
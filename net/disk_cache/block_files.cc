@@ -334,7 +334,18 @@ void BlockFiles::DeleteBlock(Addr address, bool deep) {
     FileType type = Addr::RequiredFileType(header->entry_size);
     if (Addr::BlockSizeForFileType(RANKINGS) == header->entry_size)
       type = RANKINGS;
+    if (address.FileNumber() < kFirstAdditionalBlockFile) {
+      // The first file of each chain cannot be removed, but we can still
+      // release its unused space.
+      TrimBlockFile(file, header);
+    }
     RemoveEmptyFile(type);  // Ignore failures.
+  } else if (header->max_entries > 2048 &&
+             EmptyBlocks(header) > header->max_entries * 3 / 4) {
+    // Mostly empty now. We cannot move the remaining blocks closer together
+    // (their addresses are stored by the owning records), but we may be able
+    // to give back the tail of the file.
+    TrimBlockFile(file, header);
   }
 }
 
@@ -476,14 +487,13 @@ bool BlockFiles::GrowBlockFile(MappedFile* file, BlockFileHeader* header) {
   if (kMaxBlocks == header->max_entries)
     return false;
 
-  DCHECK(!header->empty[3]);
   int new_size = header->max_entries + 1024;
   if (new_size > kMaxBlocks)
     new_size = kMaxBlocks;
 
   int new_size_bytes = new_size * header->entry_size + sizeof(*header);
 
-  if (!file->SetLength(new_size_bytes)) {
+  if (!file->Preallocate(new_size_bytes)) {
     // Most likely we are trying to truncate the file, so the header is wrong.
     if (header->updating < 10 && !FixBlockFileHeader(file)) {
       // If we can't fix the file increase the lock guard so we'll pick it on
@@ -495,12 +505,47 @@ bool BlockFiles::GrowBlockFile(MappedFile* file, BlockFileHeader* header) {
   }
 
   FileLock lock(header);
-  header->empty[3] = (new_size - header->max_entries) / 4;  // 4 blocks entries
+  header->empty[3] += (new_size - header->max_entries) / 4;  // 4 blocks entries
   header->max_entries = new_size;
 
   return true;
 }
 
+bool BlockFiles::TrimBlockFile(MappedFile* file, BlockFileHeader* header) {
+  // Find the last 32-block chunk of the allocation map that is in use.
+  int last_used = -1;
+  for (int i = header->max_entries / 32 - 1; i >= 0; i--) {
+    if (header->allocation_map[i]) {
+      last_used = i;
+      break;
+    }
+  }
+
+  // Stay on the 1024-block granularity used by GrowBlockFile(), and keep one
+  // free chunk so that the next allocation doesn't grow the file right back.
+  int used_blocks = (last_used + 1) * 32;
+  int new_size = (used_blocks + 1023) / 1024 * 1024 + 1024;
+  if (new_size >= header->max_entries)
+    return false;
+
+  int new_size_bytes = new_size * header->entry_size + sizeof(*header);
+  {
+    // Update the header first; if we crash before the actual truncation the
+    // file is larger than the header says, which FixBlockFileHeader() treats
+    // the same way as an interrupted GrowBlockFile().
+    FileLock lock(header);
+    header->max_entries = new_size;
+    // The discarded tail was all free space, so the entry count is still
+    // valid; just rebuild the counters for the new size.
+    FixAllocationCounters(header);
+  }
+  if (!file->SetLength(new_size_bytes))
+    return false;
+
+  Trace("TrimBlockFile %d", header->this_file);
+  return true;
+}
+
 MappedFile* BlockFiles::FileForNewBlock(FileType block_type, int block_count) {
   COMPILE_ASSERT(RANKINGS == 1, invalid_file_type);
   MappedFile* file = block_files_[block_type - 1];
@@ -617,12 +662,13 @@ bool BlockFiles::FixBlockFileHeader(MappedFile* file) {
   int expected = header->entry_size * header->max_entries + sizeof(*header);
   if (file_size != expected) {
     int max_expected = header->entry_size * kMaxBlocks + sizeof(*header);
-    if (file_size < expected || header->empty[3] || file_size > max_expected) {
+    if (file_size < expected || file_size > max_expected) {
       NOTREACHED();
       LOG(ERROR) << "Unexpected file size";
       return false;
     }
-    // We were in the middle of growing the file.
+    // We were in the middle of growing or trimming the file. Either way, the
+    // region between the expected and actual sizes holds no used blocks.
     int num_entries = (file_size - sizeof(*header)) / header->entry_size;
     header->max_entries = num_entries;
   }
@@ -65,6 +65,11 @@ class NET_EXPORT_PRIVATE BlockFiles {
   // Attemp to grow this file. Fails if the file cannot be extended anymore.
   bool GrowBlockFile(MappedFile* file, BlockFileHeader* header);
 
+  // Returns the unused space at the end of this file to the OS. Blocks are
+  // never moved around (their addresses are stored by the owning records), so
+  // only trailing free space can be reclaimed.
+  bool TrimBlockFile(MappedFile* file, BlockFileHeader* header);
+
   // Returns the appropriate file to use for a new block.
   MappedFile* FileForNewBlock(FileType block_type, int block_count);
 
@@ -96,6 +101,7 @@ class NET_EXPORT_PRIVATE BlockFiles {
   FRIEND_TEST_ALL_PREFIXES(DiskCacheTest, BlockFiles_TruncatedFile);
   FRIEND_TEST_ALL_PREFIXES(DiskCacheTest, BlockFiles_InvalidFile);
   FRIEND_TEST_ALL_PREFIXES(DiskCacheTest, BlockFiles_Stats);
+  FRIEND_TEST_ALL_PREFIXES(DiskCacheTest, BlockFiles_TrimTail);
 
   DISALLOW_COPY_AND_ASSIGN(BlockFiles);
 };
@@ -75,6 +75,51 @@ TEST_F(DiskCacheTest, BlockFiles_Shrink) {
   EXPECT_EQ(4, NumberOfFiles(cache_path_));
 }
 
+// A file that is mostly empty should give back its unused tail, even if some
+// entries remain.
+TEST_F(DiskCacheTest, BlockFiles_TrimTail) {
+  ASSERT_TRUE(CleanupCacheDir());
+  ASSERT_TRUE(file_util::CreateDirectory(cache_path_));
+
+  BlockFiles files(cache_path_);
+  ASSERT_TRUE(files.Init(true));
+
+  const int kNumEntries = 4000;
+  Addr address[kNumEntries];
+
+  // Grow the 36-byte block file well past the trimming threshold.
+  for (int i = 0; i < kNumEntries; i++) {
+    EXPECT_TRUE(files.CreateBlock(RANKINGS, 4, &address[i]));
+  }
+
+  size_t full_size;
+  {
+    scoped_refptr<File> file(new File);
+    ASSERT_TRUE(file->Init(files.Name(0)));
+    full_size = file->GetLength();
+  }
+
+  // Delete everything but the first entry. The file cannot be removed, but
+  // the free space at the end should be returned to the OS.
+  for (int i = 1; i < kNumEntries; i++) {
+    files.DeleteBlock(address[i], false);
+  }
+  EXPECT_TRUE(files.IsValid(address[0]));
+
+  size_t trimmed_size;
+  {
+    scoped_refptr<File> file(new File);
+    ASSERT_TRUE(file->Init(files.Name(0)));
+    trimmed_size = file->GetLength();
+  }
+  EXPECT_LT(trimmed_size, full_size);
+
+  // The remaining entry must survive a reopen.
+  files.CloseFiles();
+  ASSERT_TRUE(files.Init(false));
+  EXPECT_TRUE(files.IsValid(address[0]));
+}
+
 // Handling of block files not properly closed.
 TEST_F(DiskCacheTest, BlockFiles_Recover) {
   ASSERT_TRUE(CleanupCacheDir());
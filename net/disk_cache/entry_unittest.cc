@@ -1463,6 +1463,35 @@ TEST_F(DiskCacheEntryTest, MemoryOnlyHugeSparseIO) {
   HugeSparseIO();
 }
 
+// Reads a multi-child sparse entry sequentially, the way media playback does.
+// This exercises the read-ahead of upcoming children.
+TEST_F(DiskCacheEntryTest, SequentialSparseIO) {
+  InitCache();
+  std::string key("the first key");
+  disk_cache::Entry* entry;
+  ASSERT_EQ(net::OK, CreateEntry(key, &entry));
+
+  // Write 3 MB so that the data spans several children.
+  const int kSize = 3 * 1024 * 1024;
+  scoped_refptr<net::IOBuffer> buf_1(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buf_1->data(), kSize, false);
+
+  net::TestCompletionCallback cb;
+  int ret = entry->WriteSparseData(0, buf_1, kSize, cb.callback());
+  EXPECT_EQ(kSize, cb.GetResult(ret));
+
+  const int kChunkSize = 64 * 1024;
+  scoped_refptr<net::IOBuffer> buf_2(new net::IOBuffer(kChunkSize));
+  for (int offset = 0; offset < kSize; offset += kChunkSize) {
+    memset(buf_2->data(), 0, kChunkSize);
+    ret = entry->ReadSparseData(offset, buf_2, kChunkSize, cb.callback());
+    ASSERT_EQ(kChunkSize, cb.GetResult(ret));
+    EXPECT_EQ(0, memcmp(buf_1->data() + offset, buf_2->data(), kChunkSize));
+  }
+
+  entry->Close();
+}
+
 void DiskCacheEntryTest::GetAvailableRange() {
   std::string key("the first key");
   disk_cache::Entry* entry;
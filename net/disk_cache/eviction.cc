@@ -288,6 +288,7 @@ bool Eviction::EvictEntry(CacheRankingsBlock* node, bool empty,
     EntryStore* info = entry->entry()->Data();
     DCHECK_EQ(ENTRY_NORMAL, info->state);
 
+    CACHE_UMA(LIST, "TrimList", 0, list);
     rankings_->Remove(entry->rankings(), GetListForEntryV2(entry), true);
     info->state = ENTRY_EVICTED;
     entry->entry()->Store();
@@ -310,9 +311,11 @@ void Eviction::TrimCacheV2(bool empty) {
   Rankings::ScopedRankingsBlock next[kListsToSearch];
   int list = Rankings::LAST_ELEMENT;
 
-  // Get a node from each list.
+  // Get a node from each list. Stop looking at the first (least valuable)
+  // list that meets the age target, so that frequently used entries are not
+  // evicted while one-shot entries are still available.
+  bool done = false;
   for (int i = 0; i < kListsToSearch; i++) {
-    bool done = false;
     next[i].set_rankings(rankings_);
     if (done)
       continue;
@@ -391,6 +394,9 @@ void Eviction::OnOpenEntryV2(EntryImpl* entry) {
   EntryStore* info = entry->entry()->Data();
   DCHECK_EQ(ENTRY_NORMAL, info->state);
 
+  // Sample the list that served this hit, before any promotion.
+  CACHE_UMA(LIST, "HitFromList", 0, GetListForEntryV2(entry));
+
   if (info->reuse_count < kint32max) {
     info->reuse_count++;
     entry->entry()->set_modified();
@@ -417,6 +423,9 @@ void Eviction::OnCreateEntryV2(EntryImpl* entry) {
       break;
     };
     case ENTRY_EVICTED: {
+      // We are fetching again something that we evicted not long ago, so the
+      // eviction was premature. Report it against the DELETED list.
+      CACHE_UMA(LIST, "HitFromList", 0, Rankings::DELETED);
       if (info->refetch_count < kint32max)
         info->refetch_count++;
 
@@ -65,6 +65,11 @@ class NET_EXPORT_PRIVATE File : public base::RefCounted<File> {
   bool SetLength(size_t length);
   size_t GetLength();
 
+  // Extends the file to |length| bytes, asking the OS to reserve disk space
+  // for the whole range so that the new region is not fragmented all over the
+  // disk. Falls back to SetLength() if the OS cannot preallocate.
+  bool Preallocate(size_t length);
+
   // Blocks until |num_pending_io| IO operations complete.
   static void WaitForPendingIO(int* num_pending_io);
 
@@ -9,13 +9,21 @@
 #include "base/bind.h"
 #include "base/location.h"
 #include "base/logging.h"
-#include "base/threading/worker_pool.h"
+#include "base/stringprintf.h"
+#include "base/threading/thread.h"
 #include "net/base/net_errors.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/in_flight_io.h"
 
 namespace {
 
+// Number of dedicated threads performing the actual file operations. All the
+// operations on a given File go to the same thread (sharded by the File
+// pointer), so they are serialized with respect to each other, while
+// operations on independent entries can proceed in parallel instead of
+// queueing behind one slow read.
+const int kCacheIOThreads = 4;
+
 // This class represents a single asynchronous IO operation while it is being
 // bounced between threads.
 class FileBackgroundIO : public disk_cache::BackgroundIO {
@@ -65,7 +73,7 @@ class FileBackgroundIO : public disk_cache::BackgroundIO {
 // The specialized controller that keeps track of current operations.
 class FileInFlightIO : public disk_cache::InFlightIO {
  public:
-  FileInFlightIO() {}
+  FileInFlightIO();
   ~FileInFlightIO() {}
 
   // These methods start an asynchronous operation. The arguments have the same
@@ -85,6 +93,11 @@ class FileInFlightIO : public disk_cache::InFlightIO {
                                    bool cancel);
 
  private:
+  // Returns the message loop that serializes the operations on |file|.
+  MessageLoop* GetThreadForFile(disk_cache::File* file);
+
+  scoped_ptr<base::Thread> io_threads_[kCacheIOThreads];
+
   DISALLOW_COPY_AND_ASSIGN(FileInFlightIO);
 };
 
@@ -110,14 +123,22 @@ void FileBackgroundIO::Write() {
 
 // ---------------------------------------------------------------------------
 
+FileInFlightIO::FileInFlightIO() {
+  for (int i = 0; i < kCacheIOThreads; i++) {
+    io_threads_[i].reset(
+        new base::Thread(base::StringPrintf("CacheIOThread %d", i).c_str()));
+    io_threads_[i]->Start();
+  }
+}
+
 void FileInFlightIO::PostRead(disk_cache::File *file, void* buf, size_t buf_len,
                           size_t offset, disk_cache::FileIOCallback *callback) {
   scoped_refptr<FileBackgroundIO> operation(
       new FileBackgroundIO(file, buf, buf_len, offset, callback, this));
   file->AddRef();  // Balanced on OnOperationComplete()
 
-  base::WorkerPool::PostTask(FROM_HERE,
-      base::Bind(&FileBackgroundIO::Read, operation.get()), true);
+  GetThreadForFile(file)->PostTask(FROM_HERE,
+      base::Bind(&FileBackgroundIO::Read, operation.get()));
   OnOperationPosted(operation);
 }
 
@@ -128,11 +149,17 @@ void FileInFlightIO::PostWrite(disk_cache::File* file, const void* buf,
       new FileBackgroundIO(file, buf, buf_len, offset, callback, this));
   file->AddRef();  // Balanced on OnOperationComplete()
 
-  base::WorkerPool::PostTask(FROM_HERE,
-      base::Bind(&FileBackgroundIO::Write, operation.get()), true);
+  GetThreadForFile(file)->PostTask(FROM_HERE,
+      base::Bind(&FileBackgroundIO::Write, operation.get()));
   OnOperationPosted(operation);
 }
 
+MessageLoop* FileInFlightIO::GetThreadForFile(disk_cache::File* file) {
+  // Skip the low bits of the pointer; they are shared by every allocation.
+  size_t shard = (reinterpret_cast<uintptr_t>(file) >> 4) % kCacheIOThreads;
+  return io_threads_[shard]->message_loop();
+}
+
 // Runs on the IO thread.
 void FileInFlightIO::OnOperationComplete(disk_cache::BackgroundIO* operation,
                                          bool cancel) {
@@ -274,6 +301,20 @@ size_t File::GetLength() {
   return ret;
 }
 
+bool File::Preallocate(size_t length) {
+  DCHECK(init_);
+  if (length > ULONG_MAX)
+    return false;
+
+#if defined(OS_LINUX)
+  // Allocate the actual blocks now, so that a file that grows little by
+  // little still ends up mostly contiguous on disk.
+  if (!posix_fallocate(platform_file_, 0, static_cast<off_t>(length)))
+    return true;
+#endif
+  return SetLength(length);
+}
+
 // Static.
 void File::WaitForPendingIO(int* num_pending_io) {
   // We may be running unit tests so we should allow be able to reset the
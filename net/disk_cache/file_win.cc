@@ -254,6 +254,12 @@ size_t File::GetLength() {
   return static_cast<size_t>(size.LowPart);
 }
 
+bool File::Preallocate(size_t length) {
+  DCHECK(init_);
+  // SetEndOfFile() already reserves the space within the filesystem.
+  return SetLength(length);
+}
+
 // Static.
 void File::WaitForPendingIO(int* num_pending_io) {
   while (*num_pending_io) {
@@ -85,6 +85,11 @@
 #define CACHE_HISTOGRAM_CACHE_ERROR(name, sample) \
     CACHE_HISTOGRAM_ENUMERATION(name, sample, 50)
 
+// HISTOGRAM_LIST samples a Rankings::List (the boundary value is
+// Rankings::LAST_ELEMENT).
+#define CACHE_HISTOGRAM_LIST(name, sample) \
+    CACHE_HISTOGRAM_ENUMERATION(name, sample, 5)
+
 #ifdef NET_DISK_CACHE_BACKEND_IMPL_CC_
 #define BACKEND_OBJ this
 #else
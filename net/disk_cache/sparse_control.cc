@@ -37,6 +37,10 @@ const int kMaxEntrySize = 0x100000;
 // The size of each data block (tracked by the child allocation bitmap).
 const int kBlockSize = 1024;
 
+// The number of back-to-back sequential reads after which we consider the
+// caller to be streaming through the entry and start reading ahead.
+const int kMinSequentialReads = 2;
+
 // Returns the name of a child entry given the base_name and signature of the
 // parent and the child_id.
 // If the entry is called entry_name, child entries will be named something
@@ -140,6 +144,37 @@ void ChildrenDeleter::DeleteChildren() {
       &ChildrenDeleter::DeleteChildren, this));
 }
 
+// This class warms up a child entry that a sequential reader is about to
+// need: it reads the child's data and throws it away, so that by the time
+// the reader gets there the data is already in memory. The object destroys
+// itself when the read completes.
+class ChildPrefetcher : public base::RefCounted<ChildPrefetcher> {
+ public:
+  // Takes ownership of the caller's reference to |child|.
+  explicit ChildPrefetcher(disk_cache::EntryImpl* child) : child_(child) {}
+
+  void Start() {
+    int len = std::min(child_->GetDataSize(kSparseData), kMaxEntrySize);
+    if (len <= 0)
+      return;
+    buffer_ = new net::IOBuffer(len);
+    // If the read completes synchronously the callback is not invoked, and
+    // the last reference to this object goes away with the caller.
+    child_->ReadDataImpl(kSparseData, 0, buffer_, len,
+                         base::Bind(&ChildPrefetcher::OnIOComplete, this));
+  }
+
+ private:
+  friend class base::RefCounted<ChildPrefetcher>;
+  ~ChildPrefetcher() { child_->Release(); }
+
+  void OnIOComplete(int result) {}
+
+  disk_cache::EntryImpl* child_;
+  scoped_refptr<net::IOBuffer> buffer_;
+  DISALLOW_COPY_AND_ASSIGN(ChildPrefetcher);
+};
+
 // Returns the NetLog event type corresponding to a SparseOperation.
 net::NetLog::EventType GetSparseEventType(
     disk_cache::SparseControl::SparseOperation operation) {
@@ -189,7 +224,10 @@ SparseControl::SparseControl(EntryImpl* entry)
       child_(NULL),
       operation_(kNoOperation),
       init_(false),
-      child_map_(child_data_.bitmap, kNumSparseBits, kNumSparseBits / 32) {
+      child_map_(child_data_.bitmap, kNumSparseBits, kNumSparseBits / 32),
+      next_sequential_offset_(0),
+      sequential_reads_(0),
+      last_readahead_child_(-1) {
 }
 
 SparseControl::~SparseControl() {
@@ -262,6 +300,20 @@ int SparseControl::StartIO(SparseOperation op, int64 offset, net::IOBuffer* buf,
   finished_ = false;
   abort_ = false;
 
+  // Keep track of sequential reads so we can warm up the child that the
+  // caller is going to need next. The target is computed now because the
+  // operation moves |offset_| as it makes progress.
+  int64 readahead_child = -1;
+  if (kReadOperation == op) {
+    if (offset_ == next_sequential_offset_)
+      sequential_reads_++;
+    else
+      sequential_reads_ = 1;
+    next_sequential_offset_ = offset_ + buf_len_;
+    if (sequential_reads_ >= kMinSequentialReads)
+      readahead_child = (offset_ >> 20) + 1;
+  }
+
   if (entry_->net_log().IsLoggingAllEvents()) {
     entry_->net_log().BeginEvent(
         GetSparseEventType(operation_),
@@ -269,6 +321,9 @@ int SparseControl::StartIO(SparseOperation op, int64 offset, net::IOBuffer* buf,
   }
   DoChildrenIO();
 
+  if (readahead_child != -1)
+    ReadAhead(readahead_child);
+
   if (!pending_) {
     // Everything was done synchronously.
     operation_ = kNoOperation;
@@ -497,6 +552,34 @@ std::string SparseControl::GenerateChildKey() {
                            offset_ >> 20);
 }
 
+void SparseControl::ReadAhead(int64 child_id) {
+  if (child_id == last_readahead_child_)
+    return;
+
+  // Only warm up children that actually store data.
+  int child_bit = static_cast<int>(child_id);
+  if (children_map_.Size() <= child_bit || !children_map_.Get(child_bit))
+    return;
+
+  if (!entry_->backend_)
+    return;
+
+  // Remember the target even if the open fails so that we don't retry it on
+  // every read.
+  last_readahead_child_ = child_id;
+
+  std::string key = GenerateChildName(entry_->GetKey(),
+                                      sparse_header_.signature, child_id);
+  EntryImpl* child = entry_->backend_->OpenEntryImpl(key);
+  if (!child)
+    return;
+
+  // The prefetcher owns the reference to |child| and destroys itself when
+  // the read completes.
+  scoped_refptr<ChildPrefetcher> prefetcher(new ChildPrefetcher(child));
+  prefetcher->Start();
+}
+
 // We are deleting the child because something went wrong.
 bool SparseControl::KillChildAndContinue(const std::string& key, bool fatal) {
   SetChildBit(false);
@@ -92,6 +92,11 @@ class SparseControl {
   void CloseChild();
   std::string GenerateChildKey();
 
+  // Reads the data of the child |child_id| into memory, discarding the
+  // result, so that a sequential reader finds it there instead of waiting
+  // for the disk when it gets to that child.
+  void ReadAhead(int64 child_id);
+
   // Deletes the current child and continues the current operation (open).
   bool KillChildAndContinue(const std::string& key, bool fatal);
 
@@ -170,6 +175,14 @@ class SparseControl {
   int child_len_;  // Bytes to read or write for this child.
   int result_;
 
+  // Sequential-read detection, used to decide when to read ahead.
+  // |next_sequential_offset_| is where a sequential reader would issue its
+  // next read, and |last_readahead_child_| is the last child warmed up by
+  // ReadAhead().
+  int64 next_sequential_offset_;
+  int sequential_reads_;
+  int64 last_readahead_child_;
+
   DISALLOW_COPY_AND_ASSIGN(SparseControl);
 };
 
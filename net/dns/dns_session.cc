@@ -6,13 +6,24 @@
 
 #include "base/basictypes.h"
 #include "base/bind.h"
+#include "base/stl_util.h"
 #include "base/time.h"
 #include "net/base/ip_endpoint.h"
 #include "net/dns/dns_config_service.h"
 #include "net/socket/client_socket_factory.h"
+#include "net/udp/datagram_client_socket.h"
 
 namespace net {
 
+namespace {
+
+// Maximum number of released sockets kept per server. Kept small so that
+// queries still spread over many source ports; see
+// DnsSession::ReleaseSocket().
+const size_t kMaxPooledSocketsPerServer = 4;
+
+}  // namespace
+
 DnsSession::DnsSession(const DnsConfig& config,
                        ClientSocketFactory* factory,
                        const RandIntCallback& rand_int_callback,
@@ -21,7 +32,9 @@ DnsSession::DnsSession(const DnsConfig& config,
       socket_factory_(factory),
       rand_callback_(base::Bind(rand_int_callback, 0, kuint16max)),
       net_log_(net_log),
-      server_index_(0) {
+      server_index_(0),
+      socket_pools_(config.nameservers.size()),
+      socket_reuse_enabled_(true) {
 }
 
 int DnsSession::NextQueryId() const {
@@ -41,7 +54,31 @@ base::TimeDelta DnsSession::NextTimeout(int attempt) {
   return config_.timeout * (1 << (attempt / config_.nameservers.size()));
 }
 
-DnsSession::~DnsSession() {}
+scoped_ptr<DatagramClientSocket> DnsSession::AllocateSocket(
+    unsigned server_index) {
+  if (server_index >= socket_pools_.size() ||
+      socket_pools_[server_index].empty())
+    return scoped_ptr<DatagramClientSocket>();
+
+  scoped_ptr<DatagramClientSocket> socket(socket_pools_[server_index].front());
+  socket_pools_[server_index].pop_front();
+  return socket.Pass();
+}
+
+void DnsSession::ReleaseSocket(unsigned server_index,
+                               scoped_ptr<DatagramClientSocket> socket) {
+  if (!socket_reuse_enabled_ ||
+      server_index >= socket_pools_.size() ||
+      socket_pools_[server_index].size() >= kMaxPooledSocketsPerServer)
+    return;  // |socket| is freed.
+
+  socket_pools_[server_index].push_back(socket.release());
+}
+
+DnsSession::~DnsSession() {
+  for (size_t i = 0; i < socket_pools_.size(); ++i)
+    STLDeleteElements(&socket_pools_[i]);
+}
 
 }  // namespace net
 
@@ -6,6 +6,9 @@
 #define NET_DNS_DNS_SESSION_H_
 #pragma once
 
+#include <deque>
+#include <vector>
+
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/time.h"
@@ -16,6 +19,7 @@
 namespace net {
 
 class ClientSocketFactory;
+class DatagramClientSocket;
 class NetLog;
 
 // Session parameters and state shared between DNS transactions.
@@ -45,6 +49,26 @@ class NET_EXPORT_PRIVATE DnsSession
   // Return the timeout for the next query.
   base::TimeDelta NextTimeout(int attempt);
 
+  // Returns a connected socket released by an earlier query to the server at
+  // |server_index|, or NULL if none is pooled. The caller is expected to
+  // create (and bind) its own socket on NULL.
+  scoped_ptr<DatagramClientSocket> AllocateSocket(unsigned server_index);
+
+  // Makes |socket| available to later queries to the same server, or frees it
+  // if the pool is full. Only sockets with no outstanding query may be
+  // released; otherwise a late response could be mistaken for the answer to a
+  // subsequent query on the socket. Released sockets keep their randomly
+  // bound port, so the pool is kept small to preserve port diversity across
+  // queries.
+  void ReleaseSocket(unsigned server_index,
+                     scoped_ptr<DatagramClientSocket> socket);
+
+  // Enables or disables reuse of released sockets (enabled by default).
+  // Tests which script one mock socket per query disable it.
+  void set_socket_reuse_enabled(bool enabled) {
+    socket_reuse_enabled_ = enabled;
+  }
+
  private:
   friend class base::RefCounted<DnsSession>;
   ~DnsSession();
@@ -57,9 +81,12 @@ class NET_EXPORT_PRIVATE DnsSession
   // Current index into |config_.nameservers| to begin resolution with.
   int server_index_;
 
+  // Per-server pools of connected sockets with no outstanding query.
+  std::vector<std::deque<DatagramClientSocket*> > socket_pools_;
+  bool socket_reuse_enabled_;
+
   // TODO(szym): Add current RTT estimate.
   // TODO(szym): Add TCP connection pool to support DNS over TCP.
-  // TODO(szym): Add UDP port pool to avoid NAT table overload.
 
   DISALLOW_COPY_AND_ASSIGN(DnsSession);
 };
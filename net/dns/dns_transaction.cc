@@ -4,8 +4,11 @@
 
 #include "net/dns/dns_transaction.h"
 
+#include <algorithm>
 #include <deque>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/bind.h"
@@ -100,22 +103,34 @@ class ResponseParameters : public NetLog::EventParameters {
 // matches. Logging is done in the socket and in the outer DnsTransaction.
 class DnsUDPAttempt {
  public:
-  DnsUDPAttempt(scoped_ptr<DatagramClientSocket> socket,
-                const IPEndPoint& server,
+  DnsUDPAttempt(DnsSession* session,
+                unsigned server_index,
+                scoped_ptr<DatagramClientSocket> socket,
+                bool needs_connect,
                 scoped_ptr<DnsQuery> query,
                 const CompletionCallback& callback)
-      : next_state_(STATE_NONE),
+      : session_(session),
+        server_index_(server_index),
+        next_state_(STATE_NONE),
+        needs_connect_(needs_connect),
+        socket_reusable_(false),
         socket_(socket.Pass()),
-        server_(server),
         query_(query.Pass()),
         callback_(callback) {
   }
 
+  ~DnsUDPAttempt() {
+    // A socket that received a well-formed answer has no outstanding query,
+    // so it can safely carry the next one; hand it back to the session.
+    if (socket_reusable_)
+      session_->ReleaseSocket(server_index_, socket_.Pass());
+  }
+
   // Starts the attempt. Returns ERR_IO_PENDING if cannot complete synchronously
   // and calls |callback| upon completion.
   int Start() {
     DCHECK_EQ(STATE_NONE, next_state_);
-    next_state_ = STATE_CONNECT;
+    next_state_ = needs_connect_ ? STATE_CONNECT : STATE_SEND_QUERY;
     return DoLoop(OK);
   }
 
@@ -177,7 +192,7 @@ class DnsUDPAttempt {
 
   int DoConnect() {
     next_state_ = STATE_SEND_QUERY;
-    return socket_->Connect(server_);
+    return socket_->Connect(session_->config().nameservers[server_index_]);
   }
 
   int DoSendQuery() {
@@ -224,6 +239,9 @@ class DnsUDPAttempt {
       // http://crbug.com/107413
       return ERR_DNS_MALFORMED_RESPONSE;
     }
+    // The server produced a matching response, so the socket has no
+    // outstanding query left and may be reused; see the destructor.
+    socket_reusable_ = true;
     if (response_->flags() & dns_protocol::kFlagTC)
       return ERR_DNS_SERVER_REQUIRES_TCP;
     // TODO(szym): Extract TTL for NXDOMAIN results. http://crbug.com/115051
@@ -242,10 +260,13 @@ class DnsUDPAttempt {
       callback_.Run(rv);
   }
 
+  DnsSession* session_;
+  unsigned server_index_;
   State next_state_;
+  bool needs_connect_;
+  bool socket_reusable_;
 
   scoped_ptr<DatagramClientSocket> socket_;
-  IPEndPoint server_;
   scoped_ptr<DnsQuery> query_;
 
   scoped_ptr<DnsResponse> response_;
@@ -405,20 +426,30 @@ class DnsTransactionImpl : public DnsTransaction,
   AttemptResult MakeAttempt() {
     unsigned attempt_number = attempts_.size();
 
+    const DnsConfig& config = session_->config();
+
+    unsigned server_index = first_server_index_ +
+        (attempt_number % config.nameservers.size());
+
+    // Prefer a socket released by an earlier query to this server; a fresh
+    // socket costs a creation, a bind and a connect per attempt.
+    bool needs_connect = false;
+    scoped_ptr<DatagramClientSocket> socket(
+        session_->AllocateSocket(server_index));
+    if (!socket.get()) {
 #if defined(OS_WIN)
-    // Avoid the Windows firewall warning about explicit UDP binding.
-    // TODO(szym): Reuse a pool of pre-bound sockets. http://crbug.com/107413
-    DatagramSocket::BindType bind_type = DatagramSocket::DEFAULT_BIND;
+      // Avoid the Windows firewall warning about explicit UDP binding.
+      DatagramSocket::BindType bind_type = DatagramSocket::DEFAULT_BIND;
 #else
-    DatagramSocket::BindType bind_type = DatagramSocket::RANDOM_BIND;
+      DatagramSocket::BindType bind_type = DatagramSocket::RANDOM_BIND;
 #endif
-
-    scoped_ptr<DatagramClientSocket> socket(
-        session_->socket_factory()->CreateDatagramClientSocket(
-            bind_type,
-            base::Bind(&base::RandInt),
-            net_log_.net_log(),
-            net_log_.source()));
+      socket.reset(session_->socket_factory()->CreateDatagramClientSocket(
+          bind_type,
+          base::Bind(&base::RandInt),
+          net_log_.net_log(),
+          net_log_.source()));
+      needs_connect = true;
+    }
 
     uint16 id = session_->NextQueryId();
     scoped_ptr<DnsQuery> query;
@@ -432,14 +463,11 @@ class DnsTransactionImpl : public DnsTransaction,
         new NetLogSourceParameter("source_dependency",
                                   socket->NetLog().source())));
 
-    const DnsConfig& config = session_->config();
-
-    unsigned server_index = first_server_index_ +
-        (attempt_number % config.nameservers.size());
-
     DnsUDPAttempt* attempt = new DnsUDPAttempt(
+        session_,
+        server_index,
         socket.Pass(),
-        config.nameservers[server_index],
+        needs_connect,
         query.Pass(),
         base::Bind(&DnsTransactionImpl::OnAttemptComplete,
                    base::Unretained(this),
@@ -577,12 +605,182 @@ class DnsTransactionImpl : public DnsTransaction,
 
 // ----------------------------------------------------------------------------
 
+// Shares one DnsTransactionImpl among all concurrently started transactions
+// which ask the same question, so that identical in-flight (hostname, qtype)
+// pairs issued by different HostResolverImpl jobs cost a single query.
+// Ref-counted because transactions may outlive the factory.
+class DnsTransactionCoalescer
+    : public base::RefCounted<DnsTransactionCoalescer>,
+      public base::NonThreadSafe {
+ public:
+  // The transaction handed out to clients; attaches to an in-flight question
+  // on Start() and detaches (cancelling the question if it was the last
+  // waiter) on destruction.
+  class CoalescedTransaction : public DnsTransaction {
+   public:
+    CoalescedTransaction(DnsTransactionCoalescer* coalescer,
+                         const std::string& hostname,
+                         uint16 qtype,
+                         const DnsTransactionFactory::CallbackType& callback,
+                         const BoundNetLog& net_log)
+        : coalescer_(coalescer),
+          hostname_(hostname),
+          qtype_(qtype),
+          callback_(callback),
+          net_log_(net_log),
+          started_(false) {
+      DCHECK(!callback_.is_null());
+    }
+
+    virtual ~CoalescedTransaction() {
+      if (started_ && !callback_.is_null())
+        coalescer_->Detach(this);
+    }
+
+    virtual const std::string& GetHostname() const OVERRIDE {
+      return hostname_;
+    }
+
+    virtual uint16 GetType() const OVERRIDE {
+      return qtype_;
+    }
+
+    virtual int Start() OVERRIDE {
+      DCHECK(!started_);
+      started_ = true;
+      return coalescer_->Start(this);
+    }
+
+    const BoundNetLog& net_log() const { return net_log_; }
+
+    // Runs the client callback with the shared result. Careful; the callback
+    // might destroy |this|.
+    void DispatchResult(int neterror, const DnsResponse* response) {
+      DnsTransactionFactory::CallbackType callback = callback_;
+      callback_.Reset();
+      callback.Run(this, neterror, response);
+    }
+
+   private:
+    scoped_refptr<DnsTransactionCoalescer> coalescer_;
+    const std::string hostname_;
+    const uint16 qtype_;
+    // Cleared in DispatchResult.
+    DnsTransactionFactory::CallbackType callback_;
+    BoundNetLog net_log_;
+    bool started_;
+
+    DISALLOW_COPY_AND_ASSIGN(CoalescedTransaction);
+  };
+
+  explicit DnsTransactionCoalescer(DnsSession* session) : session_(session) {}
+
+  scoped_ptr<DnsTransaction> CreateTransaction(
+      const std::string& hostname,
+      uint16 qtype,
+      const DnsTransactionFactory::CallbackType& callback,
+      const BoundNetLog& net_log) {
+    return scoped_ptr<DnsTransaction>(
+        new CoalescedTransaction(this, hostname, qtype, callback, net_log));
+  }
+
+ private:
+  friend class base::RefCounted<DnsTransactionCoalescer>;
+
+  typedef std::pair<std::string, uint16> QuestionKey;
+
+  // An in-flight question and the transactions waiting for its answer.
+  struct Question {
+    scoped_ptr<DnsTransaction> transaction;
+    std::deque<CoalescedTransaction*> waiters;
+  };
+
+  typedef std::map<QuestionKey, Question*> QuestionMap;
+
+  ~DnsTransactionCoalescer() {
+    DCHECK(questions_.empty());
+  }
+
+  // Attaches |waiter| to the in-flight question it asks, starting the real
+  // transaction if there is none. Returns a net error or ERR_IO_PENDING.
+  int Start(CoalescedTransaction* waiter) {
+    DCHECK(CalledOnValidThread());
+    QuestionKey key(waiter->GetHostname(), waiter->GetType());
+    QuestionMap::iterator it = questions_.find(key);
+    if (it != questions_.end()) {
+      it->second->waiters.push_back(waiter);
+      return ERR_IO_PENDING;
+    }
+
+    scoped_ptr<Question> question(new Question());
+    question->transaction.reset(new DnsTransactionImpl(
+        session_,
+        waiter->GetHostname(),
+        waiter->GetType(),
+        base::Bind(&DnsTransactionCoalescer::OnQuestionComplete, this, key),
+        waiter->net_log()));
+    int rv = question->transaction->Start();
+    if (rv != ERR_IO_PENDING)
+      return rv;
+    question->waiters.push_back(waiter);
+    questions_[key] = question.release();
+    return ERR_IO_PENDING;
+  }
+
+  // Removes |waiter| from its question, if still in flight. Cancels the
+  // question once the last waiter is gone.
+  void Detach(CoalescedTransaction* waiter) {
+    DCHECK(CalledOnValidThread());
+    QuestionKey key(waiter->GetHostname(), waiter->GetType());
+    QuestionMap::iterator it = questions_.find(key);
+    if (it == questions_.end())
+      return;
+    Question* question = it->second;
+    std::deque<CoalescedTransaction*>::iterator w = std::find(
+        question->waiters.begin(), question->waiters.end(), waiter);
+    if (w == question->waiters.end())
+      return;
+    question->waiters.erase(w);
+    if (question->waiters.empty()) {
+      questions_.erase(it);
+      delete question;
+    }
+  }
+
+  void OnQuestionComplete(const QuestionKey& key,
+                          DnsTransaction* transaction,
+                          int neterror,
+                          const DnsResponse* response) {
+    DCHECK(CalledOnValidThread());
+    QuestionMap::iterator it = questions_.find(key);
+    DCHECK(it != questions_.end());
+    scoped_ptr<Question> question(it->second);
+    questions_.erase(it);
+    // A dispatched callback may destroy other waiters; they unregister from
+    // |question| through Detach, which no longer finds it in the map.
+    while (!question->waiters.empty()) {
+      CoalescedTransaction* waiter = question->waiters.front();
+      question->waiters.pop_front();
+      waiter->DispatchResult(neterror, response);
+    }
+    // |response| is owned by |question->transaction|, so the underlying
+    // transaction must outlive the dispatch above.
+  }
+
+  scoped_refptr<DnsSession> session_;
+  QuestionMap questions_;
+
+  DISALLOW_COPY_AND_ASSIGN(DnsTransactionCoalescer);
+};
+
+// ----------------------------------------------------------------------------
+
 // Implementation of DnsTransactionFactory that returns instances of
-// DnsTransactionImpl.
+// CoalescedTransaction sharing one DnsTransactionCoalescer.
 class DnsTransactionFactoryImpl : public DnsTransactionFactory {
  public:
-  explicit DnsTransactionFactoryImpl(DnsSession* session) {
-    session_ = session;
+  explicit DnsTransactionFactoryImpl(DnsSession* session)
+      : coalescer_(new DnsTransactionCoalescer(session)) {
   }
 
   virtual scoped_ptr<DnsTransaction> CreateTransaction(
@@ -590,15 +788,11 @@ class DnsTransactionFactoryImpl : public DnsTransactionFactory {
       uint16 qtype,
       const CallbackType& callback,
       const BoundNetLog& net_log) OVERRIDE {
-    return scoped_ptr<DnsTransaction>(new DnsTransactionImpl(session_,
-                                                             hostname,
-                                                             qtype,
-                                                             callback,
-                                                             net_log));
+    return coalescer_->CreateTransaction(hostname, qtype, callback, net_log);
   }
 
  private:
-  scoped_refptr<DnsSession> session_;
+  scoped_refptr<DnsTransactionCoalescer> coalescer_;
 };
 
 }  // namespace
@@ -218,6 +218,9 @@ class DnsTransactionTest : public testing::Test {
         socket_factory_.get(),
         base::Bind(&DnsTransactionTest::GetNextId, base::Unretained(this)),
         NULL /* NetLog */);
+    // Each query below is scripted with its own mock socket, so the sockets
+    // must not be reused across queries.
+    session_->set_socket_reuse_enabled(false);
     transaction_factory_ = DnsTransactionFactory::CreateFactory(session_.get());
   }
 
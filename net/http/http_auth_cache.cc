@@ -59,18 +59,41 @@ struct IsEnclosedBy {
 
 namespace net {
 
-HttpAuthCache::HttpAuthCache() {
+HttpAuthCache::HttpAuthCache() : origin_filter_(0) {
 }
 
 HttpAuthCache::~HttpAuthCache() {
 }
 
-// Performance: O(n), where n is the number of realm entries.
+// static
+uint32 HttpAuthCache::OriginFilterMask(const GURL& origin) {
+  // Same string hash as base/hash_tables.h uses for std::string, folded down
+  // to two bits out of 32. False positives just fall through to the scan.
+  uint32 hash = 0;
+  const std::string& spec = origin.possibly_invalid_spec();
+  for (std::string::const_iterator it = spec.begin(); it != spec.end(); ++it)
+    hash = hash * 131 + *it;
+  return (1u << (hash & 0x1f)) | (1u << ((hash >> 5) & 0x1f));
+}
+
+void HttpAuthCache::RebuildOriginFilter() {
+  origin_filter_ = 0;
+  for (EntryList::const_iterator it = entries_.begin(); it != entries_.end();
+       ++it)
+    origin_filter_ |= OriginFilterMask(it->origin());
+}
+
+// Performance: one filter test in the common no-entry case, otherwise O(n),
+// where n is the number of realm entries.
 HttpAuthCache::Entry* HttpAuthCache::Lookup(const GURL& origin,
                                             const std::string& realm,
                                             HttpAuth::Scheme scheme) {
   CheckOriginIsValid(origin);
 
+  const uint32 mask = OriginFilterMask(origin);
+  if ((origin_filter_ & mask) != mask)
+    return NULL;  // Definitely no entry for this origin.
+
   // Linear scan through the realm entries.
   for (EntryList::iterator it = entries_.begin(); it != entries_.end(); ++it) {
     if (it->origin() == origin && it->realm() == realm &&
@@ -80,9 +103,10 @@ HttpAuthCache::Entry* HttpAuthCache::Lookup(const GURL& origin,
   return NULL;  // No realm entry found.
 }
 
-// Performance: O(n*m), where n is the number of realm entries, m is the number
-// of path entries per realm. Both n amd m are expected to be small; m is
-// kept small because AddPath() only keeps the shallowest entry.
+// Performance: one filter test in the common no-entry case, otherwise O(n*m),
+// where n is the number of realm entries, m is the number of path entries per
+// realm. Both n amd m are expected to be small; m is kept small because
+// AddPath() only keeps the shallowest entry.
 HttpAuthCache::Entry* HttpAuthCache::LookupByPath(const GURL& origin,
                                                   const std::string& path) {
   HttpAuthCache::Entry* best_match = NULL;
@@ -90,6 +114,10 @@ HttpAuthCache::Entry* HttpAuthCache::LookupByPath(const GURL& origin,
   CheckOriginIsValid(origin);
   CheckPathIsValid(path);
 
+  const uint32 mask = OriginFilterMask(origin);
+  if ((origin_filter_ & mask) != mask)
+    return NULL;  // Definitely no entry for this origin.
+
   // RFC 2617 section 2:
   // A client SHOULD assume that all paths at or deeper than the depth of
   // the last symbolic element in the path field of the Request-URI also are
@@ -124,6 +152,7 @@ HttpAuthCache::Entry* HttpAuthCache::Add(const GURL& origin,
     if (entries_.size() >= kMaxNumRealmEntries) {
       LOG(WARNING) << "Num auth cache entries reached limit -- evicting";
       entries_.pop_back();
+      RebuildOriginFilter();
     }
 
     entries_.push_front(Entry());
@@ -131,6 +160,7 @@ HttpAuthCache::Entry* HttpAuthCache::Add(const GURL& origin,
     entry->origin_ = origin;
     entry->realm_ = realm;
     entry->scheme_ = scheme;
+    origin_filter_ |= OriginFilterMask(origin);
   }
   DCHECK_EQ(origin, entry->origin_);
   DCHECK_EQ(realm, entry->realm_);
@@ -203,6 +233,7 @@ bool HttpAuthCache::Remove(const GURL& origin,
         it->scheme() == scheme) {
       if (credentials.Equals(it->credentials())) {
         entries_.erase(it);
+        RebuildOriginFilter();
         return true;
       }
       return false;
@@ -9,6 +9,7 @@
 #include <list>
 #include <string>
 
+#include "base/basictypes.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
 #include "googleurl/src/gurl.h"
@@ -103,7 +104,20 @@ class NET_EXPORT_PRIVATE HttpAuthCache {
 
  private:
   typedef std::list<Entry> EntryList;
+
+  // Returns the bloom filter bits for |origin|. See |origin_filter_|.
+  static uint32 OriginFilterMask(const GURL& origin);
+
+  // Recomputes |origin_filter_| from |entries_|. Called whenever an entry is
+  // removed, since bloom filters don't support deletion.
+  void RebuildOriginFilter();
+
   EntryList entries_;
+
+  // A tiny bloom filter over the origins of |entries_|. Most requests have no
+  // cached auth entry at all; testing this filter lets them skip the entry
+  // scan entirely. Zero when the cache is empty.
+  uint32 origin_filter_;
 };
 
 // An authentication realm entry.
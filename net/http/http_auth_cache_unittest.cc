@@ -387,6 +387,32 @@ TEST(HttpAuthCacheTest, Remove) {
   EXPECT_FALSE(NULL == entry);
 }
 
+TEST(HttpAuthCacheTest, LookupAfterRemoveLastEntryForOrigin) {
+  GURL origin("http://foobar.com");
+  GURL other_origin("http://other.com");
+
+  scoped_ptr<HttpAuthHandler> realm1_handler(
+      new MockAuthHandler(
+          HttpAuth::AUTH_SCHEME_BASIC, kRealm1, HttpAuth::AUTH_SERVER));
+
+  HttpAuthCache cache;
+  cache.Add(origin, realm1_handler->realm(), realm1_handler->auth_scheme(),
+            "basic realm=Realm1", AuthCredentials(kAlice, k123), "/");
+
+  // An origin with no entries misses in both lookups.
+  EXPECT_TRUE(NULL == cache.Lookup(
+      other_origin, kRealm1, HttpAuth::AUTH_SCHEME_BASIC));
+  EXPECT_TRUE(NULL == cache.LookupByPath(other_origin, "/"));
+
+  // Removing the origin's only entry makes its lookups miss as well.
+  EXPECT_TRUE(cache.Remove(
+      origin, kRealm1, HttpAuth::AUTH_SCHEME_BASIC,
+      AuthCredentials(kAlice, k123)));
+  EXPECT_TRUE(NULL == cache.Lookup(
+      origin, kRealm1, HttpAuth::AUTH_SCHEME_BASIC));
+  EXPECT_TRUE(NULL == cache.LookupByPath(origin, "/"));
+}
+
 TEST(HttpAuthCacheTest, UpdateStaleChallenge) {
   HttpAuthCache cache;
   GURL origin("http://foobar2.com");
@@ -42,6 +42,11 @@ namespace net {
 
 namespace {
 
+// Used to wake a parked streaming reader from a posted task.
+void RunTransactionCallback(const net::CompletionCallback& callback) {
+  callback.Run(OK);
+}
+
 HttpNetworkSession* CreateNetworkSession(
     HostResolver* host_resolver,
     CertVerifier* cert_verifier,
@@ -106,7 +111,8 @@ HttpCache::ActiveEntry::ActiveEntry(disk_cache::Entry* entry)
     : disk_entry(entry),
       writer(NULL),
       will_process_pending_queue(false),
-      doomed(false) {
+      doomed(false),
+      writer_failed(false) {
 }
 
 HttpCache::ActiveEntry::~ActiveEntry() {
@@ -369,6 +375,8 @@ HttpCache::~HttpCache() {
     entry->will_process_pending_queue = false;
     entry->pending_queue.clear();
     entry->readers.clear();
+    entry->streaming_readers.clear();
+    entry->waiting_readers.clear();
     entry->writer = NULL;
     DeactivateEntry(entry);
   }
@@ -617,7 +625,8 @@ int HttpCache::DoomEntry(const std::string& key, Transaction* trans) {
   entry->disk_entry->Doom();
   entry->doomed = true;
 
-  DCHECK(entry->writer || !entry->readers.empty());
+  DCHECK(entry->writer || !entry->readers.empty() ||
+         !entry->streaming_readers.empty());
   return OK;
 }
 
@@ -649,6 +658,7 @@ void HttpCache::FinalizeDoomedEntry(ActiveEntry* entry) {
   DCHECK(entry->doomed);
   DCHECK(!entry->writer);
   DCHECK(entry->readers.empty());
+  DCHECK(entry->streaming_readers.empty());
   DCHECK(entry->pending_queue.empty());
 
   ActiveEntriesSet::iterator it = doomed_entries_.find(entry);
@@ -677,6 +687,7 @@ void HttpCache::DeactivateEntry(ActiveEntry* entry) {
   DCHECK(!entry->writer);
   DCHECK(entry->disk_entry);
   DCHECK(entry->readers.empty());
+  DCHECK(entry->streaming_readers.empty());
   DCHECK(entry->pending_queue.empty());
 
   std::string key = entry->disk_entry->GetKey();
@@ -817,6 +828,16 @@ int HttpCache::AddTransactionToEntry(ActiveEntry* entry, Transaction* trans) {
   // use (since any existing entry should have already been doomed).
 
   if (entry->writer || entry->will_process_pending_queue) {
+    if (entry->writer && !entry->will_process_pending_queue &&
+        !entry->writer_failed && trans->CanStreamFromWriter() &&
+        entry->writer->CanStreamReaders()) {
+      // The writer has committed the response headers already, so |trans|
+      // can consume the body as it is appended instead of waiting for the
+      // writer to finish.
+      trans->set_streaming_reader(true);
+      entry->streaming_readers.push_back(trans);
+      return OK;
+    }
     entry->pending_queue.push_back(trans);
     return ERR_IO_PENDING;
   }
@@ -850,9 +871,7 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
   if (entry->will_process_pending_queue && entry->readers.empty())
     return;
 
-  if (entry->writer) {
-    DCHECK(trans == entry->writer);
-
+  if (entry->writer == trans) {
     // Assume there was a failure.
     bool success = false;
     if (cancel) {
@@ -860,6 +879,10 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
       // This is a successful operation in the sense that we want to keep the
       // entry.
       success = trans->AddTruncatedFlag();
+      // Streaming readers cannot resume a truncated entry, so they have to
+      // fail even if the entry itself is kept.
+      if (!entry->streaming_readers.empty())
+        entry->writer_failed = true;
     }
     DoneWritingToEntry(entry, success);
   } else {
@@ -873,6 +896,13 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
   entry->writer = NULL;
 
   if (success) {
+    // Streaming readers become plain readers of the finished entry, and the
+    // parked ones resume to consume whatever is left.
+    entry->readers.insert(entry->readers.end(),
+                          entry->streaming_readers.begin(),
+                          entry->streaming_readers.end());
+    entry->streaming_readers.clear();
+    WriterProgressed(entry);
     ProcessPendingQueue(entry);
   } else {
     DCHECK(!entry->will_process_pending_queue);
@@ -882,7 +912,25 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
     pending_queue.swap(entry->pending_queue);
 
     entry->disk_entry->Doom();
-    DestroyEntry(entry);
+
+    if (entry->streaming_readers.empty()) {
+      DestroyEntry(entry);
+    } else {
+      // Streaming readers are still attached to the entry, so it can only be
+      // destroyed when the last one detaches. They notice the failure when
+      // they run out of data (see Transaction::DoCacheReadDataComplete).
+      entry->writer_failed = true;
+      entry->doomed = true;
+      doomed_entries_.insert(entry);
+      for (ActiveEntriesMap::iterator it = active_entries_.begin();
+           it != active_entries_.end(); ++it) {
+        if (it->second == entry) {
+          active_entries_.erase(it);
+          break;
+        }
+      }
+      WriterProgressed(entry);
+    }
 
     // We need to do something about these pending entries, which now need to
     // be added to a new entry.
@@ -895,15 +943,26 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
 }
 
 void HttpCache::DoneReadingFromEntry(ActiveEntry* entry, Transaction* trans) {
-  DCHECK(!entry->writer);
-
   TransactionList::iterator it =
       std::find(entry->readers.begin(), entry->readers.end(), trans);
-  DCHECK(it != entry->readers.end());
-
-  entry->readers.erase(it);
+  if (it != entry->readers.end()) {
+    DCHECK(!entry->writer);
+    entry->readers.erase(it);
+  } else {
+    // A streaming reader detaching, possibly while parked and possibly while
+    // the writer is still working on the entry.
+    it = std::find(entry->streaming_readers.begin(),
+                   entry->streaming_readers.end(), trans);
+    DCHECK(it != entry->streaming_readers.end());
+    entry->streaming_readers.erase(it);
+    it = std::find(entry->waiting_readers.begin(),
+                   entry->waiting_readers.end(), trans);
+    if (it != entry->waiting_readers.end())
+      entry->waiting_readers.erase(it);
+  }
 
-  ProcessPendingQueue(entry);
+  if (!entry->writer)
+    ProcessPendingQueue(entry);
 }
 
 void HttpCache::ConvertWriterToReader(ActiveEntry* entry) {
@@ -916,9 +975,35 @@ void HttpCache::ConvertWriterToReader(ActiveEntry* entry) {
   entry->writer = NULL;
   entry->readers.push_back(trans);
 
+  // Streaming readers are plain readers from now on.
+  entry->readers.insert(entry->readers.end(),
+                        entry->streaming_readers.begin(),
+                        entry->streaming_readers.end());
+  entry->streaming_readers.clear();
+  WriterProgressed(entry);
+
   ProcessPendingQueue(entry);
 }
 
+void HttpCache::WaitForWriterProgress(ActiveEntry* entry, Transaction* trans) {
+  DCHECK(entry->writer);
+  DCHECK(std::find(entry->streaming_readers.begin(),
+                   entry->streaming_readers.end(),
+                   trans) != entry->streaming_readers.end());
+  entry->waiting_readers.push_back(trans);
+}
+
+void HttpCache::WriterProgressed(ActiveEntry* entry) {
+  while (!entry->waiting_readers.empty()) {
+    Transaction* trans = entry->waiting_readers.front();
+    entry->waiting_readers.erase(entry->waiting_readers.begin());
+    // The callback is bound to a weak pointer, so this is safe even if the
+    // transaction goes away before the task runs.
+    MessageLoop::current()->PostTask(
+        FROM_HERE, base::Bind(&RunTransactionCallback, trans->io_callback()));
+  }
+}
+
 LoadState HttpCache::GetLoadStateForPendingTransaction(
       const Transaction* trans) {
   ActiveEntriesMap::const_iterator i = active_entries_.find(trans->key());
@@ -1018,14 +1103,15 @@ void HttpCache::OnProcessPendingQueue(ActiveEntry* entry) {
 
   // If no one is interested in this entry, then we can deactivate it.
   if (entry->pending_queue.empty()) {
-    if (entry->readers.empty())
+    if (entry->readers.empty() && entry->streaming_readers.empty())
       DestroyEntry(entry);
     return;
   }
 
   // Promote next transaction from the pending queue.
   Transaction* next = entry->pending_queue.front();
-  if ((next->mode() & Transaction::WRITE) && !entry->readers.empty())
+  if ((next->mode() & Transaction::WRITE) &&
+      (!entry->readers.empty() || !entry->streaming_readers.empty()))
     return;  // Have to wait.
 
   entry->pending_queue.erase(entry->pending_queue.begin());
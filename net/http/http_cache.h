@@ -228,9 +228,17 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
     disk_cache::Entry* disk_entry;
     Transaction*       writer;
     TransactionList    readers;
+    // Transactions reading this entry while |writer| is still appending to
+    // it, and the subset of them that caught up with the writer and wait for
+    // more data.
+    TransactionList    streaming_readers;
+    TransactionList    waiting_readers;
     TransactionList    pending_queue;
     bool               will_process_pending_queue;
     bool               doomed;
+    // Set when the writer failed or stopped before the end of the response;
+    // streaming readers cannot complete from this entry.
+    bool               writer_failed;
   };
 
   typedef base::hash_map<std::string, ActiveEntry*> ActiveEntriesMap;
@@ -330,6 +338,14 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // transactions can start reading from this entry.
   void ConvertWriterToReader(ActiveEntry* entry);
 
+  // Parks |trans|, a streaming reader that caught up with the writer of
+  // |entry|, until the writer makes progress with the entry.
+  void WaitForWriterProgress(ActiveEntry* entry, Transaction* trans);
+
+  // Wakes the streaming readers parked on |entry|. Called whenever the
+  // writer appends data to the entry or lets go of it.
+  void WriterProgressed(ActiveEntry* entry);
+
   // Returns the LoadState of the provided pending transaction.
   LoadState GetLoadStateForPendingTransaction(const Transaction* trans);
 
@@ -0,0 +1,488 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_cache_hybrid_backend.h"
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/stringprintf.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/disk_cache/mem_backend_impl.h"
+
+namespace net {
+
+namespace {
+
+// Entries larger than this never enter the memory tier; it is meant for the
+// favicon / small script / style sheet class of responses, and one large
+// response would evict many of them.
+const int kMaxHotEntryBytes = 64 * 1024;
+
+}  // namespace
+
+// An Entry that keeps a memory tier copy synchronized with the disk entry.
+// Every write is applied to both copies, and reads are served from the
+// memory copy while it exists. |disk_entry| is NULL when the shim was
+// created from a memory tier hit; in that case the disk entry is opened on
+// demand by the first write, so pure read traffic never reaches the cache
+// thread.
+class HybridCacheBackend::EntryShim : public disk_cache::Entry {
+ public:
+  EntryShim(disk_cache::Backend* disk_backend,
+            disk_cache::Entry* disk_entry,
+            disk_cache::Entry* ram_entry)
+      : disk_backend_(disk_backend),
+        disk_entry_(disk_entry),
+        ram_entry_(ram_entry),
+        pending_disk_entry_(NULL),
+        pending_index_(0),
+        pending_offset_(0),
+        pending_buf_len_(0),
+        pending_truncate_(false),
+        chain_result_(net::OK),
+        sync_in_progress_(false),
+        busy_(false),
+        closed_(false) {
+    key_ = primary()->GetKey();
+  }
+
+  // disk_cache::Entry interface.
+  virtual void Doom() OVERRIDE {
+    if (ram_entry_)
+      ram_entry_->Doom();
+    if (disk_entry_)
+      disk_entry_->Doom();
+    else
+      disk_backend_->DoomEntry(key_, CompletionCallback());
+  }
+
+  virtual void Close() OVERRIDE {
+    if (ram_entry_) {
+      ram_entry_->Close();
+      ram_entry_ = NULL;
+    }
+    if (busy_) {
+      // CompleteChain() finishes the cleanup when the write-through lands.
+      closed_ = true;
+      return;
+    }
+    if (disk_entry_)
+      disk_entry_->Close();
+    delete this;
+  }
+
+  virtual std::string GetKey() const OVERRIDE {
+    return key_;
+  }
+
+  virtual base::Time GetLastUsed() const OVERRIDE {
+    return primary() ? primary()->GetLastUsed() : base::Time();
+  }
+
+  virtual base::Time GetLastModified() const OVERRIDE {
+    return primary() ? primary()->GetLastModified() : base::Time();
+  }
+
+  virtual int32 GetDataSize(int index) const OVERRIDE {
+    return primary() ? primary()->GetDataSize(index) : 0;
+  }
+
+  virtual int ReadData(int index, int offset, IOBuffer* buf, int buf_len,
+                       const CompletionCallback& callback) OVERRIDE {
+    if (ram_entry_)
+      return ram_entry_->ReadData(index, offset, buf, buf_len,
+                                  CompletionCallback());
+    if (!disk_entry_)
+      return net::ERR_FAILED;
+    return disk_entry_->ReadData(index, offset, buf, buf_len, callback);
+  }
+
+  virtual int WriteData(int index, int offset, IOBuffer* buf, int buf_len,
+                        const CompletionCallback& callback,
+                        bool truncate) OVERRIDE {
+    DCHECK(!busy_);
+    MirrorWrite(index, offset, buf, buf_len, truncate);
+    if (disk_entry_)
+      return disk_entry_->WriteData(index, offset, buf, buf_len, callback,
+                                    truncate);
+    if (callback.is_null()) {
+      // We cannot block while the disk entry is opened. Keep the memory
+      // copy and doom the now stale disk copy so it cannot be served later.
+      disk_backend_->DoomEntry(key_, CompletionCallback());
+      return ram_entry_ ? buf_len : net::ERR_FAILED;
+    }
+
+    // First write on a memory tier hit: open the disk entry and replay the
+    // write on it.
+    busy_ = true;
+    chain_result_ = net::ERR_IO_PENDING;
+    pending_callback_ = callback;
+    pending_index_ = index;
+    pending_offset_ = offset;
+    pending_buf_ = buf;
+    pending_buf_len_ = buf_len;
+    pending_truncate_ = truncate;
+
+    sync_in_progress_ = true;
+    int rv = disk_backend_->OpenEntry(
+        key_, &pending_disk_entry_,
+        base::Bind(&EntryShim::OnDiskEntryAvailable, base::Unretained(this)));
+    if (rv != net::ERR_IO_PENDING)
+      OnDiskEntryAvailable(rv);
+    sync_in_progress_ = false;
+
+    if (chain_result_ == net::ERR_IO_PENDING)
+      return net::ERR_IO_PENDING;
+    busy_ = false;
+    pending_callback_.Reset();
+    return chain_result_;
+  }
+
+  virtual int ReadSparseData(int64 offset, IOBuffer* buf, int buf_len,
+                             const CompletionCallback& callback) OVERRIDE {
+    if (disk_entry_)
+      return disk_entry_->ReadSparseData(offset, buf, buf_len, callback);
+    if (!ram_entry_)
+      return net::ERR_FAILED;
+    return ram_entry_->ReadSparseData(offset, buf, buf_len,
+                                      CompletionCallback());
+  }
+
+  virtual int WriteSparseData(int64 offset, IOBuffer* buf, int buf_len,
+                              const CompletionCallback& callback) OVERRIDE {
+    // A sparse entry cannot be kept coherent in the memory tier.
+    if (ram_entry_)
+      DropRamCopy();
+    if (disk_entry_)
+      return disk_entry_->WriteSparseData(offset, buf, buf_len, callback);
+    disk_backend_->DoomEntry(key_, CompletionCallback());
+    return net::ERR_CACHE_OPERATION_NOT_SUPPORTED;
+  }
+
+  virtual int GetAvailableRange(int64 offset, int len, int64* start,
+                                const CompletionCallback& callback) OVERRIDE {
+    if (disk_entry_)
+      return disk_entry_->GetAvailableRange(offset, len, start, callback);
+    if (!ram_entry_)
+      return net::ERR_FAILED;
+    return ram_entry_->GetAvailableRange(offset, len, start,
+                                         CompletionCallback());
+  }
+
+  virtual bool CouldBeSparse() const OVERRIDE {
+    return primary() ? primary()->CouldBeSparse() : false;
+  }
+
+  virtual void CancelSparseIO() OVERRIDE {
+    if (ram_entry_)
+      ram_entry_->CancelSparseIO();
+    if (disk_entry_)
+      disk_entry_->CancelSparseIO();
+  }
+
+  virtual int ReadyForSparseIO(const CompletionCallback& callback) OVERRIDE {
+    if (disk_entry_)
+      return disk_entry_->ReadyForSparseIO(callback);
+    return net::OK;
+  }
+
+ private:
+  virtual ~EntryShim() {}
+
+  disk_cache::Entry* primary() {
+    return ram_entry_ ? ram_entry_ : disk_entry_;
+  }
+
+  const disk_cache::Entry* primary() const {
+    return ram_entry_ ? ram_entry_ : disk_entry_;
+  }
+
+  // Applies a write to the memory copy, dropping the copy if it can no
+  // longer be kept coherent (too large, or rejected by the memory backend).
+  void MirrorWrite(int index, int offset, IOBuffer* buf, int buf_len,
+                   bool truncate) {
+    if (!ram_entry_)
+      return;
+    if (offset + buf_len > kMaxHotEntryBytes) {
+      DropRamCopy();
+      return;
+    }
+    int rv = ram_entry_->WriteData(index, offset, buf, buf_len,
+                                   CompletionCallback(), truncate);
+    if (rv != buf_len)
+      DropRamCopy();
+  }
+
+  void DropRamCopy() {
+    ram_entry_->Doom();
+    ram_entry_->Close();
+    ram_entry_ = NULL;
+  }
+
+  // Continues the deferred write once the disk entry open finished.
+  void OnDiskEntryAvailable(int result) {
+    if (result != net::OK) {
+      // The disk copy is gone (evicted, for instance). Writing only part of
+      // the entry to a fresh disk entry would leave a truncated copy behind,
+      // so serve from the memory copy alone until it gets evicted too.
+      CompleteChain(ram_entry_ ? pending_buf_len_ : result);
+      return;
+    }
+    disk_entry_ = pending_disk_entry_;
+    pending_disk_entry_ = NULL;
+    int rv = disk_entry_->WriteData(
+        pending_index_, pending_offset_, pending_buf_, pending_buf_len_,
+        base::Bind(&EntryShim::CompleteChain, base::Unretained(this)),
+        pending_truncate_);
+    pending_buf_ = NULL;
+    if (rv != net::ERR_IO_PENDING)
+      CompleteChain(rv);
+  }
+
+  // Last step of the deferred write.
+  void CompleteChain(int result) {
+    if (sync_in_progress_) {
+      chain_result_ = result;
+      return;
+    }
+    busy_ = false;
+    CompletionCallback callback = pending_callback_;
+    pending_callback_.Reset();
+    if (closed_) {
+      // Closed while the write-through was in flight; finish the cleanup
+      // that Close() deferred. The callback still runs, as promised by the
+      // Entry contract.
+      if (disk_entry_)
+        disk_entry_->Close();
+      delete this;
+      callback.Run(result);
+      return;
+    }
+    callback.Run(result);  // May delete this object (via Close).
+  }
+
+  disk_cache::Backend* disk_backend_;
+  disk_cache::Entry* disk_entry_;
+  disk_cache::Entry* ram_entry_;
+  std::string key_;
+
+  // State of a write waiting for the disk entry to be opened.
+  disk_cache::Entry* pending_disk_entry_;
+  int pending_index_;
+  int pending_offset_;
+  scoped_refptr<IOBuffer> pending_buf_;
+  int pending_buf_len_;
+  bool pending_truncate_;
+  CompletionCallback pending_callback_;
+  int chain_result_;
+  bool sync_in_progress_;
+
+  bool busy_;
+  bool closed_;
+
+  DISALLOW_COPY_AND_ASSIGN(EntryShim);
+};
+
+struct HybridCacheBackend::PendingEntry {
+  PendingEntry(disk_cache::Entry** entry, const CompletionCallback& callback)
+      : entry(entry), disk_entry(NULL), ram_entry(NULL), callback(callback) {}
+
+  disk_cache::Entry** entry;
+  disk_cache::Entry* disk_entry;
+  disk_cache::Entry* ram_entry;
+  CompletionCallback callback;
+};
+
+HybridCacheBackend::HybridCacheBackend(disk_cache::Backend* disk_backend,
+                                       int max_ram_bytes,
+                                       NetLog* net_log)
+    : ram_backend_(
+          disk_cache::MemBackendImpl::CreateBackend(max_ram_bytes, net_log)),
+      disk_backend_(disk_backend) {
+}
+
+HybridCacheBackend::~HybridCacheBackend() {
+  // Cancel in-flight operations before touching their state.
+  disk_backend_.reset();
+  for (std::set<PendingEntry*>::iterator it = pending_entries_.begin();
+       it != pending_entries_.end(); ++it) {
+    if ((*it)->ram_entry) {
+      (*it)->ram_entry->Doom();
+      (*it)->ram_entry->Close();
+    }
+    delete *it;
+  }
+}
+
+int32 HybridCacheBackend::GetEntryCount() const {
+  return disk_backend_->GetEntryCount();
+}
+
+int HybridCacheBackend::OpenEntry(const std::string& key,
+                                  disk_cache::Entry** entry,
+                                  const CompletionCallback& callback) {
+  if (ram_backend_.get()) {
+    disk_cache::Entry* ram_entry = NULL;
+    if (ram_backend_->OpenEntry(key, &ram_entry, CompletionCallback()) ==
+        net::OK) {
+      *entry = new EntryShim(disk_backend_.get(), NULL, ram_entry);
+      return net::OK;
+    }
+  }
+  // A miss in the memory tier is served by the disk backend directly; there
+  // is no copy to keep synchronized.
+  return disk_backend_->OpenEntry(key, entry, callback);
+}
+
+int HybridCacheBackend::CreateEntry(const std::string& key,
+                                    disk_cache::Entry** entry,
+                                    const CompletionCallback& callback) {
+  PendingEntry* pending = new PendingEntry(entry, callback);
+  if (ram_backend_.get()) {
+    // Drop any stale copy and start mirroring the new entry from scratch.
+    ram_backend_->DoomEntry(key, CompletionCallback());
+    ram_backend_->CreateEntry(key, &pending->ram_entry, CompletionCallback());
+  }
+
+  int rv = disk_backend_->CreateEntry(
+      key, &pending->disk_entry,
+      base::Bind(&HybridCacheBackend::OnEntryOperationComplete,
+                 base::Unretained(this), pending));
+  if (rv != net::ERR_IO_PENDING)
+    return FinishEntryOperation(pending, rv);
+
+  pending_entries_.insert(pending);
+  return rv;
+}
+
+int HybridCacheBackend::DoomEntry(const std::string& key,
+                                  const CompletionCallback& callback) {
+  if (ram_backend_.get())
+    ram_backend_->DoomEntry(key, CompletionCallback());
+  return disk_backend_->DoomEntry(key, callback);
+}
+
+int HybridCacheBackend::DoomAllEntries(const CompletionCallback& callback) {
+  if (ram_backend_.get())
+    ram_backend_->DoomAllEntries(CompletionCallback());
+  return disk_backend_->DoomAllEntries(callback);
+}
+
+int HybridCacheBackend::DoomEntriesBetween(const base::Time initial_time,
+                                           const base::Time end_time,
+                                           const CompletionCallback& callback) {
+  if (ram_backend_.get())
+    ram_backend_->DoomEntriesBetween(initial_time, end_time,
+                                     CompletionCallback());
+  return disk_backend_->DoomEntriesBetween(initial_time, end_time, callback);
+}
+
+int HybridCacheBackend::DoomEntriesSince(const base::Time initial_time,
+                                         const CompletionCallback& callback) {
+  if (ram_backend_.get())
+    ram_backend_->DoomEntriesSince(initial_time, CompletionCallback());
+  return disk_backend_->DoomEntriesSince(initial_time, callback);
+}
+
+int HybridCacheBackend::OpenNextEntry(void** iter,
+                                      disk_cache::Entry** next_entry,
+                                      const CompletionCallback& callback) {
+  return disk_backend_->OpenNextEntry(iter, next_entry, callback);
+}
+
+void HybridCacheBackend::EndEnumeration(void** iter) {
+  disk_backend_->EndEnumeration(iter);
+}
+
+void HybridCacheBackend::GetStats(
+    std::vector<std::pair<std::string, std::string> >* stats) {
+  disk_backend_->GetStats(stats);
+  if (ram_backend_.get()) {
+    stats->push_back(std::make_pair(
+        "Hot RAM entries",
+        base::StringPrintf("%d", ram_backend_->GetEntryCount())));
+  }
+}
+
+void HybridCacheBackend::OnExternalCacheHit(const std::string& key) {
+  if (ram_backend_.get())
+    ram_backend_->OnExternalCacheHit(key);
+  disk_backend_->OnExternalCacheHit(key);
+}
+
+int HybridCacheBackend::FinishEntryOperation(PendingEntry* pending,
+                                             int result) {
+  if (result == net::OK) {
+    if (pending->ram_entry) {
+      *pending->entry = new EntryShim(disk_backend_.get(),
+                                      pending->disk_entry,
+                                      pending->ram_entry);
+    } else {
+      *pending->entry = pending->disk_entry;
+    }
+  } else if (pending->ram_entry) {
+    pending->ram_entry->Doom();
+    pending->ram_entry->Close();
+  }
+  delete pending;
+  return result;
+}
+
+void HybridCacheBackend::OnEntryOperationComplete(PendingEntry* pending,
+                                                  int result) {
+  pending_entries_.erase(pending);
+  CompletionCallback callback = pending->callback;
+  result = FinishEntryOperation(pending, result);
+  callback.Run(result);
+}
+
+//-----------------------------------------------------------------------------
+
+HybridBackendFactory::HybridBackendFactory(
+    HttpCache::BackendFactory* disk_factory, int max_ram_bytes)
+    : disk_factory_(disk_factory),
+      max_ram_bytes_(max_ram_bytes),
+      net_log_(NULL),
+      disk_backend_(NULL),
+      backend_(NULL),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
+}
+
+HybridBackendFactory::~HybridBackendFactory() {
+}
+
+int HybridBackendFactory::CreateBackend(NetLog* net_log,
+                                        disk_cache::Backend** backend,
+                                        const CompletionCallback& callback) {
+  DCHECK(!backend_);
+  net_log_ = net_log;
+  backend_ = backend;
+  callback_ = callback;
+  disk_backend_ = NULL;
+
+  int rv = disk_factory_->CreateBackend(
+      net_log, &disk_backend_,
+      base::Bind(&HybridBackendFactory::OnDiskBackendCreated,
+                 weak_factory_.GetWeakPtr()));
+  if (rv == net::ERR_IO_PENDING)
+    return rv;
+
+  if (rv == net::OK)
+    *backend_ = new HybridCacheBackend(disk_backend_, max_ram_bytes_, net_log_);
+  backend_ = NULL;
+  callback_.Reset();
+  return rv;
+}
+
+void HybridBackendFactory::OnDiskBackendCreated(int result) {
+  if (result == net::OK)
+    *backend_ = new HybridCacheBackend(disk_backend_, max_ram_bytes_, net_log_);
+  CompletionCallback callback = callback_;
+  callback_.Reset();
+  backend_ = NULL;
+  callback.Run(result);  // May delete this object.
+}
+
+}  // namespace net
@@ -0,0 +1,122 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_HTTP_HTTP_CACHE_HYBRID_BACKEND_H_
+#define NET_HTTP_HTTP_CACHE_HYBRID_BACKEND_H_
+#pragma once
+
+#include <set>
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "net/base/completion_callback.h"
+#include "net/base/net_export.h"
+#include "net/disk_cache/disk_cache.h"
+#include "net/http/http_cache.h"
+
+namespace net {
+
+// HybridCacheBackend layers a bounded in-memory tier (the MEMORY_CACHE
+// backend) on top of a disk cache backend. Small entries are mirrored into
+// the memory tier as they are written (write-through), so a later open of a
+// hot entry is served synchronously from RAM without posting anything to the
+// cache thread. The disk backend remains the authoritative store: dooms are
+// applied to both tiers and a memory copy is dropped as soon as it can no
+// longer be kept coherent (the entry grows past the mirroring threshold or
+// becomes sparse).
+//
+// Entries returned by OpenNextEntry() come straight from the disk backend;
+// enumeration is only used to inspect or doom entries, so no attempt is made
+// to keep the memory tier coherent with writes performed through them.
+class NET_EXPORT_PRIVATE HybridCacheBackend : public disk_cache::Backend {
+ public:
+  // Takes ownership of |disk_backend|. |max_ram_bytes| bounds the memory
+  // tier; if the tier cannot be created this object degenerates to a
+  // pass-through of |disk_backend|.
+  HybridCacheBackend(disk_cache::Backend* disk_backend, int max_ram_bytes,
+                     NetLog* net_log);
+  virtual ~HybridCacheBackend();
+
+  // Backend interface.
+  virtual int32 GetEntryCount() const OVERRIDE;
+  virtual int OpenEntry(const std::string& key, disk_cache::Entry** entry,
+                        const CompletionCallback& callback) OVERRIDE;
+  virtual int CreateEntry(const std::string& key, disk_cache::Entry** entry,
+                          const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomEntry(const std::string& key,
+                        const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomAllEntries(const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomEntriesBetween(const base::Time initial_time,
+                                 const base::Time end_time,
+                                 const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomEntriesSince(const base::Time initial_time,
+                               const CompletionCallback& callback) OVERRIDE;
+  virtual int OpenNextEntry(void** iter, disk_cache::Entry** next_entry,
+                            const CompletionCallback& callback) OVERRIDE;
+  virtual void EndEnumeration(void** iter) OVERRIDE;
+  virtual void GetStats(
+      std::vector<std::pair<std::string, std::string> >* stats) OVERRIDE;
+  virtual void OnExternalCacheHit(const std::string& key) OVERRIDE;
+
+ private:
+  class EntryShim;
+  struct PendingEntry;
+
+  // Completes a disk OpenEntry / CreateEntry, wrapping the resulting entry
+  // when a memory tier copy exists. Returns the final result for |pending|
+  // and deletes it.
+  int FinishEntryOperation(PendingEntry* pending, int result);
+
+  // Callback for the asynchronous version of the above.
+  void OnEntryOperationComplete(PendingEntry* pending, int result);
+
+  scoped_ptr<disk_cache::Backend> ram_backend_;
+  scoped_ptr<disk_cache::Backend> disk_backend_;
+
+  // Outstanding open/create operations, deleted if the backend goes away
+  // before they complete (the disk backend cancels the callbacks).
+  std::set<PendingEntry*> pending_entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(HybridCacheBackend);
+};
+
+// A BackendFactory that decorates another factory (normally an on-disk
+// HttpCache::DefaultBackend) with a HybridCacheBackend. Use it to give an
+// existing HTTP cache a RAM tier for hot small entries:
+//   new HybridBackendFactory(
+//       new HttpCache::DefaultBackend(DISK_CACHE, path, max_bytes, thread),
+//       max_ram_bytes);
+class NET_EXPORT HybridBackendFactory : public HttpCache::BackendFactory {
+ public:
+  // Takes ownership of |disk_factory|.
+  HybridBackendFactory(HttpCache::BackendFactory* disk_factory,
+                       int max_ram_bytes);
+  virtual ~HybridBackendFactory();
+
+  // BackendFactory implementation.
+  virtual int CreateBackend(NetLog* net_log,
+                            disk_cache::Backend** backend,
+                            const CompletionCallback& callback) OVERRIDE;
+
+ private:
+  void OnDiskBackendCreated(int result);
+
+  scoped_ptr<HttpCache::BackendFactory> disk_factory_;
+  int max_ram_bytes_;
+
+  // State of the CreateBackend call in progress.
+  NetLog* net_log_;
+  disk_cache::Backend* disk_backend_;
+  disk_cache::Backend** backend_;
+  CompletionCallback callback_;
+
+  base::WeakPtrFactory<HybridBackendFactory> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(HybridBackendFactory);
+};
+
+}  // namespace net
+
+#endif  // NET_HTTP_HTTP_CACHE_HYBRID_BACKEND_H_
@@ -0,0 +1,157 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_cache_hybrid_backend.h"
+
+#include <string.h>
+
+#include <string>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/disk_cache/mem_backend_impl.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// Must match kMaxHotEntryBytes in http_cache_hybrid_backend.cc.
+const int kMaxHotEntryBytes = 64 * 1024;
+
+const char kKey[] = "http://www.example.com/favicon.ico";
+
+// The tests use a memory backend as the "disk" tier too; its operations all
+// complete synchronously, which keeps the state transitions of the entry
+// shim deterministic and lets a test doom the disk copy behind the hybrid
+// backend's back to see whether the memory tier still holds one.
+class HttpCacheHybridBackendTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    disk_backend_ = disk_cache::MemBackendImpl::CreateBackend(
+        16 * 1024 * 1024, NULL);
+    ASSERT_TRUE(disk_backend_);
+    backend_.reset(
+        new HybridCacheBackend(disk_backend_, 1024 * 1024, NULL));
+  }
+
+  // Creates |kKey| through the hybrid backend and writes |data| to stream 1.
+  void WriteEntry(const std::string& data) {
+    disk_cache::Entry* entry = NULL;
+    ASSERT_EQ(OK, backend_->CreateEntry(kKey, &entry, CompletionCallback()));
+    scoped_refptr<StringIOBuffer> buf(new StringIOBuffer(data));
+    ASSERT_EQ(static_cast<int>(data.size()),
+              entry->WriteData(1, 0, buf, data.size(), CompletionCallback(),
+                               false));
+    entry->Close();
+  }
+
+  // Returns true if the memory tier still holds a copy of |kKey|. The disk
+  // copy is doomed first, so the open can only succeed from RAM; use this
+  // only as the last step of a test.
+  bool HasRamCopy() {
+    disk_backend_->DoomEntry(kKey, CompletionCallback());
+    disk_cache::Entry* entry = NULL;
+    if (backend_->OpenEntry(kKey, &entry, CompletionCallback()) != OK)
+      return false;
+    entry->Close();
+    return true;
+  }
+
+  // Reads |len| bytes of stream 1 of |kKey| straight from the disk tier.
+  std::string ReadFromDiskTier(int len) {
+    disk_cache::Entry* entry = NULL;
+    if (disk_backend_->OpenEntry(kKey, &entry, CompletionCallback()) != OK)
+      return std::string();
+    scoped_refptr<IOBuffer> buf(new IOBuffer(len));
+    int rv = entry->ReadData(1, 0, buf, len, CompletionCallback());
+    entry->Close();
+    if (rv < 0)
+      return std::string();
+    return std::string(buf->data(), rv);
+  }
+
+  disk_cache::Backend* disk_backend_;  // Owned by |backend_|.
+  scoped_ptr<HybridCacheBackend> backend_;
+};
+
+TEST_F(HttpCacheHybridBackendTest, WriteThrough) {
+  WriteEntry("hello");
+
+  // The disk tier stays authoritative and must have received the bytes.
+  EXPECT_EQ("hello", ReadFromDiskTier(5));
+
+  // The memory tier received the same bytes, so a hot open survives the
+  // loss of the disk copy and serves them synchronously.
+  disk_backend_->DoomEntry(kKey, CompletionCallback());
+  disk_cache::Entry* entry = NULL;
+  ASSERT_EQ(OK, backend_->OpenEntry(kKey, &entry, CompletionCallback()));
+  scoped_refptr<IOBuffer> buf(new IOBuffer(5));
+  EXPECT_EQ(5, entry->ReadData(1, 0, buf, 5, CompletionCallback()));
+  EXPECT_EQ("hello", std::string(buf->data(), 5));
+  entry->Close();
+}
+
+TEST_F(HttpCacheHybridBackendTest, DropsRamCopyWhenEntryGrows) {
+  disk_cache::Entry* entry = NULL;
+  ASSERT_EQ(OK, backend_->CreateEntry(kKey, &entry, CompletionCallback()));
+
+  const int kSize = kMaxHotEntryBytes + 1;
+  scoped_refptr<IOBuffer> buf(new IOBuffer(kSize));
+  memset(buf->data(), 'a', kSize);
+  ASSERT_EQ(kSize, entry->WriteData(1, 0, buf, kSize, CompletionCallback(),
+                                    false));
+  entry->Close();
+
+  // The write went through to disk, but the entry is now too large for the
+  // memory tier.
+  EXPECT_EQ(kSize, static_cast<int>(ReadFromDiskTier(kSize).size()));
+  EXPECT_FALSE(HasRamCopy());
+}
+
+TEST_F(HttpCacheHybridBackendTest, DropsRamCopyOnSparseWrite) {
+  disk_cache::Entry* entry = NULL;
+  ASSERT_EQ(OK, backend_->CreateEntry(kKey, &entry, CompletionCallback()));
+
+  scoped_refptr<StringIOBuffer> buf(new StringIOBuffer("sparse"));
+  ASSERT_EQ(6, entry->WriteSparseData(0, buf, 6, CompletionCallback()));
+  entry->Close();
+
+  // The sparse data reached the disk tier...
+  disk_cache::Entry* disk_entry = NULL;
+  ASSERT_EQ(OK,
+            disk_backend_->OpenEntry(kKey, &disk_entry, CompletionCallback()));
+  scoped_refptr<IOBuffer> read_buf(new IOBuffer(6));
+  EXPECT_EQ(6, disk_entry->ReadSparseData(0, read_buf, 6,
+                                          CompletionCallback()));
+  EXPECT_EQ("sparse", std::string(read_buf->data(), 6));
+  disk_entry->Close();
+
+  // ...and the copy that cannot be kept coherent was dropped.
+  EXPECT_FALSE(HasRamCopy());
+}
+
+TEST_F(HttpCacheHybridBackendTest, ReopensDiskEntryForWriteAfterRamHit) {
+  WriteEntry("hello");
+
+  // This open hits the memory tier, so the shim has no disk entry attached.
+  disk_cache::Entry* entry = NULL;
+  ASSERT_EQ(OK, backend_->OpenEntry(kKey, &entry, CompletionCallback()));
+
+  // The first write reopens the disk entry and replays the write on it.
+  scoped_refptr<StringIOBuffer> buf(new StringIOBuffer("HELLO"));
+  TestCompletionCallback cb;
+  int rv = entry->WriteData(1, 0, buf, 5, cb.callback(), false);
+  EXPECT_EQ(5, cb.GetResult(rv));
+  entry->Close();
+
+  EXPECT_EQ("HELLO", ReadFromDiskTier(5));
+}
+
+}  // namespace
+
+}  // namespace net
@@ -118,6 +118,8 @@ HttpCache::Transaction::Transaction(HttpCache* cache)
       handling_206_(false),
       cache_pending_(false),
       done_reading_(false),
+      streaming_reader_(false),
+      response_committed_(false),
       read_offset_(0),
       effective_load_flags_(0),
       write_len_(0),
@@ -207,6 +209,19 @@ LoadState HttpCache::Transaction::GetWriterLoadState() const {
   return LOAD_STATE_WAITING_FOR_CACHE;
 }
 
+bool HttpCache::Transaction::CanStreamFromWriter() const {
+  // Only a plain full-body request can consume an entry that is still being
+  // written; range requests and writers need the entry for themselves.
+  return mode_ == READ_WRITE && !partial_.get() && !range_requested_;
+}
+
+bool HttpCache::Transaction::CanStreamReaders() const {
+  if (!response_committed_ || partial_.get() || truncated_ || handling_206_)
+    return false;
+  return response_.headers.get() &&
+         response_.headers->response_code() == 200;
+}
+
 const BoundNetLog& HttpCache::Transaction::net_log() const {
   return net_log_;
 }
@@ -1278,6 +1293,10 @@ int HttpCache::Transaction::DoCacheWriteResponseComplete(int result) {
   if (result != io_buf_len_) {
     DLOG(ERROR) << "failed to write response info to cache";
     DoneWritingToEntry(false);
+  } else {
+    // Streaming readers may attach once a usable (non truncated) header
+    // block has been stored.
+    response_committed_ = !truncated_;
   }
   return OK;
 }
@@ -1349,6 +1368,18 @@ int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
   if (result > 0) {
     read_offset_ += result;
   } else if (result == 0) {  // End of file.
+    if (streaming_reader_ && entry_->writer) {
+      // We caught up with the writer; wait for it to append more data and
+      // retry the read.
+      next_state_ = STATE_CACHE_READ_DATA;
+      cache_->WaitForWriterProgress(entry_, this);
+      return ERR_IO_PENDING;
+    }
+    if (streaming_reader_ && entry_->writer_failed) {
+      // The writer did not store the complete response, so what is left in
+      // the entry cannot be served.
+      return OnCacheReadError(ERR_CACHE_READ_FAILURE, false);
+    }
     cache_->DoneReadingFromEntry(entry_, this);
     entry_ = NULL;
   } else {
@@ -1389,6 +1420,10 @@ int HttpCache::Transaction::DoCacheWriteDataComplete(int result) {
       done_reading_ = true;
   }
 
+  // Let any streaming readers that caught up with us consume the new data.
+  if (entry_ && result > 0)
+    cache_->WriterProgressed(entry_);
+
   if (partial_.get()) {
     // This may be the last request.
     if (!(result == 0 && !truncated_ &&
@@ -1564,6 +1599,16 @@ int HttpCache::Transaction::BeginCacheRead() {
 int HttpCache::Transaction::BeginCacheValidation() {
   DCHECK(mode_ == READ_WRITE);
 
+  if (streaming_reader_) {
+    // We attached to an entry that is still being written, and the writer
+    // just produced these headers, so there is nothing to validate; we only
+    // get to read.
+    mode_ = READ;
+    if (entry_->disk_entry->GetDataSize(kMetadataIndex))
+      next_state_ = STATE_CACHE_READ_METADATA;
+    return OK;
+  }
+
   bool skip_validation = effective_load_flags_ & LOAD_PREFERRING_CACHE ||
                          !RequiresValidation();
 
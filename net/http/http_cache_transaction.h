@@ -94,6 +94,20 @@ class HttpCache::Transaction : public HttpTransaction {
   // to the cache entry.
   LoadState GetWriterLoadState() const;
 
+  // Returns true if this transaction may attach to an entry that is still
+  // being written and consume the body as the writer appends it.
+  bool CanStreamFromWriter() const;
+
+  // Called by the HttpCache when this transaction is the writer of an entry,
+  // to decide if other transactions may read the entry in parallel. Returns
+  // true once the response headers have been committed, and only for plain
+  // (complete, non sparse) 200 responses.
+  bool CanStreamReaders() const;
+
+  // Marks this transaction as a reader of an entry that is still being
+  // written.
+  void set_streaming_reader(bool value) { streaming_reader_ = value; }
+
   const CompletionCallback& io_callback() { return io_callback_; }
 
   const BoundNetLog& net_log() const;
@@ -360,6 +374,8 @@ class HttpCache::Transaction : public HttpTransaction {
   bool handling_206_;  // We must deal with this 206 response.
   bool cache_pending_;  // We are waiting for the HttpCache.
   bool done_reading_;
+  bool streaming_reader_;  // We read the entry while it is being written.
+  bool response_committed_;  // We stored a usable response header block.
   scoped_refptr<IOBuffer> read_buf_;
   int io_buf_len_;
   int read_offset_;
@@ -921,6 +921,220 @@ TEST(HttpCache, SimpleGET_ManyReaders) {
   }
 }
 
+// Tests that a request that arrives while another transaction is still
+// writing the response body attaches to the entry as a streaming reader and
+// drains it to completion, without a second network transaction.
+TEST(HttpCache, SimpleGET_StreamingReader) {
+  MockHttpCache cache;
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+
+  // Start the writer and let it commit the response headers.
+  Context writer;
+  writer.result = cache.http_cache()->CreateTransaction(&writer.trans);
+  ASSERT_EQ(net::OK, writer.result);
+  writer.result = writer.trans->Start(
+      &request, writer.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, writer.callback.GetResult(writer.result));
+
+  // The second request can stream the body from the writer, so it attaches
+  // to the entry instead of waiting in the pending queue, and it completes
+  // its headers from the cache.
+  Context reader;
+  reader.result = cache.http_cache()->CreateTransaction(&reader.trans);
+  ASSERT_EQ(net::OK, reader.result);
+  reader.result = reader.trans->Start(
+      &request, reader.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, reader.callback.GetResult(reader.result));
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+
+  // No body has been stored yet, so the reader parks until the writer makes
+  // progress.
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  int rv = reader.trans->Read(buf, 256, reader.callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_FALSE(reader.callback.have_result());
+
+  // Drain the writer; every chunk it stores wakes the parked reader.
+  ReadAndVerifyTransaction(writer.trans.get(), kSimpleGET_Transaction);
+
+  std::string content;
+  rv = reader.callback.WaitForResult();
+  while (rv > 0) {
+    content.append(buf->data(), rv);
+    rv = reader.trans->Read(buf, 256, reader.callback.callback());
+    if (rv == net::ERR_IO_PENDING)
+      rv = reader.callback.WaitForResult();
+  }
+  EXPECT_EQ(net::OK, rv);
+  EXPECT_EQ(kSimpleGET_Transaction.data, content);
+
+  // The reader was served without going to the network or re-opening the
+  // disk entry.
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
+// Tests that a streaming reader gets an error, and not just a short body,
+// when the writer goes away without storing the complete response and the
+// entry cannot be resumed.
+TEST(HttpCache, SimpleGET_StreamingReaderWriterFailure) {
+  MockHttpCache cache;
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+
+  Context writer;
+  writer.result = cache.http_cache()->CreateTransaction(&writer.trans);
+  ASSERT_EQ(net::OK, writer.result);
+  writer.result = writer.trans->Start(
+      &request, writer.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, writer.callback.GetResult(writer.result));
+
+  Context reader;
+  reader.result = cache.http_cache()->CreateTransaction(&reader.trans);
+  ASSERT_EQ(net::OK, reader.result);
+  reader.result = reader.trans->Start(
+      &request, reader.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, reader.callback.GetResult(reader.result));
+
+  // Let the writer store the first part of the body and stream it to the
+  // reader.
+  scoped_refptr<net::IOBufferWithSize> writer_buf(
+      new net::IOBufferWithSize(10));
+  int rv = writer.trans->Read(writer_buf, writer_buf->size(),
+                              writer.callback.callback());
+  EXPECT_EQ(writer_buf->size(), writer.callback.GetResult(rv));
+
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  rv = reader.trans->Read(buf, 256, reader.callback.callback());
+  EXPECT_EQ(10, reader.callback.GetResult(rv));
+
+  // The reader caught up with the writer again.
+  rv = reader.trans->Read(buf, 256, reader.callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_FALSE(reader.callback.have_result());
+
+  // Kill the writer mid-body. The response has no validators, so the entry
+  // cannot be completed later and has to be doomed; the reader must see the
+  // failure instead of a truncated body.
+  writer.trans.reset();
+  EXPECT_EQ(net::ERR_CACHE_READ_FAILURE, reader.callback.WaitForResult());
+
+  // The next request cannot use the doomed entry and goes to the network.
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(2, cache.disk_cache()->create_count());
+}
+
+// Tests that cancelling a writer that has streaming readers marks the entry
+// as truncated for later resumption but still fails the readers, since they
+// cannot issue the range request needed to finish the body.
+TEST(HttpCache, SimpleGET_StreamingReaderWriterTruncated) {
+  MockHttpCache cache;
+
+  MockTransaction transaction(kSimpleGET_Transaction);
+  transaction.response_headers =
+      "Last-Modified: Wed, 28 Nov 2007 00:40:09 GMT\n"
+      "Content-Length: 22\n"
+      "Etag: foopy\n";
+  AddMockTransaction(&transaction);
+  MockHttpRequest request(transaction);
+
+  Context writer;
+  writer.result = cache.http_cache()->CreateTransaction(&writer.trans);
+  ASSERT_EQ(net::OK, writer.result);
+  writer.result = writer.trans->Start(
+      &request, writer.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, writer.callback.GetResult(writer.result));
+
+  Context reader;
+  reader.result = cache.http_cache()->CreateTransaction(&reader.trans);
+  ASSERT_EQ(net::OK, reader.result);
+  reader.result = reader.trans->Start(
+      &request, reader.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, reader.callback.GetResult(reader.result));
+
+  // Store some data and let the reader consume it and park again.
+  scoped_refptr<net::IOBufferWithSize> writer_buf(
+      new net::IOBufferWithSize(10));
+  int rv = writer.trans->Read(writer_buf, writer_buf->size(),
+                              writer.callback.callback());
+  EXPECT_EQ(writer_buf->size(), writer.callback.GetResult(rv));
+
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  rv = reader.trans->Read(buf, 256, reader.callback.callback());
+  EXPECT_EQ(10, reader.callback.GetResult(rv));
+
+  rv = reader.trans->Read(buf, 256, reader.callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_FALSE(reader.callback.have_result());
+
+  // Destroy the writer; the response can be resumed, so the entry is kept
+  // and marked as truncated.
+  MockHttpCache::SetTestMode(TEST_MODE_SYNC_ALL);
+  writer.trans.reset();
+
+  disk_cache::Entry* entry;
+  ASSERT_TRUE(cache.OpenBackendEntry(kSimpleGET_Transaction.url, &entry));
+  net::HttpResponseInfo response;
+  bool truncated = false;
+  EXPECT_TRUE(MockHttpCache::ReadResponseInfo(entry, &response, &truncated));
+  EXPECT_TRUE(truncated);
+  entry->Close();
+  MockHttpCache::SetTestMode(0);
+
+  // The parked reader cannot be resumed with a range request, so it fails.
+  EXPECT_EQ(net::ERR_CACHE_READ_FAILURE, reader.callback.WaitForResult());
+
+  RemoveMockTransaction(&transaction);
+}
+
+// Tests that a parked streaming reader can be cancelled while it waits for
+// the writer, and that the writer is not affected.
+TEST(HttpCache, SimpleGET_AbandonedStreamingReader) {
+  MockHttpCache cache;
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+
+  Context writer;
+  writer.result = cache.http_cache()->CreateTransaction(&writer.trans);
+  ASSERT_EQ(net::OK, writer.result);
+  writer.result = writer.trans->Start(
+      &request, writer.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, writer.callback.GetResult(writer.result));
+
+  Context reader;
+  reader.result = cache.http_cache()->CreateTransaction(&reader.trans);
+  ASSERT_EQ(net::OK, reader.result);
+  reader.result = reader.trans->Start(
+      &request, reader.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, reader.callback.GetResult(reader.result));
+
+  // Park the reader...
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  int rv = reader.trans->Read(buf, 256, reader.callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_FALSE(reader.callback.have_result());
+
+  // ...and abandon it while it waits for the writer.
+  reader.trans.reset();
+  MessageLoop::current()->RunAllPending();
+
+  // The writer completes normally and the entry stays usable.
+  ReadAndVerifyTransaction(writer.trans.get(), kSimpleGET_Transaction);
+  writer.trans.reset();
+
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
 // This is a test for http://code.google.com/p/chromium/issues/detail?id=4769.
 // If cancelling a request is racing with another request for the same resource
 // finishing, we have to make sure that we remove both transactions from the
@@ -27,6 +27,8 @@ class NET_EXPORT_PRIVATE HttpPipelinedConnection {
     OLD_HTTP_VERSION,
     MUST_CLOSE_CONNECTION,
     AUTHENTICATION_REQUIRED,
+    HEAD_OF_LINE_STALL,  // The response at the front of the pipeline stalled
+                         // with requests queued behind it.
   };
 
   class Delegate {
@@ -25,6 +25,12 @@ namespace net {
 
 namespace {
 
+// If the response at the front of the pipeline takes longer than this to
+// produce headers while other requests are queued behind it, we assume the
+// head is stalled and evict the queued requests so they can retry on fresh
+// connections.
+const int kHeadOfLineStallThresholdMs = 1000;
+
 class ReceivedHeadersParameters : public NetLog::EventParameters {
  public:
   ReceivedHeadersParameters(const NetLog::Source& source,
@@ -471,10 +477,17 @@ int HttpPipelinedConnectionImpl::DoReadHeaders(int result) {
       base::Bind(&HttpPipelinedConnectionImpl::OnReadIOCallback,
                  base::Unretained(this)));
   read_next_state_ = READ_STATE_READ_HEADERS_COMPLETE;
+  if (rv == ERR_IO_PENDING && !request_order_.empty()) {
+    stall_timer_.Start(
+        FROM_HERE,
+        base::TimeDelta::FromMilliseconds(kHeadOfLineStallThresholdMs),
+        this, &HttpPipelinedConnectionImpl::OnHeadOfLineStallTimeout);
+  }
   return rv;
 }
 
 int HttpPipelinedConnectionImpl::DoReadHeadersComplete(int result) {
+  stall_timer_.Stop();
   CHECK(active_read_id_);
   CHECK(ContainsKey(stream_info_map_, active_read_id_));
   CHECK_EQ(STREAM_ACTIVE, stream_info_map_[active_read_id_].state);
@@ -509,6 +522,7 @@ int HttpPipelinedConnectionImpl::DoReadWaitForClose(int result) {
 }
 
 int HttpPipelinedConnectionImpl::DoReadStreamClosed() {
+  stall_timer_.Stop();
   CHECK(active_read_id_);
   CHECK(ContainsKey(stream_info_map_, active_read_id_));
   CHECK_EQ(stream_info_map_[active_read_id_].state, STREAM_CLOSED);
@@ -528,6 +542,12 @@ int HttpPipelinedConnectionImpl::DoReadStreamClosed() {
 }
 
 int HttpPipelinedConnectionImpl::DoEvictPendingReadHeaders(int result) {
+  EvictPendingReads();
+  read_next_state_ = READ_STATE_NONE;
+  return result;
+}
+
+void HttpPipelinedConnectionImpl::EvictPendingReads() {
   while (!request_order_.empty()) {
     int evicted_id = request_order_.front();
     request_order_.pop();
@@ -540,8 +560,23 @@ int HttpPipelinedConnectionImpl::DoEvictPendingReadHeaders(int result) {
           ERR_PIPELINE_EVICTION);
     }
   }
-  read_next_state_ = READ_STATE_NONE;
-  return result;
+}
+
+void HttpPipelinedConnectionImpl::OnHeadOfLineStallTimeout() {
+  CHECK(active_read_id_);
+  CHECK_EQ(READ_STATE_READ_HEADERS_COMPLETE, read_next_state_);
+  // The head of the pipeline is stalled. Mark the pipeline unusable so no new
+  // requests pick it, report the stall, and evict everything queued behind
+  // the head. The evicted requests get ERR_PIPELINE_EVICTION and retry on
+  // fresh connections. The stalled request itself stays on this connection.
+  usable_ = false;
+  ReportPipelineFeedback(active_read_id_, HEAD_OF_LINE_STALL);
+  if (send_next_state_ == SEND_STATE_NONE &&
+      !pending_send_request_queue_.empty()) {
+    send_next_state_ = SEND_STATE_EVICT_PENDING_REQUESTS;
+    DoSendRequestLoop(OK);
+  }
+  EvictPendingReads();
 }
 
 void HttpPipelinedConnectionImpl::Close(int pipeline_id,
@@ -755,6 +790,10 @@ void HttpPipelinedConnectionImpl::ReportPipelineFeedback(int pipeline_id,
       feedback_str = "AUTHENTICATION_REQUIRED";
       break;
 
+    case HEAD_OF_LINE_STALL:
+      feedback_str = "HEAD_OF_LINE_STALL";
+      break;
+
     default:
       NOTREACHED();
       feedback_str = "UNKNOWN";
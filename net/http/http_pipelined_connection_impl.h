@@ -14,6 +14,7 @@
 #include "base/location.h"
 #include "base/memory/linked_ptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/timer.h"
 #include "net/base/completion_callback.h"
 #include "net/base/net_export.h"
 #include "net/base/net_log.h"
@@ -279,6 +280,18 @@ class NET_EXPORT_PRIVATE HttpPipelinedConnectionImpl
   // HttpPipelinedSockets indicates the connection was suddenly closed.
   int DoEvictPendingReadHeaders(int result);
 
+  // Fails every stream still waiting in |request_order_| with
+  // ERR_PIPELINE_EVICTION, which tells the owning transactions to retry
+  // without pipelining. Shared by DoEvictPendingReadHeaders() and
+  // OnHeadOfLineStallTimeout().
+  void EvictPendingReads();
+
+  // Called by |stall_timer_| when the response at the front of the pipeline
+  // hasn't produced headers within the stall threshold while other requests
+  // are queued behind it. Evicts the queued requests so they can retry on
+  // fresh connections instead of waiting out the stall.
+  void OnHeadOfLineStallTimeout();
+
   // Determines if the response headers indicate pipelining will work. This is
   // called every time we receive headers.
   void CheckHeadersForPipelineCompatibility(int pipeline_id, int result);
@@ -328,6 +341,10 @@ class NET_EXPORT_PRIVATE HttpPipelinedConnectionImpl
   int active_read_id_;
   bool read_still_on_call_stack_;
 
+  // Running whenever the active read is waiting on headers with requests
+  // queued behind it. Fires OnHeadOfLineStallTimeout().
+  base::OneShotTimer<HttpPipelinedConnectionImpl> stall_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(HttpPipelinedConnectionImpl);
 };
 
@@ -4,6 +4,8 @@
 
 #include "net/http/http_pipelined_host_impl.h"
 
+#include <algorithm>
+
 #include "base/stl_util.h"
 #include "base/values.h"
 #include "net/http/http_pipelined_connection_impl.h"
@@ -19,6 +21,14 @@ namespace net {
 // costing too much performance. Until then, this is just a bad guess.
 static const int kNumKnownSuccessesThreshold = 3;
 
+// Bounds on the adaptive pipeline capacity. Capacity starts at
+// max_pipeline_depth(), grows by one after every
+// |kNumSuccessesPerCapacityIncrease| OK responses without a stall, and is
+// halved whenever a pipeline reports head-of-line blocking.
+static const int kMinPipelineCapacity = 2;
+static const int kMaxPipelineCapacity = 8;
+static const int kNumSuccessesPerCapacityIncrease = 10;
+
 HttpPipelinedHostImpl::HttpPipelinedHostImpl(
     HttpPipelinedHost::Delegate* delegate,
     const HttpPipelinedHost::Key& key,
@@ -27,7 +37,9 @@ HttpPipelinedHostImpl::HttpPipelinedHostImpl(
     : delegate_(delegate),
       key_(key),
       factory_(factory),
-      capability_(capability) {
+      capability_(capability),
+      pipeline_capacity_(max_pipeline_depth()),
+      successes_since_capacity_change_(0) {
   if (!factory) {
     factory_.reset(new HttpPipelinedConnectionImpl::Factory());
   }
@@ -123,6 +135,14 @@ void HttpPipelinedHostImpl::OnPipelineFeedback(
         capability_ = PIPELINE_CAPABLE;
         delegate_->OnHostDeterminedCapability(this, PIPELINE_CAPABLE);
       }
+      ++successes_since_capacity_change_;
+      if (successes_since_capacity_change_ >=
+              kNumSuccessesPerCapacityIncrease &&
+          pipeline_capacity_ < kMaxPipelineCapacity) {
+        ++pipeline_capacity_;
+        successes_since_capacity_change_ = 0;
+        NotifyAllPipelinesHaveCapacity();
+      }
       break;
 
     case HttpPipelinedConnection::PIPELINE_SOCKET_ERROR:
@@ -146,6 +166,15 @@ void HttpPipelinedHostImpl::OnPipelineFeedback(
 
     case HttpPipelinedConnection::MUST_CLOSE_CONNECTION:
       break;
+
+    case HttpPipelinedConnection::HEAD_OF_LINE_STALL:
+      // The server is serializing responses slowly enough that queueing
+      // behind its head request costs latency. Back off the depth we allow,
+      // but keep pipelining.
+      successes_since_capacity_change_ = 0;
+      pipeline_capacity_ = std::max(kMinPipelineCapacity,
+                                    pipeline_capacity_ / 2);
+      break;
   }
 }
 
@@ -154,7 +183,7 @@ int HttpPipelinedHostImpl::GetPipelineCapacity() const {
   switch (capability_) {
     case PIPELINE_CAPABLE:
     case PIPELINE_PROBABLY_CAPABLE:
-      capacity = max_pipeline_depth();
+      capacity = pipeline_capacity_;
       break;
 
     case PIPELINE_INCAPABLE:
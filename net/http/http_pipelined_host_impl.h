@@ -72,8 +72,10 @@ class NET_EXPORT_PRIVATE HttpPipelinedHostImpl
   // ownership of the returned Value.
   virtual base::Value* PipelineInfoToValue() const OVERRIDE;
 
-  // Returns the maximum number of in-flight pipelined requests we'll allow on a
-  // single connection.
+  // Returns the initial number of in-flight pipelined requests we'll allow on
+  // a single connection. The limit adapts at runtime: it grows while
+  // responses come back cleanly and shrinks when a pipeline reports
+  // head-of-line blocking.
   static int max_pipeline_depth() { return 3; }
 
  private:
@@ -110,6 +112,14 @@ class NET_EXPORT_PRIVATE HttpPipelinedHostImpl
   scoped_ptr<HttpPipelinedConnection::Factory> factory_;
   HttpPipelinedHostCapability capability_;
 
+  // Current adaptive depth limit for this host's pipelines. See
+  // GetPipelineCapacity() and OnPipelineFeedback().
+  int pipeline_capacity_;
+
+  // Number of OK responses since |pipeline_capacity_| last changed. Reset
+  // whenever a pipeline reports head-of-line blocking.
+  int successes_since_capacity_change_;
+
   DISALLOW_COPY_AND_ASSIGN(HttpPipelinedHostImpl);
 };
 
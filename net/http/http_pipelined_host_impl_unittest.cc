@@ -303,6 +303,43 @@ TEST_F(HttpPipelinedHostImplTest, HeedsSocketErrorOnFirstRequestWithPipeline) {
   ClearTestPipeline(pipeline);
 }
 
+TEST_F(HttpPipelinedHostImplTest, StallReducesPipelineCapacity) {
+  MockPipeline* pipeline = AddTestPipeline(
+      HttpPipelinedHostImpl::max_pipeline_depth() - 1, true, true);
+
+  EXPECT_TRUE(host_->IsExistingPipelineAvailable());
+  EXPECT_CALL(delegate_, OnHostDeterminedCapability(host_.get(), _))
+      .Times(0);
+  host_->OnPipelineFeedback(pipeline,
+                            HttpPipelinedConnection::HEAD_OF_LINE_STALL);
+
+  // Capacity dropped below this pipeline's depth, so it's now full.
+  EXPECT_FALSE(host_->IsExistingPipelineAvailable());
+  EXPECT_EQ(NULL, host_->CreateStreamOnExistingPipeline());
+
+  ClearTestPipeline(pipeline);
+}
+
+TEST_F(HttpPipelinedHostImplTest, SuccessesGrowPipelineCapacity) {
+  MockPipeline* pipeline = AddTestPipeline(
+      HttpPipelinedHostImpl::max_pipeline_depth(), true, true);
+
+  EXPECT_FALSE(host_->IsExistingPipelineAvailable());
+
+  // The capacity increase should notify pipelines that they have new room.
+  EXPECT_CALL(delegate_, OnHostHasAdditionalCapacity(host_.get()))
+      .Times(1);
+  for (int i = 0; i < 10; ++i) {
+    host_->OnPipelineFeedback(pipeline, HttpPipelinedConnection::OK);
+  }
+
+  EXPECT_TRUE(host_->IsExistingPipelineAvailable());
+
+  EXPECT_CALL(delegate_, OnHostHasAdditionalCapacity(host_.get()))
+      .Times(1);
+  ClearTestPipeline(pipeline);
+}
+
 }  // anonymous namespace
 
 }  // namespace net
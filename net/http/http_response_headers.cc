@@ -170,11 +170,59 @@ HttpResponseHeaders::HttpResponseHeaders(const std::string& raw_input)
 }
 
 HttpResponseHeaders::HttpResponseHeaders(const Pickle& pickle,
-                                         PickleIterator* iter)
+                                         PickleIterator* iter,
+                                         bool has_parsed_table)
     : response_code_(-1) {
   std::string raw_input;
-  if (pickle.ReadString(iter, &raw_input))
-    Parse(raw_input);
+  if (!pickle.ReadString(iter, &raw_input))
+    return;
+  if (has_parsed_table && InitFromParsedTable(raw_input, pickle, iter))
+    return;
+  Parse(raw_input);
+}
+
+bool HttpResponseHeaders::InitFromParsedTable(const std::string& raw_input,
+                                              const Pickle& pickle,
+                                              PickleIterator* iter) {
+  int response_code;
+  uint16 http_major, http_minor, parsed_major, parsed_minor;
+  int num_headers;
+  if (!pickle.ReadInt(iter, &response_code) ||
+      !pickle.ReadUInt16(iter, &http_major) ||
+      !pickle.ReadUInt16(iter, &http_minor) ||
+      !pickle.ReadUInt16(iter, &parsed_major) ||
+      !pickle.ReadUInt16(iter, &parsed_minor) ||
+      !pickle.ReadInt(iter, &num_headers) ||
+      num_headers < 0)
+    return false;
+
+  std::vector<uint32> offsets(static_cast<size_t>(num_headers) * 4);
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    if (!pickle.ReadUInt32(iter, &offsets[i]))
+      return false;
+  }
+
+  // Validate before adopting anything: every offset must stay inside
+  // |raw_input| and each entry must be ordered, so that a corrupt cache
+  // entry falls back to a full reparse instead of producing wild iterators.
+  const uint32 size = static_cast<uint32>(raw_input.size());
+  for (size_t i = 0; i < offsets.size(); i += 4) {
+    if (offsets[i] > offsets[i + 1] || offsets[i + 1] > offsets[i + 2] ||
+        offsets[i + 2] > offsets[i + 3] || offsets[i + 3] > size)
+      return false;
+  }
+
+  raw_headers_ = raw_input;
+  response_code_ = response_code;
+  http_version_ = HttpVersion(http_major, http_minor);
+  parsed_http_version_ = HttpVersion(parsed_major, parsed_minor);
+  parsed_.reserve(offsets.size() / 4);
+  std::string::const_iterator begin = raw_headers_.begin();
+  for (size_t i = 0; i < offsets.size(); i += 4) {
+    AddToParsed(begin + offsets[i], begin + offsets[i + 1],
+                begin + offsets[i + 2], begin + offsets[i + 3]);
+  }
+  return true;
 }
 
 void HttpResponseHeaders::Persist(Pickle* pickle, PersistOptions options) {
@@ -212,6 +260,11 @@ void HttpResponseHeaders::Persist(Pickle* pickle, PersistOptions options) {
   // so this just copies the first header line.
   blob.assign(raw_headers_.c_str(), strlen(raw_headers_.c_str()) + 1);
 
+  const bool persist_parsed_table =
+      (options & PERSIST_WITH_PARSED_TABLE) == PERSIST_WITH_PARSED_TABLE;
+  std::vector<uint32> parsed_offsets;  // Four entries per surviving header.
+  const std::string::const_iterator raw_begin = raw_headers_.begin();
+
   for (size_t i = 0; i < parsed_.size(); ++i) {
     DCHECK(!parsed_[i].is_continuation());
 
@@ -224,6 +277,24 @@ void HttpResponseHeaders::Persist(Pickle* pickle, PersistOptions options) {
     StringToLowerASCII(&header_name);
 
     if (filter_headers.find(header_name) == filter_headers.end()) {
+      if (persist_parsed_table) {
+        // The span [i, k] is copied into the blob verbatim, so its entries'
+        // offsets all shift by the same amount.
+        size_t shift = blob.size() - (parsed_[i].name_begin - raw_begin);
+        for (size_t j = i; j <= k; ++j) {
+          parsed_offsets.push_back(
+              static_cast<uint32>((parsed_[j].name_begin - raw_begin) +
+                                  shift));
+          parsed_offsets.push_back(
+              static_cast<uint32>((parsed_[j].name_end - raw_begin) + shift));
+          parsed_offsets.push_back(
+              static_cast<uint32>((parsed_[j].value_begin - raw_begin) +
+                                  shift));
+          parsed_offsets.push_back(
+              static_cast<uint32>((parsed_[j].value_end - raw_begin) +
+                                  shift));
+        }
+      }
       // Make sure there is a null after the value.
       blob.append(parsed_[i].name_begin, parsed_[k].value_end);
       blob.push_back('\0');
@@ -234,6 +305,17 @@ void HttpResponseHeaders::Persist(Pickle* pickle, PersistOptions options) {
   blob.push_back('\0');
 
   pickle->WriteString(blob);
+
+  if (persist_parsed_table) {
+    pickle->WriteInt(response_code_);
+    pickle->WriteUInt16(http_version_.major_value());
+    pickle->WriteUInt16(http_version_.minor_value());
+    pickle->WriteUInt16(parsed_http_version_.major_value());
+    pickle->WriteUInt16(parsed_http_version_.minor_value());
+    pickle->WriteInt(static_cast<int>(parsed_offsets.size() / 4));
+    for (size_t i = 0; i < parsed_offsets.size(); ++i)
+      pickle->WriteUInt32(parsed_offsets[i]);
+  }
 }
 
 void HttpResponseHeaders::Update(const HttpResponseHeaders& new_headers) {
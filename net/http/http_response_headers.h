@@ -39,6 +39,11 @@ class NET_EXPORT HttpResponseHeaders
   static const PersistOptions PERSIST_SANS_NON_CACHEABLE = 1 << 3;
   static const PersistOptions PERSIST_SANS_RANGES = 1 << 4;
   static const PersistOptions PERSIST_SANS_SECURITY_STATE = 1 << 5;
+  // Also persist the parsed header offsets and status line fields, so that
+  // deserialization can rebuild the object without re-tokenizing the raw
+  // header block.  Readers must pass |has_parsed_table| = true to the pickle
+  // constructor below to consume the extra data.
+  static const PersistOptions PERSIST_WITH_PARSED_TABLE = 1 << 6;
 
   // Parses the given raw_headers.  raw_headers should be formatted thus:
   // includes the http status response line, each line is \0-terminated, and
@@ -52,8 +57,13 @@ class NET_EXPORT HttpResponseHeaders
 
   // Initializes from the representation stored in the given pickle.  The data
   // for this object is found relative to the given pickle_iter, which should
-  // be passed to the pickle's various Read* methods.
-  HttpResponseHeaders(const Pickle& pickle, PickleIterator* pickle_iter);
+  // be passed to the pickle's various Read* methods.  |has_parsed_table| must
+  // be true if (and only if) the pickle was written with
+  // PERSIST_WITH_PARSED_TABLE; a corrupt table falls back to a full reparse
+  // of the raw header block.
+  HttpResponseHeaders(const Pickle& pickle,
+                      PickleIterator* pickle_iter,
+                      bool has_parsed_table);
 
   // Appends a representation of this object to the given pickle.
   // The options argument can be a combination of PersistOptions.
@@ -267,6 +277,14 @@ class NET_EXPORT HttpResponseHeaders
   // Initializes from the given raw headers.
   void Parse(const std::string& raw_input);
 
+  // Initializes from |raw_input| plus the pre-parsed offset table written by
+  // Persist() with PERSIST_WITH_PARSED_TABLE.  Consumes the table from the
+  // pickle and returns false (leaving this object untouched) if any of it
+  // fails validation, in which case the caller should Parse() instead.
+  bool InitFromParsedTable(const std::string& raw_input,
+                           const Pickle& pickle,
+                           PickleIterator* pickle_iter);
+
   // Helper function for ParseStatusLine.
   // Tries to extract the "HTTP/X.Y" from a status line formatted like:
   //    HTTP/1.1 200 OK
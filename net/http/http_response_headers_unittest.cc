@@ -477,7 +477,7 @@ TEST(HttpResponseHeadersTest, Persist) {
 
     PickleIterator iter(pickle);
     scoped_refptr<net::HttpResponseHeaders> parsed2(
-        new net::HttpResponseHeaders(pickle, &iter));
+        new net::HttpResponseHeaders(pickle, &iter, false));
 
     std::string h2;
     parsed2->GetNormalizedHeaders(&h2);
@@ -485,6 +485,45 @@ TEST(HttpResponseHeadersTest, Persist) {
   }
 }
 
+TEST(HttpResponseHeadersTest, PersistWithParsedTable) {
+  std::string headers =
+      "HTTP/1.1 200 OK\n"
+      "Cache-control: private\n"
+      "Set-Cookie: name=value\n"
+      "Content-Length: 450\n";
+  HeadersToRaw(&headers);
+  scoped_refptr<net::HttpResponseHeaders> parsed1(
+      new net::HttpResponseHeaders(headers));
+
+  Pickle pickle;
+  parsed1->Persist(&pickle,
+                   net::HttpResponseHeaders::PERSIST_SANS_COOKIES |
+                   net::HttpResponseHeaders::PERSIST_WITH_PARSED_TABLE);
+
+  PickleIterator iter(pickle);
+  scoped_refptr<net::HttpResponseHeaders> parsed2(
+      new net::HttpResponseHeaders(pickle, &iter, true));
+
+  // The rehydrated object must match what a full reparse would produce.
+  EXPECT_EQ(200, parsed2->response_code());
+  EXPECT_TRUE(net::HttpVersion(1, 1) == parsed2->GetHttpVersion());
+  std::string h2;
+  parsed2->GetNormalizedHeaders(&h2);
+  EXPECT_EQ("HTTP/1.1 200 OK\n"
+            "Cache-control: private\n"
+            "Content-Length: 450\n",
+            h2);
+
+  // Appending more data after the table must leave the iterator aligned.
+  pickle.WriteInt(42);
+  int trailing = 0;
+  PickleIterator iter2(pickle);
+  scoped_refptr<net::HttpResponseHeaders> parsed3(
+      new net::HttpResponseHeaders(pickle, &iter2, true));
+  EXPECT_TRUE(pickle.ReadInt(&iter2, &trailing));
+  EXPECT_EQ(42, trailing);
+}
+
 TEST(HttpResponseHeadersTest, EnumerateHeader_Coalesced) {
   // Ensure that commas in quoted strings are not regarded as value separators.
   // Ensure that whitespace following a value is trimmed properly
@@ -38,7 +38,7 @@ X509Certificate::PickleType GetPickleTypeForVersion(int version) {
 // serialized HttpResponseInfo.
 enum {
   // The version of the response info used when persisting response info.
-  RESPONSE_INFO_VERSION = 3,
+  RESPONSE_INFO_VERSION = 4,
 
   // The minimum version supported for deserializing response info.
   RESPONSE_INFO_MINIMUM_VERSION = 1,
@@ -81,6 +81,10 @@ enum {
   // This bit is set if the response info has protocol version.
   RESPONSE_INFO_HAS_NPN_NEGOTIATED_PROTOCOL = 1 << 17,
 
+  // This bit is set if the response headers were persisted with their
+  // pre-parsed offset table, so deserialization can skip the reparse.
+  RESPONSE_INFO_HAS_PARSED_HEADER_TABLE = 1 << 18,
+
   // TODO(darin): Add other bits to indicate alternate request methods.
   // For now, we don't support storing those.
 };
@@ -158,7 +162,8 @@ bool HttpResponseInfo::InitFromPickle(const Pickle& pickle,
   response_time = Time::FromInternalValue(time_val);
 
   // read response-headers
-  headers = new HttpResponseHeaders(pickle, &iter);
+  headers = new HttpResponseHeaders(
+      pickle, &iter, (flags & RESPONSE_INFO_HAS_PARSED_HEADER_TABLE) != 0);
   if (headers->response_code() == -1)
     return false;
 
@@ -250,6 +255,8 @@ void HttpResponseInfo::Persist(Pickle* pickle,
   }
   if (was_fetched_via_proxy)
     flags |= RESPONSE_INFO_WAS_PROXY;
+  if (skip_transient_headers)
+    flags |= RESPONSE_INFO_HAS_PARSED_HEADER_TABLE;
 
   pickle->WriteInt(flags);
   pickle->WriteInt64(request_time.ToInternalValue());
@@ -265,7 +272,8 @@ void HttpResponseInfo::Persist(Pickle* pickle,
         net::HttpResponseHeaders::PERSIST_SANS_HOP_BY_HOP |
         net::HttpResponseHeaders::PERSIST_SANS_NON_CACHEABLE |
         net::HttpResponseHeaders::PERSIST_SANS_RANGES |
-        net::HttpResponseHeaders::PERSIST_SANS_SECURITY_STATE;
+        net::HttpResponseHeaders::PERSIST_SANS_SECURITY_STATE |
+        net::HttpResponseHeaders::PERSIST_WITH_PARSED_TABLE;
   }
 
   headers->Persist(pickle, persist_options);
@@ -22,6 +22,13 @@ namespace net {
 
 namespace {
 
+// Bounds for the memo of recently completed resolutions.  The TTL is short
+// since PAC results may legitimately vary over time (e.g. scripts that
+// branch on the time of day), but it is long enough to cover the burst of
+// lookups issued while loading a page.
+const size_t kResultCacheMaxEntries = 256;
+const int kResultCacheTTLSeconds = 60;
+
 class PurgeMemoryTask : public base::RefCountedThreadSafe<PurgeMemoryTask> {
  public:
   explicit PurgeMemoryTask(ProxyResolver* resolver) : resolver_(resolver) {}
@@ -221,13 +228,18 @@ class MultiThreadedProxyResolver::SetPacScriptJob
 class MultiThreadedProxyResolver::GetProxyForURLJob
     : public MultiThreadedProxyResolver::Job {
  public:
+  // |coordinator| -- the resolver that created this job; used to memoize the
+  //                  result.  Must only be used if the job was not cancelled,
+  //                  which guarantees the coordinator is still alive.
   // |url|         -- the URL of the query.
   // |results|     -- the structure to fill with proxy resolve results.
-  GetProxyForURLJob(const GURL& url,
+  GetProxyForURLJob(MultiThreadedProxyResolver* coordinator,
+                    const GURL& url,
                     ProxyInfo* results,
                     const CompletionCallback& callback,
                     const BoundNetLog& net_log)
       : Job(TYPE_GET_PROXY_FOR_URL, callback),
+        coordinator_(coordinator),
         results_(results),
         net_log_(net_log),
         url_(url),
@@ -280,11 +292,16 @@ class MultiThreadedProxyResolver::GetProxyForURLJob
       if (result_code >= OK) {  // Note: unit-tests use values > 0.
         results_->Use(results_buf_);
       }
+      if (result_code == OK)
+        coordinator_->CacheResult(url_, results_buf_);
       RunUserCallback(result_code);
     }
     OnJobCompleted();
   }
 
+  // Must only be used on the "origin" thread, when not cancelled.
+  MultiThreadedProxyResolver* coordinator_;
+
   // Must only be used on the "origin" thread.
   ProxyInfo* results_;
 
@@ -392,7 +409,8 @@ MultiThreadedProxyResolver::MultiThreadedProxyResolver(
     size_t max_num_threads)
     : ProxyResolver(resolver_factory->resolvers_expect_pac_bytes()),
       resolver_factory_(resolver_factory),
-      max_num_threads_(max_num_threads) {
+      max_num_threads_(max_num_threads),
+      result_cache_(kResultCacheMaxEntries) {
   DCHECK_GE(max_num_threads, 1u);
 }
 
@@ -410,8 +428,14 @@ int MultiThreadedProxyResolver::GetProxyForURL(
   DCHECK(current_script_data_.get())
       << "Resolver is un-initialized. Must call SetPacScript() first!";
 
+  // Page loads tend to resolve the same origins over and over, and each PAC
+  // evaluation costs a thread hop (plus potentially a slow script), so serve
+  // repeated lookups from the memo of recent results.
+  if (LookupCachedResult(url, results))
+    return OK;
+
   scoped_refptr<GetProxyForURLJob> job(
-      new GetProxyForURLJob(url, results, callback, net_log));
+      new GetProxyForURLJob(this, url, results, callback, net_log));
 
   // Completion will be notified through |callback|, unless the caller cancels
   // the request using |request|.
@@ -488,12 +512,14 @@ void MultiThreadedProxyResolver::CancelSetPacScript() {
   // Defensively clear some data which shouldn't be getting used
   // anymore.
   current_script_data_ = NULL;
+  result_cache_.Clear();
 
   ReleaseAllExecutors();
 }
 
 void MultiThreadedProxyResolver::PurgeMemory() {
   DCHECK(CalledOnValidThread());
+  result_cache_.Clear();
   for (ExecutorList::iterator it = executors_.begin();
        it != executors_.end(); ++it) {
     Executor* executor = *it;
@@ -510,6 +536,9 @@ int MultiThreadedProxyResolver::SetPacScript(
   // Save the script details, so we can provision new executors later.
   current_script_data_ = script_data;
 
+  // Results computed against the previous script are now stale.
+  result_cache_.Clear();
+
   // The user should not have any outstanding requests when they call
   // SetPacScript().
   CheckNoOutstandingUserRequests();
@@ -577,6 +606,24 @@ MultiThreadedProxyResolver::AddNewExecutor() {
   return executor;
 }
 
+bool MultiThreadedProxyResolver::LookupCachedResult(const GURL& url,
+                                                    ProxyInfo* results) {
+  DCHECK(CalledOnValidThread());
+  const ProxyInfo* entry =
+      result_cache_.Get(url.GetOrigin().spec(), base::TimeTicks::Now());
+  if (!entry)
+    return false;
+  results->Use(*entry);
+  return true;
+}
+
+void MultiThreadedProxyResolver::CacheResult(const GURL& url,
+                                             const ProxyInfo& results) {
+  DCHECK(CalledOnValidThread());
+  result_cache_.Put(url.GetOrigin().spec(), results, base::TimeTicks::Now(),
+                    base::TimeDelta::FromSeconds(kResultCacheTTLSeconds));
+}
+
 void MultiThreadedProxyResolver::OnExecutorReady(Executor* executor) {
   DCHECK(CalledOnValidThread());
   if (pending_jobs_.empty())
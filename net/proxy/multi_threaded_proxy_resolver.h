@@ -7,13 +7,16 @@
 #pragma once
 
 #include <deque>
+#include <string>
 #include <vector>
 
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
+#include "net/base/expiring_cache.h"
 #include "net/base/net_export.h"
+#include "net/proxy/proxy_info.h"
 #include "net/proxy/proxy_resolver.h"
 
 namespace base {
@@ -134,11 +137,26 @@ class NET_EXPORT_PRIVATE MultiThreadedProxyResolver
   // Starts the next job from |pending_jobs_| if possible.
   void OnExecutorReady(Executor* executor);
 
+  // Returns true and fills |results| if a sufficiently recent result for
+  // |url|'s origin is memoized, in which case no job needs to be dispatched.
+  bool LookupCachedResult(const GURL& url, ProxyInfo* results);
+
+  // Memoizes a successful result, so repeated lookups for the same origin
+  // within the TTL complete without a thread hop.  Called by
+  // GetProxyForURLJob on the origin thread.
+  void CacheResult(const GURL& url, const ProxyInfo& results);
+
   const scoped_ptr<ProxyResolverFactory> resolver_factory_;
   const size_t max_num_threads_;
   PendingJobsQueue pending_jobs_;
   ExecutorList executors_;
   scoped_refptr<ProxyResolverScriptData> current_script_data_;
+
+  // Memoized results of recently completed jobs, keyed by the url's origin.
+  // Cleared whenever the PAC script changes; network changes cause
+  // ProxyService to re-run SetPacScript, so they invalidate the cache too.
+  typedef ExpiringCache<std::string, ProxyInfo> ResultCache;
+  ResultCache result_cache_;
 };
 
 }  // namespace net
@@ -20,7 +20,8 @@ namespace net {
 HttpServer::HttpServer(const std::string& host,
                        int port,
                        HttpServer::Delegate* del)
-    : delegate_(del) {
+    : delegate_(del),
+      connection_limit_(0) {
   server_ = TCPListenSocket::CreateAndListen(host, port, this);
 }
 
@@ -95,6 +96,10 @@ void HttpServer::Close(int connection_id)
 
 void HttpServer::DidAccept(ListenSocket* server,
                            ListenSocket* socket) {
+  // Refuse connections past the limit.  By not taking a reference here we
+  // let the caller destroy (and thereby close) the socket.
+  if (connection_limit_ > 0 && id_to_connection_.size() >= connection_limit_)
+    return;
   HttpConnection* connection = new HttpConnection(this, socket);
   id_to_connection_[connection->id()] = connection;
   socket_to_connection_[socket] = connection;
@@ -41,6 +41,10 @@ class HttpServer : public ListenSocket::ListenSocketDelegate,
 
   HttpServer(const std::string& host, int port, HttpServer::Delegate* del);
 
+  // Caps the number of concurrent connections; connections accepted past the
+  // limit are closed immediately.  0 (the default) means no limit.
+  void set_connection_limit(size_t limit) { connection_limit_ = limit; }
+
   void AcceptWebSocket(int connection_id,
                        const HttpServerRequestInfo& request);
   void SendOverWebSocket(int connection_id, const std::string& data);
@@ -79,6 +83,7 @@ class HttpServer : public ListenSocket::ListenSocketDelegate,
 
   HttpServer::Delegate* delegate_;
   scoped_refptr<ListenSocket> server_;
+  size_t connection_limit_;
   typedef std::map<int, HttpConnection*> IdToConnectionMap;
   IdToConnectionMap id_to_connection_;
   typedef std::map<ListenSocket*, HttpConnection*> SocketToConnectionMap;
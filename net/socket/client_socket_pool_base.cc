@@ -42,6 +42,18 @@ bool g_connect_backup_jobs_enabled = true;
 double g_socket_reuse_policy_penalty_exponent = -1;
 int g_socket_reuse_policy = -1;
 
+// Idle sockets in a warm group are kept alive this many times longer than the
+// regular idle timeouts, since another request to the same group is likely.
+const int kWarmSocketTimeoutMultiplier = 4;
+
+// Number of idle socket reuses after which a group is considered warm on its
+// own, without having been pinned.
+const int kWarmGroupReuseThreshold = 3;
+
+// How long a preconnect (or an explicit PinGroupWarm() call) keeps a group
+// pinned warm.
+const int kWarmGroupPinSeconds = 60;
+
 }  // namespace
 
 namespace net {
@@ -297,6 +309,11 @@ void ClientSocketPoolBaseHelper::RequestSockets(
 
   Group* group = GetOrCreateGroup(group_name);
 
+  // A preconnect predicts upcoming traffic to this group, so keep its idle
+  // sockets warm until the predicted requests arrive.
+  group->PinWarm(base::TimeTicks::Now() +
+                 TimeDelta::FromSeconds(kWarmGroupPinSeconds));
+
   // RequestSocketsInternal() may delete the group.
   bool deleted_group = false;
 
@@ -539,6 +556,14 @@ bool ClientSocketPoolBaseHelper::HasGroup(const std::string& group_name) const {
   return ContainsKey(group_map_, group_name);
 }
 
+void ClientSocketPoolBaseHelper::PinGroupWarm(const std::string& group_name) {
+  GroupMap::iterator it = group_map_.find(group_name);
+  if (it == group_map_.end())
+    return;
+  it->second->PinWarm(base::TimeTicks::Now() +
+                      TimeDelta::FromSeconds(kWarmGroupPinSeconds));
+}
+
 void ClientSocketPoolBaseHelper::CloseIdleSockets() {
   CleanupIdleSockets(true);
   DCHECK_EQ(0, idle_socket_count_);
@@ -677,6 +702,8 @@ void ClientSocketPoolBaseHelper::CleanupIdleSockets(bool force) {
       base::TimeDelta timeout =
           j->socket->WasEverUsed() ?
           used_idle_socket_timeout_ : unused_idle_socket_timeout_;
+      if (group->IsWarm(now))
+        timeout *= kWarmSocketTimeoutMultiplier;
       if (force || j->ShouldCleanup(now, timeout)) {
         delete j->socket;
         j = group->mutable_idle_sockets()->erase(j);
@@ -994,6 +1021,7 @@ void ClientSocketPoolBaseHelper::HandOutSocket(
   handle->set_pool_id(pool_generation_number_);
 
   if (reused) {
+    group->RecordSocketReuse();
     net_log.AddEvent(
         NetLog::TYPE_SOCKET_POOL_REUSED_AN_EXISTING_SOCKET,
         make_scoped_refptr(new NetLogIntegerParameter(
@@ -1143,12 +1171,17 @@ void ClientSocketPoolBaseHelper::InvokeUserCallback(
 
 ClientSocketPoolBaseHelper::Group::Group()
     : active_socket_count_(0),
+      reuse_count_(0),
       ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {}
 
 ClientSocketPoolBaseHelper::Group::~Group() {
   CleanupBackupJob();
 }
 
+bool ClientSocketPoolBaseHelper::Group::IsWarm(base::TimeTicks now) const {
+  return now < warm_until_ || reuse_count_ >= kWarmGroupReuseThreshold;
+}
+
 void ClientSocketPoolBaseHelper::Group::StartBackupSocketTimer(
     const std::string& group_name,
     ClientSocketPoolBaseHelper* pool) {
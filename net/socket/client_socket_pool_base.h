@@ -264,6 +264,13 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
                      StreamSocket* socket,
                      int id);
 
+  // Pins |group_name| warm for the near future so that its idle sockets are
+  // kept alive longer than the regular idle timeouts, keeping completed
+  // connections (including any TLS handshake done by the ConnectJob) ready
+  // for a predicted request.  Preconnects via RequestSockets() pin their
+  // group automatically.  Does nothing if the group does not exist.
+  void PinGroupWarm(const std::string& group_name);
+
   // See ClientSocketPool::Flush for documentation on this function.
   void Flush();
 
@@ -420,6 +427,22 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
     void IncrementActiveSocketCount() { active_socket_count_++; }
     void DecrementActiveSocketCount() { active_socket_count_--; }
 
+    // Called whenever an idle socket from this group is handed out for reuse.
+    void RecordSocketReuse() { reuse_count_++; }
+    int reuse_count() const { return reuse_count_; }
+
+    // Keeps this group warm until |until|, regardless of the observed reuse
+    // rate.  Idle sockets in a warm group stay open for longer before being
+    // cleaned up; see CleanupIdleSockets().
+    void PinWarm(base::TimeTicks until) {
+      if (until > warm_until_)
+        warm_until_ = until;
+    }
+
+    // A group is warm if it was recently pinned (e.g. by a preconnect, which
+    // predicts traffic to the group) or its idle sockets keep getting reused.
+    bool IsWarm(base::TimeTicks now) const;
+
     const std::set<ConnectJob*>& jobs() const { return jobs_; }
     const std::list<IdleSocket>& idle_sockets() const { return idle_sockets_; }
     const RequestQueue& pending_requests() const { return pending_requests_; }
@@ -437,6 +460,8 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
     std::set<ConnectJob*> jobs_;
     RequestQueue pending_requests_;
     int active_socket_count_;  // number of active sockets used by clients
+    int reuse_count_;  // number of times an idle socket was reused
+    base::TimeTicks warm_until_;  // time until which the group is pinned warm
     // A factory to pin the backup_job tasks.
     base::WeakPtrFactory<Group> weak_factory_;
   };
@@ -713,6 +738,10 @@ class ClientSocketPoolBase {
     return helper_.ReleaseSocket(group_name, socket, id);
   }
 
+  void PinGroupWarm(const std::string& group_name) {
+    helper_.PinGroupWarm(group_name);
+  }
+
   void Flush() { helper_.Flush(); }
 
   bool IsStalled() const { return helper_.IsStalled(); }
@@ -0,0 +1,39 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/socket/socket.h"
+
+#include <string.h>
+
+#include "base/logging.h"
+#include "net/base/io_buffer.h"
+
+namespace net {
+
+int Socket::WriteV(const std::vector<IOBufferSlice>& buffers,
+                   const CompletionCallback& callback) {
+  DCHECK(!buffers.empty());
+
+  // If there is only one slice there is nothing to gather.
+  if (buffers.size() == 1)
+    return Write(buffers[0].buffer, buffers[0].length, callback);
+
+  int total_length = 0;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    DCHECK_GT(buffers[i].length, 0);
+    total_length += buffers[i].length;
+  }
+
+  // Coalesce into a single buffer.  Write() keeps |coalesced| alive if the
+  // write completes asynchronously.
+  scoped_refptr<IOBuffer> coalesced(new IOBuffer(total_length));
+  char* dest = coalesced->data();
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    memcpy(dest, buffers[i].buffer->data(), buffers[i].length);
+    dest += buffers[i].length;
+  }
+  return Write(coalesced, total_length, callback);
+}
+
+}  // namespace net
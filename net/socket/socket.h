@@ -6,6 +6,8 @@
 #define NET_SOCKET_SOCKET_H_
 #pragma once
 
+#include <vector>
+
 #include "net/base/completion_callback.h"
 #include "net/base/net_export.h"
 
@@ -13,6 +15,18 @@ namespace net {
 
 class IOBuffer;
 
+// One fragment of a scatter/gather write.  |buffer| is not owned; callers
+// keep a reference and the socket takes its own for the duration of a
+// pending write, as with Write() below.
+struct NET_EXPORT IOBufferSlice {
+  IOBufferSlice() : buffer(NULL), length(0) {}
+  IOBufferSlice(IOBuffer* buffer, int length)
+      : buffer(buffer), length(length) {}
+
+  IOBuffer* buffer;
+  int length;
+};
+
 // Represents a read/write socket.
 class NET_EXPORT Socket {
  public:
@@ -47,6 +61,17 @@ class NET_EXPORT Socket {
   virtual int Write(IOBuffer* buf, int buf_len,
                     const CompletionCallback& callback) = 0;
 
+  // Writes data from multiple buffers to the socket as if they were
+  // concatenated, with the same semantics as Write(), including partial
+  // writes.  |buffers| must be non-empty and every slice must have a
+  // positive length.  The default implementation coalesces the slices into
+  // a single buffer and calls Write(); subclasses that can reach a
+  // scatter/gather primitive (writev, WSASend) override this to skip the
+  // copy, so framed protocols can write header and payload buffers in one
+  // call without coalescing them first.
+  virtual int WriteV(const std::vector<IOBufferSlice>& buffers,
+                     const CompletionCallback& callback);
+
   // Set the receive buffer size (in bytes) for the socket.
   // Note: changing this value can affect the TCP window size on some platforms.
   // Returns true on success, or false on failure.
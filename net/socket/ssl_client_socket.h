@@ -118,6 +118,22 @@ class NET_EXPORT SSLClientSocket : public SSLSocket {
   // sessions.
   static void ClearSessionCache();
 
+  // GetSessionCacheData serializes the contents of the SSL session cache to
+  // |data|, so that the embedder can persist it and restore it after a
+  // restart with SetSessionCacheData.  This allows session resumption to
+  // work across restarts, cutting the handshake to known servers from two
+  // round trips to one.  The blob contains session keys, so the embedder
+  // must store it encrypted.  Returns false if the underlying SSL library
+  // does not support exporting sessions (NSS has no such API; only the
+  // OpenSSL build supports this).
+  static bool GetSessionCacheData(std::string* data);
+
+  // SetSessionCacheData adds the sessions serialized in |data| by
+  // GetSessionCacheData to the session cache.  Expired sessions are skipped.
+  // Returns false if |data| could not be parsed or the underlying SSL
+  // library does not support importing sessions.
+  static bool SetSessionCacheData(const std::string& data);
+
   virtual bool was_npn_negotiated() const;
 
   virtual bool set_was_npn_negotiated(bool negotiated);
@@ -477,6 +477,19 @@ void SSLClientSocket::ClearSessionCache() {
   SSL_ClearSessionCache();
 }
 
+// static
+bool SSLClientSocket::GetSessionCacheData(std::string* data) {
+  // NSS provides no API for externalizing its client session cache, so
+  // sessions cannot be persisted across restarts on this build.
+  return false;
+}
+
+// static
+bool SSLClientSocket::SetSessionCacheData(const std::string& data) {
+  // See GetSessionCacheData.
+  return false;
+}
+
 void SSLClientSocketNSS::GetSSLInfo(SSLInfo* ssl_info) {
   EnterFunction("");
   ssl_info->Reset();
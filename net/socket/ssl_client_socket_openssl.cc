@@ -10,10 +10,16 @@
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 
+#include <utility>
+#include <vector>
+
 #include "base/bind.h"
 #include "base/memory/singleton.h"
 #include "base/metrics/histogram.h"
+#include "base/pickle.h"
+#include "base/string_util.h"
 #include "base/synchronization/lock.h"
+#include "base/time.h"
 #include "crypto/openssl_util.h"
 #include "net/base/cert_verifier.h"
 #include "net/base/net_errors.h"
@@ -209,27 +215,7 @@ class SSLSessionCache {
   void OnSessionAdded(const HostPortPair& host_and_port,
                       const std::string& shard,
                       SSL_SESSION* session) {
-    // Declare the session cleaner-upper before the lock, so any call into
-    // OpenSSL to free the session will happen after the lock is released.
-    crypto::ScopedOpenSSL<SSL_SESSION, SSL_SESSION_free> session_to_free;
-    base::AutoLock lock(lock_);
-
-    DCHECK_EQ(0U, session_map_.count(session));
-    const std::string cache_key = GetCacheKey(host_and_port, shard);
-
-    std::pair<HostPortMap::iterator, bool> res =
-        host_port_map_.insert(std::make_pair(cache_key, session));
-    if (!res.second) {  // Already exists: replace old entry.
-      session_to_free.reset(res.first->second);
-      session_map_.erase(session_to_free.get());
-      res.first->second = session;
-    }
-    DVLOG(2) << "Adding session " << session << " => "
-             << cache_key << ", new entry = " << res.second;
-    DCHECK(host_port_map_[cache_key] == session);
-    session_map_[session] = res.first;
-    DCHECK_EQ(host_port_map_.size(), session_map_.size());
-    DCHECK_LE(host_port_map_.size(), kSessionCacheMaxEntires);
+    AddSessionByKey(GetCacheKey(host_and_port, shard), session);
   }
 
   void OnSessionRemoved(SSL_SESSION* session) {
@@ -281,12 +267,101 @@ class SSLSessionCache {
     session_map_.clear();
   }
 
+  // Serializes all unexpired sessions to |pickle| so that the embedder can
+  // persist them and restore them with SetSerializedSessions after a
+  // restart.
+  void GetSerializedSessions(Pickle* pickle) {
+    std::vector<std::pair<std::string, std::string> > entries;
+    const long now = static_cast<long>(base::Time::Now().ToTimeT());
+    {
+      base::AutoLock lock(lock_);
+      for (HostPortMap::const_iterator it = host_port_map_.begin();
+           it != host_port_map_.end(); ++it) {
+        SSL_SESSION* session = it->second;
+        if (SSL_SESSION_get_time(session) +
+                SSL_SESSION_get_timeout(session) <= now) {
+          continue;
+        }
+        int len = i2d_SSL_SESSION(session, NULL);
+        if (len <= 0)
+          continue;
+        std::string der;
+        unsigned char* out =
+            reinterpret_cast<unsigned char*>(WriteInto(&der, len + 1));
+        if (i2d_SSL_SESSION(session, &out) != len)
+          continue;
+        entries.push_back(std::make_pair(it->first, der));
+      }
+    }
+    pickle->WriteInt(static_cast<int>(entries.size()));
+    for (size_t i = 0; i < entries.size(); i++) {
+      pickle->WriteString(entries[i].first);
+      pickle->WriteString(entries[i].second);
+    }
+  }
+
+  // Restores sessions serialized by GetSerializedSessions. Expired and
+  // unparseable sessions are skipped. Returns false if |pickle| is
+  // malformed.
+  bool SetSerializedSessions(const Pickle& pickle) {
+    PickleIterator iter(pickle);
+    int num_sessions;
+    if (!pickle.ReadInt(&iter, &num_sessions) || num_sessions < 0)
+      return false;
+
+    const long now = static_cast<long>(base::Time::Now().ToTimeT());
+    for (int i = 0; i < num_sessions; i++) {
+      std::string cache_key, der;
+      if (!pickle.ReadString(&iter, &cache_key) ||
+          !pickle.ReadString(&iter, &der)) {
+        return false;
+      }
+      const unsigned char* in =
+          reinterpret_cast<const unsigned char*>(der.data());
+      SSL_SESSION* session = d2i_SSL_SESSION(NULL, &in, der.size());
+      if (!session)
+        continue;
+      if (SSL_SESSION_get_time(session) +
+              SSL_SESSION_get_timeout(session) <= now) {
+        SSL_SESSION_free(session);
+        continue;
+      }
+      AddSessionByKey(cache_key, session);
+    }
+    return true;
+  }
+
  private:
   static std::string GetCacheKey(const HostPortPair& host_and_port,
                                  const std::string& shard) {
     return host_and_port.ToString() + "/" + shard;
   }
 
+  // Adds |session| to the cache under |cache_key|, taking ownership of the
+  // caller's reference and replacing (and freeing) any previous entry for
+  // the same key.
+  void AddSessionByKey(const std::string& cache_key, SSL_SESSION* session) {
+    // Declare the session cleaner-upper before the lock, so any call into
+    // OpenSSL to free the session will happen after the lock is released.
+    crypto::ScopedOpenSSL<SSL_SESSION, SSL_SESSION_free> session_to_free;
+    base::AutoLock lock(lock_);
+
+    DCHECK_EQ(0U, session_map_.count(session));
+    std::pair<HostPortMap::iterator, bool> res =
+        host_port_map_.insert(std::make_pair(cache_key, session));
+    if (!res.second) {  // Already exists: replace old entry.
+      session_to_free.reset(res.first->second);
+      session_map_.erase(session_to_free.get());
+      res.first->second = session;
+    }
+    DVLOG(2) << "Adding session " << session << " => "
+             << cache_key << ", new entry = " << res.second;
+    DCHECK(host_port_map_[cache_key] == session);
+    session_map_[session] = res.first;
+    DCHECK_EQ(host_port_map_.size(), session_map_.size());
+    DCHECK_LE(host_port_map_.size(), kSessionCacheMaxEntires);
+  }
+
   // A pair of maps to allow bi-directional lookups between host:port and an
   // associated session.
   typedef std::map<std::string, SSL_SESSION*> HostPortMap;
@@ -409,6 +484,22 @@ void SSLClientSocket::ClearSessionCache() {
   context->session_cache()->Flush();
 }
 
+// static
+bool SSLClientSocket::GetSessionCacheData(std::string* data) {
+  Pickle pickle(sizeof(Pickle::Header));
+  SSLContext* context = SSLContext::GetInstance();
+  context->session_cache()->GetSerializedSessions(&pickle);
+  data->assign(reinterpret_cast<const char*>(pickle.data()), pickle.size());
+  return true;
+}
+
+// static
+bool SSLClientSocket::SetSessionCacheData(const std::string& data) {
+  Pickle pickle(data.data(), data.size());
+  SSLContext* context = SSLContext::GetInstance();
+  return context->session_cache()->SetSerializedSessions(pickle);
+}
+
 SSLClientSocketOpenSSL::SSLClientSocketOpenSSL(
     ClientSocketHandle* transport_socket,
     const HostPortPair& host_and_port,
@@ -6,8 +6,10 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <netdb.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/tcp.h>
 #if defined(OS_POSIX)
 #include <netinet/in.h>
@@ -502,6 +504,61 @@ int TCPClientSocketLibevent::Write(IOBuffer* buf,
   return ERR_IO_PENDING;
 }
 
+int TCPClientSocketLibevent::WriteV(const std::vector<IOBufferSlice>& buffers,
+                                    const CompletionCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_NE(kInvalidSocket, socket_);
+  DCHECK(!waiting_connect());
+  DCHECK(write_callback_.is_null());
+  // Synchronous operation not supported
+  DCHECK(!callback.is_null());
+  DCHECK(!buffers.empty());
+
+  // The TCP FastOpen path can only send a single buffer with the SYN, so
+  // let the coalescing fallback feed it one.
+  if (use_tcp_fastopen_ && !tcp_fastopen_connected_)
+    return Socket::WriteV(buffers, callback);
+
+  int nwrite = InternalWriteV(buffers);
+  if (nwrite >= 0) {
+    base::StatsCounter write_bytes("tcp.write_bytes");
+    write_bytes.Add(nwrite);
+    if (nwrite > 0)
+      use_history_.set_was_used_to_convey_data();
+    net_log_.AddByteTransferEvent(NetLog::TYPE_SOCKET_BYTES_SENT, nwrite,
+                                  buffers[0].buffer->data());
+    return nwrite;
+  }
+  if (errno != EAGAIN && errno != EWOULDBLOCK)
+    return MapSystemError(errno);
+
+  if (!MessageLoopForIO::current()->WatchFileDescriptor(
+          socket_, true, MessageLoopForIO::WATCH_WRITE,
+          &write_socket_watcher_, &write_watcher_)) {
+    DVLOG(1) << "WatchFileDescriptor failed on write, errno " << errno;
+    return MapSystemError(errno);
+  }
+
+  write_bufs_ = buffers;
+  for (size_t i = 0; i < buffers.size(); ++i)
+    write_buf_refs_.push_back(make_scoped_refptr(buffers[i].buffer));
+  write_callback_ = callback;
+  return ERR_IO_PENDING;
+}
+
+int TCPClientSocketLibevent::InternalWriteV(
+    const std::vector<IOBufferSlice>& buffers) {
+  // writev() accepts at most IOV_MAX entries.  Writing only the first
+  // IOV_MAX slices is a valid partial write.
+  size_t count = std::min(buffers.size(), static_cast<size_t>(IOV_MAX));
+  std::vector<struct iovec> iov(count);
+  for (size_t i = 0; i < count; ++i) {
+    iov[i].iov_base = buffers[i].buffer->data();
+    iov[i].iov_len = buffers[i].length;
+  }
+  return HANDLE_EINTR(writev(socket_, &iov[0], static_cast<int>(count)));
+}
+
 int TCPClientSocketLibevent::InternalWrite(IOBuffer* buf, int buf_len) {
   int nwrite;
   if (use_tcp_fastopen_ && !tcp_fastopen_connected_) {
@@ -655,8 +712,12 @@ void TCPClientSocketLibevent::DidCompleteRead() {
 
 void TCPClientSocketLibevent::DidCompleteWrite() {
   int bytes_transferred;
-  bytes_transferred = HANDLE_EINTR(write(socket_, write_buf_->data(),
-                                         write_buf_len_));
+  if (!write_bufs_.empty()) {
+    bytes_transferred = InternalWriteV(write_bufs_);
+  } else {
+    bytes_transferred = HANDLE_EINTR(write(socket_, write_buf_->data(),
+                                           write_buf_len_));
+  }
 
   int result;
   if (bytes_transferred >= 0) {
@@ -665,8 +726,10 @@ void TCPClientSocketLibevent::DidCompleteWrite() {
     write_bytes.Add(bytes_transferred);
     if (bytes_transferred > 0)
       use_history_.set_was_used_to_convey_data();
-    net_log_.AddByteTransferEvent(NetLog::TYPE_SOCKET_BYTES_SENT, result,
-                                  write_buf_->data());
+    net_log_.AddByteTransferEvent(
+        NetLog::TYPE_SOCKET_BYTES_SENT, result,
+        write_bufs_.empty() ? write_buf_->data()
+                            : write_bufs_[0].buffer->data());
   } else {
     result = MapSystemError(errno);
   }
@@ -674,6 +737,8 @@ void TCPClientSocketLibevent::DidCompleteWrite() {
   if (result != ERR_IO_PENDING) {
     write_buf_ = NULL;
     write_buf_len_ = 0;
+    write_bufs_.clear();
+    write_buf_refs_.clear();
     write_socket_watcher_.StopWatchingFileDescriptor();
     DoWriteCallback(result);
   }
@@ -67,6 +67,8 @@ class NET_EXPORT_PRIVATE TCPClientSocketLibevent : public StreamSocket,
   virtual int Write(IOBuffer* buf,
                     int buf_len,
                     const CompletionCallback& callback) OVERRIDE;
+  virtual int WriteV(const std::vector<IOBufferSlice>& buffers,
+                     const CompletionCallback& callback) OVERRIDE;
   virtual bool SetReceiveBufferSize(int32 size) OVERRIDE;
   virtual bool SetSendBufferSize(int32 size) OVERRIDE;
 
@@ -143,6 +145,9 @@ class NET_EXPORT_PRIVATE TCPClientSocketLibevent : public StreamSocket,
   // Internal function to write to a socket.
   int InternalWrite(IOBuffer* buf, int buf_len);
 
+  // Internal function to issue a gather write of |buffers| with writev().
+  int InternalWriteV(const std::vector<IOBufferSlice>& buffers);
+
   int socket_;
 
   // Local IP address and port we are bound to. Set to NULL if Bind()
@@ -174,6 +179,12 @@ class NET_EXPORT_PRIVATE TCPClientSocketLibevent : public StreamSocket,
   scoped_refptr<IOBuffer> write_buf_;
   int write_buf_len_;
 
+  // The slices used by OnSocketReady to retry WriteV requests, plus the
+  // references that keep their buffers alive while the write is pending.
+  // Empty when the pending write came from Write().
+  std::vector<IOBufferSlice> write_bufs_;
+  std::vector<scoped_refptr<IOBuffer> > write_buf_refs_;
+
   // External callback; called when read is complete.
   CompletionCallback read_callback_;
 
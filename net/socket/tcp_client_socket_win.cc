@@ -185,6 +185,12 @@ class TCPClientSocketWin::Core : public base::RefCounted<Core> {
   scoped_refptr<IOBuffer> write_iobuffer_;
   int write_buffer_length_;
 
+  // The gather list used by WriteV(), and the references that keep its
+  // buffers alive while the write is pending.  Empty when the pending write
+  // came from Write().
+  std::vector<WSABUF> write_buffers_;
+  std::vector<scoped_refptr<IOBuffer> > write_iobuffers_;
+
   // Throttle the read size based on our current slow start state.
   // Returns the throttled read size.
   int ThrottleReadSize(int size) {
@@ -772,6 +778,70 @@ int TCPClientSocketWin::Write(IOBuffer* buf,
   return ERR_IO_PENDING;
 }
 
+int TCPClientSocketWin::WriteV(const std::vector<IOBufferSlice>& buffers,
+                               const CompletionCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_NE(socket_, INVALID_SOCKET);
+  DCHECK(!waiting_write_);
+  DCHECK(write_callback_.is_null());
+  DCHECK(!buffers.empty());
+  DCHECK(!core_->write_iobuffer_);
+
+  base::StatsCounter writes("tcp.writes");
+  writes.Increment();
+
+  int total_length = 0;
+  core_->write_buffers_.resize(buffers.size());
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    core_->write_buffers_[i].len = buffers[i].length;
+    core_->write_buffers_[i].buf = buffers[i].buffer->data();
+    total_length += buffers[i].length;
+  }
+  // DidCompleteWrite() uses |write_buffer_| and |write_buffer_length_| for
+  // logging and sanity checking, so keep them in sync with the gather list.
+  core_->write_buffer_ = core_->write_buffers_[0];
+  core_->write_buffer_length_ = total_length;
+
+  // TODO(wtc): Remove the assertion after enough testing.
+  AssertEventNotSignaled(core_->write_overlapped_.hEvent);
+  DWORD num;
+  int rv = WSASend(socket_, &core_->write_buffers_[0],
+                   static_cast<DWORD>(core_->write_buffers_.size()), &num, 0,
+                   &core_->write_overlapped_, NULL);
+  if (rv == 0) {
+    if (ResetEventIfSignaled(core_->write_overlapped_.hEvent)) {
+      core_->write_buffers_.clear();
+      rv = static_cast<int>(num);
+      if (rv > total_length || rv < 0) {
+        // It seems that some winsock interceptors report that more was written
+        // than was available. Treat this as an error.  http://crbug.com/27870
+        LOG(ERROR) << "Detected broken LSP: Asked to write " << total_length
+                   << " bytes, but " << rv << " bytes reported.";
+        return ERR_WINSOCK_UNEXPECTED_WRITTEN_BYTES;
+      }
+      base::StatsCounter write_bytes("tcp.write_bytes");
+      write_bytes.Add(rv);
+      if (rv > 0)
+        use_history_.set_was_used_to_convey_data();
+      net_log_.AddByteTransferEvent(NetLog::TYPE_SOCKET_BYTES_SENT, rv,
+                                    core_->write_buffer_.buf);
+      return rv;
+    }
+  } else {
+    int os_error = WSAGetLastError();
+    if (os_error != WSA_IO_PENDING) {
+      core_->write_buffers_.clear();
+      return MapSystemError(os_error);
+    }
+  }
+  core_->WatchForWrite();
+  waiting_write_ = true;
+  write_callback_ = callback;
+  for (size_t i = 0; i < buffers.size(); ++i)
+    core_->write_iobuffers_.push_back(make_scoped_refptr(buffers[i].buffer));
+  return ERR_IO_PENDING;
+}
+
 bool TCPClientSocketWin::SetReceiveBufferSize(int32 size) {
   DCHECK(CalledOnValidThread());
   return SetSocketReceiveBufferSize(socket_, size);
@@ -911,6 +981,8 @@ void TCPClientSocketWin::DidCompleteWrite() {
     }
   }
   core_->write_iobuffer_ = NULL;
+  core_->write_buffers_.clear();
+  core_->write_iobuffers_.clear();
   DoWriteCallback(rv);
 }
 
@@ -64,6 +64,8 @@ class NET_EXPORT TCPClientSocketWin : public StreamSocket,
                    const CompletionCallback& callback);
   virtual int Write(IOBuffer* buf, int buf_len,
                     const CompletionCallback& callback);
+  virtual int WriteV(const std::vector<IOBufferSlice>& buffers,
+                     const CompletionCallback& callback);
 
   virtual bool SetReceiveBufferSize(int32 size);
   virtual bool SetSendBufferSize(int32 size);
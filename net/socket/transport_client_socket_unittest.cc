@@ -290,6 +290,47 @@ TEST_P(TransportClientSocketTest, Read) {
   EXPECT_EQ(0, callback.WaitForResult());
 }
 
+TEST_P(TransportClientSocketTest, WriteV) {
+  TestCompletionCallback callback;
+  int rv = sock_->Connect(callback.callback());
+  if (rv != OK) {
+    ASSERT_EQ(rv, ERR_IO_PENDING);
+
+    rv = callback.WaitForResult();
+    EXPECT_EQ(rv, OK);
+  }
+
+  // Send the request split across two buffers, as a framed protocol would
+  // split a header and its payload.
+  const char request_head[] = "GET / ";
+  const char request_tail[] = "HTTP/1.0\r\n\r\n";
+  scoped_refptr<IOBuffer> head_buffer(
+      new IOBuffer(arraysize(request_head) - 1));
+  scoped_refptr<IOBuffer> tail_buffer(
+      new IOBuffer(arraysize(request_tail) - 1));
+  memcpy(head_buffer->data(), request_head, arraysize(request_head) - 1);
+  memcpy(tail_buffer->data(), request_tail, arraysize(request_tail) - 1);
+
+  std::vector<IOBufferSlice> buffers;
+  buffers.push_back(IOBufferSlice(head_buffer, arraysize(request_head) - 1));
+  buffers.push_back(IOBufferSlice(tail_buffer, arraysize(request_tail) - 1));
+
+  const int bytes_to_write =
+      arraysize(request_head) + arraysize(request_tail) - 2;
+  rv = sock_->WriteV(buffers, callback.callback());
+  EXPECT_TRUE(rv >= 0 || rv == ERR_IO_PENDING);
+  if (rv == ERR_IO_PENDING)
+    rv = callback.WaitForResult();
+  // A write this small should not be split by the kernel.
+  ASSERT_EQ(bytes_to_write, rv);
+
+  // The server echoes a reply once it has seen the complete request.
+  scoped_refptr<IOBuffer> buf(new IOBuffer(4096));
+  uint32 bytes_read = DrainClientSocket(buf, 4096, arraysize(kServerReply) - 1,
+                                        &callback);
+  ASSERT_EQ(bytes_read, arraysize(kServerReply) - 1);
+}
+
 TEST_P(TransportClientSocketTest, Read_SmallChunks) {
   TestCompletionCallback callback;
   int rv = sock_->Connect(callback.callback());
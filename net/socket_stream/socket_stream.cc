@@ -157,6 +157,12 @@ void SocketStream::Connect() {
 }
 
 bool SocketStream::SendData(const char* data, int len) {
+  scoped_refptr<IOBufferWithSize> buffer = new IOBufferWithSize(len);
+  memcpy(buffer->data(), data, len);
+  return SendBuffer(buffer);
+}
+
+bool SocketStream::SendBuffer(IOBufferWithSize* buffer) {
   DCHECK(MessageLoop::current()) <<
       "The current MessageLoop must exist";
   DCHECK_EQ(MessageLoop::TYPE_IO, MessageLoop::current()->type()) <<
@@ -170,22 +176,19 @@ bool SocketStream::SendData(const char* data, int len) {
          ++iter)
       current_amount_send += (*iter)->size();
 
-    current_amount_send += len;
+    current_amount_send += buffer->size();
     if (current_amount_send > max_pending_send_allowed_)
       return false;
 
-    pending_write_bufs_.push_back(make_scoped_refptr(
-        new IOBufferWithSize(len)));
-    memcpy(pending_write_bufs_.back()->data(), data, len);
+    pending_write_bufs_.push_back(buffer);
     return true;
   }
   DCHECK(!current_write_buf_);
-  write_buf_ = new IOBuffer(len);
-  memcpy(write_buf_->data(), data, len);
-  write_buf_size_ = len;
+  write_buf_ = buffer;
+  write_buf_size_ = buffer->size();
   write_buf_offset_ = 0;
   // Send pending data asynchronously, so that delegate won't be called
-  // back before returning SendData().
+  // back before returning SendBuffer().
   MessageLoop::current()->PostTask(
       FROM_HERE,
       base::Bind(&SocketStream::DoLoop, this, OK));
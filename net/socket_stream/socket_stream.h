@@ -153,6 +153,13 @@ class NET_EXPORT SocketStream
   // |max_pending_send_allowed_| and |data| is not sent at all.
   virtual bool SendData(const char* data, int len);
 
+  // Like SendData(), but takes a reference to |buffer| instead of copying
+  // its bytes, so callers that already hold the data in an IOBuffer (e.g.
+  // WebSocketJob) don't pay a second copy and allocation per frame.  The
+  // buffer contents must not be modified until the delegate's OnSentData()
+  // has reported them sent.
+  virtual bool SendBuffer(IOBufferWithSize* buffer);
+
   // Requests to close the connection.
   // Once the connection is closed, calls delegate's OnClose.
   virtual void Close();
@@ -376,7 +376,7 @@ int SpdyHttpStream::OnResponseReceived(const SpdyHeaderBlock& response,
   return status;
 }
 
-void SpdyHttpStream::OnDataReceived(const char* data, int length) {
+void SpdyHttpStream::OnDataReceived(IOBufferWithSize* buffer) {
   // SpdyStream won't call us with data if the header block didn't contain a
   // valid set of headers.  So we don't expect to not have headers received
   // here.
@@ -386,11 +386,9 @@ void SpdyHttpStream::OnDataReceived(const char* data, int length) {
   // ReadResponseBody(), therefore user_buffer_ may be NULL.  This may often
   // happen for server initiated streams.
   DCHECK(!stream_->closed() || stream_->pushed());
-  if (length > 0) {
-    // Save the received data.
-    IOBufferWithSize* io_buffer = new IOBufferWithSize(length);
-    memcpy(io_buffer->data(), data, length);
-    response_body_.push_back(make_scoped_refptr(io_buffer));
+  if (buffer) {
+    // Save the received data without copying it.
+    response_body_.push_back(make_scoped_refptr(buffer));
 
     if (user_buffer_) {
       // Handing small chunks of data to the caller creates measurable overhead.
@@ -101,7 +101,17 @@ NetLogSpdySessionCloseParameter::~NetLogSpdySessionCloseParameter() {}
 
 namespace {
 
-const int kReadBufferSize = 8 * 1024;
+// The read buffer starts at |kDefaultReadBufferSize| and adapts to the
+// observed throughput of the connection: every time
+// |kFullReadsBeforeGrowth| consecutive reads fill it completely (the socket
+// is delivering data faster than we drain it), it is doubled, up to
+// |kMaxReadBufferSize|.  Once |kSmallReadsBeforeShrink| consecutive reads
+// fill less than a quarter of it, it is halved again, so mostly-idle
+// sessions don't pin large allocations.
+const int kDefaultReadBufferSize = 8 * 1024;
+const int kMaxReadBufferSize = 256 * 1024;
+const int kFullReadsBeforeGrowth = 2;
+const int kSmallReadsBeforeShrink = 16;
 const int kDefaultConnectionAtRiskOfLossSeconds = 10;
 const int kTrailingPingDelayTimeSeconds = 1;
 const int kHungIntervalSeconds = 10;
@@ -346,8 +356,12 @@ SpdySession::SpdySession(const HostPortProxyPair& host_port_proxy_pair,
       spdy_session_pool_(spdy_session_pool),
       http_server_properties_(http_server_properties),
       connection_(new ClientSocketHandle),
-      read_buffer_(new IOBuffer(kReadBufferSize)),
+      read_buffer_(new IOBuffer(kDefaultReadBufferSize)),
+      read_buffer_size_(kDefaultReadBufferSize),
+      consecutive_full_reads_(0),
+      consecutive_small_reads_(0),
       read_pending_(false),
+      read_buffer_sliced_(false),
       stream_hi_water_mark_(1),  // Always start at 1 for the first stream id.
       write_pending_(false),
       delayed_write_pending_(false),
@@ -902,6 +916,40 @@ void SpdySession::OnReadComplete(int bytes_read) {
       buffered_spdy_framer_->Reset();
   }
 
+  // Adapt the buffer size to the observed throughput (see the constants at
+  // the top of the file).
+  int new_buffer_size = read_buffer_size_;
+  if (bytes_read == read_buffer_size_) {
+    consecutive_small_reads_ = 0;
+    if (++consecutive_full_reads_ >= kFullReadsBeforeGrowth &&
+        read_buffer_size_ < kMaxReadBufferSize) {
+      new_buffer_size = read_buffer_size_ * 2;
+      consecutive_full_reads_ = 0;
+    }
+  } else if (bytes_read <= read_buffer_size_ / 4) {
+    consecutive_full_reads_ = 0;
+    if (++consecutive_small_reads_ >= kSmallReadsBeforeShrink &&
+        read_buffer_size_ > kDefaultReadBufferSize) {
+      new_buffer_size = read_buffer_size_ / 2;
+      consecutive_small_reads_ = 0;
+    }
+  } else {
+    consecutive_full_reads_ = 0;
+    consecutive_small_reads_ = 0;
+  }
+
+  // If any stream kept a slice of |read_buffer_|, the buffer must not be
+  // overwritten by the next read, so start the next read into a fresh buffer.
+  // The same applies if the buffer is being resized.
+  bool need_fresh_buffer =
+      (read_buffer_sliced_ && !read_buffer_->HasOneRef()) ||
+      new_buffer_size != read_buffer_size_;
+  if (need_fresh_buffer) {
+    read_buffer_size_ = new_buffer_size;
+    read_buffer_ = new IOBuffer(read_buffer_size_);
+  }
+  read_buffer_sliced_ = false;
+
   if (state_ != CLOSED)
     ReadSocket();
 }
@@ -970,7 +1018,7 @@ net::Error SpdySession::ReadSocket() {
   CHECK(connection_->socket());
   int bytes_read = connection_->socket()->Read(
       read_buffer_.get(),
-      kReadBufferSize,
+      read_buffer_size_,
       base::Bind(&SpdySession::OnReadComplete, base::Unretained(this)));
   switch (bytes_read) {
     case 0:
@@ -1353,7 +1401,21 @@ void SpdySession::OnStreamFrameData(SpdyStreamId stream_id,
   }
 
   scoped_refptr<SpdyStream> stream = active_streams_[stream_id];
-  stream->OnDataReceived(data, len);
+  if (len > 0) {
+    // |data| points into |read_buffer_|, so hand the stream a reference
+    // counted slice of the buffer rather than copying the payload.
+    // OnReadComplete() rotates |read_buffer_| before the next socket read if
+    // any slices are still referenced.
+    int offset = data - read_buffer_->data();
+    DCHECK_GE(offset, 0);
+    DCHECK_LE(offset + static_cast<int>(len), read_buffer_size_);
+    scoped_refptr<IOBufferWithSize> buffer(
+        new SlicedIOBuffer(read_buffer_, offset, len));
+    read_buffer_sliced_ = true;
+    stream->OnDataReceived(buffer);
+  } else {
+    stream->OnDataReceived(NULL);
+  }
 }
 
 void SpdySession::OnSetting(SpdySettingsIds id,
@@ -1576,7 +1638,7 @@ void SpdySession::OnRstStream(const SpdyRstStreamControlFrame& frame) {
   CHECK(!stream->cancelled());
 
   if (frame.status() == 0) {
-    stream->OnDataReceived(NULL, 0);
+    stream->OnDataReceived(NULL);
   } else if (frame.status() == REFUSED_STREAM) {
     DeleteStream(stream_id, ERR_SPDY_SERVER_REFUSED_STREAM);
   } else {
@@ -552,8 +552,20 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
 
   // The read buffer used to read data from the socket.
   scoped_refptr<IOBuffer> read_buffer_;
+
+  // The current size of |read_buffer_|, which is adapted to the observed
+  // throughput of the connection, along with the consecutive full/small read
+  // counts that drive the adaptation.  See OnReadComplete().
+  int read_buffer_size_;
+  int consecutive_full_reads_;
+  int consecutive_small_reads_;
+
   bool read_pending_;
 
+  // True if a stream was handed a slice of |read_buffer_| while processing
+  // the current read; the buffer is then rotated before the next read.
+  bool read_buffer_sliced_;
+
   int stream_hi_water_mark_;  // The next stream id to use.
 
   // Queue, for each priority, of pending Create Streams that have not
@@ -253,10 +253,13 @@ scoped_refptr<SpdySession> SpdySessionPool::GetExistingSession(
     const BoundNetLog& net_log) const {
   DCHECK(list);
   DCHECK_LT(0u, list->size());
+  // Pick the session with the fewest active streams. |list| is bounded by
+  // g_max_sessions_per_domain, so this walk is effectively constant time.
   scoped_refptr<SpdySession> spdy_session = list->front();
-  if (list->size() > 1) {
-    list->pop_front();  // Rotate the list.
-    list->push_back(spdy_session);
+  for (SpdySessionList::const_iterator it = list->begin();
+       it != list->end(); ++it) {
+    if ((*it)->num_active_streams() < spdy_session->num_active_streams())
+      spdy_session = *it;
   }
 
   return spdy_session;
@@ -397,11 +400,11 @@ void SpdySessionPool::RemoveAliases(const HostPortProxyPair& pair) {
   SpdyAliasMap::iterator alias_it = aliases_.begin();
   while (alias_it != aliases_.end()) {
     if (HostPortProxyPairsAreEqual(alias_it->second, pair)) {
-      aliases_.erase(alias_it);
-      alias_it = aliases_.begin();  // Iterator was invalidated.
-      continue;
+      // Only the erased iterator is invalidated; advance past it first.
+      aliases_.erase(alias_it++);
+    } else {
+      ++alias_it;
     }
-    ++alias_it;
   }
 }
 
@@ -12,6 +12,7 @@
 
 #include "base/basictypes.h"
 #include "base/gtest_prod_util.h"
+#include "base/hash_tables.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "net/base/cert_database.h"
@@ -24,6 +25,27 @@
 #include "net/proxy/proxy_config.h"
 #include "net/proxy/proxy_server.h"
 
+#if defined(COMPILER_GCC)
+namespace BASE_HASH_NAMESPACE {
+template<>
+struct hash<net::HostPortProxyPair> {
+  std::size_t operator()(const net::HostPortProxyPair& pair) const {
+    // Collisions between proxies with the same scheme are resolved by the
+    // hash_map's equality check, so hashing the proxy scheme is enough.
+    return hash<std::string>()(pair.first.host()) ^ pair.first.port() ^
+        static_cast<std::size_t>(pair.second.scheme());
+  }
+};
+}  // namespace BASE_HASH_NAMESPACE
+#elif defined(COMPILER_MSVC)
+namespace stdext {
+inline size_t hash_value(const net::HostPortProxyPair& pair) {
+  return hash_value(pair.first.host()) ^ pair.first.port() ^
+      static_cast<size_t>(pair.second.scheme());
+}
+}  // namespace stdext
+#endif  // COMPILER
+
 namespace net {
 
 class AddressList;
@@ -150,7 +172,7 @@ class NET_EXPORT SpdySessionPool
                            WindowUpdateOverflow);
 
   typedef std::list<scoped_refptr<SpdySession> > SpdySessionList;
-  typedef std::map<HostPortProxyPair, SpdySessionList*> SpdySessionsMap;
+  typedef base::hash_map<HostPortProxyPair, SpdySessionList*> SpdySessionsMap;
   typedef std::map<IPEndPoint, HostPortProxyPair> SpdyAliasMap;
 
 
@@ -158,6 +180,7 @@ class NET_EXPORT SpdySessionPool
       const HostPortProxyPair& host_port_proxy_pair,
       const BoundNetLog& net_log,
       bool only_use_existing_sessions);
+  // Returns the session in |list| with the fewest active streams.
   scoped_refptr<SpdySession> GetExistingSession(
       SpdySessionList* list,
       const BoundNetLog& net_log) const;
@@ -51,7 +51,7 @@ class TestSpdyStreamDelegate : public net::SpdyStream::Delegate {
     return status;
   }
 
-  virtual void OnDataReceived(const char* buffer, int bytes) {
+  virtual void OnDataReceived(IOBufferWithSize* buffer) {
   }
 
   virtual void OnDataSent(int length) {
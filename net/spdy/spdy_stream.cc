@@ -139,9 +139,9 @@ void SpdyStream::PushedStreamReplayData() {
     if (!delegate_)
       break;
     if (buffers[i]) {
-      delegate_->OnDataReceived(buffers[i]->data(), buffers[i]->size());
+      delegate_->OnDataReceived(buffers[i]);
     } else {
-      delegate_->OnDataReceived(NULL, 0);
+      delegate_->OnDataReceived(NULL);
       session_->CloseStream(stream_id_, net::OK);
       // Note: |this| may be deleted after calling CloseStream.
       DCHECK_EQ(buffers.size() - 1, i);
@@ -390,7 +390,8 @@ int SpdyStream::OnHeaders(const SpdyHeaderBlock& headers) {
   return rv;
 }
 
-void SpdyStream::OnDataReceived(const char* data, int length) {
+void SpdyStream::OnDataReceived(IOBufferWithSize* buffer) {
+  int length = buffer ? buffer->size() : 0;
   DCHECK_GE(length, 0);
 
   // If we don't have a response, then the SYN_REPLY did not come through.
@@ -406,9 +407,7 @@ void SpdyStream::OnDataReceived(const char* data, int length) {
     // It should be valid for this to happen in the server push case.
     // We'll return received data when delegate gets attached to the stream.
     if (length > 0) {
-      IOBufferWithSize* buf = new IOBufferWithSize(length);
-      memcpy(buf->data(), data, length);
-      pending_buffers_.push_back(make_scoped_refptr(buf));
+      pending_buffers_.push_back(make_scoped_refptr(buffer));
     } else {
       pending_buffers_.push_back(NULL);
       metrics_.StopStream();
@@ -420,7 +419,7 @@ void SpdyStream::OnDataReceived(const char* data, int length) {
 
   CHECK(!closed());
 
-  // A zero-length read means that the stream is being closed.
+  // A NULL buffer means that the stream is being closed.
   if (!length) {
     metrics_.StopStream();
     session_->CloseStream(stream_id_, net::OK);
@@ -438,13 +437,11 @@ void SpdyStream::OnDataReceived(const char* data, int length) {
   if (!delegate_) {
     // It should be valid for this to happen in the server push case.
     // We'll return received data when delegate gets attached to the stream.
-    IOBufferWithSize* buf = new IOBufferWithSize(length);
-    memcpy(buf->data(), data, length);
-    pending_buffers_.push_back(make_scoped_refptr(buf));
+    pending_buffers_.push_back(make_scoped_refptr(buffer));
     return;
   }
 
-  delegate_->OnDataReceived(data, length);
+  delegate_->OnDataReceived(buffer);
 }
 
 // This function is only called when an entire frame is written.
@@ -74,8 +74,10 @@ class NET_EXPORT_PRIVATE SpdyStream
                                    base::Time response_time,
                                    int status) = 0;
 
-    // Called when data is received.
-    virtual void OnDataReceived(const char* data, int length) = 0;
+    // Called when data is received. |buffer| may be a slice of the session's
+    // read buffer; the delegate may keep a reference to it instead of copying
+    // the data. A NULL |buffer| indicates end-of-stream.
+    virtual void OnDataReceived(IOBufferWithSize* buffer) = 0;
 
     // Called when data is sent.
     virtual void OnDataSent(int length) = 0;
@@ -193,11 +195,10 @@ class NET_EXPORT_PRIVATE SpdyStream
   // Called by the SpdySession when response data has been received for this
   // stream.  This callback may be called multiple times as data arrives
   // from the network, and will never be called prior to OnResponseReceived.
-  // |buffer| contains the data received.  The stream must copy any data
-  //          from this buffer before returning from this callback.
-  // |length| is the number of bytes received or an error.
-  //         A zero-length count does not indicate end-of-stream.
-  void OnDataReceived(const char* buffer, int bytes);
+  // |buffer| contains the data received and is retained by reference for as
+  //          long as the stream (or its delegate) needs it; no copy is made.
+  //          A NULL |buffer| indicates end-of-stream.
+  void OnDataReceived(IOBufferWithSize* buffer);
 
   // Called by the SpdySession when a write has completed.  This callback
   // will be called multiple times for each write which completes.  Writes
@@ -59,8 +59,9 @@ class TestSpdyStreamDelegate : public SpdyStream::Delegate {
     }
     return status;
   }
-  virtual void OnDataReceived(const char* buffer, int bytes) {
-    received_data_ += std::string(buffer, bytes);
+  virtual void OnDataReceived(IOBufferWithSize* buffer) {
+    if (buffer)
+      received_data_ += std::string(buffer->data(), buffer->size());
   }
   virtual void OnDataSent(int length) {
     data_sent_ += length;
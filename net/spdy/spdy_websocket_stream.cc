@@ -108,9 +108,12 @@ int SpdyWebSocketStream::OnResponseReceived(
   return delegate_->OnReceivedSpdyResponseHeader(response, status);
 }
 
-void SpdyWebSocketStream::OnDataReceived(const char* data, int length) {
+void SpdyWebSocketStream::OnDataReceived(IOBufferWithSize* buffer) {
   DCHECK(delegate_);
-  delegate_->OnReceivedSpdyData(data, length);
+  if (buffer)
+    delegate_->OnReceivedSpdyData(buffer->data(), buffer->size());
+  else
+    delegate_->OnReceivedSpdyData(NULL, 0);
 }
 
 void SpdyWebSocketStream::OnDataSent(int length) {
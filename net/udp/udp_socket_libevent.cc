@@ -46,7 +46,9 @@ UDPSocketLibevent::UDPSocketLibevent(
           write_watcher_(this),
           read_buf_len_(0),
           recv_from_address_(NULL),
+          batch_read_datagrams_(NULL),
           write_buf_len_(0),
+          batch_write_datagrams_(NULL),
           net_log_(BoundNetLog::Make(net_log, NetLog::SOURCE_UDP_SOCKET)) {
   scoped_refptr<NetLog::EventParameters> params;
   if (source.is_valid())
@@ -72,10 +74,12 @@ void UDPSocketLibevent::Close() {
   read_buf_len_ = 0;
   read_callback_.Reset();
   recv_from_address_ = NULL;
+  batch_read_datagrams_ = NULL;
   write_buf_ = NULL;
   write_buf_len_ = 0;
   write_callback_.Reset();
   send_to_address_.reset();
+  batch_write_datagrams_ = NULL;
 
   bool ok = read_socket_watcher_.StopWatchingFileDescriptor();
   DCHECK(ok);
@@ -215,6 +219,60 @@ int UDPSocketLibevent::SendToOrWrite(IOBuffer* buf,
   return ERR_IO_PENDING;
 }
 
+int UDPSocketLibevent::RecvBatch(std::vector<Datagram>* datagrams,
+                                 const CompletionCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_NE(kInvalidSocket, socket_);
+  DCHECK(read_callback_.is_null());
+  DCHECK(!callback.is_null());  // Synchronous operation not supported
+  DCHECK(datagrams);
+  DCHECK(!datagrams->empty());
+
+  int result = InternalRecvBatch(datagrams);
+  if (result != ERR_IO_PENDING)
+    return result;
+
+  if (!MessageLoopForIO::current()->WatchFileDescriptor(
+          socket_, true, MessageLoopForIO::WATCH_READ,
+          &read_socket_watcher_, &read_watcher_)) {
+    PLOG(ERROR) << "WatchFileDescriptor failed on read";
+    result = MapSystemError(errno);
+    LogRead(result, NULL, 0, NULL);
+    return result;
+  }
+
+  batch_read_datagrams_ = datagrams;
+  read_callback_ = callback;
+  return ERR_IO_PENDING;
+}
+
+int UDPSocketLibevent::SendBatch(const std::vector<Datagram>* datagrams,
+                                 const CompletionCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_NE(kInvalidSocket, socket_);
+  DCHECK(write_callback_.is_null());
+  DCHECK(!callback.is_null());  // Synchronous operation not supported
+  DCHECK(datagrams);
+  DCHECK(!datagrams->empty());
+
+  int result = InternalSendBatch(datagrams);
+  if (result != ERR_IO_PENDING)
+    return result;
+
+  if (!MessageLoopForIO::current()->WatchFileDescriptor(
+          socket_, true, MessageLoopForIO::WATCH_WRITE,
+          &write_socket_watcher_, &write_watcher_)) {
+    DVLOG(1) << "WatchFileDescriptor failed on write, errno " << errno;
+    result = MapSystemError(errno);
+    LogWrite(result, NULL, NULL);
+    return result;
+  }
+
+  batch_write_datagrams_ = datagrams;
+  write_callback_ = callback;
+  return ERR_IO_PENDING;
+}
+
 int UDPSocketLibevent::Connect(const IPEndPoint& address) {
   net_log_.BeginEvent(
       NetLog::TYPE_UDP_CONNECT,
@@ -304,11 +362,16 @@ void UDPSocketLibevent::DoWriteCallback(int rv) {
 }
 
 void UDPSocketLibevent::DidCompleteRead() {
-  int result = InternalRecvFrom(read_buf_, read_buf_len_, recv_from_address_);
+  int result;
+  if (batch_read_datagrams_)
+    result = InternalRecvBatch(batch_read_datagrams_);
+  else
+    result = InternalRecvFrom(read_buf_, read_buf_len_, recv_from_address_);
   if (result != ERR_IO_PENDING) {
     read_buf_ = NULL;
     read_buf_len_ = 0;
     recv_from_address_ = NULL;
+    batch_read_datagrams_ = NULL;
     bool ok = read_socket_watcher_.StopWatchingFileDescriptor();
     DCHECK(ok);
     DoReadCallback(result);
@@ -355,13 +418,18 @@ int UDPSocketLibevent::CreateSocket(const IPEndPoint& address) {
 }
 
 void UDPSocketLibevent::DidCompleteWrite() {
-  int result = InternalSendTo(write_buf_, write_buf_len_,
-                              send_to_address_.get());
+  int result;
+  if (batch_write_datagrams_)
+    result = InternalSendBatch(batch_write_datagrams_);
+  else
+    result = InternalSendTo(write_buf_, write_buf_len_,
+                            send_to_address_.get());
 
   if (result != ERR_IO_PENDING) {
     write_buf_ = NULL;
     write_buf_len_ = 0;
     send_to_address_.reset();
+    batch_write_datagrams_ = NULL;
     write_socket_watcher_.StopWatchingFileDescriptor();
     DoWriteCallback(result);
   }
@@ -447,6 +515,133 @@ int UDPSocketLibevent::InternalSendTo(IOBuffer* buf, int buf_len,
   return result;
 }
 
+int UDPSocketLibevent::InternalRecvBatch(std::vector<Datagram>* datagrams) {
+  const size_t count = datagrams->size();
+#if defined(OS_LINUX)
+  // Deliver as many ready datagrams as fit into |datagrams| with a single
+  // system call.
+  scoped_array<struct mmsghdr> msgs(new struct mmsghdr[count]);
+  scoped_array<struct iovec> iovs(new struct iovec[count]);
+  scoped_array<struct sockaddr_storage> addrs(
+      new struct sockaddr_storage[count]);
+  memset(msgs.get(), 0, count * sizeof(struct mmsghdr));
+  for (size_t i = 0; i < count; ++i) {
+    Datagram& datagram = (*datagrams)[i];
+    DCHECK(datagram.buffer);
+    iovs[i].iov_base = datagram.buffer->data();
+    iovs[i].iov_len = datagram.buffer_len;
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+  }
+
+  int nread = HANDLE_EINTR(recvmmsg(socket_, msgs.get(), count, 0, NULL));
+  if (nread < 0) {
+    int result = MapSystemError(errno);
+    if (result != ERR_IO_PENDING)
+      LogRead(result, NULL, 0, NULL);
+    return result;
+  }
+
+  for (int i = 0; i < nread; ++i) {
+    Datagram& datagram = (*datagrams)[i];
+    datagram.length = msgs[i].msg_len;
+    struct sockaddr* addr = reinterpret_cast<struct sockaddr*>(&addrs[i]);
+    if (!datagram.address.FromSockAddr(addr, msgs[i].msg_hdr.msg_namelen))
+      return ERR_FAILED;
+    LogRead(datagram.length, datagram.buffer->data(),
+            msgs[i].msg_hdr.msg_namelen, addr);
+  }
+  return nread;
+#else
+  // No recvmmsg() on this platform; drain one datagram per recvfrom().
+  size_t nread = 0;
+  while (nread < count) {
+    Datagram& datagram = (*datagrams)[nread];
+    DCHECK(datagram.buffer);
+    int result = InternalRecvFrom(datagram.buffer, datagram.buffer_len,
+                                  &datagram.address);
+    if (result < 0) {
+      // Report an error (or ERR_IO_PENDING) only if nothing was received;
+      // otherwise it will be seen again on the next call.
+      if (nread == 0)
+        return result;
+      break;
+    }
+    datagram.length = result;
+    ++nread;
+  }
+  return nread;
+#endif
+}
+
+int UDPSocketLibevent::InternalSendBatch(
+    const std::vector<Datagram>* datagrams) {
+  const size_t count = datagrams->size();
+#if defined(OS_LINUX)
+  // Hand the kernel all datagrams with a single system call.  On a connected
+  // socket the destination addresses are omitted.
+  scoped_array<struct mmsghdr> msgs(new struct mmsghdr[count]);
+  scoped_array<struct iovec> iovs(new struct iovec[count]);
+  scoped_array<struct sockaddr_storage> addrs(
+      new struct sockaddr_storage[count]);
+  memset(msgs.get(), 0, count * sizeof(struct mmsghdr));
+  for (size_t i = 0; i < count; ++i) {
+    const Datagram& datagram = (*datagrams)[i];
+    DCHECK(datagram.buffer);
+    iovs[i].iov_base = datagram.buffer->data();
+    iovs[i].iov_len = datagram.length;
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    if (!remote_address_.get()) {
+      size_t addr_len = sizeof(addrs[i]);
+      struct sockaddr* addr = reinterpret_cast<struct sockaddr*>(&addrs[i]);
+      if (!datagram.address.ToSockAddr(addr, &addr_len)) {
+        LogWrite(ERR_FAILED, NULL, NULL);
+        return ERR_FAILED;
+      }
+      msgs[i].msg_hdr.msg_name = addr;
+      msgs[i].msg_hdr.msg_namelen = addr_len;
+    }
+  }
+
+  int nsent = HANDLE_EINTR(sendmmsg(socket_, msgs.get(), count, 0));
+  if (nsent < 0) {
+    int result = MapSystemError(errno);
+    if (result != ERR_IO_PENDING)
+      LogWrite(result, NULL, NULL);
+    return result;
+  }
+
+  for (int i = 0; i < nsent; ++i) {
+    const Datagram& datagram = (*datagrams)[i];
+    LogWrite(datagram.length, datagram.buffer->data(),
+             remote_address_.get() ? NULL : &datagram.address);
+  }
+  return nsent;
+#else
+  // No sendmmsg() on this platform; send one datagram per sendto().
+  size_t nsent = 0;
+  while (nsent < count) {
+    const Datagram& datagram = (*datagrams)[nsent];
+    DCHECK(datagram.buffer);
+    int result = InternalSendTo(
+        datagram.buffer, datagram.length,
+        remote_address_.get() ? NULL : &datagram.address);
+    if (result < 0) {
+      // Report an error (or ERR_IO_PENDING) only if nothing was sent;
+      // otherwise the caller will see it when retrying the remainder.
+      if (nsent == 0)
+        return result;
+      break;
+    }
+    ++nsent;
+  }
+  return nsent;
+#endif
+}
+
 int UDPSocketLibevent::DoBind(const IPEndPoint& address) {
   struct sockaddr_storage addr_storage;
   size_t addr_len = sizeof(addr_storage);
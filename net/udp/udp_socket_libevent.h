@@ -6,6 +6,8 @@
 #define NET_UDP_UDP_SOCKET_LIBEVENT_H_
 #pragma once
 
+#include <vector>
+
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop.h"
@@ -23,6 +25,20 @@ namespace net {
 
 class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
  public:
+  // A single datagram for the batch APIs below.  |buffer| is allocated by the
+  // caller and |buffer_len| gives its capacity.  |length| is the datagram's
+  // size: an output of RecvBatch() and an input to SendBatch().  |address| is
+  // the sender (RecvBatch) or destination (SendBatch); it is ignored when
+  // sending on a connected socket.
+  struct Datagram {
+    Datagram() : buffer_len(0), length(0) {}
+
+    scoped_refptr<IOBuffer> buffer;
+    int buffer_len;
+    int length;
+    IPEndPoint address;
+  };
+
   UDPSocketLibevent(DatagramSocket::BindType bind_type,
                     const RandIntCallback& rand_int_cb,
                     net::NetLog* net_log,
@@ -94,6 +110,28 @@ class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
              const IPEndPoint& address,
              const CompletionCallback& callback);
 
+  // Reads up to |datagrams->size()| datagrams from the socket, using a single
+  // recvmmsg() system call on Linux (one recvfrom() per ready datagram
+  // elsewhere).  Each entry's |buffer| must be pre-allocated by the caller.
+  // Returns the number of datagrams received, a net error code, or
+  // ERR_IO_PENDING if no datagrams were ready; the callback is then run with
+  // one of the former values once the socket becomes readable.  The caller
+  // must keep |*datagrams| (and its buffers) alive until completion.  Shares
+  // the single outstanding read slot with Read()/RecvFrom().
+  int RecvBatch(std::vector<Datagram>* datagrams,
+                const CompletionCallback& callback);
+
+  // Sends |datagrams->size()| datagrams, using a single sendmmsg() system
+  // call on Linux (one sendto() per datagram elsewhere).  Returns the number
+  // of datagrams sent (which may be fewer than requested; the caller should
+  // retry with the remainder), a net error code, or ERR_IO_PENDING if the
+  // socket's send buffer was full; the callback is then run once the socket
+  // becomes writable.  The caller must keep |*datagrams| alive until
+  // completion.  Shares the single outstanding write slot with
+  // Write()/SendTo().
+  int SendBatch(const std::vector<Datagram>* datagrams,
+                const CompletionCallback& callback);
+
   // Set the receive buffer size (in bytes) for the socket.
   bool SetReceiveBufferSize(int32 size);
 
@@ -173,6 +211,8 @@ class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
   int InternalConnect(const IPEndPoint& address);
   int InternalRecvFrom(IOBuffer* buf, int buf_len, IPEndPoint* address);
   int InternalSendTo(IOBuffer* buf, int buf_len, const IPEndPoint* address);
+  int InternalRecvBatch(std::vector<Datagram>* datagrams);
+  int InternalSendBatch(const std::vector<Datagram>* datagrams);
 
   int DoBind(const IPEndPoint& address);
   int RandomBind(const IPEndPoint& address);
@@ -204,11 +244,19 @@ class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
   int read_buf_len_;
   IPEndPoint* recv_from_address_;
 
+  // The caller-owned datagram vector of an outstanding RecvBatch(), or NULL
+  // if the outstanding read (if any) is a single-datagram one.
+  std::vector<Datagram>* batch_read_datagrams_;
+
   // The buffer used by InternalWrite() to retry Write requests
   scoped_refptr<IOBuffer> write_buf_;
   int write_buf_len_;
   scoped_ptr<IPEndPoint> send_to_address_;
 
+  // The caller-owned datagram vector of an outstanding SendBatch(), or NULL
+  // if the outstanding write (if any) is a single-datagram one.
+  const std::vector<Datagram>* batch_write_datagrams_;
+
   // External callback; called when read is complete.
   CompletionCallback read_callback_;
 
@@ -28,6 +28,7 @@ URLRequestJob::URLRequestJob(URLRequest* request)
       postfilter_bytes_read_(0),
       filter_input_byte_count_(0),
       filter_needs_more_output_space_(false),
+      filter_bypassing_read_(false),
       filtered_read_buffer_len_(0),
       has_handled_response_(false),
       expected_content_size_(-1),
@@ -360,7 +361,17 @@ void URLRequestJob::NotifyReadComplete(int bytes_read) {
   // survival until we can get out of this method.
   scoped_refptr<URLRequestJob> self_preservation(this);
 
-  if (filter_.get()) {
+  if (filter_.get() && filter_bypassing_read_) {
+    // The raw read went straight into the caller's buffer, bypassing the
+    // pass through filter chain.  See ReadFilteredData().
+    filter_bypassing_read_ = false;
+    postfilter_bytes_read_ += bytes_read;
+    filtered_read_buffer_ = NULL;
+    filtered_read_buffer_len_ = 0;
+    if (!bytes_read)
+      DoneReading();
+    request_->NotifyReadCompleted(bytes_read);
+  } else if (filter_.get()) {
     // Tell the filter that it has more data
     FilteredDataRead(bytes_read);
 
@@ -495,6 +506,24 @@ bool URLRequestJob::ReadFilteredData(int* bytes_read) {
   if (is_done())
     return true;
 
+  if (!filter_needs_more_output_space_ && filter_->IsPassThroughChain()) {
+    // The filter chain has degenerated into an identity transform and holds
+    // no buffered data, so read straight into the caller's buffer, skipping
+    // the filter's stream buffer and the copy out of it.
+    filter_bypassing_read_ = true;
+    int raw_bytes_read = 0;
+    if (!ReadRawDataHelper(filtered_read_buffer_, filtered_read_buffer_len_,
+                           &raw_bytes_read)) {
+      return false;  // IO Pending (or error).
+    }
+    filter_bypassing_read_ = false;
+    *bytes_read = raw_bytes_read;
+    postfilter_bytes_read_ += raw_bytes_read;
+    filtered_read_buffer_ = NULL;
+    filtered_read_buffer_len_ = 0;
+    return true;
+  }
+
   if (!filter_needs_more_output_space_ && !filter_->stream_data_len()) {
     // We don't have any raw data to work with, so
     // read from the socket.
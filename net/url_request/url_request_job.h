@@ -350,6 +350,10 @@ class NET_EXPORT URLRequestJob : public base::RefCounted<URLRequestJob>,
   // still has internal data to emit, and this flag is set.
   bool filter_needs_more_output_space_;
 
+  // Set while a raw read is bypassing a pass through filter chain and going
+  // directly into |filtered_read_buffer_|.  See ReadFilteredData().
+  bool filter_bypassing_read_;
+
   // When we filter data, we receive data into the filter buffers.  After
   // processing the filtered data, we return the data in the caller's buffer.
   // While the async IO is in progress, we save the user buffer here, and
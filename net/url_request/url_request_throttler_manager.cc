@@ -8,6 +8,7 @@
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/string_util.h"
+#include "googleurl/src/url_parse.h"
 #include "net/base/net_log.h"
 #include "net/base/net_util.h"
 
@@ -15,6 +16,50 @@ namespace net {
 
 const unsigned int URLRequestThrottlerManager::kMaximumNumberOfEntries = 1500;
 const unsigned int URLRequestThrottlerManager::kRequestsBetweenCollecting = 200;
+const unsigned int URLRequestThrottlerManager::kGcChecksPerRequest = 4;
+
+namespace {
+
+// Parameters for a 64-bit FNV-1a hash.
+const uint64 kHashOffsetBasis = GG_UINT64_C(14695981039346656037);
+const uint64 kHashPrime = GG_UINT64_C(1099511628211);
+
+// Folds the lowercased |component| of |spec| into |hash|.
+uint64 HashUrlComponent(uint64 hash,
+                        const std::string& spec,
+                        const url_parse::Component& component) {
+  for (int i = component.begin; i < component.end(); ++i) {
+    hash ^= static_cast<unsigned char>(base::ToLowerASCII(spec[i]));
+    hash *= kHashPrime;
+  }
+  return hash;
+}
+
+// Computes a cheap hash with the granularity of GetIdFromUrl(): two URLs
+// with the same ID always hash to the same value, without the ID string
+// ever being built. IDs ignore username, password, query and ref, so only
+// the remaining components are hashed. Distinct IDs may collide and share
+// one back-off entry; with 64 bits and a map capped at
+// kMaximumNumberOfEntries this is vanishingly rare.
+uint64 HashUrlId(const GURL& url) {
+  const std::string& spec = url.possibly_invalid_spec();
+  if (!url.is_valid()) {
+    return HashUrlComponent(
+        kHashOffsetBasis, spec,
+        url_parse::Component(0, static_cast<int>(spec.size())));
+  }
+
+  const url_parse::Parsed& parsed = url.parsed_for_possibly_invalid_spec();
+  uint64 hash = HashUrlComponent(kHashOffsetBasis, spec, parsed.scheme);
+  hash *= kHashPrime;  // Separate components that could run together.
+  hash = HashUrlComponent(hash, spec, parsed.host);
+  hash *= kHashPrime;
+  hash = HashUrlComponent(hash, spec, parsed.port);
+  hash *= kHashPrime;
+  return HashUrlComponent(hash, spec, parsed.path);
+}
+
+}  // namespace
 
 URLRequestThrottlerManager::URLRequestThrottlerManager()
     : requests_since_last_gc_(0),
@@ -55,10 +100,11 @@ scoped_refptr<URLRequestThrottlerEntryInterface>
     URLRequestThrottlerManager::RegisterRequestUrl(const GURL &url) {
   DCHECK(!enable_thread_checks_ || CalledOnValidThread());
 
-  // Normalize the url.
-  std::string url_id = GetIdFromUrl(url);
+  // Hash the url; the full ID string is only built if a new entry is
+  // created below.
+  uint64 url_id = HashUrlId(url);
 
-  // Periodically garbage collect old entries.
+  // Lazily garbage collect old entries.
   GarbageCollectEntriesIfNecessary();
 
   // Find the entry in the map or create a new NULL entry.
@@ -74,7 +120,7 @@ scoped_refptr<URLRequestThrottlerEntryInterface>
 
   // Create the entry if needed.
   if (entry.get() == NULL) {
-    entry = new URLRequestThrottlerEntry(this, url_id);
+    entry = new URLRequestThrottlerEntry(this, GetIdFromUrl(url));
 
     // We only disable back-off throttling on an entry that we have
     // just constructed.  This is to allow unit tests to explicitly override
@@ -121,19 +167,14 @@ void URLRequestThrottlerManager::AddToOptOutList(const std::string& host) {
 void URLRequestThrottlerManager::OverrideEntryForTests(
     const GURL& url,
     URLRequestThrottlerEntry* entry) {
-  // Normalize the url.
-  std::string url_id = GetIdFromUrl(url);
-
   // Periodically garbage collect old entries.
   GarbageCollectEntriesIfNecessary();
 
-  url_entries_[url_id] = entry;
+  url_entries_[HashUrlId(url)] = entry;
 }
 
 void URLRequestThrottlerManager::EraseEntryForTests(const GURL& url) {
-  // Normalize the url.
-  std::string url_id = GetIdFromUrl(url);
-  url_entries_.erase(url_id);
+  url_entries_.erase(HashUrlId(url));
 }
 
 void URLRequestThrottlerManager::set_enable_thread_checks(bool enable) {
@@ -180,11 +221,34 @@ std::string URLRequestThrottlerManager::GetIdFromUrl(const GURL& url) const {
 
 void URLRequestThrottlerManager::GarbageCollectEntriesIfNecessary() {
   requests_since_last_gc_++;
-  if (requests_since_last_gc_ < kRequestsBetweenCollecting)
-    return;
-  requests_since_last_gc_ = 0;
+  if (requests_since_last_gc_ >= kRequestsBetweenCollecting &&
+      gc_keys_.empty()) {
+    requests_since_last_gc_ = 0;
+
+    // Snapshot the keys only; the entries themselves are examined a few at
+    // a time by subsequent requests, so no single request pays for a full
+    // sweep of the map.
+    gc_keys_.reserve(url_entries_.size());
+    for (UrlEntryMap::const_iterator i = url_entries_.begin();
+         i != url_entries_.end(); ++i) {
+      gc_keys_.push_back(i->first);
+    }
+  }
+
+  // Lazily expire a few entries from the current snapshot. Keys that have
+  // already been erased or refreshed are simply skipped.
+  for (unsigned int checked = 0;
+       checked < kGcChecksPerRequest && !gc_keys_.empty(); ++checked) {
+    UrlEntryMap::iterator i = url_entries_.find(gc_keys_.back());
+    gc_keys_.pop_back();
+    if (i != url_entries_.end() && i->second->IsEntryOutdated())
+      url_entries_.erase(i);
+  }
 
-  GarbageCollectEntries();
+  // In case something broke we want to make sure not to grow indefinitely.
+  while (url_entries_.size() > kMaximumNumberOfEntries) {
+    url_entries_.erase(url_entries_.begin());
+  }
 }
 
 void URLRequestThrottlerManager::GarbageCollectEntries() {
@@ -209,6 +273,7 @@ void URLRequestThrottlerManager::OnNetworkChange() {
   // inconsistent with new entries for the same URLs, but since what we
   // want is a clean slate for the new connection state, this is OK.
   url_entries_.clear();
+  gc_keys_.clear();
   requests_since_last_gc_ = 0;
 }
 
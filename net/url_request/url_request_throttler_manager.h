@@ -6,11 +6,12 @@
 #define NET_URL_REQUEST_URL_REQUEST_THROTTLER_MANAGER_H_
 #pragma once
 
-#include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
+#include "base/hash_tables.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
 #include "base/threading/platform_thread.h"
@@ -28,10 +29,10 @@ class NetLog;
 // in order to supervise traffic. URL requests for HTTP contents should
 // register their URLs in this manager on each request.
 //
-// URLRequestThrottlerManager maintains a map of URL IDs to URL request
+// URLRequestThrottlerManager maintains a hashed map of URL IDs to URL request
 // throttler entries. It creates URL request throttler entries when new URLs
-// are registered, and does garbage collection from time to time in order to
-// clean out outdated entries. URL ID consists of lowercased scheme, host, port
+// are registered, and lazily expires outdated entries a few at a time as
+// requests are registered. URL ID consists of lowercased scheme, host, port
 // and path. All URLs converted to the same ID will share the same entry.
 class NET_EXPORT URLRequestThrottlerManager
     : NON_EXPORTED_BASE(public base::NonThreadSafe),
@@ -91,9 +92,10 @@ class NET_EXPORT URLRequestThrottlerManager
   // transformation.
   std::string GetIdFromUrl(const GURL& url) const;
 
-  // Method that ensures the map gets cleaned from time to time. The period at
-  // which garbage collecting happens is adjustable with the
-  // kRequestBetweenCollecting constant.
+  // Method that ensures the map gets cleaned from time to time. Every
+  // kRequestsBetweenCollecting requests a snapshot of the map's keys is
+  // taken, and each subsequent request lazily expires a few entries from it,
+  // so no single request pays for a full sweep of the map.
   void GarbageCollectEntriesIfNecessary();
 
   // Method that does the actual work of garbage collecting.
@@ -112,9 +114,11 @@ class NET_EXPORT URLRequestThrottlerManager
   int GetNumberOfEntriesForTests() const { return url_entries_.size(); }
 
  private:
-  // From each URL we generate an ID composed of the scheme, host, port and path
-  // that allows us to uniquely map an entry to it.
-  typedef std::map<std::string, scoped_refptr<URLRequestThrottlerEntry> >
+  // From each URL we generate an ID composed of the scheme, host, port and
+  // path; the map is keyed by a cheap 64-bit hash of that ID so registering
+  // a request costs a hashed lookup rather than a string construction and a
+  // tree walk.
+  typedef base::hash_map<uint64, scoped_refptr<URLRequestThrottlerEntry> >
       UrlEntryMap;
 
   // We maintain a set of hosts that have opted out of exponential
@@ -125,6 +129,9 @@ class NET_EXPORT URLRequestThrottlerManager
   static const unsigned int kMaximumNumberOfEntries;
   // Number of requests that will be made between garbage collection.
   static const unsigned int kRequestsBetweenCollecting;
+  // Number of entries lazily checked for expiry per registered request while
+  // a garbage collection snapshot is being drained.
+  static const unsigned int kGcChecksPerRequest;
 
   // Map that contains a list of URL ID and their matching
   // URLRequestThrottlerEntry.
@@ -137,6 +144,10 @@ class NET_EXPORT URLRequestThrottlerManager
   // GarbageCollectEntries.
   unsigned int requests_since_last_gc_;
 
+  // Snapshot of the map's keys taken when garbage collection is due;
+  // drained a few keys at a time by subsequent requests.
+  std::vector<uint64> gc_keys_;
+
   // Valid after construction.
   GURL::Replacements url_id_replacements_;
 
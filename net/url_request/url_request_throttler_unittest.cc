@@ -423,6 +423,22 @@ TEST(URLRequestThrottlerManager, AreEntriesBeingCollected) {
   EXPECT_EQ(3, manager.GetNumberOfEntries());
 }
 
+TEST(URLRequestThrottlerManager, AreEntriesLazilyCollected) {
+  MockURLRequestThrottlerManager manager;
+
+  manager.CreateEntry(true);  // true = Entry is outdated.
+  manager.CreateEntry(true);
+  manager.CreateEntry(true);
+
+  // Lazy expiry piggy-backs on registrations; enough of them must both
+  // trigger a snapshot of the map's keys and drain it a few entries at a
+  // time, without any explicit garbage collection call.
+  for (int i = 0; i < 300; ++i)
+    manager.RegisterRequestUrl(GURL("http://www.example.com/"));
+
+  EXPECT_EQ(1, manager.GetNumberOfEntries());
+}
+
 TEST(URLRequestThrottlerManager, IsHostBeingRegistered) {
   MockURLRequestThrottlerManager manager;
 
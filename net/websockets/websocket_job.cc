@@ -114,8 +114,7 @@ bool WebSocketJob::SendData(const char* data, int len) {
           return true;
         }
         current_send_buffer_ = new DrainableIOBuffer(buffer.get(), len);
-        return SendDataInternal(current_send_buffer_->data(),
-                                current_send_buffer_->BytesRemaining());
+        return SendDataInternal(buffer.get());
       }
 
     case CLOSING:
@@ -622,11 +621,15 @@ void WebSocketJob::CompleteIO(int result) {
   }
 }
 
-bool WebSocketJob::SendDataInternal(const char* data, int length) {
-  if (spdy_websocket_stream_.get())
-    return ERR_IO_PENDING == spdy_websocket_stream_->SendData(data, length);
+bool WebSocketJob::SendDataInternal(IOBufferWithSize* buffer) {
+  if (spdy_websocket_stream_.get()) {
+    return ERR_IO_PENDING ==
+        spdy_websocket_stream_->SendData(buffer->data(), buffer->size());
+  }
+  // Hand the buffer itself to the socket, so the bytes aren't copied into
+  // yet another buffer per frame.
   if (socket_.get())
-    return socket_->SendData(data, length);
+    return socket_->SendBuffer(buffer);
   return false;
 }
 
@@ -653,8 +656,7 @@ void WebSocketJob::SendPending() {
   send_buffer_queue_.pop_front();
   current_send_buffer_ = new DrainableIOBuffer(next_buffer,
                                                next_buffer->size());
-  SendDataInternal(current_send_buffer_->data(),
-                   current_send_buffer_->BytesRemaining());
+  SendDataInternal(next_buffer.get());
 }
 
 }  // namespace net
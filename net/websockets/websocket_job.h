@@ -114,7 +114,7 @@ class NET_EXPORT WebSocketJob
   void RetryPendingIO();
   void CompleteIO(int result);
 
-  bool SendDataInternal(const char* data, int length);
+  bool SendDataInternal(IOBufferWithSize* buffer);
   void CloseInternal();
   void SendPending();
 
@@ -51,6 +51,10 @@ class MockSocketStream : public net::SocketStream {
     return true;
   }
 
+  virtual bool SendBuffer(net::IOBufferWithSize* buffer) OVERRIDE {
+    return SendData(buffer->data(), buffer->size());
+  }
+
   virtual void Close() OVERRIDE {}
   virtual void RestartWithAuth(
       const net::AuthCredentials& credentials) OVERRIDE {
@@ -11,25 +11,47 @@
 namespace ppapi {
 
 PluginArrayBufferVar::PluginArrayBufferVar(uint32 size_in_bytes)
-    : buffer_(size_in_bytes) {
+    : buffer_(size_in_bytes),
+      size_in_bytes_(size_in_bytes) {
+}
+
+PluginArrayBufferVar::PluginArrayBufferVar(
+    uint32 size_in_bytes,
+    base::SharedMemoryHandle plugin_handle)
+    : shmem_(new base::SharedMemory(plugin_handle, false)),
+      size_in_bytes_(size_in_bytes) {
+  if (!shmem_->Map(size_in_bytes_)) {
+    // Mapping failed; give the plugin a valid (zeroed) buffer rather than a
+    // NULL Map() result.
+    shmem_.reset();
+    buffer_.resize(size_in_bytes_);
+  }
 }
 
 PluginArrayBufferVar::~PluginArrayBufferVar() {
 }
 
 void* PluginArrayBufferVar::Map() {
+  if (shmem_.get())
+    return shmem_->memory();
   if (buffer_.empty())
     return NULL;
   return &(buffer_[0]);
 }
 
 void PluginArrayBufferVar::Unmap() {
-  // We don't actually use shared memory yet, so do nothing.
+  // The shared memory segment stays mapped, so that the buffer can be handed
+  // back to the host without copying it.
 }
 
 uint32 PluginArrayBufferVar::ByteLength() {
-  return buffer_.size();
+  return size_in_bytes_;
 }
 
-}  // namespace ppapi
+base::SharedMemoryHandle PluginArrayBufferVar::shared_memory_handle() {
+  if (shmem_.get())
+    return shmem_->handle();
+  return base::SharedMemory::NULLHandle();
+}
 
+}  // namespace ppapi
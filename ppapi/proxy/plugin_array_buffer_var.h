@@ -8,27 +8,40 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/shared_memory.h"
 #include "ppapi/c/pp_stdint.h"
 #include "ppapi/shared_impl/var.h"
 
 namespace ppapi {
 
 // Represents a plugin-side ArrayBufferVar. In the plugin process, it's
-// owned as a vector.
+// owned as a vector, unless the buffer arrived from the host in a shared
+// memory segment, in which case the segment itself is the storage.
 class PluginArrayBufferVar : public ArrayBufferVar {
  public:
   explicit PluginArrayBufferVar(uint32 size_in_bytes);
+  PluginArrayBufferVar(uint32 size_in_bytes,
+                       base::SharedMemoryHandle plugin_handle);
   virtual ~PluginArrayBufferVar();
 
   // ArrayBufferVar implementation.
   virtual void* Map() OVERRIDE;
   virtual void Unmap() OVERRIDE;
   virtual uint32 ByteLength() OVERRIDE;
+  virtual base::SharedMemoryHandle shared_memory_handle() OVERRIDE;
 
  private:
-  // TODO(dmichael): Use shared memory for this.
+  // Non-shared memory version.
   std::vector<uint8> buffer_;
 
+  // Shared memory version; NULL when |buffer_| is used. The segment stays
+  // mapped for the lifetime of the var, so handing the buffer back to the
+  // host only requires sharing the handle again.
+  scoped_ptr<base::SharedMemory> shmem_;
+
+  uint32 size_in_bytes_;
+
   DISALLOW_COPY_AND_ASSIGN(PluginArrayBufferVar);
 };
 
@@ -4,7 +4,11 @@
 
 #include "ppapi/proxy/serialized_var.h"
 
+#include <string.h>
+
 #include "base/logging.h"
+#include "base/platform_file.h"
+#include "build/build_config.h"
 #include "ipc/ipc_message_utils.h"
 #include "ppapi/proxy/dispatcher.h"
 #include "ppapi/proxy/interface_proxy.h"
@@ -15,12 +19,31 @@
 namespace ppapi {
 namespace proxy {
 
+namespace {
+
+// ArrayBuffer vars at least this big are moved between processes in shared
+// memory rather than being copied through the message pickle.
+const uint32 kMinimumArrayBufferSizeForShmem = 256 * 1024;
+
+base::PlatformFile PlatformFileFromSharedMemoryHandle(
+    const base::SharedMemoryHandle& handle) {
+#if defined(OS_WIN)
+  return handle;
+#else
+  return handle.fd;
+#endif
+}
+
+}  // namespace
+
 // SerializedVar::Inner --------------------------------------------------------
 
 SerializedVar::Inner::Inner()
     : serialization_rules_(NULL),
       var_(PP_MakeUndefined()),
-      cleanup_mode_(CLEANUP_NONE) {
+      cleanup_mode_(CLEANUP_NONE),
+      transport_shmem_handle_(base::SharedMemory::NULLHandle()),
+      transport_shmem_size_(0) {
 #ifndef NDEBUG
   has_been_serialized_ = false;
   has_been_deserialized_ = false;
@@ -30,7 +53,9 @@ SerializedVar::Inner::Inner()
 SerializedVar::Inner::Inner(VarSerializationRules* serialization_rules)
     : serialization_rules_(serialization_rules),
       var_(PP_MakeUndefined()),
-      cleanup_mode_(CLEANUP_NONE) {
+      cleanup_mode_(CLEANUP_NONE),
+      transport_shmem_handle_(base::SharedMemory::NULLHandle()),
+      transport_shmem_size_(0) {
 #ifndef NDEBUG
   has_been_serialized_ = false;
   has_been_deserialized_ = false;
@@ -123,11 +148,17 @@ void SerializedVar::Inner::WriteToMessage(IPC::Message* m) const {
       // generated there. Then the function implementing the interface can
       // handle the invalid string as if it was in process rather than seeing
       // what looks like a valid empty ArraryBuffer.
+      bool using_shmem = transport_shmem_size_ > 0;
+      m->WriteBool(using_shmem);
+      if (using_shmem) {
+        m->WriteUInt32(transport_shmem_size_);
+        IPC::ParamTraits<base::SharedMemoryHandle>::Write(
+            m, transport_shmem_handle_);
+        break;
+      }
       ArrayBufferVar* buffer_var = ArrayBufferVar::FromPPVar(var_);
       if (buffer_var) {
-        // TODO(dmichael): If it wasn't already Mapped, Unmap it. (Though once
-        //                 we use shared memory, this will probably be
-        //                 completely different anyway).
+        // TODO(dmichael): If it wasn't already Mapped, Unmap it.
         m->WriteData(static_cast<const char*>(buffer_var->Map()),
                      buffer_var->ByteLength());
       } else {
@@ -195,6 +226,24 @@ bool SerializedVar::Inner::ReadFromMessage(const IPC::Message* m,
       break;
     }
     case PP_VARTYPE_ARRAY_BUFFER: {
+      bool using_shmem = false;
+      if (!m->ReadBool(iter, &using_shmem))
+        break;
+      if (using_shmem) {
+        uint32 shmem_size = 0;
+        base::SharedMemoryHandle shmem_handle =
+            base::SharedMemory::NULLHandle();
+        success = m->ReadUInt32(iter, &shmem_size) &&
+            IPC::ParamTraits<base::SharedMemoryHandle>::Read(
+                m, iter, &shmem_handle);
+        if (success) {
+          raw_var_data_.reset(new RawVarData);
+          raw_var_data_->type = PP_VARTYPE_ARRAY_BUFFER;
+          raw_var_data_->shmem_handle = shmem_handle;
+          raw_var_data_->shmem_size = shmem_size;
+        }
+        break;
+      }
       int length = 0;
       const char* message_bytes = NULL;
       success = m->ReadData(iter, &message_bytes, &length);
@@ -228,6 +277,41 @@ bool SerializedVar::Inner::ReadFromMessage(const IPC::Message* m,
   return success;
 }
 
+void SerializedVar::Inner::PrepareArrayBufferForTransport(
+    Dispatcher* dispatcher) {
+  DCHECK(dispatcher);
+  if (var_.type != PP_VARTYPE_ARRAY_BUFFER || transport_shmem_size_ > 0)
+    return;
+  ArrayBufferVar* buffer_var = ArrayBufferVar::FromPPVar(var_);
+  if (!buffer_var)
+    return;
+  uint32 size = buffer_var->ByteLength();
+  if (size < kMinimumArrayBufferSizeForShmem)
+    return;
+
+  base::SharedMemoryHandle handle = buffer_var->shared_memory_handle();
+  if (base::SharedMemory::IsHandleValid(handle)) {
+    // The buffer is already backed by a segment (a plugin-side buffer that
+    // arrived from the host); just share that segment again.
+    transport_shmem_handle_ = dispatcher->ShareHandleWithRemote(
+        PlatformFileFromSharedMemoryHandle(handle), false);
+  } else {
+    // The bytes live on the heap. Move them into a segment we can share;
+    // this one copy replaces a copy into the message on this side and one
+    // out of it on the other side.
+    base::SharedMemory shared_memory;
+    if (!shared_memory.CreateAnonymous(size) || !shared_memory.Map(size))
+      return;  // Fall back to sending the bytes inline.
+    memcpy(shared_memory.memory(), buffer_var->Map(), size);
+    shared_memory.Unmap();
+    transport_shmem_handle_ = dispatcher->ShareHandleWithRemote(
+        PlatformFileFromSharedMemoryHandle(shared_memory.handle()), false);
+  }
+  if (!base::SharedMemory::IsHandleValid(transport_shmem_handle_))
+    return;  // Brokering failed; the bytes will go inline.
+  transport_shmem_size_ = size;
+}
+
 void SerializedVar::Inner::SetCleanupModeToEndSendPassRef() {
   cleanup_mode_ = END_SEND_PASS_REF;
 }
@@ -248,8 +332,13 @@ void SerializedVar::Inner::ConvertRawVarData() {
       break;
     }
     case PP_VARTYPE_ARRAY_BUFFER: {
-      var_ = PpapiGlobals::Get()->GetVarTracker()->MakeArrayBufferPPVar(
-          raw_var_data_->data.size(), raw_var_data_->data.data());
+      if (raw_var_data_->shmem_size > 0) {
+        var_ = PpapiGlobals::Get()->GetVarTracker()->MakeArrayBufferPPVar(
+            raw_var_data_->shmem_size, raw_var_data_->shmem_handle);
+      } else {
+        var_ = PpapiGlobals::Get()->GetVarTracker()->MakeArrayBufferPPVar(
+            raw_var_data_->data.size(), raw_var_data_->data.data());
+      }
       break;
     }
     default:
@@ -276,6 +365,7 @@ SerializedVarSendInput::SerializedVarSendInput(Dispatcher* dispatcher,
                                                const PP_Var& var)
     : SerializedVar(dispatcher->serialization_rules()) {
   inner_->SetVar(dispatcher->serialization_rules()->SendCallerOwned(var));
+  inner_->PrepareArrayBufferForTransport(dispatcher);
 }
 
 // static
@@ -442,6 +532,7 @@ void SerializedVarReturnValue::Return(Dispatcher* dispatcher,
 
   serialized_->inner_->SetVar(
       dispatcher->serialization_rules()->BeginSendPassRef(var));
+  serialized_->inner_->PrepareArrayBufferForTransport(dispatcher);
 }
 
 // static
@@ -469,6 +560,7 @@ SerializedVarOutParam::~SerializedVarOutParam() {
     serialized_->inner_->SetVar(
         serialized_->inner_->serialization_rules()->BeginSendPassRef(
             writable_var_));
+    serialized_->inner_->PrepareArrayBufferForTransport(dispatcher_);
 
     // Normally the current object will be created on the stack to wrap a
     // SerializedVar and won't have a scope around the actual IPC send. So we
@@ -11,6 +11,7 @@
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/shared_memory.h"
 #include "ppapi/c/pp_var.h"
 #include "ppapi/proxy/ppapi_proxy_export.h"
 #include "ppapi/proxy/var_serialization_rules.h"
@@ -111,6 +112,13 @@ class PPAPI_PROXY_EXPORT SerializedVar {
     void WriteToMessage(IPC::Message* m) const;
     bool ReadFromMessage(const IPC::Message* m, PickleIterator* iter);
 
+    // If the var is a large ArrayBuffer, moves its contents into a shared
+    // memory segment whose handle is brokered to the remote process so that
+    // WriteToMessage() sends the handle rather than the bytes. Must be called
+    // on the sending side, where a dispatcher is available; a no-op for other
+    // var types and for buffers below the size threshold.
+    void PrepareArrayBufferForTransport(Dispatcher* dispatcher);
+
     // Sets the cleanup mode. See the CleanupMode enum below.
     void SetCleanupModeToEndSendPassRef();
     void SetCleanupModeToEndReceiveCallerOwned();
@@ -135,8 +143,18 @@ class PPAPI_PROXY_EXPORT SerializedVar {
     // and create PP_Var later when GetVar() is called, which should happen on
     // the main thread.
     struct RawVarData {
+      RawVarData()
+          : type(PP_VARTYPE_UNDEFINED),
+            shmem_handle(base::SharedMemory::NULLHandle()),
+            shmem_size(0) {}
+
       PP_VarType type;
       std::string data;
+      // For PP_VARTYPE_ARRAY_BUFFER only: when |shmem_size| is nonzero the
+      // buffer contents are in the shared memory segment identified by
+      // |shmem_handle|, not in |data|.
+      base::SharedMemoryHandle shmem_handle;
+      uint32 shmem_size;
     };
 
     // Converts |raw_var_data_| to |var_|. It is a no-op if |raw_var_data_| is
@@ -172,6 +190,12 @@ class PPAPI_PROXY_EXPORT SerializedVar {
     // converted to PP_Var.
     scoped_ptr<RawVarData> raw_var_data_;
 
+    // Set by PrepareArrayBufferForTransport() when an ArrayBuffer is going to
+    // cross the proxy in shared memory. The handle is already valid in the
+    // remote process. A size of 0 means the bytes go inline in the message.
+    base::SharedMemoryHandle transport_shmem_handle_;
+    uint32 transport_shmem_size_;
+
     DISALLOW_COPY_AND_ASSIGN(Inner);
   };
 
@@ -4,8 +4,13 @@
 
 #include "ppapi/proxy/ppapi_proxy_test.h"
 
+#include <string.h>
+
+#include "base/pickle.h"
+#include "ipc/ipc_message.h"
 #include "ppapi/proxy/serialized_var.h"
 #include "ppapi/shared_impl/proxy_lock.h"
+#include "ppapi/shared_impl/var.h"
 
 namespace ppapi {
 namespace proxy {
@@ -344,5 +349,40 @@ TEST_F(SerializedVarTest, PluginReturnValue) {
   EXPECT_EQ(1u, sink().message_count());
 }
 
+// Round-trips a large ArrayBuffer through an IPC::Message. Buffers this big
+// normally cross the proxy in a shared memory segment; if the segment can't
+// be created the bytes go inline, and either way the contents must survive
+// the trip intact.
+TEST_F(SerializedVarTest, ArrayBufferLargeRoundTrip) {
+  ProxyAutoLock lock;
+  const uint32 kBufferSize = 300 * 1024;  // Above the shared memory threshold.
+
+  PP_Var input = var_tracker().MakeArrayBufferPPVar(kBufferSize);
+  ArrayBufferVar* input_buffer = ArrayBufferVar::FromPPVar(input);
+  ASSERT_TRUE(input_buffer);
+  memset(input_buffer->Map(), 0x5A, kBufferSize);
+
+  IPC::Message msg;
+  {
+    SerializedVarSendInput sent(plugin_dispatcher(), input);
+    sent.WriteToMessage(&msg);
+  }
+
+  SerializedVar received;
+  PickleIterator iter(msg);
+  ASSERT_TRUE(received.ReadFromMessage(&msg, &iter));
+  {
+    SerializedVarReceiveInput receive_input(received);
+    PP_Var output = receive_input.Get(plugin_dispatcher());
+    ArrayBufferVar* output_buffer = ArrayBufferVar::FromPPVar(output);
+    ASSERT_TRUE(output_buffer);
+    ASSERT_EQ(kBufferSize, output_buffer->ByteLength());
+    EXPECT_EQ(0, memcmp(input_buffer->Map(), output_buffer->Map(),
+                        kBufferSize));
+  }
+
+  var_tracker().ReleaseVar(input);
+}
+
 }  // namespace proxy
 }  // namespace ppapi
@@ -174,6 +174,11 @@ ArrayBufferVar::ArrayBufferVar() {
 ArrayBufferVar::~ArrayBufferVar() {
 }
 
+base::SharedMemoryHandle ArrayBufferVar::shared_memory_handle() {
+  // Most implementations keep the bytes on the heap.
+  return base::SharedMemory::NULLHandle();
+}
+
 ArrayBufferVar* ArrayBufferVar::AsArrayBufferVar() {
   return this;
 }
@@ -10,6 +10,7 @@
 #include "base/compiler_specific.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/shared_memory.h"
 #include "ppapi/c/pp_var.h"
 #include "ppapi/shared_impl/ppapi_shared_export.h"
 
@@ -157,6 +158,11 @@ class PPAPI_SHARED_EXPORT ArrayBufferVar : public Var {
   virtual void Unmap() = 0;
   virtual uint32 ByteLength() = 0;
 
+  // Returns the handle of the shared memory segment that backs this buffer,
+  // or SharedMemory::NULLHandle() when the bytes live on the heap. The proxy
+  // uses this to pass a large buffer to the other process without copying it.
+  virtual base::SharedMemoryHandle shared_memory_handle();
+
   // Var override.
   virtual ArrayBufferVar* AsArrayBufferVar() OVERRIDE;
   virtual PP_VarType GetType() const OVERRIDE;
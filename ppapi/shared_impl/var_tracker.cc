@@ -195,6 +195,17 @@ PP_Var VarTracker::MakeArrayBufferPPVar(uint32 size_in_bytes,
   return array_buffer->GetPPVar();
 }
 
+PP_Var VarTracker::MakeArrayBufferPPVar(uint32 size_in_bytes,
+                                        base::SharedMemoryHandle handle) {
+  DCHECK(CalledOnValidThread());
+
+  scoped_refptr<ArrayBufferVar> array_buffer(
+      CreateShmArrayBuffer(size_in_bytes, handle));
+  if (!array_buffer)
+    return PP_MakeNull();
+  return array_buffer->GetPPVar();
+}
+
 std::vector<PP_Var> VarTracker::GetLiveVars() {
   DCHECK(CalledOnValidThread());
 
@@ -10,6 +10,7 @@
 #include "base/basictypes.h"
 #include "base/hash_tables.h"
 #include "base/memory/ref_counted.h"
+#include "base/shared_memory.h"
 #include "base/threading/non_thread_safe.h"
 #include "ppapi/c/pp_module.h"
 #include "ppapi/c/pp_var.h"
@@ -71,6 +72,11 @@ class PPAPI_SHARED_EXPORT VarTracker
   PP_Var MakeArrayBufferPPVar(uint32 size_in_bytes);
   // Same as above, but copy the contents of |data| in to the new array buffer.
   PP_Var MakeArrayBufferPPVar(uint32 size_in_bytes, const void* data);
+  // Same as above, but take the shared memory segment identified by |handle|
+  // as the contents of the new array buffer. Ownership of |handle| passes to
+  // the new buffer.
+  PP_Var MakeArrayBufferPPVar(uint32 size_in_bytes,
+                              base::SharedMemoryHandle handle);
 
   // Return a vector containing all PP_Vars that are in the tracker. This is
   // to help implement PPB_Testing_Dev.GetLiveVars and should generally not be
@@ -162,6 +168,13 @@ class PPAPI_SHARED_EXPORT VarTracker
   // a real WebKit ArrayBuffer on the host side.
   virtual ArrayBufferVar* CreateArrayBuffer(uint32 size_in_bytes) = 0;
 
+  // Same as above, but with the shared memory segment identified by |handle|
+  // as the contents. The plugin side keeps the segment mapped in place; the
+  // host side has to copy it into a buffer WebKit can own.
+  virtual ArrayBufferVar* CreateShmArrayBuffer(
+      uint32 size_in_bytes,
+      base::SharedMemoryHandle handle) = 0;
+
   DISALLOW_COPY_AND_ASSIGN(VarTracker);
 };
 
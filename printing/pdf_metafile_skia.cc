@@ -76,9 +76,33 @@ bool PdfMetafileSkia::StartPage(const gfx::Size& page_size,
   return NULL;
 }
 
+void PdfMetafileSkia::StreamPagesTo(PageConsumer* consumer) {
+  DCHECK(consumer);
+  DCHECK(!page_outstanding_);
+  DCHECK_EQ(0U, data_->pdf_stream_.getOffset());
+  page_consumer_ = consumer;
+}
+
 bool PdfMetafileSkia::FinishPage() {
   DCHECK(data_->current_page_.get());
 
+  if (page_consumer_) {
+    // Hand the page off instead of accumulating it in |pdf_doc_|, so memory
+    // use stays bounded by a single page. Skia flate-compresses the content
+    // streams as it emits them.
+    SkPDFDocument pdf_doc(SkPDFDocument::kDraftMode_Flags);
+    SkDynamicMemoryWStream pdf_stream;
+    bool emitted = pdf_doc.appendPage(data_->current_page_.get()) &&
+                   pdf_doc.emitPDF(&pdf_stream);
+    data_->current_page_ = NULL;
+    page_outstanding_ = false;
+    if (!emitted)
+      return false;
+
+    SkAutoDataUnref data(pdf_stream.copyToData());
+    return page_consumer_->ConsumePage(data.bytes(), data.size());
+  }
+
   data_->pdf_doc_.appendPage(data_->current_page_.get());
   page_outstanding_ = false;
   return true;
@@ -89,11 +113,16 @@ bool PdfMetafileSkia::FinishDocument() {
   if (data_->pdf_stream_.getOffset())
     return true;
 
-  if (page_outstanding_)
-    FinishPage();
+  if (page_outstanding_ && !FinishPage())
+    return false;
 
   data_->current_page_ = NULL;
 
+  // In page-streaming mode every page has already been handed to the
+  // consumer; there is no document-level data to emit.
+  if (page_consumer_)
+    return true;
+
   int font_counts[SkAdvancedTypefaceMetrics::kNotEmbeddable_Font + 1];
   data_->pdf_doc_.getCountOfFontTypes(font_counts);
   for (int type = 0;
@@ -226,6 +255,7 @@ bool PdfMetafileSkia::SaveToFD(const base::FileDescriptor& fd) const {
 
 PdfMetafileSkia::PdfMetafileSkia()
     : data_(new PdfMetafileSkiaData),
+      page_consumer_(NULL),
       page_outstanding_(false) {
 }
 
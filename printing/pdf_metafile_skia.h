@@ -22,9 +22,32 @@ struct PdfMetafileSkiaData;
 // This class uses Skia graphics library to generate a PDF document.
 class PRINTING_EXPORT PdfMetafileSkia : public Metafile {
  public:
+  // Receives the pages of a metafile put into page-streaming mode with
+  // StreamPagesTo().
+  class PRINTING_EXPORT PageConsumer {
+   public:
+    virtual ~PageConsumer() {}
+
+    // Called from FinishPage() with a complete single-page PDF in
+    // |src_buffer|. The buffer is only valid for the duration of the call.
+    // Return false to abort the document.
+    virtual bool ConsumePage(const void* src_buffer,
+                             uint32 src_buffer_size) = 0;
+  };
+
   PdfMetafileSkia();
   virtual ~PdfMetafileSkia();
 
+  // Puts the metafile into page-streaming mode: each finished page is
+  // serialized as its own PDF and handed to |consumer| from FinishPage(),
+  // then released, so memory use is bounded by one page instead of the whole
+  // document and spooling can overlap the rendering of later pages. In this
+  // mode FinishDocument() emits no data and GetDataSize() stays 0. Pages
+  // streamed this way duplicate shared resources such as fonts into every
+  // page. Must be called before the first page is started; |consumer| must
+  // outlive this metafile.
+  void StreamPagesTo(PageConsumer* consumer);
+
   // Metafile methods.
   virtual bool Init() OVERRIDE;
   virtual bool InitFromData(const void* src_buffer,
@@ -76,6 +99,9 @@ class PRINTING_EXPORT PdfMetafileSkia : public Metafile {
  private:
   scoped_ptr<PdfMetafileSkiaData> data_;
 
+  // Non-NULL when in page-streaming mode; not owned.
+  PageConsumer* page_consumer_;
+
   // True when finish page is outstanding for current page.
   bool page_outstanding_;
 
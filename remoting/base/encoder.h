@@ -31,6 +31,11 @@ class Encoder {
 
   virtual ~Encoder() {}
 
+  // Returns the number of threads that encoded the most recent frame.
+  // Encoders that slice a frame across several cores override this so that
+  // the capture scheduler can estimate CPU time from wall-clock encode time.
+  virtual int GetFrameParallelism() const { return 1; }
+
   // Encode an image stored in |capture_data|.
   //
   // If |key_frame| is true, the encoder should not reference
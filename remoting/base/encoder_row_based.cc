@@ -4,7 +4,12 @@
 
 #include "remoting/base/encoder_row_based.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/logging.h"
+#include "base/sys_info.h"
+#include "base/threading/platform_thread.h"
 #include "remoting/base/capture_data.h"
 #include "remoting/base/compressor_verbatim.h"
 #include "remoting/base/compressor_zlib.h"
@@ -15,6 +20,64 @@ namespace remoting {
 
 static const int kPacketSize = 1024 * 1024;
 
+// Rects shorter than twice this many rows are not sliced into bands.
+// Each band is an independently decodable rect update with its own packet
+// headers and compressor state, so slicing small rects would only add
+// overhead.
+static const int kMinimumBandHeight = 256;
+
+// A band of a dirty rect, plus the packets produced by encoding it. The
+// packets are buffered here so that bands compressed on different threads
+// can be delivered to the client in band order.
+struct EncoderRowBased::Band {
+  explicit Band(const SkIRect& band_rect) : rect(band_rect) {}
+
+  SkIRect rect;
+  ScopedVector<VideoPacket> packets;
+};
+
+// Encodes every |stride|'th band starting at |first_band|, using its own
+// compressor. The interleaved assignment keeps the per-thread work roughly
+// balanced without any locking; each band's packet list is touched by
+// exactly one thread.
+class EncoderRowBased::BandThread : public base::PlatformThread::Delegate {
+ public:
+  BandThread(EncoderRowBased* encoder,
+             std::vector<Band*>* bands,
+             size_t first_band,
+             size_t stride,
+             bool include_screen_size)
+      : encoder_(encoder),
+        bands_(bands),
+        first_band_(first_band),
+        stride_(stride),
+        include_screen_size_(include_screen_size),
+        compressor_(encoder->CreateCompressor()) {
+  }
+
+  virtual ~BandThread() {}
+
+  virtual void ThreadMain() OVERRIDE {
+    for (size_t i = first_band_; i < bands_->size(); i += stride_) {
+      Band* band = (*bands_)[i];
+      encoder_->EncodeRect(compressor_.get(), band->rect,
+                           include_screen_size_ && i == 0,
+                           i == bands_->size() - 1,
+                           &band->packets);
+    }
+  }
+
+ private:
+  EncoderRowBased* encoder_;
+  std::vector<Band*>* bands_;
+  size_t first_band_;
+  size_t stride_;
+  bool include_screen_size_;
+  scoped_ptr<Compressor> compressor_;
+
+  DISALLOW_COPY_AND_ASSIGN(BandThread);
+};
+
 EncoderRowBased* EncoderRowBased::CreateZlibEncoder() {
   return new EncoderRowBased(new CompressorZlib(),
                              VideoPacketFormat::ENCODING_ZLIB);
@@ -42,7 +105,9 @@ EncoderRowBased::EncoderRowBased(Compressor* compressor,
     : encoding_(encoding),
       compressor_(compressor),
       screen_size_(SkISize::Make(0,0)),
-      packet_size_(kPacketSize) {
+      packet_size_(kPacketSize),
+      max_parallelism_(base::SysInfo::NumberOfProcessors()),
+      last_frame_parallelism_(1) {
 }
 
 EncoderRowBased::EncoderRowBased(Compressor* compressor,
@@ -51,11 +116,29 @@ EncoderRowBased::EncoderRowBased(Compressor* compressor,
     : encoding_(encoding),
       compressor_(compressor),
       screen_size_(SkISize::Make(0,0)),
-      packet_size_(packet_size) {
+      packet_size_(packet_size),
+      max_parallelism_(base::SysInfo::NumberOfProcessors()),
+      last_frame_parallelism_(1) {
 }
 
 EncoderRowBased::~EncoderRowBased() {}
 
+int EncoderRowBased::GetFrameParallelism() const {
+  return last_frame_parallelism_;
+}
+
+Compressor* EncoderRowBased::CreateCompressor() {
+  switch (encoding_) {
+    case VideoPacketFormat::ENCODING_ZLIB:
+      return new CompressorZlib();
+    case VideoPacketFormat::ENCODING_VERBATIM:
+      return new CompressorVerbatim();
+    default:
+      NOTREACHED() << "Unsupported encoding " << encoding_;
+      return NULL;
+  }
+}
+
 void EncoderRowBased::Encode(
     scoped_refptr<CaptureData> capture_data,
     bool key_frame,
@@ -66,29 +149,89 @@ void EncoderRowBased::Encode(
   capture_data_ = capture_data;
   callback_ = data_available_callback;
 
-  const SkRegion& region = capture_data->dirty_region();
-  SkRegion::Iterator iter(region);
-  while (!iter.done()) {
+  bool include_screen_size = capture_data->size() != screen_size_;
+  if (include_screen_size)
+    screen_size_ = capture_data->size();
+
+  // Partition the dirty region into bands, slicing tall rects so that the
+  // bands can be compressed in parallel.
+  ScopedVector<Band> bands;
+  for (SkRegion::Iterator iter(capture_data->dirty_region());
+       !iter.done(); iter.next()) {
     SkIRect rect = iter.rect();
-    iter.next();
-    EncodeRect(rect, iter.done());
+    int slices = std::min(max_parallelism_,
+                          rect.height() / kMinimumBandHeight);
+    if (slices <= 1) {
+      bands.push_back(new Band(rect));
+      continue;
+    }
+    int top = rect.fTop;
+    for (int i = 0; i < slices; ++i) {
+      int bottom = rect.fTop + rect.height() * (i + 1) / slices;
+      bands.push_back(new Band(SkIRect::MakeLTRB(rect.fLeft, top,
+                                                 rect.fRight, bottom)));
+      top = bottom;
+    }
+  }
+
+  int thread_count = std::min(max_parallelism_,
+                              static_cast<int>(bands.size()));
+  last_frame_parallelism_ = std::max(thread_count, 1);
+
+  if (thread_count <= 1) {
+    for (size_t i = 0; i < bands.size(); ++i) {
+      EncodeRect(compressor_.get(), bands[i]->rect,
+                 include_screen_size && i == 0,
+                 i == bands.size() - 1,
+                 &bands[i]->packets);
+    }
+  } else {
+    ScopedVector<BandThread> threads;
+    for (int i = 0; i < thread_count; ++i) {
+      threads.push_back(new BandThread(this, &bands.get(), i, thread_count,
+                                       include_screen_size));
+    }
+    std::vector<base::PlatformThreadHandle> handles(thread_count,
+                                                    base::kNullThreadHandle);
+    for (int i = 0; i < thread_count; ++i) {
+      if (!base::PlatformThread::Create(0, threads[i], &handles[i])) {
+        // Thread creation failed; do this slice of the work here.
+        threads[i]->ThreadMain();
+      }
+    }
+    for (int i = 0; i < thread_count; ++i) {
+      if (handles[i] != base::kNullThreadHandle)
+        base::PlatformThread::Join(handles[i]);
+    }
+  }
+
+  // Deliver the buffered packets in band order.
+  for (size_t i = 0; i < bands.size(); ++i) {
+    std::vector<VideoPacket*>& packets = bands[i]->packets.get();
+    for (size_t j = 0; j < packets.size(); ++j) {
+      scoped_ptr<VideoPacket> packet(packets[j]);
+      callback_.Run(packet.Pass());
+    }
+    packets.clear();
   }
 
   capture_data_ = NULL;
   callback_.Reset();
 }
 
-void EncoderRowBased::EncodeRect(const SkIRect& rect, bool last) {
+void EncoderRowBased::EncodeRect(Compressor* compressor, const SkIRect& rect,
+                                 bool include_screen_size, bool last,
+                                 ScopedVector<VideoPacket>* packets) {
   CHECK(capture_data_->data_planes().data[0]);
   CHECK_EQ(capture_data_->pixel_format(), media::VideoFrame::RGB32);
   const int strides = capture_data_->data_planes().strides[0];
   const int bytes_per_pixel = 4;
   const int row_size = bytes_per_pixel * rect.width();
 
-  compressor_->Reset();
+  compressor->Reset();
 
   scoped_ptr<VideoPacket> packet(new VideoPacket());
-  PrepareUpdateStart(rect, packet.get());
+  PrepareUpdateStart(rect, packet.get(), include_screen_size);
   const uint8* in = capture_data_->data_planes().data[0] +
       rect.fTop * strides + rect.fLeft * bytes_per_pixel;
   // TODO(hclam): Fill in the sequence number.
@@ -112,9 +255,9 @@ void EncoderRowBased::EncodeRect(const SkIRect& rect, bool last) {
 
     int consumed = 0;
     int written = 0;
-    compress_again = compressor_->Process(in + row_pos, row_size - row_pos,
-                                          out + filled, packet_size_ - filled,
-                                          flush, &consumed, &written);
+    compress_again = compressor->Process(in + row_pos, row_size - row_pos,
+                                         out + filled, packet_size_ - filled,
+                                         flush, &consumed, &written);
     row_pos += consumed;
     filled += written;
 
@@ -133,7 +276,7 @@ void EncoderRowBased::EncodeRect(const SkIRect& rect, bool last) {
     // If we have filled the message or we have reached the end of stream.
     if (filled == packet_size_ || !compress_again) {
       packet->mutable_data()->resize(filled);
-      callback_.Run(packet.Pass());
+      packets->push_back(packet.release());
     }
 
     // Reached the end of input row and we're not at the last row.
@@ -146,7 +289,8 @@ void EncoderRowBased::EncodeRect(const SkIRect& rect, bool last) {
 }
 
 void EncoderRowBased::PrepareUpdateStart(const SkIRect& rect,
-                                         VideoPacket* packet) {
+                                         VideoPacket* packet,
+                                         bool include_screen_size) {
   packet->set_flags(packet->flags() | VideoPacket::FIRST_PACKET);
 
   VideoPacketFormat* format = packet->mutable_format();
@@ -155,8 +299,7 @@ void EncoderRowBased::PrepareUpdateStart(const SkIRect& rect,
   format->set_width(rect.width());
   format->set_height(rect.height());
   format->set_encoding(encoding_);
-  if (capture_data_->size() != screen_size_) {
-    screen_size_ = capture_data_->size();
+  if (include_screen_size) {
     format->set_screen_width(screen_size_.width());
     format->set_screen_height(screen_size_.height());
   }
@@ -5,6 +5,7 @@
 #ifndef REMOTING_BASE_ENCODER_ROW_BASED_H_
 #define REMOTING_BASE_ENCODER_ROW_BASED_H_
 
+#include "base/memory/scoped_vector.h"
 #include "remoting/base/encoder.h"
 #include "remoting/proto/video.pb.h"
 #include "third_party/skia/include/core/SkRect.h"
@@ -20,6 +21,11 @@ class Compressor;
 //
 // Compressor is reset before encoding each rectangle, so that each
 // rectangle can be decoded independently.
+//
+// Because rectangles are independent, tall dirty rects are sliced into
+// horizontal bands that are compressed in parallel, one thread and one
+// compressor per band, and the resulting packets are delivered in band
+// order.
 class EncoderRowBased : public Encoder {
  public:
   static EncoderRowBased* CreateZlibEncoder();
@@ -29,21 +35,36 @@ class EncoderRowBased : public Encoder {
 
   virtual ~EncoderRowBased();
 
+  virtual int GetFrameParallelism() const OVERRIDE;
+
   virtual void Encode(
       scoped_refptr<CaptureData> capture_data,
       bool key_frame,
       const DataAvailableCallback& data_available_callback) OVERRIDE;
 
  private:
+  struct Band;
+  class BandThread;
+
   EncoderRowBased(Compressor* compressor, VideoPacketFormat::Encoding encoding);
   EncoderRowBased(Compressor* compressor, VideoPacketFormat::Encoding encoding,
                   int packet_size);
 
-  // Encode a single dirty rect using compressor.
-  void EncodeRect(const SkIRect& rect, bool last);
+  // Creates a compressor of the type this encoder was configured with.
+  // Each encode thread needs its own compressor.
+  Compressor* CreateCompressor();
+
+  // Encode a single band using |compressor|, appending the resulting
+  // packets to |packets|. |include_screen_size| marks the first packet
+  // with the screen dimensions; |last| marks the band as the final one of
+  // the frame.
+  void EncodeRect(Compressor* compressor, const SkIRect& rect,
+                  bool include_screen_size, bool last,
+                  ScopedVector<VideoPacket>* packets);
 
   // Marks a packet as the first in a series of rectangle updates.
-  void PrepareUpdateStart(const SkIRect& rect, VideoPacket* packet);
+  void PrepareUpdateStart(const SkIRect& rect, VideoPacket* packet,
+                          bool include_screen_size);
 
   // Retrieves a pointer to the output buffer in |update| used for storing the
   // encoded rectangle data.  Will resize the buffer to |size|.
@@ -64,6 +85,12 @@ class EncoderRowBased : public Encoder {
   SkISize screen_size_;
 
   int packet_size_;
+
+  // Maximum number of encode threads per frame, from the processor count.
+  int max_parallelism_;
+
+  // Number of threads used to encode the most recent frame.
+  int last_frame_parallelism_;
 };
 
 }  // namespace remoting
@@ -2,12 +2,38 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string.h>
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/scoped_vector.h"
+#include "remoting/base/capture_data.h"
 #include "remoting/base/codec_test.h"
 #include "remoting/base/encoder_row_based.h"
+#include "remoting/proto/video.pb.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace remoting {
 
+namespace {
+
+// Collects the packets emitted by an encode so that the band structure can
+// be inspected afterwards.
+class PacketCollector {
+ public:
+  void DataAvailable(scoped_ptr<VideoPacket> packet) {
+    packets_.push_back(packet.release());
+  }
+
+  const std::vector<VideoPacket*>& packets() const { return packets_.get(); }
+
+ private:
+  ScopedVector<VideoPacket> packets_;
+};
+
+}  // namespace
+
 TEST(EncoderZlibTest, TestEncoder) {
   scoped_ptr<EncoderRowBased> encoder(EncoderRowBased::CreateZlibEncoder());
   TestEncoder(encoder.get(), true);
@@ -18,4 +44,50 @@ TEST(EncoderZlibTest, TestEncoderSmallOutputBuffer) {
   TestEncoder(encoder.get(), true);
 }
 
+// A tall dirty rect may be sliced into bands that are encoded in parallel
+// on multi-core hosts. Whatever the slicing, the emitted rects must tile
+// the dirty rect from top to bottom and only the final packet of the frame
+// may carry LAST_PARTITION.
+TEST(EncoderZlibTest, TestEncoderTallFrame) {
+  const int kWidth = 64;
+  const int kHeight = 1024;
+  const int kBytesPerPixel = 4;
+
+  scoped_array<uint8> memory(new uint8[kWidth * kHeight * kBytesPerPixel]);
+  memset(memory.get(), 0, kWidth * kHeight * kBytesPerPixel);
+
+  DataPlanes planes;
+  planes.data[0] = memory.get();
+  planes.strides[0] = kWidth * kBytesPerPixel;
+
+  scoped_refptr<CaptureData> data =
+      new CaptureData(planes, SkISize::Make(kWidth, kHeight),
+                      media::VideoFrame::RGB32);
+  data->mutable_dirty_region().setRect(SkIRect::MakeWH(kWidth, kHeight));
+
+  scoped_ptr<EncoderRowBased> encoder(EncoderRowBased::CreateZlibEncoder());
+  PacketCollector collector;
+  encoder->Encode(data, true,
+                  base::Bind(&PacketCollector::DataAvailable,
+                             base::Unretained(&collector)));
+
+  const std::vector<VideoPacket*>& packets = collector.packets();
+  ASSERT_FALSE(packets.empty());
+
+  int next_top = 0;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    const VideoPacket* packet = packets[i];
+    if (packet->flags() & VideoPacket::FIRST_PACKET) {
+      EXPECT_EQ(0, packet->format().x());
+      EXPECT_EQ(kWidth, packet->format().width());
+      EXPECT_EQ(next_top, packet->format().y());
+      next_top += packet->format().height();
+    }
+    bool is_last = (i == packets.size() - 1);
+    EXPECT_EQ(is_last,
+              (packet->flags() & VideoPacket::LAST_PARTITION) != 0);
+  }
+  EXPECT_EQ(kHeight, next_top);
+}
+
 }  // namespace remoting
@@ -57,7 +57,15 @@ void CaptureScheduler::RecordCaptureTime(base::TimeDelta capture_time) {
 }
 
 void CaptureScheduler::RecordEncodeTime(base::TimeDelta encode_time) {
-  encode_time_.Record(encode_time.InMilliseconds());
+  RecordEncodeTime(encode_time, 1);
+}
+
+void CaptureScheduler::RecordEncodeTime(base::TimeDelta encode_time,
+                                        int parallelism) {
+  DCHECK_GE(parallelism, 1);
+  // Scale wall-clock time by the number of busy cores to approximate CPU
+  // time before charging it against the budget.
+  encode_time_.Record(encode_time.InMilliseconds() * parallelism);
 }
 
 }  // namespace remoting
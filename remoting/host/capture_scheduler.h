@@ -22,9 +22,13 @@ class CaptureScheduler {
   // Determine the time delay from current time to perform next capture.
   base::TimeDelta NextCaptureDelay();
 
-  // Record time spent on capturing and encoding.
+  // Record time spent on capturing and encoding. |encode_time| is
+  // wall-clock time; |parallelism| is the number of threads the encoder
+  // kept busy for that long, so that sliced parallel encodes are charged
+  // their full CPU cost.
   void RecordCaptureTime(base::TimeDelta capture_time);
   void RecordEncodeTime(base::TimeDelta encode_time);
+  void RecordEncodeTime(base::TimeDelta encode_time, int parallelism);
 
  private:
   int num_of_processors_;
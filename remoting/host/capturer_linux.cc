@@ -304,8 +304,10 @@ void CapturerLinux::CaptureInvalidRegion(
   // screen-resolution.
   VideoFrameBuffer &current = buffers_[current_buffer_];
   current.Update(display_, root_window_);
-  // Also refresh the Differ helper used by CaptureFrame(), if needed.
-  if (!use_damage_ && !last_buffer_) {
+  // Also refresh the Differ helper used by CaptureFrame(), if needed.  The
+  // DAMAGE path uses it too, to trim over-reported damage rectangles down to
+  // the blocks whose pixels actually changed.
+  if (!last_buffer_) {
     differ_.reset(new Differ(current.size().width(), current.size().height(),
                              kBytesPerPixel, current.bytes_per_row()));
   }
@@ -379,6 +381,16 @@ CaptureData* CapturerLinux::CaptureFrame() {
     for (SkRegion::Iterator it(invalid_region); !it.done(); it.next()) {
       CaptureRect(it.rect(), capture_data);
     }
+
+    // The X server often reports damage rectangles that are much larger than
+    // the pixels that actually changed.  Compare the captured blocks against
+    // the previous frame and drop the unchanged ones, so they are not
+    // encoded.
+    DCHECK(differ_ != NULL);
+    SkRegion refined_region;
+    differ_->RefineDirtyRegion(last_buffer_, buffer.ptr(), invalid_region,
+                               &refined_region);
+    invalid_region = refined_region;
   } else {
     // Doing full-screen polling, or this is the first capture after a
     // screen-resolution change.  In either case, need a full-screen capture.
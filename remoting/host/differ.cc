@@ -4,6 +4,8 @@
 
 #include "remoting/host/differ.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "remoting/host/differ_block.h"
 
@@ -45,6 +47,68 @@ void Differ::CalcDirtyRegion(const void* prev_buffer, const void* curr_buffer,
   MergeBlocks(region);
 }
 
+void Differ::RefineDirtyRegion(const void* prev_buffer, const void* curr_buffer,
+                               const SkRegion& hint, SkRegion* region) {
+  if (!region) {
+    return;
+  }
+  region->setEmpty();
+
+  if (!prev_buffer || !curr_buffer) {
+    return;
+  }
+
+  memset(diff_info_.get(), 0, diff_info_size_);
+
+  // Compare only the blocks that the hint claims have changed.  The hint
+  // rects are disjoint, but several of them may touch the same block; a
+  // block found to be dirty by an earlier rect is not compared again.
+  for (SkRegion::Iterator it(hint); !it.done(); it.next()) {
+    MarkDirtyBlocksInRect(prev_buffer, curr_buffer, it.rect());
+  }
+
+  MergeBlocks(region);
+}
+
+void Differ::MarkDirtyBlocksInRect(const void* prev_buffer,
+                                   const void* curr_buffer,
+                                   const SkIRect& rect) {
+  // Clip to the screen and convert to inclusive block coordinates.
+  int x_min = std::max(rect.fLeft, 0) / kBlockSize;
+  int y_min = std::max(rect.fTop, 0) / kBlockSize;
+  int x_max = (std::min(rect.fRight, width_) - 1) / kBlockSize;
+  int y_max = (std::min(rect.fBottom, height_) - 1) / kBlockSize;
+  if (x_max < x_min || y_max < y_min) {
+    return;
+  }
+
+  for (int y = y_min; y <= y_max; y++) {
+    for (int x = x_min; x <= x_max; x++) {
+      DiffInfo* diff_info = &diff_info_[(y * diff_info_width_) + x];
+      if (*diff_info != 0) {
+        continue;
+      }
+
+      int byte_offset = (y * kBlockSize) * bytes_per_row_ +
+                        (x * kBlockSize) * bytes_per_pixel_;
+      const uint8* prev_block =
+          static_cast<const uint8*>(prev_buffer) + byte_offset;
+      const uint8* curr_block =
+          static_cast<const uint8*>(curr_buffer) + byte_offset;
+
+      // Blocks on the right and bottom edges may extend past the screen.
+      int block_width = std::min(width_ - (x * kBlockSize), kBlockSize);
+      int block_height = std::min(height_ - (y * kBlockSize), kBlockSize);
+      if (block_width == kBlockSize && block_height == kBlockSize) {
+        *diff_info = BlockDifference(prev_block, curr_block, bytes_per_row_);
+      } else {
+        *diff_info = DiffPartialBlock(prev_block, curr_block, bytes_per_row_,
+                                      block_width, block_height);
+      }
+    }
+  }
+}
+
 void Differ::MarkDirtyBlocks(const void* prev_buffer, const void* curr_buffer) {
   memset(diff_info_.get(), 0, diff_info_size_);
 
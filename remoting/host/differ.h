@@ -36,6 +36,14 @@ class Differ {
   void CalcDirtyRegion(const void* prev_buffer, const void* curr_buffer,
                        SkRegion* region);
 
+  // As CalcDirtyRegion(), but only examines the blocks that intersect |hint|,
+  // a region known to contain all of the changed pixels (e.g. damage
+  // rectangles reported by the window system).  Unchanged blocks inside
+  // |hint| are dropped, so the result is never larger than the
+  // block-expansion of |hint|.
+  void RefineDirtyRegion(const void* prev_buffer, const void* curr_buffer,
+                         const SkRegion& hint, SkRegion* region);
+
  private:
   // Allow tests to access our private parts.
   friend class DifferTest;
@@ -43,6 +51,11 @@ class Differ {
   // Identify all of the blocks that contain changed pixels.
   void MarkDirtyBlocks(const void* prev_buffer, const void* curr_buffer);
 
+  // Identify the blocks intersecting |rect| that contain changed pixels.
+  // Blocks already marked as changed are not compared again.
+  void MarkDirtyBlocksInRect(const void* prev_buffer, const void* curr_buffer,
+                             const SkIRect& rect);
+
   // After the dirty blocks have been identified, this routine merges adjacent
   // blocks into a region.
   // The goal is to minimize the region that covers the dirty blocks.
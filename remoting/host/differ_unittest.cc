@@ -636,4 +636,55 @@ TEST_F(DifferTest, MergeBlocks_MultiRect) {
   ASSERT_TRUE(CheckDirtyRegionContainsRect(dirty, 1, 2, 1, 1));
 }
 
+TEST_F(DifferTest, RefineDirtyRegion_TrimsUnchangedBlocks) {
+  InitDiffer(kScreenWidth, kScreenHeight);
+
+  // Change a single pixel in block (1,1), but hint that the whole screen
+  // changed.  Only the block containing the pixel should be reported.
+  WriteBlockPixel(curr_.get(), 1, 1, 10, 10, 0xff00ff);
+
+  SkRegion hint(SkIRect::MakeWH(kScreenWidth, kScreenHeight));
+  SkRegion dirty;
+  differ_->RefineDirtyRegion(prev_.get(), curr_.get(), hint, &dirty);
+
+  ASSERT_EQ(1, RegionRectCount(dirty));
+  ASSERT_TRUE(CheckDirtyRegionContainsRect(dirty, 1, 1, 1, 1));
+}
+
+TEST_F(DifferTest, RefineDirtyRegion_OnlyExaminesHintedBlocks) {
+  InitDiffer(kScreenWidth, kScreenHeight);
+
+  // Change a pixel in block (0,0) but hint only block (2,2).  The change is
+  // outside the hint, so nothing should be reported.
+  WriteBlockPixel(curr_.get(), 0, 0, 0, 0, 0xff00ff);
+
+  SkRegion hint(SkIRect::MakeXYWH(2 * kBlockSize, 2 * kBlockSize,
+                                  kBlockSize, kBlockSize));
+  SkRegion dirty;
+  differ_->RefineDirtyRegion(prev_.get(), curr_.get(), hint, &dirty);
+
+  EXPECT_TRUE(dirty.isEmpty());
+}
+
+TEST_F(DifferTest, RefineDirtyRegion_PartialBlocks) {
+  InitDiffer(kPartialScreenWidth, kPartialScreenHeight);
+
+  // Change the bottom-right pixel of the screen, with a small hint rect
+  // around it.  The partial block at the corner should be reported, clipped
+  // to the screen.
+  WritePixel(curr_.get(), kPartialScreenWidth - 1, kPartialScreenHeight - 1,
+             0xff00ff);
+
+  SkRegion hint(SkIRect::MakeXYWH(kPartialScreenWidth - 2,
+                                  kPartialScreenHeight - 2, 2, 2));
+  SkRegion dirty;
+  differ_->RefineDirtyRegion(prev_.get(), curr_.get(), hint, &dirty);
+
+  ASSERT_EQ(1, RegionRectCount(dirty));
+  SkIRect expected = SkIRect::MakeLTRB(2 * kBlockSize, 2 * kBlockSize,
+                                       kPartialScreenWidth,
+                                       kPartialScreenHeight);
+  EXPECT_EQ(expected, dirty.getBounds());
+}
+
 }  // namespace remoting
@@ -331,7 +331,7 @@ void ScreenRecorder::EncodedDataAvailableCallback(
     int encode_time_ms =
         static_cast<int>(encode_time.InMilliseconds());
     packet->set_encode_time_ms(encode_time_ms);
-    scheduler_.RecordEncodeTime(encode_time);
+    scheduler_.RecordEncodeTime(encode_time, encoder()->GetFrameParallelism());
   }
 
   network_loop_->PostTask(
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string.h>
+
 #include <algorithm>
 
 #include "skia/ext/convolver.h"
@@ -768,6 +770,14 @@ void BGRAConvolve2D(const unsigned char* source_data,
   filter_y.FilterForValue(num_output_rows - 1, &last_filter_offset,
                           &last_filter_length);
 
+  // The SSE2 kernels load source pixels four at a time, so convolving the
+  // very last row of the image in place could read a few bytes past the end
+  // of it. The part of that row the filter references is copied into this
+  // buffer with enough zeroed padding for the overread, which keeps every
+  // row, including the last one, on the SIMD path. Filled lazily when the
+  // last row is first needed.
+  std::vector<unsigned char> padded_last_row;
+
   for (int out_y = 0; out_y < num_output_rows; out_y++) {
     filter_values = filter_y.FilterForValue(out_y,
                                             &filter_offset, &filter_length);
@@ -785,18 +795,26 @@ void BGRAConvolve2D(const unsigned char* source_data,
           ConvolveHorizontally4_SSE2(src, filter_x, out_row);
           next_x_row += 4;
         } else {
-          // For the last row, SSE2 load possibly to access data beyond the
-          // image area. therefore we use C version here. 
+          // For the last row, the SSE2 loads could access data beyond the
+          // image area, so it is convolved from a padded copy instead.
           if (next_x_row == last_filter_offset + last_filter_length - 1) {
-            if (source_has_alpha) {
-              ConvolveHorizontally<true>(
-                  &source_data[next_x_row * source_byte_row_stride],
-                  filter_x, row_buffer.AdvanceRow());
-            } else {
-              ConvolveHorizontally<false>(
-                  &source_data[next_x_row * source_byte_row_stride],
-                  filter_x, row_buffer.AdvanceRow());
+            if (padded_last_row.empty()) {
+              // Compute how far into the row the horizontal filter reaches.
+              int needed_pixels = 0;
+              for (int i = 0; i < filter_x.num_values(); ++i) {
+                int x_offset, x_length;
+                filter_x.FilterForValue(i, &x_offset, &x_length);
+                needed_pixels = std::max(needed_pixels, x_offset + x_length);
+              }
+              // Three extra pixels cover the largest possible 16-byte load
+              // starting at the last referenced pixel.
+              padded_last_row.resize((needed_pixels + 3) * 4, 0);
+              memcpy(&padded_last_row[0],
+                     &source_data[next_x_row * source_byte_row_stride],
+                     needed_pixels * 4);
             }
+            ConvolveHorizontally_SSE2(&padded_last_row[0], filter_x,
+                                      row_buffer.AdvanceRow());
           } else {
             ConvolveHorizontally_SSE2(
                 &source_data[next_x_row * source_byte_row_stride],
@@ -318,4 +318,63 @@ TEST(Convolver, SIMDVerification) {
 #endif
 }
 
+// Tests that the SIMD path matches the C path when the horizontal filter
+// references pixels up to the very edge of the source image, which is the
+// configuration that requires padded handling of the last source row.
+TEST(Convolver, SIMDEdgeOfImage) {
+#if defined(SIMD_SSE2)
+  base::CPU cpu;
+  if (!cpu.has_sse2()) return;
+
+  static const int kSize = 19;
+  float filter[] = { 0.25f, 0.25f, 0.25f, 0.25f };
+
+  // Every output pixel's filter ends on the last source pixel of its row,
+  // and the last output row's filter ends on the last source row.
+  ConvolutionFilter1D x_filter, y_filter;
+  for (int i = 0; i < kSize; ++i) {
+    x_filter.AddFilter(kSize - arraysize(filter), filter, arraysize(filter));
+    y_filter.AddFilter(kSize - arraysize(filter), filter, arraysize(filter));
+  }
+
+  SkBitmap source, result_c, result_sse;
+  source.setConfig(SkBitmap::kARGB_8888_Config, kSize, kSize);
+  source.allocPixels();
+  result_c.setConfig(SkBitmap::kARGB_8888_Config, kSize, kSize);
+  result_c.allocPixels();
+  result_sse.setConfig(SkBitmap::kARGB_8888_Config, kSize, kSize);
+  result_sse.allocPixels();
+
+  srand(static_cast<unsigned int>(time(0)));
+  unsigned char* src_ptr = static_cast<unsigned char*>(source.getPixels());
+  for (int y = 0; y < source.height(); y++) {
+    for (int x = 0; x < source.rowBytes(); x++)
+      src_ptr[x] = rand() % 255;
+    src_ptr += source.rowBytes();
+  }
+
+  for (int alpha = 0; alpha < 2; alpha++) {
+    unsigned char* r1 = static_cast<unsigned char*>(result_c.getPixels());
+    unsigned char* r2 = static_cast<unsigned char*>(result_sse.getPixels());
+
+    BGRAConvolve2D(static_cast<const uint8*>(source.getPixels()),
+                   static_cast<int>(source.rowBytes()),
+                   alpha ? true : false, x_filter, y_filter,
+                   static_cast<int>(result_c.rowBytes()), r1, false);
+    BGRAConvolve2D(static_cast<const uint8*>(source.getPixels()),
+                   static_cast<int>(source.rowBytes()),
+                   alpha ? true : false, x_filter, y_filter,
+                   static_cast<int>(result_sse.rowBytes()), r2, true);
+
+    for (int i = 0; i < kSize; i++) {
+      for (int x = 0; x < kSize * 4; x++) {
+        EXPECT_EQ(r1[x], r2[x]);
+      }
+      r1 += result_c.rowBytes();
+      r2 += result_sse.rowBytes();
+    }
+  }
+#endif
+}
+
 }  // namespace skia
@@ -10,10 +10,17 @@
 #include "skia/ext/image_operations.h"
 
 // TODO(pkasting): skia/ext should not depend on base/!
+#include "base/bind.h"
 #include "base/debug/trace_event.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/metrics/histogram.h"
 #include "base/stack_container.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/sys_info.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "base/time.h"
 #include "build/build_config.h"
 #include "skia/ext/convolver.h"
@@ -314,6 +321,83 @@ void ResizeFilter::ComputeFilters(int src_size,
   output->PaddingForSIMD(8);
 }
 
+// Parallel convolution --------------------------------------------------------
+
+// Minimum number of destination pixels before a resize is split across
+// worker threads. Below this the convolution finishes faster on the calling
+// thread than the cost of dispatching tasks and waiting for them.
+const int kParallelResizeMinPixels = 128 * 1024;
+
+// Minimum number of output rows per band. Bands share no state, so the
+// horizontal convolutions their vertical filters have in common near the
+// seams are recomputed; very thin bands would waste most of their time
+// redoing that overlapping work.
+const int kParallelResizeMinRowsPerBand = 64;
+
+// Upper bound on the worker threads used for resizing, however many cores
+// the machine has.
+const size_t kMaxResizeWorkerThreads = 8;
+
+struct ResizeWorkerPoolHolder {
+  ResizeWorkerPoolHolder()
+      : pool(new base::SequencedWorkerPool(kMaxResizeWorkerThreads,
+                                           "ImageResize")) {}
+  scoped_refptr<base::SequencedWorkerPool> pool;
+};
+
+// Worker pool shared by all parallel resizes. Created lazily so processes
+// that never resize large images pay nothing, and intentionally leaked
+// since there is no safe shutdown point for a process-wide pool here.
+base::LazyInstance<ResizeWorkerPoolHolder>::Leaky g_resize_worker_pool =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Everything one band of a parallel resize needs. The pointers refer to
+// state owned by ResizeBasic, which blocks until every band has signaled
+// |done|.
+struct ResizeBand {
+  const unsigned char* source_data;
+  int source_byte_row_stride;
+  bool source_has_alpha;
+  const ConvolutionFilter1D* x_filter;
+  const ConvolutionFilter1D* y_filter;
+  int band_begin;  // First output row of the band.
+  int band_end;    // One past the last output row of the band.
+  int output_byte_row_stride;
+  unsigned char* output;
+  bool use_sse2;
+  base::WaitableEvent* done;  // NULL for the band run on the calling thread.
+};
+
+// Convolves output rows [band_begin, band_end) of a resize. Each band
+// rebuilds the subset of the vertical filter covering its rows, making the
+// bands fully independent of each other.
+void ConvolveBand(ResizeBand* band) {
+  ConvolutionFilter1D band_filter;
+  for (int out_y = band->band_begin; out_y < band->band_end; out_y++) {
+    int filter_offset, filter_length;
+    const ConvolutionFilter1D::Fixed* filter_values =
+        band->y_filter->FilterForValue(out_y, &filter_offset, &filter_length);
+    if (filter_length == 0) {
+      // An all-zero filter was trimmed down to nothing; re-add it as a
+      // single zero coefficient to keep the band filter aligned with its
+      // output rows.
+      ConvolutionFilter1D::Fixed zero = 0;
+      band_filter.AddFilter(filter_offset, &zero, 1);
+    } else {
+      band_filter.AddFilter(filter_offset, filter_values, filter_length);
+    }
+  }
+  band_filter.PaddingForSIMD(8);
+
+  BGRAConvolve2D(band->source_data, band->source_byte_row_stride,
+                 band->source_has_alpha, *band->x_filter, band_filter,
+                 band->output_byte_row_stride,
+                 &band->output[band->band_begin * band->output_byte_row_stride],
+                 band->use_sse2);
+  if (band->done)
+    band->done->Signal();
+}
+
 ImageOperations::ResizeMethod ResizeMethodToAlgorithmMethod(
     ImageOperations::ResizeMethod method) {
   // Convert any "Quality Method" into an "Algorithm Method"
@@ -522,11 +606,51 @@ SkBitmap ImageOperations::ResizeBasic(const SkBitmap& source,
   if (!result.readyToDraw())
     return SkBitmap();
 
-  BGRAConvolve2D(source_subset, static_cast<int>(source.rowBytes()),
-                 !source.isOpaque(), filter.x_filter(), filter.y_filter(),
-                 static_cast<int>(result.rowBytes()),
-                 static_cast<unsigned char*>(result.getPixels()),
-                 cpu.has_sse2());
+  // Large convolutions are split into horizontal bands of output rows that
+  // run on worker threads; the output rows are independent of each other.
+  // Small images stay on the calling thread, where dispatch overhead would
+  // dominate.
+  int out_height = dest_subset.height();
+  int num_bands = 1;
+  if (dest_subset.width() * out_height >= kParallelResizeMinPixels) {
+    num_bands = std::min(
+        std::min(base::SysInfo::NumberOfProcessors(),
+                 out_height / kParallelResizeMinRowsPerBand),
+        static_cast<int>(kMaxResizeWorkerThreads));
+    num_bands = std::max(num_bands, 1);
+  }
+
+  scoped_array<ResizeBand> bands(new ResizeBand[num_bands]);
+  for (int i = 0; i < num_bands; ++i) {
+    bands[i].source_data = source_subset;
+    bands[i].source_byte_row_stride = static_cast<int>(source.rowBytes());
+    bands[i].source_has_alpha = !source.isOpaque();
+    bands[i].x_filter = &filter.x_filter();
+    bands[i].y_filter = &filter.y_filter();
+    bands[i].band_begin = out_height * i / num_bands;
+    bands[i].band_end = out_height * (i + 1) / num_bands;
+    bands[i].output_byte_row_stride = static_cast<int>(result.rowBytes());
+    bands[i].output = static_cast<unsigned char*>(result.getPixels());
+    bands[i].use_sse2 = cpu.has_sse2();
+    bands[i].done = NULL;
+  }
+
+  ScopedVector<base::WaitableEvent> events;
+  for (int i = 1; i < num_bands; ++i) {
+    base::WaitableEvent* done = new base::WaitableEvent(true, false);
+    events.push_back(done);
+    bands[i].done = done;
+    if (!g_resize_worker_pool.Get().pool->PostWorkerTask(
+            FROM_HERE, base::Bind(&ConvolveBand, &bands[i]))) {
+      // The pool is shutting down; convolve the band here instead.
+      ConvolveBand(&bands[i]);
+    }
+  }
+
+  // This thread takes the first band, then waits for the others.
+  ConvolveBand(&bands[0]);
+  for (size_t i = 0; i < events.size(); ++i)
+    events[i]->Wait();
 
   // Preserve the "opaque" flag for use as an optimization later.
   result.setIsOpaque(source.isOpaque());
@@ -561,6 +561,35 @@ TEST(ImageOperations, ResizeShouldAverageColors) {
 }
 
 
+// Check that a resize large enough to be split across worker threads
+// produces the same uniform color everywhere. Band boundaries would show up
+// as rows that differ from the input color.
+TEST(ImageOperations, LargeResizeKeepsUniformColor) {
+  const int src_w = 1024, src_h = 768;
+  // Large enough that the parallel banded path is taken on multicore
+  // machines.
+  const int dest_w = 640, dest_h = 480;
+  const SkColor uniform_color = SkColorSetARGB(255, 10, 120, 240);
+
+  SkBitmap src;
+  src.setConfig(SkBitmap::kARGB_8888_Config, src_w, src_h);
+  src.allocPixels();
+  src.eraseColor(uniform_color);
+
+  SkBitmap resized = skia::ImageOperations::Resize(
+      src, skia::ImageOperations::RESIZE_LANCZOS3, dest_w, dest_h);
+  ASSERT_EQ(dest_w, resized.width());
+  ASSERT_EQ(dest_h, resized.height());
+
+  SkAutoLockPixels lock(resized);
+  for (int y = 0; y < dest_h; ++y) {
+    for (int x = 0; x < dest_w; ++x) {
+      EXPECT_TRUE(ColorsClose(uniform_color, *resized.getAddr32(x, y)))
+          << "x=" << x << " y=" << y;
+    }
+  }
+}
+
 // Check that Lanczos2 and Lanczos3 thumbnails produce similar results
 TEST(ImageOperations, CompareLanczosMethods) {
   const int src_w = 640, src_h = 480, src_grid_pitch = 8, src_grid_width = 4;
@@ -87,6 +87,7 @@ Connection::Connection()
       page_size_(0),
       cache_size_(0),
       exclusive_locking_(false),
+      journal_mode_wal_(false),
       transaction_nesting_(0),
       needs_rollback_(false) {
 }
@@ -247,6 +248,19 @@ bool Connection::RazeWithTimout(base::TimeDelta timeout) {
   return Raze();
 }
 
+bool Connection::Checkpoint() {
+  if (!db_) {
+    DLOG(FATAL) << "Cannot checkpoint null db";
+    return false;
+  }
+
+  // SQLITE_CHECKPOINT_PASSIVE copies as many log frames into the
+  // database as it can without waiting on readers or writers, which
+  // makes this safe to call from the database's thread at any time.
+  return sqlite3_wal_checkpoint_v2(db_, NULL, SQLITE_CHECKPOINT_PASSIVE,
+                                   NULL, NULL) == SQLITE_OK;
+}
+
 bool Connection::BeginTransaction() {
   if (needs_rollback_) {
     DCHECK_GT(transaction_nesting_, 0);
@@ -496,12 +510,22 @@ bool Connection::OpenInternal(const std::string& file_name) {
   // DELETE (default) - delete -journal file to commit.
   // TRUNCATE - truncate -journal file to commit.
   // PERSIST - zero out header of -journal file to commit.
+  // WAL - append commits to a -wal file, readers don't block behind
+  // the writer, the log is merged back by checkpoints.
   // journal_size_limit provides size to trim to in PERSIST.
   // TODO(shess): Figure out if PERSIST and journal_size_limit really
   // matter.  In theory, it keeps pages pre-allocated, so if
   // transactions usually fit, it should be faster.
-  ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
-  ignore_result(Execute("PRAGMA journal_size_limit = 16384"));
+  if (journal_mode_wal_) {
+    // Unlike the PERSIST setting below, failing to enter WAL mode
+    // leaves the caller with very different concurrency behavior than
+    // it asked for, so complain loudly.
+    if (!Execute("PRAGMA journal_mode = WAL"))
+      DLOG(FATAL) << "Could not set WAL mode: " << GetErrorMessage();
+  } else {
+    ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
+    ignore_result(Execute("PRAGMA journal_size_limit = 16384"));
+  }
 
   const base::TimeDelta kBusyTimeout =
     base::TimeDelta::FromSeconds(kBusyTimeoutSeconds);
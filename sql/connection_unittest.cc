@@ -261,3 +261,33 @@ TEST_F(SQLConnectionTest, RazeLocked) {
 // TODO(shess): Spin up a background thread to hold other_db, to more
 // closely match real life.  That would also allow testing
 // RazeWithTimeout().
+
+TEST_F(SQLConnectionTest, WALMode) {
+  // The fixture's connection is in the default journal mode; re-open
+  // the database with WAL requested.
+  db().Close();
+
+  sql::Connection wal_db;
+  wal_db.set_journal_mode_wal();
+  ASSERT_TRUE(wal_db.Open(db_path()));
+
+  {
+    sql::Statement s(wal_db.GetUniqueStatement("PRAGMA journal_mode"));
+    ASSERT_TRUE(s.Step());
+    EXPECT_EQ("wal", s.ColumnString(0));
+  }
+
+  ASSERT_TRUE(wal_db.Execute("CREATE TABLE foo (a, b)"));
+  ASSERT_TRUE(wal_db.Execute("INSERT INTO foo (a, b) VALUES (12, 13)"));
+  EXPECT_TRUE(wal_db.Checkpoint());
+
+  // The checkpointed data must be visible to a fresh connection which
+  // takes the database back to a rollback journal.
+  wal_db.Close();
+  sql::Connection other_db;
+  ASSERT_TRUE(other_db.Open(db_path()));
+  sql::Statement s(other_db.GetUniqueStatement(
+      "SELECT b FROM foo WHERE a = 12"));
+  ASSERT_TRUE(s.Step());
+  EXPECT_EQ(13, s.ColumnInt(0));
+}
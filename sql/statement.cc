@@ -16,15 +16,21 @@ namespace sql {
 // only have to check the ref's validity bit.
 Statement::Statement()
     : ref_(new Connection::StatementRef),
-      succeeded_(false) {
+      succeeded_(false),
+      batch_open_(false),
+      batch_failed_(false) {
 }
 
 Statement::Statement(scoped_refptr<Connection::StatementRef> ref)
     : ref_(ref),
-      succeeded_(false) {
+      succeeded_(false),
+      batch_open_(false),
+      batch_failed_(false) {
 }
 
 Statement::~Statement() {
+  AbandonBatchIfOpen();
+
   // Free the resources associated with this statement. We assume there's only
   // one statement active for a given sqlite3_stmt at any time, so this won't
   // mess with anything.
@@ -32,6 +38,7 @@ Statement::~Statement() {
 }
 
 void Statement::Assign(scoped_refptr<Connection::StatementRef> ref) {
+  AbandonBatchIfOpen();
   Reset(true);
   ref_ = ref;
 }
@@ -61,6 +68,53 @@ bool Statement::Step() {
   return CheckError(sqlite3_step(ref_->stmt())) == SQLITE_ROW;
 }
 
+bool Statement::AddToBatch() {
+  if (!CheckValid())
+    return false;
+
+  if (!batch_open_) {
+    if (!ref_->connection()->BeginTransaction())
+      return false;
+    batch_open_ = true;
+    batch_failed_ = false;
+  }
+
+  if (!Run()) {
+    batch_failed_ = true;
+    return false;
+  }
+
+  Reset(true);
+  return true;
+}
+
+bool Statement::CommitBatch() {
+  if (!batch_open_)
+    return true;
+  batch_open_ = false;
+
+  // If the connection was closed out from under us it has already rolled
+  // everything back; there is no transaction left to resolve.
+  if (!is_valid())
+    return false;
+
+  Connection* connection = ref_->connection();
+  if (batch_failed_) {
+    connection->RollbackTransaction();
+    return false;
+  }
+  return connection->CommitTransaction();
+}
+
+void Statement::AbandonBatchIfOpen() {
+  if (!batch_open_)
+    return;
+
+  DLOG(FATAL) << "Statement released with an open batch; rolling back.";
+  batch_failed_ = true;
+  CommitBatch();
+}
+
 void Statement::Reset(bool clear_bound_vars) {
   if (is_valid()) {
     // We don't call CheckError() here because sqlite3_reset() returns
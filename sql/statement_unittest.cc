@@ -124,6 +124,59 @@ TEST_F(SQLStatementTest, BasicErrorCallback) {
   reset_error();
 }
 
+TEST_F(SQLStatementTest, Batch) {
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+
+  {
+    sql::Statement s(db().GetCachedStatement(
+        SQL_FROM_HERE, "INSERT INTO foo (a, b) VALUES (?, ?)"));
+    for (int i = 0; i < 10; ++i) {
+      s.BindInt(0, i);
+      s.BindInt(1, i * 2);
+      ASSERT_TRUE(s.AddToBatch());
+    }
+    ASSERT_TRUE(s.CommitBatch());
+    // The transaction stack must be balanced again.
+    EXPECT_EQ(0, db().transaction_nesting());
+  }
+
+  sql::Statement count(db().GetUniqueStatement("SELECT COUNT(*) FROM foo"));
+  ASSERT_TRUE(count.Step());
+  EXPECT_EQ(10, count.ColumnInt(0));
+
+  // An empty batch is legal and commits trivially.
+  sql::Statement s(db().GetUniqueStatement(
+      "INSERT INTO foo (a, b) VALUES (?, ?)"));
+  EXPECT_TRUE(s.CommitBatch());
+  EXPECT_EQ(0, db().transaction_nesting());
+}
+
+TEST_F(SQLStatementTest, BatchRollbackOnError) {
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a INTEGER PRIMARY KEY, b)"));
+
+  sql::Statement s(db().GetUniqueStatement(
+      "INSERT INTO foo (a, b) VALUES (?, ?)"));
+  s.BindInt(0, 1);
+  s.BindInt(1, 2);
+  ASSERT_TRUE(s.AddToBatch());
+
+  // A non-numeric primary key fails with SQLITE_MISMATCH, which must
+  // poison the batch.
+  s.BindCString(0, "bad bad");
+  s.BindInt(1, 3);
+  EXPECT_FALSE(s.AddToBatch());
+  EXPECT_EQ(SQLITE_MISMATCH, sqlite_error());
+  reset_error();
+
+  // The commit fails and the first row is rolled back with it.
+  EXPECT_FALSE(s.CommitBatch());
+  EXPECT_EQ(0, db().transaction_nesting());
+
+  sql::Statement count(db().GetUniqueStatement("SELECT COUNT(*) FROM foo"));
+  ASSERT_TRUE(count.Step());
+  EXPECT_EQ(0, count.ColumnInt(0));
+}
+
 TEST_F(SQLStatementTest, Reset) {
   ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
   ASSERT_TRUE(db().Execute("INSERT INTO foo (a, b) VALUES (3, 12)"));
@@ -4,15 +4,99 @@
 
 #include "sync/engine/apply_updates_command.h"
 
+#include <map>
+#include <vector>
+
 #include "base/location.h"
 #include "sync/engine/update_applicator.h"
 #include "sync/sessions/sync_session.h"
 #include "sync/syncable/syncable.h"
+#include "sync/syncable/syncable_id.h"
 
 namespace browser_sync {
 
 using sessions::SyncSession;
 
+namespace {
+
+// Orders the unapplied-update handles so that parents precede their
+// children, with server-deleted items moved to the back in the opposite
+// (children-first) order. The UpdateApplicator handles dependencies by
+// retrying failed items with additional passes over the whole batch, so a
+// large initial sync delivered children-first costs one pass per level of
+// the hierarchy; with the handles in dependency order it applies in a
+// single pass.
+void OrderUpdatesByDependency(syncable::BaseTransaction* trans,
+                              std::vector<int64>* handles) {
+  size_t count = handles->size();
+  if (count < 2)
+    return;
+
+  std::vector<syncable::Id> ids(count);
+  std::vector<syncable::Id> parents(count);
+  std::vector<bool> is_del(count);
+  std::map<syncable::Id, size_t> index_of;
+
+  for (size_t i = 0; i < count; ++i) {
+    syncable::Entry entry(trans, syncable::GET_BY_HANDLE, (*handles)[i]);
+    if (!entry.good())
+      return;  // Leave the original order; the applicator copes.
+    ids[i] = entry.Get(syncable::ID);
+    parents[i] = entry.Get(syncable::SERVER_PARENT_ID);
+    is_del[i] = entry.Get(syncable::SERVER_IS_DEL);
+    index_of[ids[i]] = i;
+  }
+
+  // Items whose server parent is outside the batch have no dependencies
+  // here and seed the traversal.
+  std::map<syncable::Id, std::vector<size_t> > children;
+  std::vector<size_t> order;
+  order.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    if (index_of.count(parents[i]) > 0 && !(parents[i] == ids[i]))
+      children[parents[i]].push_back(i);
+    else
+      order.push_back(i);
+  }
+
+  // Breadth-first from those roots yields a parent-before-child order.
+  std::vector<bool> visited(count, false);
+  for (size_t i = 0; i < order.size(); ++i)
+    visited[order[i]] = true;
+  for (size_t head = 0; head < order.size(); ++head) {
+    const std::vector<size_t>& kids = children[ids[order[head]]];
+    for (size_t k = 0; k < kids.size(); ++k) {
+      if (!visited[kids[k]]) {
+        visited[kids[k]] = true;
+        order.push_back(kids[k]);
+      }
+    }
+  }
+
+  // Anything not reached is part of a parent cycle; append it in the
+  // original order and let the applicator's retry passes deal with it.
+  for (size_t i = 0; i < count; ++i) {
+    if (!visited[i])
+      order.push_back(i);
+  }
+
+  // Deletions have the opposite dependency: children before parents.
+  std::vector<int64> ordered;
+  ordered.reserve(count);
+  for (size_t i = 0; i < order.size(); ++i) {
+    if (!is_del[order[i]])
+      ordered.push_back((*handles)[order[i]]);
+  }
+  for (size_t i = order.size(); i > 0; --i) {
+    if (is_del[order[i - 1]])
+      ordered.push_back((*handles)[order[i - 1]]);
+  }
+
+  handles->swap(ordered);
+}
+
+}  // namespace
+
 ApplyUpdatesCommand::ApplyUpdatesCommand() {}
 ApplyUpdatesCommand::~ApplyUpdatesCommand() {}
 
@@ -58,6 +142,7 @@ SyncerError ApplyUpdatesCommand::ModelChangingExecuteImpl(
   std::vector<int64> handles;
   dir->GetUnappliedUpdateMetaHandles(
       &trans, server_type_restriction, &handles);
+  OrderUpdatesByDependency(&trans, &handles);
 
   UpdateApplicator applicator(
       session->context()->resolver(),
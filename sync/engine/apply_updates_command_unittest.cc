@@ -280,6 +280,33 @@ TEST_F(ApplyUpdatesCommandTest, UpdateWithChildrenBeforeParents) {
       << "All updates should have been successfully applied";
 }
 
+// A deep chain of folders delivered deepest-first. The command orders the
+// batch parent-first before applying, so this should succeed completely
+// (and in a single applicator pass, though that isn't observable here).
+TEST_F(ApplyUpdatesCommandTest, UpdateWithDeepChainReversed) {
+  const int kChainLength = 10;
+  string root_server_id = syncable::GetNullId().GetServerId();
+  for (int i = kChainLength - 1; i >= 0; --i) {
+    string parent = (i == 0) ? root_server_id
+                             : base::StringPrintf("folder_%d", i - 1);
+    CreateUnappliedNewItemWithParent(base::StringPrintf("folder_%d", i),
+                                     DefaultBookmarkSpecifics(),
+                                     parent);
+  }
+
+  ExpectGroupToChange(apply_updates_command_, GROUP_UI);
+  apply_updates_command_.ExecuteImpl(session());
+
+  sessions::StatusController* status = session()->mutable_status_controller();
+  sessions::ScopedModelSafeGroupRestriction r(status, GROUP_UI);
+  ASSERT_TRUE(status->update_progress());
+  EXPECT_EQ(kChainLength, status->update_progress()->AppliedUpdatesSize());
+  ASSERT_TRUE(status->conflict_progress());
+  EXPECT_EQ(0, status->conflict_progress()->SimpleConflictingItemsSize());
+  EXPECT_EQ(kChainLength,
+            status->update_progress()->SuccessfullyAppliedUpdateCount());
+}
+
 // Runs the ApplyUpdatesCommand on an item that has both local and remote
 // modifications (IS_UNSYNCED and IS_UNAPPLIED_UPDATE).  We expect the command
 // to detect that this update can't be applied because it is in a CONFLICT
@@ -229,11 +229,25 @@ void Syncer::SyncShare(sessions::SyncSession* session,
         break;
       }
       case PROCESS_COMMIT_RESPONSE: {
+        StatusController* status = session->mutable_status_controller();
         ProcessCommitResponseCommand process_response_command;
-        session->mutable_status_controller()->
-            set_last_process_commit_response_result(
-                process_response_command.Execute(session));
-        next_step = RESOLVE_CONFLICTS;
+        const SyncerError result = process_response_command.Execute(session);
+        status->set_last_process_commit_response_result(result);
+
+        // If we filled the batch and every item in it committed cleanly,
+        // there are probably more unsynced items waiting (e.g. a large
+        // bookmark import).  Drain them within this cycle instead of
+        // paying a full sync cycle -- including its GetUpdates round trip
+        // -- per batch.
+        const size_t batch_size = static_cast<size_t>(
+            session->context()->max_commit_batch_size());
+        if (result == SYNCER_OK &&
+            status->commit_ids().size() == batch_size &&
+            status->TotalNumServerConflictingItems() == 0) {
+          next_step = BUILD_COMMIT_REQUEST;
+        } else {
+          next_step = RESOLVE_CONFLICTS;
+        }
         break;
       }
       case RESOLVE_CONFLICTS: {
@@ -2713,6 +2713,27 @@ TEST_F(SyncerTest, CommitManyItemsInOneGo) {
   EXPECT_GE(mock_server_->commit_messages().size(), max_batches);
 }
 
+// A single sync cycle should keep posting batches until the unsynced
+// items are drained, rather than committing one batch per cycle.
+TEST_F(SyncerTest, CommitManyItemsInOneCycle) {
+  uint32 num_batches = 3;
+  uint32 items_to_commit = kDefaultMaxCommitBatchSize * num_batches;
+  {
+    WriteTransaction trans(FROM_HERE, UNITTEST, directory());
+    for (uint32 i = 0; i < items_to_commit; i++) {
+      string nameutf8 = base::StringPrintf("%d", i);
+      string name(nameutf8.begin(), nameutf8.end());
+      MutableEntry e(&trans, CREATE, trans.root_id(), name);
+      e.Put(IS_UNSYNCED, true);
+      e.Put(IS_DIR, true);
+      e.Put(SPECIFICS, DefaultBookmarkSpecifics());
+    }
+  }
+  SyncShareNudge();
+  EXPECT_EQ(num_batches, mock_server_->commit_messages().size());
+  EXPECT_EQ(items_to_commit, mock_server_->committed_ids().size());
+}
+
 TEST_F(SyncerTest, HugeConflict) {
   int item_count = 300;  // We should be able to do 300 or 3000 w/o issue.
 
@@ -2149,6 +2149,35 @@ TEST_F(DirectoryBackingStoreTest, DeleteEntries) {
   EXPECT_EQ(0U, index.size());
 }
 
+// Saves through the on-disk store (which runs in WAL journal mode) and
+// reloads with a fresh store to make sure committed changes survive.
+TEST_F(DirectoryBackingStoreTest, OnDiskSaveAndReload) {
+  const std::string kBirthday = "saved-birthday";
+  {
+    scoped_ptr<OnDiskDirectoryBackingStore> dbs(
+        new OnDiskDirectoryBackingStore(GetUsername(), GetDatabasePath()));
+    MetahandlesIndex index;
+    STLElementDeleter<MetahandlesIndex> index_deleter(&index);
+    Directory::KernelLoadInfo load_info;
+    ASSERT_EQ(OPENED, dbs->Load(&index, &load_info));
+
+    Directory::SaveChangesSnapshot snapshot;
+    snapshot.kernel_info_status = Directory::KERNEL_SHARE_INFO_DIRTY;
+    snapshot.kernel_info = load_info.kernel_info;
+    snapshot.kernel_info.store_birthday = kBirthday;
+    ASSERT_TRUE(dbs->SaveChanges(snapshot));
+  }
+  {
+    scoped_ptr<OnDiskDirectoryBackingStore> dbs(
+        new OnDiskDirectoryBackingStore(GetUsername(), GetDatabasePath()));
+    MetahandlesIndex index;
+    STLElementDeleter<MetahandlesIndex> index_deleter(&index);
+    Directory::KernelLoadInfo load_info;
+    ASSERT_EQ(OPENED, dbs->Load(&index, &load_info));
+    EXPECT_EQ(kBirthday, load_info.kernel_info.store_birthday);
+  }
+}
+
 TEST_F(DirectoryBackingStoreTest, GenerateCacheGUID) {
   const std::string& guid1 = TestDirectoryBackingStore::GenerateCacheGUID();
   const std::string& guid2 = TestDirectoryBackingStore::GenerateCacheGUID();
@@ -12,7 +12,14 @@ OnDiskDirectoryBackingStore::OnDiskDirectoryBackingStore(
     const std::string& dir_name, const FilePath& backing_filepath)
     : DirectoryBackingStore(dir_name),
       backing_filepath_(backing_filepath) {
-  db_->set_exclusive_locking();
+  // Write-ahead logging makes each periodic SaveChanges commit an append
+  // to the -wal file instead of a journalled rewrite of the touched
+  // pages, so saving a large batch of dirty entries no longer stalls the
+  // sync thread behind the rollback journal.  SQLite folds the log back
+  // into the database with automatic checkpoints.  WAL cannot be entered
+  // in exclusive locking mode; this connection is the database's only
+  // user, so exclusive locking was not buying anything.
+  db_->set_journal_mode_wal();
   db_->set_page_size(4096);
 }
 
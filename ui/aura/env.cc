@@ -3,11 +3,14 @@
 // found in the LICENSE file.
 
 #include "ui/aura/env.h"
+
+#include "base/command_line.h"
 #include "ui/aura/env_observer.h"
 #include "ui/aura/monitor_manager.h"
 #include "ui/aura/root_window_host.h"
 #include "ui/aura/window.h"
 #include "ui/gfx/compositor/compositor.h"
+#include "ui/gfx/compositor/compositor_switches.h"
 
 #if defined(USE_X11)
 #include "ui/aura/monitor_change_observer_x11.h"
@@ -77,7 +80,8 @@ void Env::Init() {
 #if defined(USE_X11)
   monitor_change_observer_.reset(new internal::MonitorChangeObserverX11);
 #endif
-  ui::Compositor::Initialize(false);
+  ui::Compositor::Initialize(CommandLine::ForCurrentProcess()->HasSwitch(
+      switches::kUIEnableThreadedCompositing));
 }
 
 void Env::NotifyWindowInitialized(Window* window) {
@@ -25,24 +25,18 @@ static const size_t kHeaderLength = 2 * sizeof(uint32) + sizeof(uint8);
 struct DataPackEntry {
   uint16 resource_id;
   uint32 file_offset;
-
-  static int CompareById(const void* void_key, const void* void_entry) {
-    uint16 key = *reinterpret_cast<const uint16*>(void_key);
-    const DataPackEntry* entry =
-        reinterpret_cast<const DataPackEntry*>(void_entry);
-    if (key < entry->resource_id) {
-      return -1;
-    } else if (key > entry->resource_id) {
-      return 1;
-    } else {
-      return 0;
-    }
-  }
 };
 #pragma pack(pop)
 
 COMPILE_ASSERT(sizeof(DataPackEntry) == 6, size_of_entry_must_be_six);
 
+// Slot of |resource_id| in an id table of size |mask| + 1. Knuth's
+// multiplicative hash spreads the mostly-contiguous resource ids across the
+// table.
+inline uint32 IdTableSlot(uint16 resource_id, uint32 mask) {
+  return (static_cast<uint32>(resource_id) * 2654435761u) & mask;
+}
+
 // We're crashing when trying to load a pak file on Windows.  Add some error
 // codes for logging.
 // http://crbug.com/58056
@@ -142,9 +136,33 @@ bool DataPack::Load(const FilePath& path) {
     }
   }
 
+  BuildLookupTable();
+
   return true;
 }
 
+void DataPack::BuildLookupTable() {
+  id_table_.clear();
+  if (resource_count_ == 0)
+    return;
+
+  // Sized to stay at most half full so linear probes stay short.
+  size_t size = 4;
+  while (size < resource_count_ * 2)
+    size <<= 1;
+  id_table_.resize(size, 0);
+
+  const uint32 mask = size - 1;
+  const DataPackEntry* entries = reinterpret_cast<const DataPackEntry*>(
+      mmap_->data() + kHeaderLength);
+  for (size_t i = 0; i < resource_count_; ++i) {
+    uint32 slot = IdTableSlot(entries[i].resource_id, mask);
+    while (id_table_[slot] != 0)
+      slot = (slot + 1) & mask;
+    id_table_[slot] = i + 1;
+  }
+}
+
 bool DataPack::GetStringPiece(uint16 resource_id,
                               base::StringPiece* data) const {
   // It won't be hard to make this endian-agnostic, but it's not worth
@@ -158,9 +176,23 @@ bool DataPack::GetStringPiece(uint16 resource_id,
   #error DataPack assumes little endian
 #endif
 
-  const DataPackEntry* target = reinterpret_cast<const DataPackEntry*>(
-      bsearch(&resource_id, mmap_->data() + kHeaderLength, resource_count_,
-              sizeof(DataPackEntry), DataPackEntry::CompareById));
+  if (id_table_.empty())
+    return false;
+
+  // Probe the id table for the entry; the table never fills up, so an empty
+  // slot ends an unsuccessful search.
+  const DataPackEntry* entries = reinterpret_cast<const DataPackEntry*>(
+      mmap_->data() + kHeaderLength);
+  const uint32 mask = id_table_.size() - 1;
+  const DataPackEntry* target = NULL;
+  for (uint32 slot = IdTableSlot(resource_id, mask); id_table_[slot] != 0;
+       slot = (slot + 1) & mask) {
+    const DataPackEntry* entry = &entries[id_table_[slot] - 1];
+    if (entry->resource_id == resource_id) {
+      target = entry;
+      break;
+    }
+  }
   if (!target) {
     return false;
   }
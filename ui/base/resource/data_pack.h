@@ -11,6 +11,7 @@
 #pragma once
 
 #include <map>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
@@ -55,9 +56,18 @@ class UI_EXPORT DataPack : public ResourceHandle {
   virtual float GetScaleFactor() const OVERRIDE;
 
  private:
+  // Builds |id_table_| from the index of the mapped file.
+  void BuildLookupTable();
+
   // The memory-mapped data.
   scoped_ptr<file_util::MemoryMappedFile> mmap_;
 
+  // Open-addressed table mapping resource ids to entries of the mapped
+  // index, built at load time so lookups don't binary-search the index on
+  // every call. The size is a power of two; each slot holds an entry index
+  // plus one, with zero meaning empty.
+  std::vector<uint32> id_table_;
+
   // Number of resources in the data.
   size_t resource_count_;
 
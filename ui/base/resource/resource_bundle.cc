@@ -6,6 +6,7 @@
 
 #include <vector>
 
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/file_util.h"
 #include "base/logging.h"
@@ -15,6 +16,7 @@
 #include "base/stl_util.h"
 #include "base/string_piece.h"
 #include "base/synchronization/lock.h"
+#include "base/threading/worker_pool.h"
 #include "base/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "third_party/skia/include/core/SkBitmap.h"
@@ -42,6 +44,19 @@ const int kMediumFontSizeDelta = 3;
 const int kLargeFontSizeDelta = 8;
 #endif
 
+// Parses |data_pack| from |path| and signals |loaded| when done. Runs on a
+// worker thread; the bundle joins every outstanding load before its first
+// lookup, which also keeps |data_pack| and |loaded| alive until then.
+void LoadDataPackInBackground(DataPack* data_pack,
+                              const FilePath& path,
+                              base::WaitableEvent* loaded) {
+  if (!data_pack->Load(path)) {
+    LOG(ERROR) << "Failed to load " << path.value()
+               << "\nSome features may not be available.";
+  }
+  loaded->Signal();
+}
+
 }  // namespace
 
 ResourceBundle* ResourceBundle::g_shared_instance_ = NULL;
@@ -90,13 +105,23 @@ bool ResourceBundle::LocaleDataPakExists(const std::string& locale) {
 }
 
 void ResourceBundle::AddDataPack(const FilePath& path, float scale_factor) {
-  scoped_ptr<DataPack> data_pack(
-      new DataPack(ResourceHandle::kScaleFactor100x));
-  if (data_pack->Load(path)) {
-    data_packs_.push_back(data_pack.release());
+  // The pack is registered immediately so lookup precedence follows
+  // registration order, but its contents are parsed on a worker thread; a
+  // pack whose load failed simply never resolves any resource.
+  DataPack* data_pack = new DataPack(ResourceHandle::kScaleFactor100x);
+  data_packs_.push_back(data_pack);
+
+  scoped_ptr<base::WaitableEvent> loaded(
+      new base::WaitableEvent(true /* manual reset */, false));
+  if (base::WorkerPool::PostTask(
+          FROM_HERE,
+          base::Bind(&LoadDataPackInBackground, data_pack, path, loaded.get()),
+          true)) {
+    base::AutoLock lock_scope(*pending_pack_loads_lock_);
+    pending_pack_loads_.push_back(loaded.release());
   } else {
-    LOG(ERROR) << "Failed to load " << path.value()
-               << "\nSome features may not be available.";
+    // No worker pool (can happen in tests); load synchronously.
+    LoadDataPackInBackground(data_pack, path, loaded.get());
   }
 }
 
@@ -232,6 +257,8 @@ SkBitmap* ResourceBundle::GetBitmapNamed(int resource_id) {
 }
 
 gfx::Image& ResourceBundle::GetImageNamed(int resource_id) {
+  WaitForDataPackLoads();
+
   // Check to see if the image is already in the cache.
   {
     base::AutoLock lock_scope(*images_and_fonts_lock_);
@@ -276,6 +303,8 @@ gfx::Image& ResourceBundle::GetNativeImageNamed(int resource_id) {
 
 base::RefCountedStaticMemory* ResourceBundle::LoadDataResourceBytes(
     int resource_id) const {
+  WaitForDataPackLoads();
+
   for (size_t i = 0; i < data_packs_.size(); ++i) {
     base::RefCountedStaticMemory* bytes =
         data_packs_[i]->GetStaticMemory(resource_id);
@@ -287,6 +316,8 @@ base::RefCountedStaticMemory* ResourceBundle::LoadDataResourceBytes(
 }
 
 base::StringPiece ResourceBundle::GetRawDataResource(int resource_id) const {
+  WaitForDataPackLoads();
+
   DCHECK(locale_resources_data_.get());
   base::StringPiece data;
   if (locale_resources_data_->GetStringPiece(resource_id, &data))
@@ -331,14 +362,28 @@ void ResourceBundle::ReloadFonts() {
 
 ResourceBundle::ResourceBundle()
     : images_and_fonts_lock_(new base::Lock),
-      locale_resources_data_lock_(new base::Lock) {
+      locale_resources_data_lock_(new base::Lock),
+      pending_pack_loads_lock_(new base::Lock) {
 }
 
 ResourceBundle::~ResourceBundle() {
+  // Loads still running on worker threads touch |data_packs_|; join them
+  // before tearing anything down.
+  WaitForDataPackLoads();
   FreeImages();
   UnloadLocaleResources();
 }
 
+void ResourceBundle::WaitForDataPackLoads() const {
+  ScopedVector<base::WaitableEvent> pending;
+  {
+    base::AutoLock lock_scope(*pending_pack_loads_lock_);
+    pending.swap(pending_pack_loads_);
+  }
+  for (size_t i = 0; i < pending.size(); ++i)
+    pending[i]->Wait();
+}
+
 void ResourceBundle::FreeImages() {
   STLDeleteContainerPairSecondPointers(images_.begin(),
                                        images_.end());
@@ -16,6 +16,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
+#include "base/synchronization/waitable_event.h"
 #include "base/string16.h"
 #include "base/string_piece.h"
 #include "ui/base/ui_export.h"
@@ -90,6 +91,10 @@ class UI_EXPORT ResourceBundle {
   // main module. |scale_factor| is the scale of images in this resource pak
   // relative to the images in the 1x resource pak. This method is not thread
   // safe! You should call it immediately after calling InitSharedInstance.
+  //
+  // The pack file is parsed on a background thread so that registering
+  // several packs doesn't serialize their disk I/O on the caller; the first
+  // resource lookup blocks until every registered pack has finished loading.
   void AddDataPack(const FilePath& path, float scale_factor);
 
   // Changes the locale for an already-initialized ResourceBundle, returning the
@@ -190,16 +195,28 @@ class UI_EXPORT ResourceBundle {
 
   const FilePath& GetOverriddenPakPath();
 
+  // Blocks until every pack load started by AddDataPack has finished. Called
+  // before |data_packs_| is consulted.
+  void WaitForDataPackLoads() const;
+
   // Protects |images_| and font-related members.
   scoped_ptr<base::Lock> images_and_fonts_lock_;
 
   // Protects |locale_resources_data_|.
   scoped_ptr<base::Lock> locale_resources_data_lock_;
 
+  // Protects |pending_pack_loads_|.
+  scoped_ptr<base::Lock> pending_pack_loads_lock_;
+
   // Handles for data sources.
   scoped_ptr<ResourceHandle> locale_resources_data_;
   ScopedVector<ResourceHandle> data_packs_;
 
+  // Events signaled by background pack loads started by AddDataPack that
+  // haven't been joined yet. Mutable so the const lookup paths can join
+  // them.
+  mutable ScopedVector<base::WaitableEvent> pending_pack_loads_;
+
   // Cached images. The ResourceBundle caches all retrieved images and keeps
   // ownership of the pointers.
   typedef std::map<int, gfx::Image*> ImageMap;
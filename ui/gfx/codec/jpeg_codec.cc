@@ -436,6 +436,15 @@ class DecompressDestroyer {
 bool JPEGCodec::Decode(const unsigned char* input, size_t input_size,
                        ColorFormat format, std::vector<unsigned char>* output,
                        int* w, int* h) {
+  return DecodeIncrementally(input, input_size, format, output, w, h,
+                             RowAvailableCallback());
+}
+
+bool JPEGCodec::DecodeIncrementally(
+    const unsigned char* input, size_t input_size,
+    ColorFormat format, std::vector<unsigned char>* output,
+    int* w, int* h,
+    const RowAvailableCallback& row_available) {
   jpeg_decompress_struct cinfo;
   DecompressDestroyer destroyer;
   destroyer.SetManagedObject(&cinfo);
@@ -538,6 +547,8 @@ bool JPEGCodec::Decode(const unsigned char* input, size_t input_size,
     unsigned char* rowptr = &(*output)[row * row_write_stride];
     if (!jpeg_read_scanlines(&cinfo, &rowptr, 1))
       return false;
+    if (!row_available.is_null())
+      row_available.Run(row);
   }
 #else
   if (format == FORMAT_RGB) {
@@ -549,6 +560,8 @@ bool JPEGCodec::Decode(const unsigned char* input, size_t input_size,
       unsigned char* rowptr = &(*output)[row * row_write_stride];
       if (!jpeg_read_scanlines(&cinfo, &rowptr, 1))
         return false;
+      if (!row_available.is_null())
+        row_available.Run(row);
     }
   } else {
     // Rows need conversion to output format: read into a temporary buffer and
@@ -578,6 +591,8 @@ bool JPEGCodec::Decode(const unsigned char* input, size_t input_size,
       if (!jpeg_read_scanlines(&cinfo, &rowptr, 1))
         return false;
       converter(rowptr, *w, &(*output)[row * row_write_stride]);
+      if (!row_available.is_null())
+        row_available.Run(row);
     }
   }
 #endif
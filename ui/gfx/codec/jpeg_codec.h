@@ -9,6 +9,7 @@
 #include <stddef.h>
 #include <vector>
 
+#include "base/callback.h"
 #include "ui/base/ui_export.h"
 
 class SkBitmap;
@@ -52,6 +53,10 @@ class UI_EXPORT JPEGCodec {
                      int w, int h, int row_byte_width,
                      int quality, std::vector<unsigned char>* output);
 
+  // Run during an incremental decode each time a row has been written to the
+  // output buffer. The row index is the argument.
+  typedef base::Callback<void(int row)> RowAvailableCallback;
+
   // Decodes the JPEG data contained in input of length input_size. The
   // decoded data will be placed in *output with the dimensions in *w and *h
   // on success (returns true). This data will be written in the'format'
@@ -60,6 +65,18 @@ class UI_EXPORT JPEGCodec {
                      ColorFormat format, std::vector<unsigned char>* output,
                      int* w, int* h);
 
+  // Same as Decode() above, but runs |row_available| after each row lands in
+  // the output buffer, so the caller can start scaling, uploading or painting
+  // the top of a large image while the rest is still being decoded. The
+  // output buffer is fully sized before the first invocation of the callback.
+  // A null callback behaves exactly like Decode().
+  static bool DecodeIncrementally(const unsigned char* input,
+                                  size_t input_size,
+                                  ColorFormat format,
+                                  std::vector<unsigned char>* output,
+                                  int* w, int* h,
+                                  const RowAvailableCallback& row_available);
+
   // Decodes the JPEG data contained in input of length input_size. If
   // successful, a SkBitmap is created and returned. It is up to the caller
   // to delete the returned bitmap.
@@ -5,6 +5,7 @@
 #include <math.h>
 
 #include "base/basictypes.h"
+#include "base/bind.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "ui/gfx/codec/jpeg_codec.h"
 
@@ -164,6 +165,47 @@ TEST(JPEGCodec, EncodeDecodeRGBA) {
   ASSERT_GE(jpeg_equality_threshold, AveragePixelDelta(original, decoded));
 }
 
+// Appends the reported row to the list, used to watch incremental decodes.
+static void AppendRow(std::vector<int>* rows, int row) {
+  rows->push_back(row);
+}
+
+TEST(JPEGCodec, DecodeIncrementallyReportsAllRows) {
+  int w = 20, h = 20;
+
+  // create an image with known values
+  std::vector<unsigned char> original;
+  MakeRGBImage(w, h, &original);
+
+  // encode
+  std::vector<unsigned char> encoded;
+  EXPECT_TRUE(JPEGCodec::Encode(&original[0], JPEGCodec::FORMAT_RGB, w, h,
+                                w * 3, jpeg_quality, &encoded));
+
+  // decode incrementally, recording the reported rows
+  std::vector<unsigned char> decoded;
+  std::vector<int> rows;
+  int outw, outh;
+  EXPECT_TRUE(JPEGCodec::DecodeIncrementally(&encoded[0], encoded.size(),
+                                             JPEGCodec::FORMAT_RGB, &decoded,
+                                             &outw, &outh,
+                                             base::Bind(&AppendRow, &rows)));
+  ASSERT_EQ(w, outw);
+  ASSERT_EQ(h, outh);
+
+  // every row must be reported exactly once, in order
+  ASSERT_EQ(static_cast<size_t>(h), rows.size());
+  for (int i = 0; i < h; i++)
+    EXPECT_EQ(i, rows[i]);
+
+  // the result must match a plain decode
+  std::vector<unsigned char> plain_decoded;
+  EXPECT_TRUE(JPEGCodec::Decode(&encoded[0], encoded.size(),
+                                JPEGCodec::FORMAT_RGB, &plain_decoded,
+                                &outw, &outh));
+  ASSERT_TRUE(decoded == plain_decoded);
+}
+
 // Test that corrupted data decompression causes failures.
 TEST(JPEGCodec, DecodeCorrupted) {
   int w = 20, h = 20;
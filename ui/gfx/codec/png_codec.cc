@@ -120,6 +120,7 @@ class PngDecoderState {
         bitmap(NULL),
         is_opaque(true),
         output(o),
+        row_available(NULL),
         width(0),
         height(0),
         done(false) {
@@ -132,6 +133,7 @@ class PngDecoderState {
         bitmap(skbitmap),
         is_opaque(true),
         output(NULL),
+        row_available(NULL),
         width(0),
         height(0),
         done(false) {
@@ -151,6 +153,10 @@ class PngDecoderState {
   // instead of directly to an SkBitmap.
   std::vector<unsigned char>* output;
 
+  // If non-NULL, run each time a row is written into the output buffer. The
+  // callback is owned by the caller of the decode.
+  const PNGCodec::RowAvailableCallback* row_available;
+
   // Size of the image, set in the info callback.
   int width;
   int height;
@@ -336,6 +342,9 @@ void DecodeRowCallback(png_struct* png_ptr, png_byte* new_row,
 
   unsigned char* dest = &base[state->width * state->output_channels * row_num];
   png_progressive_combine_row(png_ptr, dest, new_row);
+
+  if (state->row_available)
+    state->row_available->Run(static_cast<int>(row_num));
 }
 
 void DecodeEndCallback(png_struct* png_ptr, png_info* info) {
@@ -429,6 +438,17 @@ void LogLibPNGEncodeWarning(png_structp png_ptr, png_const_charp warning_msg) {
 bool PNGCodec::Decode(const unsigned char* input, size_t input_size,
                       ColorFormat format, std::vector<unsigned char>* output,
                       int* w, int* h) {
+  return DecodeIncrementally(input, input_size, format, output, w, h,
+                             RowAvailableCallback());
+}
+
+// static
+bool PNGCodec::DecodeIncrementally(const unsigned char* input,
+                                   size_t input_size,
+                                   ColorFormat format,
+                                   std::vector<unsigned char>* output,
+                                   int* w, int* h,
+                                   const RowAvailableCallback& row_available) {
   png_struct* png_ptr = NULL;
   png_info* info_ptr = NULL;
   if (!BuildPNGStruct(input, input_size, &png_ptr, &info_ptr))
@@ -443,6 +463,8 @@ bool PNGCodec::Decode(const unsigned char* input, size_t input_size,
   }
 
   PngDecoderState state(format, output);
+  if (!row_available.is_null())
+    state.row_available = &row_available;
 
   png_set_error_fn(png_ptr, NULL, LogLibPNGDecodeError, LogLibPNGDecodeWarning);
   png_set_progressive_read_fn(png_ptr, &state, &DecodeInfoCallback,
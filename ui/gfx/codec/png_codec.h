@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/callback.h"
 #include "ui/base/ui_export.h"
 
 class SkBitmap;
@@ -110,6 +111,23 @@ class UI_EXPORT PNGCodec {
                      ColorFormat format, std::vector<unsigned char>* output,
                      int* w, int* h);
 
+  // Run during an incremental decode each time a row has been written to the
+  // output buffer. The row index is the argument. For interlaced pngs the
+  // same row may be reported several times as later passes refine it.
+  typedef base::Callback<void(int row)> RowAvailableCallback;
+
+  // Same as the vector<unsigned char> version of Decode() above, but runs
+  // |row_available| as rows land in the output buffer, so the caller can
+  // paint a large image progressively while it is still being decoded. The
+  // output buffer is fully sized before the first invocation of the
+  // callback. A null callback behaves exactly like Decode().
+  static bool DecodeIncrementally(const unsigned char* input,
+                                  size_t input_size,
+                                  ColorFormat format,
+                                  std::vector<unsigned char>* output,
+                                  int* w, int* h,
+                                  const RowAvailableCallback& row_available);
+
   // Decodes the PNG data directly into the passed in SkBitmap. This is
   // significantly faster than the vector<unsigned char> version of Decode()
   // above when dealing with PNG files that are >500K, which a lot of theme
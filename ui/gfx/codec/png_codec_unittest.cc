@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <cmath>
 
+#include "base/bind.h"
 #include "base/logging.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/skia/include/core/SkBitmap.h"
@@ -299,6 +300,46 @@ TEST(PNGCodec, EncodeDecodeRGB) {
   ASSERT_TRUE(original == decoded);
 }
 
+// Appends the reported row to the list, used to watch incremental decodes.
+static void AppendRow(std::vector<int>* rows, int row) {
+  rows->push_back(row);
+}
+
+TEST(PNGCodec, DecodeIncrementallyReportsRows) {
+  const int w = 20, h = 20;
+
+  // create an image with known values
+  std::vector<unsigned char> original;
+  MakeRGBImage(w, h, &original);
+
+  // encode
+  std::vector<unsigned char> encoded;
+  ASSERT_TRUE(PNGCodec::Encode(&original[0], PNGCodec::FORMAT_RGB,
+                               Size(w, h), w * 3, false,
+                               std::vector<PNGCodec::Comment>(),
+                               &encoded));
+
+  // decode incrementally, recording the reported rows
+  std::vector<unsigned char> decoded;
+  std::vector<int> rows;
+  int outw, outh;
+  ASSERT_TRUE(PNGCodec::DecodeIncrementally(&encoded[0], encoded.size(),
+                                            PNGCodec::FORMAT_RGB, &decoded,
+                                            &outw, &outh,
+                                            base::Bind(&AppendRow, &rows)));
+  ASSERT_EQ(w, outw);
+  ASSERT_EQ(h, outh);
+
+  // this is not an interlaced png, so every row is reported exactly once,
+  // in order
+  ASSERT_EQ(static_cast<size_t>(h), rows.size());
+  for (int i = 0; i < h; i++)
+    EXPECT_EQ(i, rows[i]);
+
+  // the result must match a plain decode
+  ASSERT_TRUE(original == decoded);
+}
+
 TEST(PNGCodec, EncodeDecodeRGBA) {
   const int w = 20, h = 20;
 
@@ -172,10 +172,10 @@ void Compositor::Terminate() {
 
 void Compositor::ScheduleDraw() {
   if (g_compositor_thread) {
-    // TODO(nduca): Temporary while compositor calls
-    // compositeImmediately() directly.
-    layout();
-    host_.composite();
+    // The threaded proxy picks up the damaged rects sent by layout() at
+    // commit time and draws on the compositor thread; frames with no
+    // damage never leave the scheduler.
+    host_.setNeedsRedraw();
   } else {
     delegate_->ScheduleDraw();
   }
@@ -198,11 +198,18 @@ void Compositor::Draw(bool force_clear) {
   if (!root_layer_)
     return;
 
+  if (g_compositor_thread) {
+    // The frame is produced asynchronously on the compositor thread;
+    // NotifyEnd() runs when the swap completes.
+    host_.setNeedsRedraw();
+    return;
+  }
+
   // TODO(nduca): Temporary while compositor calls
   // compositeImmediately() directly.
   layout();
   host_.composite();
-  if (!g_compositor_thread && !swap_posted_)
+  if (!swap_posted_)
     NotifyEnd();
 }
 
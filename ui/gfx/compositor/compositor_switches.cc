@@ -23,4 +23,8 @@ const char kUIShowLayerTree[] = "ui-show-layer-tree";
 
 const char kUIEnablePerTilePainting[] = "ui-enable-per-tile-painting";
 
+// Run the UI compositor on its own thread, so layer-tree commits and draws
+// happen off the UI thread.
+const char kUIEnableThreadedCompositing[] = "ui-enable-threaded-compositing";
+
 }  // namespace switches
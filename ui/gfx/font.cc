@@ -4,9 +4,61 @@
 
 #include "ui/gfx/font.h"
 
+#include "base/lazy_instance.h"
+#include "base/memory/mru_cache.h"
+#include "base/stringprintf.h"
+#include "base/synchronization/lock.h"
 #include "base/utf_string_conversions.h"
 #include "ui/gfx/platform_font.h"
 
+namespace {
+
+// Strings longer than this are measured directly; they are rare and would
+// crowd the short, frequently remeasured ones out of the cache.
+const size_t kMaxCachedTextLength = 64;
+
+// Number of cached string widths.  A relayout of a dense view hierarchy
+// measures at most a few hundred distinct strings.
+const size_t kStringWidthCacheSize = 1024;
+
+// Memoizes the measured pixel widths of short strings.  Measuring goes
+// through the platform's text stack (Pango on GTK) every time, and layout
+// code measures the same labels with the same fonts over and over, so the
+// results are kept here keyed by font description and text.  Widths for a
+// given description never change within a session, which makes the entries
+// safe to share between Font instances.
+class StringWidthCache {
+ public:
+  StringWidthCache() : cache_(kStringWidthCacheSize) {}
+
+  bool Get(const string16& key, int* width) {
+    base::AutoLock scoped_lock(lock_);
+    CacheType::iterator iter = cache_.Get(key);
+    if (iter == cache_.end())
+      return false;
+    *width = iter->second;
+    return true;
+  }
+
+  void Put(const string16& key, int width) {
+    base::AutoLock scoped_lock(lock_);
+    cache_.Put(key, width);
+  }
+
+ private:
+  typedef base::HashingMRUCache<string16, int> CacheType;
+
+  CacheType cache_;
+  base::Lock lock_;
+
+  DISALLOW_COPY_AND_ASSIGN(StringWidthCache);
+};
+
+base::LazyInstance<StringWidthCache>::Leaky g_string_width_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
 namespace gfx {
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -59,7 +111,23 @@ int Font::GetAverageCharacterWidth() const {
 }
 
 int Font::GetStringWidth(const string16& text) const {
-  return platform_font_->GetStringWidth(text);
+  if (text.length() > kMaxCachedTextLength)
+    return platform_font_->GetStringWidth(text);
+
+  // Key on the font description rather than the platform font instance so
+  // that copies of a font, and fonts recreated with the same parameters,
+  // share entries.
+  string16 key = UTF8ToUTF16(base::StringPrintf(
+      "%s|%d|%d|", GetFontName().c_str(), GetFontSize(), GetStyle()));
+  key += text;
+
+  StringWidthCache* cache = g_string_width_cache.Pointer();
+  int width = 0;
+  if (cache->Get(key, &width))
+    return width;
+  width = platform_font_->GetStringWidth(text);
+  cache->Put(key, width);
+  return width;
 }
 
 int Font::GetExpectedTextWidth(int length) const {
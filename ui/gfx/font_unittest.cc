@@ -113,6 +113,19 @@ TEST_F(FontTest, Widths) {
             cf.GetStringWidth(ASCIIToUTF16("ab")));
 }
 
+TEST_F(FontTest, CachedWidths) {
+  Font cf("Arial", 16);
+  // Repeated measurements are served from the width cache and must agree
+  // with the first one, including for a copy of the font.
+  const int width = cf.GetStringWidth(ASCIIToUTF16("abcde"));
+  ASSERT_EQ(width, cf.GetStringWidth(ASCIIToUTF16("abcde")));
+  Font copy(cf);
+  ASSERT_EQ(width, copy.GetStringWidth(ASCIIToUTF16("abcde")));
+  // A string too long to be cached still measures consistently.
+  const string16 long_text(100, 'a');
+  ASSERT_EQ(cf.GetStringWidth(long_text), cf.GetStringWidth(long_text));
+}
+
 #if defined(OS_WIN)
 TEST_F(FontTest, DeriveFontResizesIfSizeTooSmall) {
   Font cf("Arial", 8);
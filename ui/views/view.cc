@@ -12,6 +12,7 @@
 #include "base/message_loop.h"
 #include "base/stringprintf.h"
 #include "base/utf_string_conversions.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkRect.h"
 #include "ui/base/accessibility/accessibility_types.h"
 #include "ui/base/dragdrop/drag_drop_types.h"
@@ -138,6 +139,8 @@ View::View()
       registered_for_visible_bounds_notification_(false),
       clip_insets_(0, 0, 0, 0),
       needs_layout_(true),
+      cache_paint_output_(false),
+      paint_cache_valid_(false),
       flip_canvas_on_paint_for_rtl_ui_(false),
       paint_to_layer_(false),
       accelerator_registration_delayed_(false),
@@ -714,6 +717,11 @@ void View::SchedulePaintInRect(const gfx::Rect& rect_in_dip) {
   if (!visible_ || !painting_enabled_)
     return;
 
+  // Any invalidation from this view or a descendant makes the cached paint
+  // output stale. Descendant invalidations pass through here on their way
+  // up the parent chain, so every affected ancestor cache is dropped too.
+  paint_cache_valid_ = false;
+
   if (layer()) {
     layer()->SchedulePaint(ConvertRectToPixel(this, rect_in_dip));
   } else if (parent_) {
@@ -750,6 +758,14 @@ void View::Paint(gfx::Canvas* canvas) {
   PaintCommon(canvas);
 }
 
+void View::SetCachePaintOutput(bool cache_paint_output) {
+  if (cache_paint_output_ == cache_paint_output)
+    return;
+  cache_paint_output_ = cache_paint_output;
+  paint_cache_.reset();
+  paint_cache_valid_ = false;
+}
+
 ThemeProvider* View::GetThemeProvider() const {
   const Widget* widget = GetWidget();
   return widget ? widget->GetThemeProvider() : NULL;
@@ -1536,6 +1552,23 @@ void View::PaintCommon(gfx::Canvas* canvas) {
   if (!visible_ || !painting_enabled_)
     return;
 
+  if (cache_paint_output_ && !size().IsEmpty()) {
+    if (!paint_cache_valid_) {
+      // Re-render the whole view into the cache; partial damage is handled
+      // by the clip the caller established when blitting below.
+      gfx::Canvas cache_canvas(size(), false);
+      PaintSelfAndChildren(&cache_canvas);
+      paint_cache_.reset(new SkBitmap(cache_canvas.ExtractBitmap()));
+      paint_cache_valid_ = true;
+    }
+    canvas->DrawBitmapInt(*paint_cache_, 0, 0);
+    return;
+  }
+
+  PaintSelfAndChildren(canvas);
+}
+
+void View::PaintSelfAndChildren(gfx::Canvas* canvas) {
   {
     // If the View we are about to paint requested the canvas to be flipped, we
     // should change the transform appropriately.
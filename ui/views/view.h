@@ -32,6 +32,8 @@
 
 using ui::OSExchangeData;
 
+class SkBitmap;
+
 namespace gfx {
 class Canvas;
 class Insets;
@@ -461,6 +463,17 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // the hierarchy beneath it.
   virtual void Paint(gfx::Canvas* canvas);
 
+  // Sets whether this view caches the paint output of itself and its
+  // children in a bitmap, repainting from the cache until SchedulePaint()
+  // is invoked on this view or one of its descendants. This makes repaints
+  // cheap for dense, rarely-changing views (toolbars, list rows) when the
+  // damage originates elsewhere, at the cost of a bitmap the size of the
+  // view. Views in accelerated widgets should generally prefer
+  // SetPaintToLayer(), which keeps the cached output in a compositor
+  // texture instead.
+  void SetCachePaintOutput(bool cache_paint_output);
+  bool cache_paint_output() const { return cache_paint_output_; }
+
   // The background object is owned by this object and may be NULL.
   void set_background(Background* b) { background_.reset(b); }
   const Background* background() const { return background_.get(); }
@@ -1147,6 +1160,11 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // invoke OnPaint() on the View.
   void PaintCommon(gfx::Canvas* canvas);
 
+  // Paints this view and its children into |canvas|, applying RTL flipping
+  // as needed. Helper for PaintCommon(), which renders either directly or
+  // through the paint cache.
+  void PaintSelfAndChildren(gfx::Canvas* canvas);
+
   // Tree operations -----------------------------------------------------------
 
   // Removes |view| from the hierarchy tree.  If |update_focus_cycle| is true,
@@ -1413,6 +1431,15 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // Border.
   scoped_ptr<Border> border_;
 
+  // Whether PaintCommon() renders through |paint_cache_|. See
+  // SetCachePaintOutput().
+  bool cache_paint_output_;
+
+  // Cached output of the last full paint of this view and its children.
+  // NULL or stale whenever |paint_cache_valid_| is false.
+  scoped_ptr<SkBitmap> paint_cache_;
+  bool paint_cache_valid_;
+
   // RTL painting --------------------------------------------------------------
 
   // Indicates whether or not the gfx::Canvas object passed to View::Paint()
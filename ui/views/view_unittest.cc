@@ -601,6 +601,56 @@ void CheckRect(const SkRect& check_rect, const SkRect& target_rect) {
   EXPECT_EQ(target_rect.fBottom, check_rect.fBottom);
 }
 
+namespace {
+
+// Counts how many times OnPaint() actually runs.
+class PaintCountView : public View {
+ public:
+  PaintCountView() : paint_count_(0) {
+  }
+
+  int paint_count() const { return paint_count_; }
+
+  virtual void OnPaint(gfx::Canvas* canvas) OVERRIDE {
+    ++paint_count_;
+  }
+
+ private:
+  int paint_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(PaintCountView);
+};
+
+}  // namespace
+
+TEST_F(ViewTest, CachePaintOutput) {
+  View root;
+  root.SetBoundsRect(gfx::Rect(0, 0, 100, 100));
+  root.SetCachePaintOutput(true);
+
+  PaintCountView* child = new PaintCountView;
+  child->SetBoundsRect(gfx::Rect(0, 0, 50, 50));
+  root.AddChildView(child);
+
+  gfx::Canvas canvas(gfx::Size(100, 100), false);
+  root.Paint(&canvas);
+  EXPECT_EQ(1, child->paint_count());
+
+  // A second paint with no invalidation must come from the cache.
+  root.Paint(&canvas);
+  EXPECT_EQ(1, child->paint_count());
+
+  // Invalidating the child drops the cached output of every ancestor.
+  child->SchedulePaint();
+  root.Paint(&canvas);
+  EXPECT_EQ(2, child->paint_count());
+
+  // Turning caching off falls back to direct painting.
+  root.SetCachePaintOutput(false);
+  root.Paint(&canvas);
+  EXPECT_EQ(3, child->paint_count());
+}
+
 /* This test is disabled because it is flakey on some systems.
 TEST_F(ViewTest, DISABLED_Painting) {
   // Determine if InvalidateRect generates an empty paint rectangle.
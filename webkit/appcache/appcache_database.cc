@@ -381,6 +381,41 @@ bool AppCacheDatabase::FindGroupForCache(int64 cache_id, GroupRecord* record) {
   return true;
 }
 
+bool AppCacheDatabase::FindGroupsForCaches(
+    const std::vector<int64>& cache_ids,
+    std::map<int64, GroupRecord>* records) {
+  DCHECK(records && records->empty());
+  if (cache_ids.empty())
+    return true;
+  if (!LazyOpen(false))
+    return false;
+
+  // One query for the whole batch. The statement text depends on the
+  // number of ids, so we can't use the statement cache here.
+  std::string sql(
+      "SELECT g.group_id, g.origin, g.manifest_url,"
+      "       g.creation_time, g.last_access_time, c.cache_id"
+      "  FROM Groups g, Caches c"
+      "  WHERE c.group_id = g.group_id AND c.cache_id IN (");
+  for (size_t i = 0; i < cache_ids.size(); ++i) {
+    if (i)
+      sql.append(",");
+    sql.append("?");
+  }
+  sql.append(")");
+
+  sql::Statement statement(db_->GetUniqueStatement(sql.c_str()));
+  for (size_t i = 0; i < cache_ids.size(); ++i)
+    statement.BindInt64(static_cast<int>(i), cache_ids[i]);
+
+  while (statement.Step()) {
+    int64 cache_id = statement.ColumnInt64(5);
+    ReadGroupRecord(statement, &(*records)[cache_id]);
+  }
+
+  return statement.Succeeded();
+}
+
 bool AppCacheDatabase::UpdateGroupLastAccessTime(
     int64 group_id, base::Time time) {
   if (!LazyOpen(true))
@@ -101,6 +101,9 @@ class APPCACHE_EXPORT AppCacheDatabase {
   bool FindGroupsForOrigin(
       const GURL& origin, std::vector<GroupRecord>* records);
   bool FindGroupForCache(int64 cache_id, GroupRecord* record);
+  bool FindGroupsForCaches(
+      const std::vector<int64>& cache_ids,
+      std::map<int64, GroupRecord>* records);
   bool UpdateGroupLastAccessTime(
       int64 group_id, base::Time last_access_time);
   bool InsertGroup(const GroupRecord* record);
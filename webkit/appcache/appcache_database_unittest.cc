@@ -327,6 +327,24 @@ TEST(AppCacheDatabaseTest, GroupRecords) {
   EXPECT_EQ(1, record.group_id);
   EXPECT_EQ(kManifest2, record.manifest_url);
   EXPECT_EQ(kOrigin2, record.origin);
+
+  cache_record.cache_id = 2;
+  cache_record.group_id = 2;
+  EXPECT_TRUE(db.InsertCache(&cache_record));
+
+  std::vector<int64> cache_ids;
+  cache_ids.push_back(1);
+  cache_ids.push_back(2);
+  cache_ids.push_back(3);  // Has no cache record.
+  std::map<int64, AppCacheDatabase::GroupRecord> group_map;
+  EXPECT_TRUE(db.FindGroupsForCaches(cache_ids, &group_map));
+  EXPECT_EQ(2U, group_map.size());
+  EXPECT_EQ(1, group_map[1].group_id);
+  EXPECT_EQ(kManifest2, group_map[1].manifest_url);
+  EXPECT_EQ(kOrigin2, group_map[1].origin);
+  EXPECT_EQ(2, group_map[2].group_id);
+  EXPECT_EQ(kOrigin, group_map[2].manifest_url);
+  EXPECT_EQ(kOrigin, group_map[2].origin);
 }
 
 TEST(AppCacheDatabaseTest, NamespaceRecords) {
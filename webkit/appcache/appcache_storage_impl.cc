@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <map>
 #include <set>
 #include <vector>
 
@@ -896,6 +897,7 @@ class AppCacheStorageImpl::FindMainResponseTask : public DatabaseTask {
  private:
   typedef std::vector<AppCacheDatabase::NamespaceRecord*>
       NamespaceRecordPtrVector;
+  typedef std::map<int64, AppCacheDatabase::GroupRecord> GroupRecordMap;
 
   bool FindExactMatch(int64 preferred_id);
   bool FindNamespaceMatch(int64 preferred_id);
@@ -903,7 +905,8 @@ class AppCacheStorageImpl::FindMainResponseTask : public DatabaseTask {
       int64 preferred_cache_id,
       AppCacheDatabase::NamespaceRecordVector* namespaces,
       NetworkNamespaceHelper* network_namespace_helper);
-  bool FindFirstValidNamespace(const NamespaceRecordPtrVector& namespaces);
+  bool FindFirstValidNamespace(const NamespaceRecordPtrVector& namespaces,
+                               const GroupRecordMap& groups);
 
   GURL url_;
   GURL preferred_manifest_url_;
@@ -965,16 +968,24 @@ FindMainResponseTask::FindExactMatch(int64 preferred_cache_id) {
     std::sort(entries.begin(), entries.end(),
               SortByCachePreference(preferred_cache_id, cache_ids_in_use_));
 
-    // Take the first with a valid, non-foreign entry.
+    // Fetch the groups for all the candidate hits with one query instead
+    // of querying one row per candidate.
+    std::vector<int64> candidate_cache_ids;
     std::vector<AppCacheDatabase::EntryRecord>::iterator iter;
     for (iter = entries.begin(); iter < entries.end(); ++iter) {
-      AppCacheDatabase::GroupRecord group_record;
-      if ((iter->flags & AppCacheEntry::FOREIGN) ||
-          !database_->FindGroupForCache(iter->cache_id, &group_record)) {
+      if (!(iter->flags & AppCacheEntry::FOREIGN))
+        candidate_cache_ids.push_back(iter->cache_id);
+    }
+    GroupRecordMap groups;
+    database_->FindGroupsForCaches(candidate_cache_ids, &groups);
+
+    // Take the first with a valid, non-foreign entry.
+    for (iter = entries.begin(); iter < entries.end(); ++iter) {
+      GroupRecordMap::const_iterator found = groups.find(iter->cache_id);
+      if ((iter->flags & AppCacheEntry::FOREIGN) || found == groups.end())
         continue;
-      }
-      manifest_url_ = group_record.manifest_url;
-      group_id_ = group_record.group_id;
+      manifest_url_ = found->second.manifest_url;
+      group_id_ = found->second.group_id;
       entry_ = AppCacheEntry(iter->flags, iter->response_id);
       cache_id_ = iter->cache_id;
       return true;  // We found an exact match.
@@ -1037,9 +1048,25 @@ FindMainResponseTask::FindNamespaceHelper(
       other_namespaces.push_back(&(*iter));
   }
 
-  if (FindFirstValidNamespace(preferred_namespaces) ||
-      FindFirstValidNamespace(inuse_namespaces) ||
-      FindFirstValidNamespace(other_namespaces))
+  // Batch the group lookups for everything we binned so the valid-namespace
+  // scans below don't issue one group query per candidate.
+  std::vector<int64> candidate_cache_ids;
+  NamespaceRecordPtrVector::const_iterator candidate;
+  for (candidate = preferred_namespaces.begin();
+       candidate != preferred_namespaces.end(); ++candidate)
+    candidate_cache_ids.push_back((*candidate)->cache_id);
+  for (candidate = inuse_namespaces.begin();
+       candidate != inuse_namespaces.end(); ++candidate)
+    candidate_cache_ids.push_back((*candidate)->cache_id);
+  for (candidate = other_namespaces.begin();
+       candidate != other_namespaces.end(); ++candidate)
+    candidate_cache_ids.push_back((*candidate)->cache_id);
+  GroupRecordMap groups;
+  database_->FindGroupsForCaches(candidate_cache_ids, &groups);
+
+  if (FindFirstValidNamespace(preferred_namespaces, groups) ||
+      FindFirstValidNamespace(inuse_namespaces, groups) ||
+      FindFirstValidNamespace(other_namespaces, groups))
     return true;  // We found one.
 
   // We didn't find anything.
@@ -1048,20 +1075,22 @@ FindMainResponseTask::FindNamespaceHelper(
 
 bool AppCacheStorageImpl::
 FindMainResponseTask::FindFirstValidNamespace(
-    const NamespaceRecordPtrVector& namespaces) {
+    const NamespaceRecordPtrVector& namespaces,
+    const GroupRecordMap& groups) {
   // Take the first with a valid, non-foreign entry.
   NamespaceRecordPtrVector::const_iterator iter;
   for (iter = namespaces.begin(); iter < namespaces.end();  ++iter) {
     AppCacheDatabase::EntryRecord entry_record;
     if (database_->FindEntry((*iter)->cache_id, (*iter)->target_url,
                              &entry_record)) {
-      AppCacheDatabase::GroupRecord group_record;
+      GroupRecordMap::const_iterator found =
+          groups.find(entry_record.cache_id);
       if ((entry_record.flags & AppCacheEntry::FOREIGN) ||
-          !database_->FindGroupForCache(entry_record.cache_id, &group_record)) {
+          found == groups.end()) {
         continue;
       }
-      manifest_url_ = group_record.manifest_url;
-      group_id_ = group_record.group_id;
+      manifest_url_ = found->second.manifest_url;
+      group_id_ = found->second.group_id;
       cache_id_ = (*iter)->cache_id;
       namespace_entry_url_ = (*iter)->target_url;
       if ((*iter)->type == FALLBACK_NAMESPACE)
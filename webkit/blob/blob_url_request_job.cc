@@ -175,7 +175,14 @@ void BlobURLRequestJob::CountSize() {
 
   for (size_t i = 0; i < blob_data_->items().size(); ++i) {
     const BlobData::Item& item = blob_data_->items().at(i);
-    if (item.type == BlobData::TYPE_FILE) {
+    if (item.type == BlobData::TYPE_FILE &&
+        (static_cast<int64>(item.length) == -1 ||
+         !item.expected_modification_time.is_null())) {
+      // We have to touch the file now, either because the item length is
+      // still unknown or because we have a snapshot time to verify. Items
+      // with a known length and no snapshot time are not opened until they
+      // are actually read, so that a range request doesn't pay a file thread
+      // round trip for every item it skips.
       ++pending_get_file_info_count_;
       GetFileReader(i)->GetLength(
           base::Bind(&BlobURLRequestJob::DidGetFileItemLength,
@@ -25,10 +25,14 @@ namespace dom_storage {
 static const int kCommitTimerSeconds = 1;
 
 DomStorageArea::CommitBatch::CommitBatch()
-  : clear_all_first(false) {
+  : clear_all_first(false),
+    data_size(0) {
 }
 DomStorageArea::CommitBatch::~CommitBatch() {}
 
+// static
+const size_t DomStorageArea::kMaxCommitBatchBytes = 1024 * 1024;
+
 
 // static
 const FilePath::CharType DomStorageArea::kDatabaseFileExtension[] =
@@ -111,6 +115,8 @@ bool DomStorageArea::SetItem(const string16& key,
   if (success && backing_.get()) {
     CommitBatch* commit_batch = CreateCommitBatchIfNeeded();
     commit_batch->changed_values[key] = NullableString16(value, false);
+    commit_batch->data_size += (key.size() + value.size()) * sizeof(char16);
+    CommitIfBatchIsFull();
   }
   return success;
 }
@@ -125,6 +131,8 @@ bool DomStorageArea::RemoveItem(const string16& key, string16* old_value) {
   if (success && backing_.get()) {
     CommitBatch* commit_batch = CreateCommitBatchIfNeeded();
     commit_batch->changed_values[key] = NullableString16(true);
+    commit_batch->data_size += key.size() * sizeof(char16);
+    CommitIfBatchIsFull();
   }
   return success;
 }
@@ -142,6 +150,7 @@ bool DomStorageArea::Clear() {
     CommitBatch* commit_batch = CreateCommitBatchIfNeeded();
     commit_batch->clear_all_first = true;
     commit_batch->changed_values.clear();
+    commit_batch->data_size = 0;
   }
 
   return true;
@@ -246,14 +255,35 @@ DomStorageArea::CommitBatch* DomStorageArea::CreateCommitBatchIfNeeded() {
   return commit_batch_.get();
 }
 
+void DomStorageArea::CommitIfBatchIsFull() {
+  DCHECK(task_runner_->IsRunningOnPrimarySequence());
+  DCHECK(commit_batch_.get());
+  if (in_flight_commit_batch_.get() ||
+      commit_batch_->data_size < kMaxCommitBatchBytes)
+    return;
+  // A batch that has accrued a lot of data is committed right away rather
+  // than waiting for the timer to fire. The timer task that was scheduled
+  // for this batch will find nothing to do.
+  in_flight_commit_batch_ = commit_batch_.Pass();
+  bool success = task_runner_->PostShutdownBlockingTask(
+      FROM_HERE,
+      DomStorageTaskRunner::COMMIT_SEQUENCE,
+      base::Bind(&DomStorageArea::CommitChanges, this));
+  DCHECK(success);
+}
+
 void DomStorageArea::OnCommitTimer() {
   DCHECK_EQ(kLocalStorageNamespaceId, namespace_id_);
   if (is_shutdown_)
     return;
 
   DCHECK(backing_.get());
-  DCHECK(commit_batch_.get());
-  DCHECK(!in_flight_commit_batch_.get());
+
+  // The batch this timer was started for may have already been committed
+  // by CommitIfBatchIsFull(), leaving nothing to do here. Any batch that
+  // accrued behind that commit is scheduled by OnCommitComplete().
+  if (!commit_batch_.get() || in_flight_commit_batch_.get())
+    return;
 
   // This method executes on the primary sequence, we schedule
   // a task for immediate execution on the commit sequence.
@@ -74,6 +74,7 @@ class DomStorageArea
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, BackingDatabaseOpened);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, TestDatabaseFilePath);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, CommitTasks);
+  FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, CommitBatchFillsUp);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, CommitChangesAtShutdown);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, DeleteOrigin);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, PurgeMemory);
@@ -82,10 +83,19 @@ class DomStorageArea
   struct CommitBatch {
     bool clear_all_first;
     ValuesMap changed_values;
+    // Approximate number of bytes of changed values accrued in this batch.
+    // Repeated changes to the same key are counted each time, which only
+    // makes the batch look full sooner.
+    size_t data_size;
     CommitBatch();
     ~CommitBatch();
   };
 
+  // Batches holding at least this many bytes of changed values are
+  // committed without waiting for the commit timer, bounding the memory
+  // a batch holds and the window of changes lost on a crash.
+  static const size_t kMaxCommitBatchBytes;
+
   ~DomStorageArea();
 
   // If we haven't done so already and this is a local storage area,
@@ -97,6 +107,7 @@ class DomStorageArea
   // disk on the commit sequence, and to call back on the primary
   // task sequence when complete.
   CommitBatch* CreateCommitBatchIfNeeded();
+  void CommitIfBatchIsFull();
   void OnCommitTimer();
   void CommitChanges();
   void OnCommitComplete();
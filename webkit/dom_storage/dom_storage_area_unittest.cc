@@ -270,6 +270,43 @@ TEST_F(DomStorageAreaTest, CommitTasks) {
   EXPECT_EQ(kValue2, values[kKey2].string());
 }
 
+TEST_F(DomStorageAreaTest, CommitBatchFillsUp) {
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+
+  scoped_refptr<DomStorageArea> area(
+      new DomStorageArea(kLocalStorageNamespaceId, kOrigin,
+          temp_dir.path(),
+          new MockDomStorageTaskRunner(base::MessageLoopProxy::current())));
+  // Inject an in-memory db to speed up the test.
+  area->backing_.reset(new DomStorageDatabase());
+  EXPECT_EQ(0u, area->Length());
+
+  // A small change accrues in a batch awaiting the commit timer.
+  NullableString16 old_value;
+  EXPECT_TRUE(area->SetItem(kKey, kValue, &old_value));
+  EXPECT_TRUE(area->commit_batch_.get());
+  EXPECT_FALSE(area->in_flight_commit_batch_.get());
+
+  // A change that fills the batch past the size limit puts the commit in
+  // flight without waiting for the timer.
+  string16 large_value(
+      DomStorageArea::kMaxCommitBatchBytes / sizeof(char16), 'a');
+  EXPECT_TRUE(area->SetItem(kKey2, large_value, &old_value));
+  EXPECT_FALSE(area->commit_batch_.get());
+  EXPECT_TRUE(area->in_flight_commit_batch_.get());
+
+  MessageLoop::current()->RunAllPending();
+  EXPECT_FALSE(area->HasUncommittedChanges());
+
+  // Verify the changes made it to the database.
+  ValuesMap values;
+  area->backing_->ReadAllValues(&values);
+  EXPECT_EQ(2u, values.size());
+  EXPECT_EQ(kValue, values[kKey].string());
+  EXPECT_EQ(large_value, values[kKey2].string());
+}
+
 TEST_F(DomStorageAreaTest, CommitChangesAtShutdown) {
   ScopedTempDir temp_dir;
   ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
@@ -380,7 +380,11 @@ FileSystemDirectoryDatabase::FileInfo::~FileInfo() {
 
 FileSystemDirectoryDatabase::FileSystemDirectoryDatabase(
     const FilePath& filesystem_data_directory)
-    : filesystem_data_directory_(filesystem_data_directory) {
+    : filesystem_data_directory_(filesystem_data_directory),
+      last_file_id_(-1),
+      last_file_id_cached_(false),
+      last_integer_(-1),
+      last_integer_cached_(false) {
 }
 
 FileSystemDirectoryDatabase::~FileSystemDirectoryDatabase() {
@@ -434,7 +438,11 @@ bool FileSystemDirectoryDatabase::ListChildren(
   DCHECK(children);
   std::string child_key_prefix = GetChildListingKeyPrefix(parent_id);
 
-  scoped_ptr<leveldb::Iterator> iter(db_->NewIterator(leveldb::ReadOptions()));
+  // Reuse the cursor from the previous listing when nothing has been written
+  // since; CommitBatch() drops it whenever its snapshot could be stale.
+  if (!listing_iterator_.get())
+    listing_iterator_.reset(db_->NewIterator(leveldb::ReadOptions()));
+  leveldb::Iterator* iter = listing_iterator_.get();
   iter->Seek(child_key_prefix);
   children->clear();
   while (iter->Valid() &&
@@ -511,11 +519,10 @@ bool FileSystemDirectoryDatabase::AddFileInfo(
     return false;
 
   batch.Put(LastFileIdKey(), base::Int64ToString(temp_id));
-  status = db_->Write(leveldb::WriteOptions(), &batch);
-  if (!status.ok()) {
-    HandleError(FROM_HERE, status);
+  if (!CommitBatch(FROM_HERE, &batch))
     return false;
-  }
+  last_file_id_ = temp_id;
+  last_file_id_cached_ = true;
   *file_id = temp_id;
   return true;
 }
@@ -526,12 +533,7 @@ bool FileSystemDirectoryDatabase::RemoveFileInfo(FileId file_id) {
   leveldb::WriteBatch batch;
   if (!RemoveFileInfoHelper(file_id, &batch))
     return false;
-  leveldb::Status status = db_->Write(leveldb::WriteOptions(), &batch);
-  if (!status.ok()) {
-    HandleError(FROM_HERE, status);
-    return false;
-  }
-  return true;
+  return CommitBatch(FROM_HERE, &batch);
 }
 
 bool FileSystemDirectoryDatabase::UpdateFileInfo(
@@ -560,12 +562,7 @@ bool FileSystemDirectoryDatabase::UpdateFileInfo(
   if (!RemoveFileInfoHelper(file_id, &batch) ||
       !AddFileInfoHelper(new_info, file_id, &batch))
     return false;
-  leveldb::Status status = db_->Write(leveldb::WriteOptions(), &batch);
-  if (!status.ok()) {
-    HandleError(FROM_HERE, status);
-    return false;
-  }
-  return true;
+  return CommitBatch(FROM_HERE, &batch);
 }
 
 bool FileSystemDirectoryDatabase::UpdateModificationTime(
@@ -577,16 +574,12 @@ bool FileSystemDirectoryDatabase::UpdateModificationTime(
   Pickle pickle;
   if (!PickleFromFileInfo(info, &pickle))
     return false;
-  leveldb::Status status = db_->Put(
-      leveldb::WriteOptions(),
+  leveldb::WriteBatch batch;
+  batch.Put(
       GetFileLookupKey(file_id),
       leveldb::Slice(reinterpret_cast<const char *>(pickle.data()),
                      pickle.size()));
-  if (!status.ok()) {
-    HandleError(FROM_HERE, status);
-    return false;
-  }
-  return true;
+  return CommitBatch(FROM_HERE, &batch);
 }
 
 bool FileSystemDirectoryDatabase::OverwritingMoveFile(
@@ -613,46 +606,41 @@ bool FileSystemDirectoryDatabase::OverwritingMoveFile(
       GetFileLookupKey(dest_file_id),
       leveldb::Slice(reinterpret_cast<const char *>(pickle.data()),
                      pickle.size()));
-  leveldb::Status status = db_->Write(leveldb::WriteOptions(), &batch);
-  if (!status.ok()) {
-    HandleError(FROM_HERE, status);
-    return false;
-  }
-  return true;
+  return CommitBatch(FROM_HERE, &batch);
 }
 
 bool FileSystemDirectoryDatabase::GetNextInteger(int64* next) {
   if (!Init(REPAIR_ON_CORRUPTION))
     return false;
   DCHECK(next);
-  std::string int_string;
-  leveldb::Status status =
-      db_->Get(leveldb::ReadOptions(), LastIntegerKey(), &int_string);
-  if (status.ok()) {
-    int64 temp;
-    if (!base::StringToInt64(int_string, &temp)) {
-      LOG(ERROR) << "Hit database corruption!";
-      return false;
-    }
-    ++temp;
-    status = db_->Put(leveldb::WriteOptions(), LastIntegerKey(),
-        base::Int64ToString(temp));
-    if (!status.ok()) {
-      HandleError(FROM_HERE, status);
-      return false;
+  if (!last_integer_cached_) {
+    std::string int_string;
+    leveldb::Status status =
+        db_->Get(leveldb::ReadOptions(), LastIntegerKey(), &int_string);
+    if (status.ok()) {
+      if (!base::StringToInt64(int_string, &last_integer_)) {
+        LOG(ERROR) << "Hit database corruption!";
+        return false;
+      }
+      last_integer_cached_ = true;
+    } else {
+      if (!status.IsNotFound()) {
+        HandleError(FROM_HERE, status);
+        return false;
+      }
+      // The database must not yet exist; initialize it.  This primes the
+      // cache as a side effect.
+      if (!StoreDefaultValues())
+        return false;
     }
-    *next = temp;
-    return true;
   }
-  if (!status.IsNotFound()) {
-    HandleError(FROM_HERE, status);
-    return false;
-  }
-  // The database must not yet exist; initialize it.
-  if (!StoreDefaultValues())
+  leveldb::WriteBatch batch;
+  batch.Put(LastIntegerKey(), base::Int64ToString(last_integer_ + 1));
+  if (!CommitBatch(FROM_HERE, &batch))
     return false;
-
-  return GetNextInteger(next);
+  ++last_integer_;
+  *next = last_integer_;
+  return true;
 }
 
 // static
@@ -722,6 +710,11 @@ bool FileSystemDirectoryDatabase::RepairDatabase(const std::string& db_path) {
 bool FileSystemDirectoryDatabase::IsFileSystemConsistent() {
   if (!Init(FAIL_ON_CORRUPTION))
     return false;
+  // The check must not trust any cached state; anything could have happened
+  // to the database behind our back for us to be called at all.
+  listing_iterator_.reset();
+  last_file_id_cached_ = false;
+  last_integer_cached_ = false;
   DatabaseCheckHelper helper(this, db_.get(), filesystem_data_directory_);
   return helper.IsFileSystemConsistent();
 }
@@ -768,11 +761,12 @@ bool FileSystemDirectoryDatabase::StoreDefaultValues() {
     return false;
   batch.Put(LastFileIdKey(), base::Int64ToString(0));
   batch.Put(LastIntegerKey(), base::Int64ToString(-1));
-  leveldb::Status status = db_->Write(leveldb::WriteOptions(), &batch);
-  if (!status.ok()) {
-    HandleError(FROM_HERE, status);
+  if (!CommitBatch(FROM_HERE, &batch))
     return false;
-  }
+  last_file_id_ = 0;
+  last_file_id_cached_ = true;
+  last_integer_ = -1;
+  last_integer_cached_ = true;
   return true;
 }
 
@@ -780,14 +774,20 @@ bool FileSystemDirectoryDatabase::GetLastFileId(FileId* file_id) {
   if (!Init(REPAIR_ON_CORRUPTION))
     return false;
   DCHECK(file_id);
+  if (last_file_id_cached_) {
+    *file_id = last_file_id_;
+    return true;
+  }
   std::string id_string;
   leveldb::Status status =
       db_->Get(leveldb::ReadOptions(), LastFileIdKey(), &id_string);
   if (status.ok()) {
-    if (!base::StringToInt64(id_string, file_id)) {
+    if (!base::StringToInt64(id_string, &last_file_id_)) {
       LOG(ERROR) << "Hit database corruption!";
       return false;
     }
+    last_file_id_cached_ = true;
+    *file_id = last_file_id_;
     return true;
   }
   if (!status.IsNotFound()) {
@@ -858,11 +858,28 @@ bool FileSystemDirectoryDatabase::RemoveFileInfoHelper(
   return true;
 }
 
+bool FileSystemDirectoryDatabase::CommitBatch(
+    const tracked_objects::Location& from_here,
+    leveldb::WriteBatch* batch) {
+  // The listing cursor reads from a snapshot, so it has to be rebuilt after
+  // any write, even a failed one.
+  listing_iterator_.reset();
+  leveldb::Status status = db_->Write(leveldb::WriteOptions(), batch);
+  if (!status.ok()) {
+    HandleError(from_here, status);
+    return false;
+  }
+  return true;
+}
+
 void FileSystemDirectoryDatabase::HandleError(
     const tracked_objects::Location& from_here,
     const leveldb::Status& status) {
   LOG(ERROR) << "FileSystemDirectoryDatabase failed at: "
              << from_here.ToString() << " with error: " << status.ToString();
+  listing_iterator_.reset();
+  last_file_id_cached_ = false;
+  last_integer_cached_ = false;
   db_.reset();
 }
 
@@ -18,6 +18,7 @@ class Location;
 
 namespace leveldb {
 class DB;
+class Iterator;
 class Status;
 class WriteBatch;
 }
@@ -107,11 +108,27 @@ class FileSystemDirectoryDatabase {
   bool AddFileInfoHelper(
       const FileInfo& info, FileId file_id, leveldb::WriteBatch* batch);
   bool RemoveFileInfoHelper(FileId file_id, leveldb::WriteBatch* batch);
+  // All mutations funnel through this; it commits |batch| as a single write
+  // and drops any cached state that the write may have made stale.
+  bool CommitBatch(const tracked_objects::Location& from_here,
+                   leveldb::WriteBatch* batch);
   void HandleError(const tracked_objects::Location& from_here,
                    const leveldb::Status& status);
 
   FilePath filesystem_data_directory_;
   scoped_ptr<leveldb::DB> db_;
+  // A reusable cursor for ListChildren, so that enumerating a directory tree
+  // doesn't allocate an iterator per directory.  It reads from a snapshot, so
+  // CommitBatch() drops it after every write.  Declared after |db_| since an
+  // iterator must not outlive its database.
+  scoped_ptr<leveldb::Iterator> listing_iterator_;
+  // Cached copies of the LAST_FILE_ID and LAST_INTEGER entries, valid only
+  // when the matching flag is set, so that creating many files in a burst
+  // doesn't pay a database read per file.
+  FileId last_file_id_;
+  bool last_file_id_cached_;
+  int64 last_integer_;
+  bool last_integer_cached_;
   base::Time last_reported_time_;
   DISALLOW_COPY_AND_ASSIGN(FileSystemDirectoryDatabase);
 };
@@ -375,6 +375,40 @@ TEST_F(FileSystemDirectoryDatabaseTest, TestListChildren) {
   }
 }
 
+TEST_F(FileSystemDirectoryDatabaseTest, TestListChildrenAfterMutation) {
+  // Listings reuse a cached cursor; make sure each kind of mutation between
+  // two listings is reflected in the second one.
+  FileInfo info;
+  FileId file_id0;
+  FileId file_id1;
+  info.parent_id = 0;
+  info.name = FILE_PATH_LITERAL("foo");
+  EXPECT_TRUE(db()->AddFileInfo(info, &file_id0));
+
+  std::vector<FileId> children;
+  EXPECT_TRUE(db()->ListChildren(0, &children));
+  EXPECT_EQ(1UL, children.size());
+
+  info.name = FILE_PATH_LITERAL("bar");
+  EXPECT_TRUE(db()->AddFileInfo(info, &file_id1));
+  EXPECT_TRUE(db()->ListChildren(0, &children));
+  EXPECT_EQ(2UL, children.size());
+
+  // Move |file_id1| into |file_id0|.
+  info.parent_id = file_id0;
+  EXPECT_TRUE(db()->UpdateFileInfo(file_id1, info));
+  EXPECT_TRUE(db()->ListChildren(0, &children));
+  EXPECT_EQ(1UL, children.size());
+  EXPECT_EQ(file_id0, children[0]);
+  EXPECT_TRUE(db()->ListChildren(file_id0, &children));
+  EXPECT_EQ(1UL, children.size());
+  EXPECT_EQ(file_id1, children[0]);
+
+  EXPECT_TRUE(db()->RemoveFileInfo(file_id1));
+  EXPECT_TRUE(db()->ListChildren(file_id0, &children));
+  EXPECT_TRUE(children.empty());
+}
+
 TEST_F(FileSystemDirectoryDatabaseTest, TestUpdateModificationTime) {
   FileInfo info0;
   FileId file_id;
@@ -4,6 +4,8 @@
 
 #include "webkit/plugins/ppapi/host_array_buffer_var.h"
 
+#include <string.h>
+
 using ppapi::ArrayBufferVar;
 using WebKit::WebArrayBuffer;
 
@@ -18,6 +20,18 @@ HostArrayBufferVar::HostArrayBufferVar(const WebArrayBuffer& buffer)
     : buffer_(buffer) {
 }
 
+HostArrayBufferVar::HostArrayBufferVar(uint32 size_in_bytes,
+                                       const base::SharedMemoryHandle& handle)
+    : buffer_(WebArrayBuffer::create(size_in_bytes, 1 /* element_size */)) {
+  base::SharedMemory shared_memory(handle, false);
+  if (shared_memory.Map(size_in_bytes)) {
+    // WebArrayBuffer owns its own memory, so the bytes have to be copied out
+    // of the segment here; everything up to this point shared them.
+    memcpy(buffer_.data(), shared_memory.memory(), size_in_bytes);
+    shared_memory.Unmap();
+  }
+}
+
 HostArrayBufferVar::~HostArrayBufferVar() {
 }
 
@@ -16,6 +16,9 @@ class HostArrayBufferVar : public ::ppapi::ArrayBufferVar {
  public:
   explicit HostArrayBufferVar(uint32 size_in_bytes);
   explicit HostArrayBufferVar(const WebKit::WebArrayBuffer& buffer);
+  // Takes ownership of |handle| and copies its contents into the buffer.
+  HostArrayBufferVar(uint32 size_in_bytes,
+                     const base::SharedMemoryHandle& handle);
   virtual ~HostArrayBufferVar();
 
   // ArrayBufferVar implementation.
@@ -26,6 +26,12 @@ ArrayBufferVar* HostVarTracker::CreateArrayBuffer(uint32 size_in_bytes) {
   return new HostArrayBufferVar(size_in_bytes);
 }
 
+ArrayBufferVar* HostVarTracker::CreateShmArrayBuffer(
+    uint32 size_in_bytes,
+    base::SharedMemoryHandle handle) {
+  return new HostArrayBufferVar(size_in_bytes, handle);
+}
+
 void HostVarTracker::AddNPObjectVar(NPObjectVar* object_var) {
   DCHECK(CalledOnValidThread());
 
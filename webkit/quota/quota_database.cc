@@ -170,6 +170,31 @@ bool QuotaDatabase::GetHostQuota(
   return true;
 }
 
+bool QuotaDatabase::GetHostsQuota(
+    const std::set<std::string>& hosts,
+    StorageType type,
+    std::map<std::string, int64>* quota_map) {
+  DCHECK(quota_map);
+  quota_map->clear();
+  if (!LazyOpen(false))
+    return false;
+
+  const char* kSql =
+      "SELECT quota"
+      " FROM HostQuotaTable"
+      " WHERE host = ? AND type = ?";
+
+  sql::Statement statement(db_->GetCachedStatement(SQL_FROM_HERE, kSql));
+  for (std::set<std::string>::const_iterator iter = hosts.begin();
+       iter != hosts.end(); ++iter) {
+    statement.Reset(true);
+    statement.BindString(0, *iter);
+    statement.BindInt(1, static_cast<int>(type));
+    (*quota_map)[*iter] = statement.Step() ? statement.ColumnInt64(0) : 0;
+  }
+  return true;
+}
+
 bool QuotaDatabase::SetHostQuota(
     const std::string& host, StorageType type, int64 quota) {
   DCHECK_GE(quota, 0);
@@ -5,6 +5,7 @@
 #ifndef WEBKIT_QUOTA_QUOTA_DATABASE_H_
 #define WEBKIT_QUOTA_QUOTA_DATABASE_H_
 
+#include <map>
 #include <set>
 #include <string>
 
@@ -43,6 +44,14 @@ class QuotaDatabase {
   void CloseConnection();
 
   bool GetHostQuota(const std::string& host, StorageType type, int64* quota);
+
+  // Reads the quota of all |hosts| for |type| in one database pass.
+  // Hosts that have no persisted quota are reported with a quota of 0.
+  // It returns false when it failed in opening the database.
+  bool GetHostsQuota(const std::set<std::string>& hosts,
+                     StorageType type,
+                     std::map<std::string, int64>* quota_map);
+
   bool SetHostQuota(const std::string& host, StorageType type, int64 quota);
   bool DeleteHostQuota(const std::string& host, StorageType type);
 
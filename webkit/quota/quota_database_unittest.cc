@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <map>
 #include <set>
 
 #include "base/bind.h"
@@ -105,6 +106,28 @@ class QuotaDatabaseTest : public testing::Test {
     EXPECT_FALSE(db.GetHostQuota(kHost, kStorageTypeTemporary, &quota));
   }
 
+  void HostsQuota(const FilePath& kDbFile) {
+    QuotaDatabase db(kDbFile);
+    ASSERT_TRUE(db.LazyOpen(true));
+
+    EXPECT_TRUE(db.SetHostQuota("a.com", kStorageTypePersistent, 100));
+    EXPECT_TRUE(db.SetHostQuota("b.com", kStorageTypePersistent, 200));
+    EXPECT_TRUE(db.SetHostQuota("b.com", kStorageTypeTemporary, 300));
+
+    std::set<std::string> hosts;
+    hosts.insert("a.com");
+    hosts.insert("b.com");
+    hosts.insert("no-quota.com");
+
+    std::map<std::string, int64> quota_map;
+    EXPECT_TRUE(db.GetHostsQuota(hosts, kStorageTypePersistent, &quota_map));
+    ASSERT_EQ(3U, quota_map.size());
+    EXPECT_EQ(100, quota_map["a.com"]);
+    EXPECT_EQ(200, quota_map["b.com"]);
+    // Hosts without a persisted quota are reported with 0.
+    EXPECT_EQ(0, quota_map["no-quota.com"]);
+  }
+
   void GlobalQuota(const FilePath& kDbFile) {
     QuotaDatabase db(kDbFile);
     ASSERT_TRUE(db.LazyOpen(true));
@@ -505,6 +528,14 @@ TEST_F(QuotaDatabaseTest, HostQuota) {
   HostQuota(FilePath());
 }
 
+TEST_F(QuotaDatabaseTest, HostsQuota) {
+  ScopedTempDir data_dir;
+  ASSERT_TRUE(data_dir.CreateUniqueTempDir());
+  const FilePath kDbFile = data_dir.path().AppendASCII("quota_manager.db");
+  HostsQuota(kDbFile);
+  HostsQuota(FilePath());
+}
+
 TEST_F(QuotaDatabaseTest, GlobalQuota) {
   ScopedTempDir data_dir;
   ASSERT_TRUE(data_dir.CreateUniqueTempDir());
@@ -39,6 +39,12 @@ const int64 kIncognitoDefaultTemporaryQuota = 50 * kMBytes;
 const int64 kReportHistogramInterval = 60 * 60 * 1000;  // 1 hour
 const double kTemporaryQuotaRatioToAvail = 0.5;  // 50%
 
+// How long a result of the available space query is reused.  Each usage and
+// quota dispatcher asks for the available space, so a burst of quota checks
+// would otherwise queue one disk query per host.  The cache is cleared when
+// origin data is deleted, since that changes the free space.
+const int kAvailableSpaceCacheExpirationInSeconds = 10;
+
 void CountOriginType(const std::set<GURL>& origins,
                      SpecialStoragePolicy* policy,
                      size_t* protected_origins,
@@ -747,38 +753,38 @@ class QuotaManager::UpdateTemporaryQuotaOverrideTask
   QuotaCallback callback_;
 };
 
-class QuotaManager::GetPersistentHostQuotaTask
+class QuotaManager::GetPersistentHostsQuotaTask
     : public QuotaManager::DatabaseTaskBase {
  public:
-  GetPersistentHostQuotaTask(
+  GetPersistentHostsQuotaTask(
       QuotaManager* manager,
-      const std::string& host,
-      const HostQuotaCallback& callback)
+      const std::set<std::string>& hosts)
       : DatabaseTaskBase(manager),
-        host_(host),
-        quota_(-1),
-        callback_(callback) {
+        hosts_(hosts) {
   }
 
  protected:
-  virtual ~GetPersistentHostQuotaTask() {}
+  virtual ~GetPersistentHostsQuotaTask() {}
 
   // QuotaThreadTask:
   virtual void RunOnTargetThread() OVERRIDE {
-    if (!database()->GetHostQuota(host_, kStorageTypePersistent, &quota_))
-      quota_ = 0;
+    if (!database()->GetHostsQuota(hosts_, kStorageTypePersistent,
+                                   &quota_map_)) {
+      // Mirror the single-host behavior: report 0 when nothing could be read.
+      for (std::set<std::string>::const_iterator iter = hosts_.begin();
+           iter != hosts_.end(); ++iter)
+        quota_map_[*iter] = 0;
+    }
   }
 
   // DatabaseTaskBase:
   virtual void DatabaseTaskCompleted() OVERRIDE {
-    callback_.Run(kQuotaStatusOk,
-                  host_, kStorageTypePersistent, quota_);
+    manager()->DidGetPersistentHostsQuota(quota_map_);
   }
 
  private:
-  std::string host_;
-  int64 quota_;
-  HostQuotaCallback callback_;
+  std::set<std::string> hosts_;
+  std::map<std::string, int64> quota_map_;
 };
 
 class QuotaManager::UpdatePersistentHostQuotaTask
@@ -1195,6 +1201,8 @@ QuotaManager::QuotaManager(bool is_incognito,
     temporary_quota_initialized_(false),
     temporary_quota_override_(-1),
     desired_available_space_(-1),
+    cached_available_space_(-1),
+    persistent_host_quota_task_running_(false),
     special_storage_policy_(special_storage_policy),
     weak_factory_(ALLOW_THIS_IN_INITIALIZER_LIST(this)) {
 }
@@ -1218,7 +1226,29 @@ void QuotaManager::GetAvailableSpace(const AvailableSpaceCallback& callback) {
     callback.Run(kQuotaStatusOk, kIncognitoDefaultTemporaryQuota);
     return;
   }
-  make_scoped_refptr(new AvailableSpaceQueryTask(this, callback))->Start();
+  if (!available_space_cached_at_.is_null() &&
+      base::TimeTicks::Now() - available_space_cached_at_ <
+          base::TimeDelta::FromSeconds(
+              kAvailableSpaceCacheExpirationInSeconds)) {
+    callback.Run(kQuotaStatusOk, cached_available_space_);
+    return;
+  }
+  if (available_space_callbacks_.Add(callback)) {
+    // This is the first call since the cache expired; others are answered
+    // together when the query returns.
+    make_scoped_refptr(new AvailableSpaceQueryTask(
+        this,
+        base::Bind(&QuotaManager::DidGetAvailableSpace,
+                   weak_factory_.GetWeakPtr())))->Start();
+  }
+}
+
+void QuotaManager::DidGetAvailableSpace(QuotaStatusCode status, int64 space) {
+  if (status == kQuotaStatusOk) {
+    cached_available_space_ = space;
+    available_space_cached_at_ = base::TimeTicks::Now();
+  }
+  available_space_callbacks_.Run(status, space);
 }
 
 void QuotaManager::GetTemporaryGlobalQuota(const QuotaCallback& callback) {
@@ -1264,9 +1294,37 @@ void QuotaManager::GetPersistentHostQuota(const std::string& host,
     callback.Run(kQuotaStatusOk, host, kStorageTypePersistent, 0);
     return;
   }
-  scoped_refptr<GetPersistentHostQuotaTask> task(
-      new GetPersistentHostQuotaTask(this, host, callback));
-  task->Start();
+  if (!persistent_host_quota_callbacks_.Add(host, callback))
+    return;  // A read for this host is already queued.
+  if (!persistent_host_quota_task_running_)
+    StartPersistentHostQuotaBatch();
+}
+
+void QuotaManager::StartPersistentHostQuotaBatch() {
+  DCHECK(!persistent_host_quota_task_running_);
+  std::set<std::string> hosts;
+  for (HostQuotaCallbackMap::iterator iter =
+           persistent_host_quota_callbacks_.Begin();
+       iter != persistent_host_quota_callbacks_.End(); ++iter)
+    hosts.insert(iter->first);
+  DCHECK(!hosts.empty());
+  persistent_host_quota_task_running_ = true;
+  make_scoped_refptr(new GetPersistentHostsQuotaTask(this, hosts))->Start();
+}
+
+void QuotaManager::DidGetPersistentHostsQuota(
+    const std::map<std::string, int64>& quota_map) {
+  persistent_host_quota_task_running_ = false;
+  for (std::map<std::string, int64>::const_iterator iter = quota_map.begin();
+       iter != quota_map.end(); ++iter) {
+    persistent_host_quota_callbacks_.Run(iter->first, kQuotaStatusOk,
+                                         iter->first, kStorageTypePersistent,
+                                         iter->second);
+  }
+  // Hosts that were requested while the database task was in flight are
+  // grouped into the next batch.
+  if (persistent_host_quota_callbacks_.HasAnyCallbacks())
+    StartPersistentHostQuotaBatch();
 }
 
 void QuotaManager::SetPersistentHostQuota(const std::string& host,
@@ -1555,6 +1613,8 @@ void QuotaManager::DumpOriginInfoTable(
 void QuotaManager::DeleteOriginFromDatabase(
     const GURL& origin, StorageType type) {
   LazyInitialize();
+  // Deleting origin data changes the amount of free disk space.
+  available_space_cached_at_ = base::TimeTicks();
   if (db_disabled_)
     return;
   scoped_refptr<DeleteOriginInfo> task =
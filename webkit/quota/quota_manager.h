@@ -22,6 +22,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequenced_task_runner_helpers.h"
+#include "base/time.h"
 #include "webkit/quota/quota_database.h"
 #include "webkit/quota/quota_client.h"
 #include "webkit/quota/quota_task.h"
@@ -219,7 +220,7 @@ class QuotaManager : public QuotaTaskObserver,
   class DatabaseTaskBase;
   class InitializeTask;
   class UpdateTemporaryQuotaOverrideTask;
-  class GetPersistentHostQuotaTask;
+  class GetPersistentHostsQuotaTask;
   class UpdatePersistentHostQuotaTask;
   class GetLRUOriginTask;
   class DeleteOriginInfo;
@@ -307,6 +308,16 @@ class QuotaManager : public QuotaTaskObserver,
   void DumpQuotaTable(const DumpQuotaTableCallback& callback);
   void DumpOriginInfoTable(const DumpOriginInfoTableCallback& callback);
 
+  // Methods for batching persistent host quota reads.  A single database
+  // task reads the quota of every host queued so far; hosts queued while
+  // the task is in flight are grouped into the next batch.
+  void StartPersistentHostQuotaBatch();
+  void DidGetPersistentHostsQuota(
+      const std::map<std::string, int64>& quota_map);
+
+  // Caches the result for GetAvailableSpace() for a short period.
+  void DidGetAvailableSpace(QuotaStatusCode status, int64 space);
+
   // Methods for eviction logic.
   void StartEviction();
   void DeleteOriginFromDatabase(const GURL& origin, StorageType type);
@@ -376,6 +387,17 @@ class QuotaManager : public QuotaTaskObserver,
 
   int64 desired_available_space_;
 
+  // The last result of the available space query and when it was made.
+  // |available_space_cached_at_| is null when no result is cached.
+  int64 cached_available_space_;
+  base::TimeTicks available_space_cached_at_;
+  AvailableSpaceCallbackQueue available_space_callbacks_;
+
+  // Pending persistent host quota reads, keyed by host.  At most one
+  // database task is reading them at a time.
+  bool persistent_host_quota_task_running_;
+  HostQuotaCallbackMap persistent_host_quota_callbacks_;
+
   // Map from origin to count.
   std::map<GURL, int> origins_in_use_;
   // Map from origin to error count.
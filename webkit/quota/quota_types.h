@@ -144,6 +144,8 @@ typedef CallbackQueue3<GlobalUsageCallback,
 typedef CallbackQueue3<QuotaCallback,
                        QuotaStatusCode,
                        StorageType, int64> QuotaCallbackQueue;
+typedef CallbackQueue2<AvailableSpaceCallback,
+                       QuotaStatusCode, int64> AvailableSpaceCallbackQueue;
 
 template <typename CallbackType, typename CallbackQueueType, typename KEY>
 class CallbackQueueMapBase {
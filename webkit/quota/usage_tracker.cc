@@ -18,10 +18,18 @@
 namespace quota {
 
 namespace {
+
+// Cached per-host usage is gathered again when it becomes older than this.
+// Client-reported deltas keep the cache up to date in between, but they
+// cannot cover modifications the clients never report, so a periodic full
+// gather bounds the drift.
+const int kUsageCacheExpirationInHours = 1;
+
 bool SortByHost(const GURL& lhs, const GURL& rhs) {
   return net::GetHostOrSpecFromURL(lhs) > net::GetHostOrSpecFromURL(rhs);
 }
-}
+
+}  // namespace
 
 // A task class for getting the total amount of data used for a collection of
 // origins.  This class is self-destructed.
@@ -373,11 +381,19 @@ void ClientUsageTracker::GetGlobalUsage(const GlobalUsageCallback& callback) {
 
 void ClientUsageTracker::GetHostUsage(
     const std::string& host, const HostUsageCallback& callback) {
-  HostSet::const_iterator found = cached_hosts_.find(host);
+  HostCacheMap::const_iterator found = cached_hosts_.find(host);
   if (found != cached_hosts_.end()) {
-    // TODO(kinuko): Drop host_usage_map_ cache periodically.
-    callback.Run(host, type_, GetCachedHostUsage(host));
-    return;
+    // Serve the cached usage unless it has expired.  We must not drop any
+    // cached origins while a gather task is running, as the task skips the
+    // origins that were cached when it started.
+    if (base::TimeTicks::Now() - found->second <
+            base::TimeDelta::FromHours(kUsageCacheExpirationInHours) ||
+        global_usage_task_ ||
+        host_usage_tasks_.find(host) != host_usage_tasks_.end()) {
+      callback.Run(host, type_, GetCachedHostUsage(host));
+      return;
+    }
+    DropCachedHost(host);
   }
   if (!host_usage_callbacks_.Add(host, callback) || global_usage_task_)
     return;
@@ -445,7 +461,22 @@ void ClientUsageTracker::AddCachedOrigin(
 }
 
 void ClientUsageTracker::AddCachedHost(const std::string& host) {
-  cached_hosts_.insert(host);
+  cached_hosts_[host] = base::TimeTicks::Now();
+}
+
+void ClientUsageTracker::DropCachedHost(const std::string& host) {
+  HostUsageMap::iterator found = cached_usage_.find(host);
+  if (found != cached_usage_.end()) {
+    const UsageMap& origin_map = found->second;
+    for (UsageMap::const_iterator iter = origin_map.begin();
+         iter != origin_map.end(); ++iter) {
+      global_usage_ -= iter->second;
+      if (global_unlimited_usage_is_valid_ && IsStorageUnlimited(iter->first))
+        global_unlimited_usage_ -= iter->second;
+    }
+    cached_usage_.erase(found);
+  }
+  cached_hosts_.erase(host);
 }
 
 void ClientUsageTracker::GatherGlobalUsageComplete() {
@@ -15,6 +15,7 @@
 #include "base/callback.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time.h"
 #include "googleurl/src/gurl.h"
 #include "webkit/quota/quota_client.h"
 #include "webkit/quota/quota_task.h"
@@ -96,7 +97,8 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer,
   void GetCachedOrigins(std::set<GURL>* origins) const;
 
  private:
-  typedef std::set<std::string> HostSet;
+  // Maps a cached host to the time its usage was last fully gathered.
+  typedef std::map<std::string, base::TimeTicks> HostCacheMap;
   typedef std::map<GURL, int64> UsageMap;
   typedef std::map<std::string, UsageMap> HostUsageMap;
 
@@ -108,6 +110,11 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer,
   // origins and hosts are added incrementally to the cache.
   void AddCachedOrigin(const GURL& origin, int64 usage);
   void AddCachedHost(const std::string& host);
+
+  // Drops the cached usage of every origin of |host| and removes the host
+  // from the cache, adjusting the cached global usage accordingly.
+  void DropCachedHost(const std::string& host);
+
   void GatherGlobalUsageComplete();
   void GatherHostUsageComplete(const std::string& host);
 
@@ -126,7 +133,7 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer,
   int64 global_unlimited_usage_;
   bool global_usage_retrieved_;
   bool global_unlimited_usage_is_valid_;
-  HostSet cached_hosts_;
+  HostCacheMap cached_hosts_;
   HostUsageMap cached_usage_;
 
   GatherGlobalUsageTask* global_usage_task_;